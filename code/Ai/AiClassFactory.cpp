@@ -9,6 +9,7 @@
 #include "Ai/AiClassFactory.h"
 #include "Ai/MoveQuery.h"
 #include "Ai/MoveQueryResult.h"
+#include "Ai/NavCrowdComponent.h"
 #include "Ai/NavMesh.h"
 #include "Ai/NavMeshComponent.h"
 #include "Core/Class/AutoRuntimeClass.h"
@@ -85,6 +86,18 @@ void AiClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	auto classNavMeshComponent = new AutoRuntimeClass< NavMeshComponent >();
 	classNavMeshComponent->addMethod("get", &NavMeshComponent_get);
 	registrar->registerClass(classNavMeshComponent);
+
+	auto classNavCrowdComponent = new AutoRuntimeClass< NavCrowdComponent >();
+	classNavCrowdComponent->addProperty("agentCount", &NavCrowdComponent::getAgentCount);
+	classNavCrowdComponent->addMethod("addAgent", &NavCrowdComponent::addAgent);
+	classNavCrowdComponent->addMethod("removeAgent", &NavCrowdComponent::removeAgent);
+	classNavCrowdComponent->addMethod("setAgentTarget", &NavCrowdComponent::setAgentTarget);
+	classNavCrowdComponent->addMethod("stopAgent", &NavCrowdComponent::stopAgent);
+	classNavCrowdComponent->addMethod("getAgentPosition", &NavCrowdComponent::getAgentPosition);
+	classNavCrowdComponent->addMethod("getAgentVelocity", &NavCrowdComponent::getAgentVelocity);
+	classNavCrowdComponent->addMethod("isAgentMoving", &NavCrowdComponent::isAgentMoving);
+	classNavCrowdComponent->addMethod("isAgentValid", &NavCrowdComponent::isAgentValid);
+	registrar->registerClass(classNavCrowdComponent);
 }
 
 }
@@ -15,7 +15,7 @@
 namespace traktor::ai
 {
 
-T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.ai.NavMeshAsset", 0, NavMeshAsset, ISerializable)
+T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.ai.NavMeshAsset", 1, NavMeshAsset, ISerializable)
 
 void NavMeshAsset::serialize(ISerializer& s)
 {
@@ -32,6 +32,9 @@ void NavMeshAsset::serialize(ISerializer& s)
 	s >> Member< float >(L"mergeRegionSize", m_mergeRegionSize, AttributeRange(0.0f) | AttributeUnit(UnitType::Metres));
 	s >> Member< float >(L"detailSampleDistance", m_detailSampleDistance, AttributeRange(0.0f));
 	s >> Member< float >(L"detailSampleMaxError", m_detailSampleMaxError, AttributeRange(0.0f));
+
+	if (s.getVersion< NavMeshAsset >() >= 1)
+		s >> Member< float >(L"tileSize", m_tileSize, AttributeRange(0.0f) | AttributeUnit(UnitType::Metres));
 }
 
 }
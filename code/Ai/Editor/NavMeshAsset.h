@@ -48,6 +48,7 @@ private:
 	float m_mergeRegionSize = 20.0f;
 	float m_detailSampleDistance = 6.0f;
 	float m_detailSampleMaxError = 1.0f;
+	float m_tileSize = 32.0f;
 };
 
 }
@@ -64,17 +64,17 @@ void NavMeshComponentEditor::draw(render::PrimitiveRenderer* primitiveRenderer)
 		primitiveRenderer->pushWorld(Matrix44::identity());
 		primitiveRenderer->pushDepthState(true, false, false);
 
-		const uint16_t* nmp = navMesh->m_navMeshPolygons.c_ptr();
+		const uint32_t* nmp = navMesh->m_navMeshPolygons.c_ptr();
 		T_ASSERT(nmp);
 
 		for (uint32_t i = 0; i < navMesh->m_navMeshPolygons.size(); )
 		{
-			const uint16_t npv = nmp[i++];
-			for (uint16_t j = 0; j < npv - 2; ++j)
+			const uint32_t npv = nmp[i++];
+			for (uint32_t j = 0; j < npv - 2; ++j)
 			{
-				const uint16_t i0 = nmp[i];
-				const uint16_t i1 = nmp[i + j + 1];
-				const uint16_t i2 = nmp[i + j + 2];
+				const uint32_t i0 = nmp[i];
+				const uint32_t i1 = nmp[i + j + 1];
+				const uint32_t i2 = nmp[i + j + 2];
 				primitiveRenderer->drawSolidTriangle(
 					navMesh->m_navMeshVertices[i0],
 					navMesh->m_navMeshVertices[i1],
@@ -90,11 +90,11 @@ void NavMeshComponentEditor::draw(render::PrimitiveRenderer* primitiveRenderer)
 
 		for (uint32_t i = 0; i < navMesh->m_navMeshPolygons.size(); )
 		{
-			const uint16_t npv = nmp[i++];
-			for (uint16_t j = 0; j < npv; ++j)
+			const uint32_t npv = nmp[i++];
+			for (uint32_t j = 0; j < npv; ++j)
 			{
-				const uint16_t i0 = nmp[i + j];
-				const uint16_t i1 = nmp[i + (j + 1) % npv];
+				const uint32_t i0 = nmp[i + j];
+				const uint32_t i1 = nmp[i + (j + 1) % npv];
 				primitiveRenderer->drawLine(
 					navMesh->m_navMeshVertices[i0],
 					navMesh->m_navMeshVertices[i1],
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Ai/NavCrowdComponentData.h"
 #include "Ai/NavMeshComponentData.h"
 #include "Ai/Editor/NavMeshEntityPipeline.h"
 #include "Editor/IPipelineDepends.h"
@@ -13,11 +14,11 @@
 namespace traktor::ai
 {
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.ai.NavMeshEntityPipeline", 1, NavMeshEntityPipeline, world::EntityPipeline)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.ai.NavMeshEntityPipeline", 2, NavMeshEntityPipeline, world::EntityPipeline)
 
 TypeInfoSet NavMeshEntityPipeline::getAssetTypes() const
 {
-	return makeTypeInfoSet< NavMeshComponentData >();
+	return makeTypeInfoSet< NavMeshComponentData, NavCrowdComponentData >();
 }
 
 bool NavMeshEntityPipeline::buildDependencies(
@@ -28,12 +29,17 @@ bool NavMeshEntityPipeline::buildDependencies(
 	const Guid& outputGuid
 ) const
 {
-	const NavMeshComponentData* entityData = checked_type_cast< const NavMeshComponentData*, false >(sourceAsset);
-
 	if (!world::EntityPipeline::buildDependencies(pipelineDepends, sourceInstance, sourceAsset, outputPath, outputGuid))
 		return false;
 
-	pipelineDepends->addDependency(entityData->get(), editor::PdfResource | editor::PdfBuild);
+	if (auto navCrowdComponentData = dynamic_type_cast< const NavCrowdComponentData* >(sourceAsset))
+		pipelineDepends->addDependency(navCrowdComponentData->getNavMesh(), editor::PdfResource | editor::PdfBuild);
+	else
+	{
+		const NavMeshComponentData* entityData = checked_type_cast< const NavMeshComponentData*, false >(sourceAsset);
+		pipelineDepends->addDependency(entityData->get(), editor::PdfResource | editor::PdfBuild);
+	}
+
 	return true;
 }
 
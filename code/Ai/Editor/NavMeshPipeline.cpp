@@ -11,14 +11,21 @@
 #include "Ai/Editor/NavMeshAsset.h"
 #include "Ai/NavMeshResource.h"
 #include "Core/Io/IStream.h"
+#include "Core/Io/Reader.h"
 #include "Core/Io/Writer.h"
 #include "Core/Log/Log.h"
-#include "Core/Misc/AutoPtr.h"
+#include "Core/Math/Log2.h"
+#include "Core/Misc/Murmur3.h"
 #include "Core/Misc/String.h"
 #include "Core/Misc/TString.h"
 #include "Core/Settings/PropertyBoolean.h"
 #include "Core/Settings/PropertyInteger.h"
 #include "Core/Settings/PropertyString.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/Job.h"
+#include "Core/Thread/JobManager.h"
+#include "Core/Timer/Timer.h"
+#include "Database/Database.h"
 #include "Database/Instance.h"
 #include "Editor/IPipelineBuilder.h"
 #include "Editor/IPipelineDepends.h"
@@ -35,6 +42,7 @@
 #include "World/Entity/VolumeComponentData.h"
 #include "World/EntityData.h"
 
+#include <atomic>
 #include <cstring>
 #include <DetourNavMesh.h>
 #include <DetourNavMeshBuilder.h>
@@ -47,6 +55,7 @@ namespace
 {
 
 const float c_oceanThreshold = 0.25f;
+const uint32_t c_tileBuildVersion = 2;	//!< Increment to invalidate tiles from previous builds.
 
 class BuildContext : public rcContext
 {
@@ -71,6 +80,43 @@ struct NavMeshSourceModel
 	}
 };
 
+/*! Merged, world space, triangles of all source models. */
+struct NavMeshGeometry
+{
+	AlignedVector< float > vertices;
+	AlignedVector< int32_t > indices;
+};
+
+/*! Built tile, data is null if tile is empty. */
+struct NavMeshTile
+{
+	int32_t x = 0;
+	int32_t z = 0;
+	uint32_t hash = 0;
+	uint8_t* data = nullptr;
+	int32_t dataSize = 0;
+	bool reused = false;
+};
+
+/*! Recast intermediates of a single tile, released when leaving scope. */
+struct TileIntermediates
+{
+	rcHeightfield* solid = nullptr;
+	rcCompactHeightfield* chf = nullptr;
+	rcContourSet* cset = nullptr;
+	rcPolyMesh* pmesh = nullptr;
+	rcPolyMeshDetail* dmesh = nullptr;
+
+	~TileIntermediates()
+	{
+		rcFreeHeightField(solid);
+		rcFreeCompactHeightfield(chf);
+		rcFreeContourSet(cset);
+		rcFreePolyMesh(pmesh);
+		rcFreePolyMeshDetail(dmesh);
+	}
+};
+
 void copyUnaligned3(float out[3], const Vector4& source)
 {
 	out[0] = source.x();
@@ -78,15 +124,186 @@ void copyUnaligned3(float out[3], const Vector4& source)
 	out[2] = source.z();
 }
 
+/*! Build Detour data of a single tile.
+ *
+ * \param cfg Recast configuration, bounds including border, of tile.
+ * \param baseParams Detour parameters, shared by all tiles.
+ * \param geometry Source geometry.
+ * \param triangles Triangles overlapping tile, including border.
+ * \param inoutTile Tile; data is left null if tile is empty.
+ * \return True if successful, even if tile is empty.
+ */
+bool buildTile(const rcConfig& cfg, const dtNavMeshCreateParams& baseParams, const NavMeshGeometry& geometry, const AlignedVector< int32_t >& triangles, NavMeshTile& inoutTile)
+{
+	BuildContext ctx;
+	TileIntermediates ti;
+
+	const int32_t triangleCount = (int32_t)triangles.size();
+	const int32_t vertexCount = (int32_t)(geometry.vertices.size() / 3);
+
+	AlignedVector< int32_t > indices(triangleCount * 3);
+	for (int32_t i = 0; i < triangleCount; ++i)
+	{
+		const int32_t* triangle = &geometry.indices[triangles[i] * 3];
+		indices[i * 3 + 0] = triangle[0];
+		indices[i * 3 + 1] = triangle[1];
+		indices[i * 3 + 2] = triangle[2];
+	}
+
+	AlignedVector< uint8_t > triAreas(triangleCount, uint8_t(0));
+
+	if ((ti.solid = rcAllocHeightfield()) == nullptr)
+	{
+		log::error << L"NavMesh pipeline failed; unable to allocate Recast heightfield." << Endl;
+		return false;
+	}
+
+	if (!rcCreateHeightfield(&ctx, *ti.solid, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
+	{
+		log::error << L"NavMesh pipeline failed; unable to create Recast heightfield." << Endl;
+		return false;
+	}
+
+	rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, geometry.vertices.c_ptr(), vertexCount, indices.c_ptr(), triangleCount, triAreas.ptr());
+	if (!rcRasterizeTriangles(&ctx, geometry.vertices.c_ptr(), vertexCount, indices.c_ptr(), triAreas.c_ptr(), triangleCount, *ti.solid, cfg.walkableClimb))
+	{
+		log::error << L"NavMesh pipeline failed; unable to rasterize triangles." << Endl;
+		return false;
+	}
+
+	// Once all geometry is rasterized, we do initial pass of filtering to
+	// remove unwanted overhangs caused by the conservative rasterization
+	// as well as filter spans where the character cannot possibly stand.
+	rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *ti.solid);
+	rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *ti.solid);
+	rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *ti.solid);
+
+	// Compact the heightfield so that it is faster to handle from now on.
+	// This will result more cache coherent data as well as the neighbors
+	// between walkable cells will be calculated.
+	if ((ti.chf = rcAllocCompactHeightfield()) == nullptr)
+	{
+		log::error << L"NavMesh pipeline failed; unable to allocate Recast compact heightfield." << Endl;
+		return false;
+	}
+
+	if (!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *ti.solid, *ti.chf))
+	{
+		log::error << L"NavMesh pipeline failed; unable to build Recast compact heightfield." << Endl;
+		return false;
+	}
+
+	rcFreeHeightField(ti.solid);
+	ti.solid = nullptr;
+
+	// Erode the walkable area by agent radius.
+	if (!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *ti.chf))
+	{
+		log::error << L"NavMesh pipeline failed; unable to erode Recast walkable area." << Endl;
+		return false;
+	}
+
+	// Prepare for region partitioning, by calculating distance field along the walkable surface.
+	if (!rcBuildDistanceField(&ctx, *ti.chf))
+	{
+		log::error << L"NavMesh pipeline failed; unable to build distance field." << Endl;
+		return false;
+	}
+
+	// Partition the walkable surface into simple regions without holes.
+	if (!rcBuildRegions(&ctx, *ti.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
+	{
+		log::error << L"NavMesh pipeline failed; unable to build regions." << Endl;
+		return false;
+	}
+
+	// Trace and simplify region contours.
+	if ((ti.cset = rcAllocContourSet()) == nullptr)
+	{
+		log::error << L"NavMesh pipeline failed; unable to allocate Recast contour set." << Endl;
+		return false;
+	}
+
+	if (!rcBuildContours(&ctx, *ti.chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *ti.cset))
+	{
+		log::error << L"NavMesh pipeline failed; unable to build Recast contours." << Endl;
+		return false;
+	}
+
+	// Build polygon navmesh from the contours.
+	if ((ti.pmesh = rcAllocPolyMesh()) == nullptr)
+	{
+		log::error << L"NavMesh pipeline failed; unable to allocate Recast polygon mesh." << Endl;
+		return false;
+	}
+
+	if (!rcBuildPolyMesh(&ctx, *ti.cset, cfg.maxVertsPerPoly, *ti.pmesh))
+	{
+		log::error << L"NavMesh pipeline failed; unable to build Recast polygon mesh." << Endl;
+		return false;
+	}
+
+	// Create detail mesh which allows to access approximate height on each polygon.
+	if ((ti.dmesh = rcAllocPolyMeshDetail()) == nullptr)
+	{
+		log::error << L"NavMesh pipeline failed; unable to allocate Recast polygon detail mesh." << Endl;
+		return false;
+	}
+
+	if (!rcBuildPolyMeshDetail(&ctx, *ti.pmesh, *ti.chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *ti.dmesh))
+	{
+		log::error << L"NavMesh pipeline failed; unable to build Recast polygon detail mesh." << Endl;
+		return false;
+	}
+
+	// Nothing walkable in tile.
+	const rcPolyMesh* pmesh = ti.pmesh;
+	if (pmesh->npolys <= 0)
+		return true;
+
+	for (int i = 0; i < pmesh->npolys; ++i)
+		if (pmesh->areas[i] == RC_WALKABLE_AREA)
+			pmesh->flags[i] = 0xffff;
+
+	// Create Detour tile data.
+	dtNavMeshCreateParams params = baseParams;
+	params.verts = pmesh->verts;
+	params.vertCount = pmesh->nverts;
+	params.polys = pmesh->polys;
+	params.polyAreas = pmesh->areas;
+	params.polyFlags = pmesh->flags;
+	params.polyCount = pmesh->npolys;
+	params.nvp = pmesh->nvp;
+	params.detailMeshes = ti.dmesh->meshes;
+	params.detailVerts = ti.dmesh->verts;
+	params.detailVertsCount = ti.dmesh->nverts;
+	params.detailTris = ti.dmesh->tris;
+	params.detailTriCount = ti.dmesh->ntris;
+	params.tileX = inoutTile.x;
+	params.tileY = inoutTile.z;
+	params.tileLayer = 0;
+	rcVcopy(params.bmin, pmesh->bmin);
+	rcVcopy(params.bmax, pmesh->bmax);
+
+	if (!dtCreateNavMeshData(&params, &inoutTile.data, &inoutTile.dataSize))
+	{
+		log::error << L"NavMesh pipeline failed; unable to create Detour navigation mesh data of tile " << inoutTile.x << L", " << inoutTile.z << L"." << Endl;
+		return false;
+	}
+
+	return true;
+}
+
 }
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.ai.NavMeshPipeline", 13, NavMeshPipeline, editor::DefaultPipeline)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.ai.NavMeshPipeline", 14, NavMeshPipeline, editor::DefaultPipeline)
 
 bool NavMeshPipeline::create(const editor::IPipelineSettings* settings, db::Database* database)
 {
 	m_assetPath = settings->getPropertyExcludeHash< std::wstring >(L"Pipeline.AssetPath", L"");
 	m_editor = settings->getPropertyIncludeHash< bool >(L"Pipeline.TargetEditor", false);
 	m_build = settings->getPropertyIncludeHash< bool >(L"NavMeshPipeline.Build", true);
+	m_buildThreads = settings->getPropertyExcludeHash< int32_t >(L"NavMeshPipeline.BuildThreads", 0);
 
 	// Create entity replicators.
 	for (const auto& entityReplicatorType : type_of< world::IEntityReplicator >().findAllOf(false))
@@ -247,7 +464,6 @@ bool NavMeshPipeline::buildOutput(
 	log::info << L"\t" << navModelsTriangleCount << L" triangle(s) loaded." << Endl;
 	log::info << L"Generating navigation mesh..." << Endl;
 
-	BuildContext ctx;
 	rcConfig cfg;
 
 	std::memset(&cfg, 0, sizeof(cfg));
@@ -265,264 +481,304 @@ bool NavMeshPipeline::buildOutput(
 	cfg.detailSampleDist = (asset->m_detailSampleDistance < 0.9f) ? 0.0f : asset->m_cellSize * asset->m_detailSampleDistance;
 	cfg.detailSampleMaxError = asset->m_cellHeight * asset->m_detailSampleMaxError;
 
-	copyUnaligned3(cfg.bmin, navModelsAabb.mn);
-	copyUnaligned3(cfg.bmax, navModelsAabb.mx);
+	// Tiles overlap neighbours by a border to ensure tile edges are matching.
+	cfg.tileSize = std::max(int(std::ceil(asset->m_tileSize / cfg.cs)), 16);
+	cfg.borderSize = cfg.walkableRadius + 3;
+	cfg.width = cfg.tileSize + cfg.borderSize * 2;
+	cfg.height = cfg.tileSize + cfg.borderSize * 2;
 
-	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
+	float navBoundsMin[3], navBoundsMax[3];
+	copyUnaligned3(navBoundsMin, navModelsAabb.mn);
+	copyUnaligned3(navBoundsMax, navModelsAabb.mx);
 
-	log::info << L"NavMesh heightfield size " << cfg.width << L" * " << cfg.height << L"." << Endl;
+	int32_t gridWidth = 0, gridHeight = 0;
+	rcCalcGridSize(navBoundsMin, navBoundsMax, cfg.cs, &gridWidth, &gridHeight);
 
-	rcHeightfield* solid = rcAllocHeightfield();
-	if (!solid)
-	{
-		log::error << L"NavMesh pipeline failed; unable to allocate Recast heightfield." << Endl;
-		return false;
-	}
+	// Tiles are aligned to a world grid, with tile coordinates relative to world origin,
+	// so a tile's location doesn't depend on bounds of entire navigation mesh.
+	const float tileWorldSize = cfg.tileSize * cfg.cs;
+	const float borderWorldSize = cfg.borderSize * cfg.cs;
+	const int32_t tileOriginX = int32_t(std::floor(navBoundsMin[0] / tileWorldSize));
+	const int32_t tileOriginZ = int32_t(std::floor(navBoundsMin[2] / tileWorldSize));
+	const int32_t tilesX = std::max(int32_t(std::floor(navBoundsMax[0] / tileWorldSize)) - tileOriginX + 1, 1);
+	const int32_t tilesZ = std::max(int32_t(std::floor(navBoundsMax[2] / tileWorldSize)) - tileOriginZ + 1, 1);
 
-	if (!rcCreateHeightfield(&ctx, *solid, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
-	{
-		log::error << L"NavMesh pipeline failed; unable to create Recast heightfield." << Endl;
-		return false;
-	}
-
-	// Allocate array that can hold triangle area types.
-	// If you have multiple meshes you need to process, allocate
-	// and array which can hold the max number of triangles you need to process.
-	AutoArrayPtr< uint8_t > triAreas(new uint8_t[navModelsTriangleCount]);
-	if (!triAreas.c_ptr())
-	{
-		log::error << L"NavMesh pipeline failed; unable to allocate memory." << Endl;
-		return false;
-	}
+	log::info << L"NavMesh heightfield size " << gridWidth << L" * " << gridHeight << L", " << tilesX << L" * " << tilesZ << L" tile(s)." << Endl;
 
-	std::memset(triAreas.ptr(), 0, navModelsTriangleCount * sizeof(uint8_t));
+	// Merge all source models into world space triangles.
+	NavMeshGeometry geometry;
+	geometry.vertices.reserve(navModelsTriangleCount * 3);
+	geometry.indices.reserve(navModelsTriangleCount * 3);
 
+	for (auto& navModel : navModels)
 	{
-		AlignedVector< int32_t > indices;
+		const int32_t vertexOffset = (int32_t)(geometry.vertices.size() / 3);
+		const int32_t vertexCount = navModel.model->getVertexCount();
+		const int32_t triangleCount = navModel.model->getPolygonCount();
 
-		uint8_t* triAreaPtr = triAreas.ptr();
-		for (auto& navModel : navModels)
+		for (int32_t j = 0; j < vertexCount; ++j)
 		{
-			int32_t vertexCount = navModel.model->getVertexCount();
-			int32_t triangleCount = navModel.model->getPolygonCount();
-
-			AutoArrayPtr< float > vertices(new float[3 * vertexCount]);
-			for (int32_t j = 0; j < vertexCount; ++j)
-			{
-				const Vector4& position = navModel.model->getVertexPosition(j);
-				copyUnaligned3(&vertices[j * 3], navModel.transform * position.xyz1());
-			}
-
-			indices.resize(0);
-			indices.reserve(3 * triangleCount);
-
-			for (int32_t j = 0; j < triangleCount; ++j)
-			{
-				const model::Polygon& triangle = navModel.model->getPolygon(j);
-				T_ASSERT(triangle.getVertexCount() == 3);
-
-				if (oceanClip)
-				{
-					if (vertices[triangle.getVertex(0) * 3 + 1] < oceanHeight - c_oceanThreshold)
-						continue;
-					if (vertices[triangle.getVertex(1) * 3 + 1] < oceanHeight - c_oceanThreshold)
-						continue;
-					if (vertices[triangle.getVertex(2) * 3 + 1] < oceanHeight - c_oceanThreshold)
-						continue;
-				}
-
-				indices.push_back(triangle.getVertex(2));
-				indices.push_back(triangle.getVertex(1));
-				indices.push_back(triangle.getVertex(0));
-			}
+			const Vector4 position = navModel.transform * navModel.model->getVertexPosition(j).xyz1();
+			geometry.vertices.push_back(position.x());
+			geometry.vertices.push_back(position.y());
+			geometry.vertices.push_back(position.z());
+		}
 
-			T_ASSERT(indices.size() / 3 <= triangleCount);
+		const float* vertices = &geometry.vertices[vertexOffset * 3];
+		for (int32_t j = 0; j < triangleCount; ++j)
+		{
+			const model::Polygon& triangle = navModel.model->getPolygon(j);
+			T_ASSERT(triangle.getVertexCount() == 3);
 
-			if (!indices.empty())
+			if (oceanClip)
 			{
-				rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, vertices.c_ptr(), vertexCount, &indices[0], (int)(indices.size() / 3), triAreaPtr);
-				rcRasterizeTriangles(&ctx, vertices.c_ptr(), vertexCount, &indices[0], triAreaPtr, (int)(indices.size() / 3), *solid, cfg.walkableClimb);
+				if (vertices[triangle.getVertex(0) * 3 + 1] < oceanHeight - c_oceanThreshold)
+					continue;
+				if (vertices[triangle.getVertex(1) * 3 + 1] < oceanHeight - c_oceanThreshold)
+					continue;
+				if (vertices[triangle.getVertex(2) * 3 + 1] < oceanHeight - c_oceanThreshold)
+					continue;
 			}
 
-			navModel.model = nullptr;
-
-			triAreaPtr += triangleCount;
+			geometry.indices.push_back(vertexOffset + triangle.getVertex(2));
+			geometry.indices.push_back(vertexOffset + triangle.getVertex(1));
+			geometry.indices.push_back(vertexOffset + triangle.getVertex(0));
 		}
-	}
-
-	//
-	// Step 3. Filter walkables surfaces.
-	//
-
-	// Once all geometry is rasterized, we do initial pass of filtering to
-	// remove unwanted overhangs caused by the conservative rasterization
-	// as well as filter spans where the character cannot possibly stand.
-	rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *solid);
-	rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid);
-	rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *solid);
-
-	//
-	// Step 4. Partition walkable surface to simple regions.
-	//
 
-	// Compact the heightfield so that it is faster to handle from now on.
-	// This will result more cache coherent data as well as the neighbors
-	// between walkable cells will be calculated.
-	rcCompactHeightfield* chf = rcAllocCompactHeightfield();
-	if (!chf)
-	{
-		log::error << L"NavMesh pipeline failed; unable to allocate Recast compact heightfield." << Endl;
-		return false;
+		navModel.model = nullptr;
 	}
 
-	if (!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid, *chf))
+	// Bin triangles into each tile they overlap, including border.
+	AlignedVector< AlignedVector< int32_t > > tileTriangles(tilesX * tilesZ);
+	for (int32_t i = 0; i < (int32_t)geometry.indices.size() / 3; ++i)
 	{
-		log::error << L"NavMesh pipeline failed; unable to build Recast compact heightfield." << Endl;
-		return false;
-	}
-
-	rcFreeHeightField(solid);
-	solid = 0;
-
-	// Erode the walkable area by agent radius.
-	if (!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf))
-	{
-		log::error << L"NavMesh pipeline failed; unable to erode Recast walkable area." << Endl;
-		return false;
-	}
-
-	//// (Optional) Mark areas.
-	// const ConvexVolume* vols = m_geom->getConvexVolumes();
-	// for (int i  = 0; i < m_geom->getConvexVolumeCount(); ++i)
-	//	rcMarkConvexPolyArea(ctx, vols[i].verts, vols[i].nverts, vols[i].hmin, vols[i].hmax, (unsigned char)vols[i].area, *chf);
-
-	const bool c_monotonePartitioning = false;
-	if (c_monotonePartitioning)
-	{
-		// Partition the walkable surface into simple regions without holes.
-		// Monotone partitioning does not need distance field.
-		if (!rcBuildRegionsMonotone(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+		float mnx = std::numeric_limits< float >::max(), mnz = std::numeric_limits< float >::max();
+		float mxx = -std::numeric_limits< float >::max(), mxz = -std::numeric_limits< float >::max();
+		for (int32_t j = 0; j < 3; ++j)
 		{
-			log::error << L"NavMesh pipeline failed; unable to build region monotones." << Endl;
-			return false;
-		}
-	}
-	else
-	{
-		// Prepare for region partitioning, by calculating distance field along the walkable surface.
-		if (!rcBuildDistanceField(&ctx, *chf))
-		{
-			log::error << L"NavMesh pipeline failed; unable to build distance field." << Endl;
-			return false;
+			const float* v = &geometry.vertices[geometry.indices[i * 3 + j] * 3];
+			mnx = std::min(mnx, v[0]);
+			mnz = std::min(mnz, v[2]);
+			mxx = std::max(mxx, v[0]);
+			mxz = std::max(mxz, v[2]);
 		}
 
-		// Partition the walkable surface into simple regions without holes.
-		if (!rcBuildRegions(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+		const int32_t tx0 = std::max(int32_t(std::floor((mnx - borderWorldSize) / tileWorldSize)) - tileOriginX, 0);
+		const int32_t tz0 = std::max(int32_t(std::floor((mnz - borderWorldSize) / tileWorldSize)) - tileOriginZ, 0);
+		const int32_t tx1 = std::min(int32_t(std::floor((mxx + borderWorldSize) / tileWorldSize)) - tileOriginX, tilesX - 1);
+		const int32_t tz1 = std::min(int32_t(std::floor((mxz + borderWorldSize) / tileWorldSize)) - tileOriginZ, tilesZ - 1);
+		for (int32_t tz = tz0; tz <= tz1; ++tz)
 		{
-			log::error << L"NavMesh pipeline failed; unable to build regions." << Endl;
-			return false;
+			for (int32_t tx = tx0; tx <= tx1; ++tx)
+				tileTriangles[tx + tz * tilesX].push_back(i);
 		}
 	}
 
-	//
-	// Step 5. Trace and simplify region contours.
-	//
-
-	// Create contours.
-	rcContourSet* cset = rcAllocContourSet();
-	if (!cset)
+	// Setup tiles and calculate hash of each tile's input so unchanged tiles can be reused;
+	// only tile local input is hashed thus changing bounds doesn't invalidate other tiles.
+	AlignedVector< rcConfig > tileConfigs(tilesX * tilesZ);
+	AlignedVector< NavMeshTile > tiles(tilesX * tilesZ);
+	for (int32_t tz = 0; tz < tilesZ; ++tz)
 	{
-		log::error << L"NavMesh pipeline failed; unable to allocate Recast contour set." << Endl;
-		return false;
+		for (int32_t tx = 0; tx < tilesX; ++tx)
+		{
+			const int32_t tileIndex = tx + tz * tilesX;
+			const int32_t x = tileOriginX + tx;
+			const int32_t z = tileOriginZ + tz;
+
+			// Vertical extent from tile's own triangles, snapped to cell height.
+			float mny = std::numeric_limits< float >::max();
+			float mxy = -std::numeric_limits< float >::max();
+			for (auto triangle : tileTriangles[tileIndex])
+			{
+				for (int32_t j = 0; j < 3; ++j)
+				{
+					const float y = geometry.vertices[geometry.indices[triangle * 3 + j] * 3 + 1];
+					mny = std::min(mny, y);
+					mxy = std::max(mxy, y);
+				}
+			}
+			mny = std::max(mny, navBoundsMin[1]);
+			mxy = std::min(mxy, navBoundsMax[1]);
+
+			rcConfig& tileCfg = tileConfigs[tileIndex];
+			tileCfg = cfg;
+			tileCfg.bmin[0] = x * tileWorldSize - borderWorldSize;
+			tileCfg.bmin[1] = std::floor(mny / cfg.ch) * cfg.ch;
+			tileCfg.bmin[2] = z * tileWorldSize - borderWorldSize;
+			tileCfg.bmax[0] = (x + 1) * tileWorldSize + borderWorldSize;
+			tileCfg.bmax[1] = std::max(std::ceil(mxy / cfg.ch) * cfg.ch, tileCfg.bmin[1] + cfg.ch);
+			tileCfg.bmax[2] = (z + 1) * tileWorldSize + borderWorldSize;
+
+			Murmur3 hash;
+			hash.begin();
+			hash.feed(c_tileBuildVersion);
+			hash.feed(x);
+			hash.feed(z);
+			hash.feedBuffer(&tileCfg, sizeof(tileCfg));
+			hash.feed(asset->m_agentHeight);
+			hash.feed(asset->m_agentRadius);
+			hash.feed(asset->m_agentClimb);
+			for (auto triangle : tileTriangles[tileIndex])
+			{
+				for (int32_t j = 0; j < 3; ++j)
+					hash.feedBuffer(&geometry.vertices[geometry.indices[triangle * 3 + j] * 3], 3 * sizeof(float));
+			}
+			hash.end();
+
+			NavMeshTile& tile = tiles[tileIndex];
+			tile.x = x;
+			tile.z = z;
+			tile.hash = hash.get();
+		}
 	}
 
-	if (!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset))
+	// Reuse tiles from previous build which have same input.
+	uint32_t reusedCount = 0;
+	if (Ref< db::Instance > previousInstance = pipelineBuilder->getOutputDatabase()->getInstance(outputGuid))
 	{
-		log::error << L"NavMesh pipeline failed; unable to build Recast contours." << Endl;
-		return false;
-	}
+		Ref< IStream > stream = previousInstance->readData(L"Data");
+		if (stream)
+		{
+			Reader r(stream);
 
-	//
-	// Step 6. Build polygons mesh from contours.
-	//
+			uint8_t version = 0;
+			r >> version;
+			if (version == 3)
+			{
+				dtNavMeshParams previousParams;
+				r >> previousParams.orig[0];
+				r >> previousParams.orig[1];
+				r >> previousParams.orig[2];
+				r >> previousParams.tileWidth;
+				r >> previousParams.tileHeight;
+				r >> previousParams.maxTiles;
+				r >> previousParams.maxPolys;
+
+				uint32_t previousTileCount = 0;
+				r >> previousTileCount;
+
+				for (uint32_t i = 0; i < previousTileCount; ++i)
+				{
+					int32_t tileX, tileZ, tileDataSize;
+					uint32_t tileHash;
+					r >> tileX;
+					r >> tileZ;
+					r >> tileHash;
+					r >> tileDataSize;
+					if (tileDataSize <= 0)
+						break;
+
+					NavMeshTile* tile = nullptr;
+					const int32_t tx = tileX - tileOriginX;
+					const int32_t tz = tileZ - tileOriginZ;
+					if (tx >= 0 && tx < tilesX && tz >= 0 && tz < tilesZ)
+						tile = &tiles[tx + tz * tilesX];
+
+					if (tile && tile->hash == tileHash && !tile->reused)
+					{
+						tile->data = (uint8_t*)dtAlloc(tileDataSize, DT_ALLOC_PERM);
+						tile->dataSize = tileDataSize;
+						if (stream->read(tile->data, tileDataSize) != tileDataSize)
+						{
+							dtFree(tile->data);
+							tile->data = nullptr;
+							tile->dataSize = 0;
+							break;
+						}
+						tile->reused = true;
+						++reusedCount;
+					}
+					else
+					{
+						if (stream->seek(IStream::SeekCurrent, tileDataSize) < 0)
+							break;
+					}
+				}
+			}
 
-	// Build polygon navmesh from the contours.
-	rcPolyMesh* pmesh = rcAllocPolyMesh();
-	if (!pmesh)
-	{
-		log::error << L"NavMesh pipeline failed; unable to allocate Recast polygon mesh." << Endl;
-		return false;
+			stream->close();
+			stream = nullptr;
+		}
 	}
 
-	if (!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *pmesh))
+	// Build remaining, non-empty, tiles in parallel.
+	AlignedVector< int32_t > buildTiles;
+	for (int32_t i = 0; i < (int32_t)tiles.size(); ++i)
 	{
-		log::error << L"NavMesh pipeline failed; unable to build Recast polygon mesh." << Endl;
-		return false;
+		if (!tiles[i].reused && !tileTriangles[i].empty())
+			buildTiles.push_back(i);
 	}
 
-	//
-	// Step 7. Create detail mesh which allows to access approximate height on each polygon.
-	//
+	dtNavMeshCreateParams baseParams;
+	std::memset(&baseParams, 0, sizeof(baseParams));
+	baseParams.walkableHeight = asset->m_agentHeight;
+	baseParams.walkableRadius = asset->m_agentRadius;
+	baseParams.walkableClimb = asset->m_agentClimb;
+	baseParams.cs = cfg.cs;
+	baseParams.ch = cfg.ch;
+	baseParams.buildBvTree = true;
 
-	rcPolyMeshDetail* dmesh = rcAllocPolyMeshDetail();
-	if (!dmesh)
-	{
-		log::error << L"NavMesh pipeline failed; unable to allocate Recast polygon detail mesh." << Endl;
-		return false;
-	}
+	std::atomic< int32_t > nextBuildTile(0);
+	std::atomic< bool > buildFailed(false);
 
-	if (!rcBuildPolyMeshDetail(&ctx, *pmesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *dmesh))
-	{
-		log::error << L"NavMesh pipeline failed; unable to build Recast polygon detail mesh." << Endl;
-		return false;
-	}
-
-	rcFreeCompactHeightfield(chf);
-	chf = 0;
+	auto worker = [&]() {
+		for (;;)
+		{
+			const int32_t i = nextBuildTile++;
+			if (i >= (int32_t)buildTiles.size() || buildFailed)
+				break;
 
-	rcFreeContourSet(cset);
-	cset = 0;
+			const int32_t tileIndex = buildTiles[i];
+			if (!buildTile(tileConfigs[tileIndex], baseParams, geometry, tileTriangles[tileIndex], tiles[tileIndex]))
+				buildFailed = true;
+		}
+	};
 
-	//
-	// Step 8. Create Detour navigation mesh.
-	//
+	// Number of threads can be limited in settings, to measure
+	// build time with fewer threads; zero means all cores.
+	const uint32_t threadCount = (m_buildThreads > 0) ? (uint32_t)m_buildThreads : std::max(OS::getInstance().getCPUCoreCount(), 1U);
+	const uint32_t workerCount = std::min< uint32_t >(threadCount, (uint32_t)buildTiles.size());
 
-	for (int i = 0; i < pmesh->npolys; ++i)
-		if (pmesh->areas[i] == RC_WALKABLE_AREA)
-			pmesh->flags[i] = 0xffff;
+	Timer timer;
+	if (workerCount > 1)
+	{
+		AlignedVector< Job::task_t > jobs(workerCount, worker);
+		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+	}
+	else
+		worker();
 
-	dtNavMeshCreateParams params;
-	std::memset(&params, 0, sizeof(params));
+	log::info << L"NavMesh " << (uint32_t)buildTiles.size() << L" tile(s) built, " << reusedCount << L" reused, in " << int32_t(timer.getElapsedTime() * 1000.0) << L" ms using " << workerCount << L" thread(s)." << Endl;
 
-	params.verts = pmesh->verts;
-	params.vertCount = pmesh->nverts;
-	params.polys = pmesh->polys;
-	params.polyAreas = pmesh->areas;
-	params.polyFlags = pmesh->flags;
-	params.polyCount = pmesh->npolys;
-	params.nvp = pmesh->nvp;
-	params.detailMeshes = dmesh->meshes;
-	params.detailVerts = dmesh->verts;
-	params.detailVertsCount = dmesh->nverts;
-	params.detailTris = dmesh->tris;
-	params.detailTriCount = dmesh->ntris;
-	params.walkableHeight = asset->m_agentHeight;
-	params.walkableRadius = asset->m_agentRadius;
-	params.walkableClimb = asset->m_agentClimb;
-	rcVcopy(params.bmin, pmesh->bmin);
-	rcVcopy(params.bmax, pmesh->bmax);
-	params.cs = cfg.cs;
-	params.ch = cfg.ch;
-	params.buildBvTree = false;
+	auto freeTiles = [&]() {
+		for (auto& tile : tiles)
+		{
+			dtFree(tile.data);
+			tile.data = nullptr;
+		}
+	};
 
-	uint8_t* navData = nullptr;
-	int32_t navDataSize = 0;
-	if (!dtCreateNavMeshData(&params, &navData, &navDataSize))
+	if (buildFailed)
 	{
-		log::error << L"NavMesh pipeline failed; unable to create Detour navigation mesh data." << Endl;
+		freeTiles();
 		return false;
 	}
 
+	// Detour tile and polygon references share bits; allocate bits according to number of tiles.
+	const int32_t tileBits = std::min< int32_t >(log2(nearestLog2(tilesX * tilesZ)), 14);
+	const int32_t polyBits = 22 - tileBits;
+
+	// Origin at world origin as tile coordinates are relative to world grid.
+	dtNavMeshParams navParams;
+	navParams.orig[0] = 0.0f;
+	navParams.orig[1] = 0.0f;
+	navParams.orig[2] = 0.0f;
+	navParams.tileWidth = tileWorldSize;
+	navParams.tileHeight = tileWorldSize;
+	navParams.maxTiles = 1 << tileBits;
+	navParams.maxPolys = 1 << polyBits;
+
 	// Save navigation data in resource.
 	Ref< NavMeshResource > outputResource = new NavMeshResource();
 
@@ -532,6 +788,7 @@ bool NavMeshPipeline::buildOutput(
 	if (!outputInstance)
 	{
 		log::error << L"NavMesh pipeline failed; unable to create output instance." << Endl;
+		freeTiles();
 		return false;
 	}
 
@@ -542,106 +799,62 @@ bool NavMeshPipeline::buildOutput(
 	{
 		log::error << L"NavMesh pipeline failed; unable to create data stream." << Endl;
 		outputInstance->revert();
+		freeTiles();
 		return false;
 	}
 
 	Writer w(stream);
 
-	w << uint8_t(2);
-	w << navDataSize;
-
-	if (stream->write(navData, navDataSize) != navDataSize)
+	w << uint8_t(3);
+	w << navParams.orig[0];
+	w << navParams.orig[1];
+	w << navParams.orig[2];
+	w << navParams.tileWidth;
+	w << navParams.tileHeight;
+	w << int32_t(navParams.maxTiles);
+	w << int32_t(navParams.maxPolys);
+
+	uint32_t tileCount = 0;
+	for (const auto& tile : tiles)
 	{
-		log::error << L"NavMesh pipeline failed; unable to write to data stream." << Endl;
-		outputInstance->revert();
-		return false;
+		if (tile.data)
+			++tileCount;
 	}
+	w << tileCount;
 
-	// Append geometry last in NavMesh resource; currently useful for editor
-	// but might come in handy later.
-	w << m_editor;
-	if (m_editor)
+	for (const auto& tile : tiles)
 	{
-		w << uint32_t(pmesh->nverts);
-		for (int32_t i = 0; i < pmesh->nverts; ++i)
-		{
-			w << pmesh->bmin[0] + pmesh->verts[i * 3 + 0] * pmesh->cs;
-			w << pmesh->bmin[1] + pmesh->verts[i * 3 + 1] * pmesh->ch;
-			w << pmesh->bmin[2] + pmesh->verts[i * 3 + 2] * pmesh->cs;
-		}
+		if (!tile.data)
+			continue;
 
-		w << uint32_t(pmesh->npolys);
-		for (int32_t i = 0; i < pmesh->npolys; ++i)
-		{
-			const uint16_t* p = &pmesh->polys[i * pmesh->nvp * 2];
-
-			int32_t nvp = 0;
-			for (; nvp < pmesh->nvp; ++nvp)
-				if (p[nvp] == RC_MESH_NULL_IDX)
-					break;
+		w << tile.x;
+		w << tile.z;
+		w << tile.hash;
+		w << tile.dataSize;
 
-			w << uint8_t(nvp);
-			for (uint32_t j = 0; j < (uint32_t)nvp; ++j)
-				w << uint16_t(p[j]);
+		if (stream->write(tile.data, tile.dataSize) != tile.dataSize)
+		{
+			log::error << L"NavMesh pipeline failed; unable to write to data stream." << Endl;
+			outputInstance->revert();
+			freeTiles();
+			return false;
 		}
 	}
 
+	// Geometry, for editor visualization, is extracted from tiles when loaded.
+	w << m_editor;
+
 	stream->close();
 	stream = nullptr;
 
+	freeTiles();
+
 	if (!outputInstance->commit())
 	{
 		log::error << L"NavMesh pipeline failed; unable to commit output instance." << Endl;
 		return false;
 	}
 
-	dtFree(navData);
-	navData = nullptr;
-
-	// Save pmesh for debugging; only in editor.
-	if (m_editor)
-	{
-		Ref< model::Model > pmeshModel = new model::Model();
-
-		for (int32_t i = 0; i < pmesh->nverts; ++i)
-		{
-			pmeshModel->addPosition(Vector4(
-				pmesh->bmin[0] + pmesh->verts[i * 3 + 0] * pmesh->cs,
-				pmesh->bmin[1] + pmesh->verts[i * 3 + 1] * pmesh->ch,
-				pmesh->bmin[2] + pmesh->verts[i * 3 + 2] * pmesh->cs,
-				1.0f));
-			pmeshModel->addVertex(model::Vertex(i));
-		}
-
-		for (int32_t i = 0; i < pmesh->npolys; ++i)
-		{
-			model::Polygon polygon;
-
-			const uint16_t* p = &pmesh->polys[i * pmesh->nvp * 2];
-			for (int32_t j = 0; j < pmesh->nvp; ++j)
-			{
-				if (p[j] == RC_MESH_NULL_IDX)
-					break;
-
-				polygon.addVertex(p[j]);
-			}
-
-			polygon.flipWinding();
-
-			pmeshModel->addPolygon(polygon);
-		}
-
-		pmeshModel->apply(model::Triangulate());
-
-		model::ModelFormat::writeAny(L"data/Temp/NavMesh_nav.obj", pmeshModel);
-	}
-
-	rcFreePolyMeshDetail(dmesh);
-	dmesh = nullptr;
-
-	rcFreePolyMesh(pmesh);
-	pmesh = nullptr;
-
 	return true;
 }
 
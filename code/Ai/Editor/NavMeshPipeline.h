@@ -67,6 +67,7 @@ private:
 	std::wstring m_assetPath;
 	bool m_editor = false;
 	bool m_build = true;
+	int32_t m_buildThreads = 0;
 	SmallMap< const TypeInfo*, Ref< const world::IEntityReplicator > > m_entityReplicators;
 };
 
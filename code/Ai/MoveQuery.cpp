@@ -6,7 +6,6 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
-#include <DetourNavMeshQuery.h>
 #include "Ai/MoveQuery.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Plane.h"
@@ -19,19 +18,11 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.ai.MoveQuery", MoveQuery, Object)
 MoveQuery::MoveQuery()
 :	m_startPosition(0.0f, 0.0f, 0.0f, 0.0f)
 ,	m_endPosition(0.0f, 0.0f, 0.0f, 0.0f)
-,	m_filter(new dtQueryFilter())
-,	m_navQuery(nullptr)
 ,	m_pathCount(0)
 ,	m_steerIndex(0)
 {
 }
 
-MoveQuery::~MoveQuery()
-{
-	dtFreeNavMeshQuery(m_navQuery);
-	delete m_filter;
-}
-
 bool MoveQuery::update(const Vector4& currentPosition, Vector4& outMoveToPosition, float nodeDistanceThreshold)
 {
 	const static Vector4 c_101(1.0f, 0.0f, 1.0f);
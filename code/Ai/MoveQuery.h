@@ -20,9 +20,6 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
-class dtNavMeshQuery;
-class dtQueryFilter;
-
 namespace traktor::ai
 {
 
@@ -36,8 +33,6 @@ class T_DLLCLASS MoveQuery : public Object
 public:
 	MoveQuery();
 
-	virtual ~MoveQuery();
-
 	/*! Update query to get desired "move to" position.
 	 *
 	 * \param currentPosition Current entity position.
@@ -57,8 +52,6 @@ private:
 
 	Vector4 m_startPosition;
 	Vector4 m_endPosition;
-	dtQueryFilter* m_filter;
-	dtNavMeshQuery* m_navQuery;
 	uint32_t m_path[MaxPathPolygons];
 	int32_t m_pathCount;
 	AlignedVector< Vector4 > m_steerPath;
@@ -8,6 +8,8 @@
  */
 #include "Ai/MoveQueryResult.h"
 
+#include "Ai/NavMesh.h"
+
 namespace traktor::ai
 {
 
@@ -21,6 +23,11 @@ void MoveQueryResult::succeed(MoveQuery* moveQuery)
 
 MoveQuery* MoveQueryResult::get() const
 {
+	// Process query immediately if not yet processed by navigation mesh update.
+	NavMesh* navMesh = m_navMesh;
+	if (!ready() && navMesh)
+		navMesh->complete(this);
+
 	wait();
 	return m_moveQuery;
 }
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Core/Thread/Result.h"
 
 // import/export mechanism.
@@ -22,6 +23,7 @@ namespace traktor::ai
 {
 
 class MoveQuery;
+class NavMesh;
 
 class T_DLLCLASS MoveQueryResult : public Result
 {
@@ -33,6 +35,9 @@ public:
 	MoveQuery* get() const;
 
 private:
+	friend class NavMesh;
+
+	std::atomic< NavMesh* > m_navMesh = nullptr;	//!< Owner navigation mesh while query is pending.
 	Ref< MoveQuery > m_moveQuery;
 };
 
@@ -0,0 +1,487 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Ai/NavCrowdComponent.h"
+
+#include "Ai/MoveQuery.h"
+#include "Ai/MoveQueryResult.h"
+#include "Ai/NavCrowdComponentData.h"
+#include "Ai/NavMesh.h"
+#include "Core/Math/Log2.h"
+#include "Core/Thread/Job.h"
+#include "Core/Thread/JobManager.h"
+#include "World/WorldTypes.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace traktor::ai
+{
+namespace
+{
+
+const uint32_t c_agentsPerJob = 256;		//!< Number of agents steered by each job.
+const uint32_t c_maxSlots = 0x10000;
+const uint32_t c_invalidIndex = ~0U;
+const float c_relaxationTime = 0.25f;		//!< Time, in seconds, to reach preferred velocity.
+const float c_arrivalTime = 0.5f;			//!< Agents slow down when this far from target, in seconds at max speed.
+const float c_separationGain = 4.0f;		//!< Overlapping agents are pushed apart by this many times overlap per second.
+const float c_timeToCollisionEpsilon = 0.05f;
+const float c_epsilon = 1e-4f;
+
+inline uint32_t hashCell(int32_t x, int32_t z)
+{
+	return (uint32_t)(x * 73856093) ^ (uint32_t)(z * 19349663);
+}
+
+}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.ai.NavCrowdComponent", NavCrowdComponent, world::IWorldComponent)
+
+NavCrowdComponent::NavCrowdComponent(const resource::Proxy< NavMesh >& navMesh, const NavCrowdComponentData* data)
+:	m_navMesh(navMesh)
+,	m_maxAgents(std::min< uint32_t >(std::max(data->getMaxAgents(), 1), c_maxSlots - 1))
+,	m_neighbourDistance(std::max(data->getNeighbourDistance(), c_epsilon))
+,	m_avoidanceHorizon(std::max(data->getAvoidanceHorizon(), c_epsilon))
+,	m_maxNeighbours((uint32_t)std::max(data->getMaxNeighbours(), 0))
+{
+}
+
+void NavCrowdComponent::destroy()
+{
+	m_positionX.clear();
+	m_positionY.clear();
+	m_positionZ.clear();
+	m_velocityX.clear();
+	m_velocityZ.clear();
+	m_newVelocityX.clear();
+	m_newVelocityZ.clear();
+	m_radius.clear();
+	m_maxSpeed.clear();
+	m_paths.clear();
+	m_indexSlots.clear();
+	m_slotIndices.clear();
+	m_slotGenerations.clear();
+	m_freeSlots.clear();
+	m_navMesh.clear();
+}
+
+void NavCrowdComponent::update(world::World* world, const world::UpdateParams& update)
+{
+	const uint32_t count = getAgentCount();
+	const float deltaTime = (float)update.deltaTime;
+	if (count == 0 || deltaTime <= 0.0f)
+		return;
+
+	// Process queued path queries; navigation mesh only spend
+	// budget once per frame even if shared with other components.
+	if (m_navMesh)
+		m_navMesh->update(update.totalTime);
+
+	// Pick up paths which has been found since last update.
+	for (auto& path : m_paths)
+	{
+		if (path.result && path.result->ready())
+		{
+			path.query = path.result->succeeded() ? path.result->get() : nullptr;
+			path.result = nullptr;
+		}
+	}
+
+	buildGrid();
+
+	// Steer agents in parallel batches.
+	m_newVelocityX.resize(count);
+	m_newVelocityZ.resize(count);
+	if (count > c_agentsPerJob)
+	{
+		AlignedVector< Job::task_t > jobs;
+		for (uint32_t i = 0; i < count; i += c_agentsPerJob)
+		{
+			const uint32_t to = std::min(i + c_agentsPerJob, count);
+			jobs.push_back([=, this](){ steer(i, to, deltaTime); });
+		}
+		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+	}
+	else
+		steer(0, count, deltaTime);
+
+	// Integrate positions; moving agents are kept on navigation mesh.
+	m_clampPositions.resize(0);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const float vx = m_newVelocityX[i];
+		const float vz = m_newVelocityZ[i];
+		m_velocityX[i] = vx;
+		m_velocityZ[i] = vz;
+		m_positionX[i] += vx * deltaTime;
+		m_positionZ[i] += vz * deltaTime;
+	}
+
+	if (m_navMesh)
+	{
+		AlignedVector< uint32_t > clampIndices;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (m_velocityX[i] * m_velocityX[i] + m_velocityZ[i] * m_velocityZ[i] > c_epsilon)
+			{
+				m_clampPositions.push_back(Vector4(m_positionX[i], m_positionY[i], m_positionZ[i], 1.0f));
+				clampIndices.push_back(i);
+			}
+		}
+
+		if (!m_clampPositions.empty())
+		{
+			m_navMesh->findClosestPoints(m_clampPositions.c_ptr(), m_clampPositions.ptr(), (uint32_t)m_clampPositions.size());
+			for (uint32_t i = 0; i < clampIndices.size(); ++i)
+			{
+				const Vector4& p = m_clampPositions[i];
+				const uint32_t index = clampIndices[i];
+				m_positionX[index] = p.x();
+				m_positionY[index] = p.y();
+				m_positionZ[index] = p.z();
+			}
+		}
+	}
+}
+
+int32_t NavCrowdComponent::addAgent(const Vector4& position, float radius, float maxSpeed)
+{
+	if (getAgentCount() >= m_maxAgents)
+		return -1;
+
+	uint32_t slot;
+	if (!m_freeSlots.empty())
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		slot = (uint32_t)m_slotIndices.size();
+		m_slotIndices.push_back(c_invalidIndex);
+		m_slotGenerations.push_back(0);
+	}
+
+	const uint32_t index = getAgentCount();
+	m_positionX.push_back(position.x());
+	m_positionY.push_back(position.y());
+	m_positionZ.push_back(position.z());
+	m_velocityX.push_back(0.0f);
+	m_velocityZ.push_back(0.0f);
+	m_radius.push_back(radius);
+	m_maxSpeed.push_back(maxSpeed);
+	m_paths.push_back();
+	m_indexSlots.push_back(slot);
+	m_slotIndices[slot] = index;
+
+	return (int32_t)(slot | (uint32_t(m_slotGenerations[slot]) << 16));
+}
+
+void NavCrowdComponent::removeAgent(int32_t agent)
+{
+	const int32_t index = indexOf(agent);
+	if (index < 0)
+		return;
+
+	const uint32_t slot = m_indexSlots[index];
+	const uint32_t last = getAgentCount() - 1;
+
+	// Move last agent into removed agent's place.
+	if ((uint32_t)index != last)
+	{
+		m_positionX[index] = m_positionX[last];
+		m_positionY[index] = m_positionY[last];
+		m_positionZ[index] = m_positionZ[last];
+		m_velocityX[index] = m_velocityX[last];
+		m_velocityZ[index] = m_velocityZ[last];
+		m_radius[index] = m_radius[last];
+		m_maxSpeed[index] = m_maxSpeed[last];
+		m_paths[index] = m_paths[last];
+		m_indexSlots[index] = m_indexSlots[last];
+		m_slotIndices[m_indexSlots[index]] = index;
+	}
+
+	m_positionX.pop_back();
+	m_positionY.pop_back();
+	m_positionZ.pop_back();
+	m_velocityX.pop_back();
+	m_velocityZ.pop_back();
+	m_radius.pop_back();
+	m_maxSpeed.pop_back();
+	m_paths.pop_back();
+	m_indexSlots.pop_back();
+
+	// Invalidate handle.
+	m_slotIndices[slot] = c_invalidIndex;
+	m_slotGenerations[slot] = (m_slotGenerations[slot] + 1) & 0x7fff;
+	m_freeSlots.push_back(slot);
+}
+
+bool NavCrowdComponent::setAgentTarget(int32_t agent, const Vector4& target)
+{
+	const int32_t index = indexOf(agent);
+	if (index < 0)
+		return false;
+
+	AgentPath& path = m_paths[index];
+	path.target = target.xyz1();
+	path.query = nullptr;
+	path.result = nullptr;
+	path.moving = true;
+
+	if (m_navMesh)
+		path.result = m_navMesh->createMoveQuery(
+			Vector4(m_positionX[index], m_positionY[index], m_positionZ[index], 1.0f),
+			path.target
+		);
+
+	return true;
+}
+
+void NavCrowdComponent::stopAgent(int32_t agent)
+{
+	const int32_t index = indexOf(agent);
+	if (index < 0)
+		return;
+
+	AgentPath& path = m_paths[index];
+	path.query = nullptr;
+	path.result = nullptr;
+	path.moving = false;
+}
+
+Vector4 NavCrowdComponent::getAgentPosition(int32_t agent) const
+{
+	const int32_t index = indexOf(agent);
+	if (index >= 0)
+		return Vector4(m_positionX[index], m_positionY[index], m_positionZ[index], 1.0f);
+	else
+		return Vector4::origo();
+}
+
+Vector4 NavCrowdComponent::getAgentVelocity(int32_t agent) const
+{
+	const int32_t index = indexOf(agent);
+	if (index >= 0)
+		return Vector4(m_velocityX[index], 0.0f, m_velocityZ[index], 0.0f);
+	else
+		return Vector4::zero();
+}
+
+bool NavCrowdComponent::isAgentMoving(int32_t agent) const
+{
+	const int32_t index = indexOf(agent);
+	return index >= 0 ? m_paths[index].moving : false;
+}
+
+bool NavCrowdComponent::isAgentValid(int32_t agent) const
+{
+	return indexOf(agent) >= 0;
+}
+
+int32_t NavCrowdComponent::indexOf(int32_t agent) const
+{
+	if (agent < 0)
+		return -1;
+
+	const uint32_t slot = uint32_t(agent) & 0xffff;
+	const uint32_t generation = uint32_t(agent) >> 16;
+	if (slot >= m_slotIndices.size() || m_slotGenerations[slot] != generation || m_slotIndices[slot] == c_invalidIndex)
+		return -1;
+
+	return (int32_t)m_slotIndices[slot];
+}
+
+void NavCrowdComponent::buildGrid()
+{
+	const uint32_t count = getAgentCount();
+	const uint32_t cellCount = nearestLog2(count * 2);
+	const uint32_t cellMask = cellCount - 1;
+	const float invCellSize = 1.0f / m_neighbourDistance;
+
+	m_agentCells.resize(count);
+	m_cellStarts.resize(cellCount + 1);
+	m_cellAgents.resize(count);
+
+	// Count agents in each cell, then place agents in cell order.
+	std::fill(m_cellStarts.begin(), m_cellStarts.end(), 0);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const int32_t x = (int32_t)std::floor(m_positionX[i] * invCellSize);
+		const int32_t z = (int32_t)std::floor(m_positionZ[i] * invCellSize);
+		const uint32_t cell = hashCell(x, z) & cellMask;
+		m_agentCells[i] = cell;
+		m_cellStarts[cell]++;
+	}
+
+	for (uint32_t i = 1; i < cellCount; ++i)
+		m_cellStarts[i] += m_cellStarts[i - 1];
+	m_cellStarts[cellCount] = count;
+
+	for (uint32_t i = 0; i < count; ++i)
+		m_cellAgents[--m_cellStarts[m_agentCells[i]]] = i;
+}
+
+void NavCrowdComponent::steer(uint32_t from, uint32_t to, float deltaTime)
+{
+	const uint32_t cellMask = (uint32_t)m_cellStarts.size() - 2;
+	const float invCellSize = 1.0f / m_neighbourDistance;
+	const float neighbourDistance2 = m_neighbourDistance * m_neighbourDistance;
+	const float horizon = m_avoidanceHorizon;
+
+	for (uint32_t i = from; i < to; ++i)
+	{
+		const float px = m_positionX[i];
+		const float pz = m_positionZ[i];
+		const float vx = m_velocityX[i];
+		const float vz = m_velocityZ[i];
+		const float radius = m_radius[i];
+		const float maxSpeed = m_maxSpeed[i];
+
+		// Preferred velocity, towards next corner of path.
+		float prefX = 0.0f, prefZ = 0.0f;
+
+		AgentPath& path = m_paths[i];
+		if (path.moving && !path.result)
+		{
+			const Vector4 position(px, m_positionY[i], pz, 1.0f);
+
+			Vector4 moveTo = path.target;
+			bool arrived = false;
+			if (path.query)
+				arrived = !path.query->update(position, moveTo, radius);
+			else
+			{
+				const float tx = path.target.x() - px;
+				const float tz = path.target.z() - pz;
+				arrived = (tx * tx + tz * tz) < radius * radius;
+			}
+
+			if (!arrived)
+			{
+				const float dx = moveTo.x() - px;
+				const float dz = moveTo.z() - pz;
+				const float d = std::sqrt(dx * dx + dz * dz);
+
+				const float tx = path.target.x() - px;
+				const float tz = path.target.z() - pz;
+				const float targetDistance = std::sqrt(tx * tx + tz * tz);
+				const float speed = maxSpeed * std::min(targetDistance / (maxSpeed * c_arrivalTime + c_epsilon), 1.0f);
+
+				if (d > c_epsilon)
+				{
+					prefX = (dx / d) * speed;
+					prefZ = (dz / d) * speed;
+				}
+			}
+			else
+			{
+				path.moving = false;
+				path.query = nullptr;
+			}
+		}
+
+		// Avoid neighbours, either by pushing apart if overlapping or
+		// by anticipating time until collision.
+		float avoidX = 0.0f, avoidZ = 0.0f;
+		uint32_t neighbourCount = 0;
+
+		const int32_t cx = (int32_t)std::floor(px * invCellSize);
+		const int32_t cz = (int32_t)std::floor(pz * invCellSize);
+		for (int32_t iz = cz - 1; iz <= cz + 1 && neighbourCount < m_maxNeighbours; ++iz)
+		{
+			for (int32_t ix = cx - 1; ix <= cx + 1 && neighbourCount < m_maxNeighbours; ++ix)
+			{
+				const uint32_t cell = hashCell(ix, iz) & cellMask;
+				for (uint32_t k = m_cellStarts[cell]; k < m_cellStarts[cell + 1] && neighbourCount < m_maxNeighbours; ++k)
+				{
+					const uint32_t j = m_cellAgents[k];
+					if (j == i)
+						continue;
+
+					const float wx = px - m_positionX[j];
+					const float wz = pz - m_positionZ[j];
+					const float distance2 = wx * wx + wz * wz;
+					if (distance2 > neighbourDistance2)
+						continue;
+
+					++neighbourCount;
+
+					const float combinedRadius = radius + m_radius[j];
+					if (distance2 < combinedRadius * combinedRadius)
+					{
+						const float distance = std::sqrt(distance2);
+						const float overlap = (combinedRadius - distance) * c_separationGain;
+						if (distance > c_epsilon)
+						{
+							avoidX += (wx / distance) * overlap;
+							avoidZ += (wz / distance) * overlap;
+						}
+						else
+							avoidX += (i < j) ? overlap : -overlap;
+						continue;
+					}
+
+					// Time until collision, solve |w + u * t| = combined radius.
+					const float ux = vx - m_velocityX[j];
+					const float uz = vz - m_velocityZ[j];
+					const float a = ux * ux + uz * uz;
+					const float b = wx * ux + wz * uz;
+					if (b >= 0.0f || a < c_epsilon)
+						continue;
+
+					const float c = distance2 - combinedRadius * combinedRadius;
+					const float discriminant = b * b - a * c;
+					if (discriminant <= 0.0f)
+						continue;
+
+					const float t = (-b - std::sqrt(discriminant)) / a;
+					if (t <= 0.0f || t >= horizon)
+						continue;
+
+					// Push away from where collision would happen, stronger the sooner it happens.
+					const float hx = wx + ux * t;
+					const float hz = wz + uz * t;
+					const float h = std::sqrt(hx * hx + hz * hz);
+					if (h > c_epsilon)
+					{
+						const float strength = maxSpeed * (horizon - t) / (t + c_timeToCollisionEpsilon);
+						avoidX += (hx / h) * strength;
+						avoidZ += (hz / h) * strength;
+					}
+				}
+			}
+		}
+
+		// Accelerate towards preferred velocity.
+		const float maxAcceleration = 2.0f * maxSpeed / c_relaxationTime;
+		float ax = (prefX - vx) / c_relaxationTime + avoidX;
+		float az = (prefZ - vz) / c_relaxationTime + avoidZ;
+		const float acceleration = std::sqrt(ax * ax + az * az);
+		if (acceleration > maxAcceleration)
+		{
+			ax *= maxAcceleration / acceleration;
+			az *= maxAcceleration / acceleration;
+		}
+
+		float nvx = vx + ax * deltaTime;
+		float nvz = vz + az * deltaTime;
+		const float speed = std::sqrt(nvx * nvx + nvz * nvz);
+		if (speed > maxSpeed)
+		{
+			nvx *= maxSpeed / speed;
+			nvz *= maxSpeed / speed;
+		}
+
+		m_newVelocityX[i] = nvx;
+		m_newVelocityZ[i] = nvz;
+	}
+}
+
+}
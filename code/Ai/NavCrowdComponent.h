@@ -0,0 +1,142 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Vector4.h"
+#include "Resource/Proxy.h"
+#include "World/IWorldComponent.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_AI_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::ai
+{
+
+class MoveQuery;
+class MoveQueryResult;
+class NavCrowdComponentData;
+class NavMesh;
+
+/*! Navigation crowd component.
+ * \ingroup AI
+ *
+ * Simulate movement of many agents; each agent follow a path,
+ * found on the navigation mesh, towards it's target while
+ * avoiding collisions with neighbouring agents.
+ *
+ * Agent state is kept as structure-of-arrays and agents
+ * are steered in parallel batches. Agents are identified
+ * by handles which become invalid when agent is removed.
+ */
+class T_DLLCLASS NavCrowdComponent : public world::IWorldComponent
+{
+	T_RTTI_CLASS;
+
+public:
+	NavCrowdComponent() = default;
+
+	explicit NavCrowdComponent(const resource::Proxy< NavMesh >& navMesh, const NavCrowdComponentData* data);
+
+	virtual void destroy() override final;
+
+	virtual void update(world::World* world, const world::UpdateParams& update) override final;
+
+	/*! Add agent to crowd.
+	 *
+	 * \param position Initial position.
+	 * \param radius Agent radius.
+	 * \param maxSpeed Max speed, in metres per second.
+	 * \return Agent handle, -1 if crowd is full.
+	 */
+	int32_t addAgent(const Vector4& position, float radius, float maxSpeed);
+
+	/*! Remove agent from crowd. */
+	void removeAgent(int32_t agent);
+
+	/*! Set agent target, agent start moving when path to target has been found.
+	 *
+	 * \param agent Agent handle.
+	 * \param target Target position.
+	 * \return True if target set.
+	 */
+	bool setAgentTarget(int32_t agent, const Vector4& target);
+
+	/*! Stop agent and discard it's target. */
+	void stopAgent(int32_t agent);
+
+	/*! Get agent position. */
+	Vector4 getAgentPosition(int32_t agent) const;
+
+	/*! Get agent velocity. */
+	Vector4 getAgentVelocity(int32_t agent) const;
+
+	/*! Check if agent has a target which hasn't yet been reached. */
+	bool isAgentMoving(int32_t agent) const;
+
+	/*! Check if handle refer to an agent in crowd. */
+	bool isAgentValid(int32_t agent) const;
+
+	/*! Get number of agents in crowd. */
+	uint32_t getAgentCount() const { return (uint32_t)m_positionX.size(); }
+
+private:
+	struct AgentPath
+	{
+		Vector4 target = Vector4::zero();
+		Ref< MoveQueryResult > result;	//!< Pending path query.
+		Ref< MoveQuery > query;			//!< Path to follow; null if moving straight to target.
+		bool moving = false;
+	};
+
+	resource::Proxy< NavMesh > m_navMesh;
+	uint32_t m_maxAgents = 0;
+	float m_neighbourDistance = 4.0f;
+	float m_avoidanceHorizon = 2.0f;
+	uint32_t m_maxNeighbours = 8;
+
+	// Agent state, indexed by dense agent index.
+	AlignedVector< float > m_positionX;
+	AlignedVector< float > m_positionY;
+	AlignedVector< float > m_positionZ;
+	AlignedVector< float > m_velocityX;
+	AlignedVector< float > m_velocityZ;
+	AlignedVector< float > m_newVelocityX;
+	AlignedVector< float > m_newVelocityZ;
+	AlignedVector< float > m_radius;
+	AlignedVector< float > m_maxSpeed;
+	AlignedVector< AgentPath > m_paths;
+	AlignedVector< uint32_t > m_indexSlots;		//!< Slot of each agent.
+
+	// Handle slots; handle is slot in low 16 bits and slot generation in high bits.
+	AlignedVector< uint32_t > m_slotIndices;	//!< Dense agent index of each slot.
+	AlignedVector< uint16_t > m_slotGenerations;
+	AlignedVector< uint32_t > m_freeSlots;
+
+	// Spatial hash grid, rebuilt each update.
+	AlignedVector< uint32_t > m_agentCells;
+	AlignedVector< uint32_t > m_cellStarts;
+	AlignedVector< uint32_t > m_cellAgents;
+
+	AlignedVector< Vector4 > m_clampPositions;
+
+	int32_t indexOf(int32_t agent) const;
+
+	void buildGrid();
+
+	void steer(uint32_t from, uint32_t to, float deltaTime);
+};
+
+}
@@ -0,0 +1,32 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Ai/NavCrowdComponentData.h"
+
+#include "Ai/NavMesh.h"
+#include "Core/Serialization/AttributeRange.h"
+#include "Core/Serialization/AttributeUnit.h"
+#include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/Member.h"
+#include "Resource/Member.h"
+
+namespace traktor::ai
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.ai.NavCrowdComponentData", 0, NavCrowdComponentData, world::IWorldComponentData)
+
+void NavCrowdComponentData::serialize(ISerializer& s)
+{
+	s >> resource::Member< NavMesh >(L"navMesh", m_navMesh);
+	s >> Member< int32_t >(L"maxAgents", m_maxAgents, AttributeRange(1, 65535));
+	s >> Member< float >(L"neighbourDistance", m_neighbourDistance, AttributeRange(0.0f) | AttributeUnit(UnitType::Metres));
+	s >> Member< float >(L"avoidanceHorizon", m_avoidanceHorizon, AttributeRange(0.0f) | AttributeUnit(UnitType::Seconds));
+	s >> Member< int32_t >(L"maxNeighbours", m_maxNeighbours, AttributeRange(0));
+}
+
+}
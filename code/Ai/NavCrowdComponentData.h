@@ -0,0 +1,55 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Resource/Id.h"
+#include "World/IWorldComponentData.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_AI_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::ai
+{
+
+class NavMesh;
+
+/*! Navigation crowd component data.
+ * \ingroup AI
+ */
+class T_DLLCLASS NavCrowdComponentData : public world::IWorldComponentData
+{
+	T_RTTI_CLASS;
+
+public:
+	const resource::Id< NavMesh >& getNavMesh() const { return m_navMesh; }
+
+	int32_t getMaxAgents() const { return m_maxAgents; }
+
+	float getNeighbourDistance() const { return m_neighbourDistance; }
+
+	float getAvoidanceHorizon() const { return m_avoidanceHorizon; }
+
+	int32_t getMaxNeighbours() const { return m_maxNeighbours; }
+
+	virtual void serialize(ISerializer& s) override final;
+
+private:
+	resource::Id< NavMesh > m_navMesh;
+	int32_t m_maxAgents = 8192;
+	float m_neighbourDistance = 4.0f;
+	float m_avoidanceHorizon = 2.0f;
+	int32_t m_maxNeighbours = 8;
+};
+
+}
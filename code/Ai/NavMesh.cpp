@@ -12,18 +12,31 @@
 #include "Ai/MoveQueryResult.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Random.h"
-#include "Core/Misc/AutoPtr.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/Acquire.h"
 #include "Core/Thread/Job.h"
 #include "Core/Thread/JobManager.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
 
+#include <DetourNavMesh.h>
 #include <DetourNavMeshQuery.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace traktor::ai
 {
 namespace
 {
 
 const float c_searchExtents[3] = { 32.0f, 1.0f, 32.0f };
+const int32_t c_maxQueryNodes = 2048;
+const int32_t c_iterationsPerSlice = 64;	//!< Number of path find iterations between each budget check.
+const uint32_t c_pointsPerJob = 256;		//!< Number of points, or rays, in each batched query job.
+const double c_pathFindingBudget = 0.002;	//!< Default time, in seconds, spent on path finding each update.
+const double c_updateTimeout = 0.5;		//!< Time, in seconds, without update until queries are processed by jobs.
 
 float random()
 {
@@ -35,210 +48,328 @@ float random()
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.ai.NavMesh", NavMesh, Object)
 
+NavMesh::NavMesh()
+:	m_filter(new dtQueryFilter())
+,	m_tileGeneration(0)
+,	m_pathFindingBudget(c_pathFindingBudget)
+,	m_lastUpdateTime(-1.0)
+,	m_lastUpdateWallTime(-1.0)
+{
+}
+
 NavMesh::~NavMesh()
 {
+	// Fail all pending requests.
+	for (auto request : m_requests)
+		finishRequest(request, false);
+	m_requests.clear();
+
+	for (auto navQuery : m_queryPool)
+		dtFreeNavMeshQuery(navQuery);
+	m_queryPool.clear();
+
+	delete m_filter;
 	dtFreeNavMesh(m_navMesh);
 }
 
 Ref< MoveQueryResult > NavMesh::createMoveQuery(const Vector4& startPosition, const Vector4& endPosition)
 {
 	Ref< MoveQueryResult > result = new MoveQueryResult();
-	JobManager::getInstance().add([=]() {
-		T_ANONYMOUS_VAR(Ref< NavMesh >)(this);
+	result->m_navMesh = this;
 
-		dtNavMeshQuery* navQuery = dtAllocNavMeshQuery();
-		if (!navQuery)
-		{
-			result->fail();
+	PathRequest* request = new PathRequest();
+	request->startPosition = startPosition;
+	request->endPosition = endPosition;
+	request->moveQuery = new MoveQuery();
+	request->result = result;
+
+	bool updated;
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_requestLock);
+		m_requests.push_back(request);
+		updated = (m_lastUpdateWallTime >= 0.0 && m_wallTimer.getElapsedTime() - m_lastUpdateWallTime < c_updateTimeout);
+	}
+
+	// No one is updating navigation mesh; process query in a job
+	// so result eventually become ready even if only polled.
+	if (!updated)
+	{
+		Ref< NavMesh > navMesh = this;
+		JobManager::getInstance().add([=]() {
+			navMesh->complete(result);
+		});
+	}
+
+	return result;
+}
+
+void NavMesh::update(double time)
+{
+	uint32_t pendingCount;
+	double timeBudget;
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_requestLock);
+		if (time == m_lastUpdateTime)
 			return;
-		}
+		m_lastUpdateTime = time;
+		m_lastUpdateWallTime = m_wallTimer.getElapsedTime();
+		pendingCount = (uint32_t)m_requests.size();
+		timeBudget = m_pathFindingBudget;
+	}
+	if (pendingCount == 0)
+		return;
 
-		dtStatus status = navQuery->init(m_navMesh, 2048);
-		if (dtStatusFailed(status))
+	T_ANONYMOUS_VAR(Ref< NavMesh >)(this);
+	Timer timer;
+
+	// Each worker process one request at a time until budget is exhausted;
+	// unfinished request is put first in queue and resumed on next update.
+	auto worker = [&]() {
+		while (timer.getElapsedTime() < timeBudget)
 		{
-			result->fail();
-			return;
+			PathRequest* request = nullptr;
+			{
+				T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_requestLock);
+				if (m_requests.empty())
+					break;
+				request = m_requests.front();
+				m_requests.erase(m_requests.begin());
+			}
+
+			bool finished = false;
+			while (!(finished = processRequest(request, c_iterationsPerSlice)) && timer.getElapsedTime() < timeBudget)
+				;
+
+			if (!finished)
+			{
+				T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_requestLock);
+				m_requests.insert(m_requests.begin(), request);
+				break;
+			}
 		}
+	};
 
-		float T_MATH_ALIGN16 startPos[4];
-		float T_MATH_ALIGN16 endPos[4];
-		startPosition.storeAligned(startPos);
-		endPosition.storeAligned(endPos);
+	const uint32_t workerCount = std::min(std::max(OS::getInstance().getCPUCoreCount(), 1U), pendingCount);
+	if (workerCount <= 1)
+	{
+		worker();
+		return;
+	}
 
-		Ref< MoveQuery > outputQuery = new MoveQuery();
-		outputQuery->m_navQuery = navQuery;
+	AlignedVector< Job::task_t > jobs(workerCount, worker);
+	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+}
 
-		dtPolyRef startRef, endRef;
-		float T_MATH_ALIGN16 startPosN[4];
-		float T_MATH_ALIGN16 endPosN[4];
+void NavMesh::setPathFindingBudget(double timeBudget)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_requestLock);
+	m_pathFindingBudget = timeBudget;
+}
 
-		status = outputQuery->m_navQuery->findNearestPoly(
-			startPos,
-			c_searchExtents,
-			outputQuery->m_filter,
-			&startRef,
-			startPosN);
-		if (dtStatusFailed(status))
-		{
-			result->fail();
-			return;
-		}
+uint32_t NavMesh::getPendingMoveQueryCount() const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_requestLock);
+	return (uint32_t)m_requests.size();
+}
 
-		status = outputQuery->m_navQuery->findNearestPoly(
-			endPos,
-			c_searchExtents,
-			outputQuery->m_filter,
-			&endRef,
-			endPosN);
-		if (dtStatusFailed(status))
-		{
-			result->fail();
-			return;
-		}
+bool NavMesh::findClosestPoint(const Vector4& searchFrom, Vector4& outPoint) const
+{
+	return findClosestPoints(&searchFrom, &outPoint, 1) == 1;
+}
 
-		outputQuery->m_startPosition = Vector4::loadAligned(startPosN).xyz1();
-		outputQuery->m_endPosition = Vector4::loadAligned(endPosN).xyz1();
+uint32_t NavMesh::findClosestPoints(const Vector4* searchFrom, Vector4* outPoints, uint32_t count) const
+{
+	std::atomic< uint32_t > foundCount(0);
 
-		status = outputQuery->m_navQuery->findPath(
-			startRef,
-			endRef,
-			startPosN,
-			endPosN,
-			outputQuery->m_filter,
-			outputQuery->m_path,
-			&outputQuery->m_pathCount,
-			sizeof_array(outputQuery->m_path));
-		if (dtStatusFailed(status) || outputQuery->m_pathCount <= 0)
+	auto find = [&](uint32_t from, uint32_t to) {
+		T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_navMeshLock);
+		dtNavMeshQuery* navQuery = acquireQuery();
+		if (!navQuery)
 		{
-			// Failed to create navmesh path; most probably no valid route exists.
-			// Create a short-cut path to move navigation entity back on track.
-			outputQuery->m_steerPath.push_back(outputQuery->m_endPosition);
-			result->succeed(outputQuery);
+			for (uint32_t i = from; i < to; ++i)
+				outPoints[i] = searchFrom[i];
 			return;
 		}
 
-		float steerPath[256 * 3 + 1];
-		int32_t steerPathCount = 0;
-
-		status = outputQuery->m_navQuery->findStraightPath(
-			startPosN,
-			endPosN,
-			outputQuery->m_path,
-			outputQuery->m_pathCount,
-			steerPath,
-			nullptr,
-			nullptr,
-			&steerPathCount,
-			256);
-		if (dtStatusFailed(status) || steerPathCount <= 0)
+		uint32_t found = 0;
+		for (uint32_t i = from; i < to; ++i)
 		{
-			// Failed to create navmesh path; most probably no valid route exists.
-			// Create a short-cut path to move navigation entity back on track.
-			outputQuery->m_steerPath.push_back(outputQuery->m_endPosition);
-			result->succeed(outputQuery);
-			return;
+			float T_MATH_ALIGN16 startPos[4];
+			searchFrom[i].storeAligned(startPos);
+
+			dtPolyRef startRef = 0;
+			float T_MATH_ALIGN16 startPosN[4];
+
+			const dtStatus status = navQuery->findNearestPoly(
+				startPos,
+				c_searchExtents,
+				m_filter,
+				&startRef,
+				startPosN);
+			if (dtStatusFailed(status))
+			{
+				outPoints[i] = searchFrom[i];
+				continue;
+			}
+
+			outPoints[i] = Vector4::loadAligned(startPosN).xyz1();
+			++found;
 		}
 
-		outputQuery->m_steerPath.reserve(steerPathCount);
-		for (int32_t i = 0; i < steerPathCount; ++i)
-			outputQuery->m_steerPath.push_back(Vector4::loadUnaligned(&steerPath[i * 3]).xyz1());
+		releaseQuery(navQuery);
+		foundCount += found;
+	};
 
-		result->succeed(outputQuery);
-		return;
-	});
-	return result;
+	if (count <= c_pointsPerJob)
+	{
+		find(0, count);
+		return foundCount;
+	}
+
+	AlignedVector< Job::task_t > jobs;
+	for (uint32_t i = 0; i < count; i += c_pointsPerJob)
+	{
+		const uint32_t to = std::min(i + c_pointsPerJob, count);
+		jobs.push_back([=, &find](){ find(i, to); });
+	}
+	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+
+	return foundCount;
 }
 
-bool NavMesh::findClosestPoint(const Vector4& searchFrom, Vector4& outPoint) const
+bool NavMesh::raycast(const Vector4& from, const Vector4& to, Vector4& outHit) const
 {
-	dtNavMeshQuery* navQuery = dtAllocNavMeshQuery();
-	if (!navQuery)
+	float fraction;
+	if (raycast(&from, &to, &fraction, 1) == 0)
+	{
+		outHit = to;
 		return false;
+	}
 
-	dtStatus status = navQuery->init(m_navMesh, 2048);
-	if (dtStatusFailed(status))
-		return false;
+	outHit = lerp(from, to, Scalar(fraction));
+	return true;
+}
 
-	AutoPtr< dtQueryFilter > filter(new dtQueryFilter());
+uint32_t NavMesh::raycast(const Vector4* from, const Vector4* to, float* outFractions, uint32_t count) const
+{
+	std::atomic< uint32_t > hitCount(0);
 
-	float T_MATH_ALIGN16 startPos[4];
-	searchFrom.storeAligned(startPos);
+	auto cast = [&](uint32_t first, uint32_t last) {
+		T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_navMeshLock);
+		dtNavMeshQuery* navQuery = acquireQuery();
+		if (!navQuery)
+		{
+			for (uint32_t i = first; i < last; ++i)
+				outFractions[i] = std::numeric_limits< float >::max();
+			return;
+		}
 
-	dtPolyRef startRef;
-	float T_MATH_ALIGN16 startPosN[4];
+		uint32_t hits = 0;
+		for (uint32_t i = first; i < last; ++i)
+		{
+			float T_MATH_ALIGN16 startPos[4];
+			float T_MATH_ALIGN16 endPos[4];
+			from[i].storeAligned(startPos);
+			to[i].storeAligned(endPos);
+
+			outFractions[i] = std::numeric_limits< float >::max();
+
+			dtPolyRef startRef = 0;
+			float T_MATH_ALIGN16 startPosN[4];
+
+			dtStatus status = navQuery->findNearestPoly(
+				startPos,
+				c_searchExtents,
+				m_filter,
+				&startRef,
+				startPosN);
+			if (dtStatusFailed(status) || startRef == 0)
+				continue;
+
+			float t = 0.0f;
+			float hitNormal[3];
+			int32_t pathCount = 0;
+
+			status = navQuery->raycast(
+				startRef,
+				startPos,
+				endPos,
+				m_filter,
+				&t,
+				hitNormal,
+				nullptr,
+				&pathCount,
+				0);
+			if (dtStatusFailed(status) || t >= std::numeric_limits< float >::max())
+				continue;
+
+			outFractions[i] = t;
+			++hits;
+		}
 
-	status = navQuery->findNearestPoly(
-		startPos,
-		c_searchExtents,
-		filter.ptr(),
-		&startRef,
-		startPosN);
-	if (dtStatusFailed(status))
+		releaseQuery(navQuery);
+		hitCount += hits;
+	};
+
+	if (count <= c_pointsPerJob)
 	{
-		dtFreeNavMeshQuery(navQuery);
-		return false;
+		cast(0, count);
+		return hitCount;
 	}
 
-	outPoint = Vector4::loadAligned(startPosN).xyz1();
+	AlignedVector< Job::task_t > jobs;
+	for (uint32_t i = 0; i < count; i += c_pointsPerJob)
+	{
+		const uint32_t last = std::min(i + c_pointsPerJob, count);
+		jobs.push_back([=, &cast](){ cast(i, last); });
+	}
+	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
 
-	dtFreeNavMeshQuery(navQuery);
-	return true;
+	return hitCount;
 }
 
 bool NavMesh::findRandomPoint(Vector4& outPoint) const
 {
-	dtNavMeshQuery* navQuery = dtAllocNavMeshQuery();
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_navMeshLock);
+	dtNavMeshQuery* navQuery = acquireQuery();
 	if (!navQuery)
 		return false;
 
-	dtStatus status = navQuery->init(m_navMesh, 2048);
-	if (dtStatusFailed(status))
-		return false;
-
-	AutoPtr< dtQueryFilter > filter(new dtQueryFilter());
-
 	dtPolyRef randomRef;
 	float T_MATH_ALIGN16 randomPosN[4];
 
-	status = navQuery->findRandomPoint(
-		filter.ptr(),
+	const dtStatus status = navQuery->findRandomPoint(
+		m_filter,
 		&random,
 		&randomRef,
 		randomPosN);
+
+	releaseQuery(navQuery);
+
 	if (dtStatusFailed(status))
-	{
-		dtFreeNavMeshQuery(navQuery);
 		return false;
-	}
 
 	outPoint = Vector4::loadAligned(randomPosN).xyz1();
-
-	dtFreeNavMeshQuery(navQuery);
 	return true;
 }
 
 bool NavMesh::findRandomPoint(const Vector4& center, float radius, Vector4& outPoint) const
 {
-	dtNavMeshQuery* navQuery = dtAllocNavMeshQuery();
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_navMeshLock);
+	dtNavMeshQuery* navQuery = acquireQuery();
 	if (!navQuery)
 		return false;
 
-	dtStatus status = navQuery->init(m_navMesh, 2048);
-	if (dtStatusFailed(status))
-		return false;
-
-	AutoPtr< dtQueryFilter > filter(new dtQueryFilter());
-
 	float T_MATH_ALIGN16 centerPos[4];
 	center.storeAligned(centerPos);
 
 	dtPolyRef startRef;
 	float T_MATH_ALIGN16 startPosN[4];
 
-	status = navQuery->findNearestPoly(
+	dtStatus status = navQuery->findNearestPoly(
 		centerPos,
 		c_searchExtents,
-		filter.ptr(),
+		m_filter,
 		&startRef,
 		startPosN);
 
@@ -249,20 +380,310 @@ bool NavMesh::findRandomPoint(const Vector4& center, float radius, Vector4& outP
 		startRef,
 		centerPos,
 		radius,
-		filter.ptr(),
+		m_filter,
 		&random,
 		&randomRef,
 		randomPosN);
+
+	releaseQuery(navQuery);
+
+	if (dtStatusFailed(status))
+		return false;
+
+	outPoint = Vector4::loadAligned(randomPosN).xyz1();
+	return true;
+}
+
+void NavMesh::getTileAt(const Vector4& position, int32_t& outTileX, int32_t& outTileZ) const
+{
+	float T_MATH_ALIGN16 pos[4];
+	position.storeAligned(pos);
+	m_navMesh->calcTileLoc(pos, &outTileX, &outTileZ);
+}
+
+bool NavMesh::replaceTile(int32_t tileX, int32_t tileZ, uint8_t* tileData, int32_t tileDataSize)
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_navMeshLock);
+
+	const dtTileRef tileRef = m_navMesh->getTileRefAt(tileX, tileZ, 0);
+	if (tileRef != 0)
+		m_navMesh->removeTile(tileRef, nullptr, nullptr);
+
+	++m_tileGeneration;
+
+	const dtStatus status = m_navMesh->addTile(tileData, tileDataSize, DT_TILE_FREE_DATA, 0, nullptr);
+	if (dtStatusFailed(status))
+	{
+		log::error << L"Unable to replace navigation mesh tile " << tileX << L", " << tileZ << L"." << Endl;
+		dtFree(tileData);
+		return false;
+	}
+
+	if (m_extractGeometry)
+		extractGeometry();
+
+	return true;
+}
+
+bool NavMesh::removeTile(int32_t tileX, int32_t tileZ)
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_navMeshLock);
+
+	const dtTileRef tileRef = m_navMesh->getTileRefAt(tileX, tileZ, 0);
+	if (tileRef == 0)
+		return false;
+
+	m_navMesh->removeTile(tileRef, nullptr, nullptr);
+	++m_tileGeneration;
+
+	if (m_extractGeometry)
+		extractGeometry();
+
+	return true;
+}
+
+void NavMesh::extractGeometry()
+{
+	m_navMeshVertices.resize(0);
+	m_navMeshPolygons.resize(0);
+
+	const dtNavMesh* navMesh = m_navMesh;
+	for (int32_t i = 0; i < navMesh->getMaxTiles(); ++i)
+	{
+		const dtMeshTile* tile = navMesh->getTile(i);
+		if (!tile || !tile->header)
+			continue;
+
+		const uint32_t vertexOffset = (uint32_t)m_navMeshVertices.size();
+		for (int32_t j = 0; j < tile->header->vertCount; ++j)
+			m_navMeshVertices.push_back(Vector4(
+				tile->verts[j * 3 + 0],
+				tile->verts[j * 3 + 1],
+				tile->verts[j * 3 + 2],
+				1.0f
+			));
+
+		for (int32_t j = 0; j < tile->header->polyCount; ++j)
+		{
+			const dtPoly& poly = tile->polys[j];
+			if (poly.getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+				continue;
+
+			m_navMeshPolygons.push_back(poly.vertCount);
+			for (uint32_t k = 0; k < poly.vertCount; ++k)
+				m_navMeshPolygons.push_back(vertexOffset + poly.verts[k]);
+		}
+	}
+}
+
+dtNavMeshQuery* NavMesh::acquireQuery() const
+{
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_queryPoolLock);
+		if (!m_queryPool.empty())
+		{
+			dtNavMeshQuery* navQuery = m_queryPool.back();
+			m_queryPool.pop_back();
+			return navQuery;
+		}
+	}
+
+	dtNavMeshQuery* navQuery = dtAllocNavMeshQuery();
+	if (!navQuery)
+		return nullptr;
+
+	const dtStatus status = navQuery->init(m_navMesh, c_maxQueryNodes);
 	if (dtStatusFailed(status))
 	{
 		dtFreeNavMeshQuery(navQuery);
+		return nullptr;
+	}
+
+	return navQuery;
+}
+
+void NavMesh::releaseQuery(dtNavMeshQuery* navQuery) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_queryPoolLock);
+	m_queryPool.push_back(navQuery);
+}
+
+bool NavMesh::processRequest(PathRequest* request, int32_t maxIterations)
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_navMeshLock);
+
+	MoveQuery* moveQuery = request->moveQuery;
+	dtStatus status;
+
+	// Restart sliced path find if tiles has been replaced since it began.
+	if (request->navQuery && request->tileGeneration != m_tileGeneration)
+	{
+		releaseQuery(request->navQuery);
+		request->navQuery = nullptr;
+	}
+
+	// Begin sliced path find.
+	if (!request->navQuery)
+	{
+		request->tileGeneration = m_tileGeneration;
+
+		if ((request->navQuery = acquireQuery()) == nullptr)
+		{
+			finishRequest(request, false);
+			return true;
+		}
+
+		float T_MATH_ALIGN16 startPos[4];
+		float T_MATH_ALIGN16 endPos[4];
+		request->startPosition.storeAligned(startPos);
+		request->endPosition.storeAligned(endPos);
+
+		dtPolyRef startRef, endRef;
+		float T_MATH_ALIGN16 startPosN[4];
+		float T_MATH_ALIGN16 endPosN[4];
+
+		status = request->navQuery->findNearestPoly(
+			startPos,
+			c_searchExtents,
+			m_filter,
+			&startRef,
+			startPosN);
+		if (dtStatusFailed(status))
+		{
+			finishRequest(request, false);
+			return true;
+		}
+
+		status = request->navQuery->findNearestPoly(
+			endPos,
+			c_searchExtents,
+			m_filter,
+			&endRef,
+			endPosN);
+		if (dtStatusFailed(status))
+		{
+			finishRequest(request, false);
+			return true;
+		}
+
+		moveQuery->m_startPosition = Vector4::loadAligned(startPosN).xyz1();
+		moveQuery->m_endPosition = Vector4::loadAligned(endPosN).xyz1();
+
+		status = request->navQuery->initSlicedFindPath(
+			startRef,
+			endRef,
+			startPosN,
+			endPosN,
+			m_filter);
+		if (dtStatusFailed(status))
+		{
+			// Failed to create navmesh path; most probably no valid route exists.
+			// Create a short-cut path to move navigation entity back on track.
+			moveQuery->m_steerPath.push_back(moveQuery->m_endPosition);
+			finishRequest(request, true);
+			return true;
+		}
+	}
+
+	// Continue sliced path find.
+	int32_t doneIterations = 0;
+	status = request->navQuery->updateSlicedFindPath(maxIterations, &doneIterations);
+	if (dtStatusInProgress(status))
 		return false;
+
+	if (dtStatusSucceed(status))
+		status = request->navQuery->finalizeSlicedFindPath(
+			moveQuery->m_path,
+			&moveQuery->m_pathCount,
+			MoveQuery::MaxPathPolygons);
+	if (dtStatusFailed(status) || moveQuery->m_pathCount <= 0)
+	{
+		// Failed to create navmesh path; most probably no valid route exists.
+		// Create a short-cut path to move navigation entity back on track.
+		moveQuery->m_steerPath.push_back(moveQuery->m_endPosition);
+		finishRequest(request, true);
+		return true;
 	}
 
-	outPoint = Vector4::loadAligned(randomPosN).xyz1();
+	float T_MATH_ALIGN16 startPosN[4];
+	float T_MATH_ALIGN16 endPosN[4];
+	moveQuery->m_startPosition.storeAligned(startPosN);
+	moveQuery->m_endPosition.storeAligned(endPosN);
+
+	float steerPath[256 * 3 + 1];
+	int32_t steerPathCount = 0;
+
+	status = request->navQuery->findStraightPath(
+		startPosN,
+		endPosN,
+		moveQuery->m_path,
+		moveQuery->m_pathCount,
+		steerPath,
+		nullptr,
+		nullptr,
+		&steerPathCount,
+		256);
+	if (dtStatusFailed(status) || steerPathCount <= 0)
+	{
+		// Failed to create navmesh path; most probably no valid route exists.
+		// Create a short-cut path to move navigation entity back on track.
+		moveQuery->m_steerPath.push_back(moveQuery->m_endPosition);
+		finishRequest(request, true);
+		return true;
+	}
 
-	dtFreeNavMeshQuery(navQuery);
+	moveQuery->m_steerPath.reserve(steerPathCount);
+	for (int32_t i = 0; i < steerPathCount; ++i)
+		moveQuery->m_steerPath.push_back(Vector4::loadUnaligned(&steerPath[i * 3]).xyz1());
+
+	finishRequest(request, true);
 	return true;
 }
 
+void NavMesh::finishRequest(PathRequest* request, bool succeeded)
+{
+	if (request->navQuery)
+	{
+		releaseQuery(request->navQuery);
+		request->navQuery = nullptr;
+	}
+
+	request->result->m_navMesh = nullptr;
+	if (succeeded)
+		request->result->succeed(request->moveQuery);
+	else
+		request->result->fail();
+
+	delete request;
+}
+
+void NavMesh::complete(const MoveQueryResult* result)
+{
+	while (!result->ready())
+	{
+		PathRequest* request = nullptr;
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_requestLock);
+			auto it = std::find_if(m_requests.begin(), m_requests.end(), [=](const PathRequest* request) {
+				return request->result == result;
+			});
+			if (it != m_requests.end())
+			{
+				request = *it;
+				m_requests.erase(it);
+			}
+		}
+
+		// Request currently processed by update; wait until it's either finished or put back in queue.
+		if (!request)
+		{
+			ThreadManager::getInstance().getCurrentThread()->yield();
+			continue;
+		}
+
+		while (!processRequest(request, std::numeric_limits< int32_t >::max()))
+			;
+	}
+}
+
 }
@@ -8,10 +8,14 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Core/Object.h"
 #include "Core/Ref.h"
 #include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Vector4.h"
+#include "Core/Thread/ReaderWriterLock.h"
+#include "Core/Thread/Semaphore.h"
+#include "Core/Timer/Timer.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -22,20 +26,32 @@
 #endif
 
 class dtNavMesh;
+class dtNavMeshQuery;
+class dtQueryFilter;
 
 namespace traktor::ai
 {
 
+class MoveQuery;
 class MoveQueryResult;
 
 /*! Navigation mesh.
  * \ingroup AI
+ *
+ * Detour queries are pooled and reused by all threads, queries
+ * are only allocated when more threads query concurrently than
+ * ever before.
+ *
+ * Navigation mesh is divided into tiles which can be replaced
+ * at runtime, for example when rebuilt around dynamic obstacles.
  */
 class T_DLLCLASS NavMesh : public Object
 {
 	T_RTTI_CLASS;
 
 public:
+	NavMesh();
+
 	virtual ~NavMesh();
 
 	/*! Create a movement query from start to end position.
@@ -45,12 +61,37 @@ public:
 	 * it will return a "deferred result" which
 	 * will become ready sometime in the future.
 	 *
+	 * Queries are queued and processed by update, getting
+	 * query from result before it's ready will process
+	 * query immediately. If navigation mesh isn't updated
+	 * each frame then query is processed by a job.
+	 *
 	 * \param startPosition Start of movement.
 	 * \param endPosition End of movement.
 	 * \return Movement query async result.
 	 */
 	Ref< MoveQueryResult > createMoveQuery(const Vector4& startPosition, const Vector4& endPosition);
 
+	/*! Process queued movement queries.
+	 *
+	 * Path finding is sliced and spread over worker threads,
+	 * queries not finished within budget are resumed
+	 * on next update.
+	 *
+	 * Components using the navigation mesh call this each frame,
+	 * only first call for each time is processed thus budget
+	 * is shared by all components.
+	 *
+	 * \param time Current world time, in seconds.
+	 */
+	void update(double time);
+
+	/*! Set time, in seconds, spent on path finding each update. */
+	void setPathFindingBudget(double timeBudget);
+
+	/*! Get number of queued movement queries. */
+	uint32_t getPendingMoveQueryCount() const;
+
 	/*! Find closest point on navigation mesh.
 	 *
 	 * \param searchFrom Search from point.
@@ -59,6 +100,34 @@ public:
 	 */
 	bool findClosestPoint(const Vector4& searchFrom, Vector4& outPoint) const;
 
+	/*! Find closest points on navigation mesh.
+	 *
+	 * \param searchFrom Search from points.
+	 * \param outPoints Closest points on navigation mesh, search from point if none found.
+	 * \param count Number of points.
+	 * \return Number of closest points found.
+	 */
+	uint32_t findClosestPoints(const Vector4* searchFrom, Vector4* outPoints, uint32_t count) const;
+
+	/*! Cast ray along navigation mesh surface.
+	 *
+	 * \param from Ray start, on navigation mesh.
+	 * \param to Ray end.
+	 * \param outHit Position where ray hit navigation mesh boundary.
+	 * \return True if ray hit boundary before reaching end.
+	 */
+	bool raycast(const Vector4& from, const Vector4& to, Vector4& outHit) const;
+
+	/*! Cast rays along navigation mesh surface.
+	 *
+	 * \param from Ray starts, on navigation mesh.
+	 * \param to Ray ends.
+	 * \param outFractions Fraction of each ray until hit boundary, max float if reached end.
+	 * \param count Number of rays.
+	 * \return Number of rays which hit boundary.
+	 */
+	uint32_t raycast(const Vector4* from, const Vector4* to, float* outFractions, uint32_t count) const;
+
 	/*! Find a random point which is guaranteed to be on navigation mesh.
 	 *
 	 * \param outPoint Random point on navigation mesh.
@@ -75,13 +144,86 @@ public:
 	 */
 	bool findRandomPoint(const Vector4& center, float radius, Vector4& outPoint) const;
 
+	/*! Get coordinates of tile containing position.
+	 *
+	 * \param position World position.
+	 * \param outTileX Tile x coordinate.
+	 * \param outTileZ Tile z coordinate.
+	 */
+	void getTileAt(const Vector4& position, int32_t& outTileX, int32_t& outTileZ) const;
+
+	/*! Replace, or add, tile in navigation mesh.
+	 *
+	 * Tiles are built offline by the navigation mesh pipeline,
+	 * there is no runtime rebuild; this only swap in prebuilt
+	 * tile data, for example streamed or alternative tiles.
+	 *
+	 * Tile data must be Detour tile data allocated with dtAlloc,
+	 * navigation mesh takes ownership of data even if replace fails.
+	 * Safe to call concurrently with queries; path finds in
+	 * progress are restarted.
+	 *
+	 * \param tileX Tile x coordinate.
+	 * \param tileZ Tile z coordinate.
+	 * \param tileData Tile data.
+	 * \param tileDataSize Size of tile data in bytes.
+	 * \return True if tile replaced.
+	 */
+	bool replaceTile(int32_t tileX, int32_t tileZ, uint8_t* tileData, int32_t tileDataSize);
+
+	/*! Remove tile from navigation mesh.
+	 *
+	 * \param tileX Tile x coordinate.
+	 * \param tileZ Tile z coordinate.
+	 * \return True if tile removed.
+	 */
+	bool removeTile(int32_t tileX, int32_t tileZ);
+
 private:
+	friend class MoveQueryResult;
 	friend class NavMeshFactory;
 	friend class NavMeshComponentEditor;
 
-	dtNavMesh* m_navMesh;
+	struct PathRequest
+	{
+		Vector4 startPosition;
+		Vector4 endPosition;
+		Ref< MoveQuery > moveQuery;
+		Ref< MoveQueryResult > result;
+		dtNavMeshQuery* navQuery = nullptr;	//!< Query of sliced path find in progress.
+		uint32_t tileGeneration = 0;		//!< Tile generation when sliced path find began.
+	};
+
+	dtNavMesh* m_navMesh = nullptr;
+	dtQueryFilter* m_filter = nullptr;
 	AlignedVector< Vector4 > m_navMeshVertices;
-	AlignedVector< uint16_t > m_navMeshPolygons;
+	AlignedVector< uint32_t > m_navMeshPolygons;
+	bool m_extractGeometry = false;
+	mutable ReaderWriterLock m_navMeshLock;
+	std::atomic< uint32_t > m_tileGeneration;
+	mutable Semaphore m_queryPoolLock;
+	mutable AlignedVector< dtNavMeshQuery* > m_queryPool;
+	mutable Semaphore m_requestLock;
+	AlignedVector< PathRequest* > m_requests;
+	double m_pathFindingBudget;
+	double m_lastUpdateTime;
+	double m_lastUpdateWallTime;
+	Timer m_wallTimer;
+
+	/*! Extract editor geometry from all loaded tiles. */
+	void extractGeometry();
+
+	dtNavMeshQuery* acquireQuery() const;
+
+	void releaseQuery(dtNavMeshQuery* navQuery) const;
+
+	/*! Process path request, return true if request is finished. */
+	bool processRequest(PathRequest* request, int32_t maxIterations);
+
+	void finishRequest(PathRequest* request, bool succeeded);
+
+	/*! Process request of result immediately, called when result is needed before it's ready. */
+	void complete(const MoveQueryResult* result);
 };
 
 }
@@ -8,6 +8,8 @@
  */
 #include "Ai/NavMeshComponent.h"
 
+#include "Ai/NavMesh.h"
+
 namespace traktor::ai
 {
 
@@ -24,6 +26,8 @@ void NavMeshComponent::destroy()
 
 void NavMeshComponent::update(world::World* world, const world::UpdateParams& update)
 {
+	if (m_navMesh)
+		m_navMesh->update(update.totalTime);
 }
 
 }
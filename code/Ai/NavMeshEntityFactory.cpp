@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Ai/NavCrowdComponent.h"
+#include "Ai/NavCrowdComponentData.h"
 #include "Ai/NavMesh.h"
 #include "Ai/NavMeshComponent.h"
 #include "Ai/NavMeshComponentData.h"
@@ -31,11 +33,20 @@ bool NavMeshEntityFactory::initialize(const ObjectStore& objectStore)
 
 const TypeInfoSet NavMeshEntityFactory::getWorldComponentTypes() const
 {
-	return makeTypeInfoSet< NavMeshComponentData >();
+	return makeTypeInfoSet< NavMeshComponentData, NavCrowdComponentData >();
 }
 
 Ref< world::IWorldComponent > NavMeshEntityFactory::createWorldComponent(const world::IEntityBuilder* builder, const world::IWorldComponentData& worldComponentData) const
 {
+	if (auto navCrowdComponentData = dynamic_type_cast< const NavCrowdComponentData* >(&worldComponentData))
+	{
+		resource::Proxy< NavMesh > navMesh;
+		if (!m_resourceManager->bind(navCrowdComponentData->getNavMesh(), navMesh))
+			return nullptr;
+
+		return new NavCrowdComponent(navMesh, navCrowdComponentData);
+	}
+
 	auto navMeshComponentData = checked_type_cast<const NavMeshComponentData*>(&worldComponentData);
 
 	resource::Proxy< NavMesh > navMesh;
@@ -56,22 +56,85 @@ Ref< Object > NavMeshFactory::create(resource::IResourceManager* resourceManager
 
 	uint8_t version;
 	r >> version;
-	if (version != 2)
+	if (version != 2 && version != 3)
 		return nullptr;
 
-	int32_t navDataSize;
-	r >> navDataSize;
-	if (navDataSize <= 0)
+	dtNavMesh* navMesh = dtAllocNavMesh();
+	if (!navMesh)
 		return nullptr;
 
-	uint8_t* navData = (uint8_t*)dtAlloc(navDataSize, DT_ALLOC_PERM);
-	if (stream->read(navData, navDataSize) != navDataSize)
-		return nullptr;
+	outputNavMesh->m_navMesh = navMesh;
+
+	if (version == 2)
+	{
+		// Single tile navigation mesh.
+		int32_t navDataSize;
+		r >> navDataSize;
+		if (navDataSize <= 0)
+			return nullptr;
+
+		uint8_t* navData = (uint8_t*)dtAlloc(navDataSize, DT_ALLOC_PERM);
+		if (stream->read(navData, navDataSize) != navDataSize)
+		{
+			dtFree(navData);
+			return nullptr;
+		}
+
+		const dtStatus status = navMesh->init(navData, navDataSize, DT_TILE_FREE_DATA);
+		if (dtStatusFailed(status))
+			return nullptr;
+	}
+	else
+	{
+		// Tiled navigation mesh.
+		dtNavMeshParams params;
+		r >> params.orig[0];
+		r >> params.orig[1];
+		r >> params.orig[2];
+		r >> params.tileWidth;
+		r >> params.tileHeight;
+		r >> params.maxTiles;
+		r >> params.maxPolys;
+
+		dtStatus status = navMesh->init(&params);
+		if (dtStatusFailed(status))
+			return nullptr;
+
+		uint32_t tileCount;
+		r >> tileCount;
+
+		for (uint32_t i = 0; i < tileCount; ++i)
+		{
+			int32_t tileX, tileZ;
+			uint32_t tileHash;
+			int32_t tileDataSize;
+			r >> tileX;
+			r >> tileZ;
+			r >> tileHash;
+			r >> tileDataSize;
+			if (tileDataSize <= 0)
+				return nullptr;
+
+			uint8_t* tileData = (uint8_t*)dtAlloc(tileDataSize, DT_ALLOC_PERM);
+			if (stream->read(tileData, tileDataSize) != tileDataSize)
+			{
+				dtFree(tileData);
+				return nullptr;
+			}
+
+			status = navMesh->addTile(tileData, tileDataSize, DT_TILE_FREE_DATA, 0, nullptr);
+			if (dtStatusFailed(status))
+			{
+				dtFree(tileData);
+				return nullptr;
+			}
+		}
+	}
 
 	bool haveGeometry;
 	r >> haveGeometry;
 
-	if (haveGeometry)
+	if (haveGeometry && version == 2)
 	{
 		uint32_t numVertices;
 		r >> numVertices;
@@ -106,20 +169,17 @@ Ref< Object > NavMeshFactory::create(resource::IResourceManager* resourceManager
 			}
 		}
 	}
+	else if (haveGeometry)
+	{
+		// Tiled navigation mesh doesn't store geometry, extract from loaded tiles
+		// and keep extracting whenever tiles are replaced.
+		outputNavMesh->m_extractGeometry = true;
+		outputNavMesh->extractGeometry();
+	}
 
 	stream->close();
 	stream = nullptr;
 
-	dtNavMesh* navMesh = dtAllocNavMesh();
-	if (!navMesh)
-		return nullptr;
-
-	dtStatus status = navMesh->init(navData, navDataSize, DT_TILE_FREE_DATA);
-	if (dtStatusFailed(status))
-		return nullptr;
-
-	outputNavMesh->m_navMesh = navMesh;
-
 	return outputNavMesh;
 }
 
@@ -0,0 +1,100 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Ai/Test/CaseNavCrowd.h"
+
+#include "Ai/NavCrowdComponent.h"
+#include "Ai/NavCrowdComponentData.h"
+#include "Ai/NavMesh.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Random.h"
+#include "Core/Timer/Timer.h"
+#include "World/WorldTypes.h"
+
+#include <algorithm>
+
+namespace traktor::ai::test
+{
+namespace
+{
+
+const uint32_t c_agentCount = 5000;
+const uint32_t c_frameCount = 300;
+const float c_areaSize = 100.0f;
+const float c_agentRadius = 0.4f;
+const float c_agentSpeed = 3.0f;
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.ai.test.CaseNavCrowd", 0, CaseNavCrowd, traktor::test::Case)
+
+void CaseNavCrowd::run()
+{
+	Ref< NavCrowdComponentData > data = new NavCrowdComponentData();
+	Ref< NavCrowdComponent > crowd = new NavCrowdComponent(resource::Proxy< NavMesh >(), data);
+
+	// Agents spread over area, each heading to opposite side
+	// so all agents cross in the middle.
+	AlignedVector< int32_t > agents;
+	AlignedVector< Vector4 > targets;
+	Random random;
+	for (uint32_t i = 0; i < c_agentCount; ++i)
+	{
+		const float x = (random.nextFloat() - 0.5f) * c_areaSize;
+		const float z = (random.nextFloat() - 0.5f) * c_areaSize;
+
+		const int32_t agent = crowd->addAgent(Vector4(x, 0.0f, z, 1.0f), c_agentRadius, c_agentSpeed);
+		CASE_ASSERT(crowd->isAgentValid(agent));
+
+		const Vector4 target(-x, 0.0f, -z, 1.0f);
+		CASE_ASSERT(crowd->setAgentTarget(agent, target));
+
+		agents.push_back(agent);
+		targets.push_back(target);
+	}
+	CASE_ASSERT_EQUAL(crowd->getAgentCount(), c_agentCount);
+
+	Scalar distanceBefore(0.0f);
+	for (uint32_t i = 0; i < c_agentCount; ++i)
+		distanceBefore += (targets[i] - crowd->getAgentPosition(agents[i])).xyz0().length();
+
+	world::UpdateParams update;
+	update.deltaTime = 1.0 / 60.0;
+
+	Timer timer;
+	double totalTime = 0.0;
+	double maxTime = 0.0;
+	for (uint32_t frame = 0; frame < c_frameCount; ++frame)
+	{
+		update.totalTime += update.deltaTime;
+
+		const double start = timer.getElapsedTime();
+		crowd->update(nullptr, update);
+		const double elapsed = timer.getElapsedTime() - start;
+
+		totalTime += elapsed;
+		maxTime = std::max(maxTime, elapsed);
+	}
+
+	// Crowd must make progress towards targets and no agent may exceed it's max speed.
+	Scalar distanceAfter(0.0f);
+	uint32_t movingCount = 0;
+	for (uint32_t i = 0; i < c_agentCount; ++i)
+	{
+		distanceAfter += (targets[i] - crowd->getAgentPosition(agents[i])).xyz0().length();
+		CASE_ASSERT(crowd->getAgentVelocity(agents[i]).xyz0().length() <= Scalar(c_agentSpeed + 1e-3f));
+		if (crowd->isAgentMoving(agents[i]))
+			++movingCount;
+	}
+	CASE_ASSERT(distanceAfter < distanceBefore);
+
+	log::info << L"Crowd, " << c_agentCount << L" agents; " << (totalTime * 1000.0) / c_frameCount << L" ms average, " << maxTime * 1000.0 << L" ms max per frame, " << movingCount << L" still moving" << Endl;
+}
+
+}
@@ -10,6 +10,7 @@
 
 #include "Core/Class/AutoVerify.h"
 #include "Core/Class/CastAny.h"
+#include "Core/Class/FastCall.h"
 #include "Core/Class/IRuntimeDispatch.h"
 #include "Core/Io/OutputStream.h"
 
@@ -32,6 +33,8 @@ public:
 	explicit AutoMethodTrunk(method_t method)
 	:	m_method(method)
 	{
+		if constexpr (FastCallSignature< ArgumentTypes ... >::supported)
+			FastCallSignature< ArgumentTypes ... >::describe(m_fastCall, &fastCall);
 	}
 
 #if defined(T_NEED_RUNTIME_SIGNATURE)
@@ -48,6 +51,11 @@ public:
 		return AcceptAny< ArgumentTypes ... >::accept(argc, argv);
 	}
 
+	virtual const FastCall* getFastCall() const override final
+	{
+		return m_fastCall.function != nullptr ? &m_fastCall : nullptr;
+	}
+
 	virtual Any invoke(ITypedObject* self, uint32_t argc, const Any* argv) const override final
 	{
 		T_VERIFY_ARGUMENT_COUNT(sizeof ... (ArgumentTypes));
@@ -56,6 +64,22 @@ public:
 	}
 
 private:
+	FastCall m_fastCall;
+
+	static Any fastCall(const IRuntimeDispatch* dispatch, ITypedObject* self, const FastCallValue* argv)
+	{
+		return fastCallI(dispatch, self, argv, std::make_index_sequence< sizeof...(ArgumentTypes) >());
+	}
+
+	template < std::size_t ... Is >
+	static Any fastCallI(const IRuntimeDispatch* dispatch, ITypedObject* self, const FastCallValue* argv, std::index_sequence< Is ... >)
+	{
+		return CastAny< ReturnType >::set((*static_cast< const AutoMethodTrunk* >(dispatch)->m_method)(
+			static_cast< ClassType* >(self),
+			FastCallArgument< ArgumentTypes >::get(argv[Is]) ...
+		));
+	}
+
 	template < std::size_t... Is >
 	inline Any invokeI(ITypedObject* self, const Any* argv, std::index_sequence< Is... >) const
 	{
@@ -79,6 +103,8 @@ public:
 	explicit AutoMethodTrunk(method_t method)
 	:	m_method(method)
 	{
+		if constexpr (FastCallSignature< ArgumentTypes ... >::supported)
+			FastCallSignature< ArgumentTypes ... >::describe(m_fastCall, &fastCall);
 	}
 
 #if defined(T_NEED_RUNTIME_SIGNATURE)
@@ -95,6 +121,11 @@ public:
 		return AcceptAny< ArgumentTypes ... >::accept(argc, argv);
 	}
 
+	virtual const FastCall* getFastCall() const override final
+	{
+		return m_fastCall.function != nullptr ? &m_fastCall : nullptr;
+	}
+
 	virtual Any invoke(ITypedObject* self, uint32_t argc, const Any* argv) const override final
 	{
 		T_VERIFY_ARGUMENT_COUNT(sizeof ... (ArgumentTypes));
@@ -104,6 +135,23 @@ public:
 	}
 
 private:
+	FastCall m_fastCall;
+
+	static Any fastCall(const IRuntimeDispatch* dispatch, ITypedObject* self, const FastCallValue* argv)
+	{
+		fastCallI(dispatch, self, argv, std::make_index_sequence< sizeof...(ArgumentTypes) >());
+		return Any();
+	}
+
+	template < std::size_t ... Is >
+	static void fastCallI(const IRuntimeDispatch* dispatch, ITypedObject* self, const FastCallValue* argv, std::index_sequence< Is ... >)
+	{
+		(*static_cast< const AutoMethodTrunk* >(dispatch)->m_method)(
+			static_cast< ClassType* >(self),
+			FastCallArgument< ArgumentTypes >::get(argv[Is]) ...
+		);
+	}
+
 	template < std::size_t... Is >
 	inline void invokeI(ITypedObject* self, const Any* argv, std::index_sequence< Is... >) const
 	{
@@ -0,0 +1,174 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <type_traits>
+#include "Core/Ref.h"
+#include "Core/Class/Any.h"
+#include "Core/Math/Scalar.h"
+#include "Core/Meta/Traits.h"
+
+namespace traktor
+{
+
+class IRuntimeDispatch;
+
+/*! \ingroup Core */
+/*! \{ */
+
+/*! Fast call argument type. */
+enum class FastCallType : uint8_t
+{
+	Boolean,	//!< bool
+	Integer,	//!< Any integer type.
+	Number,		//!< float, double or Scalar.
+	Object,		//!< Borrowed pointer to object, must not be retained by callee.
+	Reference	//!< Reference to object, might be retained by callee.
+};
+
+/*! Fast call argument value. */
+union FastCallValue
+{
+	bool b;
+	int64_t i;
+	double n;
+	ITypedObject* o;
+};
+
+/*! Fast call descriptor.
+ *
+ * Describe a dispatch which can be invoked with plain
+ * typed arguments, thus script bindings can read arguments
+ * directly from their own stack instead of marshalling
+ * through Any.
+ *
+ * Number of arguments and their types must match the description
+ * exactly, object arguments must be either null or of described
+ * object type.
+ */
+struct FastCall
+{
+	typedef Any (*function_t)(const IRuntimeDispatch* dispatch, ITypedObject* self, const FastCallValue* argv);
+
+	enum { MaxArguments = 6 };
+
+	function_t function = nullptr;
+	uint32_t argc = 0;
+	FastCallType argumentTypes[MaxArguments];
+	const TypeInfo* objectTypes[MaxArguments];	//!< Required type of object arguments.
+};
+
+template < typename Type, bool IsTypePtr = IsPointer< Type >::value >
+struct FastCallArgument
+{
+	enum { supported = false };
+};
+
+template < >
+struct FastCallArgument < bool, false >
+{
+	enum { supported = true };
+	static constexpr FastCallType type = FastCallType::Boolean;
+	static const TypeInfo* objectType() { return nullptr; }
+	static bool get(const FastCallValue& value) { return value.b; }
+};
+
+#define T_FAST_CALL_ARGUMENT(TYPE, FCT, FIELD) \
+	template < > \
+	struct FastCallArgument < TYPE, false > \
+	{ \
+		enum { supported = true }; \
+		static constexpr FastCallType type = FastCallType::FCT; \
+		static const TypeInfo* objectType() { return nullptr; } \
+		static TYPE get(const FastCallValue& value) { return (TYPE)value.FIELD; } \
+	};
+
+T_FAST_CALL_ARGUMENT(int8_t, Integer, i)
+T_FAST_CALL_ARGUMENT(uint8_t, Integer, i)
+T_FAST_CALL_ARGUMENT(int16_t, Integer, i)
+T_FAST_CALL_ARGUMENT(uint16_t, Integer, i)
+T_FAST_CALL_ARGUMENT(int32_t, Integer, i)
+T_FAST_CALL_ARGUMENT(uint32_t, Integer, i)
+T_FAST_CALL_ARGUMENT(int64_t, Integer, i)
+T_FAST_CALL_ARGUMENT(uint64_t, Integer, i)
+T_FAST_CALL_ARGUMENT(float, Number, n)
+T_FAST_CALL_ARGUMENT(double, Number, n)
+
+#undef T_FAST_CALL_ARGUMENT
+
+template < >
+struct FastCallArgument < Scalar, false >
+{
+	enum { supported = true };
+	static constexpr FastCallType type = FastCallType::Number;
+	static const TypeInfo* objectType() { return nullptr; }
+	static Scalar get(const FastCallValue& value) { return Scalar((float)value.n); }
+};
+
+template < >
+struct FastCallArgument < const Scalar&, false >
+{
+	enum { supported = true };
+	static constexpr FastCallType type = FastCallType::Number;
+	static const TypeInfo* objectType() { return nullptr; }
+	static Scalar get(const FastCallValue& value) { return Scalar((float)value.n); }
+};
+
+template < typename Type >
+struct FastCallArgument < Type, true >
+{
+	enum { supported = std::is_base_of< ITypedObject, typename IsConst< typename IsPointer< Type >::base_t >::type_t >::value };
+	static constexpr FastCallType type = FastCallType::Object;
+	static const TypeInfo* objectType() { return &type_of< Type >(); }
+	static Type get(const FastCallValue& value) { return static_cast< Type >(value.o); }
+};
+
+template < typename Type >
+struct FastCallArgument < Ref< Type >, false >
+{
+	enum { supported = true };
+	static constexpr FastCallType type = FastCallType::Reference;
+	static const TypeInfo* objectType() { return &type_of< Type >(); }
+	static Ref< Type > get(const FastCallValue& value) { return static_cast< Type* >(value.o); }
+};
+
+template < typename Type >
+struct FastCallArgument < const Ref< Type >&, false >
+{
+	enum { supported = true };
+	static constexpr FastCallType type = FastCallType::Reference;
+	static const TypeInfo* objectType() { return &type_of< Type >(); }
+	static Ref< Type > get(const FastCallValue& value) { return static_cast< Type* >(value.o); }
+};
+
+/*! Describe fast call of given argument types.
+ *
+ * Only valid to call describe if all argument types
+ * are supported.
+ */
+template < typename ... ArgumentTypes >
+struct FastCallSignature
+{
+	static constexpr bool supported = (sizeof ... (ArgumentTypes) <= FastCall::MaxArguments) && (true && ... && bool(FastCallArgument< ArgumentTypes >::supported));
+
+	static void describe(FastCall& outFastCall, FastCall::function_t function)
+	{
+		uint32_t i = 0;
+		int __dummy__[(sizeof ... (ArgumentTypes)) + 1] = {
+			(outFastCall.argumentTypes[i] = FastCallArgument< ArgumentTypes >::type, outFastCall.objectTypes[i] = FastCallArgument< ArgumentTypes >::objectType(), ++i, 0) ...
+		};
+		(void)__dummy__;
+		outFastCall.argc = (uint32_t)sizeof ... (ArgumentTypes);
+		outFastCall.function = function;
+	}
+};
+
+/*! \} */
+
+}
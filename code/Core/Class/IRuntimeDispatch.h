@@ -24,6 +24,7 @@ namespace traktor
 
 class Any;
 class OutputStream;
+struct FastCall;
 
 /*! Runtime dispatch interface.
  * \ingroup Core
@@ -40,6 +41,9 @@ public:
 	virtual Any invoke(ITypedObject* self, uint32_t argc, const Any* argv) const = 0;
 
 	virtual bool accept(uint32_t /*argc*/, const Any* /*argv*/) const { return true; }
+
+	/*! Get fast call descriptor, null if dispatch cannot be called without Any marshalling. */
+	virtual const FastCall* getFastCall() const { return nullptr; }
 };
 
 }
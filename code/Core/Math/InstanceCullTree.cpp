@@ -0,0 +1,346 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Math/InstanceCullTree.h"
+
+#include "Core/Math/Aabb3.h"
+#include "Core/Thread/JobManager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace traktor
+{
+namespace
+{
+
+const uint32_t c_leafSize = 64;				//!< Max number of instances in leaf nodes.
+const uint32_t c_instancesPerJob = 16384;	//!< Subtrees smaller than this are culled by a single job.
+
+std::atomic< uint32_t > s_generation(0);
+
+/*! View planes, in world space, splatted for testing four instances at once. */
+struct CullContext
+{
+	uint32_t planeCount;
+	Vector4 planeX[12];
+	Vector4 planeY[12];
+	Vector4 planeZ[12];
+	Vector4 planeD[12];
+	Vector4 depthPlane;
+	Vector4 depthX;
+	Vector4 depthY;
+	Vector4 depthZ;
+	Vector4 depthW;
+	float maxDistance;
+	float lodDistances[InstanceCullTree::MaxLodCount];
+	uint32_t lodCount;
+};
+
+struct StackEntry
+{
+	uint32_t node;
+	bool inside;
+};
+
+int32_t lodFromDistance(const CullContext& cc, float distance)
+{
+	int32_t lod = 0;
+	while (lod < (int32_t)cc.lodCount && distance >= cc.lodDistances[lod])
+		++lod;
+	return lod;
+}
+
+}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.InstanceCullTree", InstanceCullTree, Object)
+
+void InstanceCullTree::build(const AlignedVector< Vector4 >& positions, const Scalar& radius)
+{
+	const uint32_t count = (uint32_t)positions.size();
+
+	m_nodes.resize(0);
+	m_radius = radius;
+	m_generation = ++s_generation;
+
+	m_indices.resize(count);
+	std::iota(m_indices.begin(), m_indices.end(), 0);
+	if (count > 0)
+		buildNode(positions, m_indices.ptr(), 0, count);
+
+	// Store positions in tree order, padded so four instances can always be loaded at once.
+	m_x.resize(count + 3, 0.0f);
+	m_y.resize(count + 3, 0.0f);
+	m_z.resize(count + 3, 0.0f);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const Vector4& p = positions[m_indices[i]];
+		m_x[i] = p.x();
+		m_y[i] = p.y();
+		m_z[i] = p.z();
+	}
+}
+
+bool InstanceCullTree::cull(const Matrix44& view, const Frustum& viewFrustum, const float* lodDistances, uint32_t lodCount, CullResult& inoutResult) const
+{
+	T_ASSERT(lodCount > 0 && lodCount <= MaxLodCount);
+
+	// Check if cached result is still valid.
+	const Matrix44 viewInv = view.inverse();
+	StaticVector< Vector4, 12 > planes;
+	for (const auto& plane : viewFrustum.planes)
+	{
+		const Plane worldPlane = viewInv * plane;
+		planes.push_back(worldPlane.normal().xyz0() + Vector4(0.0f, 0.0f, 0.0f, worldPlane.distance()));
+	}
+
+	if (
+		inoutResult.m_generation == m_generation &&
+		inoutResult.m_view == view &&
+		inoutResult.m_lodCount == lodCount &&
+		std::memcmp(inoutResult.m_lodDistances, lodDistances, lodCount * sizeof(float)) == 0 &&
+		inoutResult.m_planes.size() == planes.size() &&
+		std::equal(planes.begin(), planes.end(), inoutResult.m_planes.begin())
+	)
+		return false;
+
+	inoutResult.m_generation = m_generation;
+	inoutResult.m_view = view;
+	inoutResult.m_planes = planes;
+	inoutResult.m_lodCount = lodCount;
+	std::memcpy(inoutResult.m_lodDistances, lodDistances, lodCount * sizeof(float));
+
+	for (uint32_t i = 0; i < MaxLodCount; ++i)
+		inoutResult.lodIndices[i].resize(0);
+
+	if (m_nodes.empty())
+		return true;
+
+	// Setup culling context.
+	CullContext cc;
+	cc.planeCount = (uint32_t)planes.size();
+	for (uint32_t i = 0; i < cc.planeCount; ++i)
+	{
+		cc.planeX[i] = Vector4(planes[i].x());
+		cc.planeY[i] = Vector4(planes[i].y());
+		cc.planeZ[i] = Vector4(planes[i].z());
+		cc.planeD[i] = Vector4(planes[i].w());
+	}
+
+	// View depth as a plane in world space.
+	cc.depthPlane = view.transpose().get(2) + Vector4(0.0f, 0.0f, 0.0f, m_radius);
+	cc.depthX = Vector4(cc.depthPlane.x());
+	cc.depthY = Vector4(cc.depthPlane.y());
+	cc.depthZ = Vector4(cc.depthPlane.z());
+	cc.depthW = Vector4(cc.depthPlane.w());
+	cc.maxDistance = lodDistances[lodCount - 1];
+	std::memcpy(cc.lodDistances, lodDistances, lodCount * sizeof(float));
+	cc.lodCount = lodCount;
+
+	// Classify node; -1 outside, 0 partial or multiple lods, otherwise 1 + lod of all instances.
+	auto classify = [&](const Node& node, bool& inoutInside) -> int32_t {
+		const Vector4 center = node.sphere.xyz1();
+		const Scalar radius = node.sphere.w();
+
+		if (!inoutInside)
+		{
+			bool inside = true;
+			for (uint32_t i = 0; i < cc.planeCount; ++i)
+			{
+				const Scalar d = dot3(planes[i], center) - planes[i].w();
+				if (d < -radius)
+					return -1;
+				if (d < radius)
+					inside = false;
+			}
+			inoutInside = inside;
+		}
+
+		const Scalar z = dot3(cc.depthPlane, center) + cc.depthPlane.w();
+		const float nearDistance = z - radius;
+		const float farDistance = z + radius;
+		if (nearDistance >= cc.maxDistance)
+			return -1;
+
+		if (!inoutInside)
+			return 0;
+
+		const int32_t nearLod = lodFromDistance(cc, nearDistance);
+		const int32_t farLod = lodFromDistance(cc, farDistance);
+		return nearLod == farLod ? 1 + nearLod : 0;
+	};
+
+	// Cull subtree into set of index arrays.
+	auto cullSubTree = [&](uint32_t root, bool rootInside, AlignedVector< uint32_t >* outLodIndices) {
+		StaticVector< StackEntry, 64 > stack;
+		stack.push_back({ root, rootInside });
+		while (!stack.empty())
+		{
+			const StackEntry se = stack.back();
+			stack.pop_back();
+
+			const Node& node = m_nodes[se.node];
+			bool inside = se.inside;
+			const int32_t c = classify(node, inside);
+			if (c < 0)
+				continue;
+
+			// Entire node visible with same lod.
+			if (c > 0)
+			{
+				const uint32_t* indices = m_indices.c_ptr();
+				outLodIndices[c - 1].insert(outLodIndices[c - 1].end(), indices + node.first, indices + node.last);
+				continue;
+			}
+
+			if (node.right != 0)
+			{
+				stack.push_back({ node.right, inside });
+				stack.push_back({ se.node + 1, inside });
+				continue;
+			}
+
+			// Leaf; test four instances at a time.
+			for (uint32_t i = node.first; i < node.last; i += 4)
+			{
+				const Vector4 x = Vector4::loadUnaligned(&m_x[i]);
+				const Vector4 y = Vector4::loadUnaligned(&m_y[i]);
+				const Vector4 z = Vector4::loadUnaligned(&m_z[i]);
+
+				T_MATH_ALIGN16 float planeDistances[4];
+				if (!inside)
+				{
+					Vector4 mn(Scalar(std::numeric_limits< float >::max()));
+					for (uint32_t j = 0; j < cc.planeCount; ++j)
+						mn = min(mn, x * cc.planeX[j] + y * cc.planeY[j] + z * cc.planeZ[j] - cc.planeD[j]);
+					(mn + Vector4(m_radius)).storeAligned(planeDistances);
+				}
+				else
+					Vector4::zero().storeAligned(planeDistances);
+
+				T_MATH_ALIGN16 float distances[4];
+				(x * cc.depthX + y * cc.depthY + z * cc.depthZ + cc.depthW).storeAligned(distances);
+
+				const uint32_t n = std::min< uint32_t >(4, node.last - i);
+				for (uint32_t j = 0; j < n; ++j)
+				{
+					if (planeDistances[j] < 0.0f)
+						continue;
+					const int32_t lod = lodFromDistance(cc, distances[j]);
+					if (lod < (int32_t)cc.lodCount)
+						outLodIndices[lod].push_back(m_indices[i + j]);
+				}
+			}
+		}
+	};
+
+	// Find subtrees to cull in parallel; upper nodes are classified here.
+	StaticVector< StackEntry, 256 > jobRoots;
+	{
+		StaticVector< StackEntry, 256 > stack;
+		stack.push_back({ 0, false });
+		while (!stack.empty())
+		{
+			const StackEntry se = stack.back();
+			stack.pop_back();
+
+			const Node& node = m_nodes[se.node];
+			if (node.last - node.first <= c_instancesPerJob || node.right == 0 || jobRoots.size() + stack.size() + 2 >= jobRoots.capacity())
+			{
+				jobRoots.push_back(se);
+				continue;
+			}
+
+			bool inside = se.inside;
+			if (classify(node, inside) < 0)
+				continue;
+
+			stack.push_back({ node.right, inside });
+			stack.push_back({ se.node + 1, inside });
+		}
+	}
+
+	if (jobRoots.size() <= 1)
+	{
+		for (const auto& jobRoot : jobRoots)
+			cullSubTree(jobRoot.node, jobRoot.inside, inoutResult.lodIndices);
+		return true;
+	}
+
+	auto& jobIndices = inoutResult.m_jobIndices;
+	if (jobIndices.size() < jobRoots.size() * MaxLodCount)
+		jobIndices.resize(jobRoots.size() * MaxLodCount);
+
+	AlignedVector< Job::task_t > jobs;
+	for (uint32_t i = 0; i < jobRoots.size(); ++i)
+	{
+		AlignedVector< uint32_t >* outLodIndices = &jobIndices[i * MaxLodCount];
+		for (uint32_t j = 0; j < lodCount; ++j)
+			outLodIndices[j].resize(0);
+		jobs.push_back([=, &cullSubTree, &jobRoots](){
+			cullSubTree(jobRoots[i].node, jobRoots[i].inside, outLodIndices);
+		});
+	}
+	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+
+	// Merge results from each job.
+	for (uint32_t j = 0; j < lodCount; ++j)
+	{
+		size_t total = 0;
+		for (uint32_t i = 0; i < jobRoots.size(); ++i)
+			total += jobIndices[i * MaxLodCount + j].size();
+
+		auto& lodIndices = inoutResult.lodIndices[j];
+		lodIndices.resize(total);
+
+		size_t offset = 0;
+		for (uint32_t i = 0; i < jobRoots.size(); ++i)
+		{
+			const auto& indices = jobIndices[i * MaxLodCount + j];
+			if (!indices.empty())
+				std::memcpy(lodIndices.ptr() + offset, indices.c_ptr(), indices.size() * sizeof(uint32_t));
+			offset += indices.size();
+		}
+	}
+
+	return true;
+}
+
+uint32_t InstanceCullTree::buildNode(const AlignedVector< Vector4 >& positions, uint32_t* order, uint32_t first, uint32_t last)
+{
+	Aabb3 bounds;
+	for (uint32_t i = first; i < last; ++i)
+		bounds.contain(positions[order[i]]);
+
+	const uint32_t nodeIndex = (uint32_t)m_nodes.size();
+	Node& node = m_nodes.push_back();
+	node.sphere = bounds.getCenter().xyz0() + Vector4(0.0f, 0.0f, 0.0f, bounds.getExtent().length() + m_radius);
+	node.first = first;
+	node.last = last;
+	node.right = 0;
+
+	if (last - first <= c_leafSize)
+		return nodeIndex;
+
+	// Split at median along major axis.
+	const int32_t axis = majorAxis3(bounds.getExtent());
+	const uint32_t middle = (first + last) / 2;
+	std::nth_element(order + first, order + middle, order + last, [&](uint32_t lh, uint32_t rh) {
+		return positions[lh][axis] < positions[rh][axis];
+	});
+
+	buildNode(positions, order, first, middle);
+	const uint32_t right = buildNode(positions, order, middle, last);
+	m_nodes[nodeIndex].right = right;
+	return nodeIndex;
+}
+
+}
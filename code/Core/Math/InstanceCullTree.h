@@ -0,0 +1,111 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/StaticVector.h"
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Matrix44.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_CORE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+/*! Bounding sphere hierarchy of instances.
+ *
+ * Instances, such as vegetation, are spatially clustered
+ * into a binary tree of bounding spheres. Culling reject
+ * or accept entire clusters and only test individual
+ * instances, four at a time, in clusters intersecting
+ * frustum or lod boundaries. Large trees are culled
+ * in parallel.
+ *
+ * \ingroup Core
+ */
+class T_DLLCLASS InstanceCullTree : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	enum { MaxLodCount = 4 };
+
+	/*! Culling result, one per view.
+	 *
+	 * Last cull is cached and reused as long as
+	 * view, frustum and lod distances are the same.
+	 */
+	class CullResult
+	{
+	public:
+		AlignedVector< uint32_t > lodIndices[MaxLodCount];	//!< Indices of visible instances, per lod.
+
+	private:
+		friend class InstanceCullTree;
+
+		uint32_t m_generation = 0;
+		Matrix44 m_view;
+		StaticVector< Vector4, 12 > m_planes;
+		float m_lodDistances[MaxLodCount];
+		uint32_t m_lodCount = 0;
+		AlignedVector< AlignedVector< uint32_t > > m_jobIndices;
+	};
+
+	/*! Build tree.
+	 *
+	 * \param positions Instance bounding sphere centers.
+	 * \param radius Instance bounding sphere radius.
+	 */
+	void build(const AlignedVector< Vector4 >& positions, const Scalar& radius);
+
+	/*! Cull instances.
+	 *
+	 * Distance of an instance is it's view depth plus
+	 * radius, same as WorldRenderView::isBoxVisible.
+	 *
+	 * \param view View transform.
+	 * \param viewFrustum Cull frustum in view space.
+	 * \param lodDistances Ascending distance limit of each lod, instances beyond last limit are culled.
+	 * \param lodCount Number of lods.
+	 * \param inoutResult Visible instances, per lod.
+	 * \return True if result was updated, false if cached result is still valid.
+	 */
+	bool cull(const Matrix44& view, const Frustum& viewFrustum, const float* lodDistances, uint32_t lodCount, CullResult& inoutResult) const;
+
+	/*! Get number of instances in tree. */
+	uint32_t getInstanceCount() const { return (uint32_t)m_indices.size(); }
+
+private:
+	struct Node
+	{
+		Vector4 sphere;		//!< Center xyz and radius in w, encloses all instance spheres.
+		uint32_t first;		//!< First instance.
+		uint32_t last;		//!< End instance.
+		uint32_t right;		//!< Right child, left child is always next node; 0 if leaf.
+	};
+
+	AlignedVector< Node > m_nodes;
+	AlignedVector< float > m_x;
+	AlignedVector< float > m_y;
+	AlignedVector< float > m_z;
+	AlignedVector< uint32_t > m_indices;
+	Scalar m_radius;
+	uint32_t m_generation = 0;
+
+	uint32_t buildNode(const AlignedVector< Vector4 >& positions, uint32_t* order, uint32_t first, uint32_t last);
+};
+
+}
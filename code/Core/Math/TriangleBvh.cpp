@@ -0,0 +1,823 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Math/TriangleBvh.h"
+
+#include "Core/Thread/JobManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace traktor
+{
+namespace
+{
+
+const uint32_t c_minLeafSize = 4;			//!< Ranges this small are never split.
+const uint32_t c_maxLeafSize = 8;			//!< Ranges larger than this are always split.
+const uint32_t c_binCount = 16;				//!< Number of SAH bins.
+const uint32_t c_subTreeSize = 8192;		//!< Sub trees smaller than this are built by a single job.
+const int32_t c_maxDepth = 48;				//!< Split at median beyond this depth, keeps traversal stack bounded.
+const int32_t c_maxStackSize = 256;
+
+struct Triangle
+{
+	Vector4 v0;
+	Vector4 v1;
+	Vector4 v2;
+	int32_t polygon;
+};
+
+struct BuildRef
+{
+	Vector4 mn;
+	Vector4 mx;
+	Vector4 centroid;
+	uint32_t triangle;
+};
+
+struct StackEntry
+{
+	int32_t node;
+	float nearT;
+};
+
+float surfaceArea(const Vector4& mn, const Vector4& mx)
+{
+	const Vector4 e = mx - mn;
+	return 2.0f * (e.x() * e.y() + e.y() * e.z() + e.z() * e.x());
+}
+
+float safeReciprocal(float v)
+{
+	const float c_tiny = 1e-20f;
+	return 1.0f / (std::abs(v) > c_tiny ? v : (v >= 0.0f ? c_tiny : -c_tiny));
+}
+
+}
+
+/*! Ray splatted into all lanes. */
+struct TriangleBvh::Ray
+{
+	Vector4 origin;
+	Vector4 direction;
+	Vector4 ox, oy, oz;
+	Vector4 dx, dy, dz;
+	Vector4 idx, idy, idz;
+
+	explicit Ray(const Vector4& origin_, const Vector4& direction_)
+	:	origin(origin_)
+	,	direction(direction_)
+	,	ox(origin_.x())
+	,	oy(origin_.y())
+	,	oz(origin_.z())
+	,	dx(direction_.x())
+	,	dy(direction_.y())
+	,	dz(direction_.z())
+	,	idx(Scalar(safeReciprocal(direction_.x())))
+	,	idy(Scalar(safeReciprocal(direction_.y())))
+	,	idz(Scalar(safeReciprocal(direction_.z())))
+	{
+	}
+};
+
+/*! Build sub tree into own node and packet arrays. */
+class TriangleBvh::Builder
+{
+public:
+	struct Deferred
+	{
+		uint32_t node;
+		uint32_t lane;
+		uint32_t first;
+		uint32_t last;
+		int32_t depth;
+	};
+
+	const Triangle* triangles = nullptr;
+	BuildRef* refs = nullptr;
+	AlignedVector< Deferred >* deferred = nullptr;
+	AlignedVector< Node > nodes;
+	AlignedVector< Packet > packets;
+
+	uint32_t buildNode(uint32_t first, uint32_t last, int32_t depth)
+	{
+		// Split range, and resulting ranges, until we have four children.
+		uint32_t firsts[4] = { first, 0, 0, 0 };
+		uint32_t lasts[4] = { last, 0, 0, 0 };
+		bool leafs[4] = { false, false, false, false };
+		uint32_t n = 1;
+
+		while (n < 4)
+		{
+			int32_t candidate = -1;
+			for (uint32_t i = 0; i < n; ++i)
+			{
+				if (!leafs[i] && (candidate < 0 || lasts[i] - firsts[i] > lasts[candidate] - firsts[candidate]))
+					candidate = (int32_t)i;
+			}
+			if (candidate < 0)
+				break;
+
+			uint32_t middle;
+			if (!split(firsts[candidate], lasts[candidate], depth, middle))
+			{
+				leafs[candidate] = true;
+				continue;
+			}
+
+			firsts[n] = middle;
+			lasts[n] = lasts[candidate];
+			leafs[n] = false;
+			lasts[candidate] = middle;
+			++n;
+		}
+
+		const uint32_t nodeIndex = (uint32_t)nodes.size();
+		nodes.push_back();
+
+		T_MATH_ALIGN16 float mnx[4], mny[4], mnz[4], mxx[4], mxy[4], mxz[4];
+		int32_t child[4] = { -1, -1, -1, -1 };
+		uint32_t count[4] = { 0, 0, 0, 0 };
+
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			mnx[i] = mny[i] = mnz[i] = std::numeric_limits< float >::max();
+			mxx[i] = mxy[i] = mxz[i] = -std::numeric_limits< float >::max();
+		}
+
+		for (uint32_t i = 0; i < n; ++i)
+		{
+			Vector4 mn(Scalar(std::numeric_limits< float >::max()));
+			Vector4 mx(Scalar(-std::numeric_limits< float >::max()));
+			for (uint32_t j = firsts[i]; j < lasts[i]; ++j)
+			{
+				mn = min(mn, refs[j].mn);
+				mx = max(mx, refs[j].mx);
+			}
+
+			mnx[i] = mn.x(); mny[i] = mn.y(); mnz[i] = mn.z();
+			mxx[i] = mx.x(); mxy[i] = mx.y(); mxz[i] = mx.z();
+
+			if (leafs[i] || lasts[i] - firsts[i] <= c_maxLeafSize)
+			{
+				child[i] = (int32_t)packets.size();
+				count[i] = buildLeaf(firsts[i], lasts[i]);
+			}
+			else if (deferred != nullptr && lasts[i] - firsts[i] <= c_subTreeSize)
+				deferred->push_back({ nodeIndex, i, firsts[i], lasts[i], depth + 1 });
+			else
+				child[i] = (int32_t)buildNode(firsts[i], lasts[i], depth + 1);
+		}
+
+		Node& node = nodes[nodeIndex];
+		node.mnX = Vector4::loadAligned(mnx);
+		node.mnY = Vector4::loadAligned(mny);
+		node.mnZ = Vector4::loadAligned(mnz);
+		node.mxX = Vector4::loadAligned(mxx);
+		node.mxY = Vector4::loadAligned(mxy);
+		node.mxZ = Vector4::loadAligned(mxz);
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			node.child[i] = child[i];
+			node.count[i] = count[i];
+		}
+
+		return nodeIndex;
+	}
+
+private:
+	struct Bin
+	{
+		Vector4 mn;
+		Vector4 mx;
+		uint32_t count;
+	};
+
+	bool split(uint32_t first, uint32_t last, int32_t depth, uint32_t& outMiddle) const
+	{
+		const uint32_t count = last - first;
+		if (count <= c_minLeafSize)
+			return false;
+
+		Vector4 mn(Scalar(std::numeric_limits< float >::max()));
+		Vector4 mx(Scalar(-std::numeric_limits< float >::max()));
+		Vector4 cmn = mn, cmx = mx;
+		for (uint32_t i = first; i < last; ++i)
+		{
+			mn = min(mn, refs[i].mn);
+			mx = max(mx, refs[i].mx);
+			cmn = min(cmn, refs[i].centroid);
+			cmx = max(cmx, refs[i].centroid);
+		}
+
+		const int32_t majorAxis = majorAxis3(cmx - cmn);
+		if (depth > c_maxDepth)
+			return splitMedian(first, last, majorAxis, outMiddle);
+
+		// Find best split plane in each axis.
+		int32_t bestAxis = -1;
+		uint32_t bestBin = 0;
+		float bestCost = std::numeric_limits< float >::max();
+
+		for (int32_t axis = 0; axis < 3; ++axis)
+		{
+			const float cmin = cmn[axis];
+			const float extent = cmx[axis] - cmin;
+			if (extent <= FUZZY_EPSILON)
+				continue;
+
+			const float scale = float(c_binCount) / extent;
+
+			Bin bins[c_binCount];
+			for (auto& bin : bins)
+			{
+				bin.mn = Vector4(Scalar(std::numeric_limits< float >::max()));
+				bin.mx = Vector4(Scalar(-std::numeric_limits< float >::max()));
+				bin.count = 0;
+			}
+
+			for (uint32_t i = first; i < last; ++i)
+			{
+				const uint32_t b = std::min< uint32_t >((uint32_t)((float(refs[i].centroid[axis]) - cmin) * scale), c_binCount - 1);
+				bins[b].mn = min(bins[b].mn, refs[i].mn);
+				bins[b].mx = max(bins[b].mx, refs[i].mx);
+				bins[b].count++;
+			}
+
+			float rightArea[c_binCount];
+			uint32_t rightCount[c_binCount];
+			{
+				Vector4 rmn = bins[c_binCount - 1].mn, rmx = bins[c_binCount - 1].mx;
+				uint32_t rc = 0;
+				for (uint32_t b = c_binCount - 1; b > 0; --b)
+				{
+					rmn = min(rmn, bins[b].mn);
+					rmx = max(rmx, bins[b].mx);
+					rc += bins[b].count;
+					rightArea[b] = rc > 0 ? surfaceArea(rmn, rmx) : 0.0f;
+					rightCount[b] = rc;
+				}
+			}
+
+			Vector4 lmn = bins[0].mn, lmx = bins[0].mx;
+			uint32_t lc = 0;
+			for (uint32_t b = 1; b < c_binCount; ++b)
+			{
+				lmn = min(lmn, bins[b - 1].mn);
+				lmx = max(lmx, bins[b - 1].mx);
+				lc += bins[b - 1].count;
+				if (lc == 0 || rightCount[b] == 0)
+					continue;
+
+				const float cost = surfaceArea(lmn, lmx) * lc + rightArea[b] * rightCount[b];
+				if (cost < bestCost)
+				{
+					bestAxis = axis;
+					bestBin = b;
+					bestCost = cost;
+				}
+			}
+		}
+
+		// All centroids coincide; split arbitrary if too many to put in a leaf.
+		if (bestAxis < 0)
+		{
+			if (count <= c_maxLeafSize)
+				return false;
+			outMiddle = first + count / 2;
+			return true;
+		}
+
+		// Compare with cost of not splitting.
+		const float area = surfaceArea(mn, mx);
+		if (count <= c_maxLeafSize && bestCost + area >= area * count)
+			return false;
+
+		const float cmin = cmn[bestAxis];
+		const float scale = float(c_binCount) / (cmx[bestAxis] - cmin);
+		BuildRef* middle = std::partition(refs + first, refs + last, [&](const BuildRef& ref) {
+			return std::min< uint32_t >((uint32_t)((float(ref.centroid[bestAxis]) - cmin) * scale), c_binCount - 1) < bestBin;
+		});
+
+		outMiddle = (uint32_t)(middle - refs);
+		if (outMiddle == first || outMiddle == last)
+			return splitMedian(first, last, majorAxis, outMiddle);
+
+		return true;
+	}
+
+	bool splitMedian(uint32_t first, uint32_t last, int32_t axis, uint32_t& outMiddle) const
+	{
+		outMiddle = first + (last - first) / 2;
+		std::nth_element(refs + first, refs + outMiddle, refs + last, [&](const BuildRef& lh, const BuildRef& rh) {
+			return float(lh.centroid[axis]) < float(rh.centroid[axis]);
+		});
+		return true;
+	}
+
+	uint32_t buildLeaf(uint32_t first, uint32_t last)
+	{
+		uint32_t count = 0;
+		for (uint32_t i = first; i < last; i += 4)
+		{
+			T_MATH_ALIGN16 float v[9][4];
+			Packet& packet = packets.push_back();
+
+			for (uint32_t j = 0; j < 4; ++j)
+			{
+				if (i + j < last)
+				{
+					const Triangle& t = triangles[refs[i + j].triangle];
+					const Vector4 e1 = t.v1 - t.v0;
+					const Vector4 e2 = t.v2 - t.v0;
+					for (int32_t k = 0; k < 3; ++k)
+					{
+						v[k][j] = t.v0[k];
+						v[3 + k][j] = e1[k];
+						v[6 + k][j] = e2[k];
+					}
+					packet.polygon[j] = t.polygon;
+				}
+				else
+				{
+					// Degenerate triangles are never intersected.
+					for (int32_t k = 0; k < 9; ++k)
+						v[k][j] = 0.0f;
+					packet.polygon[j] = -1;
+				}
+			}
+
+			packet.v0X = Vector4::loadAligned(v[0]);
+			packet.v0Y = Vector4::loadAligned(v[1]);
+			packet.v0Z = Vector4::loadAligned(v[2]);
+			packet.e1X = Vector4::loadAligned(v[3]);
+			packet.e1Y = Vector4::loadAligned(v[4]);
+			packet.e1Z = Vector4::loadAligned(v[5]);
+			packet.e2X = Vector4::loadAligned(v[6]);
+			packet.e2Y = Vector4::loadAligned(v[7]);
+			packet.e2Z = Vector4::loadAligned(v[8]);
+			++count;
+		}
+		return count;
+	}
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.TriangleBvh", TriangleBvh, Object)
+
+void TriangleBvh::build(const AlignedVector< Winding3 >& polygons)
+{
+	m_nodes.clear();
+	m_packets.clear();
+	m_boundingBox = Aabb3();
+	m_triangleCount = 0;
+
+	// Triangulate polygons as fans.
+	AlignedVector< Triangle > triangles;
+	for (uint32_t i = 0; i < (uint32_t)polygons.size(); ++i)
+	{
+		const auto& points = polygons[i].get();
+		for (uint32_t j = 2; j < (uint32_t)points.size(); ++j)
+			triangles.push_back({ points[0], points[j - 1], points[j], (int32_t)i });
+	}
+	if (triangles.empty())
+		return;
+
+	AlignedVector< BuildRef > refs(triangles.size());
+	for (uint32_t i = 0; i < (uint32_t)triangles.size(); ++i)
+	{
+		const Triangle& t = triangles[i];
+		BuildRef& ref = refs[i];
+		ref.mn = min(min(t.v0, t.v1), t.v2).xyz1();
+		ref.mx = max(max(t.v0, t.v1), t.v2).xyz1();
+		ref.centroid = ((ref.mn + ref.mx) * 0.5_simd).xyz1();
+		ref.triangle = i;
+		m_boundingBox.contain(ref.mn);
+		m_boundingBox.contain(ref.mx);
+	}
+
+	// Build top of tree, sub trees are deferred and built in parallel.
+	AlignedVector< Builder::Deferred > deferred;
+	Builder root;
+	root.triangles = triangles.c_ptr();
+	root.refs = refs.ptr();
+	root.deferred = refs.size() > c_subTreeSize ? &deferred : nullptr;
+	root.buildNode(0, (uint32_t)refs.size(), 0);
+
+	AlignedVector< Builder > builders(deferred.size());
+	AlignedVector< Job::task_t > jobs;
+	for (uint32_t i = 0; i < (uint32_t)deferred.size(); ++i)
+	{
+		builders[i].triangles = triangles.c_ptr();
+		builders[i].refs = refs.ptr();
+		jobs.push_back([&, i]() {
+			builders[i].buildNode(deferred[i].first, deferred[i].last, deferred[i].depth);
+		});
+	}
+	if (!jobs.empty())
+		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+
+	// Merge sub trees, relocating child references.
+	m_nodes.swap(root.nodes);
+	m_packets.swap(root.packets);
+	for (uint32_t i = 0; i < (uint32_t)builders.size(); ++i)
+	{
+		const int32_t nodeOffset = (int32_t)m_nodes.size();
+		const int32_t packetOffset = (int32_t)m_packets.size();
+
+		for (const auto& node : builders[i].nodes)
+		{
+			Node& n = m_nodes.push_back();
+			n = node;
+			for (uint32_t j = 0; j < 4; ++j)
+			{
+				if (n.count[j] > 0)
+					n.child[j] += packetOffset;
+				else if (n.child[j] >= 0)
+					n.child[j] += nodeOffset;
+			}
+		}
+		m_packets.insert(m_packets.end(), builders[i].packets.begin(), builders[i].packets.end());
+
+		Node& parent = m_nodes[deferred[i].node];
+		parent.child[deferred[i].lane] = nodeOffset;
+		parent.count[deferred[i].lane] = 0;
+
+		builders[i].nodes.clear();
+		builders[i].packets.clear();
+	}
+
+	m_triangleCount = (uint32_t)triangles.size();
+}
+
+bool TriangleBvh::queryClosestIntersection(const Vector4& origin, const Vector4& direction, float maxDistance, int32_t ignore, QueryResult& outResult) const
+{
+	outResult.index = -1;
+	if (m_nodes.empty())
+		return false;
+
+	const Ray ray(origin, direction);
+	float bestT = maxDistance > FUZZY_EPSILON ? maxDistance : std::numeric_limits< float >::max();
+	const Packet* bestPacket = nullptr;
+	int32_t bestLane = -1;
+
+	StackEntry stack[c_maxStackSize];
+	int32_t sp = 0;
+	stack[sp++] = { 0, 0.0f };
+
+	while (sp > 0)
+	{
+		const StackEntry se = stack[--sp];
+		if (se.nearT > bestT)
+			continue;
+
+		const Node& node = m_nodes[se.node];
+
+		T_MATH_ALIGN16 float nearT[4];
+		T_MATH_ALIGN16 float farT[4];
+		intersectNode(node, ray, bestT, nearT, farT);
+
+		// Push children sorted, nearest child is popped first.
+		StackEntry hits[4];
+		int32_t nhits = 0;
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			if (node.child[i] < 0 || nearT[i] > farT[i])
+				continue;
+
+			if (node.count[i] > 0)
+			{
+				for (uint32_t j = 0; j < node.count[i]; ++j)
+				{
+					const Packet& packet = m_packets[node.child[i] + j];
+					if (intersectPacket(packet, ray, ignore, bestT, bestLane))
+						bestPacket = &packet;
+				}
+				continue;
+			}
+
+			int32_t k = nhits++;
+			for (; k > 0 && hits[k - 1].nearT < nearT[i]; --k)
+				hits[k] = hits[k - 1];
+			hits[k] = { node.child[i], nearT[i] };
+		}
+		for (int32_t i = 0; i < nhits; ++i)
+			stack[sp++] = hits[i];
+	}
+
+	if (!bestPacket)
+		return false;
+
+	const Vector4 e1(bestPacket->e1X.get(bestLane), bestPacket->e1Y.get(bestLane), bestPacket->e1Z.get(bestLane), 0.0f);
+	const Vector4 e2(bestPacket->e2X.get(bestLane), bestPacket->e2Y.get(bestLane), bestPacket->e2Z.get(bestLane), 0.0f);
+
+	outResult.index = bestPacket->polygon[bestLane];
+	outResult.distance = Scalar(bestT);
+	outResult.position = origin + direction * Scalar(bestT);
+	outResult.normal = cross(e2, e1).normalized();
+	return true;
+}
+
+bool TriangleBvh::queryAnyIntersection(const Vector4& origin, const Vector4& direction, float maxDistance, int32_t ignore) const
+{
+	if (m_nodes.empty())
+		return false;
+
+	const Ray ray(origin, direction);
+	const float md = maxDistance > FUZZY_EPSILON ? maxDistance : std::numeric_limits< float >::max();
+
+	int32_t stack[c_maxStackSize];
+	int32_t sp = 0;
+	stack[sp++] = 0;
+
+	while (sp > 0)
+	{
+		const Node& node = m_nodes[stack[--sp]];
+
+		T_MATH_ALIGN16 float nearT[4];
+		T_MATH_ALIGN16 float farT[4];
+		intersectNode(node, ray, md, nearT, farT);
+
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			if (node.child[i] < 0 || nearT[i] > farT[i])
+				continue;
+
+			if (node.count[i] > 0)
+			{
+				for (uint32_t j = 0; j < node.count[i]; ++j)
+				{
+					float t = md;
+					int32_t lane;
+					if (intersectPacket(m_packets[node.child[i] + j], ray, ignore, t, lane))
+						return true;
+				}
+			}
+			else
+				stack[sp++] = node.child[i];
+		}
+	}
+
+	return false;
+}
+
+uint32_t TriangleBvh::queryClosestIntersection(const Vector4* origins, const Vector4* directions, const float* maxDistances, int32_t ignore, QueryResult* outResults) const
+{
+	if (m_nodes.empty())
+		return 0;
+
+	const Ray rays[PacketSize] = { Ray(origins[0], directions[0]), Ray(origins[1], directions[1]), Ray(origins[2], directions[2]), Ray(origins[3], directions[3]) };
+
+	// Rays in lanes, used to test all rays against one child box.
+	const Vector4 ox(origins[0].x(), origins[1].x(), origins[2].x(), origins[3].x());
+	const Vector4 oy(origins[0].y(), origins[1].y(), origins[2].y(), origins[3].y());
+	const Vector4 oz(origins[0].z(), origins[1].z(), origins[2].z(), origins[3].z());
+	const Vector4 idx(rays[0].idx.x(), rays[1].idx.x(), rays[2].idx.x(), rays[3].idx.x());
+	const Vector4 idy(rays[0].idy.x(), rays[1].idy.x(), rays[2].idy.x(), rays[3].idy.x());
+	const Vector4 idz(rays[0].idz.x(), rays[1].idz.x(), rays[2].idz.x(), rays[3].idz.x());
+
+	T_MATH_ALIGN16 float bestT[PacketSize];
+	const Packet* bestPacket[PacketSize] = { nullptr, nullptr, nullptr, nullptr };
+	int32_t bestLane[PacketSize] = { -1, -1, -1, -1 };
+	for (uint32_t r = 0; r < PacketSize; ++r)
+		bestT[r] = maxDistances[r] > FUZZY_EPSILON ? maxDistances[r] : std::numeric_limits< float >::max();
+
+	StackEntry stack[c_maxStackSize];
+	int32_t sp = 0;
+	stack[sp++] = { 0, 0.0f };
+
+	while (sp > 0)
+	{
+		const StackEntry se = stack[--sp];
+		if (se.nearT > std::max(std::max(bestT[0], bestT[1]), std::max(bestT[2], bestT[3])))
+			continue;
+
+		const Node& node = m_nodes[se.node];
+
+		// Push children sorted on nearest ray, nearest child is popped first.
+		StackEntry hits[4];
+		int32_t nhits = 0;
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			if (node.child[i] < 0)
+				continue;
+
+			const Vector4 farLimit = Vector4::loadAligned(bestT);
+
+			const Vector4 t0x = (Vector4(node.mnX.get(i)) - ox) * idx;
+			const Vector4 t1x = (Vector4(node.mxX.get(i)) - ox) * idx;
+			const Vector4 t0y = (Vector4(node.mnY.get(i)) - oy) * idy;
+			const Vector4 t1y = (Vector4(node.mxY.get(i)) - oy) * idy;
+			const Vector4 t0z = (Vector4(node.mnZ.get(i)) - oz) * idz;
+			const Vector4 t1z = (Vector4(node.mxZ.get(i)) - oz) * idz;
+
+			T_MATH_ALIGN16 float nearT[4];
+			T_MATH_ALIGN16 float farT[4];
+			max(max(min(t0x, t1x), min(t0y, t1y)), max(min(t0z, t1z), Vector4::zero())).storeAligned(nearT);
+			min(min(max(t0x, t1x), max(t0y, t1y)), min(max(t0z, t1z), farLimit)).storeAligned(farT);
+
+			uint32_t mask = 0;
+			float nearest = std::numeric_limits< float >::max();
+			for (uint32_t r = 0; r < PacketSize; ++r)
+			{
+				if (nearT[r] <= farT[r])
+				{
+					mask |= 1 << r;
+					nearest = std::min(nearest, nearT[r]);
+				}
+			}
+			if (!mask)
+				continue;
+
+			if (node.count[i] > 0)
+			{
+				for (uint32_t r = 0; r < PacketSize; ++r)
+				{
+					if ((mask & (1 << r)) == 0)
+						continue;
+					for (uint32_t j = 0; j < node.count[i]; ++j)
+					{
+						const Packet& packet = m_packets[node.child[i] + j];
+						if (intersectPacket(packet, rays[r], ignore, bestT[r], bestLane[r]))
+							bestPacket[r] = &packet;
+					}
+				}
+			}
+			else
+			{
+				int32_t k = nhits++;
+				for (; k > 0 && hits[k - 1].nearT < nearest; --k)
+					hits[k] = hits[k - 1];
+				hits[k] = { node.child[i], nearest };
+			}
+		}
+		for (int32_t i = 0; i < nhits; ++i)
+			stack[sp++] = hits[i];
+	}
+
+	uint32_t result = 0;
+	for (uint32_t r = 0; r < PacketSize; ++r)
+	{
+		outResults[r].index = -1;
+		if (!bestPacket[r])
+			continue;
+
+		const Packet& packet = *bestPacket[r];
+		const int32_t lane = bestLane[r];
+		const Vector4 e1(packet.e1X.get(lane), packet.e1Y.get(lane), packet.e1Z.get(lane), 0.0f);
+		const Vector4 e2(packet.e2X.get(lane), packet.e2Y.get(lane), packet.e2Z.get(lane), 0.0f);
+
+		outResults[r].index = packet.polygon[lane];
+		outResults[r].distance = Scalar(bestT[r]);
+		outResults[r].position = origins[r] + directions[r] * Scalar(bestT[r]);
+		outResults[r].normal = cross(e2, e1).normalized();
+		result |= 1 << r;
+	}
+	return result;
+}
+
+uint32_t TriangleBvh::queryAnyIntersection(const Vector4* origins, const Vector4* directions, const float* maxDistances, int32_t ignore) const
+{
+	if (m_nodes.empty())
+		return 0;
+
+	const Ray rays[PacketSize] = { Ray(origins[0], directions[0]), Ray(origins[1], directions[1]), Ray(origins[2], directions[2]), Ray(origins[3], directions[3]) };
+
+	const Vector4 ox(origins[0].x(), origins[1].x(), origins[2].x(), origins[3].x());
+	const Vector4 oy(origins[0].y(), origins[1].y(), origins[2].y(), origins[3].y());
+	const Vector4 oz(origins[0].z(), origins[1].z(), origins[2].z(), origins[3].z());
+	const Vector4 idx(rays[0].idx.x(), rays[1].idx.x(), rays[2].idx.x(), rays[3].idx.x());
+	const Vector4 idy(rays[0].idy.x(), rays[1].idy.x(), rays[2].idy.x(), rays[3].idy.x());
+	const Vector4 idz(rays[0].idz.x(), rays[1].idz.x(), rays[2].idz.x(), rays[3].idz.x());
+
+	T_MATH_ALIGN16 float md[PacketSize];
+	for (uint32_t r = 0; r < PacketSize; ++r)
+		md[r] = maxDistances[r] > FUZZY_EPSILON ? maxDistances[r] : std::numeric_limits< float >::max();
+	const Vector4 farLimit = Vector4::loadAligned(md);
+
+	const uint32_t allMask = (1 << PacketSize) - 1;
+	uint32_t occluded = 0;
+
+	int32_t stack[c_maxStackSize];
+	int32_t sp = 0;
+	stack[sp++] = 0;
+
+	while (sp > 0 && occluded != allMask)
+	{
+		const Node& node = m_nodes[stack[--sp]];
+
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			if (node.child[i] < 0)
+				continue;
+
+			const Vector4 t0x = (Vector4(node.mnX.get(i)) - ox) * idx;
+			const Vector4 t1x = (Vector4(node.mxX.get(i)) - ox) * idx;
+			const Vector4 t0y = (Vector4(node.mnY.get(i)) - oy) * idy;
+			const Vector4 t1y = (Vector4(node.mxY.get(i)) - oy) * idy;
+			const Vector4 t0z = (Vector4(node.mnZ.get(i)) - oz) * idz;
+			const Vector4 t1z = (Vector4(node.mxZ.get(i)) - oz) * idz;
+
+			T_MATH_ALIGN16 float nearT[4];
+			T_MATH_ALIGN16 float farT[4];
+			max(max(min(t0x, t1x), min(t0y, t1y)), max(min(t0z, t1z), Vector4::zero())).storeAligned(nearT);
+			min(min(max(t0x, t1x), max(t0y, t1y)), min(max(t0z, t1z), farLimit)).storeAligned(farT);
+
+			uint32_t mask = 0;
+			for (uint32_t r = 0; r < PacketSize; ++r)
+				mask |= (nearT[r] <= farT[r]) ? (1 << r) : 0;
+			mask &= ~occluded;
+			if (!mask)
+				continue;
+
+			if (node.count[i] > 0)
+			{
+				for (uint32_t r = 0; r < PacketSize; ++r)
+				{
+					if ((mask & (1 << r)) == 0)
+						continue;
+					for (uint32_t j = 0; j < node.count[i]; ++j)
+					{
+						float t = md[r];
+						int32_t lane;
+						if (intersectPacket(m_packets[node.child[i] + j], rays[r], ignore, t, lane))
+						{
+							occluded |= 1 << r;
+							break;
+						}
+					}
+				}
+			}
+			else
+				stack[sp++] = node.child[i];
+		}
+	}
+
+	return occluded;
+}
+
+void TriangleBvh::intersectNode(const Node& node, const Ray& ray, float farT, float* outNear, float* outFar) const
+{
+	const Vector4 t0x = (node.mnX - ray.ox) * ray.idx;
+	const Vector4 t1x = (node.mxX - ray.ox) * ray.idx;
+	const Vector4 t0y = (node.mnY - ray.oy) * ray.idy;
+	const Vector4 t1y = (node.mxY - ray.oy) * ray.idy;
+	const Vector4 t0z = (node.mnZ - ray.oz) * ray.idz;
+	const Vector4 t1z = (node.mxZ - ray.oz) * ray.idz;
+
+	max(max(min(t0x, t1x), min(t0y, t1y)), max(min(t0z, t1z), Vector4::zero())).storeAligned(outNear);
+	min(min(max(t0x, t1x), max(t0y, t1y)), min(max(t0z, t1z), Vector4(Scalar(farT)))).storeAligned(outFar);
+}
+
+bool TriangleBvh::intersectPacket(const Packet& packet, const Ray& ray, int32_t ignore, float& inoutT, int32_t& outLane) const
+{
+	// Möller-Trumbore, four triangles at once.
+	const Vector4 px = ray.dy * packet.e2Z - ray.dz * packet.e2Y;
+	const Vector4 py = ray.dz * packet.e2X - ray.dx * packet.e2Z;
+	const Vector4 pz = ray.dx * packet.e2Y - ray.dy * packet.e2X;
+	const Vector4 det = packet.e1X * px + packet.e1Y * py + packet.e1Z * pz;
+
+	const Vector4 tx = ray.ox - packet.v0X;
+	const Vector4 ty = ray.oy - packet.v0Y;
+	const Vector4 tz = ray.oz - packet.v0Z;
+
+	const Vector4 qx = ty * packet.e1Z - tz * packet.e1Y;
+	const Vector4 qy = tz * packet.e1X - tx * packet.e1Z;
+	const Vector4 qz = tx * packet.e1Y - ty * packet.e1X;
+
+	T_MATH_ALIGN16 float d[4], u[4], v[4], t[4];
+	det.storeAligned(d);
+	(tx * px + ty * py + tz * pz).storeAligned(u);
+	(ray.dx * qx + ray.dy * qy + ray.dz * qz).storeAligned(v);
+	(packet.e2X * qx + packet.e2Y * qy + packet.e2Z * qz).storeAligned(t);
+
+	bool hit = false;
+	for (int32_t i = 0; i < 4; ++i)
+	{
+		if (std::abs(d[i]) <= 1e-12f)
+			continue;
+
+		const float invDet = 1.0f / d[i];
+		const float uu = u[i] * invDet;
+		const float vv = v[i] * invDet;
+		const float tt = t[i] * invDet;
+		if (uu < 0.0f || vv < 0.0f || uu + vv > 1.0f || tt <= 0.0f || tt >= inoutT)
+			continue;
+
+		if (packet.polygon[i] == ignore)
+			continue;
+
+		inoutT = tt;
+		outLane = i;
+		hit = true;
+	}
+	return hit;
+}
+
+}
@@ -0,0 +1,148 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Aabb3.h"
+#include "Core/Math/Winding3.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_CORE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+/*! Bounding volume hierarchy of triangles.
+ *
+ * Flattened BVH with four children per node; child bounds
+ * and triangles are stored as structure of arrays so a ray is
+ * tested against four boxes, or four triangles, at once.
+ * Tree is built using binned "surface area heuristic" and large
+ * trees are built in parallel.
+ *
+ * Polygons are triangulated internally, query results refer
+ * to the polygon index thus it can be used as a replacement
+ * of SahTree.
+ *
+ * \ingroup Core
+ */
+class T_DLLCLASS TriangleBvh : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	enum { PacketSize = 4 };
+
+	struct QueryResult
+	{
+		int32_t index = -1;
+		Scalar distance = 0.0_simd;
+		Vector4 position;
+		Vector4 normal;
+	};
+
+	/*! Build tree from a set of polygons.
+	 *
+	 * \param polygons Polygon set.
+	 */
+	void build(const AlignedVector< Winding3 >& polygons);
+
+	/*! Query for closest intersection.
+	 *
+	 * \param origin Ray origin.
+	 * \param direction Ray direction.
+	 * \param maxDistance Intersection must occur prior to this distance from origin, 0 distance is infinite.
+	 * \param ignore Ignore intersection with polygon.
+	 * \param outResult Intersection result.
+	 * \return True if any intersection found.
+	 */
+	bool queryClosestIntersection(const Vector4& origin, const Vector4& direction, float maxDistance, int32_t ignore, QueryResult& outResult) const;
+
+	/*! Query for any intersection.
+	 *
+	 * \param origin Ray origin.
+	 * \param direction Ray direction.
+	 * \param maxDistance Intersection must occur prior to this distance from origin, 0 distance is infinite.
+	 * \param ignore Ignore intersection with polygon.
+	 * \return True if any intersection found.
+	 */
+	bool queryAnyIntersection(const Vector4& origin, const Vector4& direction, float maxDistance, int32_t ignore) const;
+
+	/*! Query for closest intersection of a packet of rays.
+	 *
+	 * Rays are traversed together, thus packet should
+	 * contain coherent rays.
+	 *
+	 * \param origins Ray origins, PacketSize number of rays.
+	 * \param directions Ray directions.
+	 * \param maxDistances Per ray max distance, 0 distance is infinite.
+	 * \param ignore Ignore intersection with polygon.
+	 * \param outResults Intersection results.
+	 * \return Mask of rays which intersect, bit N set if ray N intersect.
+	 */
+	uint32_t queryClosestIntersection(const Vector4* origins, const Vector4* directions, const float* maxDistances, int32_t ignore, QueryResult* outResults) const;
+
+	/*! Query for any intersection of a packet of rays.
+	 *
+	 * Traversal terminates as soon as all rays are occluded,
+	 * suitable for shadow rays.
+	 *
+	 * \param origins Ray origins, PacketSize number of rays.
+	 * \param directions Ray directions.
+	 * \param maxDistances Per ray max distance, 0 distance is infinite.
+	 * \param ignore Ignore intersection with polygon.
+	 * \return Mask of rays which intersect, bit N set if ray N intersect.
+	 */
+	uint32_t queryAnyIntersection(const Vector4* origins, const Vector4* directions, const float* maxDistances, int32_t ignore) const;
+
+	/*! Get number of triangles. */
+	uint32_t getTriangleCount() const { return m_triangleCount; }
+
+	/*! Get bounding box. */
+	const Aabb3& getBoundingBox() const { return m_boundingBox; }
+
+private:
+	class Builder;
+	struct Ray;
+
+	/*! Four children; a child is a leaf if count is non-zero, empty if child is negative. */
+	struct Node
+	{
+		Vector4 mnX, mnY, mnZ;
+		Vector4 mxX, mxY, mxZ;
+		int32_t child[4];		//!< Child node, or first packet if leaf.
+		uint32_t count[4];		//!< Number of packets in leaf.
+	};
+
+	/*! Four triangles, vertex and edges. */
+	struct Packet
+	{
+		Vector4 v0X, v0Y, v0Z;
+		Vector4 e1X, e1Y, e1Z;
+		Vector4 e2X, e2Y, e2Z;
+		int32_t polygon[4];
+	};
+
+	AlignedVector< Node > m_nodes;
+	AlignedVector< Packet > m_packets;
+	Aabb3 m_boundingBox;
+	uint32_t m_triangleCount = 0;
+
+	void intersectNode(const Node& node, const Ray& ray, float farT, float* outNear, float* outFar) const;
+
+	bool intersectPacket(const Packet& packet, const Ray& ray, int32_t ignore, float& inoutT, int32_t& outLane) const;
+};
+
+}
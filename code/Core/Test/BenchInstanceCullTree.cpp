@@ -0,0 +1,96 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Test/BenchInstanceCullTree.h"
+
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Math/InstanceCullTree.h"
+#include "Core/Math/Random.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::test
+{
+namespace
+{
+
+const float c_radius = 4.0f;
+const float c_lodDistances[] = { 100.0f, 300.0f, 1000.0f };
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.BenchInstanceCullTree", 0, BenchInstanceCullTree, Benchmark)
+
+void BenchInstanceCullTree::run()
+{
+	Random random;
+
+	// Scatter instances over a 4 by 4 km area.
+	const uint32_t instanceCount = 1000000;
+	AlignedVector< Vector4 > positions(instanceCount);
+	for (auto& position : positions)
+		position = Vector4(
+			(random.nextFloat() * 2.0f - 1.0f) * 2000.0f,
+			random.nextFloat() * 40.0f,
+			(random.nextFloat() * 2.0f - 1.0f) * 2000.0f,
+			1.0f
+		);
+
+	Timer timer;
+	Ref< InstanceCullTree > tree = new InstanceCullTree();
+	tree->build(positions, Scalar(c_radius));
+	log::info << L"Instance cull tree, built " << instanceCount << L" instances in " << int32_t(timer.getDeltaTime() * 1000.0) << L" ms" << Endl;
+
+	Frustum viewFrustum;
+	viewFrustum.buildPerspective(deg2rad(70.0f), 16.0f / 9.0f, 0.1f, 2000.0f);
+
+	// Measure culling from a camera moving across area.
+	const int32_t frames = 100;
+	const Vector4 up(0.0f, 1.0f, 0.0f, 0.0f);
+	InstanceCullTree::CullResult result;
+	double bruteTime = 0.0;
+	double treeTime = 0.0;
+	double cachedTime = 0.0;
+	uint32_t visibleCount = 0;
+	for (int32_t frame = 0; frame < frames; ++frame)
+	{
+		const Vector4 eye(-1000.0f + frame * 20.0f, 20.0f, -500.0f + frame * 10.0f, 1.0f);
+		const Matrix44 view = lookAt(eye, eye + Vector4(1.0f, -0.05f, 0.3f, 0.0f), up);
+
+		// Cull each instance as ForestComponent used to.
+		timer.getDeltaTime();
+		AlignedVector< uint32_t > bruteIndices[3];
+		for (uint32_t i = 0; i < instanceCount; ++i)
+		{
+			const Vector4 center = view * positions[i].xyz1();
+			if (viewFrustum.inside(center, Scalar(c_radius)) == Frustum::Result::Outside)
+				continue;
+			const float distance = center.z() + c_radius;
+			if (distance < c_lodDistances[0])
+				bruteIndices[0].push_back(i);
+			else if (distance < c_lodDistances[1])
+				bruteIndices[1].push_back(i);
+			else if (distance < c_lodDistances[2])
+				bruteIndices[2].push_back(i);
+		}
+		bruteTime += timer.getDeltaTime();
+
+		tree->cull(view, viewFrustum, c_lodDistances, 3, result);
+		treeTime += timer.getDeltaTime();
+
+		tree->cull(view, viewFrustum, c_lodDistances, 3, result);
+		cachedTime += timer.getDeltaTime();
+
+		visibleCount += (uint32_t)(result.lodIndices[0].size() + result.lodIndices[1].size() + result.lodIndices[2].size());
+	}
+
+	log::info << L"Instance cull tree, " << instanceCount << L" instances, " << visibleCount / frames << L" visible on average" << Endl;
+	log::info << L"  per instance " << bruteTime * 1000.0 / frames << L" ms, tree " << treeTime * 1000.0 / frames << L" ms, cached " << cachedTime * 1000.0 / frames << L" ms per view" << Endl;
+}
+
+}
@@ -0,0 +1,162 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Test/BenchTriangleBvh.h"
+
+#include "Core/Log/Log.h"
+#include "Core/Math/Random.h"
+#include "Core/Math/SahTree.h"
+#include "Core/Math/TriangleBvh.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::test
+{
+namespace
+{
+
+/*! Scatter boxes over a ground plane, each box face is a quad. */
+void createScene(Random& random, uint32_t boxCount, AlignedVector< Winding3 >& outPolygons)
+{
+	const Vector4 ground[] =
+	{
+		Vector4(-100.0f, 0.0f, -100.0f, 1.0f),
+		Vector4(-100.0f, 0.0f, 100.0f, 1.0f),
+		Vector4(100.0f, 0.0f, 100.0f, 1.0f),
+		Vector4(100.0f, 0.0f, -100.0f, 1.0f)
+	};
+	outPolygons.push_back(Winding3(ground, 4));
+
+	for (uint32_t i = 0; i < boxCount; ++i)
+	{
+		const Vector4 center((random.nextFloat() * 2.0f - 1.0f) * 100.0f, random.nextFloat() * 20.0f, (random.nextFloat() * 2.0f - 1.0f) * 100.0f, 1.0f);
+		const Vector4 extent(0.2f + random.nextFloat(), 0.2f + random.nextFloat(), 0.2f + random.nextFloat(), 0.0f);
+
+		Vector4 corners[8];
+		for (int32_t j = 0; j < 8; ++j)
+			corners[j] = center + extent * Vector4((j & 1) ? 1.0f : -1.0f, (j & 2) ? 1.0f : -1.0f, (j & 4) ? 1.0f : -1.0f, 0.0f);
+
+		const int32_t faces[6][4] = { { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 } };
+		for (const auto& face : faces)
+		{
+			const Vector4 points[] = { corners[face[0]], corners[face[1]], corners[face[2]], corners[face[3]] };
+			outPolygons.push_back(Winding3(points, 4));
+		}
+	}
+}
+
+/*! Generate packets of rays, rays in a packet share origin and point in similar directions. */
+void createRays(Random& random, uint32_t packetCount, AlignedVector< Vector4 >& outOrigins, AlignedVector< Vector4 >& outDirections)
+{
+	outOrigins.resize(packetCount * TriangleBvh::PacketSize);
+	outDirections.resize(packetCount * TriangleBvh::PacketSize);
+	for (uint32_t i = 0; i < packetCount; ++i)
+	{
+		const Vector4 origin((random.nextFloat() * 2.0f - 1.0f) * 90.0f, 1.0f + random.nextFloat() * 10.0f, (random.nextFloat() * 2.0f - 1.0f) * 90.0f, 1.0f);
+		const Vector4 direction(random.nextFloat() * 2.0f - 1.0f, random.nextFloat() * 2.0f - 1.0f, random.nextFloat() * 2.0f - 1.0f, 0.0f);
+		for (uint32_t j = 0; j < TriangleBvh::PacketSize; ++j)
+		{
+			const Vector4 jitter(random.nextFloat() - 0.5f, random.nextFloat() - 0.5f, random.nextFloat() - 0.5f, 0.0f);
+			outOrigins[i * TriangleBvh::PacketSize + j] = origin;
+			outDirections[i * TriangleBvh::PacketSize + j] = (direction + jitter * 0.1_simd).normalized();
+		}
+	}
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.BenchTriangleBvh", 0, BenchTriangleBvh, Benchmark)
+
+void BenchTriangleBvh::run()
+{
+	Random random;
+	Timer timer;
+
+	// Small scene; compare with SahTree.
+	{
+		AlignedVector< Winding3 > polygons;
+		createScene(random, 500, polygons);
+
+		SahTree sah;
+		sah.build(polygons);
+
+		Ref< TriangleBvh > bvh = new TriangleBvh();
+		bvh->build(polygons);
+
+		const uint32_t packetCount = 10000;
+		AlignedVector< Vector4 > origins, directions;
+		createRays(random, packetCount, origins, directions);
+
+		SahTree::QueryCache cache;
+
+		// Measure same scene with both trees.
+		timer.getDeltaTime();
+		for (uint32_t i = 0; i < packetCount * TriangleBvh::PacketSize; ++i)
+		{
+			SahTree::QueryResult sahResult;
+			sah.queryClosestIntersection(origins[i], directions[i], 0.0f, -1, sahResult, cache);
+		}
+		const double sahTime = timer.getDeltaTime();
+		for (uint32_t i = 0; i < packetCount * TriangleBvh::PacketSize; ++i)
+		{
+			TriangleBvh::QueryResult result;
+			bvh->queryClosestIntersection(origins[i], directions[i], 0.0f, -1, result);
+		}
+		const double bvhTime = timer.getDeltaTime();
+
+		const double rayCount = packetCount * TriangleBvh::PacketSize;
+		log::info << L"Triangle BVH, " << bvh->getTriangleCount() << L" triangles; SahTree " << rayCount / (sahTime * 1e6) << L" Mrays/s, BVH " << rayCount / (bvhTime * 1e6) << L" Mrays/s" << Endl;
+	}
+
+	// Large scene; measure build and tracing.
+	{
+		AlignedVector< Winding3 > polygons;
+		createScene(random, 100000, polygons);
+
+		timer.getDeltaTime();
+		Ref< TriangleBvh > bvh = new TriangleBvh();
+		bvh->build(polygons);
+		const double buildTime = timer.getDeltaTime();
+
+		const uint32_t packetCount = 250000;
+		AlignedVector< Vector4 > origins, directions;
+		createRays(random, packetCount, origins, directions);
+
+		const float maxDistances[TriangleBvh::PacketSize] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		const float shortDistances[TriangleBvh::PacketSize] = { 5.0f, 5.0f, 5.0f, 5.0f };
+		const uint32_t rayCount = packetCount * TriangleBvh::PacketSize;
+
+		timer.getDeltaTime();
+		for (uint32_t i = 0; i < rayCount; ++i)
+		{
+			TriangleBvh::QueryResult result;
+			bvh->queryClosestIntersection(origins[i], directions[i], 0.0f, -1, result);
+		}
+		const double singleTime = timer.getDeltaTime();
+
+		for (uint32_t i = 0; i < rayCount; i += TriangleBvh::PacketSize)
+		{
+			TriangleBvh::QueryResult results[TriangleBvh::PacketSize];
+			bvh->queryClosestIntersection(&origins[i], &directions[i], maxDistances, -1, results);
+		}
+		const double packetTime = timer.getDeltaTime();
+
+		for (uint32_t i = 0; i < rayCount; ++i)
+			bvh->queryAnyIntersection(origins[i], directions[i], shortDistances[0], -1);
+		const double singleAnyTime = timer.getDeltaTime();
+
+		for (uint32_t i = 0; i < rayCount; i += TriangleBvh::PacketSize)
+			bvh->queryAnyIntersection(&origins[i], &directions[i], shortDistances, -1);
+		const double packetAnyTime = timer.getDeltaTime();
+
+		log::info << L"Triangle BVH, built " << bvh->getTriangleCount() << L" triangles in " << int32_t(buildTime * 1000.0) << L" ms" << Endl;
+		log::info << L"  closest " << rayCount / (singleTime * 1e6) << L" Mrays/s, packet " << rayCount / (packetTime * 1e6) << L" Mrays/s" << Endl;
+		log::info << L"  any " << rayCount / (singleAnyTime * 1e6) << L" Mrays/s, packet " << rayCount / (packetAnyTime * 1e6) << L" Mrays/s" << Endl;
+	}
+}
+
+}
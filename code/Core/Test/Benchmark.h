@@ -0,0 +1,39 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_CORE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::test
+{
+
+/*! Benchmark.
+ * \ingroup Core
+ *
+ * Benchmarks are not part of unit test suite since they
+ * take too long; they are run separately and only log
+ * their measurements.
+ */
+class T_DLLCLASS Benchmark : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual void run() = 0;
+};
+
+}
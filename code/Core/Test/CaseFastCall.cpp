@@ -0,0 +1,183 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Core/Class/AutoRuntimeClass.h"
+#include "Core/Class/FastCall.h"
+#include "Core/Log/Log.h"
+#include "Core/Test/CaseFastCall.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::test
+{
+
+class FastCall_Target : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	int32_t none() { return ++m_calls; }
+
+	int32_t integer(int32_t a) { return a + 1; }
+
+	float number2(float a, float b) const { return a * b; }
+
+	float number4(float a, float b, float c, double d) const { return a + b + c + float(d); }
+
+	bool object(const FastCall_Target* other) const { return other == this; }
+
+	int32_t reference(Ref< FastCall_Target > other) { return other ? other->m_calls : -1; }
+
+	float mixed(bool a, int32_t b, float c, FastCall_Target* d) { return a ? float(b) * c : -c; }
+
+	static double staticNumber(double a) { return a * 2.0; }
+
+	std::wstring string(const std::wstring& s) { return s; }
+
+private:
+	int32_t m_calls = 0;
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseFastCall.FastCall_Target", FastCall_Target, Object)
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseFastCall", 0, CaseFastCall, Case)
+
+	namespace
+	{
+
+const int32_t c_iterations = 1000000;
+
+const IRuntimeDispatch* findMethod(const IRuntimeClass* runtimeClass, const char* name)
+{
+	for (uint32_t i = 0; i < runtimeClass->getMethodCount(); ++i)
+	{
+		if (runtimeClass->getMethodName(i) == name)
+			return runtimeClass->getMethodDispatch(i);
+	}
+	return nullptr;
+}
+
+/*! Measure per-call time, in nanoseconds, using Any marshalling and fast call. */
+void measure(const wchar_t* signature, const IRuntimeDispatch* dispatch, ITypedObject* self, uint32_t argc, const Any* argv, const FastCallValue* fargv, double& outAnyTime, double& outFastTime)
+{
+	const FastCall* fastCall = dispatch->getFastCall();
+
+	Timer timer;
+	double start = timer.getElapsedTime();
+	for (int32_t i = 0; i < c_iterations; ++i)
+	{
+		// Copy arguments as script bindings convert from stack each call.
+		Any args[FastCall::MaxArguments];
+		for (uint32_t j = 0; j < argc; ++j)
+			args[j] = argv[j];
+		dispatch->invoke(self, argc, args);
+	}
+	outAnyTime = (timer.getElapsedTime() - start) * 1e9 / c_iterations;
+
+	start = timer.getElapsedTime();
+	for (int32_t i = 0; i < c_iterations; ++i)
+	{
+		FastCallValue args[FastCall::MaxArguments];
+		for (uint32_t j = 0; j < argc; ++j)
+			args[j] = fargv[j];
+		fastCall->function(dispatch, self, args);
+	}
+	outFastTime = (timer.getElapsedTime() - start) * 1e9 / c_iterations;
+
+	log::info << L"Fast call, " << signature << L"; " << outAnyTime << L" ns (any), " << outFastTime << L" ns (fast), " << outAnyTime / std::max(outFastTime, 1e-3) << L"x" << Endl;
+}
+
+	}
+
+void CaseFastCall::run()
+{
+	Ref< AutoRuntimeClass< FastCall_Target > > runtimeClass = new AutoRuntimeClass< FastCall_Target >();
+	runtimeClass->addMethod("none", &FastCall_Target::none);
+	runtimeClass->addMethod("integer", &FastCall_Target::integer);
+	runtimeClass->addMethod("number2", &FastCall_Target::number2);
+	runtimeClass->addMethod("number4", &FastCall_Target::number4);
+	runtimeClass->addMethod("object", &FastCall_Target::object);
+	runtimeClass->addMethod("reference", &FastCall_Target::reference);
+	runtimeClass->addMethod("mixed", &FastCall_Target::mixed);
+	runtimeClass->addMethod("string", &FastCall_Target::string);
+	runtimeClass->addStaticMethod("staticNumber", &FastCall_Target::staticNumber);
+
+	Ref< FastCall_Target > target = new FastCall_Target();
+	Ref< FastCall_Target > other = new FastCall_Target();
+
+	// Descriptors must match signatures; unsupported argument types has no fast call.
+	const FastCall* fastCall = findMethod(runtimeClass, "mixed")->getFastCall();
+	CASE_ASSERT(fastCall != nullptr);
+	if (fastCall)
+	{
+		CASE_ASSERT_EQUAL(fastCall->argc, 4);
+		CASE_ASSERT(fastCall->argumentTypes[0] == FastCallType::Boolean);
+		CASE_ASSERT(fastCall->argumentTypes[1] == FastCallType::Integer);
+		CASE_ASSERT(fastCall->argumentTypes[2] == FastCallType::Number);
+		CASE_ASSERT(fastCall->argumentTypes[3] == FastCallType::Object);
+		CASE_ASSERT(fastCall->objectTypes[3] == &type_of< FastCall_Target >());
+	}
+	CASE_ASSERT(findMethod(runtimeClass, "reference")->getFastCall()->argumentTypes[0] == FastCallType::Reference);
+	CASE_ASSERT(findMethod(runtimeClass, "string")->getFastCall() == nullptr);
+	CASE_ASSERT(runtimeClass->getStaticMethodDispatch(0)->getFastCall() != nullptr);
+
+	// Results must be identical through both paths.
+	{
+		FastCallValue fargv[4];
+		fargv[0].b = true;
+		fargv[1].i = 3;
+		fargv[2].n = 2.5;
+		fargv[3].o = other;
+		const Any argv[] = { Any::fromBoolean(true), Any::fromInt32(3), Any::fromFloat(2.5f), Any::fromObject(other) };
+
+		const IRuntimeDispatch* mixed = findMethod(runtimeClass, "mixed");
+		CASE_ASSERT_EQUAL(mixed->getFastCall()->function(mixed, target, fargv).getFloat(), mixed->invoke(target, 4, argv).getFloat());
+
+		const IRuntimeDispatch* object = findMethod(runtimeClass, "object");
+		fargv[0].o = target;
+		CASE_ASSERT(object->getFastCall()->function(object, target, fargv).getBoolean());
+
+		const IRuntimeDispatch* staticNumber = runtimeClass->getStaticMethodDispatch(0);
+		fargv[0].n = 4.0;
+		CASE_ASSERT_EQUAL(staticNumber->getFastCall()->function(staticNumber, nullptr, fargv).getDouble(), 8.0);
+	}
+
+	// Measure per-call overhead across argument counts and types.
+	{
+		double anyTime, fastTime;
+		FastCallValue fargv[4];
+		Any argv[4];
+
+		measure(L"none()", findMethod(runtimeClass, "none"), target, 0, argv, fargv, anyTime, fastTime);
+
+		fargv[0].i = 1; argv[0] = Any::fromInt32(1);
+		measure(L"integer(int32_t)", findMethod(runtimeClass, "integer"), target, 1, argv, fargv, anyTime, fastTime);
+
+		fargv[0].n = 1.0; argv[0] = Any::fromFloat(1.0f);
+		fargv[1].n = 2.0; argv[1] = Any::fromFloat(2.0f);
+		measure(L"number2(float, float)", findMethod(runtimeClass, "number2"), target, 2, argv, fargv, anyTime, fastTime);
+
+		fargv[2].n = 3.0; argv[2] = Any::fromFloat(3.0f);
+		fargv[3].n = 4.0; argv[3] = Any::fromDouble(4.0);
+		measure(L"number4(float, float, float, double)", findMethod(runtimeClass, "number4"), target, 4, argv, fargv, anyTime, fastTime);
+
+		fargv[0].o = other; argv[0] = Any::fromObject(other);
+		measure(L"object(const FastCall_Target*)", findMethod(runtimeClass, "object"), target, 1, argv, fargv, anyTime, fastTime);
+		measure(L"reference(Ref< FastCall_Target >)", findMethod(runtimeClass, "reference"), target, 1, argv, fargv, anyTime, fastTime);
+
+		fargv[0].b = true; argv[0] = Any::fromBoolean(true);
+		fargv[1].i = 2; argv[1] = Any::fromInt32(2);
+		fargv[2].n = 3.0; argv[2] = Any::fromFloat(3.0f);
+		fargv[3].o = other; argv[3] = Any::fromObject(other);
+		measure(L"mixed(bool, int32_t, float, FastCall_Target*)", findMethod(runtimeClass, "mixed"), target, 4, argv, fargv, anyTime, fastTime);
+	}
+
+	CASE_ASSERT_EQUAL(other->getReferenceCount(), 1);
+}
+
+}
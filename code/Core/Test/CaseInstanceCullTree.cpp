@@ -0,0 +1,120 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Test/CaseInstanceCullTree.h"
+
+#include "Core/Math/Const.h"
+#include "Core/Math/InstanceCullTree.h"
+#include "Core/Math/Random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace traktor::test
+{
+namespace
+{
+
+const float c_radius = 4.0f;
+const float c_lodDistances[] = { 100.0f, 300.0f, 1000.0f };
+
+/*! Cull each instance individually, lod is -1 if culled and -2 if too close to a boundary to be conclusive. */
+void cullBruteForce(const AlignedVector< Vector4 >& positions, const Matrix44& view, const Frustum& viewFrustum, AlignedVector< int32_t >& outLods)
+{
+	outLods.resize(positions.size());
+	for (uint32_t i = 0; i < positions.size(); ++i)
+	{
+		const Vector4 center = view * positions[i].xyz1();
+
+		float mn = std::numeric_limits< float >::max();
+		for (const auto& plane : viewFrustum.planes)
+			mn = std::min< float >(mn, plane.distance(center) + c_radius);
+
+		const float distance = center.z() + c_radius;
+		int32_t lod = 0;
+		while (lod < 3 && distance >= c_lodDistances[lod])
+			++lod;
+
+		bool ambiguous = std::abs(mn) < 1e-2f;
+		for (int32_t j = 0; j < 3; ++j)
+			ambiguous |= std::abs(distance - c_lodDistances[j]) < 1e-2f;
+
+		if (ambiguous)
+			outLods[i] = -2;
+		else if (mn < 0.0f || lod >= 3)
+			outLods[i] = -1;
+		else
+			outLods[i] = lod;
+	}
+}
+
+bool compareResult(const AlignedVector< int32_t >& lods, const InstanceCullTree::CullResult& result)
+{
+	AlignedVector< int32_t > treeLods(lods.size(), -1);
+	for (int32_t lod = 0; lod < 3; ++lod)
+	{
+		for (auto index : result.lodIndices[lod])
+		{
+			if (treeLods[index] != -1)
+				return false;
+			treeLods[index] = lod;
+		}
+	}
+	for (uint32_t i = 0; i < lods.size(); ++i)
+	{
+		if (lods[i] != -2 && lods[i] != treeLods[i])
+			return false;
+	}
+	return true;
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseInstanceCullTree", 0, CaseInstanceCullTree, Case)
+
+void CaseInstanceCullTree::run()
+{
+	Random random;
+
+	// Scatter instances over a 2 by 2 km area.
+	const uint32_t instanceCount = 4000;
+	AlignedVector< Vector4 > positions(instanceCount);
+	for (auto& position : positions)
+		position = Vector4(
+			(random.nextFloat() * 2.0f - 1.0f) * 1000.0f,
+			random.nextFloat() * 40.0f,
+			(random.nextFloat() * 2.0f - 1.0f) * 1000.0f,
+			1.0f
+		);
+
+	Ref< InstanceCullTree > tree = new InstanceCullTree();
+	tree->build(positions, Scalar(c_radius));
+
+	Frustum viewFrustum;
+	viewFrustum.buildPerspective(deg2rad(70.0f), 16.0f / 9.0f, 0.1f, 2000.0f);
+
+	// Result must match culling each instance individually, from a number of views.
+	InstanceCullTree::CullResult result;
+	AlignedVector< int32_t > lods;
+	for (int32_t i = 0; i < 8; ++i)
+	{
+		const float a = i * TWO_PI / 8.0f;
+		const Vector4 eye((random.nextFloat() * 2.0f - 1.0f) * 500.0f, 20.0f, (random.nextFloat() * 2.0f - 1.0f) * 500.0f, 1.0f);
+		const Matrix44 view = lookAt(eye, eye + Vector4(std::cos(a), -0.1f * i, std::sin(a), 0.0f));
+
+		CASE_ASSERT(tree->cull(view, viewFrustum, c_lodDistances, 3, result));
+		cullBruteForce(positions, view, viewFrustum, lods);
+		CASE_ASSERT(compareResult(lods, result));
+
+		// Same view again should reuse cached result.
+		CASE_ASSERT(!tree->cull(view, viewFrustum, c_lodDistances, 3, result));
+	}
+}
+
+}
@@ -7,7 +7,11 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include <cmath>
+#include "Core/System/OS.h"
 #include "Core/Thread/JobManager.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
 #include "Core/Test/CaseJob.h"
 
 namespace traktor::test
@@ -78,6 +82,81 @@ void CaseJob::run()
 			correct &= (g_counts[i] == 1);
 		CASE_ASSERT(correct);
 	}
+
+	// Fork from within forked jobs.
+	{
+		g_job = 0;
+		g_active = 0;
+
+		Job::task_t jobs[10];
+		for (int32_t i = 0; i < 10; ++i)
+		{
+			jobs[i] = [=]() {
+				Job::task_t innerJobs[100];
+				for (int32_t j = 0; j < 100; ++j)
+				{
+					g_counts[i * 100 + j] = 0;
+					innerJobs[j] = [=](){ jobTask(i * 100 + j); };
+				}
+				JobManager::getInstance().fork(innerJobs, sizeof_array(innerJobs));
+			};
+		}
+
+		JobManager::getInstance().fork(jobs, sizeof_array(jobs));
+
+		CASE_ASSERT_EQUAL((int32_t)g_active, 0);
+		CASE_ASSERT_EQUAL((int32_t)g_job, 1000);
+
+		bool correct = true;
+		for (int32_t i = 0; i < 1000; ++i)
+			correct &= (g_counts[i] == 1);
+		CASE_ASSERT(correct);
+	}
+
+	// Fork while all workers are busy with unrelated jobs; forked jobs
+	// must still finish and unrelated jobs must not run on forking thread.
+	{
+		g_job = 0;
+		g_active = 0;
+
+		Thread* forkThread = ThreadManager::getInstance().getCurrentThread();
+		std::atomic< bool > release = false;
+		std::atomic< int32_t > unrelatedOnForkThread = 0;
+
+		// One more than number of workers so at least one is left in queue.
+		const int32_t unrelatedCount = OS::getInstance().getCPUCoreCount() + 1;
+		for (int32_t i = 0; i < unrelatedCount; ++i)
+		{
+			JobManager::getInstance().add([&]() {
+				if (ThreadManager::getInstance().getCurrentThread() == forkThread)
+					unrelatedOnForkThread++;
+
+				// Block worker until fork is finished, time out in case fork
+				// is waiting for us.
+				Timer timer;
+				while (!release && timer.getElapsedTime() < 5.0)
+					ThreadManager::getInstance().getCurrentThread()->yield();
+			});
+		}
+
+		Job::task_t jobs[100];
+		for (int32_t i = 0; i < 100; ++i)
+		{
+			g_counts[i] = 0;
+			jobs[i] = [=](){ jobTask(i); };
+		}
+
+		Timer timer;
+		JobManager::getInstance().fork(jobs, sizeof_array(jobs));
+		const double forkDuration = timer.getElapsedTime();
+
+		release = true;
+		JobManager::getInstance().wait();
+
+		CASE_ASSERT_EQUAL((int32_t)g_job, 100);
+		CASE_ASSERT_EQUAL((int32_t)unrelatedOnForkThread, 0);
+		CASE_ASSERT(forkDuration < 1.0);
+	}
 }
 
 }
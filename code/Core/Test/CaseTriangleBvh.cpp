@@ -0,0 +1,148 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Test/CaseTriangleBvh.h"
+
+#include "Core/Log/Log.h"
+#include "Core/Math/Random.h"
+#include "Core/Math/SahTree.h"
+#include "Core/Math/TriangleBvh.h"
+
+#include <cmath>
+
+namespace traktor::test
+{
+namespace
+{
+
+/*! Scatter boxes over a ground plane, each box face is a quad. */
+void createScene(Random& random, uint32_t boxCount, AlignedVector< Winding3 >& outPolygons)
+{
+	const Vector4 ground[] =
+	{
+		Vector4(-100.0f, 0.0f, -100.0f, 1.0f),
+		Vector4(-100.0f, 0.0f, 100.0f, 1.0f),
+		Vector4(100.0f, 0.0f, 100.0f, 1.0f),
+		Vector4(100.0f, 0.0f, -100.0f, 1.0f)
+	};
+	outPolygons.push_back(Winding3(ground, 4));
+
+	for (uint32_t i = 0; i < boxCount; ++i)
+	{
+		const Vector4 center((random.nextFloat() * 2.0f - 1.0f) * 100.0f, random.nextFloat() * 20.0f, (random.nextFloat() * 2.0f - 1.0f) * 100.0f, 1.0f);
+		const Vector4 extent(0.2f + random.nextFloat(), 0.2f + random.nextFloat(), 0.2f + random.nextFloat(), 0.0f);
+
+		Vector4 corners[8];
+		for (int32_t j = 0; j < 8; ++j)
+			corners[j] = center + extent * Vector4((j & 1) ? 1.0f : -1.0f, (j & 2) ? 1.0f : -1.0f, (j & 4) ? 1.0f : -1.0f, 0.0f);
+
+		const int32_t faces[6][4] = { { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 } };
+		for (const auto& face : faces)
+		{
+			const Vector4 points[] = { corners[face[0]], corners[face[1]], corners[face[2]], corners[face[3]] };
+			outPolygons.push_back(Winding3(points, 4));
+		}
+	}
+}
+
+/*! Generate packets of rays, rays in a packet share origin and point in similar directions. */
+void createRays(Random& random, uint32_t packetCount, AlignedVector< Vector4 >& outOrigins, AlignedVector< Vector4 >& outDirections)
+{
+	outOrigins.resize(packetCount * TriangleBvh::PacketSize);
+	outDirections.resize(packetCount * TriangleBvh::PacketSize);
+	for (uint32_t i = 0; i < packetCount; ++i)
+	{
+		const Vector4 origin((random.nextFloat() * 2.0f - 1.0f) * 90.0f, 1.0f + random.nextFloat() * 10.0f, (random.nextFloat() * 2.0f - 1.0f) * 90.0f, 1.0f);
+		const Vector4 direction(random.nextFloat() * 2.0f - 1.0f, random.nextFloat() * 2.0f - 1.0f, random.nextFloat() * 2.0f - 1.0f, 0.0f);
+		for (uint32_t j = 0; j < TriangleBvh::PacketSize; ++j)
+		{
+			const Vector4 jitter(random.nextFloat() - 0.5f, random.nextFloat() - 0.5f, random.nextFloat() - 0.5f, 0.0f);
+			outOrigins[i * TriangleBvh::PacketSize + j] = origin;
+			outDirections[i * TriangleBvh::PacketSize + j] = (direction + jitter * 0.1_simd).normalized();
+		}
+	}
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseTriangleBvh", 0, CaseTriangleBvh, Case)
+
+void CaseTriangleBvh::run()
+{
+	Random random;
+
+	// Small scene; result must match SahTree.
+	{
+		AlignedVector< Winding3 > polygons;
+		createScene(random, 500, polygons);
+
+		SahTree sah;
+		sah.build(polygons);
+
+		Ref< TriangleBvh > bvh = new TriangleBvh();
+		bvh->build(polygons);
+		CASE_ASSERT(bvh->getTriangleCount() == polygons.size() * 2);
+
+		const uint32_t packetCount = 10000;
+		AlignedVector< Vector4 > origins, directions;
+		createRays(random, packetCount, origins, directions);
+
+		const float maxDistances[TriangleBvh::PacketSize] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		const float shortDistances[TriangleBvh::PacketSize] = { 5.0f, 5.0f, 5.0f, 5.0f };
+
+		SahTree::QueryCache cache;
+		uint32_t hitCount = 0;
+		uint32_t mismatchCount = 0;
+		for (uint32_t i = 0; i < packetCount * TriangleBvh::PacketSize; i += TriangleBvh::PacketSize)
+		{
+			TriangleBvh::QueryResult packetResults[TriangleBvh::PacketSize];
+			const uint32_t closestMask = bvh->queryClosestIntersection(&origins[i], &directions[i], maxDistances, -1, packetResults);
+			const uint32_t anyMask = bvh->queryAnyIntersection(&origins[i], &directions[i], shortDistances, -1);
+
+			for (uint32_t j = 0; j < TriangleBvh::PacketSize; ++j)
+			{
+				SahTree::QueryResult sahResult;
+				TriangleBvh::QueryResult result;
+				const bool sahHit = sah.queryClosestIntersection(origins[i + j], directions[i + j], 0.0f, -1, sahResult, cache);
+				const bool hit = bvh->queryClosestIntersection(origins[i + j], directions[i + j], 0.0f, -1, result);
+
+				// Rays grazing an edge might differ.
+				if (sahHit != hit || (hit && std::abs(sahResult.distance - result.distance) > 1e-3f))
+					++mismatchCount;
+				if (hit)
+				{
+					Plane plane;
+					polygons[result.index].getPlane(plane);
+					CASE_ASSERT(dot3(result.normal, plane.normal()) > 0.99f);
+					++hitCount;
+				}
+
+				// Packet queries must match single ray queries.
+				CASE_ASSERT(hit == ((closestMask & (1 << j)) != 0));
+				CASE_ASSERT(!hit || (result.index == packetResults[j].index && result.distance == packetResults[j].distance));
+
+				const bool any = bvh->queryAnyIntersection(origins[i + j], directions[i + j], shortDistances[j], -1);
+				CASE_ASSERT(any == ((anyMask & (1 << j)) != 0));
+				CASE_ASSERT(any == (hit && result.distance < shortDistances[j]));
+
+				// Ignoring hit polygon must give a farther, or no, intersection.
+				if (hit)
+				{
+					TriangleBvh::QueryResult ignoreResult;
+					if (bvh->queryClosestIntersection(origins[i + j], directions[i + j], 0.0f, result.index, ignoreResult))
+						CASE_ASSERT(ignoreResult.index != result.index && ignoreResult.distance >= result.distance);
+				}
+			}
+		}
+
+		CASE_ASSERT(hitCount > packetCount);
+		CASE_ASSERT(mismatchCount * 1000 < packetCount * TriangleBvh::PacketSize);
+	}
+}
+
+}
@@ -9,6 +9,7 @@
 #include "Core/Class/AutoRuntimeClass.h"
 #include "Core/Class/IRuntimeClassRegistrar.h"
 #include "Core/Class/IRuntimeDelegate.h"
+#include "Core/Test/Benchmark.h"
 #include "Core/Test/Case.h"
 #include "Core/Test/TestClassFactory.h"
 
@@ -55,6 +56,10 @@ void TestClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	auto classCase = new AutoRuntimeClass< Case >();
 	classCase->addMethod("execute", &Case_execute);
 	registrar->registerClass(classCase);
+
+	auto classBenchmark = new AutoRuntimeClass< Benchmark >();
+	classBenchmark->addMethod("run", &Benchmark::run);
+	registrar->registerClass(classBenchmark);
 }
 
 }
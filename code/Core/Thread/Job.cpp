@@ -126,6 +126,7 @@ void Job::operator delete (void* ptr)
 Job::Job(Event& jobFinishedEvent, const std::function< void() >& task)
 :	m_jobFinishedEvent(jobFinishedEvent)
 ,	m_task(task)
+,	m_claimed(false)
 ,	m_finished(false)
 {
 }
@@ -52,6 +52,7 @@ private:
 
 	Event& m_jobFinishedEvent;
 	task_t m_task;
+	std::atomic< bool > m_claimed;
 	std::atomic< bool > m_finished;
 
 	explicit Job(Event& jobFinishedEvent, const task_t& task);
@@ -91,6 +91,16 @@ void JobQueue::fork(const Job::task_t* tasks, size_t ntasks)
 	// Execute first functor on caller thread.
 	tasks[0]();
 
+	// Execute forked jobs which no worker has started yet on caller
+	// thread, workers take jobs from front of queue so begin at back.
+	// Only our own jobs are executed thus a fork from within a job always
+	// make progress even if all workers are busy.
+	for (int32_t i = int32_t(jobs.size()) - 1; i >= 1; --i)
+	{
+		if (!jobs[i]->m_claimed.exchange(true))
+			execute(jobs[i]);
+	}
+
 	// Wait until all jobs has finished.
 	for (uint32_t i = 1; i < jobs.size(); )
 	{
@@ -136,17 +146,24 @@ void JobQueue::threadWorker()
 			continue;			
 		}
 
-		// Execute job.
-		auto task = job->m_task;
-		if (task)
-			task();
-		job->m_finished = true;
-		T_SAFE_RELEASE(job);
+		// Execute job unless it has already been executed by forking thread.
+		if (!job->m_claimed.exchange(true))
+			execute(job);
 
-		// Decrement number of pending jobs and signal anyone waiting for jobs to finish.
-		m_pending--;
-		m_jobFinishedEvent.broadcast();
+		T_SAFE_RELEASE(job);
 	}
 }
 
+void JobQueue::execute(Job* job)
+{
+	auto task = job->m_task;
+	if (task)
+		task();
+	job->m_finished = true;
+
+	// Decrement number of pending jobs and signal anyone waiting for jobs to finish.
+	m_pending--;
+	m_jobFinishedEvent.broadcast();
+}
+
 }
@@ -63,7 +63,10 @@ public:
 	 *
 	 * Add jobs to internal worker queue, one job
 	 * is always run on the caller thread to reduce
-	 * work for kernel scheduler.
+	 * work for kernel scheduler. Jobs which hasn't
+	 * been started by a worker when caller is done
+	 * are also run on caller thread, thus it's safe
+	 * to fork from within a job.
 	 */
 	void fork(const Job::task_t* tasks, size_t ntasks);
 
@@ -92,6 +95,8 @@ private:
 	std::atomic< int32_t > m_pending;
 
 	void threadWorker();
+
+	void execute(Job* job);
 };
 
 }
@@ -0,0 +1,61 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Containers/StaticVector.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/JobManager.h"
+
+#include <algorithm>
+
+namespace traktor
+{
+
+/*! Process range of items in parallel on job manager.
+ * \ingroup Core
+ *
+ * Range is split into at most a few contiguous chunks per core,
+ * each chunk is processed by a job and call returns when all jobs
+ * are finished. Range which doesn't exceed grain, or if only a
+ * single core is available, is processed on calling thread.
+ *
+ * \param count Number of items.
+ * \param grain Minimum number of items per chunk.
+ * \param fn Functor called with [from, to) range of each chunk.
+ */
+template < typename FunctionType >
+void parallelFor(uint32_t count, uint32_t grain, const FunctionType& fn)
+{
+	const uint32_t c_maxChunks = 64;
+
+	if (count == 0)
+		return;
+
+	grain = std::max< uint32_t >(grain, 1);
+
+	const uint32_t coreCount = OS::getInstance().getCPUCoreCount();
+	if (count <= grain || coreCount <= 1)
+	{
+		fn(0, count);
+		return;
+	}
+
+	const uint32_t chunkCount = std::min< uint32_t >(std::min< uint32_t >((count + grain - 1) / grain, coreCount * 4), c_maxChunks);
+	const uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+	StaticVector< Job::task_t, c_maxChunks > jobs;
+	for (uint32_t from = 0; from < count; from += chunkSize)
+	{
+		const uint32_t to = std::min(from + chunkSize, count);
+		jobs.push_back([=, &fn]() { fn(from, to); });
+	}
+	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+}
+
+}
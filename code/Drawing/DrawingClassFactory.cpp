@@ -41,6 +41,7 @@
 #include "Drawing/Filters/TransformFilter.h"
 #include "Drawing/Functions/BlendFunction.h"
 #include "Drawing/IImageFilter.h"
+#include "Drawing/ISpanFilter.h"
 #include "Drawing/Image.h"
 #include "Drawing/ITransferFunction.h"
 #include "Drawing/Palette.h"
@@ -255,6 +256,9 @@ void DrawingClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	auto classIImageFilter = new AutoRuntimeClass< IImageFilter >();
 	registrar->registerClass(classIImageFilter);
 
+	auto classISpanFilter = new AutoRuntimeClass< ISpanFilter >();
+	registrar->registerClass(classISpanFilter);
+
 	auto classITransferFunction = new AutoRuntimeClass< ITransferFunction >();
 	registrar->registerClass(classITransferFunction);
 
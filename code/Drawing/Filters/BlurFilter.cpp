@@ -10,6 +10,7 @@
 #include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Const.h"
 #include "Drawing/Image.h"
+#include "Drawing/ParallelRows.h"
 #include "Drawing/Filters/BlurFilter.h"
 
 namespace traktor::drawing
@@ -27,17 +28,17 @@ void BlurFilter::apply(Image* image) const
 {
 	Ref< Image > imm = image->clone(false);
 
-	int32_t w = image->getWidth();
-	int32_t h = image->getHeight();
-
-	AlignedVector< Color4f > span(std::max(w + m_x * 2, h + m_y * 2));
-	AlignedVector< Color4f > out(std::max(w, h));
+	const int32_t w = image->getWidth();
+	const int32_t h = image->getHeight();
 
 	// Horizontal pass.
-	{
+	parallelRows(w, h, [&](int32_t fromY, int32_t toY) {
 		const Scalar invX(1.0f / (m_x * 2.0f + 1.0f));
 
-		for (int32_t y = 0; y < h; ++y)
+		AlignedVector< Color4f > span(w + m_x * 2);
+		AlignedVector< Color4f > out(w);
+
+		for (int32_t y = fromY; y < toY; ++y)
 		{
 			image->getSpanUnsafe(y, span.ptr() + m_x);
 
@@ -63,39 +64,48 @@ void BlurFilter::apply(Image* image) const
 
 			imm->setSpanUnsafe(y, out.c_ptr());
 		}
-	}
+	});
 
-	// Vertical pass.
-	{
+	// Vertical pass; each band keep a window of converted rows
+	// instead of reading image column by column.
+	parallelRows(w, h, [&](int32_t fromY, int32_t toY) {
 		const Scalar invY(1.0f / (m_y * 2.0f + 1.0f));
+		const int32_t windowSize = m_y * 2 + 1;
 
-		for (int32_t x = 0; x < w; ++x)
-		{
-			imm->getVerticalSpanUnsafe(x, span.ptr() + m_y);
+		AlignedVector< Color4f > window(windowSize * w);
+		AlignedVector< Color4f > out(w);
 
-			for (int32_t y = 0; y < m_y; ++y)
-			{
-				span[y] = span[m_y];
-				span[y + h + m_y] = span[h + m_y - 1];
-			}
+		const auto row = [&](int32_t y) {
+			return window.ptr() + ((y + windowSize * 2) % windowSize) * w;
+		};
+
+		for (int32_t y = fromY - m_y; y < fromY + m_y; ++y)
+			imm->getSpanUnsafe(std::clamp(y, 0, h - 1), row(y - fromY));
 
-			for (int32_t y = 0; y < h; ++y)
-				out[y] = span[y + m_y];
+		for (int32_t y = fromY; y < toY; ++y)
+		{
+			imm->getSpanUnsafe(std::min(y + m_y, h - 1), row(y + m_y - fromY));
+
+			const Color4f* center = row(y - fromY);
+			for (int32_t x = 0; x < w; ++x)
+				out[x] = center[x];
 
 			for (int32_t dy = 0; dy < m_y; ++dy)
 			{
-				for (int32_t y = 0; y < h; ++y)
-					out[y] += span[y + m_y - dy];
-				for (int32_t y = 0; y < h; ++y)
-					out[y] += span[y + m_y + dy];
+				const Color4f* above = row(y - dy - fromY);
+				for (int32_t x = 0; x < w; ++x)
+					out[x] += above[x];
+				const Color4f* below = row(y + dy - fromY);
+				for (int32_t x = 0; x < w; ++x)
+					out[x] += below[x];
 			}
 
-			for (int32_t y = 0; y < h; ++y)
-				out[y] *= invY;
+			for (int32_t x = 0; x < w; ++x)
+				out[x] *= invY;
 
-			image->setVerticalSpanUnsafe(x, out.c_ptr());
+			image->setSpanUnsafe(y, out.c_ptr());
 		}
-	}
+	});
 }
 
 }
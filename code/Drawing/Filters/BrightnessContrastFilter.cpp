@@ -7,12 +7,11 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Drawing/Filters/BrightnessContrastFilter.h"
-#include "Drawing/Image.h"
 
 namespace traktor::drawing
 {
 
-T_IMPLEMENT_RTTI_CLASS(L"traktor.drawing.BrightnessContrastFilter", BrightnessContrastFilter, IImageFilter)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.drawing.BrightnessContrastFilter", BrightnessContrastFilter, ISpanFilter)
 
 BrightnessContrastFilter::BrightnessContrastFilter(float brightness, float contrast)
 :	m_brightness(brightness)
@@ -20,20 +19,12 @@ BrightnessContrastFilter::BrightnessContrastFilter(float brightness, float contr
 {
 }
 
-void BrightnessContrastFilter::apply(Image* image) const
+void BrightnessContrastFilter::applySpan(Color4f* span, int32_t width) const
 {
-	Color4f in;
-	Color4f c(m_contrast, m_contrast, m_contrast, 1.0f);
-	Color4f b(m_brightness, m_brightness, m_brightness, 0.0f);
-
-	for (int32_t y = 0; y < image->getHeight(); ++y)
-	{
-		for (int32_t x = 0; x < image->getWidth(); ++x)
-		{
-			image->getPixelUnsafe(x, y, in);
-			image->setPixelUnsafe(x, y, in * c + b);
-		}
-	}
+	const Color4f c(m_contrast, m_contrast, m_contrast, 1.0f);
+	const Color4f b(m_brightness, m_brightness, m_brightness, 0.0f);
+	for (int32_t x = 0; x < width; ++x)
+		span[x] = span[x] * c + b;
 }
 
 }
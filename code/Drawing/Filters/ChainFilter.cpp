@@ -6,7 +6,10 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Containers/AlignedVector.h"
 #include "Drawing/Image.h"
+#include "Drawing/ISpanFilter.h"
+#include "Drawing/ParallelRows.h"
 #include "Drawing/Filters/ChainFilter.h"
 
 namespace traktor::drawing
@@ -21,8 +24,44 @@ void ChainFilter::add(IImageFilter* filter)
 
 void ChainFilter::apply(Image* image) const
 {
-	for (auto filter : m_filters)
-		image->apply(filter);
+	for (size_t i = 0; i < m_filters.size(); )
+	{
+		// Gather consecutive span filters, these are fused into a single pass.
+		AlignedVector< const ISpanFilter* > spanFilters;
+		for (; i < m_filters.size(); ++i)
+		{
+			const ISpanFilter* spanFilter = dynamic_type_cast< const ISpanFilter* >(m_filters[i]);
+			if (!spanFilter)
+				break;
+			spanFilters.push_back(spanFilter);
+		}
+
+		if (spanFilters.size() <= 1)
+		{
+			if (!spanFilters.empty())
+				image->apply(spanFilters.front());
+			if (i < m_filters.size())
+				image->apply(m_filters[i++]);
+			continue;
+		}
+
+		// Filters can resize image thus width must be read after previous filters.
+		// Each row is written back after each filter, so output is quantized to
+		// image format between filters exactly as when applied one by one.
+		const int32_t width = image->getWidth();
+		parallelRows(width, image->getHeight(), [&](int32_t fromY, int32_t toY) {
+			AlignedVector< Color4f > span(width);
+			for (int32_t y = fromY; y < toY; ++y)
+			{
+				for (auto spanFilter : spanFilters)
+				{
+					image->getSpanUnsafe(y, span.ptr());
+					spanFilter->applySpan(span.ptr(), width);
+					image->setSpanUnsafe(y, span.c_ptr());
+				}
+			}
+		});
+	}
 }
 
 }
@@ -10,6 +10,7 @@
 #include <cstring>
 #include "Core/Math/Const.h"
 #include "Drawing/Image.h"
+#include "Drawing/ParallelRows.h"
 #include "Drawing/Filters/ConvolutionFilter.h"
 
 namespace traktor::drawing
@@ -84,38 +85,61 @@ Ref< ConvolutionFilter > ConvolutionFilter::createEmboss()
 void ConvolutionFilter::apply(Image* image) const
 {
 	Ref< Image > final = image->clone(false);
-	Color4f acc;
-	Color4f in;
-	Scalar norm;
 
-	int32_t hs = m_size / 2;
-	for (int32_t y = 0; y < image->getHeight(); ++y)
-	{
-		for (int32_t x = 0; x < image->getWidth(); ++x)
+	const int32_t w = image->getWidth();
+	const int32_t h = image->getHeight();
+	const int32_t hs = m_size / 2;
+	const int32_t windowSize = hs * 2 + 1;
+
+	// Each band keep a window of converted rows; taps outside of
+	// image are excluded from both sum and normalization.
+	parallelRows(w, h, [&](int32_t fromY, int32_t toY) {
+		AlignedVector< Color4f > window(windowSize * w);
+		AlignedVector< Color4f > out(w);
+
+		const auto row = [&](int32_t y) {
+			return window.ptr() + ((y - fromY + windowSize * 2) % windowSize) * w;
+		};
+
+		for (int32_t y = std::max(fromY - hs, 0); y < std::min(fromY + hs, h); ++y)
+			image->getSpanUnsafe(y, row(y));
+
+		for (int32_t y = fromY; y < toY; ++y)
 		{
-			acc.set(0.0f, 0.0f, 0.0f, 0.0f);
-			norm = Scalar(0.0f);
+			if (y + hs < h)
+				image->getSpanUnsafe(y + hs, row(y + hs));
 
-			const Scalar* kernel = &m_matrix[0];
-			for (int32_t r = -hs; r <= hs; ++r)
+			for (int32_t x = 0; x < w; ++x)
 			{
-				for (int32_t c = -hs; c <= hs; ++c)
+				Color4f acc(0.0f, 0.0f, 0.0f, 0.0f);
+				Scalar norm(0.0f);
+
+				const Scalar* kernel = &m_matrix[0];
+				for (int32_t r = -hs; r <= hs; ++r, kernel += m_size)
 				{
-					if (image->getPixel(x + c, y + r, in))
+					if (y + r < 0 || y + r >= h)
+						continue;
+
+					const Color4f* in = row(y + r);
+					for (int32_t c = -hs; c <= hs; ++c)
 					{
-						acc += in * (*kernel);
-						norm += *kernel;
+						if (x + c >= 0 && x + c < w)
+						{
+							acc += in[x + c] * kernel[c + hs];
+							norm += kernel[c + hs];
+						}
 					}
-					++kernel;
 				}
-			}
 
-			if (norm)
-				acc /= norm;
+				if (norm)
+					acc /= norm;
 
-			final->setPixelUnsafe(x, y, acc);
+				out[x] = acc;
+			}
+
+			final->setSpanUnsafe(y, out.c_ptr());
 		}
-	}
+	});
 
 	image->swap(final);
 }
@@ -6,8 +6,11 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Const.h"
+#include "Core/Thread/Atomic.h"
 #include "Drawing/Image.h"
+#include "Drawing/ParallelRows.h"
 #include "Drawing/Filters/DilateFilter.h"
 
 namespace traktor::drawing
@@ -22,39 +25,54 @@ DilateFilter::DilateFilter(int32_t iterations)
 
 void DilateFilter::apply(Image* image) const
 {
+	const int32_t w = image->getWidth();
+	const int32_t h = image->getHeight();
+
 	// Keep copy of image so we can restore alpha channel later.
 	Ref< Image > original = image->clone();
 
 	// Dilate pixels.
-	Color4f tmp;
 	for (int32_t i = 0; i < m_iterations; ++i)
 	{
 		Ref< Image > final = image->clone(false);
 
 		int32_t dilated = 0;
-		for (int32_t y = 0; y < image->getHeight(); ++y)
-		{
-			for (int32_t x = 0; x < image->getWidth(); ++x)
+		parallelRows(w, h, [&](int32_t fromY, int32_t toY) {
+			AlignedVector< Color4f > rows[3] = { AlignedVector< Color4f >(w), AlignedVector< Color4f >(w), AlignedVector< Color4f >(w) };
+			AlignedVector< Color4f > out(w);
+			int32_t bandDilated = 0;
+
+			for (int32_t y = fromY; y < toY; ++y)
 			{
-				image->getPixelUnsafe(x, y, tmp);
-				if (tmp.getAlpha() > FUZZY_EPSILON)
+				for (int32_t iy = -1; iy <= 1; ++iy)
 				{
-					final->setPixelUnsafe(x, y, tmp);
-					continue;
+					if (y + iy >= 0 && y + iy < h)
+						image->getSpanUnsafe(y + iy, rows[iy + 1].ptr());
 				}
 
-				Color4f acc(0.0f, 0.0f, 0.0f, 0.0f);
-				int32_t cnt = 0;
-
-				for (int32_t iy = -1; iy <= 1; ++iy)
+				for (int32_t x = 0; x < w; ++x)
 				{
-					for (int32_t ix = -1; ix <= 1; ++ix)
+					const Color4f& center = rows[1][x];
+					if (center.getAlpha() > FUZZY_EPSILON)
 					{
-						if (ix == 0 && iy == 0)
+						out[x] = center;
+						continue;
+					}
+
+					Color4f acc(0.0f, 0.0f, 0.0f, 0.0f);
+					int32_t cnt = 0;
+
+					for (int32_t iy = -1; iy <= 1; ++iy)
+					{
+						if (y + iy < 0 || y + iy >= h)
 							continue;
 
-						if (image->getPixel(x + ix, y + iy, tmp))
+						for (int32_t ix = -1; ix <= 1; ++ix)
 						{
+							if ((ix == 0 && iy == 0) || x + ix < 0 || x + ix >= w)
+								continue;
+
+							const Color4f& tmp = rows[iy + 1][x + ix];
 							if (tmp.getAlpha() > FUZZY_EPSILON)
 							{
 								acc += tmp;
@@ -62,19 +80,23 @@ void DilateFilter::apply(Image* image) const
 							}
 						}
 					}
-				}
 
-				if (cnt > 0)
-				{
-					acc /= Scalar(float(cnt));
-					acc.setAlpha(Scalar(1.0f));
-					final->setPixelUnsafe(x, y, acc);
-					dilated++;
+					if (cnt > 0)
+					{
+						acc /= Scalar(float(cnt));
+						acc.setAlpha(Scalar(1.0f));
+						out[x] = acc;
+						bandDilated++;
+					}
+					else
+						out[x] = center;
 				}
-				else
-					final->setPixelUnsafe(x, y, tmp);
+
+				final->setSpanUnsafe(y, out.c_ptr());
 			}
-		}
+
+			Atomic::add(dilated, bandDilated);
+		});
 
 		if (dilated > 0)
 			image->swap(final);
@@ -87,20 +109,18 @@ void DilateFilter::apply(Image* image) const
 	}
 
 	// Restore alpha channel.
-	for (int32_t y = 0; y < image->getHeight(); ++y)
-	{
-		for (int32_t x = 0; x < image->getWidth(); ++x)
+	parallelRows(w, h, [&](int32_t fromY, int32_t toY) {
+		AlignedVector< Color4f > oc(w);
+		AlignedVector< Color4f > ic(w);
+		for (int32_t y = fromY; y < toY; ++y)
 		{
-			Color4f oc;
-			original->getPixelUnsafe(x, y, oc);
-
-			Color4f ic;
-			image->getPixelUnsafe(x, y, ic);
-
-			ic.setAlpha(oc.getAlpha());
-			image->setPixelUnsafe(x, y, ic);
+			original->getSpanUnsafe(y, oc.ptr());
+			image->getSpanUnsafe(y, ic.ptr());
+			for (int32_t x = 0; x < w; ++x)
+				ic[x].setAlpha(oc[x].getAlpha());
+			image->setSpanUnsafe(y, ic.c_ptr());
 		}
-	}
+	});
 }
 
 }
@@ -7,14 +7,12 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include <cmath>
-#include "Core/Containers/AlignedVector.h"
-#include "Drawing/Image.h"
 #include "Drawing/Filters/GammaFilter.h"
 
 namespace traktor::drawing
 {
 
-T_IMPLEMENT_RTTI_CLASS(L"traktor.drawing.GammaFilter", GammaFilter, IImageFilter)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.drawing.GammaFilter", GammaFilter, ISpanFilter)
 
 GammaFilter::GammaFilter(float fromGamma, float toGamma)
 {
@@ -24,22 +22,16 @@ GammaFilter::GammaFilter(float fromGamma, float toGamma)
 	m_gamma[3] = 1.0f;
 }
 
-void GammaFilter::apply(Image* image) const
+void GammaFilter::applySpan(Color4f* span, int32_t width) const
 {
-	AlignedVector< Color4f > span(image->getWidth());
-	for (int32_t y = 0; y < image->getHeight(); ++y)
+	for (int32_t x = 0; x < width; ++x)
 	{
-		image->getSpanUnsafe(y, span.ptr());
-		for (int32_t x = 0; x < image->getWidth(); ++x)
-		{
-			span[x] = Color4f(
-				std::pow(span[x].getRed(), m_gamma[0]),
-				std::pow(span[x].getGreen(), m_gamma[1]),
-				std::pow(span[x].getBlue(), m_gamma[2]),
-				std::pow(span[x].getAlpha(), m_gamma[3])
-			);
-		}
-		image->setSpanUnsafe(y, span.c_ptr());
+		span[x] = Color4f(
+			std::pow(span[x].getRed(), m_gamma[0]),
+			std::pow(span[x].getGreen(), m_gamma[1]),
+			std::pow(span[x].getBlue(), m_gamma[2]),
+			std::pow(span[x].getAlpha(), m_gamma[3])
+		);
 	}
 }
 
@@ -10,6 +10,7 @@
 #include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Const.h"
 #include "Drawing/Image.h"
+#include "Drawing/ParallelRows.h"
 #include "Drawing/Filters/GaussianBlurFilter.h"
 
 namespace traktor::drawing
@@ -54,75 +55,70 @@ void GaussianBlurFilter::apply(Image* image) const
 {
 	Ref< Image > imm = image->clone(false);
 
-	int32_t w = image->getWidth();
-	int32_t h = image->getHeight();
+	const int32_t w = image->getWidth();
+	const int32_t h = image->getHeight();
+	const int32_t m = (m_size & ~1) / 2;
 
-	int32_t m = (m_size & ~1) / 2;
-
-	AlignedVector< Color4f > span(std::max(w, h));
-	AlignedVector< Color4f > out(std::max(w, h));
-
-	// Horizontal pass.
-	{
-		for (int32_t y = 0; y < h; ++y)
+	// Horizontal pass; source span is padded with edge pixels so
+	// kernel can be applied without clamping each tap.
+	parallelRows(w, h, [&](int32_t fromY, int32_t toY) {
+		AlignedVector< Color4f > span(w + m * 2);
+		AlignedVector< Color4f > out(w);
+		for (int32_t y = fromY; y < toY; ++y)
 		{
-			image->getSpanUnsafe(y, span.ptr());
-
+			image->getSpanUnsafe(y, span.ptr() + m);
 			for (int32_t x = 0; x < m; ++x)
 			{
-				out[x] = Color4f(0.0f, 0.0f, 0.0f, 0.0f);
-				for (int32_t dx = 0; dx < m_size; ++dx)
-					out[x] += span[std::max(x + dx - m, 0)] * m_kernel[dx];
+				span[x] = span[m];
+				span[x + w + m] = span[w + m - 1];
 			}
 
-			for (int32_t x = m; x < w - m; ++x)
+			for (int32_t x = 0; x < w; ++x)
+				out[x] = span[x] * m_kernel[0];
+			for (int32_t dx = 1; dx < m_size; ++dx)
 			{
-				out[x] = Color4f(0.0f, 0.0f, 0.0f, 0.0f);
-				for (int32_t dx = 0; dx < m_size; ++dx)
-					out[x] += span[x + dx - m] * m_kernel[dx];
-			}
-
-			for (int32_t x = w - m; x < w; ++x)
-			{
-				out[x] = Color4f(0.0f, 0.0f, 0.0f, 0.0f);
-				for (int32_t dx = 0; dx < m_size; ++dx)
-					out[x] += span[std::min(x + dx - m, w - 1)] * m_kernel[dx];
+				const Scalar k = m_kernel[dx];
+				const Color4f* s = span.c_ptr() + dx;
+				for (int32_t x = 0; x < w; ++x)
+					out[x] += s[x] * k;
 			}
 
 			imm->setSpanUnsafe(y, out.c_ptr());
 		}
-	}
+	});
 
-	// Vertical pass.
-	{
-		for (int32_t x = 0; x < w; ++x)
-		{
-			imm->getVerticalSpanUnsafe(x, span.ptr());
+	// Vertical pass; each band keep a window of converted rows thus
+	// each output row is a weighted sum of contiguous rows instead
+	// of reading image column by column.
+	parallelRows(w, h, [&](int32_t fromY, int32_t toY) {
+		AlignedVector< Color4f > window(m_size * w);
+		AlignedVector< Color4f > out(w);
 
-			for (int32_t y = 0; y < m; ++y)
-			{
-				out[y] = Color4f(0.0f, 0.0f, 0.0f, 0.0f);
-				for (int32_t dy = 0; dy < m_size; ++dy)
-					out[y] += span[std::max(y + dy - m, 0)] * m_kernel[dy];
-			}
+		const auto row = [&](int32_t y) {
+			return window.ptr() + ((y + m_size * 2) % m_size) * w;
+		};
 
-			for (int32_t y = m; y < h - m; ++y)
-			{
-				out[y] = Color4f(0.0f, 0.0f, 0.0f, 0.0f);
-				for (int32_t dy = 0; dy < m_size; ++dy)
-					out[y] += span[y + dy - m] * m_kernel[dy];
-			}
+		for (int32_t y = fromY - m; y < fromY + m; ++y)
+			imm->getSpanUnsafe(std::clamp(y, 0, h - 1), row(y - fromY));
+
+		for (int32_t y = fromY; y < toY; ++y)
+		{
+			imm->getSpanUnsafe(std::min(y + m, h - 1), row(y + m - fromY));
 
-			for (int32_t y = h - m; y < h; ++y)
+			const Color4f* s = row(y - m - fromY);
+			for (int32_t x = 0; x < w; ++x)
+				out[x] = s[x] * m_kernel[0];
+			for (int32_t dy = 1; dy < m_size; ++dy)
 			{
-				out[y] = Color4f(0.0f, 0.0f, 0.0f, 0.0f);
-				for (int32_t dy = 0; dy < m_size; ++dy)
-					out[y] += span[std::min(y + dy - m, h - 1)] * m_kernel[dy];
+				const Scalar k = m_kernel[dy];
+				s = row(y + dy - m - fromY);
+				for (int32_t x = 0; x < w; ++x)
+					out[x] += s[x] * k;
 			}
 
-			image->setVerticalSpanUnsafe(x, out.c_ptr());
+			image->setSpanUnsafe(y, out.c_ptr());
 		}
-	}
+	});
 }
 
 }
@@ -7,25 +7,19 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Drawing/Filters/GrayscaleFilter.h"
-#include "Drawing/Image.h"
 
 namespace traktor::drawing
 {
 
-T_IMPLEMENT_RTTI_CLASS(L"traktor.drawing.GrayScaleFilter", GrayscaleFilter, IImageFilter)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.drawing.GrayScaleFilter", GrayscaleFilter, ISpanFilter)
 
-void GrayscaleFilter::apply(Image* image) const
+void GrayscaleFilter::applySpan(Color4f* span, int32_t width) const
 {
-	Color4f in;
-	for (int32_t y = 0; y < image->getHeight(); ++y)
+	for (int32_t x = 0; x < width; ++x)
 	{
-		for (int32_t x = 0; x < image->getWidth(); ++x)
-		{
-			image->getPixelUnsafe(x, y, in);
-			const float luminance = 0.2126f * in.getRed() + 0.7152f * in.getGreen() + 0.0722f * in.getBlue();
-			const Color4f out(luminance, luminance, luminance, in.getAlpha());
-			image->setPixelUnsafe(x, y, out);
-		}
+		const Color4f& in = span[x];
+		const float luminance = 0.2126f * in.getRed() + 0.7152f * in.getGreen() + 0.0722f * in.getBlue();
+		span[x] = Color4f(luminance, luminance, luminance, in.getAlpha());
 	}
 }
 
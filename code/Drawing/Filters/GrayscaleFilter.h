@@ -8,7 +8,7 @@
  */
 #pragma once
 
-#include "Drawing/IImageFilter.h"
+#include "Drawing/ISpanFilter.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -24,12 +24,12 @@ namespace traktor::drawing
 /*! Gray scale filter.
  * \ingroup Drawing
  */
-class T_DLLCLASS GrayscaleFilter : public IImageFilter
+class T_DLLCLASS GrayscaleFilter : public ISpanFilter
 {
 	T_RTTI_CLASS;
 
 protected:
-	virtual void apply(Image* image) const override final;
+	virtual void applySpan(Color4f* span, int32_t width) const override final;
 };
 
 }
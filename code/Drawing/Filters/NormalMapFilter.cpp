@@ -6,7 +6,10 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include "Core/Containers/AlignedVector.h"
 #include "Drawing/Image.h"
+#include "Drawing/ParallelRows.h"
 #include "Drawing/Filters/NormalMapFilter.h"
 
 namespace traktor::drawing
@@ -22,32 +25,45 @@ NormalMapFilter::NormalMapFilter(float scale)
 void NormalMapFilter::apply(Image* image) const
 {
 	Ref< Image > final = image->clone(false);
-	Color4f in0, in1, in2;
-	Scalar c[3];
 
-	for (int32_t y = 0; y < image->getHeight(); ++y)
-	{
-		for (int32_t x = 0; x < image->getWidth(); ++x)
+	const int32_t w = image->getWidth();
+	const int32_t h = image->getHeight();
+
+	parallelRows(w, h, [&](int32_t fromY, int32_t toY) {
+		AlignedVector< Color4f > row0(w);
+		AlignedVector< Color4f > row1(w);
+		AlignedVector< Color4f > out(w);
+		Scalar c[3];
+
+		for (int32_t y = fromY; y < toY; ++y)
 		{
-			image->getPixel(x, y, in0);
-			image->getPixel(x + 1, y, in1);
-			image->getPixel(x, y + 1, in2);
+			image->getSpanUnsafe(y, row0.ptr());
+			image->getSpanUnsafe(std::min(y + 1, h - 1), row1.ptr());
+
+			for (int32_t x = 0; x < w; ++x)
+			{
+				const Color4f& in0 = row0[x];
+				const Color4f& in1 = row0[std::min(x + 1, w - 1)];
+				const Color4f& in2 = row1[x];
+
+				for (int32_t i = 0; i < 3; ++i)
+					c[i] = (in0.getRed() + in1.getGreen() + in2.getBlue()) / Scalar(3.0f);
 
-			for (int32_t i = 0; i < 3; ++i)
-				c[i] = (in0.getRed() + in1.getGreen() + in2.getBlue()) / Scalar(3.0f);
+				Vector4 normal =
+					Vector4(
+						(c[1] - c[0]) * m_scale,
+						(c[2] - c[0]) * m_scale,
+						1.0f
+					).normalized();
 
-			Vector4 normal =
-				Vector4(
-					(c[1] - c[0]) * m_scale,
-					(c[2] - c[0]) * m_scale,
-					1.0f
-				).normalized();
+				normal = normal * 0.5_simd + 0.5_simd;
 
-			normal = normal * 0.5_simd + 0.5_simd;
+				out[x] = Color4f(normal.xyz0());
+			}
 
-			final->setPixelUnsafe(x, y, Color4f(normal.xyz0()));
+			final->setSpanUnsafe(y, out.c_ptr());
 		}
-	}
+	});
 
 	image->swap(final);
 }
@@ -8,7 +8,7 @@
  */
 #pragma once
 
-#include "Drawing/IImageFilter.h"
+#include "Drawing/ISpanFilter.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -24,7 +24,7 @@ namespace traktor::drawing
 /*! Normalize normal map image filter.
  * \ingroup Drawing
  */
-class T_DLLCLASS NormalizeFilter : public IImageFilter
+class T_DLLCLASS NormalizeFilter : public ISpanFilter
 {
 	T_RTTI_CLASS;
 
@@ -34,7 +34,7 @@ public:
 	explicit NormalizeFilter(float scale);
 
 protected:
-	virtual void apply(Image* image) const override final;
+	virtual void applySpan(Color4f* span, int32_t width) const override final;
 
 private:
 	float m_scale = 0.0f;
@@ -8,7 +8,7 @@
  */
 #pragma once
 
-#include "Drawing/IImageFilter.h"
+#include "Drawing/ISpanFilter.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -24,7 +24,7 @@ namespace traktor::drawing
 /*! Quantize filter.
  * \ingroup Drawing
  */
-class T_DLLCLASS QuantizeFilter : public IImageFilter
+class T_DLLCLASS QuantizeFilter : public ISpanFilter
 {
 	T_RTTI_CLASS;
 
@@ -32,7 +32,7 @@ public:
 	explicit QuantizeFilter(int steps);
 
 protected:
-	virtual void apply(Image* image) const override final;
+	virtual void applySpan(Color4f* span, int32_t width) const override final;
 
 private:
 	int m_steps;
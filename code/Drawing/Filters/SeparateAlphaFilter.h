@@ -8,7 +8,7 @@
  */
 #pragma once
 
-#include "Drawing/IImageFilter.h"
+#include "Drawing/ISpanFilter.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -24,12 +24,12 @@ namespace traktor::drawing
 /*! Separate alpha from a premultiplied alpha image.
  * \ingroup Drawing
  */
-class T_DLLCLASS SeparateAlphaFilter : public IImageFilter
+class T_DLLCLASS SeparateAlphaFilter : public ISpanFilter
 {
 	T_RTTI_CLASS;
 
 protected:
-	virtual void apply(Image* image) const override final;
+	virtual void applySpan(Color4f* span, int32_t width) const override final;
 };
 
 }
@@ -8,12 +8,11 @@
  */
 #include <cctype>
 #include "Drawing/Filters/SwizzleFilter.h"
-#include "Drawing/Image.h"
 
 namespace traktor::drawing
 {
 
-T_IMPLEMENT_RTTI_CLASS(L"traktor.drawing.SwizzleFilter", SwizzleFilter, IImageFilter)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.drawing.SwizzleFilter", SwizzleFilter, ISpanFilter)
 
 SwizzleFilter::SwizzleFilter(const std::wstring& swizzle)
 {
@@ -24,40 +23,37 @@ SwizzleFilter::SwizzleFilter(const std::wstring& swizzle)
 	m_swizzle[3] = std::toupper(swizzle[3]);
 }
 
-void SwizzleFilter::apply(Image* image) const
+void SwizzleFilter::applySpan(Color4f* span, int32_t width) const
 {
-	Color4f in, out;
-	for (int32_t y = 0; y < image->getHeight(); ++y)
+	Color4f out;
+	for (int32_t x = 0; x < width; ++x)
 	{
-		for (int32_t x = 0; x < image->getWidth(); ++x)
+		const Color4f in = span[x];
+		for (int32_t i = 0; i < 4; ++i)
 		{
-			image->getPixelUnsafe(x, y, in);
-			for (int32_t i = 0; i < 4; ++i)
+			switch (m_swizzle[i])
 			{
-				switch (m_swizzle[i])
-				{
-				case L'A':
-					out.set(i, in.getAlpha());
-					break;
-				case L'R':
-					out.set(i, in.getRed());
-					break;
-				case L'G':
-					out.set(i, in.getGreen());
-					break;
-				case L'B':
-					out.set(i, in.getBlue());
-					break;
-				case L'0':
-					out.set(i, 0.0_simd);
-					break;
-				case L'1':
-					out.set(i, 1.0_simd);
-					break;
-				}
+			case L'A':
+				out.set(i, in.getAlpha());
+				break;
+			case L'R':
+				out.set(i, in.getRed());
+				break;
+			case L'G':
+				out.set(i, in.getGreen());
+				break;
+			case L'B':
+				out.set(i, in.getBlue());
+				break;
+			case L'0':
+				out.set(i, 0.0_simd);
+				break;
+			case L'1':
+				out.set(i, 1.0_simd);
+				break;
 			}
-			image->setPixelUnsafe(x, y, out);
 		}
+		span[x] = out;
 	}
 }
 
@@ -9,7 +9,7 @@
 #pragma once
 
 #include <string>
-#include "Drawing/IImageFilter.h"
+#include "Drawing/ISpanFilter.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -25,7 +25,7 @@ namespace traktor::drawing
 /*! Swizzle color channels.
  * \ingroup Drawing
  */
-class T_DLLCLASS SwizzleFilter : public IImageFilter
+class T_DLLCLASS SwizzleFilter : public ISpanFilter
 {
 	T_RTTI_CLASS;
 
@@ -33,7 +33,7 @@ public:
 	explicit SwizzleFilter(const std::wstring& swizzle);
 
 protected:
-	virtual void apply(Image* image) const override final;
+	virtual void applySpan(Color4f* span, int32_t width) const override final;
 
 private:
 	wchar_t m_swizzle[4];
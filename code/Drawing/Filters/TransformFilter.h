@@ -9,7 +9,7 @@
 #pragma once
 
 #include "Core/Math/Color4f.h"
-#include "Drawing/IImageFilter.h"
+#include "Drawing/ISpanFilter.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -27,7 +27,7 @@ namespace traktor::drawing
  *
  * Linearly transform colors; RGBA' = RGBA * Km + Kc
  */
-class T_DLLCLASS TransformFilter : public IImageFilter
+class T_DLLCLASS TransformFilter : public ISpanFilter
 {
 	T_RTTI_CLASS;
 
@@ -35,7 +35,7 @@ public:
 	explicit TransformFilter(const Color4f& Km, const Color4f& Kc);
 
 protected:
-	virtual void apply(Image* image) const override final;
+	virtual void applySpan(Color4f* span, int32_t width) const override final;
 
 private:
 	Color4f m_Km;
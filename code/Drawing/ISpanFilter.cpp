@@ -0,0 +1,34 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Color4f.h"
+#include "Drawing/Image.h"
+#include "Drawing/ISpanFilter.h"
+#include "Drawing/ParallelRows.h"
+
+namespace traktor::drawing
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.drawing.ISpanFilter", ISpanFilter, IImageFilter)
+
+void ISpanFilter::apply(Image* image) const
+{
+	const int32_t width = image->getWidth();
+	parallelRows(width, image->getHeight(), [&](int32_t fromY, int32_t toY) {
+		AlignedVector< Color4f > span(width);
+		for (int32_t y = fromY; y < toY; ++y)
+		{
+			image->getSpanUnsafe(y, span.ptr());
+			applySpan(span.ptr(), width);
+			image->setSpanUnsafe(y, span.c_ptr());
+		}
+	});
+}
+
+}
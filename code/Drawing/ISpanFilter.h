@@ -0,0 +1,49 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Math/Color4f.h"
+#include "Drawing/IImageFilter.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_DRAWING_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::drawing
+{
+
+/*! Span filter base class.
+ * \ingroup Drawing
+ *
+ * Span filters modify each pixel based only on it's own
+ * value; rows are filtered in parallel bands and consecutive
+ * span filters in a ChainFilter are fused into a single pass.
+ */
+class T_DLLCLASS ISpanFilter : public IImageFilter
+{
+	T_RTTI_CLASS;
+
+protected:
+	friend class ChainFilter;
+
+	virtual void apply(Image* image) const override final;
+
+	/*! Filter span of pixels in-place.
+	 *
+	 * \param span Pixels.
+	 * \param width Number of pixels in span.
+	 */
+	virtual void applySpan(Color4f* span, int32_t width) const = 0;
+};
+
+}
@@ -16,6 +16,8 @@
 #include "Core/Serialization/Member.h"
 #include "Core/Serialization/MemberComposite.h"
 #include "Core/Serialization/MemberRef.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/JobManager.h"
 #include "Drawing/Image.h"
 #include "Drawing/Palette.h"
 #include "Drawing/IImageFormat.h"
@@ -65,6 +67,48 @@ uint8_t* allocData(size_t size)
 	return ptr + c_wallSize;
 }
 
+/*! Convert pixels, large images are split into bands of rows which are converted in parallel. */
+void convertRows(
+	const PixelFormat& fromPixelFormat,
+	const Palette* fromPalette,
+	const uint8_t* src,
+	const PixelFormat& intoPixelFormat,
+	const Palette* intoPalette,
+	uint8_t* dst,
+	int32_t width,
+	int32_t height
+)
+{
+	const int32_t c_parallelPixelCount = 256 * 1024;
+
+	const int32_t coreCount = (int32_t)OS::getInstance().getCPUCoreCount();
+	if (width * height < c_parallelPixelCount || coreCount <= 1)
+	{
+		fromPixelFormat.convert(fromPalette, src, intoPixelFormat, intoPalette, dst, width * height);
+		return;
+	}
+
+	const int32_t bandCount = std::min(coreCount * 2, height);
+	const int32_t bandRows = (height + bandCount - 1) / bandCount;
+
+	AlignedVector< Job::task_t > jobs;
+	for (int32_t y = 0; y < height; y += bandRows)
+	{
+		const int32_t rows = std::min(bandRows, height - y);
+		jobs.push_back([=, &fromPixelFormat, &intoPixelFormat]() {
+			fromPixelFormat.convert(
+				fromPalette,
+				src + y * width * fromPixelFormat.getByteSize(),
+				intoPixelFormat,
+				intoPalette,
+				dst + y * width * intoPixelFormat.getByteSize(),
+				width * rows
+			);
+		});
+	}
+	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+}
+
 void freeData(uint8_t* ptr, size_t size)
 {
 	if (ptr)
@@ -431,13 +475,15 @@ void Image::convert(const PixelFormat& intoPixelFormat, Palette* intoPalette)
 	// If pixel size match then convert in-place.
 	if (m_pixelFormat.getByteSize() == intoPixelFormat.getByteSize())
 	{
-		m_pixelFormat.convert(
+		convertRows(
+			m_pixelFormat,
 			m_palette,
 			m_data,
 			intoPixelFormat,
 			intoPalette,
 			m_data,
-			m_width * m_height
+			m_width,
+			m_height
 		);
 	}
 	else
@@ -445,13 +491,15 @@ void Image::convert(const PixelFormat& intoPixelFormat, Palette* intoPalette)
 		const size_t size = m_width * m_height * intoPixelFormat.getByteSize();
 		uint8_t* tmp = allocData(size);
 
-		m_pixelFormat.convert(
+		convertRows(
+			m_pixelFormat,
 			m_palette,
 			m_data,
 			intoPixelFormat,
 			intoPalette,
 			tmp,
-			m_width * m_height
+			m_width,
+			m_height
 		);
 
 		freeData(m_data, m_size);
@@ -0,0 +1,43 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Thread/ParallelFor.h"
+
+#include <algorithm>
+
+namespace traktor::drawing
+{
+
+const int32_t c_pixelsPerJob = 64 * 1024;	//!< Minimum number of pixels processed by each job.
+
+/*! Split image rows into bands and process bands on job manager.
+ * \ingroup Drawing
+ *
+ * Each band is a contiguous range of rows; filters which only
+ * write rows of their own band produce same output regardless
+ * of number of threads. Small images, or if only a single core
+ * is available, are processed on calling thread as a single band.
+ *
+ * \param width Image width, used to determine band size.
+ * \param height Image height.
+ * \param fn Functor called with [fromY, toY) band.
+ */
+template < typename FunctionType >
+void parallelRows(int32_t width, int32_t height, const FunctionType& fn)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	parallelFor(height, c_pixelsPerJob / width, [&](uint32_t fromY, uint32_t toY) {
+		fn((int32_t)fromY, (int32_t)toY);
+	});
+}
+
+}
@@ -26,12 +26,16 @@
 #include "Core/Serialization/ISerializer.h"
 #include "Core/Serialization/Member.h"
 #include "Drawing/Palette.h"
+#include "Drawing/PixelFormatConvert.h"
 
 namespace traktor::drawing
 {
 namespace
 {
 
+// Minimum number of pixels before selecting a specialized kernel is worth it.
+const int32_t c_kernelPixelCount = 16;
+
 inline float clamp(float v)
 {
 	return min(max(v, 0.0f), 1.0f);
@@ -419,6 +423,17 @@ void PixelFormat::convert(
 	uint32_t i;
 	float clr[4];
 
+	// Specialized kernel, only formats with odd channel sizes use generic paths below.
+	if (pixelCount >= c_kernelPixelCount)
+	{
+		PixelFormatConvert kernel;
+		if (kernel.select(*this, dstFormat))
+		{
+			kernel(srcPixels, dstPixels, pixelCount);
+			return;
+		}
+	}
+
 	const bool isSourcePacked32 = isPacked32(*this);
 	const bool isDestinationPacked32 = isPacked32(dstFormat);
 
@@ -683,6 +698,17 @@ void PixelFormat::convertTo4f(
 	const uint8_t* T_RESTRICT src = static_cast< const uint8_t * T_RESTRICT >(srcPixels);
 	Color4f* T_RESTRICT dst = dstPixels;
 
+	// Color4f is laid out as RGBA32F thus specialized kernels can be used for contiguous pixels.
+	if (srcPixelPitch <= 1 && pixelCount >= c_kernelPixelCount)
+	{
+		PixelFormatConvert kernel;
+		if (kernel.select(*this, getRGBAF32()))
+		{
+			kernel(srcPixels, dstPixels, pixelCount);
+			return;
+		}
+	}
+
 	if (!isPalettized() && !isFloatPoint() && getColorBits() <= 32)
 	{
 		uint32_t rmx = (1 << getRedBits()) - 1;
@@ -857,6 +883,16 @@ void PixelFormat::convertFrom4f(
 	uint8_t* T_RESTRICT dst = static_cast< uint8_t * T_RESTRICT >(dstPixels);
 	float T_MATH_ALIGN16 clr[4];
 
+	if (dstPixelPitch <= 1 && pixelCount >= c_kernelPixelCount)
+	{
+		PixelFormatConvert kernel;
+		if (kernel.select(getRGBAF32(), *this))
+		{
+			kernel(srcPixels, dstPixels, pixelCount);
+			return;
+		}
+	}
+
 	if (!isPalettized() && !isFloatPoint() && getColorBits() <= 32)
 	{
 		uint32_t rmx = ((1 << getRedBits()) - 1);
@@ -0,0 +1,453 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Math/MathConfig.h"
+#include "Drawing/PixelFormat.h"
+#include "Drawing/PixelFormatConvert.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace traktor::drawing
+{
+namespace
+{
+
+enum class Element
+{
+	Byte,
+	Half,
+	Float
+};
+
+struct Layout
+{
+	Element element;
+	int32_t elementCount;
+	int8_t channel[4];
+};
+
+bool classify(const PixelFormat& pf, Layout& outLayout)
+{
+#if defined(T_LITTLE_ENDIAN)
+	if (pf.isPalettized())
+		return false;
+
+	const int32_t bits[] = { pf.getRedBits(), pf.getGreenBits(), pf.getBlueBits(), pf.getAlphaBits() };
+	const int32_t shifts[] = { pf.getRedShift(), pf.getGreenShift(), pf.getBlueShift(), pf.getAlphaShift() };
+
+	int32_t elementBits = 8;
+	outLayout.element = Element::Byte;
+
+	if (pf.isFloatPoint())
+	{
+		elementBits = std::max(std::max(bits[0], bits[1]), std::max(bits[2], bits[3]));
+		if (elementBits == 16)
+			outLayout.element = Element::Half;
+		else if (elementBits == 32)
+			outLayout.element = Element::Float;
+		else
+			return false;
+	}
+
+	if ((pf.getColorBits() % elementBits) != 0)
+		return false;
+
+	// Pixel must fit in a register.
+	outLayout.elementCount = pf.getColorBits() / elementBits;
+	if (outLayout.elementCount * elementBits > 128 || (outLayout.element == Element::Byte && outLayout.elementCount > 4))
+		return false;
+
+	bool any = false;
+	for (int32_t i = 0; i < 4; ++i)
+	{
+		if (bits[i] == 0)
+			outLayout.channel[i] = -1;
+		else if (bits[i] == elementBits && (shifts[i] % elementBits) == 0)
+		{
+			outLayout.channel[i] = (int8_t)(shifts[i] / elementBits);
+			any = true;
+		}
+		else
+			return false;
+	}
+	return any;
+#else
+	return false;
+#endif
+}
+
+int32_t elementSize(Element element)
+{
+	switch (element)
+	{
+	case Element::Half:
+		return 2;
+	case Element::Float:
+		return 4;
+	default:
+		return 1;
+	}
+}
+
+/*! Read pixel of at most four bytes, fixed size copies so they are not calls to memcpy. */
+inline int32_t readBytes(const uint8_t* src, int32_t byteSize)
+{
+	int32_t v = 0;
+	switch (byteSize)
+	{
+	case 1:
+		std::memcpy(&v, src, 1);
+		break;
+	case 2:
+		std::memcpy(&v, src, 2);
+		break;
+	case 3:
+		v = src[0] | (src[1] << 8) | (src[2] << 16);
+		break;
+	default:
+		std::memcpy(&v, src, 4);
+		break;
+	}
+	return v;
+}
+
+inline void writeBytes(uint8_t* dst, int32_t v, int32_t byteSize)
+{
+	switch (byteSize)
+	{
+	case 1:
+		std::memcpy(dst, &v, 1);
+		break;
+	case 2:
+		std::memcpy(dst, &v, 2);
+		break;
+	case 3:
+		std::memcpy(dst, &v, 3);
+		break;
+	default:
+		std::memcpy(dst, &v, 4);
+		break;
+	}
+}
+
+void convertCopy(const PixelFormatConvert& c, const uint8_t* src, uint8_t* dst, int32_t pixelCount)
+{
+	if (src != dst)
+		std::memcpy(dst, src, pixelCount * c.srcByteSize);
+}
+
+void convertShuffle(const PixelFormatConvert& c, const uint8_t* src, uint8_t* dst, int32_t pixelCount)
+{
+	const int32_t ss = c.srcByteSize;
+	const int32_t ds = c.dstByteSize;
+	int32_t i = 0;
+
+#if defined(T_MATH_USE_SSE2)
+	// Four pixels at a time; only 4 * ds bytes are written, else in-place
+	// conversion would overwrite source pixels not yet read.
+	const __m128i shuffle = _mm_loadu_si128((const __m128i*)c.shuffle4);
+	switch (ds)
+	{
+	case 1:
+		for (; (pixelCount - i) * ss >= 16; i += 4)
+		{
+			const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i * ss)), shuffle);
+			writeBytes(dst + i, _mm_cvtsi128_si32(v), 4);
+		}
+		break;
+
+	case 2:
+		for (; (pixelCount - i) * ss >= 16; i += 4)
+		{
+			const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i * ss)), shuffle);
+			_mm_storel_epi64((__m128i*)(dst + i * 2), v);
+		}
+		break;
+
+	case 3:
+		for (; (pixelCount - i) * ss >= 16; i += 4)
+		{
+			const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i * ss)), shuffle);
+			_mm_storel_epi64((__m128i*)(dst + i * 3), v);
+			writeBytes(dst + i * 3 + 8, _mm_cvtsi128_si32(_mm_srli_si128(v, 8)), 4);
+		}
+		break;
+
+	case 4:
+		for (; (pixelCount - i) * ss >= 16; i += 4)
+		{
+			const __m128i v = _mm_loadu_si128((const __m128i*)(src + i * ss));
+			_mm_storeu_si128((__m128i*)(dst + i * 4), _mm_shuffle_epi8(v, shuffle));
+		}
+		break;
+	}
+#endif
+
+	for (; i < pixelCount; ++i)
+	{
+		const int32_t s = readBytes(src + i * ss, ss);
+		int32_t d = 0;
+		for (int32_t j = 0; j < ds; ++j)
+		{
+			if ((c.shuffle4[j] & 0x80) == 0)
+				d |= ((s >> (c.shuffle4[j] * 8)) & 255) << (j * 8);
+		}
+		writeBytes(dst + i * ds, d, ds);
+	}
+}
+
+#if defined(T_MATH_USE_SSE2)
+
+/*! Convert four halfs, in lower 16 bits of each lane, into floats. */
+__m128 halfToFloat4(__m128i h)
+{
+#	if defined(__F16C__)
+	return _mm_cvtph_ps(_mm_packus_epi32(h, h));
+#	else
+	const __m128i expmant = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+	const __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expmant), 16);
+
+	// Rebias exponent by scaling, also handle denormals.
+	const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expmant, 13)), _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+
+	// Inf and NaN keep maximum exponent.
+	const __m128i infnan = _mm_cmpgt_epi32(expmant, _mm_set1_epi32(0x7bff));
+	const __m128 infnanexp = _mm_and_ps(_mm_castsi128_ps(infnan), _mm_castsi128_ps(_mm_set1_epi32(255 << 23)));
+
+	return _mm_or_ps(scaled, _mm_or_ps(_mm_castsi128_ps(sign), infnanexp));
+#	endif
+}
+
+/*! Convert four floats into halfs, result in lower 16 bits of each lane.
+ *
+ * Same as scalar pack; values are clamped to largest half and
+ * mantissa is truncated.
+ */
+__m128i floatToHalf4(__m128 f)
+{
+	// Operands ordered so NaN is kept.
+	const __m128 cf = _mm_min_ps(_mm_set1_ps(65504.0f), _mm_max_ps(_mm_set1_ps(-65504.0f), f));
+#	if defined(__F16C__)
+	return _mm_cvtepu16_epi32(_mm_cvtps_ph(cf, _MM_FROUND_TO_ZERO));
+#	else
+	const __m128 justsign = _mm_and_ps(cf, _mm_castsi128_ps(_mm_set1_epi32(0x80000000)));
+	const __m128 absf = _mm_xor_ps(cf, justsign);
+	const __m128i absi = _mm_castps_si128(absf);
+
+	// Normals; rebias exponent and drop low mantissa bits.
+	const __m128i normal = _mm_sub_epi32(_mm_srli_epi32(absi, 13), _mm_set1_epi32((127 - 15) << 10));
+
+	// Denormals, and zero, are integer multiples of 2^-24.
+	const __m128i denormal = _mm_cvttps_epi32(_mm_mul_ps(absf, _mm_set1_ps(16777216.0f)));
+	const __m128i isdenormal = _mm_cmplt_epi32(absi, _mm_set1_epi32((127 - 14) << 23));
+
+	const __m128i isnan = _mm_cmpgt_epi32(absi, _mm_set1_epi32(255 << 23));
+	const __m128i h = _mm_or_si128(_mm_and_si128(isdenormal, denormal), _mm_andnot_si128(isdenormal, normal));
+	const __m128i joined = _mm_or_si128(_mm_andnot_si128(isnan, h), _mm_and_si128(isnan, _mm_set1_epi32(0x7e00)));
+	return _mm_or_si128(joined, _mm_srli_epi32(_mm_castps_si128(justsign), 16));
+#	endif
+}
+
+/*! Load pixel into register, never read outside of pixel. */
+inline __m128i loadPixel(const uint8_t* src, int32_t byteSize)
+{
+	switch (byteSize)
+	{
+	case 1:
+	case 2:
+	case 3:
+	case 4:
+		return _mm_cvtsi32_si128(readBytes(src, byteSize));
+	case 8:
+		return _mm_loadl_epi64((const __m128i*)src);
+	case 16:
+		return _mm_loadu_si128((const __m128i*)src);
+	default:
+		{
+			uint8_t T_MATH_ALIGN16 tmp[16] = { 0 };
+			std::memcpy(tmp, src, byteSize);
+			return _mm_load_si128((const __m128i*)tmp);
+		}
+	}
+}
+
+/*! Store pixel from register, never write outside of pixel. */
+inline void storePixel(uint8_t* dst, __m128i v, int32_t byteSize)
+{
+	switch (byteSize)
+	{
+	case 1:
+	case 2:
+	case 3:
+	case 4:
+		writeBytes(dst, _mm_cvtsi128_si32(v), byteSize);
+		break;
+	case 8:
+		_mm_storel_epi64((__m128i*)dst, v);
+		break;
+	case 16:
+		_mm_storeu_si128((__m128i*)dst, v);
+		break;
+	default:
+		{
+			uint8_t T_MATH_ALIGN16 tmp[16];
+			_mm_store_si128((__m128i*)tmp, v);
+			std::memcpy(dst, tmp, byteSize);
+		}
+		break;
+	}
+}
+
+/*! Convert between RGBA float vector and lanes of elements. */
+template < Element E >
+struct Lanes {};
+
+template < >
+struct Lanes< Element::Byte >
+{
+	static __m128 toFloat(__m128i v)
+	{
+		return _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(1.0f / 255.0f));
+	}
+
+	/*! Result is packed into lowest four bytes, truncated same as scalar pack. */
+	static __m128i fromFloat(__m128 v)
+	{
+		const __m128 cv = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		const __m128i i = _mm_cvttps_epi32(_mm_mul_ps(cv, _mm_set1_ps(255.0f)));
+		const __m128i s = _mm_packs_epi32(i, i);
+		return _mm_packus_epi16(s, s);
+	}
+};
+
+template < >
+struct Lanes< Element::Half >
+{
+	static __m128 toFloat(__m128i v)
+	{
+		return halfToFloat4(v);
+	}
+
+	static __m128i fromFloat(__m128 v)
+	{
+		return floatToHalf4(v);
+	}
+};
+
+template < >
+struct Lanes< Element::Float >
+{
+	static __m128 toFloat(__m128i v)
+	{
+		return _mm_castsi128_ps(v);
+	}
+
+	static __m128i fromFloat(__m128 v)
+	{
+		return _mm_castps_si128(v);
+	}
+};
+
+/*! Convert through an RGBA float vector.
+ *
+ * Pixel elements are shuffled into, or out of, lanes thus any
+ * channel order is handled without branches. Each pixel is read
+ * completely before written thus in-place conversion is safe.
+ */
+template < Element From, Element To >
+void convertVector(const PixelFormatConvert& c, const uint8_t* src, uint8_t* dst, int32_t pixelCount)
+{
+	const __m128i srcShuffle = _mm_loadu_si128((const __m128i*)c.srcShuffle);
+	const __m128i dstShuffle = _mm_loadu_si128((const __m128i*)c.dstShuffle);
+	const int32_t ss = c.srcByteSize;
+	const int32_t ds = c.dstByteSize;
+
+	for (int32_t i = 0; i < pixelCount; ++i)
+	{
+		const __m128 v = Lanes< From >::toFloat(_mm_shuffle_epi8(loadPixel(src, ss), srcShuffle));
+		storePixel(dst, _mm_shuffle_epi8(Lanes< To >::fromFloat(v), dstShuffle), ds);
+		src += ss;
+		dst += ds;
+	}
+}
+
+const PixelFormatConvert::kernel_fn_t c_vectorKernels[3][3] =
+{
+	{ &convertVector< Element::Byte, Element::Byte >, &convertVector< Element::Byte, Element::Half >, &convertVector< Element::Byte, Element::Float > },
+	{ &convertVector< Element::Half, Element::Byte >, &convertVector< Element::Half, Element::Half >, &convertVector< Element::Half, Element::Float > },
+	{ &convertVector< Element::Float, Element::Byte >, &convertVector< Element::Float, Element::Half >, &convertVector< Element::Float, Element::Float > }
+};
+
+#endif
+
+}
+
+bool PixelFormatConvert::select(const PixelFormat& from, const PixelFormat& to)
+{
+	Layout s, d;
+	if (!classify(from, s) || !classify(to, d))
+		return false;
+
+	srcByteSize = from.getByteSize();
+	dstByteSize = to.getByteSize();
+
+	// Source elements into RGBA lanes; missing elements are zero.
+	const int32_t ses = elementSize(s.element);
+	std::memset(srcShuffle, 0x80, sizeof(srcShuffle));
+	for (int32_t i = 0; i < 4; ++i)
+	{
+		for (int32_t j = 0; s.channel[i] >= 0 && j < ses; ++j)
+			srcShuffle[i * 4 + j] = (uint8_t)(s.channel[i] * ses + j);
+	}
+
+	// RGBA lanes into destination elements; bytes are already packed into lowest four bytes.
+	const int32_t des = elementSize(d.element);
+	const int32_t stride = (d.element == Element::Byte) ? 1 : 4;
+	std::memset(dstShuffle, 0x80, sizeof(dstShuffle));
+	for (int32_t i = 0; i < 4; ++i)
+	{
+		for (int32_t j = 0; d.channel[i] >= 0 && j < des; ++j)
+			dstShuffle[d.channel[i] * des + j] = (uint8_t)(i * stride + j);
+	}
+
+	// Four source pixels directly into four destination pixels.
+	std::memset(shuffle4, 0x80, sizeof(shuffle4));
+	if (s.element == Element::Byte && d.element == Element::Byte)
+	{
+		for (int32_t p = 0; p < 4; ++p)
+		{
+			for (int32_t i = 0; i < 4; ++i)
+			{
+				if (d.channel[i] >= 0 && s.channel[i] >= 0)
+					shuffle4[p * dstByteSize + d.channel[i]] = (uint8_t)(p * srcByteSize + s.channel[i]);
+			}
+		}
+	}
+
+	if (
+		s.element == d.element &&
+		srcByteSize == dstByteSize &&
+		std::memcmp(s.channel, d.channel, sizeof(s.channel)) == 0
+	)
+		kernel = &convertCopy;
+	else if (s.element == Element::Byte && d.element == Element::Byte)
+		kernel = &convertShuffle;
+	else
+	{
+#if defined(T_MATH_USE_SSE2)
+		kernel = c_vectorKernels[(int32_t)s.element][(int32_t)d.element];
+#else
+		kernel = nullptr;
+#endif
+	}
+
+	return kernel != nullptr;
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Config.h"
+
+namespace traktor::drawing
+{
+
+class PixelFormat;
+
+/*! Specialized pixel conversion kernel.
+ * \ingroup Drawing
+ *
+ * Kernels cover formats where each channel is either
+ * a full byte, a half or a single precision float; such
+ * formats are converted using shuffles instead of
+ * unpacking each channel separately.
+ */
+struct PixelFormatConvert
+{
+	typedef void (*kernel_fn_t)(const PixelFormatConvert& convert, const uint8_t* src, uint8_t* dst, int32_t pixelCount);
+
+	kernel_fn_t kernel = nullptr;
+	int32_t srcByteSize = 0;
+	int32_t dstByteSize = 0;
+	uint8_t srcShuffle[16];		//!< Shuffle source pixel bytes into 32-bit RGBA lanes.
+	uint8_t dstShuffle[16];		//!< Shuffle RGBA lanes into destination pixel bytes.
+	uint8_t shuffle4[16];		//!< Shuffle four source pixels into four destination pixels, byte formats only.
+
+	/*! Select kernel for conversion between two formats.
+	 *
+	 * \param from Source pixel format.
+	 * \param to Destination pixel format.
+	 * \return True if a specialized kernel exist.
+	 */
+	bool select(const PixelFormat& from, const PixelFormat& to);
+
+	/*! Convert pixels; source and destination may be same memory if pixel sizes match. */
+	void operator () (const void* src, void* dst, int32_t pixelCount) const
+	{
+		(*kernel)(*this, static_cast< const uint8_t* >(src), static_cast< uint8_t* >(dst), pixelCount);
+	}
+};
+
+}
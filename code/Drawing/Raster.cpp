@@ -59,6 +59,8 @@ class IRasterImpl : public IRefCount
 public:
 	virtual void setMask(Image* image) = 0;
 
+	virtual void setClipRect(int32_t x0, int32_t y0, int32_t x1, int32_t y1) = 0;
+
 	virtual void clearStyles() = 0;
 
 	virtual int32_t defineSolidStyle(const Color4f& color) = 0;
@@ -103,6 +105,9 @@ class IStyle
 public:
 	virtual ~IStyle() = default;
 
+	/*! Return true, and color, if style is a single color; solid spans are blended without generating span. */
+	virtual bool isSolid(color_type& outColor) const { return false; }
+
 	virtual void generateSpan(color_type* span, int x, int y, unsigned len) const = 0;
 };
 
@@ -120,6 +125,12 @@ public:
 	{
 	}
 
+	virtual bool isSolid(agg::gray8& outColor) const override final
+	{
+		outColor = m_color;
+		return true;
+	}
+
 	virtual void generateSpan(agg::gray8* span, int x, int y, unsigned len) const override final
 	{
 		for (unsigned i = 0; i < len; ++i)
@@ -145,6 +156,12 @@ public:
 	{
 	}
 
+	virtual bool isSolid(agg::rgba8& outColor) const override final
+	{
+		outColor = m_color;
+		return true;
+	}
+
 	virtual void generateSpan(agg::rgba8* span, int x, int y, unsigned len) const override final
 	{
 		for (unsigned i = 0; i < len; ++i)
@@ -368,13 +385,15 @@ public:
 
 	bool is_solid(unsigned style) const
 	{
-		return false;
+		agg::gray8 c;
+		return m_styles[style]->isSolid(c);
 	}
 
 	agg::gray8 color(unsigned style) const
 	{
-		T_FATAL_ERROR;
-		return agg::gray8();
+		agg::gray8 c;
+		m_styles[style]->isSolid(c);
+		return c;
 	}
 
     void generate_span(agg::gray8* span, int x, int y, unsigned len, unsigned style)
@@ -432,13 +451,15 @@ public:
 
 	bool is_solid(unsigned style) const
 	{
-		return false;
+		agg::rgba8 c;
+		return m_styles[style]->isSolid(c);
 	}
 
 	agg::rgba8 color(unsigned style) const
 	{
-		T_FATAL_ERROR;
-		return agg::rgba8();
+		agg::rgba8 c;
+		m_styles[style]->isSolid(c);
+		return c;
 	}
 
 	void generate_span(agg::rgba8* span, int x, int y, unsigned len, unsigned style)
@@ -467,6 +488,12 @@ public:
 		m_mask = image;
 	}
 
+	virtual void setClipRect(int32_t x0, int32_t y0, int32_t x1, int32_t y1) override final
+	{
+		m_renderer.clip_box(x0, y0, x1 - 1, y1 - 1);
+		m_rasterizer.clip_box(x0, y0, x1, y1);
+	}
+
 	virtual void clearStyles() override final
 	{
 		m_styleHandler.clearStyles();
@@ -698,6 +725,11 @@ void Raster::setMask(Image* image)
 	m_impl->setMask(image);
 }
 
+void Raster::setClipRect(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+	m_impl->setClipRect(x0, y0, x1, y1);
+}
+
 void Raster::clearStyles()
 {
 	m_impl->clearStyles();
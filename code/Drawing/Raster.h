@@ -71,6 +71,19 @@ public:
 
 	void setMask(Image* image);
 
+	/*! Set clip rectangle, in pixels.
+	 *
+	 * Nothing outside of rectangle is rendered, geometry
+	 * is clipped before rasterization. Clip rectangle
+	 * is reset when image is changed.
+	 *
+	 * \param x0 Left edge.
+	 * \param y0 Top edge.
+	 * \param x1 Right edge, exclusive.
+	 * \param y1 Bottom edge, exclusive.
+	 */
+	void setClipRect(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+
 	void clearStyles();
 
 	int32_t defineSolidStyle(const Color4f& color);
@@ -0,0 +1,60 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Drawing/Test/CaseChainFilter.h"
+
+#include "Core/Math/Random.h"
+#include "Drawing/Image.h"
+#include "Drawing/PixelFormat.h"
+#include "Drawing/Filters/BrightnessContrastFilter.h"
+#include "Drawing/Filters/ChainFilter.h"
+#include "Drawing/Filters/GammaFilter.h"
+#include "Drawing/Filters/GrayscaleFilter.h"
+
+#include <cstring>
+
+namespace traktor::drawing::test
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.drawing.test.CaseChainFilter", 0, CaseChainFilter, traktor::test::Case)
+
+void CaseChainFilter::run()
+{
+	const int32_t width = 512;
+	const int32_t height = 512;
+
+	Random random;
+	Ref< Image > source = new Image(PixelFormat::getR8G8B8A8(), width, height);
+	uint8_t* data = (uint8_t*)source->getData();
+	for (int32_t i = 0; i < width * height * 4; ++i)
+		data[i] = (uint8_t)(random.next() & 255);
+
+	Ref< IImageFilter > filters[] =
+	{
+		new GammaFilter(1.0f, 2.2f),
+		new BrightnessContrastFilter(0.1f, 1.3f),
+		new GrayscaleFilter()
+	};
+
+	// Consecutive span filters are fused in a chain; output must
+	// be quantized between filters as when applied one by one.
+	Ref< Image > separate = source->clone();
+	for (auto filter : filters)
+		separate->apply(filter);
+
+	Ref< ChainFilter > chainFilter = new ChainFilter();
+	for (auto filter : filters)
+		chainFilter->add(filter);
+
+	Ref< Image > chained = source->clone();
+	chained->apply(chainFilter);
+
+	CASE_ASSERT(std::memcmp(chained->getData(), separate->getData(), width * height * 4) == 0);
+}
+
+}
@@ -0,0 +1,112 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Drawing/Test/CasePixelFormatConvert.h"
+
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Half.h"
+#include "Core/Math/Random.h"
+#include "Core/Timer/Timer.h"
+#include "Drawing/PixelFormat.h"
+
+#include <cstring>
+
+namespace traktor::drawing::test
+{
+namespace
+{
+
+const int32_t c_pixelCount = 1024 * 1024;
+const int32_t c_shortSpan = 15;		//!< Shorter than any span converted by specialized kernels.
+
+struct ConvertPair
+{
+	const wchar_t* name;
+	const PixelFormat& from;
+	const PixelFormat& into;
+};
+
+/*! Fill source pixels; floats are generated as values, slightly out of range, so no NaN is produced. */
+void fillPixels(const PixelFormat& pf, AlignedVector< uint8_t >& outPixels, Random& random)
+{
+	outPixels.resize(c_pixelCount * pf.getByteSize());
+	if (pf.isFloatPoint() && pf.getRedBits() == 16)
+	{
+		half_t* p = (half_t*)outPixels.ptr();
+		for (int32_t i = 0; i < (int32_t)(outPixels.size() / sizeof(half_t)); ++i)
+			p[i] = floatToHalf(random.nextFloat() * 1.5f - 0.25f);
+	}
+	else if (pf.isFloatPoint())
+	{
+		float* p = (float*)outPixels.ptr();
+		for (int32_t i = 0; i < (int32_t)(outPixels.size() / sizeof(float)); ++i)
+			p[i] = random.nextFloat() * 1.5f - 0.25f;
+	}
+	else
+	{
+		for (auto& p : outPixels)
+			p = (uint8_t)(random.next() & 255);
+	}
+}
+
+/*! Convert all pixels in spans of given length, return time in seconds. */
+double convertSpans(const ConvertPair& pair, const uint8_t* src, uint8_t* dst, int32_t span)
+{
+	const int32_t ss = pair.from.getByteSize();
+	const int32_t ds = pair.into.getByteSize();
+
+	Timer timer;
+	for (int32_t i = 0; i < c_pixelCount; i += span)
+	{
+		const int32_t count = std::min(span, c_pixelCount - i);
+		pair.from.convert(nullptr, src + i * ss, pair.into, nullptr, dst + i * ds, count);
+	}
+	return timer.getElapsedTime();
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.drawing.test.CasePixelFormatConvert", 0, CasePixelFormatConvert, traktor::test::Case)
+
+void CasePixelFormatConvert::run()
+{
+	const ConvertPair pairs[] =
+	{
+		{ L"RGBA8->BGRA8", PixelFormat::getR8G8B8A8(), PixelFormat::getB8G8R8A8() },
+		{ L"R8G8B8->A8R8G8B8", PixelFormat::getR8G8B8(), PixelFormat::getA8R8G8B8() },
+		{ L"A8R8G8B8->R8G8B8", PixelFormat::getA8R8G8B8(), PixelFormat::getR8G8B8() },
+		{ L"A8R8G8B8->RGBAF32", PixelFormat::getA8R8G8B8(), PixelFormat::getRGBAF32() },
+		{ L"RGBAF32->A8B8G8R8", PixelFormat::getRGBAF32(), PixelFormat::getA8B8G8R8() },
+		{ L"RGBAF16->RGBAF32", PixelFormat::getRGBAF16(), PixelFormat::getRGBAF32() },
+		{ L"RGBAF32->RGBAF16", PixelFormat::getRGBAF32(), PixelFormat::getRGBAF16() },
+		{ L"ARGBF32->RGBAF32", PixelFormat::getARGBF32(), PixelFormat::getRGBAF32() },
+		{ L"A8->A8R8G8B8", PixelFormat::getA8(), PixelFormat::getA8R8G8B8() }
+	};
+
+	Random random;
+	AlignedVector< uint8_t > src;
+	AlignedVector< uint8_t > dstShort;
+	AlignedVector< uint8_t > dstLong;
+
+	for (const auto& pair : pairs)
+	{
+		fillPixels(pair.from, src, random);
+		dstShort.resize(c_pixelCount * pair.into.getByteSize());
+		dstLong.resize(c_pixelCount * pair.into.getByteSize());
+
+		// Converted result must not depend on span length.
+		const double shortTime = convertSpans(pair, src.c_ptr(), dstShort.ptr(), c_shortSpan);
+		const double longTime = convertSpans(pair, src.c_ptr(), dstLong.ptr(), c_pixelCount);
+		CASE_ASSERT(std::memcmp(dstShort.c_ptr(), dstLong.c_ptr(), dstLong.size()) == 0);
+
+		log::info << L"Pixel format convert, " << pair.name << L"; " << int32_t(c_pixelCount / (shortTime * 1e6)) << L" Mpix/s (short spans), " << int32_t(c_pixelCount / (longTime * 1e6)) << L" Mpix/s" << Endl;
+	}
+}
+
+}
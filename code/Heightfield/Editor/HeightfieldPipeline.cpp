@@ -10,6 +10,7 @@
 #include "Core/Io/Writer.h"
 #include "Core/Log/Log.h"
 #include "Core/Serialization/DeepHash.h"
+#include "Core/Settings/PropertyInteger.h"
 #include "Core/Settings/PropertyString.h"
 #include "Database/Instance.h"
 #include "Editor/IPipelineBuilder.h"
@@ -25,11 +26,13 @@
 namespace traktor::hf
 {
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.HeightfieldPipeline", 2, HeightfieldPipeline, editor::IPipeline)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.HeightfieldPipeline", 3, HeightfieldPipeline, editor::IPipeline)
 
 bool HeightfieldPipeline::create(const editor::IPipelineSettings* settings, db::Database* database)
 {
 	m_assetPath = settings->getPropertyExcludeHash< std::wstring >(L"Pipeline.AssetPath", L"");
+	m_tileSize = settings->getPropertyIncludeHash< int32_t >(L"HeightfieldPipeline.TileSize", 256);
+	m_quantization = settings->getPropertyIncludeHash< int32_t >(L"HeightfieldPipeline.Quantization", 0);
 	return true;
 }
 
@@ -123,7 +126,12 @@ bool HeightfieldPipeline::buildOutput(
 		return false;
 	}
 
-	HeightfieldFormat().write(outputData, heightfield);
+	if (!HeightfieldFormat().writeTiled(outputData, heightfield, m_tileSize, m_quantization))
+	{
+		log::error << L"Heightfield pipeline failed; unable to write tiled heights." << Endl;
+		instance->revert();
+		return false;
+	}
 
 	outputData->close();
 	outputData = nullptr;
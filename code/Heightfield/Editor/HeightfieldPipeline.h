@@ -65,6 +65,8 @@ public:
 
 private:
 	std::wstring m_assetPath;
+	int32_t m_tileSize = 256;
+	int32_t m_quantization = 0;
 };
 
 }
@@ -8,10 +8,15 @@
  */
 #include "Heightfield/Heightfield.h"
 
-#include "Core/Math/Winding3.h"
+#include "Core/Math/Const.h"
+#include "Core/Math/Float.h"
+#include "Core/Thread/Job.h"
+#include "Core/Thread/JobManager.h"
+#include "Heightfield/HeightfieldTileCache.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <limits>
 
 namespace traktor::hf
@@ -19,8 +24,37 @@ namespace traktor::hf
 namespace
 {
 
-constexpr int32_t c_cellSize = 64;
-constexpr int32_t c_skip = 1;
+constexpr int32_t c_leafSize = 4;			//!< Number of grid quads, in each direction, covered by a node in first pyramid level.
+constexpr int32_t c_maxTraversal = 128;		//!< Size of ray traversal stack.
+constexpr uint32_t c_raysPerJob = 256;		//!< Number of rays traced by each job in a batched query.
+constexpr int32_t c_residencyRadius = 1;	//!< Number of tiles, around position, kept resident in streamed heightfields.
+
+/*! Ray/triangle intersection; both sides, only in front of origin. */
+bool intersectTriangle(const Vector4& origin, const Vector4& direction, const Vector4& v0, const Vector4& v1, const Vector4& v2, Scalar& outK)
+{
+	const Vector4 e1 = v1 - v0;
+	const Vector4 e2 = v2 - v0;
+	const Vector4 p = cross(direction, e2);
+
+	const Scalar det = dot3(e1, p);
+	if (abs(det) <= Scalar(FUZZY_EPSILON))
+		return false;
+
+	const Scalar invDet = 1.0_simd / det;
+	const Vector4 t = origin - v0;
+
+	const Scalar u = dot3(t, p) * invDet;
+	if (u < 0.0_simd || u > 1.0_simd)
+		return false;
+
+	const Vector4 q = cross(t, e1);
+	const Scalar v = dot3(direction, q) * invDet;
+	if (v < 0.0_simd || u + v > 1.0_simd)
+		return false;
+
+	outK = dot3(e2, q) * invDet;
+	return outK > 0.0_simd;
+}
 
 }
 
@@ -32,18 +66,30 @@ Heightfield::Heightfield(
 	: m_size(size)
 	, m_worldExtent(worldExtent)
 {
-	m_cellBoundsPitch = (m_size + c_cellSize - 1) / c_cellSize;
-
 	m_heights.reset(new height_t[m_size * m_size]);
 	m_cuts.reset(new uint8_t[(m_size * m_size) / 8]);
 	m_attributes.reset(new uint8_t[m_size * m_size]);
-	m_cellBounds.reset(new Aabb3[m_cellBoundsPitch * m_cellBoundsPitch]);
+	m_worldExtent.storeUnaligned(m_worldExtentFloats);
+	createPyramid();
+}
 
+Heightfield::Heightfield(
+	int32_t size,
+	const Vector4& worldExtent,
+	HeightfieldTileCache* tileCache)
+	: m_size(size)
+	, m_worldExtent(worldExtent)
+	, m_tileCache(tileCache)
+	, m_pyramidTileLevel(tileCache->getPyramidLevels() - 1)
+{
 	m_worldExtent.storeUnaligned(m_worldExtentFloats);
+	createPyramid();
 }
 
 void Heightfield::setGridHeight(int32_t gridX, int32_t gridZ, float unitY)
 {
+	T_ASSERT_M (!m_tileCache, L"Streamed heightfield cannot be modified");
+
 	if (gridX < 0 || gridX >= (int32_t)m_size)
 		return;
 	if (gridZ < 0 || gridZ >= (int32_t)m_size)
@@ -53,6 +99,8 @@ void Heightfield::setGridHeight(int32_t gridX, int32_t gridZ, float unitY)
 
 void Heightfield::setGridCut(int32_t gridX, int32_t gridZ, bool cut)
 {
+	T_ASSERT_M (!m_tileCache, L"Streamed heightfield cannot be modified");
+
 	if (gridX < 0 || gridX >= (int32_t)m_size)
 		return;
 	if (gridZ < 0 || gridZ >= (int32_t)m_size)
@@ -67,6 +115,8 @@ void Heightfield::setGridCut(int32_t gridX, int32_t gridZ, bool cut)
 
 void Heightfield::setGridAttribute(int32_t gridX, int32_t gridZ, uint8_t attribute)
 {
+	T_ASSERT_M (!m_tileCache, L"Streamed heightfield cannot be modified");
+
 	if (gridX < 0 || gridX >= (int32_t)m_size)
 		return;
 	if (gridZ < 0 || gridZ >= (int32_t)m_size)
@@ -88,7 +138,9 @@ float Heightfield::getGridHeightNearest(int32_t gridX, int32_t gridZ) const
 	else if (gridZ >= (int32_t)m_size)
 		gridZ = (int32_t)m_size - 1;
 
-	return m_heights[gridX + gridZ * m_size] / 65535.0f;
+	HeightfieldTileCache::TileRef tile;
+	int32_t pitch;
+	return *getHeightsAt(gridX, gridZ, pitch, tile) / 65535.0f;
 }
 
 float Heightfield::getGridHeightBilinear(float gridX, float gridZ) const
@@ -106,13 +158,15 @@ float Heightfield::getGridHeightBilinear(float gridX, float gridZ) const
 	else if (igridZ >= (int32_t)m_size - 1)
 		igridZ = (int32_t)m_size - 2;
 
-	const int32_t offset = igridX + igridZ * m_size;
+	HeightfieldTileCache::TileRef tile;
+	int32_t pitch;
+	const height_t* heights = getHeightsAt(igridX, igridZ, pitch, tile);
 
 	height_t hts[] = {
-		m_heights[offset],
-		m_heights[offset + 1],
-		m_heights[offset + m_size],
-		m_heights[offset + 1 + m_size]
+		heights[0],
+		heights[1],
+		heights[pitch],
+		heights[1 + pitch]
 	};
 
 	const float fgridX = gridX - igridX;
@@ -178,6 +232,33 @@ float Heightfield::getWorldHeight(float worldX, float worldZ) const
 	return -m_worldExtentFloats[1] * 0.5f + gridY * m_worldExtentFloats[1];
 }
 
+void Heightfield::getWorldHeights(const Vector4* worldPositions, float* outWorldHeights, uint32_t count) const
+{
+	const Scalar size((float)m_size);
+	const Scalar extentX(m_worldExtentFloats[0]);
+	const Scalar extentZ(m_worldExtentFloats[2]);
+	const float wexy = m_worldExtentFloats[1];
+
+	// Convert four positions at once into grid space; same
+	// operations as worldToGrid thus results are identical.
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const Vector4 worldX(worldPositions[i].x(), worldPositions[i + 1].x(), worldPositions[i + 2].x(), worldPositions[i + 3].x());
+		const Vector4 worldZ(worldPositions[i].z(), worldPositions[i + 1].z(), worldPositions[i + 2].z(), worldPositions[i + 3].z());
+
+		float T_MATH_ALIGN16 gridX[4];
+		float T_MATH_ALIGN16 gridZ[4];
+		((size * ((worldX - Scalar(0.5f)) + extentX * Scalar(0.5f))) / extentX).storeAligned(gridX);
+		((size * ((worldZ - Scalar(0.5f)) + extentZ * Scalar(0.5f))) / extentZ).storeAligned(gridZ);
+
+		for (uint32_t j = 0; j < 4; ++j)
+			outWorldHeights[i + j] = -wexy * 0.5f + getGridHeightBilinear(gridX[j], gridZ[j]) * wexy;
+	}
+	for (; i < count; ++i)
+		outWorldHeights[i] = getWorldHeight(worldPositions[i].x(), worldPositions[i].z());
+}
+
 bool Heightfield::getGridCut(int32_t gridX, int32_t gridZ) const
 {
 	if (gridX < 0)
@@ -190,6 +271,15 @@ bool Heightfield::getGridCut(int32_t gridX, int32_t gridZ) const
 	else if (gridZ >= (int32_t)m_size)
 		gridZ = (int32_t)m_size - 1;
 
+	if (m_tileCache)
+	{
+		const int32_t tileSize = m_tileCache->getTileSize();
+		const int32_t tileX = gridX / tileSize;
+		const int32_t tileZ = gridZ / tileSize;
+		const int32_t local = (gridX - tileX * tileSize) + (gridZ - tileZ * tileSize) * tileSize;
+		return (m_tileCache->acquire(tileX, tileZ)->cuts[local / 8] & (1 << (local & 7))) != 0;
+	}
+
 	const int32_t offset = gridX + gridZ * m_size;
 	return (m_cuts[offset / 8] & (1 << (offset & 7))) != 0;
 }
@@ -213,6 +303,15 @@ uint8_t Heightfield::getGridAttribute(int32_t gridX, int32_t gridZ) const
 	else if (gridZ >= (int32_t)m_size)
 		gridZ = (int32_t)m_size - 1;
 
+	if (m_tileCache)
+	{
+		const int32_t tileSize = m_tileCache->getTileSize();
+		const int32_t tileX = gridX / tileSize;
+		const int32_t tileZ = gridZ / tileSize;
+		const int32_t local = (gridX - tileX * tileSize) + (gridZ - tileZ * tileSize) * tileSize;
+		return m_tileCache->acquire(tileX, tileZ)->attributes[local];
+	}
+
 	const int32_t offset = gridX + gridZ * m_size;
 	return m_attributes[offset];
 }
@@ -323,90 +422,151 @@ Vector4 Heightfield::normalAt(float gridX, float gridZ) const
 
 bool Heightfield::queryRay(const Vector4& worldRayOrigin, const Vector4& worldRayDirection, Scalar& outDistance) const
 {
-	Scalar k;
-	Scalar kIn, kOut;
+	struct Traversal
+	{
+		int32_t level;
+		int32_t nodeX;
+		int32_t nodeZ;
+		float distance;
+	};
 
-	const Aabb3 boundingBox(-m_worldExtent * 0.5_simd, m_worldExtent * 0.5_simd);
-	if (!boundingBox.intersectRay(worldRayOrigin, worldRayDirection, kIn, kOut))
-		return false;
+	const int32_t topLevel = (int32_t)m_pyramidSizes.size() - 1;
 
-	bool foundIntersection = false;
+	Scalar kIn, kOut;
+	if (!getPyramidBounds(topLevel, 0, 0).intersectRay(worldRayOrigin, worldRayDirection, kIn, kOut) || kOut < 0.0_simd)
+		return false;
 
 	outDistance = Scalar(std::numeric_limits< float >::max());
 
-	for (int32_t cz = 0; cz < m_size; cz += c_cellSize)
+	// Traverse pyramid front to back, nodes further away than
+	// closest intersection found so far are skipped.
+	Traversal stack[c_maxTraversal];
+	int32_t depth = 0;
+	stack[depth++] = { topLevel, 0, 0, std::max< float >(kIn, 0.0f) };
+
+	bool foundIntersection = false;
+	while (depth > 0)
 	{
-		for (int32_t cx = 0; cx < m_size; cx += c_cellSize)
+		const Traversal node = stack[--depth];
+		if (node.distance >= (float)outDistance)
+			continue;
+
+		// Trace triangles of all quads in leaf node; there is one
+		// quad less than vertices in each direction.
+		if (node.level == 0)
 		{
-			// First check cell bounding box before finding more refined intersection.
-			const int32_t icx = gridToCell(cx);
-			const int32_t icz = gridToCell(cz);
-			const Aabb3& bb = m_cellBounds[icx + icz * m_cellBoundsPitch];
+			const int32_t qx0 = node.nodeX * c_leafSize;
+			const int32_t qz0 = node.nodeZ * c_leafSize;
+			const int32_t qx1 = std::min(qx0 + c_leafSize, m_size - 1);
+			const int32_t qz1 = std::min(qz0 + c_leafSize, m_size - 1);
+			for (int32_t iz = qz0; iz < qz1; ++iz)
+			{
+				for (int32_t ix = qx0; ix < qx1; ++ix)
+					foundIntersection |= queryRayQuad(worldRayOrigin, worldRayDirection, ix, iz, outDistance);
+			}
+			continue;
+		}
 
-			// Check if ray intersect bounding box; skip tracing triangles if not.
-			if (!bb.intersectRay(worldRayOrigin, worldRayDirection, kIn, kOut))
-				continue;
+		// Gather intersecting child nodes.
+		const int32_t childLevel = node.level - 1;
+		const int32_t childSize = m_pyramidSizes[childLevel];
 
-			// Construct and trace triangles.
-			for (int32_t iz = cz; iz <= cz + c_cellSize; iz += c_skip)
-			{
-				for (int32_t ix = cx; ix <= cx + c_cellSize; ix += c_skip)
-				{
-					float x1w, z1w;
-					float x2w, z2w;
-
-					gridToWorld(float(ix), float(iz), x1w, z1w);
-					gridToWorld(float(ix + c_skip), float(iz + c_skip), x2w, z2w);
-
-					const float yw[] = {
-						unitToWorld(getGridHeightNearest(ix, iz)),
-						unitToWorld(getGridHeightNearest(ix + c_skip, iz)),
-						unitToWorld(getGridHeightNearest(ix, iz + c_skip)),
-						unitToWorld(getGridHeightNearest(ix + c_skip, iz + c_skip))
-					};
-
-					const Vector4 vw[] = {
-						Vector4(x1w, yw[0], z1w, 1.0f),
-						Vector4(x2w, yw[1], z1w, 1.0f),
-						Vector4(x1w, yw[2], z2w, 1.0f),
-						Vector4(x2w, yw[3], z2w, 1.0f)
-					};
-
-					if (Winding3(vw[0], vw[1], vw[2]).rayIntersection(worldRayOrigin, worldRayDirection, k))
-					{
-						if (k < outDistance)
-						{
-							outDistance = k;
-							foundIntersection = true;
-						}
-					}
+		Traversal children[4];
+		int32_t childCount = 0;
 
-					if (Winding3(vw[1], vw[3], vw[2]).rayIntersection(worldRayOrigin, worldRayDirection, k))
-					{
-						if (k < outDistance)
-						{
-							outDistance = k;
-							foundIntersection = true;
-						}
-					}
-				}
+		for (int32_t dz = 0; dz < 2; ++dz)
+		{
+			const int32_t childZ = node.nodeZ * 2 + dz;
+			if (childZ >= childSize)
+				break;
+
+			for (int32_t dx = 0; dx < 2; ++dx)
+			{
+				const int32_t childX = node.nodeX * 2 + dx;
+				if (childX >= childSize)
+					break;
+
+				if (!getPyramidBounds(childLevel, childX, childZ).intersectRay(worldRayOrigin, worldRayDirection, kIn, kOut) || kOut < 0.0_simd)
+					continue;
+
+				const float distance = std::max< float >(kIn, 0.0f);
+				if (distance >= (float)outDistance)
+					continue;
+
+				// Keep children sorted far to near so nearest is popped first.
+				int32_t i = childCount++;
+				for (; i > 0 && children[i - 1].distance < distance; --i)
+					children[i] = children[i - 1];
+				children[i] = { childLevel, childX, childZ, distance };
 			}
 		}
+
+		T_FATAL_ASSERT(depth + childCount <= c_maxTraversal);
+		for (int32_t i = 0; i < childCount; ++i)
+			stack[depth++] = children[i];
 	}
 
 	return foundIntersection;
 }
 
-int32_t Heightfield::gridToCell(int32_t grid) const
+uint32_t Heightfield::queryRays(const Ray3* worldRays, Scalar* outDistances, uint32_t count) const
 {
-	return grid / c_cellSize;
+	std::atomic< uint32_t > intersectionCount(0);
+
+	auto trace = [&](uint32_t from, uint32_t to) {
+		uint32_t intersections = 0;
+		for (uint32_t i = from; i < to; ++i)
+		{
+			if (queryRay(worldRays[i].origin, worldRays[i].direction, outDistances[i]))
+				++intersections;
+			else
+				outDistances[i] = Scalar(std::numeric_limits< float >::max());
+		}
+		intersectionCount += intersections;
+	};
+
+	if (count <= c_raysPerJob)
+	{
+		trace(0, count);
+		return intersectionCount;
+	}
+
+	AlignedVector< Job::task_t > jobs;
+	for (uint32_t i = 0; i < count; i += c_raysPerJob)
+	{
+		const uint32_t to = std::min(i + c_raysPerJob, count);
+		jobs.push_back([=, &trace](){ trace(i, to); });
+	}
+	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+
+	return intersectionCount;
+}
+
+void Heightfield::updateResidency(const Vector4& worldPosition)
+{
+	if (!m_tileCache)
+		return;
+
+	int32_t gridX, gridZ;
+	worldToGrid(worldPosition.x(), worldPosition.z(), gridX, gridZ);
+
+	const int32_t tileSize = m_tileCache->getTileSize();
+	const int32_t tileCount = m_tileCache->getTileCount();
+	m_tileCache->updateResidency(
+		clamp(gridX / tileSize, 0, tileCount - 1),
+		clamp(gridZ / tileSize, 0, tileCount - 1),
+		c_residencyRadius
+	);
+}
+
+int32_t Heightfield::getPyramidLeafSize()
+{
+	return c_leafSize;
 }
 
 void Heightfield::updateCellBounds()
 {
-	for (int32_t cz = 0; cz < m_size; cz += c_cellSize)
-		for (int32_t cx = 0; cx < m_size; cx += c_cellSize)
-			updateCellBounds(cx, cz);
+	updatePyramid(0, 0, m_size - 1, m_size - 1);
 }
 
 void Heightfield::updateCellBounds(int32_t gridX, int32_t gridZ)
@@ -414,47 +574,232 @@ void Heightfield::updateCellBounds(int32_t gridX, int32_t gridZ)
 	if (gridX < 0 || gridZ < 0 || gridX >= m_size || gridZ >= m_size)
 		return;
 
-	const int32_t icx = gridToCell(gridX);
-	const int32_t icz = gridToCell(gridZ);
+	// Grid point is a corner in all four surrounding quads.
+	updatePyramid(gridX - 1, gridZ - 1, gridX, gridZ);
+}
 
-	const int32_t cx = icx * c_cellSize;
-	const int32_t cz = icz * c_cellSize;
+void Heightfield::updateCellBounds(int32_t gridX0, int32_t gridY0, int32_t gridX1, int32_t gridY1)
+{
+	updatePyramid(gridX0 - 1, gridY0 - 1, gridX1, gridY1);
+}
 
-	// Calculate bounding box of cell.
-	float cx1w, cz1w;
-	float cx2w, cz2w;
+void Heightfield::updatePyramid(int32_t quadX0, int32_t quadZ0, int32_t quadX1, int32_t quadZ1)
+{
+	quadX0 = clamp(quadX0, 0, m_size - 1);
+	quadZ0 = clamp(quadZ0, 0, m_size - 1);
+	quadX1 = clamp(quadX1, 0, m_size - 1);
+	quadZ1 = clamp(quadZ1, 0, m_size - 1);
+
+	// Streamed heightfields are immutable, only levels from tile
+	// level are stored and those are initialized from tile directory.
+	if (m_tileCache)
+	{
+		const int32_t tileSize = m_tileCache->getTileSize();
+		const int32_t tileCount = m_tileCache->getTileCount();
+		height_t* level = m_pyramid.ptr() + m_pyramidOffsets[m_pyramidTileLevel];
+		T_FATAL_ASSERT(m_pyramidSizes[m_pyramidTileLevel] == tileCount);
 
-	gridToWorld(float(cx), float(cz), cx1w, cz1w);
-	gridToWorld(float(cx + c_cellSize), float(cz + c_cellSize), cx2w, cz2w);
+		for (int32_t tz = quadZ0 / tileSize; tz <= quadZ1 / tileSize; ++tz)
+		{
+			for (int32_t tx = quadX0 / tileSize; tx <= quadX1 / tileSize; ++tx)
+			{
+				height_t* node = level + (tx + tz * tileCount) * 2;
+				m_tileCache->getTileBounds(tx, tz, node[0], node[1]);
+			}
+		}
+	}
 
-	float cy1w = std::numeric_limits< float >::max();
-	float cy2w = -std::numeric_limits< float >::max();
+	int32_t nodeX0 = (quadX0 / c_leafSize) >> m_pyramidTileLevel;
+	int32_t nodeZ0 = (quadZ0 / c_leafSize) >> m_pyramidTileLevel;
+	int32_t nodeX1 = (quadX1 / c_leafSize) >> m_pyramidTileLevel;
+	int32_t nodeZ1 = (quadZ1 / c_leafSize) >> m_pyramidTileLevel;
 
-	for (int32_t iz = cz; iz <= cz + c_cellSize; iz += c_skip)
+	// Update min/max of leaf nodes from heights.
+	if (!m_tileCache)
 	{
-		for (int32_t ix = cx; ix <= cx + c_cellSize; ix += c_skip)
+		height_t* level = m_pyramid.ptr() + m_pyramidOffsets[0];
+		const int32_t levelSize = m_pyramidSizes[0];
+
+		for (int32_t nz = nodeZ0; nz <= nodeZ1; ++nz)
 		{
-			const float wy = unitToWorld(getGridHeightNearest(ix, iz));
-			cy1w = std::min(cy1w, wy);
-			cy2w = std::max(cy2w, wy);
+			for (int32_t nx = nodeX0; nx <= nodeX1; ++nx)
+			{
+				// Node cover vertices of all its quads, thus one
+				// more vertex than number of quads in each direction.
+				const int32_t gx0 = nx * c_leafSize;
+				const int32_t gz0 = nz * c_leafSize;
+				const int32_t gx1 = std::min(gx0 + c_leafSize, m_size - 1);
+				const int32_t gz1 = std::min(gz0 + c_leafSize, m_size - 1);
+
+				height_t mn = std::numeric_limits< height_t >::max();
+				height_t mx = 0;
+				for (int32_t gz = gz0; gz <= gz1; ++gz)
+				{
+					const height_t* heights = m_heights.c_ptr() + gz * m_size;
+					for (int32_t gx = gx0; gx <= gx1; ++gx)
+					{
+						mn = std::min(mn, heights[gx]);
+						mx = std::max(mx, heights[gx]);
+					}
+				}
+
+				height_t* node = level + (nx + nz * levelSize) * 2;
+				node[0] = mn;
+				node[1] = mx;
+			}
+		}
+	}
+
+	// Propagate into coarser levels.
+	for (int32_t i = m_pyramidTileLevel + 1; i < (int32_t)m_pyramidSizes.size(); ++i)
+	{
+		const height_t* childLevel = m_pyramid.c_ptr() + m_pyramidOffsets[i - 1];
+		const int32_t childLevelSize = m_pyramidSizes[i - 1];
+
+		height_t* level = m_pyramid.ptr() + m_pyramidOffsets[i];
+		const int32_t levelSize = m_pyramidSizes[i];
+
+		nodeX0 /= 2;
+		nodeZ0 /= 2;
+		nodeX1 /= 2;
+		nodeZ1 /= 2;
+
+		for (int32_t nz = nodeZ0; nz <= nodeZ1; ++nz)
+		{
+			for (int32_t nx = nodeX0; nx <= nodeX1; ++nx)
+			{
+				height_t mn = std::numeric_limits< height_t >::max();
+				height_t mx = 0;
+				for (int32_t cz = nz * 2; cz < std::min(nz * 2 + 2, childLevelSize); ++cz)
+				{
+					for (int32_t cx = nx * 2; cx < std::min(nx * 2 + 2, childLevelSize); ++cx)
+					{
+						const height_t* child = childLevel + (cx + cz * childLevelSize) * 2;
+						mn = std::min(mn, child[0]);
+						mx = std::max(mx, child[1]);
+					}
+				}
+
+				height_t* node = level + (nx + nz * levelSize) * 2;
+				node[0] = mn;
+				node[1] = mx;
+			}
 		}
 	}
+}
 
-	Aabb3& bb = m_cellBounds[icx + icz * m_cellBoundsPitch];
-	bb.mn = Vector4(cx1w, cy1w, cz1w, 1.0f);
-	bb.mx = Vector4(cx2w, cy2w, cz2w, 1.0f);
+void Heightfield::createPyramid()
+{
+	// Allocate min/max pyramid, halving number of nodes in each
+	// direction for each level until a single node remain; levels
+	// stored in tiles are not allocated.
+	int32_t pyramidSize = 0;
+	for (int32_t levelSize = (m_size + c_leafSize - 1) / c_leafSize; ; levelSize = (levelSize + 1) / 2)
+	{
+		const bool stored = (int32_t)m_pyramidSizes.size() >= m_pyramidTileLevel;
+		m_pyramidOffsets.push_back(pyramidSize);
+		m_pyramidSizes.push_back(levelSize);
+		if (stored)
+			pyramidSize += levelSize * levelSize * 2;
+		if (levelSize <= 1 && (int32_t)m_pyramidSizes.size() > m_pyramidTileLevel)
+			break;
+	}
+	m_pyramid.reset(new height_t[pyramidSize]);
+	std::memset(m_pyramid.ptr(), 0, pyramidSize * sizeof(height_t));
 }
 
-void Heightfield::updateCellBounds(int32_t gridX0, int32_t gridY0, int32_t gridX1, int32_t gridY1)
+const height_t* Heightfield::getHeightsAt(int32_t gridX, int32_t gridZ, int32_t& outPitch, HeightfieldTileCache::TileRef& outTile) const
 {
-	gridX0 = gridToCell(gridX0) * c_cellSize;
-	gridY0 = gridToCell(gridY0) * c_cellSize;
-	gridX1 = gridToCell(gridX1) * c_cellSize;
-	gridY1 = gridToCell(gridY1) * c_cellSize;
+	if (m_tileCache)
+	{
+		// Tiles share last row and column with neighbours thus
+		// next row and column are always within same tile.
+		const int32_t tileSize = m_tileCache->getTileSize();
+		const int32_t tileX = gridX / tileSize;
+		const int32_t tileZ = gridZ / tileSize;
+		outPitch = tileSize + 1;
+		outTile = m_tileCache->acquire(tileX, tileZ);
+		return outTile->heights.c_ptr() + (gridX - tileX * tileSize) + (gridZ - tileZ * tileSize) * outPitch;
+	}
+	outPitch = m_size;
+	return m_heights.c_ptr() + gridX + gridZ * m_size;
+}
 
-	for (int32_t y = gridY0; y <= gridY1; y += c_cellSize)
-		for (int32_t x = gridX0; x <= gridX1; x += c_cellSize)
-			updateCellBounds(x, y);
+const height_t* Heightfield::getPyramidNode(int32_t level, int32_t nodeX, int32_t nodeZ, HeightfieldTileCache::TileRef& outTile) const
+{
+	if (level < m_pyramidTileLevel)
+	{
+		const int32_t shift = m_pyramidTileLevel - level;
+		const int32_t tileX = nodeX >> shift;
+		const int32_t tileZ = nodeZ >> shift;
+		const int32_t localX = nodeX - (tileX << shift);
+		const int32_t localZ = nodeZ - (tileZ << shift);
+		outTile = m_tileCache->acquire(tileX, tileZ);
+		return outTile->pyramid.c_ptr() + m_tileCache->getPyramidOffset(level) + (localX + localZ * m_tileCache->getPyramidSize(level)) * 2;
+	}
+	return m_pyramid.c_ptr() + m_pyramidOffsets[level] + (nodeX + nodeZ * m_pyramidSizes[level]) * 2;
+}
+
+Aabb3 Heightfield::getPyramidBounds(int32_t level, int32_t nodeX, int32_t nodeZ) const
+{
+	HeightfieldTileCache::TileRef tile;
+	const height_t* node = getPyramidNode(level, nodeX, nodeZ, tile);
+	const int32_t span = c_leafSize << level;
+
+	const int32_t gx0 = nodeX * span;
+	const int32_t gz0 = nodeZ * span;
+	const int32_t gx1 = std::min(gx0 + span, m_size);
+	const int32_t gz1 = std::min(gz0 + span, m_size);
+
+	float x0w, z0w;
+	float x1w, z1w;
+	gridToWorld(gx0, gz0, x0w, z0w);
+	gridToWorld(gx1, gz1, x1w, z1w);
+
+	return Aabb3(
+		Vector4(x0w, unitToWorld(node[0] / 65535.0f), z0w, 1.0f),
+		Vector4(x1w, unitToWorld(node[1] / 65535.0f), z1w, 1.0f)
+	);
+}
+
+bool Heightfield::queryRayQuad(const Vector4& worldRayOrigin, const Vector4& worldRayDirection, int32_t quadX, int32_t quadZ, Scalar& inOutDistance) const
+{
+	float x1w, z1w;
+	float x2w, z2w;
+
+	gridToWorld(quadX, quadZ, x1w, z1w);
+	gridToWorld(quadX + 1, quadZ + 1, x2w, z2w);
+
+	const float yw[] = {
+		unitToWorld(getGridHeightNearest(quadX, quadZ)),
+		unitToWorld(getGridHeightNearest(quadX + 1, quadZ)),
+		unitToWorld(getGridHeightNearest(quadX, quadZ + 1)),
+		unitToWorld(getGridHeightNearest(quadX + 1, quadZ + 1))
+	};
+
+	const Vector4 vw[] = {
+		Vector4(x1w, yw[0], z1w, 1.0f),
+		Vector4(x2w, yw[1], z1w, 1.0f),
+		Vector4(x1w, yw[2], z2w, 1.0f),
+		Vector4(x2w, yw[3], z2w, 1.0f)
+	};
+
+	bool foundIntersection = false;
+	Scalar k;
+
+	if (intersectTriangle(worldRayOrigin, worldRayDirection, vw[0], vw[1], vw[2], k) && k < inOutDistance)
+	{
+		inOutDistance = k;
+		foundIntersection = true;
+	}
+
+	if (intersectTriangle(worldRayOrigin, worldRayDirection, vw[1], vw[3], vw[2], k) && k < inOutDistance)
+	{
+		inOutDistance = k;
+		foundIntersection = true;
+	}
+
+	return foundIntersection;
 }
 
 }
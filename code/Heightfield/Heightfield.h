@@ -8,9 +8,13 @@
  */
 #pragma once
 
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Aabb3.h"
+#include "Core/Math/Ray3.h"
 #include "Core/Misc/AutoPtr.h"
 #include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Heightfield/HeightfieldTileCache.h"
 #include "Heightfield/HeightfieldTypes.h"
 
 // import/export mechanism.
@@ -36,6 +40,17 @@ public:
 		int32_t size,
 		const Vector4& worldExtent);
 
+	/*! Create streamed heightfield.
+	 *
+	 * Heights, cuts and attributes are paged in from tile
+	 * cache on demand; streamed heightfields cannot be modified
+	 * and raw arrays are not available.
+	 */
+	explicit Heightfield(
+		int32_t size,
+		const Vector4& worldExtent,
+		HeightfieldTileCache* tileCache);
+
 	void setGridHeight(int32_t gridX, int32_t gridZ, float unitY);
 
 	void setGridCut(int32_t gridX, int32_t gridZ, bool cut);
@@ -44,12 +59,20 @@ public:
 
 	float getGridHeightNearest(int32_t gridX, int32_t gridZ) const;
 
-	float getGridHeightNearestUnsafe(int32_t gridX, int32_t gridZ) const { return m_heights[gridX + gridZ * m_size] / 65535.0f; }
+	float getGridHeightNearestUnsafe(int32_t gridX, int32_t gridZ) const { HeightfieldTileCache::TileRef tile; int32_t pitch; return *getHeightsAt(gridX, gridZ, pitch, tile) / 65535.0f; }
 
 	float getGridHeightBilinear(float gridX, float gridZ) const;
 
 	float getWorldHeight(float worldX, float worldZ) const;
 
+	/*! Get world height at many points at once.
+	 *
+	 * \param worldPositions World positions, only X and Z are used.
+	 * \param outWorldHeights Output world heights, one for each position.
+	 * \param count Number of positions.
+	 */
+	void getWorldHeights(const Vector4* worldPositions, float* outWorldHeights, uint32_t count) const;
+
 	bool getGridCut(int32_t gridX, int32_t gridZ) const;
 
 	bool getWorldCut(float worldX, float worldZ) const;
@@ -76,6 +99,17 @@ public:
 
 	bool queryRay(const Vector4& worldRayOrigin, const Vector4& worldRayDirection, Scalar& outDistance) const;
 
+	/*! Query many rays at once.
+	 *
+	 * Large batches are split and traced concurrently.
+	 *
+	 * \param worldRays World rays.
+	 * \param outDistances Output distance for each ray, max float if ray doesn't intersect.
+	 * \param count Number of rays.
+	 * \return Number of rays intersecting heightfield.
+	 */
+	uint32_t queryRays(const Ray3* worldRays, Scalar* outDistances, uint32_t count) const;
+
 	int32_t getSize() const { return m_size; }
 
 	const Vector4& getWorldExtent() const { return m_worldExtent; }
@@ -92,23 +126,59 @@ public:
 
 	const uint8_t* getAttributes() const { return m_attributes.c_ptr(); }
 
-	int32_t gridToCell(int32_t grid) const;
+	/*! True if heightfield is paged in from a tile cache. */
+	bool isStreamed() const { return m_tileCache != nullptr; }
+
+	HeightfieldTileCache* getTileCache() const { return m_tileCache; }
+
+	/*! Make tiles around world position resident, no-op if heightfield isn't streamed. */
+	void updateResidency(const Vector4& worldPosition);
+
+	/*! Number of grid quads, in each direction, of a pyramid leaf node. */
+	static int32_t getPyramidLeafSize();
 
+	/*! Update min/max height pyramid of entire heightfield. */
 	void updateCellBounds();
 
+	/*! Update min/max height pyramid around grid point. */
 	void updateCellBounds(int32_t gridX, int32_t gridZ);
 
+	/*! Update min/max height pyramid of grid region. */
 	void updateCellBounds(int32_t gridX0, int32_t gridY0, int32_t gridX1, int32_t gridY1);
 
 private:
 	int32_t m_size;
-	int32_t m_cellBoundsPitch;
 	Vector4 m_worldExtent;
 	float m_worldExtentFloats[4];
 	AutoArrayPtr< height_t > m_heights;
 	AutoArrayPtr< uint8_t > m_cuts;
 	AutoArrayPtr< uint8_t > m_attributes;
-	AutoArrayPtr< Aabb3 > m_cellBounds;
+	Ref< HeightfieldTileCache > m_tileCache;
+
+	/*! Min/max height pyramid.
+	 *
+	 * Level 0 contain min and max height of each block of 4x4 grid
+	 * quads, each following level contain min and max of 2x2 nodes of previous
+	 * level; last level is a single node covering entire heightfield.
+	 * Streamed heightfields only store levels from tile level,
+	 * finer levels are stored in each tile.
+	 */
+	AutoArrayPtr< height_t > m_pyramid;
+	AlignedVector< int32_t > m_pyramidOffsets;
+	AlignedVector< int32_t > m_pyramidSizes;
+	int32_t m_pyramidTileLevel = 0;
+
+	void createPyramid();
+
+	const height_t* getHeightsAt(int32_t gridX, int32_t gridZ, int32_t& outPitch, HeightfieldTileCache::TileRef& outTile) const;
+
+	const height_t* getPyramidNode(int32_t level, int32_t nodeX, int32_t nodeZ, HeightfieldTileCache::TileRef& outTile) const;
+
+	void updatePyramid(int32_t quadX0, int32_t quadZ0, int32_t quadX1, int32_t quadZ1);
+
+	Aabb3 getPyramidBounds(int32_t level, int32_t nodeX, int32_t nodeZ) const;
+
+	bool queryRayQuad(const Vector4& worldRayOrigin, const Vector4& worldRayDirection, int32_t quadX, int32_t quadZ, Scalar& inOutDistance) const;
 };
 
 }
@@ -15,9 +15,20 @@
 
 namespace traktor::hf
 {
+	namespace
+	{
+
+const uint32_t c_maxResidentTiles = 64;
+
+	}
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.HeightfieldFactory", 0, HeightfieldFactory, resource::IResourceFactory)
 
+HeightfieldFactory::HeightfieldFactory(bool editor)
+:	m_editor(editor)
+{
+}
+
 bool HeightfieldFactory::initialize(const ObjectStore& objectStore)
 {
 	return true;
@@ -48,9 +59,19 @@ Ref< Object > HeightfieldFactory::create(resource::IResourceManager* resourceMan
 	if (!stream)
 		return nullptr;
 
-	Ref< Heightfield > heightfield = HeightfieldFormat().read(stream, resource->getWorldExtent());
+	// Editor tools modify heights thus editor always read entire heightfield.
+	if (m_editor)
+	{
+		Ref< Heightfield > heightfield = HeightfieldFormat().read(stream, resource->getWorldExtent());
+		stream->close();
+		return heightfield;
+	}
+
+	// Tiled heightfields keep stream open to page in tiles on demand.
+	Ref< Heightfield > heightfield = HeightfieldFormat().readStreamed(stream, resource->getWorldExtent(), c_maxResidentTiles);
+	if (!heightfield || !heightfield->isStreamed())
+		stream->close();
 
-	stream->close();
 	return heightfield;
 }
 
@@ -23,12 +23,20 @@ namespace traktor::hf
 
 /*!
  * \ingroup Heightfield
+ *
+ * Tiled heightfields are streamed at runtime; editor
+ * factory always load heightfields fully resident since
+ * editor tools modify heights in place.
  */
 class T_DLLCLASS HeightfieldFactory : public resource::IResourceFactory
 {
 	T_RTTI_CLASS;
 
 public:
+	HeightfieldFactory() = default;
+
+	explicit HeightfieldFactory(bool editor);
+
 	virtual bool initialize(const ObjectStore& objectStore) override final;
 
 	virtual const TypeInfoSet getResourceTypes() const override final;
@@ -40,6 +48,9 @@ public:
 	virtual Ref< Object > create(resource::IResourceManager* resourceManager, const db::Database* database, const db::Instance* instance, const TypeInfo& productType, const Object* current) const override final;
 
 	virtual void destroy(Object* resource) const override final;
+
+private:
+	bool m_editor = false;
 };
 
 }
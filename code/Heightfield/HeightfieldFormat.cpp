@@ -6,12 +6,16 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include <cstring>
+#include <limits>
 #include "Core/Io/IStream.h"
 #include "Core/Io/Reader.h"
 #include "Core/Io/Writer.h"
+#include "Core/Log/Log.h"
 #include "Heightfield/Heightfield.h"
 #include "Heightfield/HeightfieldFormat.h"
+#include "Heightfield/HeightfieldTileCache.h"
 
 namespace traktor::hf
 {
@@ -19,18 +23,122 @@ namespace traktor::hf
 	{
 
 const int32_t c_version = 2;
+const int32_t c_versionTiled = 3;
+const size_t c_residualGroupSize = 16;	//!< Number of height residuals sharing same bit width.
 
+/*! LOCO-I median edge predictor. */
+int32_t predict(int32_t left, int32_t up, int32_t upLeft)
+{
+	if (upLeft >= std::max(left, up))
+		return std::min(left, up);
+	else if (upLeft <= std::min(left, up))
+		return std::max(left, up);
+	else
+		return left + up - upLeft;
+}
+
+void writeVarUInt(AlignedVector< uint8_t >& out, uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back(uint8_t(value | 0x80));
+		value >>= 7;
 	}
+	out.push_back(uint8_t(value));
+}
 
-T_IMPLEMENT_RTTI_CLASS(L"traktor.hf.HeightfieldFormat", HeightfieldFormat, Object)
+bool readVarUInt(const uint8_t*& data, const uint8_t* end, uint32_t& outValue)
+{
+	outValue = 0;
+	for (int32_t shift = 0; shift < 32; shift += 7)
+	{
+		if (data >= end)
+			return false;
+		const uint8_t b = *data++;
+		outValue |= uint32_t(b & 0x7f) << shift;
+		if ((b & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
 
-Ref< Heightfield > HeightfieldFormat::read(IStream* stream, const Vector4& worldExtent) const
+/*! Pack residuals in groups, each group prefixed with bit width of group's largest residual. */
+void packResiduals(const AlignedVector< uint32_t >& residuals, AlignedVector< uint8_t >& out)
 {
-	int32_t version;
-	Reader(stream) >> version;
+	uint64_t bits = 0;
+	int32_t count = 0;
+
+	auto put = [&](uint32_t value, int32_t width) {
+		bits |= uint64_t(value) << count;
+		count += width;
+		for (; count >= 8; count -= 8)
+		{
+			out.push_back(uint8_t(bits));
+			bits >>= 8;
+		}
+	};
+
+	for (size_t i = 0; i < residuals.size(); i += c_residualGroupSize)
+	{
+		const size_t n = std::min(c_residualGroupSize, residuals.size() - i);
+
+		uint32_t mx = 0;
+		for (size_t j = 0; j < n; ++j)
+			mx |= residuals[i + j];
+
+		int32_t width = 0;
+		while ((mx >> width) != 0)
+			++width;
+
+		put(width, 5);
+		for (size_t j = 0; j < n; ++j)
+			put(residuals[i + j], width);
+	}
+
+	if (count > 0)
+		out.push_back(uint8_t(bits));
+}
+
+bool unpackResiduals(const uint8_t*& data, const uint8_t* end, uint32_t* outResiduals, size_t residualCount)
+{
+	uint64_t bits = 0;
+	int32_t count = 0;
+
+	auto get = [&](int32_t width, uint32_t& outValue) {
+		for (; count < width; count += 8)
+		{
+			if (data >= end)
+				return false;
+			bits |= uint64_t(*data++) << count;
+		}
+		outValue = uint32_t(bits & ((uint64_t(1) << width) - 1));
+		bits >>= width;
+		count -= width;
+		return true;
+	};
+
+	for (size_t i = 0; i < residualCount; i += c_residualGroupSize)
+	{
+		const size_t n = std::min(c_residualGroupSize, residualCount - i);
+
+		uint32_t width;
+		if (!get(5, width) || width > 17)
+			return false;
+
+		for (size_t j = 0; j < n; ++j)
+		{
+			if (!get((int32_t)width, outResiduals[i + j]))
+				return false;
+		}
+	}
+
+	return true;
+}
 
-	if (version != 1 && version != 2)
-		return 0;
+Ref< Heightfield > readResident(IStream* stream, int32_t version, const Vector4& worldExtent)
+{
+	if (version != 1 && version != 2 && version != c_versionTiled)
+		return nullptr;
 
 	int32_t size;
 	Reader(stream) >> size;
@@ -42,18 +150,75 @@ Ref< Heightfield > HeightfieldFormat::read(IStream* stream, const Vector4& world
 
 	height_t* heights = heightfield->getHeights();
 	T_ASSERT_M (heights, L"No heights in heightfield");
-	Reader(stream).read(heights, size * size, sizeof(height_t));
 
 	uint8_t* cuts = heightfield->getCuts();
 	T_ASSERT_M (cuts, L"No cuts in heightfield");
-	Reader(stream).read(cuts, size * size / 8, sizeof(uint8_t));
 
 	uint8_t* attributes = heightfield->getAttributes();
 	T_ASSERT_M (attributes, L"No attributes in heightfield");
-	if (version == 2)
-		Reader(stream).read(attributes, size * size, sizeof(uint8_t));
+
+	if (version == c_versionTiled)
+	{
+		int32_t tileSize;
+		Reader(stream) >> tileSize;
+
+		const int32_t tileCount = (size + tileSize - 1) / tileSize;
+
+		AlignedVector< HeightfieldTileCache::TileEntry > directory(tileCount * tileCount);
+		for (auto& entry : directory)
+			Reader(stream) >> entry.offset >> entry.size >> entry.minHeight >> entry.maxHeight;
+
+		// Tiles are stored in directory order; decode each tile and copy into heightfield.
+		AlignedVector< uint8_t > data;
+		AutoArrayPtr< height_t > tileHeights(new height_t[(tileSize + 1) * (tileSize + 1)]);
+		AutoArrayPtr< uint8_t > tileCuts(new uint8_t[(tileSize * tileSize) / 8]);
+		AutoArrayPtr< uint8_t > tileAttributes(new uint8_t[tileSize * tileSize]);
+
+		for (int32_t tz = 0; tz < tileCount; ++tz)
+		{
+			for (int32_t tx = 0; tx < tileCount; ++tx)
+			{
+				const auto& entry = directory[tx + tz * tileCount];
+
+				data.resize(entry.size);
+				if (stream->read(data.ptr(), entry.size) != entry.size)
+					return nullptr;
+
+				if (!HeightfieldFormat::decodeTile(data.c_ptr(), entry.size, tileSize, tileHeights.ptr(), tileCuts.ptr(), tileAttributes.ptr()))
+					return nullptr;
+
+				const int32_t w = std::min(tileSize, size - tx * tileSize);
+				const int32_t h = std::min(tileSize, size - tz * tileSize);
+				for (int32_t z = 0; z < h; ++z)
+				{
+					for (int32_t x = 0; x < w; ++x)
+					{
+						const int32_t gx = tx * tileSize + x;
+						const int32_t gz = tz * tileSize + z;
+						const int32_t offset = gx + gz * size;
+						const int32_t local = x + z * tileSize;
+
+						heights[offset] = tileHeights[x + z * (tileSize + 1)];
+						attributes[offset] = tileAttributes[local];
+
+						if ((tileCuts[local / 8] & (1 << (local & 7))) != 0)
+							cuts[offset / 8] |= (1 << (offset & 7));
+						else
+							cuts[offset / 8] &= ~(1 << (offset & 7));
+					}
+				}
+			}
+		}
+	}
 	else
-		std::memset(attributes, 0, size * size * sizeof(uint8_t));
+	{
+		Reader(stream).read(heights, size * size, sizeof(height_t));
+		Reader(stream).read(cuts, size * size / 8, sizeof(uint8_t));
+		if (version == 2)
+			Reader(stream).read(attributes, size * size, sizeof(uint8_t));
+		else
+			std::memset(attributes, 0, size * size * sizeof(uint8_t));
+	}
 
 	heightfield->updateCellBounds();
 
@@ -61,8 +226,45 @@ Ref< Heightfield > HeightfieldFormat::read(IStream* stream, const Vector4& world
 	return heightfield;
 }
 
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.hf.HeightfieldFormat", HeightfieldFormat, Object)
+
+Ref< Heightfield > HeightfieldFormat::read(IStream* stream, const Vector4& worldExtent) const
+{
+	int32_t version;
+	Reader(stream) >> version;
+	return readResident(stream, version, worldExtent);
+}
+
+Ref< Heightfield > HeightfieldFormat::readStreamed(IStream* stream, const Vector4& worldExtent, uint32_t maxResidentTiles) const
+{
+	int32_t version;
+	Reader(stream) >> version;
+
+	if (version != c_versionTiled || !stream->canSeek())
+		return readResident(stream, version, worldExtent);
+
+	int32_t size, tileSize;
+	Reader(stream) >> size >> tileSize;
+
+	Ref< HeightfieldTileCache > tileCache = new HeightfieldTileCache();
+	if (!tileCache->create(stream, size, tileSize, Heightfield::getPyramidLeafSize(), maxResidentTiles))
+		return nullptr;
+
+	Ref< Heightfield > heightfield = new Heightfield(
+		size,
+		worldExtent,
+		tileCache
+	);
+	heightfield->updateCellBounds();
+	return heightfield;
+}
+
 bool HeightfieldFormat::write(IStream* stream, const Heightfield* heightfield) const
 {
+	T_ASSERT_M (!heightfield->isStreamed(), L"Cannot write streamed heightfield");
+
 	Writer(stream) << int32_t(c_version);
 	Writer(stream) << int32_t(heightfield->getSize());
 
@@ -87,4 +289,229 @@ bool HeightfieldFormat::write(IStream* stream, const Heightfield* heightfield) c
 	return true;
 }
 
+bool HeightfieldFormat::writeTiled(IStream* stream, const Heightfield* heightfield, int32_t tileSize, int32_t quantization) const
+{
+	T_ASSERT_M (!heightfield->isStreamed(), L"Cannot write streamed heightfield");
+
+	if (tileSize < Heightfield::getPyramidLeafSize() || (tileSize & (tileSize - 1)) != 0)
+	{
+		log::error << L"Unable to write tiled heightfield; tile size must be a power of two." << Endl;
+		return false;
+	}
+
+	const int32_t size = heightfield->getSize();
+	const int32_t tileCount = (size + tileSize - 1) / tileSize;
+
+	// Encode all tiles first as directory is written before tile data.
+	AlignedVector< HeightfieldTileCache::TileEntry > directory(tileCount * tileCount);
+	AlignedVector< AlignedVector< uint8_t > > tileData(tileCount * tileCount);
+	uint32_t offset = 0;
+
+	for (int32_t tz = 0; tz < tileCount; ++tz)
+	{
+		for (int32_t tx = 0; tx < tileCount; ++tx)
+		{
+			const int32_t tileIndex = tx + tz * tileCount;
+			auto& entry = directory[tileIndex];
+
+			encodeTile(heightfield, tx, tz, tileSize, quantization, tileData[tileIndex], entry.minHeight, entry.maxHeight);
+
+			entry.offset = offset;
+			entry.size = (uint32_t)tileData[tileIndex].size();
+			offset += entry.size;
+		}
+	}
+
+	Writer w(stream);
+	w << int32_t(c_versionTiled);
+	w << int32_t(size);
+	w << int32_t(tileSize);
+	for (const auto& entry : directory)
+		w << entry.offset << entry.size << entry.minHeight << entry.maxHeight;
+
+	for (const auto& data : tileData)
+	{
+		if (w.write(data.c_ptr(), (int64_t)data.size()) != (int64_t)data.size())
+			return false;
+	}
+
+	return true;
+}
+
+void HeightfieldFormat::encodeTile(const Heightfield* heightfield, int32_t tileX, int32_t tileZ, int32_t tileSize, int32_t quantization, AlignedVector< uint8_t >& outData, height_t& outMinHeight, height_t& outMaxHeight)
+{
+	const height_t* heights = heightfield->getHeights();
+	const uint8_t* cuts = heightfield->getCuts();
+	const uint8_t* attributes = heightfield->getAttributes();
+	const int32_t size = heightfield->getSize();
+	const int32_t pitch = tileSize + 1;
+	const int32_t half = quantization > 0 ? (1 << (quantization - 1)) : 0;
+	const int32_t maxValue = 0xffff >> quantization;
+
+	// Quantize heights, tile include shared last row and column; outside
+	// of heightfield heights are clamped to edge.
+	AlignedVector< int32_t > values(pitch * pitch);
+	outMinHeight = std::numeric_limits< height_t >::max();
+	outMaxHeight = 0;
+	for (int32_t z = 0; z < pitch; ++z)
+	{
+		const int32_t gz = std::min(tileZ * tileSize + z, size - 1);
+		for (int32_t x = 0; x < pitch; ++x)
+		{
+			const int32_t gx = std::min(tileX * tileSize + x, size - 1);
+			const int32_t value = std::min((heights[gx + gz * size] + half) >> quantization, maxValue);
+			const height_t height = height_t((value << quantization) | half);
+			values[x + z * pitch] = value;
+			outMinHeight = std::min(outMinHeight, height);
+			outMaxHeight = std::max(outMaxHeight, height);
+		}
+	}
+
+	outData.reserve(pitch * pitch * 2);
+	outData.push_back(uint8_t(quantization));
+
+	// Heights; residual from predicted height, zig-zag encoded and bit packed.
+	AlignedVector< uint32_t > residuals(pitch * pitch);
+	for (int32_t z = 0; z < pitch; ++z)
+	{
+		for (int32_t x = 0; x < pitch; ++x)
+		{
+			int32_t predicted = 0;
+			if (z == 0)
+				predicted = (x > 0) ? values[x - 1] : 0;
+			else if (x == 0)
+				predicted = values[(z - 1) * pitch];
+			else
+				predicted = predict(values[x - 1 + z * pitch], values[x + (z - 1) * pitch], values[x - 1 + (z - 1) * pitch]);
+
+			const int32_t residual = values[x + z * pitch] - predicted;
+			residuals[x + z * pitch] = uint32_t((residual << 1) ^ (residual >> 31));
+		}
+	}
+	packResiduals(residuals, outData);
+
+	// Gather cuts and attributes of tile.
+	AlignedVector< uint8_t > tileCuts((tileSize * tileSize) / 8, uint8_t(0));
+	AlignedVector< uint8_t > tileAttributes(tileSize * tileSize);
+	for (int32_t z = 0; z < tileSize; ++z)
+	{
+		const int32_t gz = std::min(tileZ * tileSize + z, size - 1);
+		for (int32_t x = 0; x < tileSize; ++x)
+		{
+			const int32_t gx = std::min(tileX * tileSize + x, size - 1);
+			const int32_t offset = gx + gz * size;
+			const int32_t local = x + z * tileSize;
+			if ((cuts[offset / 8] & (1 << (offset & 7))) != 0)
+				tileCuts[local / 8] |= (1 << (local & 7));
+			tileAttributes[local] = attributes[offset];
+		}
+	}
+
+	// Cuts; most tiles are either entirely uncut or entirely cut.
+	if (std::all_of(tileCuts.begin(), tileCuts.end(), [](uint8_t c) { return c == 0xff; }))
+		outData.push_back(0);
+	else if (std::all_of(tileCuts.begin(), tileCuts.end(), [](uint8_t c) { return c == 0x00; }))
+		outData.push_back(1);
+	else
+	{
+		outData.push_back(2);
+		outData.insert(outData.end(), tileCuts.begin(), tileCuts.end());
+	}
+
+	// Attributes; run length encoded.
+	for (int32_t i = 0; i < tileSize * tileSize; )
+	{
+		const uint8_t attribute = tileAttributes[i];
+		int32_t run = 1;
+		while (i + run < tileSize * tileSize && tileAttributes[i + run] == attribute)
+			++run;
+		outData.push_back(attribute);
+		writeVarUInt(outData, uint32_t(run));
+		i += run;
+	}
+}
+
+bool HeightfieldFormat::decodeTile(const uint8_t* data, uint32_t dataSize, int32_t tileSize, height_t* outHeights, uint8_t* outCuts, uint8_t* outAttributes)
+{
+	const uint8_t* end = data + dataSize;
+	const int32_t pitch = tileSize + 1;
+
+	if (data >= end)
+		return false;
+
+	const int32_t quantization = *data++;
+	if (quantization > 15)
+		return false;
+
+	const int32_t half = quantization > 0 ? (1 << (quantization - 1)) : 0;
+
+	// Heights; decoded values are kept quantized until all rows has been predicted.
+	AlignedVector< uint32_t > residuals(pitch * pitch);
+	if (!unpackResiduals(data, end, residuals.ptr(), residuals.size()))
+		return false;
+
+	AlignedVector< int32_t > values(pitch * pitch);
+	for (int32_t z = 0; z < pitch; ++z)
+	{
+		for (int32_t x = 0; x < pitch; ++x)
+		{
+			int32_t predicted = 0;
+			if (z == 0)
+				predicted = (x > 0) ? values[x - 1] : 0;
+			else if (x == 0)
+				predicted = values[(z - 1) * pitch];
+			else
+				predicted = predict(values[x - 1 + z * pitch], values[x + (z - 1) * pitch], values[x - 1 + (z - 1) * pitch]);
+
+			const uint32_t zigzag = residuals[x + z * pitch];
+			const int32_t residual = int32_t(zigzag >> 1) ^ -int32_t(zigzag & 1);
+			values[x + z * pitch] = predicted + residual;
+			outHeights[x + z * pitch] = height_t((values[x + z * pitch] << quantization) | half);
+		}
+	}
+
+	// Cuts.
+	const int32_t cutsSize = (tileSize * tileSize) / 8;
+	if (data >= end)
+		return false;
+	switch (*data++)
+	{
+	case 0:
+		std::memset(outCuts, 0xff, cutsSize);
+		break;
+
+	case 1:
+		std::memset(outCuts, 0x00, cutsSize);
+		break;
+
+	case 2:
+		if (end - data < cutsSize)
+			return false;
+		std::memcpy(outCuts, data, cutsSize);
+		data += cutsSize;
+		break;
+
+	default:
+		return false;
+	}
+
+	// Attributes.
+	for (int32_t i = 0; i < tileSize * tileSize; )
+	{
+		if (data >= end)
+			return false;
+
+		const uint8_t attribute = *data++;
+
+		uint32_t run;
+		if (!readVarUInt(data, end, run) || run == 0 || run > uint32_t(tileSize * tileSize - i))
+			return false;
+
+		std::memset(outAttributes + i, attribute, run);
+		i += run;
+	}
+
+	return true;
+}
+
 }
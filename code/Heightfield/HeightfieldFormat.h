@@ -10,7 +10,9 @@
 
 #include "Core/Object.h"
 #include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Vector4.h"
+#include "Heightfield/HeightfieldTypes.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -33,9 +35,48 @@ class T_DLLCLASS HeightfieldFormat : public Object
 	T_RTTI_CLASS;
 
 public:
+	/*! Read entire heightfield, tiled heightfields are decoded into a fully resident heightfield. */
 	Ref< Heightfield > read(IStream* stream, const Vector4& worldExtent) const;
 
+	/*! Read heightfield with tiles paged in on demand.
+	 *
+	 * Stream is kept open by returned heightfield. Non-tiled
+	 * heightfields, or if stream isn't seekable, are read as
+	 * fully resident.
+	 *
+	 * \param stream Heightfield stream.
+	 * \param worldExtent Heightfield world extent.
+	 * \param maxResidentTiles Number of tiles kept resident.
+	 * eturn Heightfield.
+	 */
+	Ref< Heightfield > readStreamed(IStream* stream, const Vector4& worldExtent, uint32_t maxResidentTiles) const;
+
 	bool write(IStream* stream, const Heightfield* heightfield) const;
+
+	/*! Write tiled heightfield.
+	 *
+	 * \param stream Output stream.
+	 * \param heightfield Fully resident heightfield.
+	 * \param tileSize Number of grid points in each direction of a tile, must be power of two.
+	 * \param quantization Number of least significant height bits discarded.
+	 * eturn True if written successfully.
+	 */
+	bool writeTiled(IStream* stream, const Heightfield* heightfield, int32_t tileSize, int32_t quantization) const;
+
+	/*! Encode single tile. */
+	static void encodeTile(const Heightfield* heightfield, int32_t tileX, int32_t tileZ, int32_t tileSize, int32_t quantization, AlignedVector< uint8_t >& outData, height_t& outMinHeight, height_t& outMaxHeight);
+
+	/*! Decode single tile.
+	 *
+	 * \param data Encoded tile.
+	 * \param dataSize Size of encoded tile in bytes.
+	 * \param tileSize Number of grid points in each direction of a tile.
+	 * \param outHeights (tileSize + 1)^2 heights.
+	 * \param outCuts tileSize^2 cut bits.
+	 * \param outAttributes tileSize^2 attributes.
+	 * eturn True if decoded successfully.
+	 */
+	static bool decodeTile(const uint8_t* data, uint32_t dataSize, int32_t tileSize, height_t* outHeights, uint8_t* outCuts, uint8_t* outAttributes);
 };
 
 }
@@ -0,0 +1,326 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Heightfield/HeightfieldTileCache.h"
+
+#include "Core/Io/IStream.h"
+#include "Core/Io/Reader.h"
+#include "Core/Log/Log.h"
+#include "Core/Thread/Acquire.h"
+#include "Heightfield/HeightfieldFormat.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace traktor::hf
+{
+namespace
+{
+
+void buildTilePyramid(const height_t* heights, int32_t tileSize, int32_t leafSize, const AlignedVector< int32_t >& offsets, const AlignedVector< int32_t >& sizes, height_t* outPyramid)
+{
+	const int32_t pitch = tileSize + 1;
+
+	// Leaf nodes from heights; each node include shared last row and column.
+	for (int32_t nz = 0; nz < sizes[0]; ++nz)
+	{
+		for (int32_t nx = 0; nx < sizes[0]; ++nx)
+		{
+			height_t mn = std::numeric_limits< height_t >::max();
+			height_t mx = 0;
+			for (int32_t z = nz * leafSize; z <= (nz + 1) * leafSize; ++z)
+			{
+				for (int32_t x = nx * leafSize; x <= (nx + 1) * leafSize; ++x)
+				{
+					mn = std::min(mn, heights[x + z * pitch]);
+					mx = std::max(mx, heights[x + z * pitch]);
+				}
+			}
+			height_t* node = outPyramid + offsets[0] + (nx + nz * sizes[0]) * 2;
+			node[0] = mn;
+			node[1] = mx;
+		}
+	}
+
+	// Propagate into coarser levels.
+	for (int32_t i = 1; i < (int32_t)sizes.size(); ++i)
+	{
+		const height_t* childLevel = outPyramid + offsets[i - 1];
+		height_t* level = outPyramid + offsets[i];
+		for (int32_t nz = 0; nz < sizes[i]; ++nz)
+		{
+			for (int32_t nx = 0; nx < sizes[i]; ++nx)
+			{
+				const height_t* c0 = childLevel + (nx * 2 + nz * 2 * sizes[i - 1]) * 2;
+				const height_t* c1 = c0 + sizes[i - 1] * 2;
+				height_t* node = level + (nx + nz * sizes[i]) * 2;
+				node[0] = std::min(std::min(c0[0], c0[2]), std::min(c1[0], c1[2]));
+				node[1] = std::max(std::max(c0[1], c0[3]), std::max(c1[1], c1[3]));
+			}
+		}
+	}
+}
+
+}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.hf.HeightfieldTileCache", HeightfieldTileCache, Object)
+
+HeightfieldTileCache::~HeightfieldTileCache()
+{
+	destroy();
+}
+
+bool HeightfieldTileCache::create(IStream* stream, int32_t size, int32_t tileSize, int32_t pyramidLeafSize, uint32_t maxResidentTiles)
+{
+	if (!stream->canSeek())
+	{
+		log::error << L"Unable to create heightfield tile cache; stream must be seekable." << Endl;
+		return false;
+	}
+
+	if (tileSize < pyramidLeafSize || (tileSize & (tileSize - 1)) != 0)
+	{
+		log::error << L"Unable to create heightfield tile cache; invalid tile size " << tileSize << L"." << Endl;
+		return false;
+	}
+
+	m_stream = stream;
+	m_size = size;
+	m_tileSize = tileSize;
+	m_tileCount = (size + tileSize - 1) / tileSize;
+	m_pyramidLeafSize = pyramidLeafSize;
+	m_maxResidentTiles = std::max< uint32_t >(maxResidentTiles, 1);
+	m_clock = 0;
+	m_readers = 0;
+
+	// Read tile directory.
+	Reader reader(stream);
+	m_directory.resize(m_tileCount * m_tileCount);
+	for (auto& entry : m_directory)
+		reader >> entry.offset >> entry.size >> entry.minHeight >> entry.maxHeight;
+	m_tileDataOffset = stream->tell();
+
+	// Pyramid levels within a tile, from leaf nodes until a single node.
+	int32_t pyramidSize = 0;
+	for (int32_t levelSize = tileSize / pyramidLeafSize; levelSize >= 1; levelSize /= 2)
+	{
+		m_pyramidOffsets.push_back(pyramidSize);
+		m_pyramidSizes.push_back(levelSize);
+		pyramidSize += levelSize * levelSize * 2;
+	}
+
+	m_tiles.reset(new std::atomic< Tile* >[m_tileCount * m_tileCount]);
+	for (int32_t i = 0; i < m_tileCount * m_tileCount; ++i)
+		m_tiles[i] = nullptr;
+
+	return true;
+}
+
+void HeightfieldTileCache::destroy()
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	for (auto tileIndex : m_resident)
+		delete m_tiles[tileIndex].load();
+	for (auto tile : m_retired)
+		delete tile;
+
+	m_resident.clear();
+	m_retired.clear();
+	m_tiles.release();
+
+	if (m_stream)
+	{
+		m_stream->close();
+		m_stream = nullptr;
+	}
+}
+
+HeightfieldTileCache::TileRef HeightfieldTileCache::acquire(int32_t tileX, int32_t tileZ)
+{
+	const int32_t tileIndex = tileX + tileZ * m_tileCount;
+
+	// Fast path, tile already resident; readers count prevent evicted tiles
+	// from being deleted between loading tile pointer and pinning tile.
+	m_readers.fetch_add(1);
+	Tile* tile = m_tiles[tileIndex].load();
+	if (tile)
+		tile->pins.fetch_add(1);
+	m_readers.fetch_sub(1);
+
+	if (tile)
+	{
+		const uint32_t clock = m_clock.load(std::memory_order_relaxed);
+		if (tile->lastUsed.load(std::memory_order_relaxed) != clock)
+			tile->lastUsed.store(clock, std::memory_order_relaxed);
+		return TileRef(tile);
+	}
+
+	// Read and decode tile without holding cache lock; if another thread
+	// load same tile concurrently then only one of the tiles is kept.
+	Tile* loaded = load(tileIndex);
+	if (!loaded)
+	{
+		// Return a flat tile rather than nothing to keep accessors simple.
+		log::error << L"Unable to load heightfield tile " << tileX << L", " << tileZ << L"." << Endl;
+		loaded = createFlatTile();
+	}
+	loaded->lastUsed = ++m_clock;
+	loaded->pins = 1;
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	// Tiles are only evicted while holding lock thus safe to pin.
+	if ((tile = m_tiles[tileIndex].load()) != nullptr)
+	{
+		tile->pins.fetch_add(1);
+		delete loaded;
+		return TileRef(tile);
+	}
+
+	m_resident.push_back(tileIndex);
+	m_tiles[tileIndex].store(loaded);
+
+	evict(std::numeric_limits< uint32_t >::max());
+	deleteRetired();
+
+	return TileRef(loaded);
+}
+
+void HeightfieldTileCache::updateResidency(int32_t centerTileX, int32_t centerTileZ, int32_t radius)
+{
+	// Keep tiles used from this update and onward.
+	const uint32_t keepFrom = ++m_clock;
+
+	// Touch, and load if necessary, tiles surrounding center.
+	const int32_t tx0 = std::max(centerTileX - radius, 0);
+	const int32_t tz0 = std::max(centerTileZ - radius, 0);
+	const int32_t tx1 = std::min(centerTileX + radius, m_tileCount - 1);
+	const int32_t tz1 = std::min(centerTileZ + radius, m_tileCount - 1);
+	for (int32_t tz = tz0; tz <= tz1; ++tz)
+	{
+		for (int32_t tx = tx0; tx <= tx1; ++tx)
+			acquire(tx, tz);
+	}
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	evict(keepFrom);
+	deleteRetired();
+}
+
+void HeightfieldTileCache::getTileBounds(int32_t tileX, int32_t tileZ, height_t& outMinHeight, height_t& outMaxHeight) const
+{
+	const TileEntry& entry = m_directory[tileX + tileZ * m_tileCount];
+	outMinHeight = entry.minHeight;
+	outMaxHeight = entry.maxHeight;
+}
+
+uint32_t HeightfieldTileCache::getResidentCount() const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	return (uint32_t)m_resident.size();
+}
+
+uint64_t HeightfieldTileCache::getResidentMemory() const
+{
+	const uint64_t tileMemory =
+		(m_tileSize + 1) * (m_tileSize + 1) * sizeof(height_t) +
+		(m_tileSize * m_tileSize) / 8 +
+		m_tileSize * m_tileSize +
+		(m_pyramidOffsets.back() + 2) * sizeof(height_t) +
+		sizeof(Tile);
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	return (m_resident.size() + m_retired.size()) * tileMemory;
+}
+
+HeightfieldTileCache::Tile* HeightfieldTileCache::load(int32_t tileIndex)
+{
+	const TileEntry& entry = m_directory[tileIndex];
+
+	// Only reading from stream need to be serialized.
+	AlignedVector< uint8_t > buffer(entry.size);
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_streamLock);
+		if (m_stream->seek(IStream::SeekSet, m_tileDataOffset + entry.offset) < 0)
+			return nullptr;
+		if (m_stream->read(buffer.ptr(), entry.size) != entry.size)
+			return nullptr;
+	}
+
+	Tile* tile = new Tile();
+	tile->heights.reset(new height_t[(m_tileSize + 1) * (m_tileSize + 1)]);
+	tile->cuts.reset(new uint8_t[(m_tileSize * m_tileSize) / 8]);
+	tile->attributes.reset(new uint8_t[m_tileSize * m_tileSize]);
+	tile->pyramid.reset(new height_t[m_pyramidOffsets.back() + 2]);
+
+	if (!HeightfieldFormat::decodeTile(buffer.c_ptr(), entry.size, m_tileSize, tile->heights.ptr(), tile->cuts.ptr(), tile->attributes.ptr()))
+	{
+		delete tile;
+		return nullptr;
+	}
+
+	buildTilePyramid(tile->heights.c_ptr(), m_tileSize, m_pyramidLeafSize, m_pyramidOffsets, m_pyramidSizes, tile->pyramid.ptr());
+	return tile;
+}
+
+HeightfieldTileCache::Tile* HeightfieldTileCache::createFlatTile() const
+{
+	Tile* tile = new Tile();
+	tile->heights.reset(new height_t[(m_tileSize + 1) * (m_tileSize + 1)]);
+	tile->cuts.reset(new uint8_t[(m_tileSize * m_tileSize) / 8]);
+	tile->attributes.reset(new uint8_t[m_tileSize * m_tileSize]);
+	tile->pyramid.reset(new height_t[m_pyramidOffsets.back() + 2]);
+	std::fill_n(tile->heights.ptr(), (m_tileSize + 1) * (m_tileSize + 1), height_t(0));
+	std::fill_n(tile->cuts.ptr(), (m_tileSize * m_tileSize) / 8, uint8_t(0xff));
+	std::fill_n(tile->attributes.ptr(), m_tileSize * m_tileSize, uint8_t(0));
+	std::fill_n(tile->pyramid.ptr(), m_pyramidOffsets.back() + 2, height_t(0));
+	return tile;
+}
+
+void HeightfieldTileCache::evict(uint32_t keepFrom)
+{
+	if (m_resident.size() <= m_maxResidentTiles)
+		return;
+
+	// Evict least recently used tiles; pinned tiles and tiles
+	// used since keepFrom are kept.
+	std::sort(m_resident.begin(), m_resident.end(), [&](int32_t lh, int32_t rh) {
+		return m_tiles[lh].load(std::memory_order_relaxed)->lastUsed.load(std::memory_order_relaxed) > m_tiles[rh].load(std::memory_order_relaxed)->lastUsed.load(std::memory_order_relaxed);
+	});
+	for (int32_t i = (int32_t)m_resident.size() - 1; i >= 0 && m_resident.size() > m_maxResidentTiles; --i)
+	{
+		const int32_t tileIndex = m_resident[i];
+		Tile* tile = m_tiles[tileIndex].load(std::memory_order_relaxed);
+		if (tile->lastUsed.load(std::memory_order_relaxed) >= keepFrom)
+			break;
+		if (tile->pins.load() > 0)
+			continue;
+
+		m_tiles[tileIndex].store(nullptr);
+		m_retired.push_back(tile);
+		m_resident.erase(m_resident.begin() + i);
+	}
+}
+
+void HeightfieldTileCache::deleteRetired()
+{
+	// A reader might have loaded pointer to an evicted tile but not yet pinned it.
+	if (m_retired.empty() || m_readers.load() != 0)
+		return;
+
+	auto it = std::remove_if(m_retired.begin(), m_retired.end(), [](Tile* tile) {
+		if (tile->pins.load() > 0)
+			return false;
+		delete tile;
+		return true;
+	});
+	m_retired.erase(it, m_retired.end());
+}
+
+}
@@ -0,0 +1,209 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Misc/AutoPtr.h"
+#include "Core/Thread/Semaphore.h"
+#include "Heightfield/HeightfieldTypes.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_HEIGHTFIELD_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class IStream;
+
+}
+
+namespace traktor::hf
+{
+
+/*! Cache of resident heightfield tiles.
+ * \ingroup Heightfield
+ *
+ * Tiles are read and decoded from a tiled heightfield stream
+ * when first accessed. Residency is trimmed to budget, least
+ * recently used first, each time a tile is loaded and each
+ * time updateResidency is called.
+ *
+ * Tiles are pinned by references returned from acquire,
+ * pinned tiles are never evicted nor deleted.
+ */
+class T_DLLCLASS HeightfieldTileCache : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	struct Tile
+	{
+		AutoArrayPtr< height_t > heights;		//!< (tileSize + 1)^2 heights, last row and column shared with neighbour tiles.
+		AutoArrayPtr< uint8_t > cuts;			//!< tileSize^2 cut bits.
+		AutoArrayPtr< uint8_t > attributes;		//!< tileSize^2 attributes.
+		AutoArrayPtr< height_t > pyramid;		//!< Min/max pyramid levels within tile.
+		std::atomic< uint32_t > lastUsed = 0;
+		std::atomic< int32_t > pins = 0;
+	};
+
+	/*! Pinned tile reference. */
+	class TileRef
+	{
+	public:
+		TileRef() = default;
+
+		TileRef(const TileRef&) = delete;
+
+		TileRef(TileRef&& ref) noexcept
+		:	m_tile(ref.m_tile)
+		{
+			ref.m_tile = nullptr;
+		}
+
+		~TileRef()
+		{
+			release();
+		}
+
+		TileRef& operator = (const TileRef&) = delete;
+
+		TileRef& operator = (TileRef&& ref) noexcept
+		{
+			if (this != &ref)
+			{
+				release();
+				m_tile = ref.m_tile;
+				ref.m_tile = nullptr;
+			}
+			return *this;
+		}
+
+		const Tile* operator -> () const { return m_tile; }
+
+		const Tile* ptr() const { return m_tile; }
+
+	private:
+		friend class HeightfieldTileCache;
+
+		Tile* m_tile = nullptr;
+
+		/*! Take ownership of an already pinned tile. */
+		explicit TileRef(Tile* tile)
+		:	m_tile(tile)
+		{
+		}
+
+		void release()
+		{
+			if (m_tile)
+			{
+				m_tile->pins.fetch_sub(1, std::memory_order_release);
+				m_tile = nullptr;
+			}
+		}
+	};
+
+	/*! Tile directory entry. */
+	struct TileEntry
+	{
+		uint32_t offset;
+		uint32_t size;
+		height_t minHeight;
+		height_t maxHeight;
+	};
+
+	virtual ~HeightfieldTileCache();
+
+	/*! Create cache.
+	 *
+	 * \param stream Tiled heightfield stream, positioned at tile directory.
+	 * \param size Heightfield size.
+	 * \param tileSize Number of grid points in each direction of a tile.
+	 * \param pyramidLeafSize Number of grid quads, in each direction, of a pyramid leaf node.
+	 * \param maxResidentTiles Number of tiles kept resident after residency update.
+	 * \return True if cache created.
+	 */
+	bool create(IStream* stream, int32_t size, int32_t tileSize, int32_t pyramidLeafSize, uint32_t maxResidentTiles);
+
+	void destroy();
+
+	/*! Get pinned tile, read and decode tile if not resident.
+	 *
+	 * Tile is read and decoded without holding cache lock thus
+	 * other threads can access resident tiles meanwhile.
+	 */
+	TileRef acquire(int32_t tileX, int32_t tileZ);
+
+	/*! Make tiles around center resident and trim residency to budget.
+	 *
+	 * Tiles surrounding center are kept even if budget is
+	 * exceeded, should be called once per frame.
+	 *
+	 * \param centerTileX Center tile.
+	 * \param centerTileZ Center tile.
+	 * \param radius Number of tiles around center tile.
+	 */
+	void updateResidency(int32_t centerTileX, int32_t centerTileZ, int32_t radius);
+
+	/*! Get min/max height of tile from directory, doesn't require tile to be resident. */
+	void getTileBounds(int32_t tileX, int32_t tileZ, height_t& outMinHeight, height_t& outMaxHeight) const;
+
+	int32_t getTileSize() const { return m_tileSize; }
+
+	int32_t getTileCount() const { return m_tileCount; }
+
+	/*! Number of pyramid levels stored in each tile. */
+	int32_t getPyramidLevels() const { return (int32_t)m_pyramidSizes.size(); }
+
+	int32_t getPyramidOffset(int32_t level) const { return m_pyramidOffsets[level]; }
+
+	int32_t getPyramidSize(int32_t level) const { return m_pyramidSizes[level]; }
+
+	uint32_t getResidentCount() const;
+
+	/*! Memory, in bytes, used by resident tiles. */
+	uint64_t getResidentMemory() const;
+
+private:
+	Ref< IStream > m_stream;
+	int64_t m_tileDataOffset = 0;
+	int32_t m_size = 0;
+	int32_t m_tileSize = 0;
+	int32_t m_tileCount = 0;
+	int32_t m_pyramidLeafSize = 0;
+	uint32_t m_maxResidentTiles = 0;
+	AlignedVector< TileEntry > m_directory;
+	AlignedVector< int32_t > m_pyramidOffsets;
+	AlignedVector< int32_t > m_pyramidSizes;
+	AutoArrayPtr< std::atomic< Tile* > > m_tiles;
+	AlignedVector< int32_t > m_resident;
+	AlignedVector< Tile* > m_retired;
+	mutable Semaphore m_lock;
+	Semaphore m_streamLock;
+	std::atomic< uint32_t > m_clock;
+	std::atomic< int32_t > m_readers;
+
+	Tile* load(int32_t tileIndex);
+
+	Tile* createFlatTile() const;
+
+	void evict(uint32_t keepFrom);
+
+	void deleteRetired();
+};
+
+}
@@ -0,0 +1,80 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Heightfield/Test/BenchHeightfieldRay.h"
+
+#include "Core/Log/Log.h"
+#include "Core/Math/Random.h"
+#include "Core/Math/Ray3.h"
+#include "Core/Timer/Timer.h"
+#include "Heightfield/Heightfield.h"
+
+#include <cmath>
+
+namespace traktor::hf::test
+{
+namespace
+{
+
+const int32_t c_sizes[] = { 1024, 4096, 8192 };
+const int32_t c_rayCount = 100000;
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.test.BenchHeightfieldRay", 0, BenchHeightfieldRay, traktor::test::Benchmark)
+
+void BenchHeightfieldRay::run()
+{
+	for (auto size : c_sizes)
+	{
+		// Rolling terrain with detail at several frequencies.
+		Ref< Heightfield > heightfield = new Heightfield(size, Vector4(4096.0f, 512.0f, 4096.0f, 0.0f));
+		for (int32_t z = 0; z < size; ++z)
+		{
+			for (int32_t x = 0; x < size; ++x)
+			{
+				const float fx = x / (float)size;
+				const float fz = z / (float)size;
+				const float h = 0.5f + 0.2f * std::sin(fx * 13.0f) * std::cos(fz * 11.0f) + 0.05f * std::sin(fx * 97.0f + fz * 53.0f) + 0.01f * std::sin(fx * 731.0f) * std::sin(fz * 619.0f);
+				heightfield->setGridHeight(x, z, h);
+			}
+		}
+
+		Timer timer;
+		heightfield->updateCellBounds();
+		const double buildTime = timer.getDeltaTime();
+
+		// Rays cast downward at grazing angles.
+		Random random(1234);
+		AlignedVector< Ray3 > rays(c_rayCount);
+		for (auto& ray : rays)
+		{
+			ray.origin = Vector4((random.nextFloat() - 0.5f) * 4000.0f, 200.0f + random.nextFloat() * 100.0f, (random.nextFloat() - 0.5f) * 4000.0f, 1.0f);
+			ray.direction = Vector4(random.nextFloat() - 0.5f, -0.05f - random.nextFloat() * 0.3f, random.nextFloat() - 0.5f, 0.0f).normalized();
+		}
+
+		timer.getDeltaTime();
+		uint32_t hits = 0;
+		for (const auto& ray : rays)
+		{
+			Scalar distance;
+			if (heightfield->queryRay(ray.origin, ray.direction, distance))
+				++hits;
+		}
+		const double singleTime = timer.getDeltaTime();
+
+		AlignedVector< Scalar > distances(c_rayCount);
+		heightfield->queryRays(rays.c_ptr(), distances.ptr(), c_rayCount);
+		const double batchTime = timer.getDeltaTime();
+
+		log::info << L"Heightfield ray, size " << size << L", pyramid built in " << int32_t(buildTime * 1000.0) << L" ms" << Endl;
+		log::info << L"  " << hits << L" hit(s) of " << c_rayCount << L"; " << int32_t(c_rayCount / singleTime) << L" rays/s single, " << int32_t(c_rayCount / batchTime) << L" rays/s batched" << Endl;
+	}
+}
+
+}
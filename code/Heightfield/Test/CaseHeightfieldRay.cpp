@@ -0,0 +1,84 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Heightfield/Test/CaseHeightfieldRay.h"
+
+#include "Heightfield/Heightfield.h"
+
+#include <cmath>
+
+namespace traktor::hf::test
+{
+namespace
+{
+
+const int32_t c_size = 64;
+const float c_height = 0.5f;
+const float c_above = 0.01f;
+
+/*! Cast a ray, descending towards a flat heightfield, along X or Z axis; ray reach surface at given grid coordinate. */
+bool castGrazing(const Heightfield* heightfield, bool alongX, float surfaceGrid, float& outDistance, float& outExpected)
+{
+	const float surfaceY = heightfield->unitToWorld(heightfield->getGridHeightNearest(0, 0));
+	const float run = 8.0f;
+
+	float worldSurface, worldAcross;
+	heightfield->gridToWorld(surfaceGrid, 10.5f, worldSurface, worldAcross);
+
+	// Ray start outside heightfield and move towards origin.
+	const Vector4 origin = alongX ?
+		Vector4(worldSurface + run, surfaceY + c_above, worldAcross, 1.0f) :
+		Vector4(worldAcross, surfaceY + c_above, worldSurface + run, 1.0f);
+	const Vector4 direction = alongX ?
+		Vector4(-run, -c_above, 0.0f, 0.0f).normalized() :
+		Vector4(0.0f, -c_above, -run, 0.0f).normalized();
+
+	outExpected = std::sqrt(run * run + c_above * c_above);
+
+	Scalar distance;
+	if (!heightfield->queryRay(origin, direction, distance))
+		return false;
+
+	outDistance = distance;
+	return true;
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.test.CaseHeightfieldRay", 0, CaseHeightfieldRay, traktor::test::Case)
+
+void CaseHeightfieldRay::run()
+{
+	// One world unit per grid quad.
+	Ref< Heightfield > heightfield = new Heightfield(c_size, Vector4(float(c_size), 64.0f, float(c_size), 0.0f));
+	for (int32_t z = 0; z < c_size; ++z)
+	{
+		for (int32_t x = 0; x < c_size; ++x)
+			heightfield->setGridHeight(x, z, c_height);
+	}
+	heightfield->updateCellBounds();
+
+	for (int32_t axis = 0; axis < 2; ++axis)
+	{
+		const bool alongX = (axis == 0);
+		float distance = 0.0f, expected = 0.0f;
+
+		// Reaching surface inside last quad must hit.
+		const bool hitInside = castGrazing(heightfield, alongX, c_size - 1.5f, distance, expected);
+		CASE_ASSERT(hitInside);
+		if (hitInside)
+			CASE_ASSERT(std::abs(distance - expected) < 1e-2f);
+
+		// Reaching surface past last vertex must miss; grid does
+		// not extend beyond last vertex.
+		const bool hitOutside = castGrazing(heightfield, alongX, c_size - 0.5f, distance, expected);
+		CASE_ASSERT(!hitOutside);
+	}
+}
+
+}
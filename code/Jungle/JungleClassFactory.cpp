@@ -86,6 +86,26 @@ public:
 
 	float getTimeUntilTxPing() const { return m_configuration.timeUntilTxPing; }
 
+	void setTimeUntilTxStateDormant(float timeUntilTxStateDormant) { m_configuration.timeUntilTxStateDormant = timeUntilTxStateDormant; }
+
+	float getTimeUntilTxStateDormant() const { return m_configuration.timeUntilTxStateDormant; }
+
+	void setDeltaCompression(bool deltaCompression) { m_configuration.deltaCompression = deltaCompression; }
+
+	bool getDeltaCompression() const { return m_configuration.deltaCompression; }
+
+	void setMaxDeltaReduce(uint32_t maxDeltaReduce) { m_configuration.maxDeltaReduce = maxDeltaReduce; }
+
+	uint32_t getMaxDeltaReduce() const { return m_configuration.maxDeltaReduce; }
+
+	void setStateBudgetPerProxy(uint32_t stateBudgetPerProxy) { m_configuration.stateBudgetPerProxy = stateBudgetPerProxy; }
+
+	uint32_t getStateBudgetPerProxy() const { return m_configuration.stateBudgetPerProxy; }
+
+	void setStateBudgetTotal(uint32_t stateBudgetTotal) { m_configuration.stateBudgetTotal = stateBudgetTotal; }
+
+	uint32_t getStateBudgetTotal() const { return m_configuration.stateBudgetTotal; }
+
 	const Replicator::Configuration& getConfiguration() const { return m_configuration; }
 
 private:
@@ -342,6 +362,8 @@ void JungleClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	classReplicatorProxy->addProperty("relayed", &ReplicatorProxy::isRelayed);
 	classReplicatorProxy->addProperty("object", &ReplicatorProxy::setObject, &ReplicatorProxy::getObject);
 	classReplicatorProxy->addProperty("origin", &ReplicatorProxy::setOrigin, &ReplicatorProxy::getOrigin);
+	classReplicatorProxy->addProperty("relevance", &ReplicatorProxy::setRelevance, &ReplicatorProxy::getRelevance);
+	classReplicatorProxy->addProperty("dormant", &ReplicatorProxy::isDormant);
 	classReplicatorProxy->addProperty("stateTemplate", &ReplicatorProxy::setStateTemplate, &ReplicatorProxy::getStateTemplate);
 	classReplicatorProxy->addProperty("sendState", &ReplicatorProxy::setSendState, &ReplicatorProxy::getSendState);
 	classReplicatorProxy->addMethod("getState", &ReplicatorProxy::getState);
@@ -367,6 +389,11 @@ void JungleClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	classReplicatorConfiguration->addProperty("timeUntilTxStateNear", &ReplicatorConfiguration::setTimeUntilTxStateNear, &ReplicatorConfiguration::getTimeUntilTxStateNear);
 	classReplicatorConfiguration->addProperty("timeUntilTxStateFar", &ReplicatorConfiguration::setTimeUntilTxStateFar, &ReplicatorConfiguration::getTimeUntilTxStateFar);
 	classReplicatorConfiguration->addProperty("timeUntilTxPing", &ReplicatorConfiguration::setTimeUntilTxPing, &ReplicatorConfiguration::getTimeUntilTxPing);
+	classReplicatorConfiguration->addProperty("timeUntilTxStateDormant", &ReplicatorConfiguration::setTimeUntilTxStateDormant, &ReplicatorConfiguration::getTimeUntilTxStateDormant);
+	classReplicatorConfiguration->addProperty("deltaCompression", &ReplicatorConfiguration::setDeltaCompression, &ReplicatorConfiguration::getDeltaCompression);
+	classReplicatorConfiguration->addProperty("maxDeltaReduce", &ReplicatorConfiguration::setMaxDeltaReduce, &ReplicatorConfiguration::getMaxDeltaReduce);
+	classReplicatorConfiguration->addProperty("stateBudgetPerProxy", &ReplicatorConfiguration::setStateBudgetPerProxy, &ReplicatorConfiguration::getStateBudgetPerProxy);
+	classReplicatorConfiguration->addProperty("stateBudgetTotal", &ReplicatorConfiguration::setStateBudgetTotal, &ReplicatorConfiguration::getStateBudgetTotal);
 	registrar->registerClass(classReplicatorConfiguration);
 
 	auto classReplicator = new AutoRuntimeClass< Replicator >();
@@ -27,6 +27,8 @@ MeasureP2PProvider::MeasureP2PProvider(IPeer2PeerProvider* provider)
 ,	m_recvBytes(0)
 ,	m_sentBps(0.0)
 ,	m_recvBps(0.0)
+,	m_totalSentBytes(0)
+,	m_totalRecvBytes(0)
 {
 	m_time = s_timer.getElapsedTime();
 }
@@ -50,6 +52,8 @@ bool MeasureP2PProvider::update()
 		m_recvBps = recvBps;
 
 	m_time = time;
+	m_sentBytes = 0;
+	m_recvBytes = 0;
 
 	return m_provider->update();
 }
@@ -92,6 +96,7 @@ net_handle_t MeasureP2PProvider::getPrimaryPeerHandle() const
 bool MeasureP2PProvider::send(net_handle_t node, const void* data, int32_t size)
 {
 	m_sentBytes += size;
+	m_totalSentBytes += size;
 	return m_provider->send(node, data, size);
 }
 
@@ -99,7 +104,10 @@ int32_t MeasureP2PProvider::recv(void* data, int32_t size, net_handle_t& outNode
 {
 	const int32_t nbytes = m_provider->recv(data, size, outNode);
 	if (nbytes > 0)
+	{
 		m_recvBytes += nbytes;
+		m_totalRecvBytes += nbytes;
+	}
 
 	return nbytes;
 }
@@ -54,6 +54,10 @@ public:
 
 	float getRecvBitsPerSecond() const;
 
+	int64_t getTotalSentBytes() const { return m_totalSentBytes; }
+
+	int64_t getTotalRecvBytes() const { return m_totalRecvBytes; }
+
 private:
 	Ref< IPeer2PeerProvider > m_provider;
 	double m_time;
@@ -61,6 +65,8 @@ private:
 	int32_t m_recvBytes;
 	double m_sentBps;
 	double m_recvBps;
+	int64_t m_totalSentBytes;
+	int64_t m_totalRecvBytes;
 };
 
 }
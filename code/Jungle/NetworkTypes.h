@@ -15,6 +15,7 @@ namespace traktor::jungle
 
 enum { MaxDataSize = 1024 };
 enum { MaxPeers = 32 };
+enum { MaxStateHistory = 32 };
 
 typedef uint64_t net_handle_t;	//!< Globally unique handle.
 
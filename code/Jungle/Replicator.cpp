@@ -6,9 +6,11 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include <cstring>
 #include "Core/Io/MemoryStream.h"
 #include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
 #include "Core/Math/Float.h"
 #include "Core/Misc/String.h"
 #include "Core/Misc/TString.h"
@@ -32,6 +34,8 @@ namespace traktor::jungle
 const double c_catastrophicDeltaTime = 30.0;
 const double c_maxDeltaTime = 0.1;
 const uint32_t c_maxDeltaTimeCount = 10;
+const float c_maxBudgetDuration = 0.5f;
+const double c_maxStateAckDelay = 0.2;
 
 	}
 
@@ -152,35 +156,7 @@ bool Replicator::update()
 
 	// Send our state to proxies.
 	if (m_sendState && m_stateTemplate && m_state)
-	{
-		msg.id = RmiState;
-		msg.time = time2net(m_time);
-
-		const uint32_t stateDataSize = m_stateTemplate->pack(
-			m_state,
-			msg.state.data,
-			RmiState_MaxStateSize()
-		);
-
-		if (stateDataSize > 0)
-		{
-			for (auto proxy : m_proxies)
-			{
-				if (proxy->m_sendState && (proxy->m_timeUntilTxState -= dT) <= 0.0)
-				{
-					m_topology->send(proxy->m_handle, &msg, RmiState_NetSize(stateDataSize));
-
-					const Vector4 direction = proxy->m_origin.translation() - m_origin.translation();
-					const Scalar distance = direction.length();
-
-					const float t = clamp((distance - m_configuration.nearDistance) / (m_configuration.farDistance - m_configuration.nearDistance), 0.0f, 1.0f);
-
-					proxy->m_distance = distance;
-					proxy->m_timeUntilTxState = lerp(m_configuration.timeUntilTxStateNear, m_configuration.timeUntilTxStateFar, t);
-				}
-			}
-		}
-	}
+		sendState(dT);
 
 	double timeOffset = 0.0;
 	bool timeOffsetReceived = false;
@@ -267,10 +243,23 @@ bool Replicator::update()
 		}
 		else if (msg.id == RmiState)
 		{
-			const bool received = fromProxy->receivedState(m_time, net2time(msg.time), msg.state.data, RmiState_StateSize(nrecv));
+			fromProxy->receivedStateAcknowledge(msg.state.ack);
+			const bool received = fromProxy->receivedState(m_time, net2time(msg.time), msg.state.sequence, msg.state.data, RmiState_StateSize(nrecv));
 			if (received)
 				fromProxy->m_issueStateListeners = true;
 		}
+		else if (msg.id == RmiStateDelta)
+		{
+			fromProxy->receivedStateAcknowledge(msg.stateDelta.ack);
+			const bool received = fromProxy->receivedStateDelta(m_time, net2time(msg.time), msg.stateDelta.sequence, msg.stateDelta.baseline, msg.stateDelta.data, RmiStateDelta_DeltaSize(nrecv));
+			if (received)
+				fromProxy->m_issueStateListeners = true;
+		}
+		else if (msg.id == RmiStateAck)
+		{
+			// Received a state acknowledge; state can be used as delta baseline.
+			fromProxy->receivedStateAcknowledge(msg.stateAck.sequence);
+		}
 		else if (msg.id == RmiEvent0 || msg.id == RmiEvent1)
 		{
 			// Unwrap event object.
@@ -322,6 +311,24 @@ bool Replicator::update()
 	}
 	*/
 
+	// Acknowledge latest received state from each proxy; acknowledges are
+	// normally carried by our state messages so only send explicit acknowledge
+	// if we haven't sent any state to proxy for a while.
+	for (auto proxy : m_proxies)
+	{
+		if (
+			proxy->m_rxStateAckPending &&
+			(!m_sendState || !proxy->m_sendState || m_time0 - proxy->m_rxStateAckTime >= c_maxStateAckDelay)
+		)
+		{
+			reply.id = RmiStateAck;
+			reply.time = time2net(m_time);
+			reply.stateAck.sequence = proxy->m_rxStateAckSequence;
+			m_topology->send(proxy->m_handle, &reply, RmiStateAck_NetSize());
+			proxy->m_rxStateAckPending = false;
+		}
+	}
+
 	// Update proxy queues.
 	for (auto proxy : m_proxies)
 	{
@@ -505,6 +512,10 @@ bool Replicator::isPrimary() const
 void Replicator::setStateTemplate(const StateTemplate* stateTemplate)
 {
 	m_stateTemplate = stateTemplate;
+
+	// Proxies cannot reconstruct deltas from states of another template.
+	for (auto proxy : m_proxies)
+		proxy->resetTxStates();
 }
 
 void Replicator::setState(const State* state)
@@ -515,7 +526,7 @@ void Replicator::setState(const State* state)
 	{
 		for (auto proxy : m_proxies)
 		{
-			if (proxy->m_distance < m_configuration.furthestDistance)
+			if (!proxy->m_dormant)
 				proxy->m_timeUntilTxState = 0.0;
 		}
 	}
@@ -742,6 +753,182 @@ std::wstring Replicator::getLogPrefix() const
 	return L"Replicator: [" + toString(m_topology->getLocalHandle()) + L"] ";
 }
 
+void Replicator::sendState(double dT)
+{
+	RMessage msgDelta;
+	RMessage msgFull;
+	Ref< const State > fullState;
+	uint32_t fullStateDataSize = 0;
+
+	const float budgetPerProxy = float(m_configuration.stateBudgetPerProxy);
+	const float budgetTotal = float(m_configuration.stateBudgetTotal);
+
+	if (budgetTotal > 0.0f)
+		m_txStateBudget = std::min(m_txStateBudget + budgetTotal * float(dT), budgetTotal * c_maxBudgetDuration);
+
+	// Determine relevance of each proxy and accumulate priority and budget;
+	// closer, more relevant, proxies accumulate priority faster. Dormant
+	// proxies are still sent state occasionally so they can keep track of
+	// our origin and thus determine when we become relevant to them.
+	m_txStateProxies.resize(0);
+	for (auto proxy : m_proxies)
+	{
+		if (!proxy->m_sendState)
+			continue;
+
+		const Vector4 direction = proxy->m_origin.translation() - m_origin.translation();
+		const Scalar distance = direction.length();
+
+		const float t = clamp((distance - m_configuration.nearDistance) / (m_configuration.farDistance - m_configuration.nearDistance), 0.0f, 1.0f);
+		const float relevance = (distance < m_configuration.furthestDistance) ? proxy->m_relevance : 0.0f;
+
+		proxy->m_distance = distance;
+		proxy->m_dormant = (relevance <= FUZZY_EPSILON);
+
+		if (!proxy->m_dormant)
+			proxy->m_txStateInterval = std::min(lerp(m_configuration.timeUntilTxStateNear, m_configuration.timeUntilTxStateFar, t) / relevance, m_configuration.timeUntilTxStateDormant);
+		else
+			proxy->m_txStateInterval = m_configuration.timeUntilTxStateDormant;
+
+		// Proxy which has become relevant shouldn't have to wait for
+		// a state scheduled at a longer interval.
+		proxy->m_timeUntilTxState = std::min(proxy->m_timeUntilTxState, (double)proxy->m_txStateInterval);
+
+		proxy->m_txStatePriority += float(dT) / proxy->m_txStateInterval;
+
+		if (budgetPerProxy > 0.0f)
+			proxy->m_txStateBudget = std::min(proxy->m_txStateBudget + budgetPerProxy * float(dT), budgetPerProxy * c_maxBudgetDuration);
+
+		if ((proxy->m_timeUntilTxState -= dT) <= 0.0)
+			m_txStateProxies.push_back(proxy);
+	}
+
+	// Serve proxies with highest priority first; if budget is exhausted then
+	// remaining proxies are deferred and keep accumulating priority.
+	m_txStateProxies.sort([](const ReplicatorProxy* l, const ReplicatorProxy* r) {
+		return l->m_txStatePriority > r->m_txStatePriority;
+	});
+
+	m_txDeltas.resize(0);
+	m_txDeltaData.resize(0);
+
+	for (auto proxy : m_txStateProxies)
+	{
+		// Sequence zero is reserved to indicate "nothing received".
+		uint8_t sequence = proxy->m_txStateSequence + 1;
+		if (sequence == 0)
+			sequence = 1;
+
+		const float t = proxy->m_dormant ? 1.0f : clamp((proxy->m_distance - m_configuration.nearDistance) / (m_configuration.farDistance - m_configuration.nearDistance), 0.0f, 1.0f);
+
+		RMessage* msg = nullptr;
+		int32_t msgSize = 0;
+		Ref< const State > txState;
+
+		// Pack delta against last state acknowledged by proxy; reduce
+		// precision of deltas to far away proxies.
+		if (m_configuration.deltaCompression && proxy->m_txBaseline)
+		{
+			const uint32_t reduce = uint32_t(t * m_configuration.maxDeltaReduce + 0.5f);
+
+			// Proxies which have acknowledged same baseline get the same delta;
+			// thus only pack once for each baseline.
+			auto it = std::find_if(m_txDeltas.begin(), m_txDeltas.end(), [&](const TxDelta& txDelta) {
+				return txDelta.baseline == proxy->m_txBaseline && txDelta.reduce == reduce;
+			});
+			if (it == m_txDeltas.end())
+			{
+				TxDelta& txDelta = m_txDeltas.push_back();
+				txDelta.baseline = proxy->m_txBaseline;
+				txDelta.reduce = reduce;
+				txDelta.offset = m_txDeltaData.size();
+				txDelta.size = m_stateTemplate->packDelta(
+					proxy->m_txBaseline,
+					m_state,
+					reduce,
+					msgDelta.stateDelta.data,
+					RmiStateDelta_MaxDeltaSize()
+				);
+				if (txDelta.size > 0)
+				{
+					m_txDeltaData.insert(m_txDeltaData.end(), msgDelta.stateDelta.data, msgDelta.stateDelta.data + txDelta.size);
+
+					// Keep state exactly as proxy will reconstruct it, since
+					// it might become baseline of following deltas.
+					txDelta.state = m_stateTemplate->unpackDelta(proxy->m_txBaseline, msgDelta.stateDelta.data, txDelta.size);
+				}
+				it = m_txDeltas.end() - 1;
+			}
+			else if (it->state)
+				std::memcpy(msgDelta.stateDelta.data, &m_txDeltaData[it->offset], it->size);
+
+			if (it->state)
+			{
+				msgDelta.id = RmiStateDelta;
+				msgDelta.time = time2net(m_time);
+				msgDelta.stateDelta.baseline = proxy->m_txBaselineSequence;
+				msg = &msgDelta;
+				msgSize = RmiStateDelta_NetSize(it->size);
+				txState = it->state;
+			}
+		}
+
+		// Pack full state, only packed once for all proxies.
+		if (!msg)
+		{
+			if (!fullState)
+			{
+				fullStateDataSize = m_stateTemplate->pack(
+					m_state,
+					msgFull.state.data,
+					RmiState_MaxStateSize()
+				);
+				if (fullStateDataSize == 0)
+					break;
+
+				if ((fullState = m_stateTemplate->unpack(msgFull.state.data, fullStateDataSize)) == nullptr)
+					break;
+
+				msgFull.id = RmiState;
+				msgFull.time = time2net(m_time);
+			}
+
+			msg = &msgFull;
+			msgSize = RmiState_NetSize(fullStateDataSize);
+			txState = fullState;
+		}
+
+		if (budgetTotal > 0.0f && float(msgSize) > m_txStateBudget)
+			break;
+		if (budgetPerProxy > 0.0f && float(msgSize) > proxy->m_txStateBudget)
+			continue;
+
+		// Both state messages begin with sequence and acknowledge.
+		if (msg == &msgDelta)
+		{
+			msgDelta.stateDelta.sequence = sequence;
+			msgDelta.stateDelta.ack = proxy->m_rxStateAckSequence;
+		}
+		else
+		{
+			msgFull.state.sequence = sequence;
+			msgFull.state.ack = proxy->m_rxStateAckSequence;
+		}
+
+		m_topology->send(proxy->m_handle, msg, msgSize);
+		proxy->sentState(sequence, txState);
+		proxy->m_rxStateAckPending = false;
+
+		if (budgetTotal > 0.0f)
+			m_txStateBudget -= float(msgSize);
+		if (budgetPerProxy > 0.0f)
+			proxy->m_txStateBudget -= float(msgSize);
+
+		proxy->m_txStatePriority = 0.0f;
+		proxy->m_timeUntilTxState = proxy->m_txStateInterval;
+	}
+}
+
 bool Replicator::nodeConnected(INetworkTopology* topology, net_handle_t node)
 {
 	std::wstring name;
@@ -10,6 +10,7 @@
 
 #include "Core/Object.h"
 #include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Containers/CircularVector.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Math/Transform.h"
@@ -70,6 +71,11 @@ public:
 		float timeUntilTxStateNear = 0.1f;
 		float timeUntilTxStateFar = 0.3f;
 		float timeUntilTxPing = 1.0f;
+		float timeUntilTxStateDormant = 1.0f;	/*!< Time between states sent to dormant proxies, i.e. beyond furthest distance or not relevant. */
+		bool deltaCompression = true;		/*!< Send state as delta against last state acknowledged by proxy. */
+		uint32_t maxDeltaReduce = 3;		/*!< Max number of low precision bits dropped from deltas to far proxies. */
+		uint32_t stateBudgetPerProxy = 0;	/*!< Max state bytes per second to each proxy, 0 means unlimited. */
+		uint32_t stateBudgetTotal = 0;		/*!< Max state bytes per second to all proxies, 0 means unlimited. */
 	};
 
 	virtual ~Replicator();
@@ -174,7 +180,8 @@ public:
 	/*! Set our origin.
 	 *
 	 * Origin is used to determine which frequency
-	 * of transmission to use to each peer.
+	 * of transmission to use to each peer; peers
+	 * beyond furthest distance become dormant.
 	 *
 	 * \param origin World origin of caller peer.
 	 */
@@ -274,6 +281,15 @@ public:
 private:
 	friend class ReplicatorProxy;
 
+	struct TxDelta
+	{
+		Ref< const State > baseline;
+		uint32_t reduce;
+		uint32_t offset;
+		uint32_t size;
+		Ref< const State > state;
+	};
+
 	Ref< INetworkTopology > m_topology;
 	Configuration m_configuration;
 	std::vector< const TypeInfo* > m_eventTypes;
@@ -292,6 +308,10 @@ private:
 	Ref< const StateTemplate > m_stateTemplate;
 	Ref< const State > m_state;
 	RefArray< ReplicatorProxy > m_proxies;
+	RefArray< ReplicatorProxy > m_txStateProxies;
+	AlignedVector< TxDelta > m_txDeltas;
+	AlignedVector< uint8_t > m_txDeltaData;
+	float m_txStateBudget = 0.0f;
 	bool m_sendState = false;
 	bool m_timeSynchronization = true;
 	bool m_timeSynchronized = false;
@@ -299,6 +319,8 @@ private:
 
 	std::wstring getLogPrefix() const;
 
+	void sendState(double dT);
+
 	virtual bool nodeConnected(INetworkTopology* topology, net_handle_t node) override final;
 
 	virtual bool nodeDisconnected(INetworkTopology* topology, net_handle_t node) override final;
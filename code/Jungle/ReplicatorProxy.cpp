@@ -149,6 +149,21 @@ const Transform& ReplicatorProxy::getOrigin() const
 	return m_origin;
 }
 
+void ReplicatorProxy::setRelevance(float relevance)
+{
+	m_relevance = std::max(relevance, 0.0f);
+}
+
+float ReplicatorProxy::getRelevance() const
+{
+	return m_relevance;
+}
+
+bool ReplicatorProxy::isDormant() const
+{
+	return m_dormant;
+}
+
 void ReplicatorProxy::setStateTemplate(const StateTemplate* stateTemplate)
 {
 	m_stateTemplate = stateTemplate;
@@ -156,6 +171,11 @@ void ReplicatorProxy::setStateTemplate(const StateTemplate* stateTemplate)
 	// Old states must be immediately discarded; we cannot keep
 	// states produced from old template.
 	resetStates();
+
+	for (uint32_t i = 0; i < sizeof_array(m_rxStates); ++i)
+		m_rxStates[i].state = nullptr;
+	m_rxStateAckSequence = 0;
+	m_rxStateAckPending = false;
 }
 
 const StateTemplate* ReplicatorProxy::getStateTemplate() const
@@ -433,7 +453,44 @@ void ReplicatorProxy::updateLatency(double localTime, double remoteTime, double
 	m_latencyReverseStandardDeviation = latencyReverseSpread;
 }
 
-bool ReplicatorProxy::receivedState(double localTime, double stateTime, const void* stateData, uint32_t stateDataSize)
+void ReplicatorProxy::sentState(uint8_t sequence, const State* state)
+{
+	SequencedState& txState = m_txStates[sequence % MaxStateHistory];
+	txState.sequence = sequence;
+	txState.state = state;
+	m_txStateSequence = sequence;
+
+	// Baseline must still be in receiver's history when delta arrives.
+	if (m_txBaseline && uint8_t(m_txStateSequence - m_txBaselineSequence) >= MaxStateHistory - 1)
+		m_txBaseline = nullptr;
+}
+
+void ReplicatorProxy::receivedStateAcknowledge(uint8_t sequence)
+{
+	// Ignore acknowledges of states no longer in our history.
+	if (uint8_t(m_txStateSequence - sequence) >= MaxStateHistory - 1)
+		return;
+
+	const SequencedState& txState = m_txStates[sequence % MaxStateHistory];
+	if (!txState.state || txState.sequence != sequence)
+		return;
+
+	// Only move baseline forward, acknowledges might arrive out of order.
+	if (!m_txBaseline || int8_t(sequence - m_txBaselineSequence) > 0)
+	{
+		m_txBaseline = txState.state;
+		m_txBaselineSequence = sequence;
+	}
+}
+
+void ReplicatorProxy::resetTxStates()
+{
+	for (uint32_t i = 0; i < sizeof_array(m_txStates); ++i)
+		m_txStates[i].state = nullptr;
+	m_txBaseline = nullptr;
+}
+
+bool ReplicatorProxy::receivedState(double localTime, double stateTime, uint8_t sequence, const void* stateData, uint32_t stateDataSize)
 {
 	if (!m_stateTemplate)
 	{
@@ -448,6 +505,50 @@ bool ReplicatorProxy::receivedState(double localTime, double stateTime, const vo
 		return false;
 	}
 
+	return enqueueState(localTime, stateTime, sequence, state);
+}
+
+bool ReplicatorProxy::receivedStateDelta(double localTime, double stateTime, uint8_t sequence, uint8_t baseline, const void* deltaData, uint32_t deltaDataSize)
+{
+	if (!m_stateTemplate)
+	{
+		log::info << m_replicator->getLogPrefix() << L"Received state delta (" << deltaDataSize << L" byte(s)) from " << getLogIdentifier() << L" but no state template registered; state ignored." << Endl;
+		return false;
+	}
+
+	const SequencedState& rxBaseline = m_rxStates[baseline % MaxStateHistory];
+	if (!rxBaseline.state || rxBaseline.sequence != baseline)
+	{
+		log::info << m_replicator->getLogPrefix() << L"Received state delta from " << getLogIdentifier() << L" but baseline " << int32_t(baseline) << L" is not available; state ignored." << Endl;
+		return false;
+	}
+
+	Ref< const State > state = m_stateTemplate->unpackDelta(rxBaseline.state, deltaData, deltaDataSize);
+	if (!state)
+	{
+		log::info << m_replicator->getLogPrefix() << L"Failed to unpack state delta (" << deltaDataSize << L" byte(s)) from " << getLogIdentifier() << L"; state ignored." << Endl;
+		return false;
+	}
+
+	return enqueueState(localTime, stateTime, sequence, state);
+}
+
+bool ReplicatorProxy::enqueueState(double localTime, double stateTime, uint8_t sequence, const State* state)
+{
+	// Keep state as a potential baseline and acknowledge it, even if
+	// it's too old to be used for extrapolation.
+	SequencedState& rxState = m_rxStates[sequence % MaxStateHistory];
+	rxState.sequence = sequence;
+	rxState.state = state;
+
+	if (!m_rxStateAckPending)
+	{
+		m_rxStateAckTime = m_replicator->m_time0;
+		m_rxStateAckPending = true;
+	}
+	if (m_rxStateAckSequence == 0 || int8_t(sequence - m_rxStateAckSequence) > 0)
+		m_rxStateAckSequence = sequence;
+
 	m_stateReceivedTime = localTime;
 
 	if (stateTime >= m_stateTime0)
@@ -488,6 +589,8 @@ void ReplicatorProxy::disconnect()
 	m_status = 0;
 	m_object = nullptr;
 	m_distance = 0.0f;
+	m_relevance = 1.0f;
+	m_dormant = false;
 	m_sendState = false;
 	m_issueStateListeners = false;
 	m_timeUntilTxPing = 0.0;
@@ -497,6 +600,12 @@ void ReplicatorProxy::disconnect()
 	m_latencyReverse = 0.0;
 	m_latencyReverseStandardDeviation = 0.0;
 
+	resetTxStates();
+	for (uint32_t i = 0; i < sizeof_array(m_rxStates); ++i)
+		m_rxStates[i].state = nullptr;
+	m_rxStateAckSequence = 0;
+	m_rxStateAckPending = false;
+
 	m_txSequence = 0;
 	m_txSequenceInOrder = 0;
 	m_txEvents.clear();
@@ -523,12 +632,22 @@ ReplicatorProxy::ReplicatorProxy(Replicator* replicator, net_handle_t handle, co
 ,	m_status(0)
 ,	m_origin(Transform::identity())
 ,	m_distance(0.0f)
+,	m_relevance(1.0f)
+,	m_dormant(false)
 ,	m_sendState(false)
 ,	m_issueStateListeners(false)
 ,	m_stateTimeN2(0.0)
 ,	m_stateTimeN1(0.0)
 ,	m_stateTime0(0.0)
 ,	m_stateReceivedTime(0.0)
+,	m_txStateSequence(0)
+,	m_txBaselineSequence(0)
+,	m_txStatePriority(0.0f)
+,	m_txStateInterval(0.0f)
+,	m_txStateBudget(0.0f)
+,	m_rxStateAckSequence(0)
+,	m_rxStateAckPending(false)
+,	m_rxStateAckTime(0.0)
 ,	m_txSequence(0)
 ,	m_txSequenceInOrder(0)
 ,	m_rxEventsInOrderSequence(0)
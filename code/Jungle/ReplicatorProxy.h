@@ -120,6 +120,25 @@ public:
 	 */
 	const Transform& getOrigin() const;
 
+	/*! Set relevance of this proxy.
+	 *
+	 * Relevance is determined by the game, for example
+	 * by visibility, and scales frequency of which state
+	 * is sent to this proxy. Proxies with zero relevance
+	 * become dormant and only receive state occasionally.
+	 *
+	 * \param relevance Relevance, default 1.
+	 */
+	void setRelevance(float relevance);
+
+	/*!
+	 */
+	float getRelevance() const;
+
+	/*! Check if proxy is dormant, ie. not relevant.
+	 */
+	bool isDormant() const;
+
 	/*!
 	 */
 	void setStateTemplate(const StateTemplate* stateTemplate);
@@ -170,6 +189,12 @@ private:
 		Ref< const ISerializable > eventObject;
 	};
 
+	struct SequencedState
+	{
+		uint8_t sequence = 0;
+		Ref< const State > state;
+	};
+
 	Replicator* m_replicator;
 	net_handle_t m_handle;
 
@@ -182,6 +207,8 @@ private:
 	Ref< Object > m_object;
 	Transform m_origin;
 	float m_distance;
+	float m_relevance;
+	bool m_dormant;
 	bool m_sendState;
 	bool m_issueStateListeners;
 
@@ -201,6 +228,24 @@ private:
 
 	//@}
 
+	/*! \group State delta compression. */
+	//@{
+
+	SequencedState m_txStates[MaxStateHistory];	/*!< States sent, as reconstructed by receiver. */
+	uint8_t m_txStateSequence;
+	Ref< const State > m_txBaseline;			/*!< Last state acknowledged by receiver. */
+	uint8_t m_txBaselineSequence;
+	float m_txStatePriority;
+	float m_txStateInterval;
+	float m_txStateBudget;
+
+	SequencedState m_rxStates[MaxStateHistory];	/*!< States received, potential baselines of deltas. */
+	uint8_t m_rxStateAckSequence;
+	bool m_rxStateAckPending;
+	double m_rxStateAckTime;
+
+	//@}
+
 	/*! \group Event management. */
 	//@{
 
@@ -240,7 +285,17 @@ private:
 
 	void updateLatency(double localTime, double remoteTime, double roundTrip, double latencyReverse, double latencyReverseSpread);
 
-	bool receivedState(double localTime, double stateTime, const void* stateData, uint32_t stateDataSize);
+	void sentState(uint8_t sequence, const State* state);
+
+	void receivedStateAcknowledge(uint8_t sequence);
+
+	void resetTxStates();
+
+	bool receivedState(double localTime, double stateTime, uint8_t sequence, const void* stateData, uint32_t stateDataSize);
+
+	bool receivedStateDelta(double localTime, double stateTime, uint8_t sequence, uint8_t baseline, const void* deltaData, uint32_t deltaDataSize);
+
+	bool enqueueState(double localTime, double stateTime, uint8_t sequence, const State* state);
 
 	void disconnect();
 
@@ -17,7 +17,9 @@ enum RMessageId
 {
 	RmiPing	= 0xa0,
 	RmiPong = 0xa1,
-	RmiState = 0xb0,
+	RmiStateDelta = 0xb1,
+	RmiStateAck = 0xb2,
+	RmiState = 0xb3,	//!< Was 0xb0 before sequence and acknowledge were added; old peers ignore new state messages.
 	RmiEvent0 = 0xc0,
 	RmiEvent0Ack = 0xc1,
 	RmiEvent1 = 0xd0,
@@ -47,9 +49,24 @@ struct RMessage
 
 		struct
 		{
+			uint8_t sequence;
+			uint8_t ack;
 			uint8_t data[1];
 		} state;
 
+		struct
+		{
+			uint8_t sequence;
+			uint8_t ack;
+			uint8_t baseline;
+			uint8_t data[1];
+		} stateDelta;
+
+		struct
+		{
+			uint8_t sequence;
+		} stateAck;
+
 		struct
 		{
 			uint8_t sequence;
@@ -71,10 +88,16 @@ T_FORCE_INLINE int32_t RMessage_HeaderSize()				{ return sizeof(uint8_t) + sizeo
 T_FORCE_INLINE int32_t RmiPing_NetSize()					{ return RMessage_HeaderSize() + sizeof(uint32_t) + sizeof(uint8_t); }
 T_FORCE_INLINE int32_t RmiPong_NetSize()					{ return RMessage_HeaderSize() + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint32_t); }
 
-T_FORCE_INLINE int32_t RmiState_NetSize(int32_t stateSize)	{ return RMessage_HeaderSize() + stateSize; }
-T_FORCE_INLINE int32_t RmiState_StateSize(int32_t netSize)	{ return netSize - RMessage_HeaderSize(); }
+T_FORCE_INLINE int32_t RmiState_NetSize(int32_t stateSize)	{ return RMessage_HeaderSize() + sizeof(uint8_t) + sizeof(uint8_t) + stateSize; }
+T_FORCE_INLINE int32_t RmiState_StateSize(int32_t netSize)	{ return netSize - RMessage_HeaderSize() - sizeof(uint8_t) - sizeof(uint8_t); }
 T_FORCE_INLINE int32_t RmiState_MaxStateSize()				{ return RmiState_StateSize(1024); }
 
+T_FORCE_INLINE int32_t RmiStateDelta_NetSize(int32_t deltaSize)	{ return RMessage_HeaderSize() + sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint8_t) + deltaSize; }
+T_FORCE_INLINE int32_t RmiStateDelta_DeltaSize(int32_t netSize)	{ return netSize - RMessage_HeaderSize() - sizeof(uint8_t) - sizeof(uint8_t) - sizeof(uint8_t); }
+T_FORCE_INLINE int32_t RmiStateDelta_MaxDeltaSize()				{ return RmiStateDelta_DeltaSize(1024); }
+
+T_FORCE_INLINE int32_t RmiStateAck_NetSize()				{ return RMessage_HeaderSize() + sizeof(uint8_t); }
+
 T_FORCE_INLINE int32_t RmiEvent_NetSize(int32_t eventSize)	{ return RMessage_HeaderSize() + sizeof(uint8_t) + eventSize; }
 T_FORCE_INLINE int32_t RmiEvent_EventSize(int32_t netSize)	{ return netSize - RMessage_HeaderSize() - sizeof(uint8_t); }
 T_FORCE_INLINE int32_t RmiEvent_MaxEventSize()				{ return RmiEvent_EventSize(1024); }
@@ -16,6 +16,7 @@
 #include "Core/Serialization/PackedUnitVector.h"
 #include "Jungle/State/BodyStateValue.h"
 #include "Jungle/State/BodyStateTemplate.h"
+#include "Jungle/State/DeltaPacking.h"
 
 namespace traktor::jungle
 {
@@ -62,6 +63,55 @@ private:
 	int32_t m_v;
 };
 
+/*! Quantized body state, exactly as written by pack. */
+struct QuantizedBodyState
+{
+	int32_t position[3];
+	uint16_t rotationAxis;
+	int32_t rotationAngle;
+	uint16_t linearVelocityAxis;
+	int32_t linearVelocity;
+	uint16_t angularVelocityAxis;
+	int32_t angularVelocity;
+};
+
+QuantizedBodyState quantize(const physics::BodyState& v)
+{
+	QuantizedBodyState q;
+	const Transform& T = v.getTransform();
+	float T_MATH_ALIGN16 e[4];
+
+	T.translation().storeAligned(e);
+	for (uint32_t i = 0; i < 3; ++i)
+		q.position[i] = GenericFixedPoint< 13, 11 >(e[i]).raw();
+
+	Vector4 R = T.rotation().toAxisAngle();
+	float a = R.length();
+	if (abs(a) > FUZZY_EPSILON)
+		R /= Scalar(a);
+
+	q.rotationAxis = PackedUnitVector(R).raw();
+	q.rotationAngle = GenericFixedPoint< 4, 11 >(a).raw();
+
+	Vector4 linearVelocity = v.getLinearVelocity().xyz0();
+	Scalar ln = linearVelocity.length();
+	if (ln > FUZZY_EPSILON)
+		linearVelocity /= ln;
+
+	q.linearVelocityAxis = PackedUnitVector(linearVelocity).raw();
+	q.linearVelocity = GenericFixedPoint< 7, 8 >(ln).raw();
+
+	Vector4 angularVelocity = v.getAngularVelocity().xyz0();
+	Scalar an = angularVelocity.length();
+	if (an > FUZZY_EPSILON)
+		angularVelocity /= an;
+
+	q.angularVelocityAxis = PackedUnitVector(angularVelocity).raw();
+	q.angularVelocity = GenericFixedPoint< 5, 8 >(an).raw();
+
+	return q;
+}
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.jungle.BodyStateTemplate", BodyStateTemplate, IValueTemplate)
@@ -168,6 +218,96 @@ Ref< const IValue > BodyStateTemplate::unpack(BitReader& reader) const
 	return new BodyStateValue(S);
 }
 
+uint32_t BodyStateTemplate::getMaxPackedDeltaSize() const
+{
+	return 3 * getMaxPackedDeltaFixedSize(13+11) + 1 + 16 + (4+11) + 1 + 16 + (7+8) + 1 + 16 + (5+8);
+}
+
+void BodyStateTemplate::packDelta(BitWriter& writer, const IValue* Vb, const IValue* V, uint32_t reduce) const
+{
+	const QuantizedBodyState qb = quantize(*mandatory_non_null_type_cast< const BodyStateValue* >(Vb));
+	const QuantizedBodyState q = quantize(*mandatory_non_null_type_cast< const BodyStateValue* >(V));
+
+	// 3 * delta(13+11)
+	for (uint32_t i = 0; i < 3; ++i)
+		packDeltaFixed(writer, qb.position[i], q.position[i], 13+11, reduce);
+
+	// 1 [+ 16 + (4+11)]
+	if (q.rotationAxis != qb.rotationAxis || q.rotationAngle != qb.rotationAngle)
+	{
+		writer.writeBit(true);
+		writer.writeUnsigned(16, q.rotationAxis);
+		writer.writeSigned(4+11, q.rotationAngle);
+	}
+	else
+		writer.writeBit(false);
+
+	// 1 [+ 16 + (7+8)]
+	if (q.linearVelocityAxis != qb.linearVelocityAxis || q.linearVelocity != qb.linearVelocity)
+	{
+		writer.writeBit(true);
+		writer.writeUnsigned(16, q.linearVelocityAxis);
+		writer.writeSigned(7+8, q.linearVelocity);
+	}
+	else
+		writer.writeBit(false);
+
+	// 1 [+ 16 + (5+8)]
+	if (q.angularVelocityAxis != qb.angularVelocityAxis || q.angularVelocity != qb.angularVelocity)
+	{
+		writer.writeBit(true);
+		writer.writeUnsigned(16, q.angularVelocityAxis);
+		writer.writeSigned(5+8, q.angularVelocity);
+	}
+	else
+		writer.writeBit(false);
+}
+
+Ref< const IValue > BodyStateTemplate::unpackDelta(BitReader& reader, const IValue* Vb, uint32_t reduce) const
+{
+	const physics::BodyState& vb = *mandatory_non_null_type_cast< const BodyStateValue* >(Vb);
+	const QuantizedBodyState qb = quantize(vb);
+	float T_MATH_ALIGN16 f[4];
+
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		f[i] = GenericFixedPoint< 13, 11 >(unpackDeltaFixed(reader, qb.position[i], 13+11, reduce));
+		T_ASSERT(!isNanOrInfinite(f[i]));
+	}
+	f[3] = 1.0f;
+
+	Quaternion rotation = vb.getTransform().rotation();
+	if (reader.readBit())
+	{
+		const Vector4 R = PackedUnitVector(reader.readUnsigned(16)).unpack();
+		const float Ra = GenericFixedPoint< 4, 11 >(reader.readSigned(4+11));
+		rotation = (abs(Ra) > FUZZY_EPSILON && R.length() > FUZZY_EPSILON) ?
+			Quaternion::fromAxisAngle(R, Ra).normalized() :
+			Quaternion::identity();
+	}
+
+	Vector4 linearVelocity = vb.getLinearVelocity();
+	if (reader.readBit())
+	{
+		linearVelocity = PackedUnitVector(reader.readUnsigned(16)).unpack();
+		linearVelocity *= Scalar(GenericFixedPoint< 7, 8 >(reader.readSigned(7+8)));
+	}
+
+	Vector4 angularVelocity = vb.getAngularVelocity();
+	if (reader.readBit())
+	{
+		angularVelocity = PackedUnitVector(reader.readUnsigned(16)).unpack();
+		angularVelocity *= Scalar(GenericFixedPoint< 5, 8 >(reader.readSigned(5+8)));
+	}
+
+	physics::BodyState S;
+	S.setTransform(Transform(Vector4::loadAligned(f), rotation));
+	S.setLinearVelocity(linearVelocity);
+	S.setAngularVelocity(angularVelocity);
+
+	return new BodyStateValue(S);
+}
+
 Ref< const IValue > BodyStateTemplate::extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const
 {
 	const physics::BodyState& Sn2 = *checked_type_cast< const BodyStateValue* >(Vn2);
@@ -0,0 +1,85 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Io/BitReader.h"
+#include "Core/Io/BitWriter.h"
+
+namespace traktor::jungle
+{
+
+/*! Max number of bits written by packDeltaFixed.
+ * \ingroup Jungle
+ */
+T_FORCE_INLINE uint32_t getMaxPackedDeltaFixedSize(int32_t nbits)
+{
+	return 2 + std::max< int32_t >(nbits, 10);
+}
+
+/*! Pack fixed point value as delta against baseline.
+ * \ingroup Jungle
+ *
+ * Delta is written with a 2-bit width selector
+ * followed by as few bits as possible; if delta
+ * doesn't fit then entire value is written.
+ *
+ * \param writer Bit writer.
+ * \param qb Baseline fixed point value.
+ * \param q Fixed point value.
+ * \param nbits Number of bits of full, signed, fixed point value.
+ * \param reduce Number of low bits dropped from delta.
+ */
+T_FORCE_INLINE void packDeltaFixed(BitWriter& writer, int32_t qb, int32_t q, int32_t nbits, uint32_t reduce)
+{
+	const int32_t round = (reduce > 0) ? (1 << (reduce - 1)) : 0;
+	const int32_t d = (q - qb + round) >> reduce;
+	if (d == 0)
+		writer.writeUnsigned(2, 0);
+	else if (d >= -8 && d < 8)
+	{
+		writer.writeUnsigned(2, 1);
+		writer.writeSigned(4, d);
+	}
+	else if (d >= -512 && d < 512)
+	{
+		writer.writeUnsigned(2, 2);
+		writer.writeSigned(10, d);
+	}
+	else
+	{
+		writer.writeUnsigned(2, 3);
+		writer.writeSigned(nbits, q);
+	}
+}
+
+/*! Unpack fixed point value from delta against baseline.
+ * \ingroup Jungle
+ *
+ * \param reader Bit reader.
+ * \param qb Baseline fixed point value.
+ * \param nbits Number of bits of full, signed, fixed point value.
+ * \param reduce Number of low bits dropped from delta.
+ * \return Fixed point value.
+ */
+T_FORCE_INLINE int32_t unpackDeltaFixed(BitReader& reader, int32_t qb, int32_t nbits, uint32_t reduce)
+{
+	switch (reader.readUnsigned(2))
+	{
+	case 0:
+		return qb;
+	case 1:
+		return qb + (reader.readSigned(4) << reduce);
+	case 2:
+		return qb + (reader.readSigned(10) << reduce);
+	default:
+		return reader.readSigned(nbits);
+	}
+}
+
+}
@@ -12,6 +12,7 @@
 #include "Core/Math/Const.h"
 #include "Core/Math/Float.h"
 #include "Core/Math/MathUtils.h"
+#include "Jungle/State/DeltaPacking.h"
 #include "Jungle/State/FloatValue.h"
 #include "Jungle/State/FloatTemplate.h"
 
@@ -102,62 +103,59 @@ uint32_t FloatTemplate::getMaxPackedDataSize() const
 
 void FloatTemplate::pack(BitWriter& writer, const IValue* V) const
 {
-	float f = *checked_type_cast< const FloatValue* >(V);
-	switch (m_precision)
+	const float f = *checked_type_cast< const FloatValue* >(V);
+	writer.writeUnsigned(getMaxPackedDataSize(), quantize(f));
+}
+
+Ref< const IValue > FloatTemplate::unpack(BitReader& reader) const
+{
+	const uint32_t q = reader.readUnsigned(getMaxPackedDataSize());
+	return new FloatValue(dequantize(q));
+}
+
+uint32_t FloatTemplate::getMaxPackedDeltaSize() const
+{
+	if (m_precision == Ftp16)
+		return getMaxPackedDeltaFixedSize(16 + 1);
+	else
+		return 1 + getMaxPackedDataSize();
+}
+
+void FloatTemplate::packDelta(BitWriter& writer, const IValue* Vb, const IValue* V, uint32_t reduce) const
+{
+	const uint32_t qb = quantize(*checked_type_cast< const FloatValue* >(Vb));
+	const uint32_t q = quantize(*checked_type_cast< const FloatValue* >(V));
+
+	// Only 16-bit is worth delta packing; 8-bit and 4-bit are
+	// too small and 32-bit aren't continuous when quantized.
+	// Floats are also not reduced since we cannot tell what
+	// they represent.
+	if (m_precision == Ftp16)
+		packDeltaFixed(writer, int32_t(qb), int32_t(q), 16 + 1, 0);
+	else if (q != qb)
 	{
-	case Ftp32:
-		writer.writeUnsigned(32, *(uint32_t*)&f);
-		break;
-	case Ftp16:
-		{
-			uint32_t uf = uint32_t(clamp((f - m_min) / (m_max - m_min), 0.0f, 1.0f) * 65534.0f + 0.5f);
-			writer.writeUnsigned(16, uf);
-		}
-		break;
-	case Ftp8:
-		{
-			uint32_t uf = uint32_t(clamp((f - m_min) / (m_max - m_min), 0.0f, 1.0f) * 254.0f + 0.5f);
-			writer.writeUnsigned(8, uf);
-		}
-		break;
-	case Ftp4:
-		{
-			uint32_t uf = uint32_t(clamp((f - m_min) / (m_max - m_min), 0.0f, 1.0f) * 14.0f + 0.5f);
-			writer.writeUnsigned(4, uf);
-		}
-		break;
+		writer.writeBit(true);
+		writer.writeUnsigned(getMaxPackedDataSize(), q);
 	}
+	else
+		writer.writeBit(false);
 }
 
-Ref< const IValue > FloatTemplate::unpack(BitReader& reader) const
+Ref< const IValue > FloatTemplate::unpackDelta(BitReader& reader, const IValue* Vb, uint32_t reduce) const
 {
-	switch (m_precision)
+	const uint32_t qb = quantize(*checked_type_cast< const FloatValue* >(Vb));
+	if (m_precision == Ftp16)
 	{
-	case Ftp32:
-		{
-			uint32_t u = reader.readUnsigned(32);
-			return new FloatValue(*(float*)&u);
-		}
-	case Ftp16:
-		{
-			uint32_t uf = reader.readUnsigned(16);
-			float f = (uf / 65534.0f) * (m_max - m_min) + m_min;
-			return new FloatValue(f);
-		}
-	case Ftp8:
-		{
-			uint32_t uf = reader.readUnsigned(8);
-			float f = (uf / 254.0f) * (m_max - m_min) + m_min;
-			return new FloatValue(f);
-		}
-	case Ftp4:
-		{
-			uint32_t uf = reader.readUnsigned(4);
-			float f = (uf / 14.0f) * (m_max - m_min) + m_min;
-			return new FloatValue(f);
-		}
+		const int32_t q = unpackDeltaFixed(reader, int32_t(qb), 16 + 1, 0);
+		return new FloatValue(dequantize(uint32_t(clamp(q, 0, 65534))));
 	}
-	return 0;
+	else if (reader.readBit())
+	{
+		const uint32_t q = reader.readUnsigned(getMaxPackedDataSize());
+		return new FloatValue(dequantize(q));
+	}
+	else
+		return Vb;
 }
 
 Ref< const IValue > FloatTemplate::extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const
@@ -204,4 +202,36 @@ bool FloatTemplate::threshold(const IValue* Vn1, const IValue* V) const
 	return traktor::abs(Fn1 - F0) > m_threshold;
 }
 
+uint32_t FloatTemplate::quantize(float f) const
+{
+	switch (m_precision)
+	{
+	case Ftp32:
+		return *(uint32_t*)&f;
+	case Ftp16:
+		return uint32_t(clamp((f - m_min) / (m_max - m_min), 0.0f, 1.0f) * 65534.0f + 0.5f);
+	case Ftp8:
+		return uint32_t(clamp((f - m_min) / (m_max - m_min), 0.0f, 1.0f) * 254.0f + 0.5f);
+	case Ftp4:
+		return uint32_t(clamp((f - m_min) / (m_max - m_min), 0.0f, 1.0f) * 14.0f + 0.5f);
+	}
+	return 0;
+}
+
+float FloatTemplate::dequantize(uint32_t q) const
+{
+	switch (m_precision)
+	{
+	case Ftp32:
+		return *(float*)&q;
+	case Ftp16:
+		return (q / 65534.0f) * (m_max - m_min) + m_min;
+	case Ftp8:
+		return (q / 254.0f) * (m_max - m_min) + m_min;
+	case Ftp4:
+		return (q / 14.0f) * (m_max - m_min) + m_min;
+	}
+	return 0.0f;
+}
+
 }
@@ -48,6 +48,12 @@ public:
 
 	virtual Ref< const IValue > unpack(BitReader& reader) const override final;
 
+	virtual uint32_t getMaxPackedDeltaSize() const override final;
+
+	virtual void packDelta(BitWriter& writer, const IValue* Vb, const IValue* V, uint32_t reduce) const override final;
+
+	virtual Ref< const IValue > unpackDelta(BitReader& reader, const IValue* Vb, uint32_t reduce) const override final;
+
 	virtual Ref< const IValue > extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const override final;
 
 	virtual bool threshold(const IValue* Vn1, const IValue* V) const override final;
@@ -59,6 +65,10 @@ private:
 	float m_max;
 	FloatTemplatePrecision m_precision;
 	bool m_cyclic;
+
+	uint32_t quantize(float f) const;
+
+	float dequantize(uint32_t q) const;
 };
 
 }
@@ -6,6 +6,11 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cstring>
+#include "Core/Io/BitReader.h"
+#include "Core/Io/BitWriter.h"
+#include "Core/Io/MemoryStream.h"
+#include "Jungle/NetworkTypes.h"
 #include "Jungle/State/IValueTemplate.h"
 
 namespace traktor::jungle
@@ -13,4 +18,44 @@ namespace traktor::jungle
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.jungle.IValueTemplate", IValueTemplate, Object)
 
+uint32_t IValueTemplate::getMaxPackedDeltaSize() const
+{
+	return 1 + getMaxPackedDataSize();
+}
+
+void IValueTemplate::packDelta(BitWriter& writer, const IValue* Vb, const IValue* V, uint32_t reduce) const
+{
+	uint8_t bv[MaxDataSize] = { 0 };
+	uint8_t bb[MaxDataSize] = { 0 };
+
+	// Pack both values and compare packed bits; since receiver will
+	// unpack exactly the same bits there is no need to send anything
+	// but a single bit if they match.
+	MemoryStream sv(bv, sizeof(bv), false, true);
+	BitWriter wv(&sv);
+	pack(wv, V);
+	wv.flush();
+
+	MemoryStream sb(bb, sizeof(bb), false, true);
+	BitWriter wb(&sb);
+	pack(wb, Vb);
+	wb.flush();
+
+	if (sv.tell() == sb.tell() && std::memcmp(bv, bb, sv.tell()) == 0)
+		writer.writeBit(false);
+	else
+	{
+		writer.writeBit(true);
+		pack(writer, V);
+	}
+}
+
+Ref< const IValue > IValueTemplate::unpackDelta(BitReader& reader, const IValue* Vb, uint32_t reduce) const
+{
+	if (!reader.readBit())
+		return Vb;
+	else
+		return unpack(reader);
+}
+
 }
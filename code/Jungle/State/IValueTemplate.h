@@ -45,6 +45,35 @@ public:
 
 	virtual Ref< const IValue > unpack(BitReader& reader) const = 0;
 
+	/*! Get max number of bits required to pack value as a delta.
+	 *
+	 * Default implementation return max packed size plus an "unchanged" bit.
+	 */
+	virtual uint32_t getMaxPackedDeltaSize() const;
+
+	/*! Pack value as delta against baseline value.
+	 *
+	 * Baseline must be value as reconstructed by receiver, ie
+	 * as returned from unpack or unpackDelta.
+	 * Default implementation write a single bit if value pack
+	 * identical to baseline, else entire value is packed.
+	 *
+	 * \param writer Bit writer.
+	 * \param Vb Baseline value.
+	 * \param V Value to pack.
+	 * \param reduce Number of low precision bits which may be dropped from delta.
+	 */
+	virtual void packDelta(BitWriter& writer, const IValue* Vb, const IValue* V, uint32_t reduce) const;
+
+	/*! Unpack value from delta against baseline value.
+	 *
+	 * \param reader Bit reader.
+	 * \param Vb Baseline value.
+	 * \param reduce Number of low precision bits dropped from delta.
+	 * \return Reconstructed value.
+	 */
+	virtual Ref< const IValue > unpackDelta(BitReader& reader, const IValue* Vb, uint32_t reduce) const;
+
 	virtual Ref< const IValue > extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const = 0;
 
 	virtual bool threshold(const IValue* Vn1, const IValue* V) const = 0;
@@ -291,4 +291,100 @@ Ref< const State > StateTemplate::unpack(const void* buffer, uint32_t bufferSize
 	return new State(V);
 }
 
+uint32_t StateTemplate::packDelta(const State* Sb, const State* S, uint32_t reduce, void* buffer, uint32_t bufferSize) const
+{
+	T_FATAL_ASSERT (Sb);
+	T_FATAL_ASSERT (S);
+
+	// Number of values of both states must match template.
+	const RefArray< const IValue >& Vb = Sb->getValues();
+	const RefArray< const IValue >& V = S->getValues();
+	if (Vb.size() != m_valueTemplates.size() || V.size() != m_valueTemplates.size())
+	{
+		log::error << L"State values mismatch template definition." << Endl;
+		return 0;
+	}
+
+	// Ensure all values have correct type.
+	uint32_t maxPackedSize = 3;
+	for (uint32_t i = 0; i < m_valueTemplates.size(); ++i)
+	{
+		const IValueTemplate* valueTemplate = m_valueTemplates[i];
+		T_ASSERT(valueTemplate);
+
+		const TypeInfo& valueType = valueTemplate->getValueType();
+		if (!is_type_a(valueType, type_of(Vb[i])) || !is_type_a(valueType, type_of(V[i])))
+		{
+			log::error << L"Value types mismatch template definition" << Endl;
+			log::error << L"\tDefinition \"" << valueType.getName() << L"\"" << Endl;
+			log::error << L"\tVb \"" << type_of(Vb[i]).getName() << L"\"" << Endl;
+			log::error << L"\tV \"" << type_of(V[i]).getName() << L"\"" << Endl;
+			return 0;
+		}
+
+		maxPackedSize += valueTemplate->getMaxPackedDeltaSize();
+	}
+
+	// Ensure all values fit within output buffer.
+	if ((maxPackedSize + 7) / 8 > bufferSize)
+	{
+		log::error << L"Not enough size in packed buffer to pack all values; state discarded." << Endl;
+		return 0;
+	}
+
+	// Pack all value deltas into buffer.
+	MemoryStream stream(buffer, bufferSize, false, true);
+	BitWriter writer(&stream);
+
+	reduce = std::min< uint32_t >(reduce, 7);
+	writer.writeUnsigned(3, reduce);
+
+	for (uint32_t i = 0; i < m_valueTemplates.size(); ++i)
+	{
+		const IValueTemplate* valueTemplate = m_valueTemplates[i];
+		T_ASSERT(valueTemplate);
+
+		valueTemplate->packDelta(writer, Vb[i], V[i], reduce);
+	}
+
+	writer.flush();
+	return stream.tell();
+}
+
+Ref< const State > StateTemplate::unpackDelta(const State* Sb, const void* buffer, uint32_t bufferSize) const
+{
+	T_FATAL_ASSERT (Sb);
+
+	const RefArray< const IValue >& Vb = Sb->getValues();
+	if (Vb.size() != m_valueTemplates.size())
+	{
+		log::error << L"Baseline state values mismatch template definition." << Endl;
+		return 0;
+	}
+
+	MemoryStream stream(buffer, bufferSize);
+	BitReader reader(&stream);
+
+	const uint32_t reduce = reader.readUnsigned(3);
+
+	RefArray< const IValue > V(m_valueTemplates.size());
+	for (uint32_t i = 0; i < m_valueTemplates.size(); ++i)
+	{
+		const IValueTemplate* valueTemplate = m_valueTemplates[i];
+		T_ASSERT(valueTemplate);
+
+		if ((V[i] = valueTemplate->unpackDelta(reader, Vb[i], reduce)) == 0)
+			return 0;
+	}
+
+	// Must have read all data from buffer.
+	if (stream.available() > 0)
+	{
+		log::error << L"Not all state delta data has been unpacked; entire state discarded." << Endl;
+		return 0;
+	}
+
+	return new State(V);
+}
+
 }
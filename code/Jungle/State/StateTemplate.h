@@ -34,6 +34,26 @@ public:
 
 	Ref< const State > unpack(const void* buffer, uint32_t bufferSize) const;
 
+	/*! Pack state as delta against baseline state.
+	 *
+	 * \param Sb Baseline state, must be a state reconstructed by unpack or unpackDelta.
+	 * \param S State to pack.
+	 * \param reduce Number of low precision bits which may be dropped from deltas, max 7.
+	 * \param buffer Output buffer.
+	 * \param bufferSize Size of output buffer in bytes.
+	 * \return Number of bytes written, 0 if failed.
+	 */
+	uint32_t packDelta(const State* Sb, const State* S, uint32_t reduce, void* buffer, uint32_t bufferSize) const;
+
+	/*! Unpack state from delta against baseline state.
+	 *
+	 * \param Sb Baseline state.
+	 * \param buffer Packed delta.
+	 * \param bufferSize Size of packed delta in bytes.
+	 * \return Reconstructed state.
+	 */
+	Ref< const State > unpackDelta(const State* Sb, const void* buffer, uint32_t bufferSize) const;
+
 private:
 	RefArray< const IValueTemplate > m_valueTemplates;
 };
@@ -13,6 +13,7 @@
 #include "Core/Math/Float.h"
 #include "Core/Math/MathUtils.h"
 #include "Core/Serialization/PackedUnitVector.h"
+#include "Jungle/State/DeltaPacking.h"
 #include "Jungle/State/TransformTemplate.h"
 #include "Jungle/State/TransformValue.h"
 
@@ -61,6 +62,26 @@ private:
 	int32_t m_v;
 };
 
+void quantizeRotation(const Quaternion& rotation, uint16_t& outAxis, int32_t& outAngle)
+{
+	Vector4 R = rotation.toAxisAngle();
+	const Scalar a = R.length();
+	if (abs(a) > FUZZY_EPSILON)
+		R /= a;
+
+	outAxis = PackedUnitVector(R).raw();
+	outAngle = GenericFixedPoint< 4, 11 >(a).raw();
+}
+
+Quaternion dequantizeRotation(uint16_t axis, int32_t angle)
+{
+	const Vector4 R = PackedUnitVector(axis).unpack();
+	const float Ra = GenericFixedPoint< 4, 11 >(angle);
+	return (abs(Ra) > FUZZY_EPSILON && R.length() > FUZZY_EPSILON) ?
+		Quaternion::fromAxisAngle(R, Ra).normalized() :
+		Quaternion::identity();
+}
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.jungle.TransformTemplate", TransformTemplate, IValueTemplate)
@@ -91,13 +112,11 @@ void TransformTemplate::pack(BitWriter& writer, const IValue* V) const
 		writer.writeSigned(13 + 11, GenericFixedPoint< 13, 11 >(e[i]).raw());
 
 	// 16 + (4+11)
-	Vector4 R = v.rotation().toAxisAngle();
-	const Scalar a = R.length();
-	if (abs(a) > FUZZY_EPSILON)
-		R /= a;
-
-	writer.writeUnsigned(16, PackedUnitVector(R).raw());
-	writer.writeSigned(4 + 11, GenericFixedPoint< 4, 11 >(a).raw());
+	uint16_t axis;
+	int32_t angle;
+	quantizeRotation(v.rotation(), axis, angle);
+	writer.writeUnsigned(16, axis);
+	writer.writeSigned(4 + 11, angle);
 }
 
 Ref< const IValue > TransformTemplate::unpack(BitReader& reader) const
@@ -113,19 +132,90 @@ Ref< const IValue > TransformTemplate::unpack(BitReader& reader) const
 	f[3] = 1.0f;
 
 	u = reader.readUnsigned(16);
-	const Vector4 R = PackedUnitVector(u).unpack();
-	const float Ra = GenericFixedPoint< 4, 11 >(reader.readSigned(4 + 11));
+	const int32_t angle = reader.readSigned(4 + 11);
 
 	Transform v(
 		Vector4::loadAligned(f),
-		(abs(Ra) > FUZZY_EPSILON && R.length() > FUZZY_EPSILON) ?
-			Quaternion::fromAxisAngle(R, Ra).normalized() :
-			Quaternion::identity()
+		dequantizeRotation(u, angle)
 	);
 
 	return new TransformValue(v);
 }
 
+uint32_t TransformTemplate::getMaxPackedDeltaSize() const
+{
+	return 3 * getMaxPackedDeltaFixedSize(13 + 11) + 1 + 16 + (4 + 11);
+}
+
+void TransformTemplate::packDelta(BitWriter& writer, const IValue* Vb, const IValue* V, uint32_t reduce) const
+{
+	const Transform vb = *mandatory_non_null_type_cast< const TransformValue* >(Vb);
+	const Transform v = *mandatory_non_null_type_cast< const TransformValue* >(V);
+	float T_MATH_ALIGN16 eb[4];
+	float T_MATH_ALIGN16 e[4];
+
+	// 3 * delta(13+11)
+	vb.translation().storeAligned(eb);
+	v.translation().storeAligned(e);
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		packDeltaFixed(
+			writer,
+			GenericFixedPoint< 13, 11 >(eb[i]).raw(),
+			GenericFixedPoint< 13, 11 >(e[i]).raw(),
+			13 + 11,
+			reduce
+		);
+	}
+
+	// 1 [+ 16 + (4+11)]
+	uint16_t axisb, axis;
+	int32_t angleb, angle;
+	quantizeRotation(vb.rotation(), axisb, angleb);
+	quantizeRotation(v.rotation(), axis, angle);
+	if (axis != axisb || angle != angleb)
+	{
+		writer.writeBit(true);
+		writer.writeUnsigned(16, axis);
+		writer.writeSigned(4 + 11, angle);
+	}
+	else
+		writer.writeBit(false);
+}
+
+Ref< const IValue > TransformTemplate::unpackDelta(BitReader& reader, const IValue* Vb, uint32_t reduce) const
+{
+	const Transform vb = *mandatory_non_null_type_cast< const TransformValue* >(Vb);
+	float T_MATH_ALIGN16 eb[4];
+	float T_MATH_ALIGN16 f[4];
+
+	vb.translation().storeAligned(eb);
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		f[i] = GenericFixedPoint< 13, 11 >(unpackDeltaFixed(
+			reader,
+			GenericFixedPoint< 13, 11 >(eb[i]).raw(),
+			13 + 11,
+			reduce
+		));
+		T_ASSERT(!isNanOrInfinite(f[i]));
+	}
+	f[3] = 1.0f;
+
+	Quaternion rotation = vb.rotation();
+	if (reader.readBit())
+	{
+		const uint16_t axis = reader.readUnsigned(16);
+		const int32_t angle = reader.readSigned(4 + 11);
+		rotation = dequantizeRotation(axis, angle);
+	}
+
+	return new TransformValue(Transform(
+		Vector4::loadAligned(f),
+		rotation
+	));
+}
+
 Ref< const IValue > TransformTemplate::extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const
 {
 	const Transform Sn2 = *mandatory_non_null_type_cast< const TransformValue* >(Vn2);
@@ -13,6 +13,7 @@
 #include "Core/Math/Const.h"
 #include "Core/Math/Float.h"
 #include "Core/Math/MathUtils.h"
+#include "Jungle/State/DeltaPacking.h"
 #include "Jungle/State/VectorValue.h"
 #include "Jungle/State/VectorTemplate.h"
 
@@ -102,6 +103,52 @@ Ref< const IValue > VectorTemplate::unpack(BitReader& reader) const
 	return new VectorValue(Vector4::loadAligned(f));
 }
 
+uint32_t VectorTemplate::getMaxPackedDeltaSize() const
+{
+	return 4 * getMaxPackedDeltaFixedSize(13+11);
+}
+
+void VectorTemplate::packDelta(BitWriter& writer, const IValue* Vb, const IValue* V, uint32_t reduce) const
+{
+	const Vector4 vb = *mandatory_non_null_type_cast< const VectorValue* >(Vb);
+	const Vector4 v = *mandatory_non_null_type_cast< const VectorValue* >(V);
+	float T_MATH_ALIGN16 eb[4];
+	float T_MATH_ALIGN16 e[4];
+
+	vb.storeAligned(eb);
+	v.storeAligned(e);
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		packDeltaFixed(
+			writer,
+			GenericFixedPoint< 13, 11 >(eb[i]).raw(),
+			GenericFixedPoint< 13, 11 >(e[i]).raw(),
+			13+11,
+			reduce
+		);
+	}
+}
+
+Ref< const IValue > VectorTemplate::unpackDelta(BitReader& reader, const IValue* Vb, uint32_t reduce) const
+{
+	const Vector4 vb = *mandatory_non_null_type_cast< const VectorValue* >(Vb);
+	float T_MATH_ALIGN16 eb[4];
+	float T_MATH_ALIGN16 f[4];
+
+	vb.storeAligned(eb);
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		f[i] = GenericFixedPoint< 13, 11 >(unpackDeltaFixed(
+			reader,
+			GenericFixedPoint< 13, 11 >(eb[i]).raw(),
+			13+11,
+			reduce
+		));
+		T_ASSERT(!isNanOrInfinite(f[i]));
+	}
+	return new VectorValue(Vector4::loadAligned(f));
+}
+
 Ref< const IValue > VectorTemplate::extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const
 {
 	const Vector4 Sn2 = *mandatory_non_null_type_cast< const VectorValue* >(Vn2);
@@ -0,0 +1,371 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include <limits>
+#include <list>
+#include <map>
+#include "Core/Log/Log.h"
+#include "Core/Test/MathCompare.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
+#include "Jungle/INetworkTopology.h"
+#include "Jungle/IPeer2PeerProvider.h"
+#include "Jungle/MeasureP2PProvider.h"
+#include "Jungle/Replicator.h"
+#include "Jungle/ReplicatorProxy.h"
+#include "Jungle/State/FloatTemplate.h"
+#include "Jungle/State/FloatValue.h"
+#include "Jungle/State/State.h"
+#include "Jungle/State/StateTemplate.h"
+#include "Jungle/State/TransformTemplate.h"
+#include "Jungle/State/TransformValue.h"
+#include "Jungle/Test/CaseReplicator.h"
+
+namespace traktor::jungle::test
+{
+	namespace
+	{
+
+const int32_t c_peerCount = 64;
+const int32_t c_frameCount = 60;
+
+/*! In-process network, all peers directly connected. */
+class LocalNetwork : public Object
+{
+public:
+	struct Packet
+	{
+		net_handle_t from;
+		AlignedVector< uint8_t > data;
+	};
+
+	std::map< net_handle_t, std::list< Packet > > m_queues;
+	AlignedVector< net_handle_t > m_handles;
+};
+
+class LocalP2PProvider : public IPeer2PeerProvider
+{
+public:
+	explicit LocalP2PProvider(LocalNetwork* network, net_handle_t handle)
+	:	m_network(network)
+	,	m_handle(handle)
+	{
+	}
+
+	virtual bool update() override final { return true; }
+
+	virtual net_handle_t getLocalHandle() const override final { return m_handle; }
+
+	virtual int32_t getPeerCount() const override final { return (int32_t)m_network->m_handles.size(); }
+
+	virtual net_handle_t getPeerHandle(int32_t index) const override final { return m_network->m_handles[index]; }
+
+	virtual std::wstring getPeerName(int32_t index) const override final { return L"Peer"; }
+
+	virtual Object* getPeerUser(int32_t index) const override final { return nullptr; }
+
+	virtual bool setPrimaryPeerHandle(net_handle_t node) override final { return false; }
+
+	virtual net_handle_t getPrimaryPeerHandle() const override final { return m_network->m_handles[0]; }
+
+	virtual bool send(net_handle_t node, const void* data, int32_t size) override final
+	{
+		auto& packet = m_network->m_queues[node].emplace_back();
+		packet.from = m_handle;
+		packet.data.resize(size);
+		std::memcpy(packet.data.ptr(), data, size);
+		return true;
+	}
+
+	virtual int32_t recv(void* data, int32_t size, net_handle_t& outNode) override final
+	{
+		auto& queue = m_network->m_queues[m_handle];
+		if (queue.empty())
+			return 0;
+
+		const auto& packet = queue.front();
+		const int32_t nrecv = std::min< int32_t >(size, (int32_t)packet.data.size());
+		std::memcpy(data, packet.data.c_ptr(), nrecv);
+		outNode = packet.from;
+		queue.pop_front();
+		return nrecv;
+	}
+
+private:
+	Ref< LocalNetwork > m_network;
+	net_handle_t m_handle;
+};
+
+/*! Topology without routing, all peers are connected on first update. */
+class DirectTopology : public INetworkTopology
+{
+public:
+	explicit DirectTopology(IPeer2PeerProvider* provider)
+	:	m_provider(provider)
+	{
+	}
+
+	virtual void setCallback(INetworkCallback* callback) override final { m_callback = callback; }
+
+	virtual net_handle_t getLocalHandle() const override final { return m_provider->getLocalHandle(); }
+
+	virtual bool setPrimaryHandle(net_handle_t node) override final { return m_provider->setPrimaryPeerHandle(node); }
+
+	virtual net_handle_t getPrimaryHandle() const override final { return m_provider->getPrimaryPeerHandle(); }
+
+	virtual int32_t getNodeCount() const override final { return m_provider->getPeerCount(); }
+
+	virtual net_handle_t getNodeHandle(int32_t index) const override final { return m_provider->getPeerHandle(index); }
+
+	virtual std::wstring getNodeName(int32_t index) const override final { return m_provider->getPeerName(index); }
+
+	virtual Object* getNodeUser(int32_t index) const override final { return m_provider->getPeerUser(index); }
+
+	virtual bool isNodeRelayed(int32_t index) const override final { return false; }
+
+	virtual bool send(net_handle_t node, const void* data, int32_t size) override final { return m_provider->send(node, data, size); }
+
+	virtual int32_t recv(void* data, int32_t size, net_handle_t& outNode) override final { return m_provider->recv(data, size, outNode); }
+
+	virtual bool update(double dT) override final
+	{
+		if (!m_connected && m_callback)
+		{
+			for (int32_t i = 0; i < m_provider->getPeerCount(); ++i)
+				m_callback->nodeConnected(this, m_provider->getPeerHandle(i));
+			m_connected = true;
+		}
+		return m_provider->update();
+	}
+
+private:
+	Ref< IPeer2PeerProvider > m_provider;
+	INetworkCallback* m_callback = nullptr;
+	bool m_connected = false;
+};
+
+Ref< StateTemplate > createStateTemplate()
+{
+	Ref< StateTemplate > st = new StateTemplate();
+	st->declare(new TransformTemplate(L"transform"));
+	st->declare(new FloatTemplate(L"health", 1.0f, 0.0f, 100.0f, Ftp16, false));
+	return st;
+}
+
+Ref< State > createState(int32_t peer, int32_t frame, float spacing)
+{
+	// Every other peer is idle; moving peers rise during first quarter and
+	// then keep their height, thus received height can be compared at end
+	// even for far proxies which get states less frequently.
+	const float t = (peer & 1) ? 0.0f : frame / 60.0f;
+	const float h = std::min(t, (c_frameCount / 4) / 60.0f);
+	Ref< State > s = new State();
+	s->pack< TransformValue >(Transform(
+		Vector4(peer * spacing + t, h, t * 0.5f, 1.0f),
+		Quaternion::fromEulerAngles(t * 0.1f, 0.0f, 0.0f)
+	));
+	s->pack< FloatValue >(100.0f - t);
+	return s;
+}
+
+struct SimulationResult
+{
+	int64_t sentBytes = 0;
+	double duration = 0.0;
+	double updateTime = 0.0;
+	float maxError = 0.0f;
+	int32_t dormantCount = 0;
+};
+
+/*! Simulate peers spread along a line, each peer sending it's state to all others.
+ *
+ * \param configuration Replicator configuration.
+ * \param spacing Distance between peers.
+ */
+SimulationResult simulate(const Replicator::Configuration& configuration, float spacing)
+{
+	Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
+	Ref< StateTemplate > st = createStateTemplate();
+	Ref< LocalNetwork > network = new LocalNetwork();
+	RefArray< MeasureP2PProvider > providers;
+	RefArray< Replicator > replicators;
+
+	for (int32_t i = 0; i < c_peerCount; ++i)
+		network->m_handles.push_back(net_handle_t(i + 1));
+
+	for (int32_t i = 0; i < c_peerCount; ++i)
+	{
+		Ref< MeasureP2PProvider > provider = new MeasureP2PProvider(new LocalP2PProvider(network, net_handle_t(i + 1)));
+		Ref< Replicator > replicator = new Replicator();
+		replicator->create(new DirectTopology(provider), configuration);
+		replicator->setStateTemplate(st);
+		replicator->setState(createState(i, 0, spacing));
+		replicator->setSendState(true);
+		providers.push_back(provider);
+		replicators.push_back(replicator);
+	}
+
+	SimulationResult result;
+	Timer timer;
+
+	for (int32_t frame = 0; frame < c_frameCount; ++frame)
+	{
+		const double updateStart = timer.getElapsedTime();
+		for (int32_t i = 0; i < c_peerCount; ++i)
+		{
+			auto replicator = replicators[i];
+			Ref< const State > state = createState(i, frame, spacing);
+			replicator->setOrigin(state->getValue< TransformValue >(0));
+			replicator->setState(state);
+			replicator->update();
+
+			for (uint32_t j = 0; j < replicator->getProxyCount(); ++j)
+			{
+				auto proxy = replicator->getProxy(j);
+				if (!proxy->getSendState())
+				{
+					proxy->setStateTemplate(st);
+					proxy->setSendState(true);
+				}
+
+				// Proxy origin is known from it's replicated state.
+				Ref< const State > proxyState = proxy->getState(replicator->getTime(), 0.0);
+				if (proxyState)
+					proxy->setOrigin(proxyState->getValue< TransformValue >(0));
+			}
+		}
+		result.updateTime += timer.getElapsedTime() - updateStart;
+
+		currentThread->sleep(16);
+	}
+
+	result.duration = timer.getElapsedTime();
+
+	// Last received state of each peer must be close to what it sent; state is
+	// only sent occasionally to dormant proxies thus only peers well within
+	// furthest distance are compared.
+	for (int32_t i = 0; i < c_peerCount; ++i)
+	{
+		auto replicator = replicators[i];
+		for (uint32_t j = 0; j < replicator->getProxyCount(); ++j)
+		{
+			auto proxy = replicator->getProxy(j);
+			if (proxy->isDormant())
+				result.dormantCount++;
+
+			const int32_t peer = int32_t(proxy->getHandle() - 1);
+			if (std::abs(peer - i) * spacing >= configuration.furthestDistance - spacing)
+				continue;
+
+			Ref< const State > state = proxy->getState(replicator->getTime(), 0.0);
+			if (!state)
+			{
+				result.maxError = std::numeric_limits< float >::max();
+				continue;
+			}
+
+			const Transform expected = createState(peer, c_frameCount - 1, spacing)->getValue< TransformValue >(0);
+			const Transform received = state->getValue< TransformValue >(0);
+
+			// State is extrapolated to current time; only compare along axis
+			// which has stopped moving.
+			result.maxError = std::max< float >(result.maxError, abs(expected.translation().y() - received.translation().y()));
+		}
+	}
+
+	for (auto provider : providers)
+		result.sentBytes += provider->getTotalSentBytes();
+
+	for (auto replicator : replicators)
+		replicator->destroy();
+
+	return result;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.jungle.test.CaseReplicator", 0, CaseReplicator, traktor::test::Case)
+
+void CaseReplicator::run()
+{
+	// Delta against baseline must reconstruct same state as full.
+	{
+		Ref< StateTemplate > st = createStateTemplate();
+
+		uint8_t buffer[1024];
+		const uint32_t size = st->pack(createState(0, 0, 0.0f), buffer, sizeof(buffer));
+		CASE_ASSERT(size > 0);
+
+		Ref< const State > Sb = st->unpack(buffer, size);
+		CASE_ASSERT(Sb != nullptr);
+
+		Ref< const State > S = createState(0, 1, 0.0f);
+
+		const uint32_t fullSize = st->pack(S, buffer, sizeof(buffer));
+		Ref< const State > Sf = st->unpack(buffer, fullSize);
+
+		const uint32_t deltaSize = st->packDelta(Sb, S, 0, buffer, sizeof(buffer));
+		CASE_ASSERT(deltaSize > 0);
+		CASE_ASSERT(deltaSize < fullSize);
+
+		Ref< const State > Sd = st->unpackDelta(Sb, buffer, deltaSize);
+		CASE_ASSERT(Sd != nullptr);
+
+		const Transform Tf = Sf->getValue< TransformValue >(0);
+		const Transform Td = Sd->getValue< TransformValue >(0);
+		CASE_ASSERT_COMPARE(Td.translation(), Tf.translation(), traktor::test::compareVectorEqual);
+		CASE_ASSERT_COMPARE(Sd->getValue< FloatValue >(1), Sf->getValue< FloatValue >(1), traktor::test::fuzzyEqual);
+
+		// Unchanged state should only cost a few bits per value.
+		const uint32_t unchangedSize = st->packDelta(Sb, Sb, 0, buffer, sizeof(buffer));
+		CASE_ASSERT(unchangedSize <= 2);
+	}
+
+	// Simulate peers with and without delta compression.
+	{
+		Replicator::Configuration configuration;
+
+		configuration.deltaCompression = false;
+		const SimulationResult full = simulate(configuration, 0.1f);
+
+		configuration.deltaCompression = true;
+		const SimulationResult delta = simulate(configuration, 0.1f);
+
+		log::info << L"Replicator " << c_peerCount << L" peers, full state; " << int32_t(full.sentBytes / full.duration) << L" bytes/s, " << full.updateTime * 1000.0 / c_frameCount << L" ms/frame" << Endl;
+		log::info << L"Replicator " << c_peerCount << L" peers, delta state; " << int32_t(delta.sentBytes / delta.duration) << L" bytes/s, " << delta.updateTime * 1000.0 / c_frameCount << L" ms/frame" << Endl;
+
+		CASE_ASSERT(delta.sentBytes < full.sentBytes);
+		CASE_ASSERT(full.maxError < 0.01f);
+		CASE_ASSERT(delta.maxError < 0.01f);
+	}
+
+	// Simulate peers spread out with and without interest management; peers
+	// beyond furthest distance should become dormant.
+	{
+		Replicator::Configuration configuration;
+
+		configuration.furthestDistance = std::numeric_limits< float >::max();
+		configuration.timeUntilTxStateDormant = configuration.timeUntilTxStateFar;
+		const SimulationResult all = simulate(configuration, 10.0f);
+
+		configuration = Replicator::Configuration();
+		const SimulationResult relevant = simulate(configuration, 10.0f);
+
+		log::info << L"Replicator " << c_peerCount << L" peers, all relevant; " << int32_t(all.sentBytes / all.duration) << L" bytes/s, " << all.updateTime * 1000.0 / c_frameCount << L" ms/frame" << Endl;
+		log::info << L"Replicator " << c_peerCount << L" peers, " << relevant.dormantCount << L" dormant proxies; " << int32_t(relevant.sentBytes / relevant.duration) << L" bytes/s, " << relevant.updateTime * 1000.0 / c_frameCount << L" ms/frame" << Endl;
+
+		CASE_ASSERT(all.dormantCount == 0);
+		CASE_ASSERT(relevant.dormantCount > 0);
+		CASE_ASSERT(relevant.sentBytes < all.sentBytes);
+		CASE_ASSERT(relevant.maxError < 0.01f);
+	}
+}
+
+}
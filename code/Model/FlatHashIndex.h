@@ -0,0 +1,201 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Containers/AlignedVector.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace traktor::model
+{
+
+/*! Open addressing hash index.
+ * \ingroup Model
+ *
+ * Map hashes to indices of values stored elsewhere, several
+ * indices might share same hash. Slots are kept in a single
+ * flat array, using linear probing, thus lookups touch
+ * very few cache lines and no per-entry allocations are made.
+ */
+class FlatHashIndex
+{
+public:
+	static constexpr uint32_t InvalidIndex = ~0U;
+
+	void clear()
+	{
+		for (auto& slot : m_slots)
+			slot.index = InvalidIndex;
+		m_count = 0;
+	}
+
+	void reserve(uint32_t count)
+	{
+		if (count * 2 > (uint32_t)m_slots.size())
+			rehash(count * 2);
+	}
+
+	void insert(uint32_t hash, uint32_t index)
+	{
+		if ((m_count + 1) * 2 > (uint32_t)m_slots.size())
+			rehash(std::max< uint32_t >((m_count + 1) * 2, 16));
+
+		const uint32_t mask = (uint32_t)m_slots.size() - 1;
+		uint32_t i = home(hash);
+		while (m_slots[i].index != InvalidIndex)
+			i = (i + 1) & mask;
+
+		m_slots[i].hash = hash;
+		m_slots[i].index = index;
+		++m_count;
+	}
+
+	void erase(uint32_t hash, uint32_t index)
+	{
+		if (m_slots.empty())
+			return;
+
+		const uint32_t mask = (uint32_t)m_slots.size() - 1;
+		uint32_t i = home(hash);
+		for (;;)
+		{
+			if (m_slots[i].index == InvalidIndex)
+				return;
+			if (m_slots[i].index == index)
+				break;
+			i = (i + 1) & mask;
+		}
+
+		// Shift following slots back into hole, no tombstones necessary.
+		for (uint32_t j = (i + 1) & mask; m_slots[j].index != InvalidIndex; j = (j + 1) & mask)
+		{
+			const uint32_t h = home(m_slots[j].hash);
+			if (((j - h) & mask) >= ((j - i) & mask))
+			{
+				m_slots[i] = m_slots[j];
+				i = j;
+			}
+		}
+
+		m_slots[i].index = InvalidIndex;
+		--m_count;
+	}
+
+	/*! Find first index with hash which is accepted by predicate.
+	 *
+	 * \param hash Hash of value.
+	 * \param predicate Called with candidate index, return true to accept.
+	 * \return Accepted index, InvalidIndex if none accepted.
+	 */
+	template < typename PredicateType >
+	uint32_t find(uint32_t hash, const PredicateType& predicate) const
+	{
+		if (m_slots.empty())
+			return InvalidIndex;
+
+		const uint32_t mask = (uint32_t)m_slots.size() - 1;
+		for (uint32_t i = home(hash); m_slots[i].index != InvalidIndex; i = (i + 1) & mask)
+		{
+			if (m_slots[i].hash == hash && predicate(m_slots[i].index))
+				return m_slots[i].index;
+		}
+
+		return InvalidIndex;
+	}
+
+	uint32_t size() const
+	{
+		return m_count;
+	}
+
+	/*! Get number of slots, each slot is a pair of hash and index. */
+	uint32_t getSlotCount() const
+	{
+		return (uint32_t)m_slots.size();
+	}
+
+	/*! Get slot data, used to store prebuilt index. */
+	const uint32_t* getSlotData() const
+	{
+		return m_slots.empty() ? nullptr : &m_slots[0].hash;
+	}
+
+	/*! Replace slots with prebuilt slot data.
+	 *
+	 * \param slotData Slot data, as returned from getSlotData.
+	 * \param slotCount Number of slots, must be zero or a power of two.
+	 * \param count Number of occupied slots.
+	 * \return True if slot data accepted.
+	 */
+	bool setSlotData(const uint32_t* slotData, uint32_t slotCount, uint32_t count)
+	{
+		if ((slotCount & (slotCount - 1)) != 0 || (slotCount != 0 && slotCount < 16) || count * 2 > slotCount)
+			return false;
+
+		uint32_t shift = 32;
+		for (uint32_t size = 1; size < slotCount; size *= 2)
+			--shift;
+
+		m_slots.resize(slotCount);
+		if (slotCount > 0)
+			std::memcpy(m_slots.ptr(), slotData, slotCount * sizeof(Slot));
+		m_shift = shift;
+		m_count = count;
+		return true;
+	}
+
+private:
+	struct Slot
+	{
+		uint32_t hash;
+		uint32_t index;
+	};
+
+	static_assert(sizeof(Slot) == 2 * sizeof(uint32_t), "Slot must be tightly packed.");
+
+	AlignedVector< Slot > m_slots;
+	uint32_t m_shift = 32;
+	uint32_t m_count = 0;
+
+	uint32_t home(uint32_t hash) const
+	{
+		// Fibonacci hashing, spread poorly distributed hashes over all slots.
+		return (uint32_t)((hash * 0x9E3779B1U) >> m_shift);
+	}
+
+	void rehash(uint32_t minimumSize)
+	{
+		uint32_t size = 16;
+		uint32_t shift = 28;
+		while (size < minimumSize)
+		{
+			size *= 2;
+			--shift;
+		}
+		if (size <= (uint32_t)m_slots.size())
+			return;
+
+		AlignedVector< Slot > slots(size);
+		for (auto& slot : slots)
+			slot.index = InvalidIndex;
+
+		m_slots.swap(slots);
+		m_shift = shift;
+		m_count = 0;
+
+		for (const auto& slot : slots)
+		{
+			if (slot.index != InvalidIndex)
+				insert(slot.hash, slot.index);
+		}
+	}
+};
+
+}
@@ -0,0 +1,366 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Model/Formats/Tmc/ModelFormatTmc.h"
+
+#include "Core/Io/BufferedStream.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IMappedFile.h"
+#include "Core/Io/MemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/Align.h"
+#include "Core/Misc/String.h"
+#include "Core/Serialization/BinarySerializer.h"
+#include "Model/Model.h"
+
+#include <cstring>
+
+namespace traktor::model
+{
+namespace
+{
+
+const uint32_t c_magic = 0x31434d54;	//!< "TMC1"
+const uint32_t c_version = 1;
+const uint32_t c_alignment = 16;
+
+enum Section
+{
+	SnModel,
+	SnPositions,
+	SnPositionIndex,
+	SnColors,
+	SnColorIndex,
+	SnNormals,
+	SnNormalIndex,
+	SnTexCoords,
+	SnTexCoordIndex,
+	SnVertices,
+	SnVertexTexCoords,
+	SnVertexInfluences,
+	SnVertexIndex,
+	SnPolygons,
+	SnPolygonVertices,
+	SnCount
+};
+
+struct Header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t sectionCount;
+	uint32_t reserved;
+	uint64_t sectionOffsets[SnCount];
+	uint64_t sectionSizes[SnCount];
+};
+
+struct VertexRecord
+{
+	uint32_t position;
+	uint32_t color;
+	uint32_t normal;
+	uint32_t tangent;
+	uint32_t binormal;
+	uint32_t texCoordOffset;
+	uint32_t texCoordCount;
+	uint32_t influenceOffset;
+	uint32_t influenceCount;
+};
+
+struct PolygonRecord
+{
+	uint32_t material;
+	uint32_t normal;
+	uint32_t smoothGroup;
+	uint32_t vertexOffset;
+	uint32_t vertexCount;
+};
+
+class SectionWriter
+{
+public:
+	explicit SectionWriter(IStream* stream)
+	:	m_stream(stream)
+	{
+	}
+
+	bool write(Header& header, Section section, const void* data, uint64_t size)
+	{
+		const uint8_t zero[c_alignment] = { 0 };
+		const int64_t offset = m_stream->tell();
+		const int64_t alignedOffset = alignUp(offset, c_alignment);
+		if (alignedOffset > offset && m_stream->write(zero, alignedOffset - offset) != alignedOffset - offset)
+			return false;
+
+		header.sectionOffsets[section] = alignedOffset;
+		header.sectionSizes[section] = size;
+
+		return size == 0 || m_stream->write(data, size) == (int64_t)size;
+	}
+
+	template < typename ItemType >
+	bool write(Header& header, Section section, const AlignedVector< ItemType >& items)
+	{
+		return write(header, section, items.c_ptr(), items.size() * sizeof(ItemType));
+	}
+
+	bool write(Header& header, Section section, const FlatHashIndex& index)
+	{
+		return write(header, section, index.getSlotData(), index.getSlotCount() * 2 * sizeof(uint32_t));
+	}
+
+private:
+	IStream* m_stream;
+};
+
+template < typename ItemType >
+bool readSection(const uint8_t* base, const Header& header, Section section, AlignedVector< ItemType >& outItems)
+{
+	const uint64_t size = header.sectionSizes[section];
+	if ((size % sizeof(ItemType)) != 0)
+		return false;
+
+	outItems.resize(size / sizeof(ItemType));
+	if (size > 0)
+		std::memcpy(outItems.ptr(), base + header.sectionOffsets[section], size);
+	return true;
+}
+
+bool readSection(const uint8_t* base, const Header& header, Section section, uint32_t count, FlatHashIndex& outIndex)
+{
+	const uint64_t size = header.sectionSizes[section];
+	if ((size % (2 * sizeof(uint32_t))) != 0)
+		return false;
+
+	const uint32_t* slotData = (const uint32_t*)(base + header.sectionOffsets[section]);
+	return outIndex.setSlotData(slotData, (uint32_t)(size / (2 * sizeof(uint32_t))), count);
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.model.ModelFormatTmc", 0, ModelFormatTmc, ModelFormat)
+
+void ModelFormatTmc::getExtensions(std::wstring& outDescription, std::vector< std::wstring >& outExtensions) const
+{
+	outDescription = L"Traktor Model Cache";
+	outExtensions.push_back(L"tmc");
+}
+
+bool ModelFormatTmc::supportFormat(const std::wstring& extension) const
+{
+	return compareIgnoreCase(extension, L"tmc") == 0;
+}
+
+Ref< Model > ModelFormatTmc::read(const Path& filePath, const std::wstring& filter) const
+{
+	Ref< IMappedFile > mf = FileSystem::getInstance().map(filePath);
+	if (!mf)
+		return nullptr;
+
+	const uint8_t* base = (const uint8_t*)mf->getBase();
+	const uint64_t fileSize = (uint64_t)mf->getSize();
+
+	Header header;
+	if (fileSize < sizeof(header))
+		return nullptr;
+
+	std::memcpy(&header, base, sizeof(header));
+	if (header.magic != c_magic || header.version != c_version || header.sectionCount != SnCount)
+		return nullptr;
+
+	for (uint32_t i = 0; i < SnCount; ++i)
+	{
+		if (header.sectionOffsets[i] > fileSize || header.sectionSizes[i] > fileSize - header.sectionOffsets[i])
+		{
+			log::error << L"Unable to read cached model \"" << filePath.getPathName() << L"\"; corrupt section." << Endl;
+			return nullptr;
+		}
+	}
+
+	// Materials, joints, animations etc are stored as a serialized model without geometry.
+	Ref< Model > model;
+	{
+		MemoryStream ms(base + header.sectionOffsets[SnModel], header.sectionSizes[SnModel]);
+		if ((model = BinarySerializer(&ms).readObject< Model >()) == nullptr)
+			return nullptr;
+	}
+
+	AlignedVector< Vector4 > positions;
+	AlignedVector< Vector4 > colors;
+	AlignedVector< Vector4 > normals;
+	AlignedVector< Vector2 > texCoords;
+	AlignedVector< VertexRecord > vertexRecords;
+	AlignedVector< uint32_t > vertexTexCoords;
+	AlignedVector< float > vertexInfluences;
+	AlignedVector< PolygonRecord > polygonRecords;
+	AlignedVector< uint32_t > polygonVertices;
+	FlatHashIndex positionIndex, colorIndex, normalIndex, texCoordIndex, vertexIndex;
+
+	if (
+		!readSection(base, header, SnPositions, positions) ||
+		!readSection(base, header, SnColors, colors) ||
+		!readSection(base, header, SnNormals, normals) ||
+		!readSection(base, header, SnTexCoords, texCoords) ||
+		!readSection(base, header, SnVertices, vertexRecords) ||
+		!readSection(base, header, SnVertexTexCoords, vertexTexCoords) ||
+		!readSection(base, header, SnVertexInfluences, vertexInfluences) ||
+		!readSection(base, header, SnPolygons, polygonRecords) ||
+		!readSection(base, header, SnPolygonVertices, polygonVertices) ||
+		!readSection(base, header, SnPositionIndex, (uint32_t)positions.size(), positionIndex) ||
+		!readSection(base, header, SnColorIndex, (uint32_t)colors.size(), colorIndex) ||
+		!readSection(base, header, SnNormalIndex, (uint32_t)normals.size(), normalIndex) ||
+		!readSection(base, header, SnTexCoordIndex, (uint32_t)texCoords.size(), texCoordIndex) ||
+		!readSection(base, header, SnVertexIndex, (uint32_t)vertexRecords.size(), vertexIndex)
+	)
+	{
+		log::error << L"Unable to read cached model \"" << filePath.getPathName() << L"\"; corrupt geometry." << Endl;
+		return nullptr;
+	}
+
+	AlignedVector< Vertex > vertices(vertexRecords.size());
+	for (size_t i = 0; i < vertexRecords.size(); ++i)
+	{
+		const VertexRecord& vr = vertexRecords[i];
+		if (
+			(uint64_t)vr.texCoordOffset + vr.texCoordCount > vertexTexCoords.size() ||
+			(uint64_t)vr.influenceOffset + vr.influenceCount > vertexInfluences.size()
+		)
+			return nullptr;
+
+		Vertex& vertex = vertices[i];
+		vertex.setPosition(vr.position);
+		vertex.setColor(vr.color);
+		vertex.setNormal(vr.normal);
+		vertex.setTangent(vr.tangent);
+		vertex.setBinormal(vr.binormal);
+		for (uint32_t j = 0; j < vr.texCoordCount; ++j)
+			vertex.setTexCoord(j, vertexTexCoords[vr.texCoordOffset + j]);
+		for (uint32_t j = 0; j < vr.influenceCount; ++j)
+			vertex.setJointInfluence(j, vertexInfluences[vr.influenceOffset + j]);
+	}
+
+	auto& polygons = model->m_polygons;
+	polygons.resize(polygonRecords.size());
+	for (size_t i = 0; i < polygonRecords.size(); ++i)
+	{
+		const PolygonRecord& pr = polygonRecords[i];
+		if ((uint64_t)pr.vertexOffset + pr.vertexCount > polygonVertices.size() || pr.vertexCount > Polygon::vertices_t::Capacity)
+			return nullptr;
+
+		Polygon& polygon = polygons[i];
+		polygon.setMaterial(pr.material);
+		polygon.setNormal(pr.normal);
+		polygon.setSmoothGroup(pr.smoothGroup);
+		polygon.setVertices(Polygon::vertices_t(
+			polygonVertices.c_ptr() + pr.vertexOffset,
+			polygonVertices.c_ptr() + pr.vertexOffset + pr.vertexCount
+		));
+	}
+
+	model->m_positions.swap(positions, positionIndex);
+	model->m_colors.swap(colors, colorIndex);
+	model->m_normals.swap(normals, normalIndex);
+	model->m_texCoords.swap(texCoords, texCoordIndex);
+	model->m_vertices.swap(vertices, vertexIndex);
+	return model;
+}
+
+bool ModelFormatTmc::write(const Path& filePath, const Model* model) const
+{
+	// Serialize everything but geometry.
+	DynamicMemoryStream modelStream(false, true);
+	{
+		Model withoutGeometry(*model);
+		withoutGeometry.clear(Model::CfVertices | Model::CfPolygons | Model::CfPositions | Model::CfColors | Model::CfNormals | Model::CfTexCoords);
+		if (!BinarySerializer(&modelStream).writeObject(&withoutGeometry))
+			return false;
+	}
+
+	// Flatten vertices and polygons.
+	AlignedVector< VertexRecord > vertexRecords;
+	AlignedVector< uint32_t > vertexTexCoords;
+	AlignedVector< float > vertexInfluences;
+	vertexRecords.reserve(model->getVertexCount());
+	for (const auto& vertex : model->getVertices())
+	{
+		VertexRecord& vr = vertexRecords.push_back();
+		vr.position = vertex.getPosition();
+		vr.color = vertex.getColor();
+		vr.normal = vertex.getNormal();
+		vr.tangent = vertex.getTangent();
+		vr.binormal = vertex.getBinormal();
+		vr.texCoordOffset = (uint32_t)vertexTexCoords.size();
+		vr.texCoordCount = vertex.getTexCoordCount();
+		vr.influenceOffset = (uint32_t)vertexInfluences.size();
+		vr.influenceCount = vertex.getJointInfluenceCount();
+		for (uint32_t j = 0; j < vr.texCoordCount; ++j)
+			vertexTexCoords.push_back(vertex.getTexCoord(j));
+		for (uint32_t j = 0; j < vr.influenceCount; ++j)
+			vertexInfluences.push_back(vertex.getJointInfluence(j));
+	}
+
+	AlignedVector< PolygonRecord > polygonRecords;
+	AlignedVector< uint32_t > polygonVertices;
+	polygonRecords.reserve(model->getPolygonCount());
+	for (const auto& polygon : model->getPolygons())
+	{
+		PolygonRecord& pr = polygonRecords.push_back();
+		pr.material = polygon.getMaterial();
+		pr.normal = polygon.getNormal();
+		pr.smoothGroup = polygon.getSmoothGroup();
+		pr.vertexOffset = (uint32_t)polygonVertices.size();
+		pr.vertexCount = polygon.getVertexCount();
+		polygonVertices.insert(polygonVertices.end(), polygon.getVertices().begin(), polygon.getVertices().end());
+	}
+
+	Ref< IStream > stream = FileSystem::getInstance().open(filePath, File::FmWrite);
+	if (!stream)
+		return false;
+
+	BufferedStream bs(stream);
+
+	// Reserve space for header, written last when all section offsets are known.
+	Header header;
+	std::memset(&header, 0, sizeof(header));
+	if (bs.write(&header, sizeof(header)) != sizeof(header))
+		return false;
+
+	SectionWriter sw(&bs);
+	const auto& modelBuffer = modelStream.getBuffer();
+	if (
+		!sw.write(header, SnModel, modelBuffer.c_ptr(), modelBuffer.size()) ||
+		!sw.write(header, SnPositions, model->m_positions.values()) ||
+		!sw.write(header, SnPositionIndex, model->m_positions.getIndices()) ||
+		!sw.write(header, SnColors, model->m_colors.values()) ||
+		!sw.write(header, SnColorIndex, model->m_colors.getIndices()) ||
+		!sw.write(header, SnNormals, model->m_normals.values()) ||
+		!sw.write(header, SnNormalIndex, model->m_normals.getIndices()) ||
+		!sw.write(header, SnTexCoords, model->m_texCoords.values()) ||
+		!sw.write(header, SnTexCoordIndex, model->m_texCoords.getIndices()) ||
+		!sw.write(header, SnVertices, vertexRecords) ||
+		!sw.write(header, SnVertexTexCoords, vertexTexCoords) ||
+		!sw.write(header, SnVertexInfluences, vertexInfluences) ||
+		!sw.write(header, SnVertexIndex, model->m_vertices.getIndices()) ||
+		!sw.write(header, SnPolygons, polygonRecords) ||
+		!sw.write(header, SnPolygonVertices, polygonVertices)
+	)
+		return false;
+
+	header.magic = c_magic;
+	header.version = c_version;
+	header.sectionCount = SnCount;
+
+	if (bs.seek(IStream::SeekSet, 0) < 0 || bs.write(&header, sizeof(header)) != sizeof(header))
+		return false;
+
+	bs.flush();
+	return true;
+}
+
+}
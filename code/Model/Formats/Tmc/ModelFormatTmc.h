@@ -0,0 +1,49 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Model/ModelFormat.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_MODEL_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::model
+{
+
+/*! Traktor model cache format.
+ * \ingroup Model
+ *
+ * Binary format used by model cache. Geometry arrays and
+ * prebuilt dedup indices are stored as aligned sections
+ * which are copied directly from a memory mapped file;
+ * no per element deserialization nor rehashing is made.
+ *
+ * Format is versioned; files of other versions are
+ * rejected and thus rebuilt by the cache.
+ */
+class T_DLLCLASS ModelFormatTmc : public ModelFormat
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual void getExtensions(std::wstring& outDescription, std::vector< std::wstring >& outExtensions) const override final;
+
+	virtual bool supportFormat(const std::wstring& extension) const override final;
+
+	virtual Ref< Model > read(const Path& filePath, const std::wstring& filter) const override final;
+
+	virtual bool write(const Path& filePath, const Model* model) const override final;
+};
+
+}
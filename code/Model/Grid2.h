@@ -11,6 +11,7 @@
 #include <cmath>
 #include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Vector2.h"
+#include "Model/FlatHashIndex.h"
 
 namespace traktor::model
 {
@@ -46,30 +47,24 @@ struct DefaultHashFunction2
  *
  * Spatial hash for fast proximity queries over 2D values. Cells are
  * floor-quantised (symmetric around zero — no fat cell at the origin) and
- * indexed into a power-of-two bucket array. \p HashBuckets is the bucket
- * count and trades memory for fewer hash collisions; bump it for large grids.
+ * indexed through an open addressing hash index, which grows with the
+ * number of values.
  */
 template
 <
 	typename ValueType,
 	typename PositionAccessor = DefaultPositionAccessor2< ValueType >,
-	typename HashFunction = DefaultHashFunction2,
-	uint32_t HashBuckets = 4096
+	typename HashFunction = DefaultHashFunction2
 >
 class Grid2
 {
 public:
 	static constexpr uint32_t InvalidIndex = ~0U;
-	static_assert((HashBuckets & (HashBuckets - 1)) == 0, "HashBuckets must be a power of two.");
 
 	explicit Grid2(float cellSize)
 	:	m_cellSize(cellSize)
 	,	m_invCellSize(1.0f / cellSize)
 	{
-		// Bucket array lives on the heap — inline storage would balloon the
-		// containing object (Model embeds several grids) and overflow the stack
-		// of any function that holds a Grid2 by value.
-		m_indices.resize(HashBuckets);
 	}
 
 	const ValueType& get(uint32_t index, const ValueType& defaultValue = ValueType()) const
@@ -84,14 +79,10 @@ public:
 		const int32_t y = floorToInt(p.y * m_invCellSize);
 
 		const uint32_t hash = HashFunction::get(x, y);
-		for (auto index : m_indices[hash & (HashBuckets - 1)])
-		{
+		return m_indices.find(hash, [&](uint32_t index) {
 			const Vector2 pv = PositionAccessor::get(m_values[index]);
-			if ((pv - p).length2() <= 1e-8f)
-				return index;
-		}
-
-		return InvalidIndex;
+			return (pv - p).length2() <= 1e-8f;
+		});
 	}
 
 	uint32_t get(const ValueType& v, float distance) const
@@ -108,12 +99,12 @@ public:
 			for (int32_t ix = -1; ix <= 1; ++ix)
 			{
 				const uint32_t hash = HashFunction::get(cx + ix, cy + iy);
-				for (auto index : m_indices[hash & (HashBuckets - 1)])
-				{
+				const uint32_t found = m_indices.find(hash, [&](uint32_t index) {
 					const Vector2 pv = PositionAccessor::get(m_values[index]);
-					if ((pv - p).length2() <= distance2)
-						return index;
-				}
+					return (pv - p).length2() <= distance2;
+				});
+				if (found != InvalidIndex)
+					return found;
 			}
 		}
 
@@ -128,7 +119,7 @@ public:
 		const uint32_t hash = HashFunction::get(x, y);
 		const uint32_t id = (uint32_t)m_values.size();
 		m_values.push_back(v);
-		m_indices[hash & (HashBuckets - 1)].push_back(id);
+		m_indices.insert(hash, id);
 		return id;
 	}
 
@@ -137,26 +128,17 @@ public:
 		const Vector2 oldPos = PositionAccessor::get(m_values[index]);
 		const int32_t fromX = floorToInt(oldPos.x * m_invCellSize);
 		const int32_t fromY = floorToInt(oldPos.y * m_invCellSize);
-		const uint32_t fromBucket = HashFunction::get(fromX, fromY) & (HashBuckets - 1);
+		const uint32_t fromHash = HashFunction::get(fromX, fromY);
 
 		const Vector2 newPos = PositionAccessor::get(v);
 		const int32_t toX = floorToInt(newPos.x * m_invCellSize);
 		const int32_t toY = floorToInt(newPos.y * m_invCellSize);
-		const uint32_t toBucket = HashFunction::get(toX, toY) & (HashBuckets - 1);
+		const uint32_t toHash = HashFunction::get(toX, toY);
 
-		if (fromBucket != toBucket)
+		if (fromHash != toHash)
 		{
-			auto& indices = m_indices[fromBucket];
-			for (size_t k = 0; k < indices.size(); ++k)
-			{
-				if (indices[k] == index)
-				{
-					indices[k] = indices.back();
-					indices.pop_back();
-					break;
-				}
-			}
-			m_indices[toBucket].push_back(index);
+			m_indices.erase(fromHash, index);
+			m_indices.insert(toHash, index);
 		}
 
 		m_values[index] = v;
@@ -177,13 +159,13 @@ public:
 	void clear()
 	{
 		m_values.clear();
-		for (uint32_t i = 0; i < HashBuckets; ++i)
-			m_indices[i].clear();
+		m_indices.clear();
 	}
 
 	void reserve(size_t capacity)
 	{
 		m_values.reserve(capacity);
+		m_indices.reserve((uint32_t)capacity);
 	}
 
 	uint32_t size() const
@@ -191,13 +173,25 @@ public:
 		return (uint32_t)m_values.size();
 	}
 
+	/*! Swap values and prebuilt index, index must match values and cell size. */
+	void swap(AlignedVector< ValueType >& values, FlatHashIndex& indices)
+	{
+		m_values.swap(values);
+		std::swap(m_indices, indices);
+	}
+
+	const FlatHashIndex& getIndices() const
+	{
+		return m_indices;
+	}
+
 	const AlignedVector< ValueType >& values() const
 	{
 		return m_values;
 	}
 
 private:
-	AlignedVector< AlignedVector< uint32_t > > m_indices;
+	FlatHashIndex m_indices;
 	AlignedVector< ValueType > m_values;
 	float m_cellSize;
 	float m_invCellSize;
@@ -209,8 +203,8 @@ private:
 
 	void rehash()
 	{
-		for (uint32_t i = 0; i < HashBuckets; ++i)
-			m_indices[i].resize(0);
+		m_indices.clear();
+		m_indices.reserve((uint32_t)m_values.size());
 
 		for (uint32_t i = 0; i < (uint32_t)m_values.size(); ++i)
 		{
@@ -218,7 +212,7 @@ private:
 			const int32_t x = floorToInt(p.x * m_invCellSize);
 			const int32_t y = floorToInt(p.y * m_invCellSize);
 			const uint32_t hash = HashFunction::get(x, y);
-			m_indices[hash & (HashBuckets - 1)].push_back(i);
+			m_indices.insert(hash, i);
 		}
 	}
 };
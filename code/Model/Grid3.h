@@ -11,6 +11,7 @@
 #include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Const.h"
 #include "Core/Math/Vector4.h"
+#include "Model/FlatHashIndex.h"
 
 namespace traktor::model
 {
@@ -46,31 +47,24 @@ struct DefaultHashFunction3
  * \ingroup Model
  *
  * Spatial hash for fast proximity queries over 3D values. Cells are
- * floor-quantised and indexed into a power-of-two bucket array.
- * \p HashBuckets is the bucket count and trades memory for fewer hash
- * collisions; bump it for large grids.
+ * floor-quantised and indexed through an open addressing hash index,
+ * which grows with the number of values.
  */
 template
 <
 	typename ValueType,
 	typename PositionAccessor = DefaultPositionAccessor3< ValueType >,
-	typename HashFunction = DefaultHashFunction3,
-	uint32_t HashBuckets = 4096
+	typename HashFunction = DefaultHashFunction3
 >
 class Grid3
 {
 public:
 	static constexpr uint32_t InvalidIndex = ~0U;
-	static_assert((HashBuckets & (HashBuckets - 1)) == 0, "HashBuckets must be a power of two.");
 
 	explicit Grid3(float cellSize)
 	:	m_cellSize(cellSize)
 	,	m_invCellSize(1.0f / cellSize)
 	{
-		// Bucket array lives on the heap — inline storage would balloon the
-		// containing object (Model embeds several grids) and overflow the stack
-		// of any function that holds a Grid3 by value.
-		m_indices.resize(HashBuckets);
 	}
 
 	const ValueType& get(uint32_t index, const ValueType& defaultValue = ValueType()) const
@@ -82,26 +76,17 @@ public:
 	{
 		T_MATH_ALIGN16 int32_t fc[4];
 		cellOf(PositionAccessor::get(m_values[index]), fc);
-		const uint32_t fromBucket = HashFunction::get(fc[0], fc[1], fc[2]) & (HashBuckets - 1);
+		const uint32_t fromHash = HashFunction::get(fc[0], fc[1], fc[2]);
 
 		const Vector4 newPos = PositionAccessor::get(v);
 		T_MATH_ALIGN16 int32_t tc[4];
 		cellOf(newPos, tc);
-		const uint32_t toBucket = HashFunction::get(tc[0], tc[1], tc[2]) & (HashBuckets - 1);
+		const uint32_t toHash = HashFunction::get(tc[0], tc[1], tc[2]);
 
-		if (fromBucket != toBucket)
+		if (fromHash != toHash)
 		{
-			auto& indices = m_indices[fromBucket];
-			for (size_t k = 0; k < indices.size(); ++k)
-			{
-				if (indices[k] == index)
-				{
-					indices[k] = indices.back();
-					indices.pop_back();
-					break;
-				}
-			}
-			m_indices[toBucket].push_back(index);
+			m_indices.erase(fromHash, index);
+			m_indices.insert(toHash, index);
 		}
 
 		m_values[index] = v;
@@ -114,14 +99,10 @@ public:
 		cellOf(p, c);
 
 		const uint32_t hash = HashFunction::get(c[0], c[1], c[2]);
-		for (auto index : m_indices[hash & (HashBuckets - 1)])
-		{
+		return m_indices.find(hash, [&](uint32_t index) {
 			const Vector4 pv = PositionAccessor::get(m_values[index]);
-			if ((pv - p).length2() <= Scalar(FUZZY_EPSILON))
-				return index;
-		}
-
-		return InvalidIndex;
+			return (pv - p).length2() <= Scalar(FUZZY_EPSILON);
+		});
 	}
 
 	uint32_t get(const ValueType& v, const Scalar& distance) const
@@ -143,12 +124,12 @@ public:
 				for (int32_t ix = -1; ix <= 1; ++ix)
 				{
 					const uint32_t hash = HashFunction::get(c[0] + ix, c[1] + iy, c[2] + iz);
-					for (auto index : m_indices[hash & (HashBuckets - 1)])
-					{
+					const uint32_t found = m_indices.find(hash, [&](uint32_t index) {
 						const Vector4 pv = PositionAccessor::get(m_values[index]);
-						if ((pv - p).length2() <= distance2)
-							return index;
-					}
+						return (pv - p).length2() <= distance2;
+					});
+					if (found != InvalidIndex)
+						return found;
 				}
 			}
 		}
@@ -166,7 +147,7 @@ public:
 		const uint32_t id = (uint32_t)m_values.size();
 
 		m_values.push_back(v);
-		m_indices[hash & (HashBuckets - 1)].push_back(id);
+		m_indices.insert(hash, id);
 		return id;
 	}
 
@@ -185,13 +166,13 @@ public:
 	void clear()
 	{
 		m_values.clear();
-		for (uint32_t i = 0; i < HashBuckets; ++i)
-			m_indices[i].clear();
+		m_indices.clear();
 	}
 
 	void reserve(size_t capacity)
 	{
 		m_values.reserve(capacity);
+		m_indices.reserve((uint32_t)capacity);
 	}
 
 	uint32_t size() const
@@ -199,13 +180,25 @@ public:
 		return (uint32_t)m_values.size();
 	}
 
+	/*! Swap values and prebuilt index, index must match values and cell size. */
+	void swap(AlignedVector< ValueType >& values, FlatHashIndex& indices)
+	{
+		m_values.swap(values);
+		std::swap(m_indices, indices);
+	}
+
+	const FlatHashIndex& getIndices() const
+	{
+		return m_indices;
+	}
+
 	const AlignedVector< ValueType >& values() const
 	{
 		return m_values;
 	}
 
 private:
-	AlignedVector< AlignedVector< uint32_t > > m_indices;
+	FlatHashIndex m_indices;
 	AlignedVector< ValueType > m_values;
 	Scalar m_cellSize;
 	Scalar m_invCellSize;
@@ -219,8 +212,8 @@ private:
 
 	void rehash()
 	{
-		for (uint32_t i = 0; i < HashBuckets; ++i)
-			m_indices[i].resize(0);
+		m_indices.clear();
+		m_indices.reserve((uint32_t)m_values.size());
 
 		for (uint32_t i = 0; i < (uint32_t)m_values.size(); ++i)
 		{
@@ -229,7 +222,7 @@ private:
 			cellOf(p, c);
 
 			const uint32_t hash = HashFunction::get(c[0], c[1], c[2]);
-			m_indices[hash & (HashBuckets - 1)].push_back(i);
+			m_indices.insert(hash, i);
 		}
 	}
 };
@@ -1,6 +1,6 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022-2024 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,9 +8,8 @@
  */
 #pragma once
 
-#include <unordered_map>
-#include "Core/Containers/SmallMap.h"
-#include "Core/Containers/SmallSet.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Model/FlatHashIndex.h"
 
 namespace traktor::model
 {
@@ -30,23 +29,13 @@ public:
 	void swap(AlignedVector< ValueType >& values)
 	{
 		m_values.swap(values);
-		m_indices.clear();		
-		for (uint32_t i = 0; i < (uint32_t)m_values.size(); ++i)
-		{
-			const uint32_t hash = HashFunction::get(m_values[i]);
-			m_indices[hash].insert(i);
-		}
+		rehash();
 	}
 
 	void replace(const AlignedVector< ValueType >& values)
 	{
 		m_values = values;
-		m_indices.clear();
-		for (uint32_t i = 0; i < (uint32_t)m_values.size(); ++i)
-		{
-			const uint32_t hash = HashFunction::get(m_values[i]);
-			m_indices[hash].insert(i);
-		}
+		rehash();
 	}
 
 	void reserve(uint32_t capacity)
@@ -65,46 +54,33 @@ public:
 		const uint32_t hash = HashFunction::get(v);
 		const uint32_t index = (uint32_t)m_values.size();
 		m_values.push_back(v);
-		m_indices[hash].insert(index);
+		m_indices.insert(hash, index);
 		return index;
 	}
 
 	void set(uint32_t index, const ValueType& v)
 	{
-		// Remove old index.
-		{
-			const uint32_t hash = HashFunction::get(m_values[index]);
-			m_indices[hash].erase(index);
-		}
-
-		// Replace value.
+		m_indices.erase(HashFunction::get(m_values[index]), index);
 		m_values[index] = v;
-
-		// Add new index.
-		{
-			const uint32_t hash = HashFunction::get(v);
-			m_indices[hash].insert(index);
-		}
+		m_indices.insert(HashFunction::get(v), index);
 	}
 
 	uint32_t find(const ValueType& v) const
 	{
 		const uint32_t hash = HashFunction::get(v);
+		return m_indices.find(hash, [&](uint32_t index) {
+			return m_values[index] == v;
+		});
+	}
 
-		const auto it = m_indices.find(hash);
-		if (it == m_indices.end())
-			return InvalidIndex;
-
-		for (uint32_t index : it->second)
-		{
-			if (m_values[index] == v)
-				return index;
-		}
-
-		return InvalidIndex;
+	/*! Swap values and prebuilt index, index must match values. */
+	void swap(AlignedVector< ValueType >& values, FlatHashIndex& indices)
+	{
+		m_values.swap(values);
+		std::swap(m_indices, indices);
 	}
 
-	const std::unordered_map< uint32_t, SmallSet< uint32_t > >& indices() const
+	const FlatHashIndex& getIndices() const
 	{
 		return m_indices;
 	}
@@ -120,8 +96,16 @@ public:
 	}
 
 private:
-	std::unordered_map< uint32_t, SmallSet< uint32_t > > m_indices;
-	AlignedVector< ValueType > m_values;	
+	FlatHashIndex m_indices;
+	AlignedVector< ValueType > m_values;
+
+	void rehash()
+	{
+		m_indices.clear();
+		m_indices.reserve((uint32_t)m_values.size());
+		for (uint32_t i = 0; i < (uint32_t)m_values.size(); ++i)
+			m_indices.insert(HashFunction::get(m_values[i]), i);
+	}
 };
 
 }
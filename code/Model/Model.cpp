@@ -454,8 +454,9 @@ bool Model::apply(const RefArray< const IModelOperation >& operations)
 	const IModelOperation* lastOperation = nullptr;
 	for (auto operation : operations)
 	{
+		// Skip redundant operations but continue with rest of chain.
 		if (lastOperation != nullptr && !operation->required(lastOperation))
-			return true;
+			continue;
 
 		if (!operation->apply(*this))
 			return false;
@@ -539,12 +540,8 @@ void Model::serialize(ISerializer& s)
 
 void Model::validate() const
 {
-	for (const auto& indices : m_vertices.indices())
-	{
-		T_FATAL_ASSERT(!indices.second.empty());
-		for (auto vertexId : indices.second)
-			T_FATAL_ASSERT(vertexId < m_vertices.size());
-	}
+	for (uint32_t i = 0; i < m_vertices.size(); ++i)
+		T_FATAL_ASSERT(m_vertices.find(m_vertices[i]) != m_vertices.InvalidIndex);
 
 	for (const auto& polygon : m_polygons)
 	{
@@ -286,6 +286,8 @@ public:
 	virtual void serialize(ISerializer& s) override final;
 
 private:
+	friend class ModelFormatTmc;
+
 	AlignedVector< Material > m_materials;
 	HashVector< Vertex, VertexHashFunction > m_vertices;
 	AlignedVector< Polygon > m_polygons;
@@ -6,11 +6,36 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include "Core/Thread/ParallelFor.h"
 #include "Model/Model.h"
 #include "Model/ModelAdjacency.h"
 
 namespace traktor::model
 {
+	namespace
+	{
+
+const uint32_t c_polygonsPerJob = 4096;
+const uint32_t c_edgesPerJob = 16384;
+
+struct EdgeKey
+{
+	uint64_t key;
+	uint32_t edge;
+
+	bool operator < (const EdgeKey& rh) const
+	{
+		return key < rh.key || (key == rh.key && edge < rh.edge);
+	}
+};
+
+uint64_t edgeKey(uint32_t index0, uint32_t index1)
+{
+	return (uint64_t(index0) << 32) | uint64_t(index1);
+}
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.model.ModelAdjacency", ModelAdjacency, Object)
 
@@ -19,9 +44,10 @@ ModelAdjacency::ModelAdjacency(const Model* model, Mode mode, uint32_t channel)
 ,	m_mode(mode)
 ,	m_channel(channel)
 {
-	m_polygonToFirstEdge.resize(model->getPolygonCount(), c_InvalidIndex);
+	AlignedVector< uint32_t > polygons(model->getPolygonCount());
 	for (uint32_t i = 0; i < model->getPolygonCount(); ++i)
-		add(i);
+		polygons[i] = i;
+	build(polygons);
 }
 
 ModelAdjacency::ModelAdjacency(const Model* model, const AlignedVector< uint32_t >& polygons, Mode mode, uint32_t channel)
@@ -29,9 +55,7 @@ ModelAdjacency::ModelAdjacency(const Model* model, const AlignedVector< uint32_t
 ,	m_mode(mode)
 ,	m_channel(channel)
 {
-	m_polygonToFirstEdge.resize(polygons.size(), c_InvalidIndex);
-	for (auto polygon : polygons)
-		add(polygon);
+	build(polygons);
 }
 
 void ModelAdjacency::add(uint32_t polygon)
@@ -365,6 +389,95 @@ void ModelAdjacency::getEdgeIndices(uint32_t edge, uint32_t& outIndex0, uint32_t
 	}
 }
 
+void ModelAdjacency::build(const AlignedVector< uint32_t >& polygons)
+{
+	m_polygonToFirstEdge.resize(m_model->getPolygonCount(), c_InvalidIndex);
+
+	// Allocate edges of all polygons.
+	AlignedVector< uint32_t > firstEdges(polygons.size());
+	uint32_t edgeCount = 0;
+	for (uint32_t i = 0; i < (uint32_t)polygons.size(); ++i)
+	{
+		const uint32_t vertexCount = m_model->getPolygon(polygons[i]).getVertexCount();
+		firstEdges[i] = edgeCount;
+		if (vertexCount > 0)
+		{
+			T_FATAL_ASSERT(m_polygonToFirstEdge[polygons[i]] == c_InvalidIndex);
+			m_polygonToFirstEdge[polygons[i]] = edgeCount;
+		}
+		edgeCount += vertexCount;
+	}
+	m_edges.resize(edgeCount);
+
+	// Resolve edge indices and sort keys.
+	AlignedVector< EdgeKey > keys(edgeCount);
+	parallelFor((uint32_t)polygons.size(), c_polygonsPerJob, [&](uint32_t from, uint32_t to) {
+		for (uint32_t i = from; i < to; ++i)
+		{
+			const uint32_t vertexCount = m_model->getPolygon(polygons[i]).getVertexCount();
+			for (uint32_t j = 0; j < vertexCount; ++j)
+			{
+				const uint32_t edge = firstEdges[i] + j;
+				Edge& e = m_edges[edge];
+				e.polygon = polygons[i];
+				e.polygonEdge = j;
+				getEdgeIndices(edge, e.index0, e.index1);
+				keys[edge] = { edgeKey(e.index0, e.index1), edge };
+			}
+		}
+	});
+	std::sort(keys.begin(), keys.end());
+
+	// Sharing edges are those with opposite direction; count them first so share data can be tightly packed.
+	auto findOpposite = [&](const Edge& e) {
+		const EdgeKey lower = { edgeKey(e.index1, e.index0), 0 };
+		const EdgeKey upper = { edgeKey(e.index1, e.index0), c_InvalidIndex };
+		return std::make_pair(
+			std::lower_bound(keys.begin(), keys.end(), lower),
+			std::upper_bound(keys.begin(), keys.end(), upper)
+		);
+	};
+
+	parallelFor(edgeCount, c_edgesPerJob, [&](uint32_t from, uint32_t to) {
+		for (uint32_t i = from; i < to; ++i)
+		{
+			Edge& e = m_edges[i];
+			const auto range = findOpposite(e);
+			uint32_t count = 0;
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->edge != i)
+					++count;
+			}
+			e.shareDataCount = count;
+			e.shareDataCapacity = count;
+		}
+	});
+
+	uint32_t shareDataSize = 0;
+	for (auto& e : m_edges)
+	{
+		e.shareDataOffset = shareDataSize;
+		shareDataSize += e.shareDataCapacity;
+	}
+	m_shareData.resize(shareDataSize);
+
+	// Sharing edges are stored in ascending order, same as if polygons are added one by one.
+	parallelFor(edgeCount, c_edgesPerJob, [&](uint32_t from, uint32_t to) {
+		for (uint32_t i = from; i < to; ++i)
+		{
+			const Edge& e = m_edges[i];
+			const auto range = findOpposite(e);
+			uint32_t* shareData = m_shareData.ptr() + e.shareDataOffset;
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->edge != i)
+					*shareData++ = it->edge;
+			}
+		}
+	});
+}
+
 void ModelAdjacency::shareDataPushBack(Edge& edge, uint32_t value)
 {
 	if (edge.shareDataCount >= edge.shareDataCapacity)
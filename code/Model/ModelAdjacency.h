@@ -114,6 +114,8 @@ private:
 	AlignedVector< uint32_t > m_polygonToFirstEdge;
 	AlignedVector< uint32_t > m_shareData;
 
+	void build(const AlignedVector< uint32_t >& polygons);
+
 	void shareDataPushBack(Edge& edge, uint32_t value);
 
 	void shareDataErase(Edge& edge, uint32_t index);
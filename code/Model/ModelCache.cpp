@@ -15,6 +15,7 @@
 #include "Core/Singleton/SingletonManager.h"
 #include "Core/Thread/Acquire.h"
 #include "Core/Thread/JobManager.h"
+#include "Core/Thread/Signal.h"
 #include "Model/Model.h"
 #include "Model/ModelCache.h"
 #include "Model/ModelFormat.h"
@@ -24,7 +25,7 @@ namespace traktor::model
 	namespace
 	{
 
-const static int32_t c_cacheVersion = 1;
+const static int32_t c_cacheVersion = 2;
 
 uint32_t hash(const std::wstring& text)
 {
@@ -37,6 +38,12 @@ uint32_t hash(const std::wstring& text)
 
 	}
 
+class ModelCache::PendingLoad : public Object
+{
+public:
+	Signal loaded;
+};
+
 ModelCache& ModelCache::getInstance()
 {
 	static ModelCache* s_instance = nullptr;
@@ -62,38 +69,69 @@ Ref< const Model > ModelCache::get(const Path& cachePath, const Path& fileName,
 	if (!file)
 		return nullptr;
 
-	// First check if we have recent model loaded into memory.
-	auto it = m_models.find(key);
-	if (it != m_models.end())
+	// First check if we have recent model loaded into memory, or
+	// if another thread is already loading the same model.
+	Ref< PendingLoad > pending;
+	for (;;)
 	{
-		if (it->second.timeStamp >= file->getLastWriteTime())
-			return it->second.model;
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+			auto it = m_models.find(key);
+			if (it != m_models.end() && it->second.timeStamp >= file->getLastWriteTime())
+				return it->second.model;
+
+			auto it2 = m_pending.find(key);
+			if (it2 == m_pending.end())
+			{
+				pending = new PendingLoad();
+				m_pending.insert(key, pending);
+				break;
+			}
+			pending = it2->second;
+		}
+		pending->loaded.wait();
 	}
 
+	Ref< const Model > model = load(cachePath, fileName, filter, file);
+
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		if (model)
+			m_models.insert(key, { model, file->getLastWriteTime() });
+		m_pending.remove(key);
+	}
+
+	pending->loaded.set();
+	return model;
+}
+
+Ref< Model > ModelCache::getMutable(const Path& cachePath, const Path& fileName, const std::wstring& filter)
+{
+	Ref< const Model > model = get(cachePath, fileName, filter);
+	return model != nullptr ? DeepClone(model).create< Model >() : nullptr;
+}
+
+
+Ref< const Model > ModelCache::load(const Path& cachePath, const Path& fileName, const std::wstring& filter, const File* file)
+{
 	// Calculate hash of resolved file name.
 	const uint32_t fileNameHash = hash(fileName.getPathName() + L"!" + filter);
 
 	// Generate file name of cached model.
-	const Path cachedFileName = cachePath.getPathName() + L"/" + str(L"%08x_%d.tmd", fileNameHash, c_cacheVersion);
+	const Path cachedFileName = cachePath.getPathName() + L"/" + str(L"%08x_%d.tmc", fileNameHash, c_cacheVersion);
 
 	// Check if cached file exist and if it's time stamp match source file's.
-	bool haveCachedFile = false;
-	{
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-		Ref< File > cachedFile = FileSystem::getInstance().get(cachedFileName);
-		if (cachedFile != nullptr && file->getLastWriteTime() <= cachedFile->getLastWriteTime())
-			haveCachedFile = true;
-	}
-	if (haveCachedFile)
+	Ref< File > cachedFile = FileSystem::getInstance().get(cachedFileName);
+	if (cachedFile != nullptr && file->getLastWriteTime() <= cachedFile->getLastWriteTime())
 	{
 		// Valid cache entry found; read from model from cache,
 		// do not use filter as it's written into cache after filter has been applied.
 		Ref< const Model > model = ModelFormat::readAny(cachedFileName, L"");
-		{
-			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-			m_models.insert(key, { model, file->getLastWriteTime() });
-		}
-		return model;
+		if (model)
+			return model;
+
+		log::warning << L"Unable to read cached model \"" << cachedFileName.getPathName() << L"\"; reading source model." << Endl;
 	}
 
 	// No cached file exist; need to read source model.
@@ -101,39 +139,26 @@ Ref< const Model > ModelCache::get(const Path& cachePath, const Path& fileName,
 	if (!model)
 		return nullptr;
 
-	{
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-
-		// Add model to memory map.
-		m_models.insert(key, { model, file->getLastWriteTime() });
-
-		// Write cached copy of post-operation model.
-		const Path intermediateFileName = cachedFileName.getPathNameNoExtension() + L"~." + cachedFileName.getExtension();
-		JobManager::getInstance().add([=]() {
-			if (!FileSystem::getInstance().makeAllDirectories(cachedFileName.getPathOnly()))
-			{
-				log::error << L"Unable to create model cache directory." << Endl;
-				return;
-			}
+	// Write cached copy of post-operation model.
+	const Path intermediateFileName = cachedFileName.getPathNameNoExtension() + L"~." + cachedFileName.getExtension();
+	JobManager::getInstance().add([=]() {
+		if (!FileSystem::getInstance().makeAllDirectories(cachedFileName.getPathOnly()))
+		{
+			log::error << L"Unable to create model cache directory." << Endl;
+			return;
+		}
 
-			if (!ModelFormat::writeAny(intermediateFileName, model))
-			{
-				log::error << L"Unable to write model into cache directory." << Endl;
-				return;
-			}
+		if (!ModelFormat::writeAny(intermediateFileName, model))
+		{
+			log::error << L"Unable to write model into cache directory." << Endl;
+			return;
+		}
 
-			FileSystem::getInstance().move(cachedFileName, intermediateFileName, true);
-		});
-	}
+		FileSystem::getInstance().move(cachedFileName, intermediateFileName, true);
+	});
 
 	// Return model; should be same as one we've written to cache.
 	return model;
 }
 
-Ref< Model > ModelCache::getMutable(const Path& cachePath, const Path& fileName, const std::wstring& filter)
-{
-	Ref< const Model > model = get(cachePath, fileName, filter);
-	return model != nullptr ? DeepClone(model).create< Model >() : nullptr;
-}
-
 }
@@ -26,6 +26,7 @@
 namespace traktor
 {
 
+class File;
 class IStream;
 
 }
@@ -35,8 +36,13 @@ namespace traktor::model
 
 class Model;
 
-/*!
+/*! Cache of imported models.
  * \ingroup Model
+ *
+ * Imported models are cached both in memory and on disk, using
+ * the memory mapped model cache format. Cache is safe to use from
+ * multiple threads; concurrent requests of the same model
+ * wait for a single load to finish.
  */
 class T_DLLCLASS ModelCache : public ISingleton
 {
@@ -50,6 +56,8 @@ public:
 	Ref< Model > getMutable(const Path& cachePath, const Path& fileName, const std::wstring& filter);
 
 private:
+	class PendingLoad;
+
 	struct ModelWithStamp
 	{
 		Ref< const Model > model;
@@ -58,6 +66,9 @@ private:
 
 	Semaphore m_lock;
 	SmallMap< std::pair< Path, std::wstring >, ModelWithStamp > m_models;
+	SmallMap< std::pair< Path, std::wstring >, Ref< PendingLoad > > m_pending;
+
+	Ref< const Model > load(const Path& cachePath, const Path& fileName, const std::wstring& filter, const File* file);
 };
 
 }
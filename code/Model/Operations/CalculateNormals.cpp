@@ -9,6 +9,7 @@
 #include "Core/Log/Log.h"
 #include "Core/Math/Const.h"
 #include "Core/Math/Vector4.h"
+#include "Core/Thread/ParallelFor.h"
 #include "Model/Model.h"
 #include "Model/Operations/CalculateNormals.h"
 
@@ -17,6 +18,8 @@ namespace traktor::model
 	namespace
 	{
 
+const uint32_t c_polygonsPerJob = 4096;
+
 bool findBaseIndex(const Model& model, const Polygon& polygon, uint32_t& outBaseIndex)
 {
 	outBaseIndex = c_InvalidIndex;
@@ -63,48 +66,46 @@ bool CalculateNormals::apply(Model& model) const
 	const AlignedVector< Polygon >& polygons = model.getPolygons();
 	AlignedVector< Vector4 > polygonNormals;
 	AlignedVector< Vector4 > positionNormals;
-	uint32_t degenerated = 0;
 
-	// Calculate tangent base for each polygon.
+	// Calculate tangent base for each polygon, polygons are independent thus calculated in parallel.
 	polygonNormals.resize(polygons.size(), Vector4::zero());
-	for (uint32_t i = 0; i < uint32_t(polygons.size()); ++i)
-	{
-		const Polygon& polygon = polygons[i];
-		uint32_t baseIndex;
+	parallelFor((uint32_t)polygons.size(), c_polygonsPerJob, [&](uint32_t from, uint32_t to) {
+		for (uint32_t i = from; i < to; ++i)
+		{
+			const Polygon& polygon = polygons[i];
+			uint32_t baseIndex;
 
-		if (polygon.getVertexCount() < 3)
-			continue;
+			if (polygon.getVertexCount() < 3)
+				continue;
 
-		if (!findBaseIndex(model, polygon, baseIndex))
-		{
-			++degenerated;
-			continue;
-		}
+			if (!findBaseIndex(model, polygon, baseIndex))
+				continue;
 
-		const auto& vertices = polygon.getVertices();
-		const Vertex* v[] =
-		{
-			&model.getVertex(vertices[baseIndex]),
-			&model.getVertex(vertices[(baseIndex + 1) % vertices.size()]),
-			&model.getVertex(vertices[(baseIndex + 2) % vertices.size()])
-		};
+			const auto& vertices = polygon.getVertices();
+			const Vertex* v[] =
+			{
+				&model.getVertex(vertices[baseIndex]),
+				&model.getVertex(vertices[(baseIndex + 1) % vertices.size()]),
+				&model.getVertex(vertices[(baseIndex + 2) % vertices.size()])
+			};
 
-		const Vector4 p[] =
-		{
-			model.getPosition(v[0]->getPosition()),
-			model.getPosition(v[1]->getPosition()),
-			model.getPosition(v[2]->getPosition())
-		};
+			const Vector4 p[] =
+			{
+				model.getPosition(v[0]->getPosition()),
+				model.getPosition(v[1]->getPosition()),
+				model.getPosition(v[2]->getPosition())
+			};
 
-		Vector4 ep[] = { p[2] - p[0], p[1] - p[0] };
-		T_ASSERT(ep[0].length() > FUZZY_EPSILON);
-		T_ASSERT(ep[1].length() > FUZZY_EPSILON);
+			Vector4 ep[] = { p[2] - p[0], p[1] - p[0] };
+			T_ASSERT(ep[0].length() > FUZZY_EPSILON);
+			T_ASSERT(ep[1].length() > FUZZY_EPSILON);
 
-		ep[0] = ep[0].normalized();
-		ep[1] = ep[1].normalized();
+			ep[0] = ep[0].normalized();
+			ep[1] = ep[1].normalized();
 
-		polygonNormals[i] = cross(ep[0], ep[1]).normalized();
-	}
+			polygonNormals[i] = cross(ep[0], ep[1]).normalized();
+		}
+	});
 
 	// Build new vertex normals.
 	positionNormals.resize(model.getPositionCount(), Vector4::zero());
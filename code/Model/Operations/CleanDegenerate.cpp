@@ -1,17 +1,24 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022-2024 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Core/Math/Const.h"
+#include "Core/Thread/ParallelFor.h"
 #include "Model/Model.h"
 #include "Model/Operations/CleanDegenerate.h"
 
 namespace traktor::model
 {
+	namespace
+	{
+
+const uint32_t c_polygonsPerJob = 4096;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.model.CleanDegenerate", CleanDegenerate, IModelOperation)
 
@@ -23,13 +30,15 @@ bool CleanDegenerate::required(const IModelOperation* lastOperation) const
 bool CleanDegenerate::apply(Model& model) const
 {
 	auto& polygons = model.getPolygons();
-	for (size_t i = 0; i < polygons.size(); )
-	{
-		Polygon& polygon = polygons[i];
 
-		auto& vertices = polygon.getVertices();
-		if (vertices.size() > 1)
+	// Remove vertices sharing position with next vertex, each polygon is independent.
+	parallelFor((uint32_t)polygons.size(), c_polygonsPerJob, [&](uint32_t from, uint32_t to) {
+		for (uint32_t i = from; i < to; ++i)
 		{
+			auto& vertices = polygons[i].getVertices();
+			if (vertices.size() <= 1)
+				continue;
+
 			for (size_t j = 0; j < vertices.size(); )
 			{
 				const uint32_t p0 = model.getVertex(vertices[j]).getPosition();
@@ -40,12 +49,13 @@ bool CleanDegenerate::apply(Model& model) const
 					++j;
 			}
 		}
+	});
 
-		if (vertices.size() <= 2)
-			polygons.erase(polygons.begin() + i);
-		else
-			++i;
-	}
+	// Remove degenerate polygons, preserving order of remaining polygons.
+	auto it = std::remove_if(polygons.begin(), polygons.end(), [](const Polygon& polygon) {
+		return polygon.getVertexCount() <= 2;
+	});
+	polygons.erase(it, polygons.end());
 	return true;
 }
 
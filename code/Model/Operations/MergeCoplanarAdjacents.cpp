@@ -9,6 +9,7 @@
 #include <functional>
 #include "Core/Math/Const.h"
 #include "Core/Math/Winding3.h"
+#include "Core/Thread/ParallelFor.h"
 #include "Model/Model.h"
 #include "Model/ModelAdjacency.h"
 #include "Model/Operations/CleanDuplicates.h"
@@ -19,6 +20,7 @@ namespace traktor::model
 	namespace
 	{
 
+const uint32_t c_polygonsPerJob = 4096;
 const float c_planarAngleThreshold = deg2rad(0.1f);
 const float c_vertexDistanceThreshold = 0.001f;
 
@@ -29,24 +31,26 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.model.MergeCoplanarAdjacents", MergeCoplanarAdj
 bool MergeCoplanarAdjacents::apply(Model& model) const
 {
 	AlignedVector< Polygon >& polygons = model.getPolygons();
-	Winding3 w;
-	Plane p;
 
 	// Calculate polygon normals.
 	AlignedVector< Vector4 > normals(polygons.size(), Vector4(0.0f, 0.0f, 1.0f));
-	for (size_t i = 0; i < polygons.size(); ++i)
-	{
-		const Polygon& polygon = polygons[i];
-		if (polygon.getVertexCount() < 3)
-			continue;
+	parallelFor((uint32_t)polygons.size(), c_polygonsPerJob, [&](uint32_t from, uint32_t to) {
+		Winding3 w;
+		Plane p;
+		for (uint32_t i = from; i < to; ++i)
+		{
+			const Polygon& polygon = polygons[i];
+			if (polygon.getVertexCount() < 3)
+				continue;
 
-		w.clear();
-		for (uint32_t j = 0; j < polygon.getVertexCount(); ++j)
-			w.push(model.getVertexPosition(polygon.getVertex(j)));
+			w.clear();
+			for (uint32_t j = 0; j < polygon.getVertexCount(); ++j)
+				w.push(model.getVertexPosition(polygon.getVertex(j)));
 
-		if (w.getPlane(p))
-			normals[i] = p.normal();
-	}
+			if (w.getPlane(p))
+				normals[i] = p.normal();
+		}
+	});
 
 	// Build model adjacency information.
 	ModelAdjacency adjacency(&model, ModelAdjacency::Mode::ByPosition);
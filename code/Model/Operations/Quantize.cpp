@@ -7,11 +7,18 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Core/Math/Const.h"
+#include "Core/Thread/ParallelFor.h"
 #include "Model/Model.h"
 #include "Model/Operations/Quantize.h"
 
 namespace traktor::model
 {
+	namespace
+	{
+
+const uint32_t c_positionsPerJob = 16384;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.model.Quantize", Quantize, IModelOperation)
 
@@ -27,18 +34,20 @@ Quantize::Quantize(const Vector4& step)
 
 bool Quantize::apply(Model& model) const
 {
-	float T_MATH_ALIGN16 e[4];
 	AlignedVector< Vector4 > positions = model.getPositions();
-	for (AlignedVector< Vector4 >::iterator i = positions.begin(); i != positions.end(); ++i)
-	{
-		(*i / m_step).storeAligned(e);
-
-		e[0] = std::floor(e[0]);
-		e[1] = std::floor(e[1]);
-		e[2] = std::floor(e[2]);
-
-		*i = Vector4::loadAligned(e) * m_step;
-	}
+	parallelFor((uint32_t)positions.size(), c_positionsPerJob, [&](uint32_t from, uint32_t to) {
+		float T_MATH_ALIGN16 e[4];
+		for (uint32_t i = from; i < to; ++i)
+		{
+			(positions[i] / m_step).storeAligned(e);
+
+			e[0] = std::floor(e[0]);
+			e[1] = std::floor(e[1]);
+			e[2] = std::floor(e[2]);
+
+			positions[i] = Vector4::loadAligned(e) * m_step;
+		}
+	});
 	model.setPositions(positions);
 	return true;
 }
@@ -10,6 +10,7 @@
 #include "Core/Containers/StaticSet.h"
 #include "Core/Math/Const.h"
 #include "Core/Math/Plane.h"
+#include "Core/Thread/ParallelFor.h"
 #include "Model/Model.h"
 #include "Model/ModelAdjacency.h"
 #include "Model/Operations/CleanDegenerate.h"
@@ -25,6 +26,8 @@ namespace traktor::model
 	namespace
 	{
 
+const uint32_t c_polygonsPerJob = 256;
+
 Scalar tetrahedronVolume(const Vector4& A, const Vector4& B, const Vector4& C, const Vector4& u)
 {
 	const Scalar area = cross(A - B, C - B).length() / 2.0_simd;
@@ -297,13 +300,12 @@ bool Reduce::apply(Model& model) const
 	// Prepare initial adjacency.
 	Ref< ModelAdjacency > adjacency = new ModelAdjacency(&model, ModelAdjacency::Mode::ByPosition);
 
-	// Calculate initial set of errors.
-	AlignedVector< float > errors;
-	for (uint32_t i = 0; i < model.getPolygonCount(); ++i)
-	{
-		const float error = triangleVolumeError(model, *adjacency, i);
-		errors.push_back(error);
-	}
+	// Calculate initial set of errors; each error only read model and adjacency.
+	AlignedVector< float > errors(model.getPolygonCount());
+	parallelFor(model.getPolygonCount(), c_polygonsPerJob, [&](uint32_t from, uint32_t to) {
+		for (uint32_t i = from; i < to; ++i)
+			errors[i] = triangleVolumeError(model, *adjacency, i);
+	});
 
 	StaticVector< uint32_t, 4 > errorTrianglePositionIds;
 	StaticVector< uint32_t, 64 > modifiedPolygons;
@@ -406,8 +408,10 @@ bool Reduce::apply(Model& model) const
 			adjacency->update(modifiedPolygon);
 
 		// Update errors on polygons which has been modified.
-		for (uint32_t modifiedPolygon : modifiedPolygons)
-			errors[modifiedPolygon] = triangleVolumeError(model, *adjacency, modifiedPolygon);
+		parallelFor((uint32_t)modifiedPolygons.size(), 1, [&](uint32_t from, uint32_t to) {
+			for (uint32_t i = from; i < to; ++i)
+				errors[modifiedPolygons[i]] = triangleVolumeError(model, *adjacency, modifiedPolygons[i]);
+		});
 	}
 
 	// Remove unused vertices etc which will be a left over from reducing.
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Thread/ParallelFor.h"
 #include "Model/Model.h"
 #include "Model/TriangleOrderForsyth.h"
 #include "Model/Operations/SortCacheCoherency.h"
@@ -17,44 +18,51 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.model.SortCacheCoherency", SortCacheCoherency,
 
 bool SortCacheCoherency::apply(Model& model) const
 {
-	AlignedVector< Polygon > polygons = model.getPolygons();
+	const AlignedVector< Polygon >& polygons = model.getPolygons();
 	if (polygons.size() <= 2)
 		return true;
 
-	AlignedVector< Polygon > newPolygons;
-	newPolygons.reserve(polygons.size());
-
+	// Gather indices of each material in a single sweep.
 	const uint32_t materialCount = (uint32_t)model.getMaterials().size();
-	for (uint32_t material = 0; material < materialCount; ++material)
+	AlignedVector< AlignedVector< uint32_t > > indices(materialCount);
+	for (const auto& polygon : polygons)
 	{
-		AlignedVector< uint32_t > indices;
-		for (AlignedVector< Polygon >::const_iterator i = polygons.begin(); i != polygons.end(); ++i)
-		{
-			if (i->getMaterial() == material)
-				indices.insert(indices.end(), i->getVertices().begin(), i->getVertices().end());
-		}
+		if (polygon.getMaterial() < materialCount)
+			indices[polygon.getMaterial()].insert(indices[polygon.getMaterial()].end(), polygon.getVertices().begin(), polygon.getVertices().end());
+	}
 
-		if (indices.empty())
-			continue;
+	// Optimize each material in parallel.
+	AlignedVector< AlignedVector< uint32_t > > newIndices(materialCount);
+	parallelFor(materialCount, 1, [&](uint32_t from, uint32_t to) {
+		for (uint32_t material = from; material < to; ++material)
+		{
+			if (indices[material].empty())
+				continue;
 
-		AlignedVector< uint32_t >::const_iterator it = std::max_element(indices.begin(), indices.end());
-		uint32_t vertexCount = *it + 1;
+			const uint32_t vertexCount = *std::max_element(indices[material].begin(), indices[material].end()) + 1;
 
-		AlignedVector< uint32_t > newIndices(indices.size());
-		optimizeFaces(
-			indices,
-			vertexCount,
-			newIndices,
-			32
-		);
+			newIndices[material].resize(indices[material].size());
+			optimizeFaces(
+				indices[material],
+				vertexCount,
+				newIndices[material],
+				32
+			);
+		}
+	});
 
-		for (uint32_t i = 0; i < newIndices.size(); i += 3)
+	AlignedVector< Polygon > newPolygons;
+	newPolygons.reserve(polygons.size());
+	for (uint32_t material = 0; material < materialCount; ++material)
+	{
+		const auto& materialIndices = newIndices[material];
+		for (uint32_t i = 0; i < materialIndices.size(); i += 3)
 		{
 			newPolygons.push_back(Polygon(
 				material,
-				newIndices[i + 0],
-				newIndices[i + 1],
-				newIndices[i + 2]
+				materialIndices[i + 0],
+				materialIndices[i + 1],
+				materialIndices[i + 2]
 			));
 		}
 	}
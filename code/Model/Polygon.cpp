@@ -1,6 +1,6 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,11 +9,68 @@
 #include <algorithm>
 #include "Core/Serialization/ISerializer.h"
 #include "Core/Serialization/Member.h"
-#include "Core/Serialization/MemberStaticVector.h"
+#include "Core/Serialization/MemberArray.h"
 #include "Model/Polygon.h"
 
 namespace traktor::model
 {
+namespace
+{
+
+/*! Polygon vertices member, same format as MemberStaticVector. */
+class MemberPolygonVertices : public MemberArray
+{
+public:
+	explicit MemberPolygonVertices(const wchar_t* const name, PolygonVertices& ref)
+	:	MemberArray(name, nullptr)
+	,	m_ref(ref)
+	{
+	}
+
+	virtual void reserve(size_t size, size_t capacity) const override final
+	{
+		m_ref.resize(size);
+	}
+
+	virtual size_t size() const override final
+	{
+		return m_ref.size();
+	}
+
+	virtual void read(ISerializer& s, size_t count) const override final
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (m_index < m_ref.size())
+				s >> Member< uint32_t >(L"item", m_ref[m_index]);
+			else
+			{
+				uint32_t item;
+				s >> Member< uint32_t >(L"item", item);
+				m_ref.push_back(item);
+			}
+			++m_index;
+		}
+	}
+
+	virtual void write(ISerializer& s, size_t count) const override final
+	{
+		for (size_t i = 0; i < count; ++i)
+			s >> Member< uint32_t >(L"item", m_ref[m_index++]);
+	}
+
+	virtual bool insert() const override final
+	{
+		m_ref.push_back(0);
+		return true;
+	}
+
+private:
+	PolygonVertices& m_ref;
+	mutable size_t m_index = 0;
+};
+
+}
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.model.Polygon", 0, Polygon, ISerializable)
 
@@ -96,7 +153,7 @@ void Polygon::serialize(ISerializer& s)
 	s >> Member< uint32_t >(L"material", m_material);
 	s >> Member< uint32_t >(L"normal", m_normal);
 	s >> Member< uint32_t >(L"smoothGroup", m_smoothGroup);
-	s >> MemberStaticVector< uint32_t, vertices_t::Capacity >(L"vertices", m_vertices);
+	s >> MemberPolygonVertices(L"vertices", m_vertices);
 }
 
 bool Polygon::operator == (const Polygon& r) const
@@ -1,6 +1,6 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,8 +8,8 @@
  */
 #pragma once
 
-#include "Core/Containers/StaticVector.h"
 #include "Core/Serialization/ISerializable.h"
+#include "Model/PolygonVertices.h"
 #include "Model/Types.h"
 
 // import/export mechanism.
@@ -38,7 +38,7 @@ class T_DLLCLASS Polygon : public ISerializable
 	T_RTTI_CLASS;
 
 public:
-	typedef StaticVector< uint32_t, 32 > vertices_t;
+	typedef PolygonVertices vertices_t;
 
 	Polygon() = default;
 
@@ -0,0 +1,221 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Config.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace traktor::model
+{
+
+/*! Compact array of polygon vertex indices.
+ * \ingroup Model
+ *
+ * Triangles and quads, by far the most common polygons,
+ * are stored inline; larger polygons spill into a heap
+ * allocation. Iterators are plain pointers thus standard
+ * algorithms can be used directly.
+ */
+class PolygonVertices
+{
+public:
+	enum
+	{
+		Capacity = 32,		//!< Max number of vertices in a polygon.
+		InlineCapacity = 4
+	};
+
+	typedef uint32_t* iterator;
+	typedef const uint32_t* const_iterator;
+	typedef uint32_t value_type;
+
+	PolygonVertices() = default;
+
+	explicit PolygonVertices(size_t size)
+	{
+		resize(size);
+	}
+
+	template < typename IteratorType >
+	PolygonVertices(IteratorType first, IteratorType last)
+	{
+		for (; first != last; ++first)
+			push_back((uint32_t)*first);
+	}
+
+	PolygonVertices(const PolygonVertices& src)
+	{
+		*this = src;
+	}
+
+	PolygonVertices(PolygonVertices&& src) noexcept
+	{
+		*this = std::move(src);
+	}
+
+	~PolygonVertices()
+	{
+		if (m_capacity > InlineCapacity)
+			delete[] m_heap;
+	}
+
+	bool empty() const { return m_size == 0; }
+
+	size_t size() const { return m_size; }
+
+	size_t capacity() const { return m_capacity; }
+
+	void resize(size_t size)
+	{
+		T_ASSERT(size <= Capacity);
+		grow((uint32_t)size);
+		uint32_t* data = ptr();
+		for (size_t i = m_size; i < size; ++i)
+			data[i] = 0;
+		m_size = (uint8_t)size;
+	}
+
+	void clear()
+	{
+		m_size = 0;
+	}
+
+	void push_back(uint32_t vertex)
+	{
+		T_ASSERT(m_size < Capacity);
+		grow(m_size + 1);
+		ptr()[m_size++] = vertex;
+	}
+
+	void pop_back()
+	{
+		T_ASSERT(m_size > 0);
+		--m_size;
+	}
+
+	iterator insert(iterator where, uint32_t vertex)
+	{
+		const size_t offset = where - begin();
+		T_ASSERT(offset <= m_size);
+		grow(m_size + 1);
+		uint32_t* data = ptr();
+		std::memmove(data + offset + 1, data + offset, (m_size - offset) * sizeof(uint32_t));
+		data[offset] = vertex;
+		++m_size;
+		return data + offset;
+	}
+
+	iterator erase(iterator where)
+	{
+		const size_t offset = where - begin();
+		T_ASSERT(offset < m_size);
+		uint32_t* data = ptr();
+		std::memmove(data + offset, data + offset + 1, (m_size - offset - 1) * sizeof(uint32_t));
+		--m_size;
+		return data + offset;
+	}
+
+	uint32_t& front() { return ptr()[0]; }
+
+	uint32_t front() const { return ptr()[0]; }
+
+	uint32_t& back() { return ptr()[m_size - 1]; }
+
+	uint32_t back() const { return ptr()[m_size - 1]; }
+
+	iterator begin() { return ptr(); }
+
+	const_iterator begin() const { return ptr(); }
+
+	iterator end() { return ptr() + m_size; }
+
+	const_iterator end() const { return ptr() + m_size; }
+
+	uint32_t& operator [] (size_t index)
+	{
+		T_ASSERT(index < m_size);
+		return ptr()[index];
+	}
+
+	uint32_t operator [] (size_t index) const
+	{
+		T_ASSERT(index < m_size);
+		return ptr()[index];
+	}
+
+	PolygonVertices& operator = (const PolygonVertices& src)
+	{
+		if (this != &src)
+		{
+			m_size = 0;
+			grow(src.m_size);
+			std::memcpy(ptr(), src.ptr(), src.m_size * sizeof(uint32_t));
+			m_size = src.m_size;
+		}
+		return *this;
+	}
+
+	PolygonVertices& operator = (PolygonVertices&& src) noexcept
+	{
+		if (this != &src)
+		{
+			if (m_capacity > InlineCapacity)
+				delete[] m_heap;
+			std::memcpy(m_inline, src.m_inline, sizeof(m_inline));
+			m_size = src.m_size;
+			m_capacity = src.m_capacity;
+			src.m_size = 0;
+			src.m_capacity = InlineCapacity;
+		}
+		return *this;
+	}
+
+	bool operator == (const PolygonVertices& r) const
+	{
+		return m_size == r.m_size && std::equal(begin(), end(), r.begin());
+	}
+
+	bool operator != (const PolygonVertices& r) const
+	{
+		return !(*this == r);
+	}
+
+private:
+	union
+	{
+		uint32_t m_inline[InlineCapacity];
+		uint32_t* m_heap;
+	};
+	uint8_t m_size = 0;
+	uint8_t m_capacity = InlineCapacity;
+
+	uint32_t* ptr() { return m_capacity > InlineCapacity ? m_heap : m_inline; }
+
+	const uint32_t* ptr() const { return m_capacity > InlineCapacity ? m_heap : m_inline; }
+
+	void grow(uint32_t size)
+	{
+		if (size <= m_capacity)
+			return;
+
+		const uint32_t capacity = std::min< uint32_t >(std::max< uint32_t >(size, m_capacity * 2), Capacity);
+		uint32_t* heap = new uint32_t [capacity];
+		std::memcpy(heap, ptr(), m_size * sizeof(uint32_t));
+
+		if (m_capacity > InlineCapacity)
+			delete[] m_heap;
+
+		m_heap = heap;
+		m_capacity = (uint8_t)capacity;
+	}
+};
+
+}
@@ -0,0 +1,56 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Model/Test/BenchModelPolygons.h"
+
+#include "Core/Log/Log.h"
+#include "Core/Timer/Timer.h"
+#include "Model/Model.h"
+
+namespace traktor::model::test
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.model.test.BenchModelPolygons", 0, BenchModelPolygons, traktor::test::Benchmark)
+
+void BenchModelPolygons::run()
+{
+	// Import a large grid of triangles, welding shared positions and vertices.
+	const int32_t size = 2237;
+	const uint32_t triangleCount = (size - 1) * (size - 1) * 2;
+
+	Timer timer;
+	Ref< Model > m = new Model();
+	m->addMaterial(Material());
+	m->reservePositions(size * size);
+	m->reserveVertices(size * size);
+	m->reservePolygons(triangleCount);
+
+	for (int32_t z = 0; z < size - 1; ++z)
+	{
+		for (int32_t x = 0; x < size - 1; ++x)
+		{
+			uint32_t vi[4];
+			for (int32_t i = 0; i < 4; ++i)
+			{
+				Vertex vx;
+				vx.setPosition(m->addUniquePosition(Vector4(float(x + (i & 1)), 0.0f, float(z + (i >> 1)), 1.0f)));
+				vi[i] = m->addUniqueVertex(vx);
+			}
+			m->addPolygon(Polygon(0, vi[0], vi[1], vi[2]));
+			m->addPolygon(Polygon(0, vi[2], vi[1], vi[3]));
+		}
+	}
+
+	const double importTime = timer.getElapsedTime();
+
+	const uint64_t polygonMemory = (uint64_t)m->getPolygons().capacity() * sizeof(Polygon);
+	log::info << L"Model, imported " << triangleCount << L" triangles in " << int32_t(importTime * 1000.0) << L" ms" << Endl;
+	log::info << L"  " << uint32_t(sizeof(Polygon)) << L" bytes per polygon, " << uint32_t(polygonMemory / (1024 * 1024)) << L" MiB polygons" << Endl;
+}
+
+}
@@ -0,0 +1,24 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Test/Benchmark.h"
+
+namespace traktor::model::test
+{
+
+class BenchModelPolygons : public traktor::test::Benchmark
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual void run() override final;
+};
+
+}
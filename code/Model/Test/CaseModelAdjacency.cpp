@@ -77,7 +77,7 @@ void CaseModelAdjacency::run()
 		const auto edges3 = ma->getSharedEdges(i);
 		CASE_ASSERT(edges3.count == 1);
 
-		pn = ma->getPolygon(edges[0]);
+		pn = ma->getPolygon(edges3[0]);
 		CASE_ASSERT(pn == 1);
 	}
 
@@ -104,6 +104,46 @@ void CaseModelAdjacency::run()
 		CASE_ASSERT(ma->getEdgeCount() == 3 * 3);
 		checkSharingEdges(ma);
 	}
+
+	// Adjacency built at once must be same as when polygons are added one by one.
+	{
+		Ref< Model > g = new Model();
+		for (int32_t z = 0; z < 16; ++z)
+		{
+			for (int32_t x = 0; x < 16; ++x)
+			{
+				uint32_t vi[4];
+				for (int32_t j = 0; j < 4; ++j)
+				{
+					model::Vertex vx;
+					vx.setPosition(g->addUniquePosition(Vector4(float(x + (j & 1)), 0.0f, float(z + (j >> 1)), 1.0f)));
+					vi[j] = g->addUniqueVertex(vx);
+				}
+				g->addPolygon(model::Polygon(0, vi[0], vi[1], vi[2]));
+				g->addPolygon(model::Polygon(0, vi[2], vi[1], vi[3]));
+			}
+		}
+
+		Ref< ModelAdjacency > ma = new ModelAdjacency(g, ModelAdjacency::Mode::ByPosition);
+		Ref< ModelAdjacency > mi = new ModelAdjacency(g, AlignedVector< uint32_t >(), ModelAdjacency::Mode::ByPosition);
+		for (uint32_t i = 0; i < g->getPolygonCount(); ++i)
+			mi->add(i);
+
+		CASE_ASSERT(ma->getEdgeCount() == g->getPolygonCount() * 3);
+		CASE_ASSERT(ma->getEdgeCount() == mi->getEdgeCount());
+		for (uint32_t i = 0; i < ma->getEdgeCount(); ++i)
+		{
+			CASE_ASSERT(ma->getPolygon(i) == mi->getPolygon(i));
+			CASE_ASSERT(ma->getPolygonEdge(i) == mi->getPolygonEdge(i));
+
+			const auto shared = ma->getSharedEdges(i);
+			const auto sharedIncremental = mi->getSharedEdges(i);
+			CASE_ASSERT(shared.count == sharedIncremental.count);
+			for (uint32_t j = 0; j < shared.count && j < sharedIncremental.count; ++j)
+				CASE_ASSERT(shared[j] == sharedIncremental[j]);
+		}
+		checkSharingEdges(ma);
+	}
 }
 
 void CaseModelAdjacency::checkSharingEdges(const ModelAdjacency* ma)
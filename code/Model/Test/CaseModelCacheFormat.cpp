@@ -0,0 +1,129 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Model/Test/CaseModelCacheFormat.h"
+
+#include "Core/Io/FileSystem.h"
+#include "Core/Log/Log.h"
+#include "Core/Timer/Timer.h"
+#include "Model/Model.h"
+#include "Model/Formats/Tmc/ModelFormatTmc.h"
+#include "Model/Formats/Tmd/ModelFormatTmd.h"
+
+namespace traktor::model::test
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.model.test.CaseModelCacheFormat", 0, CaseModelCacheFormat, traktor::test::Case)
+
+void CaseModelCacheFormat::run()
+{
+	const Path fileName(L"CaseModelCacheFormat.tmc");
+
+	// Round trip; geometry and prebuilt indices must survive.
+	{
+		Ref< Model > m = new Model();
+		m->addMaterial(Material(L"A"));
+		m->addMaterial(Material(L"B"));
+		m->addUniqueTexCoordChannel(L"UV0");
+		m->addJoint(Joint(L"Root"));
+		m->addJoint(Joint(0, L"Child", Transform::identity(), 1.0f));
+
+		Polygon large;
+		large.setMaterial(1);
+		for (uint32_t i = 0; i < 6; ++i)
+		{
+			const float a = float(i);
+			Vertex vx;
+			vx.setPosition(m->addUniquePosition(Vector4(a, a * 2.0f, 0.0f, 1.0f)));
+			vx.setNormal(m->addUniqueNormal(Vector4(0.0f, 1.0f, 0.0f, 0.0f)));
+			vx.setColor(m->addUniqueColor(Vector4(a, 0.0f, 0.0f, 1.0f)));
+			vx.setTexCoord(0, m->addUniqueTexCoord(Vector2(a, -a)));
+			vx.setJointInfluence(1, 0.25f * a);
+			large.addVertex(m->addUniqueVertex(vx));
+		}
+		large.setNormal(0);
+		m->addPolygon(Polygon(0, 0, 1, 2));
+		m->addPolygon(large);
+
+		CASE_ASSERT(ModelFormatTmc().write(fileName, m));
+
+		Ref< Model > r = ModelFormatTmc().read(fileName, L"");
+		CASE_ASSERT(r != nullptr);
+		if (!r)
+			return;
+
+		CASE_ASSERT(r->getMaterials().size() == 2);
+		CASE_ASSERT(r->getMaterials()[1].getName() == L"B");
+		CASE_ASSERT(r->getTexCoordChannels().size() == 1);
+		CASE_ASSERT(r->getJointCount() == 2);
+		CASE_ASSERT(r->getPositions() == m->getPositions());
+		CASE_ASSERT(r->getNormals() == m->getNormals());
+		CASE_ASSERT(r->getColors() == m->getColors());
+		CASE_ASSERT(r->getTexCoords() == m->getTexCoords());
+		CASE_ASSERT(r->getVertices() == m->getVertices());
+		CASE_ASSERT(r->getPolygons() == m->getPolygons());
+
+		// Adding existing values must find them through the prebuilt indices.
+		for (uint32_t i = 0; i < m->getVertexCount(); ++i)
+		{
+			CASE_ASSERT(r->addUniqueVertex(m->getVertex(i)) == i);
+			CASE_ASSERT(r->addUniquePosition(m->getVertexPosition(i)) == m->getVertex(i).getPosition());
+			CASE_ASSERT(r->addUniqueTexCoord(m->getTexCoord(m->getVertex(i).getTexCoord(0))) == m->getVertex(i).getTexCoord(0));
+		}
+		CASE_ASSERT(r->getVertexCount() == m->getVertexCount());
+		CASE_ASSERT(r->getPositions().size() == m->getPositions().size());
+
+		r = nullptr;
+		FileSystem::getInstance().remove(fileName);
+	}
+
+	// Compare load time against serialized model format.
+	{
+		const int32_t size = 1001;
+
+		Ref< Model > m = new Model();
+		m->addMaterial(Material());
+		for (int32_t z = 0; z < size - 1; ++z)
+		{
+			for (int32_t x = 0; x < size - 1; ++x)
+			{
+				uint32_t vi[4];
+				for (int32_t i = 0; i < 4; ++i)
+				{
+					Vertex vx;
+					vx.setPosition(m->addUniquePosition(Vector4(float(x + (i & 1)), 0.0f, float(z + (i >> 1)), 1.0f)));
+					vx.setTexCoord(0, m->addUniqueTexCoord(Vector2(float(x + (i & 1)), float(z + (i >> 1)))));
+					vi[i] = m->addUniqueVertex(vx);
+				}
+				m->addPolygon(Polygon(0, vi[0], vi[1], vi[2]));
+				m->addPolygon(Polygon(0, vi[2], vi[1], vi[3]));
+			}
+		}
+
+		const Path tmdFileName(L"CaseModelCacheFormat.tmd");
+		CASE_ASSERT(ModelFormatTmd().write(tmdFileName, m));
+		CASE_ASSERT(ModelFormatTmc().write(fileName, m));
+
+		Timer timer;
+		Ref< Model > tmd = ModelFormatTmd().read(tmdFileName, L"");
+		const double tmdTime = timer.getDeltaTime();
+		Ref< Model > tmc = ModelFormatTmc().read(fileName, L"");
+		const double tmcTime = timer.getDeltaTime();
+
+		CASE_ASSERT(tmd != nullptr && tmd->getPolygonCount() == m->getPolygonCount());
+		CASE_ASSERT(tmc != nullptr && tmc->getPolygonCount() == m->getPolygonCount());
+		CASE_ASSERT(tmc != nullptr && tmc->getVertices() == m->getVertices());
+
+		log::info << L"Model cache, loaded " << m->getPolygonCount() << L" triangles; tmd " << int32_t(tmdTime * 1000.0) << L" ms, tmc " << int32_t(tmcTime * 1000.0) << L" ms" << Endl;
+
+		FileSystem::getInstance().remove(tmdFileName);
+		FileSystem::getInstance().remove(fileName);
+	}
+}
+
+}
@@ -0,0 +1,102 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Model/Test/CaseModelPolygons.h"
+
+#include "Model/FlatHashIndex.h"
+#include "Model/Model.h"
+
+#include <algorithm>
+
+namespace traktor::model::test
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.model.test.CaseModelPolygons", 0, CaseModelPolygons, traktor::test::Case)
+
+void CaseModelPolygons::run()
+{
+	// Polygon vertices; inline until spilled onto heap.
+	{
+		Polygon::vertices_t vertices;
+		for (uint32_t i = 0; i < Polygon::vertices_t::Capacity; ++i)
+			vertices.push_back(i);
+		CASE_ASSERT(vertices.size() == Polygon::vertices_t::Capacity);
+		for (uint32_t i = 0; i < Polygon::vertices_t::Capacity; ++i)
+			CASE_ASSERT(vertices[i] == i);
+
+		vertices.erase(vertices.begin() + 2);
+		vertices.insert(vertices.begin(), 100);
+		CASE_ASSERT(vertices.size() == Polygon::vertices_t::Capacity);
+		CASE_ASSERT(vertices[0] == 100);
+		CASE_ASSERT(vertices[3] == 3);
+
+		Polygon::vertices_t copy = vertices;
+		CASE_ASSERT(copy == vertices);
+
+		Polygon::vertices_t moved = std::move(copy);
+		CASE_ASSERT(moved == vertices);
+		CASE_ASSERT(copy.empty());
+
+		Polygon::vertices_t triangle(vertices.begin(), vertices.begin() + 3);
+		std::reverse(triangle.begin(), triangle.end());
+		CASE_ASSERT(triangle.size() == 3);
+		CASE_ASSERT(triangle[0] == 1 && triangle[2] == 100);
+	}
+
+	// Hash index; erase must keep colliding entries reachable.
+	{
+		FlatHashIndex index;
+		for (uint32_t i = 0; i < 1000; ++i)
+			index.insert(i % 10, i);
+		CASE_ASSERT(index.size() == 1000);
+
+		for (uint32_t i = 0; i < 1000; i += 2)
+			index.erase(i % 10, i);
+		CASE_ASSERT(index.size() == 500);
+
+		for (uint32_t i = 0; i < 1000; ++i)
+		{
+			const uint32_t found = index.find(i % 10, [&](uint32_t candidate) { return candidate == i; });
+			CASE_ASSERT(found == ((i & 1) != 0 ? i : FlatHashIndex::InvalidIndex));
+		}
+	}
+
+	// Import a grid of triangles, welding shared positions and vertices.
+	{
+		const int32_t size = 64;
+		const uint32_t triangleCount = (size - 1) * (size - 1) * 2;
+
+		Ref< Model > m = new Model();
+		m->addMaterial(Material());
+		m->reservePositions(size * size);
+		m->reserveVertices(size * size);
+		m->reservePolygons(triangleCount);
+
+		for (int32_t z = 0; z < size - 1; ++z)
+		{
+			for (int32_t x = 0; x < size - 1; ++x)
+			{
+				uint32_t vi[4];
+				for (int32_t i = 0; i < 4; ++i)
+				{
+					Vertex vx;
+					vx.setPosition(m->addUniquePosition(Vector4(float(x + (i & 1)), 0.0f, float(z + (i >> 1)), 1.0f)));
+					vi[i] = m->addUniqueVertex(vx);
+				}
+				m->addPolygon(Polygon(0, vi[0], vi[1], vi[2]));
+				m->addPolygon(Polygon(0, vi[2], vi[1], vi[3]));
+			}
+		}
+
+		CASE_ASSERT(m->getPolygonCount() == triangleCount);
+		CASE_ASSERT(m->getPositions().size() == size * size);
+		CASE_ASSERT(m->getVertexCount() == size * size);
+	}
+}
+
+}
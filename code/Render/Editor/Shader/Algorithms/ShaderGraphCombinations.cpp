@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <set>
 #include "Core/Log/Log.h"
+#include "Core/Thread/JobManager.h"
 #include "Render/Editor/Edge.h"
 #include "Render/Editor/Shader/Nodes.h"
 #include "Render/Editor/Shader/ShaderGraph.h"
@@ -21,6 +22,9 @@ namespace traktor::render
 	namespace
 	{
 
+/*! Number of combination tree levels which are expanded before sub-trees are built in parallel. */
+const int32_t c_parallelDepth = 4;
+
 Ref< ShaderGraph > replaceBranch(const ShaderGraph* shaderGraph, Branch* branch, bool path)
 {
 	Ref< ShaderGraph > shaderGraphResult = new ShaderGraph(
@@ -122,13 +126,119 @@ void buildPermutations(
 	}
 }
 
+/*! Root of a sub-tree of the combination tree. */
+struct SubTree
+{
+	Ref< const ShaderGraph > shaderGraph;
+	uint32_t parameterMask = 0;
+	uint32_t parameterValue = 0;
+};
+
+void buildCombinations(
+	const ShaderGraph* shaderGraph,
+	const Guid& shaderGraphId,
+	const AlignedVector< std::wstring >& parameterNames,
+	AlignedVector< ShaderGraphCombinations::Combination >& outCombinations
+)
+{
+	// Expand upper levels of tree breadth first; branches of each level are replaced
+	// concurrently and sub-trees are kept in same order as if tree was built depth first.
+	AlignedVector< SubTree > subTrees;
+	subTrees.push_back({ shaderGraph, 0, 0 });
+
+	for (int32_t depth = 0; depth < c_parallelDepth; ++depth)
+	{
+		AlignedVector< SubTree > expandedSubTrees(subTrees.size() * 2);
+		AlignedVector< Job::task_t > jobs;
+
+		for (uint32_t i = 0; i < (uint32_t)subTrees.size(); ++i)
+		{
+			const SubTree& subTree = subTrees[i];
+
+			RefArray< Branch > branchNodes = subTree.shaderGraph->findNodesOf< Branch >();
+			if (branchNodes.empty())
+			{
+				expandedSubTrees[i * 2] = subTree;
+				continue;
+			}
+
+			Ref< Branch > branch = branchNodes.front();
+
+			const auto parameterIter = std::find(parameterNames.begin(), parameterNames.end(), branch->getParameterName());
+			const uint32_t parameterBit = 1 << (uint32_t)std::distance(parameterNames.begin(), parameterIter);
+
+			for (uint32_t j = 0; j < 2; ++j)
+			{
+				const bool path = (j == 0);
+				jobs.push_back([&, i, j, branch, parameterBit, path]() {
+					const SubTree& parentSubTree = subTrees[i];
+					Ref< ShaderGraph > shaderGraphBranch = replaceBranch(parentSubTree.shaderGraph, branch, path);
+					if (shaderGraphBranch)
+					{
+						SubTree& expandedSubTree = expandedSubTrees[i * 2 + j];
+						expandedSubTree.shaderGraph = shaderGraphBranch;
+						expandedSubTree.parameterMask = parentSubTree.parameterMask | parameterBit;
+						expandedSubTree.parameterValue = path ? (parentSubTree.parameterValue | parameterBit) : parentSubTree.parameterValue;
+					}
+				});
+			}
+		}
+
+		if (jobs.empty())
+			break;
+
+		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+
+		subTrees.clear();
+		for (const auto& expandedSubTree : expandedSubTrees)
+		{
+			if (expandedSubTree.shaderGraph)
+				subTrees.push_back(expandedSubTree);
+		}
+	}
+
+	// Build each sub-tree concurrently into its own list.
+	AlignedVector< AlignedVector< ShaderGraphCombinations::Combination > > subTreeCombinations(subTrees.size());
+	AlignedVector< Job::task_t > jobs;
+	for (uint32_t i = 0; i < (uint32_t)subTrees.size(); ++i)
+	{
+		jobs.push_back([&, i]() {
+			buildPermutations(
+				subTrees[i].shaderGraph,
+				shaderGraphId,
+				parameterNames,
+				subTrees[i].parameterMask,
+				subTrees[i].parameterValue,
+				subTreeCombinations[i]
+			);
+		});
+	}
+	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+
+	// Merge lists in order, first occurrence of each combination is kept as if tree was built sequentially.
+	for (const auto& combinations : subTreeCombinations)
+	{
+		for (const auto& combination : combinations)
+		{
+			const auto it = std::find_if(outCombinations.begin(), outCombinations.end(), [&](const ShaderGraphCombinations::Combination& c) {
+				return c.mask == combination.mask && c.value == combination.value;
+			});
+			if (it == outCombinations.end())
+				outCombinations.push_back(combination);
+		}
+	}
+}
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.render.ShaderGraphCombinations", ShaderGraphCombinations, Object)
 
 ShaderGraphCombinations::ShaderGraphCombinations(const ShaderGraph* shaderGraph, const Guid& shaderGraphId)
 {
+	// Nodes common to all combinations are merged once here, before
+	// the graph is branched into combinations.
 	m_shaderGraph = ShaderGraphOptimizer(shaderGraph).removeUnusedBranches(true);
+	m_shaderGraph = ShaderGraphOptimizer(m_shaderGraph).mergeBranches();
 
 	RefArray< Branch > branchNodes = m_shaderGraph->findNodesOf< Branch >();
 
@@ -143,7 +253,7 @@ ShaderGraphCombinations::ShaderGraphCombinations(const ShaderGraph* shaderGraph,
 		parameterNames.insert(name);
 	}
 
-	buildPermutations(m_shaderGraph, shaderGraphId, m_parameterNames, 0, 0, m_combinations);
+	buildCombinations(m_shaderGraph, shaderGraphId, m_parameterNames, m_combinations);
 }
 
 const AlignedVector< std::wstring >& ShaderGraphCombinations::getParameterNames() const
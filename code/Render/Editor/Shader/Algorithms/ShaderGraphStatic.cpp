@@ -9,10 +9,10 @@
 #include "Render/Editor/Shader/Algorithms/ShaderGraphStatic.h"
 
 #include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/SmallSet.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Const.h"
 #include "Core/Misc/ImmutableCheck.h"
-#include "Core/Serialization/DeepClone.h"
 #include "Render/Editor/Edge.h"
 #include "Render/Editor/GraphTraverse.h"
 #include "Render/Editor/Shader/Algorithms/ShaderGraphOptimizer.h"
@@ -624,16 +624,19 @@ Ref< ShaderGraph > ShaderGraphStatic::cleanupRedundantSwizzles() const
 {
 	T_IMMUTABLE_CHECK(m_shaderGraph);
 
-	Ref< ShaderGraph > shaderGraph = DeepClone(m_shaderGraph).create< ShaderGraph >();
-	if (shaderGraph == nullptr)
-		return nullptr;
-
+	Ref< ShaderGraph > shaderGraph = new ShaderGraph(
+		m_shaderGraph->getNodes(),
+		m_shaderGraph->getEdges());
 	T_VALIDATE_SHADERGRAPH(shaderGraph);
 
+	// Nodes are shared with source graph, thus instead of cloning entire
+	// graph we replace each swizzle node the first time its pattern is modified.
+	SmallSet< const Swizzle* > replacedNodes;
+
 	RefArray< Swizzle > swizzleNodes = shaderGraph->findNodesOf< Swizzle >();
-	for (auto i = swizzleNodes.begin(); i != swizzleNodes.end();)
+	for (uint32_t i = 0; i < (uint32_t)swizzleNodes.size();)
 	{
-		Swizzle* swizzleRightNode = *i;
+		Ref< Swizzle > swizzleRightNode = swizzleNodes[i];
 		T_ASSERT(swizzleRightNode);
 
 		const InputPin* swizzleInput = swizzleRightNode->getInputPin(0);
@@ -650,7 +653,7 @@ Ref< ShaderGraph > ShaderGraphStatic::cleanupRedundantSwizzles() const
 		}
 
 		// Get left swizzle; cast to null if input ain't a swizzle node.
-		Swizzle* swizzleLeftNode = dynamic_type_cast< Swizzle* >(sourceEdge->getSource()->getNode());
+		const Swizzle* swizzleLeftNode = dynamic_type_cast< const Swizzle* >(sourceEdge->getSource()->getNode());
 		if (!swizzleLeftNode)
 		{
 			++i;
@@ -677,11 +680,26 @@ Ref< ShaderGraph > ShaderGraphStatic::cleanupRedundantSwizzles() const
 			}
 		}
 
-		swizzleRightNode->set(swizzle);
-
 		// Replace input edge with edge from left's source.
 		shaderGraph->removeEdge(sourceEdge);
 
+		if (replacedNodes.find(swizzleRightNode) == replacedNodes.end())
+		{
+			Ref< Swizzle > swizzleNode = new Swizzle(swizzle);
+			swizzleNode->setId(swizzleRightNode->getId());
+			swizzleNode->setPosition(swizzleRightNode->getPosition());
+
+			shaderGraph->addNode(swizzleNode);
+			shaderGraph->rewire(swizzleOutput, swizzleNode->getOutputPin(0));
+			shaderGraph->removeNode(swizzleRightNode);
+
+			replacedNodes.insert(swizzleNode);
+			swizzleNodes[i] = swizzleNode;
+			swizzleRightNode = swizzleNode;
+		}
+		else
+			swizzleRightNode->set(swizzle);
+
 		const OutputPin* sourcePin = shaderGraph->findSourcePin(swizzleLeftNode->getInputPin(0));
 		if (sourcePin != nullptr)
 			shaderGraph->addEdge(new Edge(
@@ -691,7 +709,7 @@ Ref< ShaderGraph > ShaderGraphStatic::cleanupRedundantSwizzles() const
 		T_VALIDATE_SHADERGRAPH(shaderGraph);
 
 		// Restart iteration as it's possible we have rewired to another swizzler.
-		i = swizzleNodes.begin();
+		i = 0;
 	}
 
 	T_VALIDATE_SHADERGRAPH(shaderGraph);
@@ -16,6 +16,7 @@
 #include "Core/Misc/Preprocessor.h"
 #include "Core/Misc/String.h"
 #include "Core/Misc/WildCompare.h"
+#include "Core/RefArray.h"
 #include "Core/Serialization/BinarySerializer.h"
 #include "Core/Serialization/DeepClone.h"
 #include "Core/Serialization/MemberComposite.h"
@@ -26,6 +27,7 @@
 #include "Core/Settings/PropertyString.h"
 #include "Core/Settings/PropertyStringSet.h"
 #include "Core/Thread/Acquire.h"
+#include "Core/Thread/Atomic.h"
 #include "Core/Thread/JobManager.h"
 #include "Core/Thread/Thread.h"
 #include "Core/Thread/ThreadManager.h"
@@ -67,6 +69,8 @@ namespace traktor::render
 namespace
 {
 
+const uint32_t c_maxCachedPrograms = 4096;
+
 class FragmentReaderAdapter : public FragmentLinker::FragmentReaderTransientCache
 {
 public:
@@ -161,6 +165,13 @@ bool ShaderPipeline::create(const editor::IPipelineSettings* settings, db::Datab
 
 void ShaderPipeline::destroy()
 {
+	if (m_programCount > 0)
+	{
+		const int32_t hitRate = ((m_programCount - m_compiledCount) * 100) / m_programCount;
+		log::info << L"Shader pipeline; " << m_programCount << L" program(s), " << m_compiledCount << L" compiled (" << hitRate << L"% cache hit rate)." << Endl;
+	}
+
+	m_programCache.clear();
 	m_programHints = nullptr;
 	m_programCompiler = nullptr;
 }
@@ -441,6 +452,9 @@ bool ShaderPipeline::buildOutput(
 	std::list< Error > errors;
 	Semaphore errorsLock;
 
+	uint32_t shaderUniqueCount = 0;
+	int32_t shaderCompiledCount = 0;
+
 	for (const auto& techniqueName : techniqueNames)
 	{
 		if (ThreadManager::getInstance().getCurrentThread()->stopped())
@@ -470,11 +484,20 @@ bool ShaderPipeline::buildOutput(
 			shaderResourceTechnique.mask |= shaderResource->m_parameterBits[parameterName];
 		}
 
-		// Optimize and compile all combination programs.
+		// Optimize all combination programs.
 		const std::wstring path = outputPath + L" - " + techniqueName;
 		AlignedVector< Job::task_t > jobs;
 		bool status = true;
 
+		struct Program
+		{
+			Ref< const ShaderGraph > combinationGraph;
+			Ref< ShaderGraph > programGraph;
+			Ref< ShaderModule > module;
+			Key key;
+		};
+
+		AlignedVector< Program > programs(combinationCount);
 		shaderResourceTechnique.combinations.resize(combinationCount);
 		for (uint32_t combination = 0; combination < combinationCount; ++combination)
 		{
@@ -698,19 +721,67 @@ bool ShaderPipeline::buildOutput(
 					return;
 				}
 
-				// Calculate hash of the entire shader graph including modules so we can
-				// memorize shader compilation.
-				const uint32_t hash = ShaderGraphHash(false, false).calculate(programGraph) + pipelineBuilder->calculateInclusiveHash(module);
+				// Key program by hash of the optimized program graph, the modules and pipeline
+				// settings; identical permutations, also from other shaders, share program.
+				Program& program = programs[combination];
+				program.combinationGraph = combinationGraph;
+				program.programGraph = programGraph;
+				program.module = module;
+				program.key = Key(
+					0x00000000,
+					pipelineBuilder->calculateInclusiveHash(module),
+					dependency->pipelineHash,
+					ShaderGraphHash(false, false).calculate(programGraph)
+				);
+
+				shaderCombination.priority = getPriority(programGraph);
+			});
+		}
 
-				Ref< ProgramResource > programResource = pipelineBuilder->getDataAccessCache()->read< ProgramResource >(
-					Key(0x00000000, 0x00000000, dependency->pipelineHash, hash),
+		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+
+		// Gather unique programs, reuse programs already compiled by this pipeline.
+		SmallMap< Key, uint32_t > uniqueIndices;
+		AlignedVector< uint32_t > uniqueCombinations;
+		RefArray< ProgramResource > uniqueResources;
+		if (status)
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_programCacheLock);
+			for (uint32_t combination = 0; combination < combinationCount; ++combination)
+			{
+				const Key& key = programs[combination].key;
+				if (uniqueIndices.find(key) != uniqueIndices.end())
+					continue;
+
+				uniqueIndices[key] = (uint32_t)uniqueCombinations.size();
+				uniqueCombinations.push_back(combination);
+
+				const auto it = m_programCache.find(key);
+				uniqueResources.push_back(it != m_programCache.end() ? it->second : nullptr);
+			}
+		}
+
+		// Compile unique programs, read from data access cache if compiled in a previous build.
+		int32_t compiledCount = 0;
+		jobs.resize(0);
+		for (uint32_t i = 0; i < uniqueCombinations.size(); ++i)
+		{
+			if (uniqueResources[i] != nullptr)
+				continue;
+
+			jobs.push_back([&, i]() {
+				const uint32_t combination = uniqueCombinations[i];
+				const Program& program = programs[combination];
+
+				uniqueResources[i] = pipelineBuilder->getDataAccessCache()->read< ProgramResource >(
+					program.key,
 					[&]() {
 					pipelineBuilder->getProfiler()->begin(type_of(programCompiler));
 
 					std::list< IProgramCompiler::Error > jobErrors;
 					Ref< ProgramResource > programResource = programCompiler->compile(
-						programGraph,
-						module,
+						program.programGraph,
+						program.module,
 						m_compilerSettings,
 						path,
 						jobErrors);
@@ -720,25 +791,48 @@ bool ShaderPipeline::buildOutput(
 					{
 						T_ANONYMOUS_VAR(Acquire< Semaphore >)(errorsLock);
 						for (const auto& jobError : jobErrors)
-							errors.push_back({ jobError, techniqueName, combination, resolvedGraph, combinationGraph, programGraph });
+							errors.push_back({ jobError, techniqueName, combination, resolvedGraph, program.combinationGraph, program.programGraph });
 					}
 
+					Atomic::increment(compiledCount);
+
 					pipelineBuilder->getProfiler()->end();
 					return programResource;
 				});
+			});
+		}
+
+		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+
+		if (status)
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_programCacheLock);
+			if (m_programCache.size() + uniqueCombinations.size() > c_maxCachedPrograms)
+				m_programCache.clear();
+			for (uint32_t i = 0; i < uniqueCombinations.size(); ++i)
+			{
+				if (uniqueResources[i] != nullptr)
+					m_programCache[programs[uniqueCombinations[i]].key] = uniqueResources[i];
+			}
+
+			for (uint32_t combination = 0; combination < combinationCount; ++combination)
+			{
+				Ref< ProgramResource > programResource = uniqueResources[uniqueIndices[programs[combination].key]];
 				if (!programResource)
 				{
 					log::error << L"ShaderPipeline failed; unable to compile shader \"" << path << L"\"." << Endl;
 					status = false;
-					return;
+					break;
 				}
+				shaderResourceTechnique.combinations[combination].program = programResource;
+			}
 
-				shaderCombination.priority = getPriority(programGraph);
-				shaderCombination.program = programResource;
-			});
-		}
+			shaderUniqueCount += (uint32_t)uniqueCombinations.size();
+			shaderCompiledCount += compiledCount;
 
-		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+			Atomic::add(m_programCount, (int32_t)combinationCount);
+			Atomic::add(m_compiledCount, compiledCount);
+		}
 
 		for (const auto& error : errors)
 		{
@@ -763,7 +857,7 @@ bool ShaderPipeline::buildOutput(
 		log::info << DecreaseIndent;
 	}
 
-	log::info << L"All permutation(s) built." << Endl;
+	log::info << L"All permutation(s) built; " << shaderUniqueCount << L" unique program(s), " << shaderCompiledCount << L" compiled." << Endl;
 
 	// Create output instance.
 	Ref< db::Instance > outputInstance = pipelineBuilder->createOutputInstance(
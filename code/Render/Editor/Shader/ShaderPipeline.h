@@ -33,6 +33,7 @@ namespace traktor::render
 
 class IProgramCompiler;
 class IProgramHints;
+class ProgramResource;
 class ShaderGraph;
 class UniformDeclaration;
 
@@ -88,6 +89,10 @@ private:
 	std::wstring m_debugPath;
 	bool m_editor = false;
 	mutable SmallMap< Key, Ref< ShaderGraph > > m_linkerCache;
+	mutable Semaphore m_programCacheLock;
+	mutable SmallMap< Key, Ref< ProgramResource > > m_programCache;	//!< Programs compiled, or read from cache, by this pipeline keyed by program hash.
+	mutable int32_t m_programCount = 0;
+	mutable int32_t m_compiledCount = 0;
 
 	IProgramCompiler* getProgramCompiler() const;
 };
@@ -0,0 +1,79 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Render/Editor/Test/BenchShaderGraphCombinations.h"
+
+#include "Core/Log/Log.h"
+#include "Core/Misc/String.h"
+#include "Core/Timer/Timer.h"
+#include "Render/Editor/Edge.h"
+#include "Render/Editor/Shader/Nodes.h"
+#include "Render/Editor/Shader/ShaderGraph.h"
+#include "Render/Editor/Shader/Algorithms/ShaderGraphCombinations.h"
+
+namespace traktor::render::test
+{
+namespace
+{
+
+/*! Sum of branches, each branch on its own parameter, into a pixel output. */
+Ref< ShaderGraph > createShaderGraph(int32_t parameterCount)
+{
+	Ref< ShaderGraph > shaderGraph = new ShaderGraph();
+
+	const OutputPin* sumPin = nullptr;
+	for (int32_t i = 0; i < parameterCount; ++i)
+	{
+		Ref< Scalar > scalarTrue = new Scalar(float(i + 1));
+		Ref< Scalar > scalarFalse = new Scalar(0.5f);
+		Ref< Branch > branch = new Branch(str(L"Parameter%d", i));
+
+		shaderGraph->addNode(scalarTrue);
+		shaderGraph->addNode(scalarFalse);
+		shaderGraph->addNode(branch);
+		shaderGraph->addEdge(new Edge(scalarTrue->getOutputPin(0), branch->findInputPin(L"True")));
+		shaderGraph->addEdge(new Edge(scalarFalse->getOutputPin(0), branch->findInputPin(L"False")));
+
+		if (sumPin)
+		{
+			Ref< Add > add = new Add();
+			shaderGraph->addNode(add);
+			shaderGraph->addEdge(new Edge(sumPin, add->findInputPin(L"Input1")));
+			shaderGraph->addEdge(new Edge(branch->getOutputPin(0), add->findInputPin(L"Input2")));
+			sumPin = add->getOutputPin(0);
+		}
+		else
+			sumPin = branch->getOutputPin(0);
+	}
+
+	Ref< PixelOutput > pixelOutput = new PixelOutput();
+	shaderGraph->addNode(pixelOutput);
+	shaderGraph->addEdge(new Edge(sumPin, pixelOutput->findInputPin(L"Input")));
+
+	return shaderGraph;
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.render.test.BenchShaderGraphCombinations", 0, BenchShaderGraphCombinations, traktor::test::Benchmark)
+
+void BenchShaderGraphCombinations::run()
+{
+	for (int32_t parameterCount = 8; parameterCount <= 12; parameterCount += 2)
+	{
+		Ref< ShaderGraph > shaderGraph = createShaderGraph(parameterCount);
+
+		Timer timer;
+		Ref< ShaderGraphCombinations > combinations = new ShaderGraphCombinations(shaderGraph, Guid());
+		const double buildTime = timer.getElapsedTime();
+
+		log::info << L"Shader graph combinations, " << parameterCount << L" parameters; " << combinations->getCombinationCount() << L" combinations in " << int32_t(buildTime * 1000.0) << L" ms" << Endl;
+	}
+}
+
+}
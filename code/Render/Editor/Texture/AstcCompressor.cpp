@@ -6,19 +6,29 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include <astcenc.h>
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Io/Writer.h"
 #include "Core/Log/Log.h"
 #include "Core/Misc/AutoPtr.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/JobManager.h"
 #include "Drawing/Image.h"
 #include "Render/Editor/Texture/AstcCompressor.h"
 
 namespace traktor::render
 {
 
-T_IMPLEMENT_RTTI_CLASS(L"traktor.render.AstcCompressor", AstcCompressor, ICompressor)
+	namespace
+	{
 
-bool AstcCompressor::compress(Writer& writer, const RefArray< drawing::Image >& mipImages, TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality) const
+uint32_t getThreadCount()
+{
+	return std::max< uint32_t >(OS::getInstance().getCPUCoreCount(), 1);
+}
+
+astcenc_context* createContext(TextureFormat textureFormat)
 {
 	astcenc_config config;
 	astcenc_error result;
@@ -83,90 +93,155 @@ bool AstcCompressor::compress(Writer& writer, const RefArray< drawing::Image >&
 
 	default:
 		log::error << L"Unable to compress using ASTC; invalid texture format." << Endl;
-		return false;
+		return nullptr;
 	}
 	
 	if (result != ASTCENC_SUCCESS)
 	{
 		log::error << L"Unable to compress using ASTC; config failed." << Endl;
-		return false;
+		return nullptr;
 	}
 
+	// Context is shared by multiple threads, each image is compressed
+	// by all threads concurrently.
 	astcenc_context* context = nullptr;
-	result = astcenc_context_alloc(&config, 1, &context, nullptr);
+	result = astcenc_context_alloc(&config, getThreadCount(), &context, nullptr);
 	if (result != ASTCENC_SUCCESS)
 	{
 		log::error << L"Unable to compress using ASTC; failed to allocate context." << Endl;
-		return false;
+		return nullptr;
 	}
 
-	for (size_t i = 0; i < mipImages.size(); ++i)
-	{
-		const uint8_t* sourceImageData = (const uint8_t*)mipImages[i]->getData();
-		T_FATAL_ASSERT(sourceImageData != nullptr);
+	return context;
+}
+
+bool compressImage(astcenc_context* context, Writer& writer, const drawing::Image* mipImage, TextureFormat textureFormat)
+{
+	const uint32_t threadCount = getThreadCount();
 
-		uint32_t pitch = mipImages[i]->getWidth() * mipImages[i]->getPixelFormat().getByteSize();
+	const uint8_t* sourceImageData = (const uint8_t*)mipImage->getData();
+	T_FATAL_ASSERT(sourceImageData != nullptr);
 
-		AutoArrayPtr< const uint8_t* > imageRows(new const uint8_t* [mipImages[i]->getHeight()]);
-		for (uint32_t y = 0; y < mipImages[i]->getHeight(); ++y)
-			imageRows[y] = sourceImageData + pitch * y;
+	uint32_t pitch = mipImage->getWidth() * mipImage->getPixelFormat().getByteSize();
 
-		void* data = (void*)imageRows.c_ptr();
+	AutoArrayPtr< const uint8_t* > imageRows(new const uint8_t* [mipImage->getHeight()]);
+	for (uint32_t y = 0; y < mipImage->getHeight(); ++y)
+		imageRows[y] = sourceImageData + pitch * y;
 
-		astcenc_image image;
-		image.dim_x = mipImages[i]->getWidth();
-		image.dim_y = mipImages[i]->getHeight();
-		image.dim_z = 1;
+	void* data = (void*)imageRows.c_ptr();
 
-		if (mipImages[i]->getPixelFormat().isFloatPoint())
+	astcenc_image image;
+	image.dim_x = mipImage->getWidth();
+	image.dim_y = mipImage->getHeight();
+	image.dim_z = 1;
+
+	if (mipImage->getPixelFormat().isFloatPoint())
+	{
+		if (mipImage->getPixelFormat().getRedBits() == 32)
+			image.data_type = ASTCENC_TYPE_F32;
+		else if (mipImage->getPixelFormat().getRedBits() == 16)
+			image.data_type = ASTCENC_TYPE_F16;
+		else
 		{
-			if (mipImages[i]->getPixelFormat().getRedBits() == 32)
-				image.data_type = ASTCENC_TYPE_F32;
-			else if (mipImages[i]->getPixelFormat().getRedBits() == 16)
-				image.data_type = ASTCENC_TYPE_F16;
-			else
-			{
-				log::error << L"Unable to compress using ASTC; unsupported number of float point bits." << Endl;
-				return false;
-			}
+			log::error << L"Unable to compress using ASTC; unsupported number of float point bits." << Endl;
+			return false;
 		}
-		else
-			image.data_type = ASTCENC_TYPE_U8;
+	}
+	else
+		image.data_type = ASTCENC_TYPE_U8;
 
-		image.data = &data;
+	image.data = &data;
 
-		astcenc_swizzle swizzle;
-		swizzle.r = ASTCENC_SWZ_R;
-		swizzle.g = ASTCENC_SWZ_G;
-		swizzle.b = ASTCENC_SWZ_B;
-		swizzle.a = ASTCENC_SWZ_A;
+	astcenc_swizzle swizzle;
+	swizzle.r = ASTCENC_SWZ_R;
+	swizzle.g = ASTCENC_SWZ_G;
+	swizzle.b = ASTCENC_SWZ_B;
+	swizzle.a = ASTCENC_SWZ_A;
 
-		size_t imageSize = getTextureMipPitch(textureFormat, image.dim_x, image.dim_y);
-		AutoArrayPtr< uint8_t > imageData(new uint8_t [imageSize]);
+	size_t imageSize = getTextureMipPitch(textureFormat, image.dim_x, image.dim_y);
+	AutoArrayPtr< uint8_t > imageData(new uint8_t [imageSize]);
 
-		result = astcenc_compress_image(context, &image, &swizzle, imageData.ptr(), imageSize, 0);
-		if (result != ASTCENC_SUCCESS)
-		{
-			log::error << L"Unable to compress using ASTC; failed to compress image." << Endl;
-			return false;
-		}
+	AlignedVector< astcenc_error > results(threadCount, ASTCENC_SUCCESS);
+	AlignedVector< Job::task_t > jobs;
+	for (uint32_t j = 0; j < threadCount; ++j)
+	{
+		jobs.push_back([&, j]() {
+			results[j] = astcenc_compress_image(context, &image, &swizzle, imageData.ptr(), imageSize, j);
+		});
+	}
+	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
 
-		result = astcenc_compress_reset(context);
-		if (result != ASTCENC_SUCCESS)
-		{
-			log::error << L"Unable to compress using ASTC; failed to reset context." << Endl;
-			return false;
-		}
+	if (std::find_if(results.begin(), results.end(), [](astcenc_error r) { return r != ASTCENC_SUCCESS; }) != results.end())
+	{
+		log::error << L"Unable to compress using ASTC; failed to compress image." << Endl;
+		return false;
+	}
 
-		if (writer.write(imageData.c_ptr(), imageSize, 1) != imageSize)
-		{
-			log::error << L"Unable to compress using ASTC; failed to write image data to file." << Endl;
+	if (astcenc_compress_reset(context) != ASTCENC_SUCCESS)
+	{
+		log::error << L"Unable to compress using ASTC; failed to reset context." << Endl;
+		return false;
+	}
+
+	if (writer.write(imageData.c_ptr(), imageSize, 1) != imageSize)
+	{
+		log::error << L"Unable to compress using ASTC; failed to write image data to file." << Endl;
+		return false;
+	}
+
+	return true;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.render.AstcCompressor", AstcCompressor, ICompressor)
+
+AstcCompressor::~AstcCompressor()
+{
+	end();
+}
+
+bool AstcCompressor::begin(TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality)
+{
+	end();
+
+	// Allocate context once and reuse it for every mip and face of texture.
+	if ((m_context = createContext(textureFormat)) == nullptr)
+		return false;
+
+	m_textureFormat = textureFormat;
+	return true;
+}
+
+void AstcCompressor::end()
+{
+	if (m_context)
+	{
+		astcenc_context_free(m_context);
+		m_context = nullptr;
+	}
+	m_textureFormat = TfInvalid;
+}
+
+bool AstcCompressor::compress(Writer& writer, const RefArray< drawing::Image >& mipImages, TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality) const
+{
+	// Use context from begin if format match, else allocate a context only for this call.
+	astcenc_context* context = (textureFormat == m_textureFormat) ? m_context : nullptr;
+	astcenc_context* ownedContext = nullptr;
+	if (!context)
+	{
+		if ((context = ownedContext = createContext(textureFormat)) == nullptr)
 			return false;
-		}
 	}
 
-	astcenc_context_free(context);
-    return true;
+	bool result = true;
+	for (size_t i = 0; i < mipImages.size() && result; ++i)
+		result = compressImage(context, writer, mipImages[i], textureFormat);
+
+	if (ownedContext)
+		astcenc_context_free(ownedContext);
+
+	return result;
 }
 
 }
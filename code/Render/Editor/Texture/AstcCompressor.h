@@ -18,6 +18,8 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+struct astcenc_context;
+
 namespace traktor::render
 {
 
@@ -29,7 +31,17 @@ class T_DLLCLASS AstcCompressor : public ICompressor
 	T_RTTI_CLASS;
 
 public:
+	virtual ~AstcCompressor();
+
+	virtual bool begin(TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality) override final;
+
+	virtual void end() override final;
+
 	virtual bool compress(Writer& writer, const RefArray< drawing::Image >& mipImages, TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality) const override final;
+
+private:
+	astcenc_context* m_context = nullptr;
+	TextureFormat m_textureFormat = TfInvalid;
 };
 
 }
@@ -6,14 +6,13 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Io/Writer.h"
 #include "Core/Log/Log.h"
-#include "Core/Misc/AutoPtr.h"
-#include "Core/Thread/Job.h"
-#include "Core/Thread/JobManager.h"
 #include "Drawing/Image.h"
 #include "Drawing/PixelFormat.h"
 #include "Render/Editor/Texture/Bc6hCompressor.h"
+#include "Render/Editor/Texture/ParallelBlockRows.h"
 
 #if defined(_WIN32)
 #	define BC6H_ENC_IMPLEMENTATION
@@ -28,25 +27,27 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.render.Bc6hCompressor", Bc6hCompressor, ICompre
 
 bool Bc6hCompressor::compress(Writer& writer, const RefArray< drawing::Image >& mipImages, TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality) const
 {
-	AutoPtr< uint8_t > compressedData[64];
-	Ref< Job > jobs[64];
+	AlignedVector< uint8_t > compressedData;
 
-	const int32_t mipCount = (int32_t)mipImages.size();
-	for (int32_t i = 0; i < mipCount; ++i)
+	for (auto mipImage : mipImages)
 	{
-		const drawing::Image* mipImage = mipImages[i];
-		const int32_t byteSize = getTextureMipPitch(textureFormat, mipImage->getWidth(), mipImage->getHeight());
+		const int32_t width = mipImage->getWidth();
+		const int32_t height = mipImage->getHeight();
+		const int32_t blockCountX = (width + 3) / 4;
+		const int32_t blockCountY = (height + 3) / 4;
 
-		compressedData[i].reset(new uint8_t[byteSize]);
-		uint8_t* compressedDataPtr = compressedData[i].ptr();
+		const int32_t byteSize = getTextureMipPitch(textureFormat, width, height);
+		compressedData.resize(byteSize);
 
-		jobs[i] = JobManager::getInstance().add([=]() {
+		// Compress rows of blocks in parallel.
+		uint8_t* compressedDataPtr = compressedData.ptr();
+		parallelBlockRows(blockCountX, blockCountY, [&](int32_t fromY, int32_t toY) {
 			Color4f tmp;
 
-			uint8_t* wp = compressedDataPtr;
-			for (int32_t y = 0; y < mipImage->getHeight(); y += 4)
+			uint8_t* wp = compressedDataPtr + fromY * blockCountX * 16;
+			for (int32_t y = fromY * 4; y < toY * 4; y += 4)
 			{
-				for (int32_t x = 0; x < mipImage->getWidth(); x += 4)
+				for (int32_t x = 0; x < width; x += 4)
 				{
 					float T_MATH_ALIGN16 source[4 * 4 * 4];
 					float* sp = source;
@@ -70,17 +71,8 @@ bool Bc6hCompressor::compress(Writer& writer, const RefArray< drawing::Image >&
 				}
 			}
 		});
-	}
-
-	for (int32_t i = 0; i < mipCount; ++i)
-	{
-		if (!jobs[i]->wait())
-			return false;
-
-		const drawing::Image* mipImage = mipImages[i];
-		const int32_t byteSize = getTextureMipPitch(textureFormat, mipImage->getWidth(), mipImage->getHeight());
 
-		if (writer.write(compressedData[i].ptr(), byteSize, 1) != byteSize)
+		if (writer.write(compressedData.c_ptr(), byteSize, 1) != byteSize)
 			return false;
 	}
 
@@ -18,126 +18,107 @@
 #endif
 
 #include <cstring>
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Io/Writer.h"
 #include "Core/Log/Log.h"
-#include "Core/Thread/Job.h"
-#include "Core/Thread/JobManager.h"
 #include "Drawing/Image.h"
 #include "Render/Editor/Texture/DxtnCompressor.h"
+#include "Render/Editor/Texture/ParallelBlockRows.h"
 
 namespace traktor::render
 {
 	namespace
 	{
 
-struct CompressTextureTask : public RefCountImpl< IRefCount >
+void compressBlocks(const drawing::Image* image, TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality, int32_t fromY, int32_t toY, uint8_t* block)
 {
-	const drawing::Image* image = nullptr;
-	TextureFormat textureFormat = TfInvalid;
-	bool needAlpha = false;
-	int32_t compressionQuality = 0;
-	AlignedVector< uint8_t > output;
+	const int32_t width = image->getWidth();
+	const int32_t height = image->getHeight();
+	const uint8_t* data = static_cast< const uint8_t* >(image->getData());
 
-	void execute()
+	for (int32_t y = fromY; y < toY; y += 4)
 	{
-		const int32_t width = image->getWidth();
-		const int32_t height = image->getHeight();
-
-		const uint32_t outputSize = getTextureMipPitch(
-			textureFormat,
-			width,
-			height
-		);
-
-		output.resize(outputSize, 0);
+		for (int32_t x = 0; x < width; x += 4)
+		{
+			uint8_t rgba[4][4][4];
+			int32_t mask = 0;
 
-		const uint8_t* data = static_cast< const uint8_t* >(image->getData());
-		uint8_t* block = &output[0];
+			std::memset(rgba, 0, sizeof(rgba));
 
-		for (int32_t y = 0; y < height; y += 4)
-		{
-			for (int32_t x = 0; x < width; x += 4)
+			for (int iy = 0; iy < 4; ++iy)
 			{
-				uint8_t rgba[4][4][4];
-				int32_t mask = 0;
+				for (int ix = 0; ix < 4; ++ix)
+				{
+					const int32_t sx = x + ix;
+					const int32_t sy = y + iy;
 
-				std::memset(rgba, 0, sizeof(rgba));
+					if (sx >= width || sy >= height)
+						continue;
 
-				for (int iy = 0; iy < 4; ++iy)
-				{
-					for (int ix = 0; ix < 4; ++ix)
-					{
-						const int32_t sx = x + ix;
-						const int32_t sy = y + iy;
-
-						if (sx >= width || sy >= height)
-							continue;
-
-						const uint32_t offset = (sx + sy * image->getWidth()) * 4;
-						rgba[iy][ix][0] = data[offset + 0];
-						rgba[iy][ix][1] = data[offset + 1];
-						rgba[iy][ix][2] = data[offset + 2];
-						rgba[iy][ix][3] = needAlpha ? data[offset + 3] : 0xff;
-
-						mask |= 1 << (ix + iy * 4);
-					}
+					const uint32_t offset = (sx + sy * image->getWidth()) * 4;
+					rgba[iy][ix][0] = data[offset + 0];
+					rgba[iy][ix][1] = data[offset + 1];
+					rgba[iy][ix][2] = data[offset + 2];
+					rgba[iy][ix][3] = needAlpha ? data[offset + 3] : 0xff;
+
+					mask |= 1 << (ix + iy * 4);
 				}
+			}
 
 #if USE_DXT_COMPRESSOR == SQUISH_COMPRESSOR
-				const int32_t c_compressionFlags[] = { squish::kColourRangeFit, squish::kColourClusterFit, squish::kColourIterativeClusterFit };
-
-				int32_t flags = c_compressionFlags[compressionQuality];
-				if (textureFormat == TfDXT1)
-					flags |= squish::kDxt1;
-				else if (textureFormat == TfDXT3)
-					flags |= squish::kDxt3;
-				else if (textureFormat == TfDXT5)
-					flags |= squish::kDxt5;
-
-				if (needAlpha)
-					flags |= squish::kWeightColourByAlpha;
-
-				squish::CompressMasked(
-					(const squish::u8*)rgba,
-					mask,
+			const int32_t c_compressionFlags[] = { squish::kColourRangeFit, squish::kColourClusterFit, squish::kColourIterativeClusterFit };
+
+			int32_t flags = c_compressionFlags[compressionQuality];
+			if (textureFormat == TfDXT1)
+				flags |= squish::kDxt1;
+			else if (textureFormat == TfDXT3)
+				flags |= squish::kDxt3;
+			else if (textureFormat == TfDXT5)
+				flags |= squish::kDxt5;
+
+			if (needAlpha)
+				flags |= squish::kWeightColourByAlpha;
+
+			squish::CompressMasked(
+				(const squish::u8*)rgba,
+				mask,
+				block,
+				flags
+			);
+#elif USE_DXT_COMPRESSOR == STB_DXT_COMPRESSOR
+			if (textureFormat == TfDXT1 || textureFormat == TfDXT5)
+			{
+				stb_compress_dxt_block(
 					block,
-					flags
+					(const unsigned char*)rgba,
+					needAlpha,
+					compressionQuality > 0 ? STB_DXT_HIGHQUAL : STB_DXT_NORMAL
+				);
+			}
+			else if (textureFormat == TfDXT3)
+			{
+				// Manually compress alpha as stb_dxt doesn't support DXT3.
+				block[0] = (rgba[0][1][3] & 0xf0) | (rgba[0][0][3] >> 4);
+				block[1] = (rgba[0][3][3] & 0xf0) | (rgba[0][2][3] >> 4);
+				block[2] = (rgba[1][1][3] & 0xf0) | (rgba[1][0][3] >> 4);
+				block[3] = (rgba[1][3][3] & 0xf0) | (rgba[1][2][3] >> 4);
+				block[4] = (rgba[2][1][3] & 0xf0) | (rgba[2][0][3] >> 4);
+				block[5] = (rgba[2][3][3] & 0xf0) | (rgba[2][2][3] >> 4);
+				block[6] = (rgba[3][1][3] & 0xf0) | (rgba[3][0][3] >> 4);
+				block[7] = (rgba[3][3][3] & 0xf0) | (rgba[3][2][3] >> 4);
+
+				stb_compress_dxt_block(
+					&block[8],
+					(const unsigned char*)rgba,
+					0,
+					compressionQuality > 0 ? STB_DXT_HIGHQUAL : STB_DXT_NORMAL
 				);
-#elif USE_DXT_COMPRESSOR == STB_DXT_COMPRESSOR
-				if (textureFormat == TfDXT1 || textureFormat == TfDXT5)
-				{
-					stb_compress_dxt_block(
-						block,
-						(const unsigned char*)rgba,
-						needAlpha,
-						compressionQuality > 0 ? STB_DXT_HIGHQUAL : STB_DXT_NORMAL
-					);
-				}
-				else if (textureFormat == TfDXT3)
-				{
-					// Manually compress alpha as stb_dxt doesn't support DXT3.
-					block[0] = (rgba[0][1][3] & 0xf0) | (rgba[0][0][3] >> 4);
-					block[1] = (rgba[0][3][3] & 0xf0) | (rgba[0][2][3] >> 4);
-					block[2] = (rgba[1][1][3] & 0xf0) | (rgba[1][0][3] >> 4);
-					block[3] = (rgba[1][3][3] & 0xf0) | (rgba[1][2][3] >> 4);
-					block[4] = (rgba[2][1][3] & 0xf0) | (rgba[2][0][3] >> 4);
-					block[5] = (rgba[2][3][3] & 0xf0) | (rgba[2][2][3] >> 4);
-					block[6] = (rgba[3][1][3] & 0xf0) | (rgba[3][0][3] >> 4);
-					block[7] = (rgba[3][3][3] & 0xf0) | (rgba[3][2][3] >> 4);
-
-					stb_compress_dxt_block(
-						&block[8],
-						(const unsigned char*)rgba,
-						0,
-						compressionQuality > 0 ? STB_DXT_HIGHQUAL : STB_DXT_NORMAL
-					);
-				}
-#endif
-				block += getTextureBlockSize(textureFormat);
 			}
+#endif
+			block += getTextureBlockSize(textureFormat);
 		}
 	}
-};
+}
 
 	}
 
@@ -145,34 +126,26 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.render.DxtnCompressor", DxtnCompressor, ICompre
 
 bool DxtnCompressor::compress(Writer& writer, const RefArray< drawing::Image >& mipImages, TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality) const
 {
-	RefArray< CompressTextureTask > tasks;
-	RefArray< Job > jobs;
+	const uint32_t blockSize = getTextureBlockSize(textureFormat);
+	AlignedVector< uint8_t > output;
 
-	const int32_t mipCount = (int32_t)mipImages.size();
-	for (int32_t i = 0; i < mipCount; ++i)
+	for (auto mipImage : mipImages)
 	{
-		Ref< CompressTextureTask > task = new CompressTextureTask();
-		task->image = mipImages[i];
-		task->textureFormat = textureFormat;
-		task->needAlpha = needAlpha;
-		task->compressionQuality = compressionQuality;
+		const int32_t width = mipImage->getWidth();
+		const int32_t height = mipImage->getHeight();
+		const int32_t blockCountX = (width + 3) / 4;
+		const int32_t blockCountY = (height + 3) / 4;
 
-		jobs.push_back(
-			JobManager::getInstance().add([=](){ task->execute(); })
-		);
+		const uint32_t outputSize = getTextureMipPitch(textureFormat, width, height);
+		output.resize(outputSize, 0);
 
-		tasks.push_back(task);
-	}
+		// Compress rows of blocks in parallel, each band writes to its own part of output.
+		uint8_t* block = output.ptr();
+		parallelBlockRows(blockCountX, blockCountY, [&](int32_t fromY, int32_t toY) {
+			compressBlocks(mipImage, textureFormat, needAlpha, compressionQuality, fromY * 4, toY * 4, block + fromY * blockCountX * blockSize);
+		});
 
-	for (size_t i = 0; i < jobs.size(); ++i)
-	{
-		jobs[i]->wait();
-		jobs[i] = nullptr;
-	}
-
-	for (auto task : tasks)
-	{
-		if (writer.write(task->output.c_ptr(), (int64_t)task->output.size(), 1) != task->output.size())
+		if (writer.write(output.c_ptr(), outputSize, 1) != outputSize)
 			return false;
 	}
 
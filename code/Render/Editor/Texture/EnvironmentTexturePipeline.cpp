@@ -177,6 +177,25 @@ bool EnvironmentTexturePipeline::buildOutput(
 	Ref< IStream > streamData = new BufferedStream(new compress::DeflateStreamLzf(stream), 64 * 1024);
 	Writer writerData(streamData);
 
+	Ref< ICompressor > compressor;
+	if (textureFormat >= TfDXT1 && textureFormat <= TfDXT5)
+		compressor = new DxtnCompressor();
+	else if (textureFormat >= TfPVRTC1 && textureFormat <= TfPVRTC4)
+		compressor = new PvrtcCompressor();
+	else if (textureFormat == TfETC1)
+		compressor = new EtcCompressor();
+	else if (textureFormat == TfASTC4x4 && textureFormat <= TfASTC12x12)
+		compressor = new AstcCompressor();
+	else
+		compressor = new UnCompressor();
+
+	// Prepare compressor once for all sides.
+	if (!compressor->begin(textureFormat, false, m_compressionQuality))
+	{
+		log::error << L"Unable to prepare texture compressor." << Endl;
+		return false;
+	}
+
 	const int32_t sampleCounts[] = { 1, 200, 400, 600, 800, 1000 };
 	for (int32_t side = 0; side < 6; ++side)
 	{
@@ -256,24 +275,14 @@ bool EnvironmentTexturePipeline::buildOutput(
 			JobManager::getInstance().fork(tasks.c_ptr(), tasks.size());
 		}
 
-		Ref< ICompressor > compressor;
-		if (textureFormat >= TfDXT1 && textureFormat <= TfDXT5)
-			compressor = new DxtnCompressor();
-		else if (textureFormat >= TfPVRTC1 && textureFormat <= TfPVRTC4)
-			compressor = new PvrtcCompressor();
-		else if (textureFormat == TfETC1)
-			compressor = new EtcCompressor();
-		else if (textureFormat == TfASTC4x4 && textureFormat <= TfASTC12x12)
-			compressor = new AstcCompressor();
-		else
-			compressor = new UnCompressor();
-
 		log::info << L"Compressing texture..." << Endl;
 		pipelineBuilder->getProfiler()->begin(type_of(compressor));
 		compressor->compress(writerData, mipImages, textureFormat, false, m_compressionQuality);
 		pipelineBuilder->getProfiler()->end();
 	}
 
+	compressor->end();
+
 	streamData->close();
 
 	if (!outputInstance->commit())
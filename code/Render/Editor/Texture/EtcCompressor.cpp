@@ -13,6 +13,7 @@
 #include "Drawing/Image.h"
 #include "Drawing/PixelFormat.h"
 #include "Render/Editor/Texture/EtcCompressor.h"
+#include "Render/Editor/Texture/ParallelBlockRows.h"
 
 namespace traktor::render
 {
@@ -38,38 +39,44 @@ bool EtcCompressor::compress(Writer& writer, const RefArray< drawing::Image >& m
 		T_ASSERT(byteSize <= maxByteSize);
 
 		Ref< drawing::Image > mipImage = mipImages[i];
-		uint8_t* wp = compressedData.ptr();
+		const int32_t blockCountX = (mipImage->getWidth() + 3) / 4;
+		const int32_t blockCountY = (mipImage->getHeight() + 3) / 4;
 
-		for (int32_t y = 0; y < mipImage->getHeight(); y += 4)
-		{
-			for (int32_t x = 0; x < mipImage->getWidth(); x += 4)
+		// Compress rows of blocks in parallel.
+		uint8_t* compressedDataPtr = compressedData.ptr();
+		parallelBlockRows(blockCountX, blockCountY, [&](int32_t fromY, int32_t toY) {
+			uint8_t* wp = compressedDataPtr + fromY * blockCountX * 8;
+			for (int32_t y = fromY * 4; y < toY * 4; y += 4)
 			{
-				uint8_t source[4 * 4 * 4];
-				uint8_t* sp = source;
-
-				for (int32_t iy = 0; iy < 4; ++iy)
+				for (int32_t x = 0; x < mipImage->getWidth(); x += 4)
 				{
-					for (int32_t ix = 0; ix < 4; ++ix)
+					uint8_t source[4 * 4 * 4];
+					uint8_t* sp = source;
+
+					for (int32_t iy = 0; iy < 4; ++iy)
 					{
-						Color4f tmp;
-						mipImage->getPixel(x + ix, y + iy, tmp);
+						for (int32_t ix = 0; ix < 4; ++ix)
+						{
+							Color4f tmp;
+							mipImage->getPixel(x + ix, y + iy, tmp);
 
-						*sp++ = uint8_t(tmp.getRed() * 255);
-						*sp++ = uint8_t(tmp.getGreen() * 255);
-						*sp++ = uint8_t(tmp.getBlue() * 255);
-						*sp++ = 255;
+							*sp++ = uint8_t(tmp.getRed() * 255);
+							*sp++ = uint8_t(tmp.getGreen() * 255);
+							*sp++ = uint8_t(tmp.getBlue() * 255);
+							*sp++ = 255;
+						}
 					}
-				}
 
-				rg_etc1::pack_etc1_block(
-					wp,
-					(const unsigned int *)source,
-					params
-				);
+					rg_etc1::pack_etc1_block(
+						wp,
+						(const unsigned int *)source,
+						params
+					);
 
-				wp += 8;
+					wp += 8;
+				}
 			}
-		}
+		});
 
 		if (writer.write(compressedData.ptr(), byteSize, 1) != byteSize)
 			return false;
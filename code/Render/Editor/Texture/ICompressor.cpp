@@ -13,4 +13,13 @@ namespace traktor::render
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.render.ICompressor", ICompressor, Object)
 
+bool ICompressor::begin(TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality)
+{
+	return true;
+}
+
+void ICompressor::end()
+{
+}
+
 }
@@ -45,6 +45,16 @@ class T_DLLCLASS ICompressor : public Object
 	T_RTTI_CLASS;
 
 public:
+	/*! Prepare compressor for all images of a texture.
+	 *
+	 * Compressors may set up state shared by all subsequent
+	 * calls to compress until end is called.
+	 */
+	virtual bool begin(TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality);
+
+	/*! Release state set up by begin. */
+	virtual void end();
+
 	virtual bool compress(Writer& writer, const RefArray< drawing::Image >& mipImages, TextureFormat textureFormat, bool needAlpha, int32_t compressionQuality) const = 0;
 };
 
@@ -0,0 +1,41 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Thread/ParallelFor.h"
+
+#include <algorithm>
+
+namespace traktor::render
+{
+
+const int32_t c_blocksPerJob = 4096;	//!< Minimum number of blocks compressed by each job.
+
+/*! Split rows of compression blocks into bands and compress bands on job manager.
+ * \ingroup Render
+ *
+ * Each band is a contiguous range of block rows, so each band
+ * writes only its own part of compressed output.
+ *
+ * \param blockCountX Number of blocks in each row.
+ * \param blockCountY Number of block rows.
+ * \param fn Functor called with [fromY, toY) band, in block rows.
+ */
+template < typename FunctionType >
+void parallelBlockRows(int32_t blockCountX, int32_t blockCountY, const FunctionType& fn)
+{
+	if (blockCountX <= 0 || blockCountY <= 0)
+		return;
+
+	parallelFor(blockCountY, c_blocksPerJob / blockCountX, [&](uint32_t fromY, uint32_t toY) {
+		fn((int32_t)fromY, (int32_t)toY);
+	});
+}
+
+}
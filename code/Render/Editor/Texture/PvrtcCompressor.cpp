@@ -36,7 +36,8 @@ bool PvrtcCompressor::compress(Writer& writer, const RefArray< drawing::Image >&
 		int32_t byteSize = pvrtc_size(mipImages[i]->getWidth(), mipImages[i]->getHeight(), 0, use2Bit);
 		T_ASSERT(byteSize <= maxByteSize);
 
-		Ref< drawing::Image > mipImage = mipImages[i];
+		// Convert a copy as input images must not be modified.
+		Ref< drawing::Image > mipImage = mipImages[i]->clone();
 		mipImage->convert(drawing::PixelFormat::getA8R8G8B8());
 
 		pvrtc_compress(
@@ -681,10 +681,31 @@ bool TextureOutputPipeline::buildOutput(
 		if (mipCount > 0)
 			log::info << L"Generating " << mipCount << L" mip(s)..." << Endl;
 
-		RefArray< drawing::Image > mipImages(mipCount);
+		// Create compressor and use it to write mips to instance.
+		Ref< ICompressor > compressor;
+		if (textureFormat >= TfDXT1 && textureFormat <= TfDXT5)
+			compressor = new DxtnCompressor();
+		else if (textureFormat >= TfBC6HU && textureFormat <= TfBC6HS)
+			compressor = new Bc6hCompressor();
+		else if (textureFormat >= TfPVRTC1 && textureFormat <= TfPVRTC4)
+			compressor = new PvrtcCompressor();
+		else if (textureFormat == TfETC1)
+			compressor = new EtcCompressor();
+		else if (textureFormat == TfASTC4x4 && textureFormat <= TfASTC12x12)
+			compressor = new AstcCompressor();
+		else
+			compressor = new UnCompressor();
+
+		// Prepare compressor once for all mips.
+		if (!compressor->begin(textureFormat, needAlpha, m_compressionQuality))
+		{
+			log::error << L"Unable to prepare texture compressor." << Endl;
+			return false;
+		}
 
 		// Generate each mip level.
 #if defined(T_USE_MIP_SCALE_TASKS)
+		RefArray< drawing::Image > mipImages(mipCount);
 		{
 			RefArray< ScaleTextureTask > tasks(mipCount);
 			RefArray< Job > jobs(mipCount);
@@ -783,17 +804,30 @@ bool TextureOutputPipeline::buildOutput(
 				return false;
 			}
 		}
+
+		log::info << L"Compressing texture..." << Endl;
+		pipelineBuilder->getProfiler()->begin(type_of(compressor));
+		compressor->compress(writerData, mipImages, textureFormat, needAlpha, m_compressionQuality);
+		pipelineBuilder->getProfiler()->end();
 #else
+		log::info << L"Compressing texture..." << Endl;
+
+		// Generate, process and compress one mip at a time; each mip is scaled
+		// from previous unprocessed mip thus at most two mips are kept in memory.
+		Ref< drawing::Image > sourceImage = image;
 		for (int32_t i = 0; i < mipCount; ++i)
 		{
+			if (ThreadManager::getInstance().getCurrentThread()->stopped())
+			{
+				log::info << L"Texture pipeline terminated. Pipeline aborted." << Endl;
+				return false;
+			}
+
 			const int32_t mipWidth = std::max(width >> i, 1);
 			const int32_t mipHeight = std::max(height >> i, 1);
 
-			// Clone previous mip image.
-			mipImages[i] = i > 0 ? mipImages[i - 1]->clone() : image->clone();
-
-			// Scale image to desired mip size.
-			if (mipWidth != image->getWidth() || mipHeight != image->getHeight())
+			// Scale previous mip image to desired mip size.
+			if (mipWidth != sourceImage->getWidth() || mipHeight != sourceImage->getHeight())
 			{
 				drawing::ScaleFilter scaleFilter(
 					mipWidth,
@@ -801,19 +835,22 @@ bool TextureOutputPipeline::buildOutput(
 					drawing::ScaleFilter::MnAverage,
 					drawing::ScaleFilter::MgLinear,
 					textureOutput->m_keepZeroAlpha);
-				mipImages[i]->apply(&scaleFilter);
+				sourceImage->apply(&scaleFilter);
 			}
-		}
 
-		// Adjust alpha from coverage.
-		if (alphaCoverage > 0.0f)
-			for (auto mipImage : mipImages)
+			// Process a copy of mip image if necessary; source is kept
+			// intact as it's used to generate next mip.
+			const bool sharpenMip = !textureOutput->m_normalMap && textureOutput->m_sharpenRadius > 0 && i > 0;
+			const bool processMip = alphaCoverage > 0.0f || textureOutput->m_normalMap || sharpenMip;
+
+			Ref< drawing::Image > mipImage = processMip ? sourceImage->clone() : sourceImage;
+
+			// Adjust alpha from coverage.
+			if (alphaCoverage > 0.0f)
 				adjustAlphaCoverage(mipImage, textureOutput->m_alphaCoverageReference, alphaCoverage);
 
-		// Ensure each pixel is renormalized after scaling.
-		if (textureOutput->m_normalMap)
-		{
-			for (auto mipImage : mipImages)
+			// Ensure each pixel is renormalized after scaling.
+			if (textureOutput->m_normalMap)
 			{
 				if (abs(textureOutput->m_scaleNormalMap) > FUZZY_EPSILON)
 				{
@@ -828,40 +865,27 @@ bool TextureOutputPipeline::buildOutput(
 					mipImage->apply(&swizzleFilter);
 				}
 			}
-		}
 
-		// Apply sharpen filter.
-		if (!textureOutput->m_normalMap && textureOutput->m_sharpenRadius > 0)
-		{
-			for (int32_t i = 1; i < (int32_t)mipImages.size(); ++i)
+			// Apply sharpen filter.
+			if (sharpenMip)
 			{
 				const drawing::SharpenFilter sharpenFilter(
 					textureOutput->m_sharpenRadius,
 					textureOutput->m_sharpenStrength * (float(i) / (mipCount - 1)));
-				mipImages[i]->apply(&sharpenFilter);
+				mipImage->apply(&sharpenFilter);
 			}
+
+			// Compress mip and write to stream before next mip is generated.
+			RefArray< drawing::Image > mipImages(1);
+			mipImages[0] = mipImage;
+
+			pipelineBuilder->getProfiler()->begin(type_of(compressor));
+			compressor->compress(writerData, mipImages, textureFormat, needAlpha, m_compressionQuality);
+			pipelineBuilder->getProfiler()->end();
 		}
 #endif
 
-		// Create compressor and use it to write mips to instance.
-		Ref< const ICompressor > compressor;
-		if (textureFormat >= TfDXT1 && textureFormat <= TfDXT5)
-			compressor = new DxtnCompressor();
-		else if (textureFormat >= TfBC6HU && textureFormat <= TfBC6HS)
-			compressor = new Bc6hCompressor();
-		else if (textureFormat >= TfPVRTC1 && textureFormat <= TfPVRTC4)
-			compressor = new PvrtcCompressor();
-		else if (textureFormat == TfETC1)
-			compressor = new EtcCompressor();
-		else if (textureFormat == TfASTC4x4 && textureFormat <= TfASTC12x12)
-			compressor = new AstcCompressor();
-		else
-			compressor = new UnCompressor();
-
-		log::info << L"Compressing texture..." << Endl;
-		pipelineBuilder->getProfiler()->begin(type_of(compressor));
-		compressor->compress(writerData, mipImages, textureFormat, needAlpha, m_compressionQuality);
-		pipelineBuilder->getProfiler()->end();
+		compressor->end();
 
 		streamData->close();
 
@@ -987,13 +1011,32 @@ bool TextureOutputPipeline::buildOutput(
 
 		Writer writerData(streamData);
 
+		Ref< ICompressor > compressor;
+		if (textureFormat >= TfDXT1 && textureFormat <= TfDXT5)
+			compressor = new DxtnCompressor();
+		else if (textureFormat >= TfPVRTC1 && textureFormat <= TfPVRTC4)
+			compressor = new PvrtcCompressor();
+		else if (textureFormat == TfETC1)
+			compressor = new EtcCompressor();
+		else if (textureFormat == TfASTC4x4 && textureFormat <= TfASTC12x12)
+			compressor = new AstcCompressor();
+		else
+			compressor = new UnCompressor();
+
+		// Prepare compressor once for all sides and mips.
+		if (!compressor->begin(textureFormat, needAlpha, m_compressionQuality))
+		{
+			log::error << L"Unable to prepare texture compressor." << Endl;
+			return false;
+		}
+
+		log::info << L"Compressing texture..." << Endl;
+
 		for (int32_t side = 0; side < 6; ++side)
 		{
 			Ref< drawing::Image > sideImage = cubeMap->getSide(side);
 
-			RefArray< drawing::Image > mipImages(mipCount);
-
-			// Generate mip levels.
+			// Generate and compress one mip level at a time.
 			for (int32_t i = 0; i < mipCount; ++i)
 			{
 				const int32_t mipSize = sideSize >> i;
@@ -1006,27 +1049,17 @@ bool TextureOutputPipeline::buildOutput(
 					textureOutput->m_keepZeroAlpha);
 				sideImage->apply(&mipScaleFilter);
 
-				mipImages[i] = sideImage->clone();
-			}
-
-			Ref< ICompressor > compressor;
-			if (textureFormat >= TfDXT1 && textureFormat <= TfDXT5)
-				compressor = new DxtnCompressor();
-			else if (textureFormat >= TfPVRTC1 && textureFormat <= TfPVRTC4)
-				compressor = new PvrtcCompressor();
-			else if (textureFormat == TfETC1)
-				compressor = new EtcCompressor();
-			else if (textureFormat == TfASTC4x4 && textureFormat <= TfASTC12x12)
-				compressor = new AstcCompressor();
-			else
-				compressor = new UnCompressor();
+				RefArray< drawing::Image > mipImages(1);
+				mipImages[0] = sideImage;
 
-			log::info << L"Compressing texture..." << Endl;
-			pipelineBuilder->getProfiler()->begin(type_of(compressor));
-			compressor->compress(writerData, mipImages, textureFormat, needAlpha, m_compressionQuality);
-			pipelineBuilder->getProfiler()->end();
+				pipelineBuilder->getProfiler()->begin(type_of(compressor));
+				compressor->compress(writerData, mipImages, textureFormat, needAlpha, m_compressionQuality);
+				pipelineBuilder->getProfiler()->end();
+			}
 		}
 
+		compressor->end();
+
 		streamData->close();
 
 		dataOffsetEnd = stream->tell();
@@ -188,6 +188,8 @@ void ProfilerDialog::receivedPerfSets()
 	const TpsMemory& memory = m_connection->getPerformance< TpsMemory >();
 	m_performanceGrid->addRow(createPerformanceRow(L"Memory (Native)", str(L"%d KiB", memory.memInUse / 1024)));
 	m_performanceGrid->addRow(createPerformanceRow(L"Memory (Script)", str(L"%d KiB", memory.memInUseScript / 1024)));
+	m_performanceGrid->addRow(createPerformanceRow(L"Script Allocation Rate", str(L"%.1f KiB/s", memory.scriptAllocationRate / 1024.0f)));
+	m_performanceGrid->addRow(createPerformanceRow(L"Script GC Worst Pause", str(L"%.2f ms", memory.scriptCollectWorst * 1000.0f)));
 	m_performanceGrid->addRow(createPerformanceRow(L"Heap Objects", str(L"%d", memory.heapObjects)));
 
 	const TpsRender& render = m_connection->getPerformance< TpsRender >();
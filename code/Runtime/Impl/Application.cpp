@@ -950,6 +950,8 @@ bool Application::update()
 					script::ScriptStatistics ss;
 					m_scriptServer->getScriptManager()->getStatistics(ss);
 					tp.memInUseScript = ss.memoryUsage;
+					tp.scriptAllocationRate = ss.allocationRate;
+					tp.scriptCollectWorst = ss.collectTimeWorst;
 				}
 				m_targetPerformance.publish(m_targetManagerConnection->getTransport(), tp);
 			}
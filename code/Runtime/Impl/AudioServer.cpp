@@ -52,6 +52,9 @@ bool AudioServer::create(const PropertyGroup* settings, const SystemApplication&
 	sound::AudioSystemCreateDesc ascd;
 	ascd.sysapp = sysapp;
 	ascd.channels = settings->getProperty< int32_t >(L"Audio.Channels", 16);
+	ascd.activeChannels = settings->getProperty< int32_t >(L"Audio.ActiveChannels", 0);
+	ascd.mixerThreads = settings->getProperty< int32_t >(L"Audio.MixerThreads", 1);
+	ascd.streamLatency = settings->getProperty< int32_t >(L"Audio.StreamLatency", 250);
 	ascd.driverDesc.sampleRate = settings->getProperty< int32_t >(L"Audio.SampleRate", 44100);
 	ascd.driverDesc.bitsPerSample = settings->getProperty< int32_t >(L"Audio.BitsPerSample", 16);
 	ascd.driverDesc.hwChannels = settings->getProperty< int32_t >(L"Audio.HwChannels", 2);
@@ -8,6 +8,7 @@
  */
 #include "Core/Log/Log.h"
 #include "Core/Misc/ObjectStore.h"
+#include "Runtime/IAudioServer.h"
 #include "Runtime/IEnvironment.h"
 #include "Runtime/Impl/ResourceServer.h"
 #include "Core/Misc/SafeDestroy.h"
@@ -16,6 +17,7 @@
 #include "Render/IRenderSystem.h"
 #include "Resource/IResourceFactory.h"
 #include "Resource/ResourceManager.h"
+#include "Sound/AudioSystem.h"
 #include "World/IEntityFactory.h"
 
 namespace traktor::runtime
@@ -40,6 +42,8 @@ void ResourceServer::createResourceFactories(IEnvironment* environment)
 	ObjectStore objectStore;
 	objectStore.set(environment->getRender()->getRenderSystem());
 	objectStore.set(environment->getWorld()->getEntityFactory());
+	if (environment->getAudio() && environment->getAudio()->getAudioSystem())
+		objectStore.set(environment->getAudio()->getAudioSystem());
 
 	// Create instances of all resource factories.
 	const TypeInfoSet resourceFactoryTypes = type_of< resource::IResourceFactory >().findAllOf(false);
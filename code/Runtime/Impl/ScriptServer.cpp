@@ -13,6 +13,7 @@
 #include "Core/Log/Log.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Settings/PropertyGroup.h"
+#include "Core/Settings/PropertyInteger.h"
 #include "Core/Settings/PropertyString.h"
 #include "Core/Thread/Acquire.h"
 #include "Core/Thread/ThreadManager.h"
@@ -69,6 +70,9 @@ bool ScriptServer::create(
 	}
 	registrar.registerClassesInOrder(m_scriptManager);
 
+	// Garbage collection budget, in microseconds, per frame.
+	m_scriptManager->setCollectBudget(settings->getProperty< int32_t >(L"Script.CollectBudget", 1000));
+
 	// Complete registration of all classes (register members, methods, properties, etc.)
 	// This is needed for script backends that require two-phase registration (e.g., AngelScript).
 	m_scriptManager->completeRegistration();
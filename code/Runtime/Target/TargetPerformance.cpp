@@ -107,7 +107,7 @@ void TpsRuntime::serialize(ISerializer& s)
 	s >> Member< uint32_t >(L"collisions", collisions);
 }
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.runtime.TpsMemory", 0, TpsMemory, TargetPerfSet)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.runtime.TpsMemory", 1, TpsMemory, TargetPerfSet)
 
 bool TpsMemory::check(const TargetPerfSet& old) const
 {
@@ -119,6 +119,11 @@ void TpsMemory::serialize(ISerializer& s)
 	s >> Member< uint64_t >(L"memInUse", memInUse);
 	s >> Member< uint32_t >(L"memInUseScript", memInUseScript);
 	s >> Member< uint32_t >(L"heapObjects", heapObjects);
+	if (s.getVersion< TpsMemory >() >= 1)
+	{
+		s >> Member< float >(L"scriptAllocationRate", scriptAllocationRate);
+		s >> Member< float >(L"scriptCollectWorst", scriptCollectWorst);
+	}
 }
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.runtime.TpsRender", 0, TpsRender, TargetPerfSet)
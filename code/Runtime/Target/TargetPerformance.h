@@ -69,6 +69,8 @@ public:
 	uint64_t memInUse = 0;
 	uint32_t memInUseScript = 0;
 	uint32_t heapObjects = 0;
+	float scriptAllocationRate = 0.0f;	//!< Bytes allocated by scripts per second.
+	float scriptCollectWorst = 0.0f;	//!< Worst script garbage collection pause, in seconds.
 
 	virtual bool check(const TargetPerfSet& old) const override final;
 
@@ -43,6 +43,12 @@ class IScriptProfiler;
 struct ScriptStatistics
 {
 	uint32_t memoryUsage;
+	uint32_t allocations;		//!< Number of allocations made by script environment.
+	float allocationRate;		//!< Bytes allocated per second.
+	float collectTime;			//!< Time, in seconds, spent collecting garbage last frame.
+	float collectTimeWorst;		//!< Worst time, in seconds, spent collecting garbage in a single frame during last second.
+	uint32_t collectSteps;		//!< Number of incremental collection steps last frame.
+	uint32_t collectCycles;		//!< Number of completed collection cycles.
 };
 
 /*! Script manager.
@@ -108,6 +114,16 @@ public:
 	 */
 	virtual void collectGarbage(bool full) = 0;
 
+	/*! Set garbage collection budget.
+	 *
+	 * Partial garbage collection is paced to stay within budget
+	 * each frame, unless allocation rate is too high for collector
+	 * to keep up.
+	 *
+	 * \param budget Budget, in microseconds, per frame.
+	 */
+	virtual void setCollectBudget(int32_t budget) = 0;
+
 	/*! */
 	virtual void getStatistics(ScriptStatistics& outStatistics) const = 0;
 };
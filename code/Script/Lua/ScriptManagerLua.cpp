@@ -6,17 +6,26 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cmath>
 #include <cstring>
+#include <new>
 #include "Core/Class/AutoVerify.h"
+#include "Core/Class/Boxes/BoxedColor4f.h"
+#include "Core/Class/Boxes/BoxedQuaternion.h"
+#include "Core/Class/Boxes/BoxedTransform.h"
 #include "Core/Class/Boxes/BoxedTypeInfo.h"
+#include "Core/Class/Boxes/BoxedVector4.h"
+#include "Core/Class/FastCall.h"
 #include "Core/Class/IRuntimeClass.h"
 #include "Core/Class/IRuntimeDispatch.h"
+#include "Core/Math/Float.h"
 #include "Core/Math/MathUtils.h"
 #include "Core/Misc/Save.h"
 #include "Core/Misc/Split.h"
 #include "Core/Misc/TString.h"
 #include "Core/Serialization/ISerializable.h"
 #include "Core/Thread/Acquire.h"
+#include "Core/Timer/Profiler.h"
 #include "Core/Timer/Timer.h"
 #include "Script/Lua/ScriptClassLua.h"
 #include "Script/Lua/ScriptContextLua.h"
@@ -32,7 +41,6 @@
 
 #define T_USE_ALLOCATOR 1
 #define T_LOG_OBJECT_GC 0
-#define T_SCRIPT_LUA_USE_GENERATIONAL_COLLECTOR
 
 namespace traktor::script
 {
@@ -41,6 +49,11 @@ namespace traktor::script
 
 Timer s_timer;
 
+const int32_t c_collectStepSize = 16;				//!< Amount of work, in KiB, credited to each incremental collection step.
+const double c_collectEmergencyDebt = 4096.0;		//!< Minimum debt, in KiB, before collection budget may be exceeded.
+const uint32_t c_collectIdleSteps = 4;				//!< Maximum steps, each frame, spent progressing an unfinished cycle after debt has been paid.
+const double c_collectStatsWindow = 1.0;			//!< Duration, in seconds, of window over which worst collection time is measured.
+
 const int32_t c_tableKey_class = -1;
 const int32_t c_tableKey_instance = -2;
 
@@ -93,6 +106,80 @@ inline bool isNativeInstance(lua_State* luaState, int32_t index)
 	return false;
 }
 
+// Inline value types are full userdata where the boxed object is constructed
+// in place, directly after the object pointer; thus toTypedObject() works for
+// both representations. Inline boxes are never destroyed nor released, they
+// only contain plain math data and the memory is owned by Lua.
+const uintptr_t c_inlineAlignment = 16;
+
+template < typename BoxedType >
+constexpr size_t inlineSize()
+{
+	return sizeof(ITypedObject*) + c_inlineAlignment - 1 + sizeof(BoxedType);
+}
+
+template < typename BoxedType, typename ... ArgumentTypes >
+inline BoxedType* newInline(lua_State* L, int32_t metaTableRef, ArgumentTypes ... arguments)
+{
+	void* ud = lua_newuserdatauv(L, inlineSize< BoxedType >(), 0);
+	void* storage = (void*)(((uintptr_t)ud + sizeof(ITypedObject*) + c_inlineAlignment - 1) & ~(c_inlineAlignment - 1));
+
+	// Keep a reference so temporary references from dispatches never free inline box.
+	BoxedType* boxed = ::new (storage) BoxedType(arguments ...);
+	T_SAFE_ANONYMOUS_ADDREF(boxed);
+	*(ITypedObject**)ud = boxed;
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, metaTableRef);
+	lua_setmetatable(L, -2);
+	return boxed;
+}
+
+template < typename BoxedType >
+inline BoxedType* toInline(lua_State* L, int32_t index)
+{
+	return static_cast< BoxedType* >(*(ITypedObject**)lua_touserdata(L, index));
+}
+
+// Scratch box used when passing inline values to native code; reference
+// count is exposed so box can be reused once native side has released it.
+template < typename BoxedType >
+class ScratchBox : public BoxedType
+{
+public:
+	explicit ScratchBox(const BoxedType& value) : BoxedType(value) {}
+
+	bool unique() const { return this->m_refCount == 1; }
+};
+
+const uint32_t c_maxScratchBoxes = 16;
+
+template < typename BoxedType >
+inline ITypedObject* scratchBox(RefArray< ITypedObject >& boxes, const ITypedObject* object)
+{
+	static_assert(sizeof(ScratchBox< BoxedType >) == sizeof(BoxedType), "Scratch box must be allocated by boxed allocator");
+	const BoxedType& value = *static_cast< const BoxedType* >(object);
+
+	// Reuse a box only referenced by us.
+	for (ITypedObject* box : boxes)
+	{
+		ScratchBox< BoxedType >* scratch = static_cast< ScratchBox< BoxedType >* >(box);
+		if (scratch->unique())
+		{
+			*static_cast< BoxedType* >(scratch) = value;
+			return scratch;
+		}
+	}
+
+	// All boxes are in use; either by pending calls or retained by native side. Let
+	// retained boxes go if there are too many since they might never be released.
+	if (boxes.size() >= c_maxScratchBoxes)
+		boxes.clear();
+
+	Ref< ScratchBox< BoxedType > > scratch = new ScratchBox< BoxedType >(value);
+	boxes.push_back(scratch);
+	return scratch;
+}
+
 inline void getObjectRef(lua_State* L, int32_t objectTableRef, ITypedObject* object)
 {
 	CHECK_LUA_STACK(L, 1);
@@ -116,21 +203,34 @@ inline void putObjectRef(lua_State* L, int32_t objectTableRef, ITypedObject* obj
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.script.ScriptManagerLua", 0, ScriptManagerLua, IScriptManager)
 
-ScriptManagerLua* ScriptManagerLua::ms_instance = nullptr;
-
 ScriptManagerLua::ScriptManagerLua()
 :	m_luaState(nullptr)
 ,	m_defaultAllocFn(nullptr)
 ,	m_defaultAllocOpaque(nullptr)
 ,	m_lockContext(nullptr)
-,	m_collectStepFrequency(10.0)
-,	m_collectSteps(-1)
-,	m_collectTargetSteps(0.0f)
+,	m_collectBudget(1000)
+,	m_collectControlled(false)
+,	m_collectCycleActive(false)
+,	m_collectDebt(0.0)
+,	m_collectStepCost(0.0)
+,	m_collectTime(0.0)
+,	m_collectTimeWorst(0.0)
+,	m_collectTimeWindowWorst(0.0)
+,	m_collectWindowStart(0.0)
+,	m_collectSteps(0)
+,	m_collectCycles(0)
 ,	m_totalMemoryUse(0)
 ,	m_lastMemoryUse(0)
+,	m_allocationCount(0)
+,	m_allocatedMemory(0)
+,	m_lastAllocatedMemory(0)
+,	m_allocationRate(0.0)
 {
-	T_FATAL_ASSERT(ms_instance == nullptr);
-	ms_instance = this;
+	for (int32_t i = 0; i < (int32_t)InlineType::Count; ++i)
+	{
+		m_inlineMetaTableRefs[i] = LUA_NOREF;
+		m_inlineMetaTables[i] = nullptr;
+	}
 
 #if defined(T_USE_ALLOCATOR)
 	m_luaState = lua_newstate(&luaAlloc, this, 0);
@@ -190,8 +290,6 @@ ScriptManagerLua::ScriptManagerLua()
 ScriptManagerLua::~ScriptManagerLua()
 {
 	T_FATAL_ASSERT_M(!m_luaState, L"Must call destroy");
-	T_FATAL_ASSERT(ms_instance == this);
-	ms_instance = nullptr;
 }
 
 void ScriptManagerLua::destroy()
@@ -235,6 +333,19 @@ void ScriptManagerLua::registerClass(IRuntimeClass* runtimeClass)
 	RegisteredClass& rc = m_classRegistry.push_back();
 	rc.runtimeClass = runtimeClass;
 	rc.isValueType = runtimeClass->isValueType();
+	rc.inlineType = InlineType::None;
+
+	if (rc.isValueType)
+	{
+		if (&exportType == &type_of< BoxedVector4 >())
+			rc.inlineType = InlineType::Vector4;
+		else if (&exportType == &type_of< BoxedQuaternion >())
+			rc.inlineType = InlineType::Quaternion;
+		else if (&exportType == &type_of< BoxedColor4f >())
+			rc.inlineType = InlineType::Color4f;
+		else if (&exportType == &type_of< BoxedTransform >())
+			rc.inlineType = InlineType::Transform;
+	}
 
 	// Create new class.
 	lua_getglobal(m_luaState, "class");
@@ -294,9 +405,16 @@ void ScriptManagerLua::registerClass(IRuntimeClass* runtimeClass)
 	for (uint32_t i = 0; i < staticMethodCount; ++i)
 	{
 		const std::string methodName = runtimeClass->getStaticMethodName(i);
-		lua_pushlightuserdata(m_luaState, (void*)runtimeClass->getStaticMethodDispatch(i));
+		const IRuntimeDispatch* dispatch = runtimeClass->getStaticMethodDispatch(i);
+		lua_pushlightuserdata(m_luaState, (void*)dispatch);
 		lua_pushlightuserdata(m_luaState, (void*)runtimeClass);
-		lua_pushcclosure(m_luaState, classCallStaticMethod, 2);
+		if (dispatch->getFastCall() != nullptr)
+		{
+			lua_pushlightuserdata(m_luaState, (void*)dispatch->getFastCall());
+			lua_pushcclosure(m_luaState, classFastCallStaticMethod, 3);
+		}
+		else
+			lua_pushcclosure(m_luaState, classCallStaticMethod, 2);
 		lua_setfield(m_luaState, -2, methodName.c_str());
 	}
 
@@ -305,9 +423,17 @@ void ScriptManagerLua::registerClass(IRuntimeClass* runtimeClass)
 	for (uint32_t i = 0; i < methodCount; ++i)
 	{
 		const std::string methodName = runtimeClass->getMethodName(i);
-		lua_pushlightuserdata(m_luaState, (void*)runtimeClass->getMethodDispatch(i));
+		const IRuntimeDispatch* dispatch = runtimeClass->getMethodDispatch(i);
+		lua_pushlightuserdata(m_luaState, (void*)dispatch);
 		lua_pushlightuserdata(m_luaState, (void*)runtimeClass);
-		lua_pushcclosure(m_luaState, classCallMethod, 2);
+		if (dispatch->getFastCall() != nullptr)
+		{
+			// Typed trampoline reading arguments directly from stack.
+			lua_pushlightuserdata(m_luaState, (void*)dispatch->getFastCall());
+			lua_pushcclosure(m_luaState, classFastCallMethod, 3);
+		}
+		else
+			lua_pushcclosure(m_luaState, classCallMethod, 2);
 		lua_setfield(m_luaState, -2, methodName.c_str());
 	}
 
@@ -410,6 +536,11 @@ void ScriptManagerLua::registerClass(IRuntimeClass* runtimeClass)
 		DO_1(m_luaState, lua_setfield(m_luaState, -2, "__index")						);
 	}
 
+	// Inline value types use a separate metatable, without "__gc", which
+	// have fast paths for field access and arithmetic.
+	if (rc.inlineType != InlineType::None)
+		createInlineMetaTable(rc);
+
 	// Export class in global scope.
 	std::wstring exportName = exportType.getName();
 	std::vector< std::wstring > exportPath;
@@ -526,14 +657,38 @@ Ref< IScriptProfiler > ScriptManagerLua::createProfiler()
 void ScriptManagerLua::collectGarbage(bool full)
 {
 	if (!full)
-		collectGarbagePartial();
+	{
+		collectGarbagePartial(s_timer.getDeltaTime());
+
+		// Report worst collection time of last completed window
+		// thus a single spike does not stick forever.
+		const double time = s_timer.getElapsedTime();
+		m_collectTimeWindowWorst = std::max(m_collectTimeWindowWorst, m_collectTime);
+		if (time - m_collectWindowStart >= c_collectStatsWindow)
+		{
+			m_collectTimeWorst = m_collectTimeWindowWorst;
+			m_collectTimeWindowWorst = 0.0;
+			m_collectWindowStart = time;
+		}
+	}
 	else
 		collectGarbageFull();
 }
 
+void ScriptManagerLua::setCollectBudget(int32_t budget)
+{
+	m_collectBudget = budget;
+}
+
 void ScriptManagerLua::getStatistics(ScriptStatistics& outStatistics) const
 {
 	outStatistics.memoryUsage = uint32_t(m_totalMemoryUse);
+	outStatistics.allocations = uint32_t(m_allocationCount);
+	outStatistics.allocationRate = float(m_allocationRate);
+	outStatistics.collectTime = float(m_collectTime);
+	outStatistics.collectTimeWorst = float(m_collectTimeWorst);
+	outStatistics.collectSteps = m_collectSteps;
+	outStatistics.collectCycles = m_collectCycles;
 }
 
 void ScriptManagerLua::pushObject(ITypedObject* object)
@@ -578,6 +733,13 @@ void ScriptManagerLua::pushObject(ITypedObject* object)
 	// and the table allocation entirely.
 	if (rc.isValueType)
 	{
+		// Copy value into userdata payload if inline type.
+		if (rc.inlineType != InlineType::None)
+		{
+			pushInline(rc.inlineType, object);
+			return;
+		}
+
 		ITypedObject** ud = (ITypedObject**)lua_newuserdatauv(m_luaState, sizeof(ITypedObject*), 0);
 		*ud = object;
 		lua_rawgeti(m_luaState, LUA_REGISTRYINDEX, rc.classTableRef);
@@ -714,7 +876,7 @@ Any ScriptManagerLua::toAny(int32_t index)
 					void* ud = lua_touserdata(m_luaState, aindex);
 					ITypedObject* object = ud ? *(ITypedObject**)ud : nullptr;
 					if (object)
-						return Any::fromObject(object);
+						return Any::fromObject(boxInline(getInlineType(m_luaState, aindex), object));
 				}
 			}
 			break;
@@ -800,7 +962,7 @@ void ScriptManagerLua::toAny(int32_t base, int32_t count, Any* outAnys)
 						ITypedObject* object = ud ? *(ITypedObject**)ud : nullptr;
 						if (object)
 						{
-							outAnys[i] = Any::fromObject(object);
+							outAnys[i] = Any::fromObject(boxInline(getInlineType(m_luaState, aindex), object));
 							continue;
 						}
 					}
@@ -887,98 +1049,314 @@ void ScriptManagerLua::collectGarbageFullNoLock()
 	}
 
 	m_lastMemoryUse = m_totalMemoryUse;
+
+	// Full collection has paid all debt and finished any cycle in progress.
+	m_collectDebt = 0.0;
+	m_collectCycleActive = false;
 }
 
-void ScriptManagerLua::collectGarbagePartial()
+void ScriptManagerLua::collectGarbagePartial(double deltaTime)
 {
-#if defined(T_SCRIPT_LUA_USE_GENERATIONAL_COLLECTOR)
-#	if defined(T_SCRIPT_LUA_USE_MT_LOCK)
+	T_PROFILER_SCOPE(L"Script GC");
+#if defined(T_SCRIPT_LUA_USE_MT_LOCK)
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-#	endif
+#endif
 
-	if (m_collectSteps < 0)
+	if (!m_luaState)
+		return;
+
+	// Collector is only stepped explicitly, in incremental mode, so
+	// no collection work is performed while scripts are executing.
+	if (!m_collectControlled)
 	{
 		lua_gc(m_luaState, LUA_GCSTOP, 0);
-		lua_gc(m_luaState, LUA_GCGEN, 0);
-		m_collectSteps = 0;
-	}
+		lua_gc(m_luaState, LUA_GCINC, 0, 0, 0);
+
+		// A basic step traverses a few times step size, with default
+		// step multiplier, thus a quarter of step size is enough for each
+		// step to perform at least as much work as we credit it.
+		lua_gc(m_luaState, LUA_GCPARAM, LUA_GCPSTEPSIZE, c_collectStepSize * 1024 / 4);
+		m_collectControlled = true;
+	}
+
+	// Measure allocation rate since last frame.
+	const size_t allocated = m_allocatedMemory - m_lastAllocatedMemory;
+	m_lastAllocatedMemory = m_allocatedMemory;
+	if (deltaTime > 0.0)
+		m_allocationRate = lerp(m_allocationRate, double(allocated) / deltaTime, 0.1);
+
+	// Collector must process at least as much as has been allocated.
+	m_collectDebt += double(allocated) / 1024.0;
+
+	// Allow budget to be exceeded only when debt has grown larger than
+	// live heap, i.e. budget is too small to keep up with allocation rate.
+	double budget = m_collectBudget / 1000000.0;
+	if (m_collectDebt > std::max(double(m_lastMemoryUse) / 1024.0, c_collectEmergencyDebt))
+		budget *= 4.0;
+
+	// Pay debt in small steps while within budget; work each frame is
+	// bounded by debt and only a few steps more are spent progressing
+	// an unfinished cycle, thus cycles are spread over frames.
+	uint32_t maxSteps = uint32_t(std::ceil(m_collectDebt / c_collectStepSize));
+	if (m_collectCycleActive)
+		maxSteps += c_collectIdleSteps;
+
+	const double start = s_timer.getElapsedTime();
+	double elapsed = 0.0;
+	uint32_t steps = 0;
+
+	while (steps < maxSteps && (m_collectDebt > 0.0 || m_collectCycleActive))
+	{
+		// Stop if next step is predicted to exceed budget; always
+		// make some progress each frame.
+		if (steps > 0 && elapsed + m_collectStepCost > budget)
+			break;
 
-	T_ASSERT(lua_gc(m_luaState, LUA_GCISRUNNING, 0) == 0);
+		const double stepStart = s_timer.getElapsedTime();
+		const bool cycleFinished = (lua_gc(m_luaState, LUA_GCSTEP, 0) != 0);
+		const double stepEnd = s_timer.getElapsedTime();
 
-	m_collectTargetSteps += float(s_timer.getDeltaTime() * m_collectStepFrequency);
+		m_collectStepCost = lerp(m_collectStepCost, stepEnd - stepStart, 0.1);
+		m_collectDebt = std::max(m_collectDebt - c_collectStepSize, 0.0);
+		elapsed = stepEnd - start;
+		++steps;
 
-	int32_t targetSteps = int32_t(m_collectTargetSteps);
-	while (m_collectSteps < targetSteps)
-	{
-		lua_gc(m_luaState, LUA_GCSTEP, 0);
-		++m_collectSteps;
+		if (cycleFinished)
+		{
+			m_lastMemoryUse = m_totalMemoryUse;
+			m_collectCycleActive = false;
+			++m_collectCycles;
+		}
+		else
+			m_collectCycleActive = true;
 	}
 
-#else
+	m_collectTime = elapsed;
+	m_collectSteps = steps;
+}
 
-	const float dT = std::min< float >((float)s_timer.getDeltaTime(), 0.1f);
-	m_collectTargetSteps += dT * m_collectStepFrequency;
+void ScriptManagerLua::breakDebugger(lua_State* luaState)
+{
+	if (!m_debugger)
+		return;
 
-	const int32_t targetSteps = int32_t(m_collectTargetSteps);
-	if (m_collectSteps < targetSteps)
-	{
-#if defined(T_SCRIPT_LUA_USE_MT_LOCK)
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-#endif
-		if (m_collectSteps < 0)
-		{
-			lua_gc(m_luaState, LUA_GCSTOP, 0);
-			m_collectSteps = 0;
-		}
+	lua_Debug ar = { 0 };
+	lua_getstack(luaState, 1, &ar);
+	lua_getinfo(luaState, "Snlu", &ar);
+
+	m_debugger->actionBreak();
+	m_debugger->analyzeState(luaState, &ar);
+}
+
+void ScriptManagerLua::createInlineMetaTable(const RegisteredClass& rc)
+{
+	CHECK_LUA_STACK(m_luaState, 0);
 
-		T_ASSERT(lua_gc(m_luaState, LUA_GCISRUNNING, 0) == 0);
+	const int32_t inlineType = (int32_t)rc.inlineType;
+	const IRuntimeClass* runtimeClass = rc.runtimeClass;
 
-		// Progress with garbage collector.
-		while (m_collectSteps < targetSteps)
+	// Copy class marker and metamethods, except "__gc", from class table;
+	// inline instances are plain memory owned by Lua thus doesn't need to
+	// be finalized. Methods and properties are looked up through the class
+	// table by "__index".
+	lua_newtable(m_luaState);
+	lua_rawgeti(m_luaState, LUA_REGISTRYINDEX, rc.classTableRef);
+	lua_pushnil(m_luaState);
+	while (lua_next(m_luaState, -2))
+	{
+		const char* key = (lua_type(m_luaState, -2) == LUA_TSTRING) ? lua_tostring(m_luaState, -2) : nullptr;
+		if (key && (std::strncmp(key, "__", 2) != 0 || std::strcmp(key, "__gc") == 0))
 		{
-			lua_gc(m_luaState, LUA_GCSTEP, 128);
-			++m_collectSteps;
+			lua_pop(m_luaState, 1);
+			continue;
 		}
-		m_collectSteps = targetSteps;
+		lua_pushvalue(m_luaState, -2);
+		lua_insert(m_luaState, -2);
+		lua_rawset(m_luaState, -5);
 	}
 
-	if (m_lastMemoryUse <= 0)
-		m_lastMemoryUse = m_totalMemoryUse;
+	// Field access, fallback to class's getters and setters.
+	lua_getfield(m_luaState, -1, "__getters");
+	lua_pushvalue(m_luaState, -2);
+	lua_pushinteger(m_luaState, inlineType);
+	lua_pushcclosure(m_luaState, inlineIndex, 3);
+	lua_setfield(m_luaState, -3, "__index");
+
+	lua_getfield(m_luaState, -1, "__setters");
+	lua_pushvalue(m_luaState, -2);
+	lua_pushinteger(m_luaState, inlineType);
+	lua_pushcclosure(m_luaState, inlineNewIndex, 3);
+	lua_setfield(m_luaState, -3, "__newindex");
 
-	if (m_totalMemoryUse > m_lastMemoryUse)
+	lua_pop(m_luaState, 1);
+
+	// Compare values instead of identity.
+	lua_pushinteger(m_luaState, inlineType);
+	lua_pushcclosure(m_luaState, inlineEqual, 1);
+	lua_setfield(m_luaState, -2, "__eq");
+
+	// Arithmetic, fallback to class's operator dispatch.
+	const struct { IRuntimeClass::Operator op; const char* name; } operators[] =
 	{
-		// Calculate amount of garbage produced per second.
-		const float garbageProduced = (m_totalMemoryUse - m_lastMemoryUse) / dT;
+		{ IRuntimeClass::Operator::Add, "__add" },
+		{ IRuntimeClass::Operator::Subtract, "__sub" },
+		{ IRuntimeClass::Operator::Multiply, "__mul" },
+		{ IRuntimeClass::Operator::Divide, "__div" }
+	};
+	for (const auto& op : operators)
+	{
+		lua_pushlightuserdata(m_luaState, (void*)runtimeClass);
+		lua_pushlightuserdata(m_luaState, (void*)runtimeClass->getOperatorDispatch(op.op));
+		lua_pushinteger(m_luaState, (int32_t)op.op);
+		lua_pushcclosure(m_luaState, inlineArithmetic, 3);
+		lua_setfield(m_luaState, -2, op.name);
+	}
 
-		// Determine collector frequency from amount of garbage per second.
-		m_collectStepFrequency = std::max< float >(
-			clamp(garbageProduced / (64*1024), 1.0f, 60.0f),
-			m_collectStepFrequency
-		);
+	if (rc.inlineType == InlineType::Vector4)
+	{
+		lua_pushinteger(m_luaState, inlineType);
+		lua_pushcclosure(m_luaState, inlineNegate, 1);
+		lua_setfield(m_luaState, -2, "__unm");
 	}
-	else if (m_totalMemoryUse < m_lastMemoryUse)
+
+	m_inlineMetaTables[inlineType] = lua_topointer(m_luaState, -1);
+	m_inlineMetaTableRefs[inlineType] = luaL_ref(m_luaState, LUA_REGISTRYINDEX);
+}
+
+void ScriptManagerLua::pushInline(InlineType inlineType, const ITypedObject* object)
+{
+	const int32_t metaTableRef = m_inlineMetaTableRefs[(int32_t)inlineType];
+	switch (inlineType)
 	{
-		// Using less memory after this collection; slowly decrease
-		// frequency until memory start to rise again.
-		m_collectStepFrequency = std::max< float >(1.0f, m_collectStepFrequency - m_collectStepFrequency / 10.0f);
+	case InlineType::Vector4:
+		newInline< BoxedVector4 >(m_luaState, metaTableRef, static_cast< const BoxedVector4* >(object)->unbox());
+		break;
+	case InlineType::Quaternion:
+		newInline< BoxedQuaternion >(m_luaState, metaTableRef, static_cast< const BoxedQuaternion* >(object)->unbox());
+		break;
+	case InlineType::Color4f:
+		newInline< BoxedColor4f >(m_luaState, metaTableRef, static_cast< const BoxedColor4f* >(object)->unbox());
+		break;
+	case InlineType::Transform:
+		newInline< BoxedTransform >(m_luaState, metaTableRef, static_cast< const BoxedTransform* >(object)->unbox());
+		break;
+	default:
+		lua_pushnil(m_luaState);
+		break;
 	}
+}
 
-	m_lastMemoryUse = m_totalMemoryUse;
+ScriptManagerLua::InlineType ScriptManagerLua::getInlineType(lua_State* luaState, int32_t index) const
+{
+	if (lua_type(luaState, index) != LUA_TUSERDATA)
+		return InlineType::None;
 
-#endif
+	if (!lua_getmetatable(luaState, index))
+		return InlineType::None;
+
+	const void* metaTable = lua_topointer(luaState, -1);
+	lua_pop(luaState, 1);
+
+	for (int32_t i = 1; i < (int32_t)InlineType::Count; ++i)
+	{
+		if (m_inlineMetaTables[i] == metaTable)
+			return (InlineType)i;
+	}
+	return InlineType::None;
 }
 
-void ScriptManagerLua::breakDebugger(lua_State* luaState)
+ITypedObject* ScriptManagerLua::boxInline(InlineType inlineType, ITypedObject* object)
 {
-	if (!m_debugger)
-		return;
+	// Inline boxes are owned by Lua; native side might keep a reference
+	// beyond lifetime of userdata so need to copy into a box owned by
+	// native side. Boxes are recycled once native side has released them.
+	RefArray< ITypedObject >& boxes = m_scratchBoxes[(int32_t)inlineType];
+	switch (inlineType)
+	{
+	case InlineType::Vector4:
+		return scratchBox< BoxedVector4 >(boxes, object);
+	case InlineType::Quaternion:
+		return scratchBox< BoxedQuaternion >(boxes, object);
+	case InlineType::Color4f:
+		return scratchBox< BoxedColor4f >(boxes, object);
+	case InlineType::Transform:
+		return scratchBox< BoxedTransform >(boxes, object);
+	default:
+		return object;
+	}
+}
 
-	lua_Debug ar = { 0 };
-	lua_getstack(luaState, 1, &ar);
-	lua_getinfo(luaState, "Snlu", &ar);
+bool ScriptManagerLua::toFastCallArguments(lua_State* luaState, int32_t base, const FastCall* fastCall, FastCallValue* outArgv) const
+{
+	// Argument count must match exactly; let regular dispatch handle,
+	// and report, other argument counts.
+	if (lua_gettop(luaState) - base + 1 != (int32_t)fastCall->argc)
+		return false;
 
-	m_debugger->actionBreak();
-	m_debugger->analyzeState(luaState, &ar);
+	for (uint32_t i = 0; i < fastCall->argc; ++i)
+	{
+		const int32_t index = base + (int32_t)i;
+		const int32_t type = lua_type(luaState, index);
+		switch (fastCall->argumentTypes[i])
+		{
+		case FastCallType::Boolean:
+			if (type != LUA_TBOOLEAN)
+				return false;
+			outArgv[i].b = (bool)(lua_toboolean(luaState, index) != 0);
+			break;
+
+		case FastCallType::Integer:
+			{
+				// Only numbers with an exact integer representation; others are
+				// converted, same as before, by regular dispatch.
+				if (type != LUA_TNUMBER)
+					return false;
+				int isnum = 0;
+				outArgv[i].i = (int64_t)lua_tointegerx(luaState, index, &isnum);
+				if (!isnum)
+					return false;
+			}
+			break;
+
+		case FastCallType::Number:
+			if (type != LUA_TNUMBER)
+				return false;
+			outArgv[i].n = (double)lua_tonumber(luaState, index);
+			break;
+
+		case FastCallType::Object:
+		case FastCallType::Reference:
+			if (type == LUA_TNIL)
+			{
+				outArgv[i].o = nullptr;
+				break;
+			}
+			else
+			{
+				// Only native instances; script objects need to be wrapped.
+				ITypedObject* object = toTypedObject(luaState, index);
+				if (!object || !is_type_of(*fastCall->objectTypes[i], type_of(object)))
+					return false;
+
+				// Inline values cannot be retained by callee.
+				if (fastCall->argumentTypes[i] == FastCallType::Reference && getInlineType(luaState, index) != InlineType::None)
+					return false;
+
+				outArgv[i].o = object;
+			}
+			break;
+		}
+	}
+
+	return true;
+}
+
+ScriptManagerLua* ScriptManagerLua::fromState(lua_State* luaState)
+{
+	// Each virtual machine install itself as allocator opaque.
+	void* opaque = nullptr;
+	lua_getallocf(luaState, &opaque);
+	return reinterpret_cast< ScriptManagerLua* >(opaque);
 }
 
 int ScriptManagerLua::classGc(lua_State* luaState)
@@ -1003,8 +1381,9 @@ int ScriptManagerLua::classGc(lua_State* luaState)
 
 int ScriptManagerLua::classNew(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const int32_t classId = (int32_t)lua_tointeger(luaState, lua_upvalueindex(2));
-	const RegisteredClass& rc =	ms_instance->m_classRegistry[classId];
+	const RegisteredClass& rc =	manager->m_classRegistry[classId];
 
 	const IRuntimeDispatch* runtimeDispatch = reinterpret_cast< const IRuntimeDispatch* >(lua_touserdata(luaState, lua_upvalueindex(1)));
 	T_ASSERT(runtimeDispatch);
@@ -1012,7 +1391,7 @@ int ScriptManagerLua::classNew(lua_State* luaState)
 	const int32_t top = lua_gettop(luaState);
 
 	Any argv[8];
-	ms_instance->toAny(2, top - 1, argv);
+	manager->toAny(2, top - 1, argv);
 
 	// Discard all arguments, only instance table in stack.
 	lua_settop(luaState, 1);
@@ -1040,14 +1419,14 @@ int ScriptManagerLua::classNew(lua_State* luaState)
 #endif
 
 		// Store object instance in weak table.
-		putObjectRef(luaState, ms_instance->m_objectTableRef, object);
+		putObjectRef(luaState, manager->m_objectTableRef, object);
 		return 1;
 	}
 #if T_VERIFY_USING_EXCEPTIONS
 	catch(const RuntimeException& x)
 	{
 		log::error << L"Unhandled RuntimeException occurred when calling constructor, class " << rc.runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
-		ms_instance->breakDebugger(luaState);
+		manager->breakDebugger(luaState);
 	}
 #endif
 
@@ -1056,8 +1435,9 @@ int ScriptManagerLua::classNew(lua_State* luaState)
 
 int ScriptManagerLua::classNewValue(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const int32_t classId = (int32_t)lua_tointeger(luaState, lua_upvalueindex(2));
-	const RegisteredClass& rc = ms_instance->m_classRegistry[classId];
+	const RegisteredClass& rc = manager->m_classRegistry[classId];
 
 	const IRuntimeDispatch* runtimeDispatch = reinterpret_cast< const IRuntimeDispatch* >(lua_touserdata(luaState, lua_upvalueindex(1)));
 	T_ASSERT(runtimeDispatch);
@@ -1066,8 +1446,60 @@ int ScriptManagerLua::classNewValue(lua_State* luaState)
 	// constructor arguments follow.
 	const int32_t top = lua_gettop(luaState);
 
+	// Construct inline value types directly from numbers, same
+	// constructors as registered in boxed class factory.
+	if (rc.inlineType != InlineType::None)
+	{
+		bool numbers = true;
+		for (int32_t i = 2; i <= top && numbers; ++i)
+			numbers = (lua_type(luaState, i) == LUA_TNUMBER);
+
+		if (numbers)
+		{
+			const int32_t metaTableRef = manager->m_inlineMetaTableRefs[(int32_t)rc.inlineType];
+			const int32_t argc = top - 1;
+			float f[4] = { 0.0f };
+			for (int32_t i = 0; i < argc && i < 4; ++i)
+				f[i] = (float)lua_tonumber(luaState, 2 + i);
+
+			switch (rc.inlineType)
+			{
+			case InlineType::Vector4:
+				if (argc == 0)
+					{ newInline< BoxedVector4 >(luaState, metaTableRef); return 1; }
+				else if (argc == 3)
+					{ newInline< BoxedVector4 >(luaState, metaTableRef, f[0], f[1], f[2]); return 1; }
+				else if (argc == 4)
+					{ newInline< BoxedVector4 >(luaState, metaTableRef, f[0], f[1], f[2], f[3]); return 1; }
+				break;
+			case InlineType::Quaternion:
+				if (argc == 0)
+					{ newInline< BoxedQuaternion >(luaState, metaTableRef); return 1; }
+				else if (argc == 3)
+					{ newInline< BoxedQuaternion >(luaState, metaTableRef, f[0], f[1], f[2]); return 1; }
+				else if (argc == 4)
+					{ newInline< BoxedQuaternion >(luaState, metaTableRef, f[0], f[1], f[2], f[3]); return 1; }
+				break;
+			case InlineType::Color4f:
+				if (argc == 0)
+					{ newInline< BoxedColor4f >(luaState, metaTableRef); return 1; }
+				else if (argc == 3)
+					{ newInline< BoxedColor4f >(luaState, metaTableRef, f[0], f[1], f[2]); return 1; }
+				else if (argc == 4)
+					{ newInline< BoxedColor4f >(luaState, metaTableRef, f[0], f[1], f[2], f[3]); return 1; }
+				break;
+			case InlineType::Transform:
+				if (argc == 0)
+					{ newInline< BoxedTransform >(luaState, metaTableRef); return 1; }
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
 	Any argv[8];
-	ms_instance->toAny(2, top - 1, argv);
+	manager->toAny(2, top - 1, argv);
 
 #if T_VERIFY_USING_EXCEPTIONS
 	try
@@ -1077,6 +1509,12 @@ int ScriptManagerLua::classNewValue(lua_State* luaState)
 		if (!object) [[unlikely]]
 			return 0;
 
+		if (rc.inlineType != InlineType::None)
+		{
+			manager->pushInline(rc.inlineType, object);
+			return 1;
+		}
+
 		// Represent the value type as full userdata holding the boxed pointer.
 		ITypedObject** ud = (ITypedObject**)lua_newuserdatauv(luaState, sizeof(ITypedObject*), 0);
 		*ud = object.ptr();
@@ -1089,7 +1527,7 @@ int ScriptManagerLua::classNewValue(lua_State* luaState)
 	catch(const RuntimeException& x)
 	{
 		log::error << L"Unhandled RuntimeException occurred when calling constructor, class " << rc.runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
-		ms_instance->breakDebugger(luaState);
+		manager->breakDebugger(luaState);
 	}
 #endif
 
@@ -1098,6 +1536,7 @@ int ScriptManagerLua::classNewValue(lua_State* luaState)
 
 int ScriptManagerLua::classCallUnknownMethod(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const IRuntimeClass* runtimeClass = reinterpret_cast< const IRuntimeClass* >(lua_touserdata(luaState, lua_upvalueindex(2)));
 	T_ASSERT(runtimeClass);
 
@@ -1121,21 +1560,21 @@ int ScriptManagerLua::classCallUnknownMethod(lua_State* luaState)
 	// Convert arguments; first argument should always be method name.
 	Any argv[8];
 	argv[0] = Any::fromString(methodName);
-	ms_instance->toAny(3, top - 2, &argv[1]);
+	manager->toAny(3, top - 2, &argv[1]);
 
 #if T_VERIFY_USING_EXCEPTIONS
 	try
 #endif
 	{
 		const Any returnValue = runtimeDispatch->invoke(object, top - 1, argv);
-		ms_instance->pushAny(returnValue);
+		manager->pushAny(returnValue);
 		return 1;
 	}
 #if T_VERIFY_USING_EXCEPTIONS
 	catch(const RuntimeException& x)
 	{
 		log::error << L"Unhandled RuntimeException occurred when calling unknown method \"" << mbstows(methodName) << L"\", class " << runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
-		ms_instance->breakDebugger(luaState);
+		manager->breakDebugger(luaState);
 	}
 #endif
 
@@ -1144,6 +1583,7 @@ int ScriptManagerLua::classCallUnknownMethod(lua_State* luaState)
 
 int ScriptManagerLua::classCallMethod(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const IRuntimeDispatch* runtimeDispatch = reinterpret_cast< const IRuntimeDispatch* >(lua_touserdata(luaState, lua_upvalueindex(1)));
 	T_ASSERT(runtimeDispatch);
 
@@ -1160,14 +1600,14 @@ int ScriptManagerLua::classCallMethod(lua_State* luaState)
 	}
 
 	Any argv[10];
-	ms_instance->toAny(2, top - 1, argv);
+	manager->toAny(2, top - 1, argv);
 
 #if T_VERIFY_USING_EXCEPTIONS
 	try
 #endif
 	{
 		const Any returnValue = runtimeDispatch->invoke(object, top - 1, argv);
-		ms_instance->pushAny(returnValue);
+		manager->pushAny(returnValue);
 		return 1;
 	}
 #if T_VERIFY_USING_EXCEPTIONS
@@ -1175,7 +1615,7 @@ int ScriptManagerLua::classCallMethod(lua_State* luaState)
 	{
 		const IRuntimeClass* runtimeClass = reinterpret_cast< const IRuntimeClass* >(lua_touserdata(luaState, lua_upvalueindex(2)));
 		log::error << L"Unhandled RuntimeException occurred when calling method \"" << mbstows(findRuntimeClassMethodName(runtimeClass, runtimeDispatch)) << L"\", class " << runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
-		ms_instance->breakDebugger(luaState);
+		manager->breakDebugger(luaState);
 	}
 #endif
 
@@ -1184,6 +1624,7 @@ int ScriptManagerLua::classCallMethod(lua_State* luaState)
 
 int ScriptManagerLua::classCallStaticMethod(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const IRuntimeDispatch* runtimeDispatch = reinterpret_cast< const IRuntimeDispatch* >(lua_touserdata(luaState, lua_upvalueindex(1)));
 	T_ASSERT(runtimeDispatch);
 
@@ -1192,14 +1633,14 @@ int ScriptManagerLua::classCallStaticMethod(lua_State* luaState)
 		return 0;
 
 	Any argv[10];
-	ms_instance->toAny(1, top, argv);
+	manager->toAny(1, top, argv);
 
 #if T_VERIFY_USING_EXCEPTIONS
 	try
 #endif
 	{
 		const Any returnValue = runtimeDispatch->invoke(0, top, argv);
-		ms_instance->pushAny(returnValue);
+		manager->pushAny(returnValue);
 		return 1;
 	}
 #if T_VERIFY_USING_EXCEPTIONS
@@ -1207,15 +1648,98 @@ int ScriptManagerLua::classCallStaticMethod(lua_State* luaState)
 	{
 		const IRuntimeClass* runtimeClass = reinterpret_cast< const IRuntimeClass* >(lua_touserdata(luaState, lua_upvalueindex(2)));
 		log::error << L"Unhandled RuntimeException occurred when calling static method \"" << mbstows(findRuntimeClassMethodName(runtimeClass, runtimeDispatch)) << L"\", class " << runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
-		ms_instance->breakDebugger(luaState);
+		manager->breakDebugger(luaState);
 	}
 #endif
 
 	return 0;
 }
 
+int ScriptManagerLua::classFastCallMethod(lua_State* luaState)
+{
+	ScriptManagerLua* manager = fromState(luaState);
+
+	// lua_upvalueindex(1) == dispatch
+	// lua_upvalueindex(2) == class
+	// lua_upvalueindex(3) == fast call
+
+	const IRuntimeClass* runtimeClass = reinterpret_cast< const IRuntimeClass* >(lua_touserdata(luaState, lua_upvalueindex(2)));
+	const FastCall* fastCall = reinterpret_cast< const FastCall* >(lua_touserdata(luaState, lua_upvalueindex(3)));
+	T_ASSERT(fastCall);
+
+	FastCallValue argv[FastCall::MaxArguments];
+
+	ITypedObject* object = toTypedObject(luaState, 1);
+	if (
+		object != nullptr &&
+		is_type_of(runtimeClass->getExportType(), type_of(object)) &&
+		manager->toFastCallArguments(luaState, 2, fastCall, argv)
+	)
+	{
+		const IRuntimeDispatch* runtimeDispatch = reinterpret_cast< const IRuntimeDispatch* >(lua_touserdata(luaState, lua_upvalueindex(1)));
+#if T_VERIFY_USING_EXCEPTIONS
+		try
+#endif
+		{
+			const Any returnValue = (*fastCall->function)(runtimeDispatch, object, argv);
+			manager->pushAny(returnValue);
+			return 1;
+		}
+#if T_VERIFY_USING_EXCEPTIONS
+		catch(const RuntimeException& x)
+		{
+			log::error << L"Unhandled RuntimeException occurred when calling method \"" << mbstows(findRuntimeClassMethodName(runtimeClass, runtimeDispatch)) << L"\", class " << runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
+			manager->breakDebugger(luaState);
+		}
+		return 0;
+#endif
+	}
+
+	// Arguments doesn't match signature exactly; dispatch through
+	// Any which also coerce or report mismatching arguments.
+	return classCallMethod(luaState);
+}
+
+int ScriptManagerLua::classFastCallStaticMethod(lua_State* luaState)
+{
+	ScriptManagerLua* manager = fromState(luaState);
+
+	// lua_upvalueindex(1) == dispatch
+	// lua_upvalueindex(2) == class
+	// lua_upvalueindex(3) == fast call
+
+	const FastCall* fastCall = reinterpret_cast< const FastCall* >(lua_touserdata(luaState, lua_upvalueindex(3)));
+	T_ASSERT(fastCall);
+
+	FastCallValue argv[FastCall::MaxArguments];
+	if (manager->toFastCallArguments(luaState, 1, fastCall, argv))
+	{
+		const IRuntimeDispatch* runtimeDispatch = reinterpret_cast< const IRuntimeDispatch* >(lua_touserdata(luaState, lua_upvalueindex(1)));
+#if T_VERIFY_USING_EXCEPTIONS
+		try
+#endif
+		{
+			const Any returnValue = (*fastCall->function)(runtimeDispatch, nullptr, argv);
+			manager->pushAny(returnValue);
+			return 1;
+		}
+#if T_VERIFY_USING_EXCEPTIONS
+		catch(const RuntimeException& x)
+		{
+			const IRuntimeClass* runtimeClass = reinterpret_cast< const IRuntimeClass* >(lua_touserdata(luaState, lua_upvalueindex(2)));
+			log::error << L"Unhandled RuntimeException occurred when calling static method \"" << mbstows(findRuntimeClassMethodName(runtimeClass, runtimeDispatch)) << L"\", class " << runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
+			manager->breakDebugger(luaState);
+		}
+		return 0;
+#endif
+	}
+
+	return classCallStaticMethod(luaState);
+}
+
 int ScriptManagerLua::classSetProperty(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const IRuntimeDispatch* runtimeDispatch = reinterpret_cast< const IRuntimeDispatch* >(lua_touserdata(luaState, lua_upvalueindex(1)));
 	T_ASSERT(runtimeDispatch);
 
@@ -1231,7 +1755,7 @@ int ScriptManagerLua::classSetProperty(lua_State* luaState)
 	try
 #endif
 	{
-		const Any value = ms_instance->toAny(2);
+		const Any value = manager->toAny(2);
 		runtimeDispatch->invoke(object, 1, &value);
 	}
 #if T_VERIFY_USING_EXCEPTIONS
@@ -1239,7 +1763,7 @@ int ScriptManagerLua::classSetProperty(lua_State* luaState)
 	{
 		const IRuntimeClass* runtimeClass = reinterpret_cast< IRuntimeClass* >(lua_touserdata(luaState, lua_upvalueindex(2)));
 		log::error << L"Unhandled RuntimeException occurred when setting property \"" << mbstows(findRuntimeClassPropertyName(runtimeClass, runtimeDispatch)) << L"\", class " << runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
-		ms_instance->breakDebugger(luaState);
+		manager->breakDebugger(luaState);
 	}
 #endif
 
@@ -1248,6 +1772,7 @@ int ScriptManagerLua::classSetProperty(lua_State* luaState)
 
 int ScriptManagerLua::classGetProperty(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const IRuntimeDispatch* runtimeDispatch = reinterpret_cast< const IRuntimeDispatch* >(lua_touserdata(luaState, lua_upvalueindex(1)));
 	T_ASSERT(runtimeDispatch);
 
@@ -1260,14 +1785,15 @@ int ScriptManagerLua::classGetProperty(lua_State* luaState)
 	}
 
 	const Any value = runtimeDispatch->invoke(object, 0, 0);
-	ms_instance->pushAny(value);
+	manager->pushAny(value);
 	return 1;
 }
 
 int ScriptManagerLua::classEqual(lua_State* luaState)
 {
-	const Any object0 = ms_instance->toAny(1);
-	const Any object1 = ms_instance->toAny(2);
+	ScriptManagerLua* manager = fromState(luaState);
+	const Any object0 = manager->toAny(1);
+	const Any object1 = manager->toAny(2);
 
 	if (object0.isObject() && object1.isObject())
 	{
@@ -1280,6 +1806,7 @@ int ScriptManagerLua::classEqual(lua_State* luaState)
 
 int ScriptManagerLua::classAdd(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const IRuntimeClass* runtimeClass = reinterpret_cast< const IRuntimeClass* >(lua_touserdata(luaState, lua_upvalueindex(1)));
 	T_ASSERT(runtimeClass);
 
@@ -1296,12 +1823,12 @@ int ScriptManagerLua::classAdd(lua_State* luaState)
 	if (isNativeInstance(luaState, 1))
 	{
 		object = toTypedObject(luaState, 1);
-		arg = ms_instance->toAny(2);
+		arg = manager->toAny(2);
 	}
 	else if (isNativeInstance(luaState, 2))
 	{
 		object = toTypedObject(luaState, 2);
-		arg = ms_instance->toAny(1);
+		arg = manager->toAny(1);
 	}
 
 	if (!object) [[unlikely]]
@@ -1315,14 +1842,14 @@ int ScriptManagerLua::classAdd(lua_State* luaState)
 #endif
 	{
 		const Any returnValue = runtimeDispatch->invoke(object, 1, &arg);
-		ms_instance->pushAny(returnValue);
+		manager->pushAny(returnValue);
 		return 1;
 	}
 #if T_VERIFY_USING_EXCEPTIONS
 	catch(const RuntimeException& x)
 	{
 		log::error << L"Unhandled RuntimeException occurred when calling add operator, class " << runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
-		ms_instance->breakDebugger(luaState);
+		manager->breakDebugger(luaState);
 	}
 #endif
 
@@ -1331,6 +1858,7 @@ int ScriptManagerLua::classAdd(lua_State* luaState)
 
 int ScriptManagerLua::classSubtract(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const IRuntimeClass* runtimeClass = reinterpret_cast< const IRuntimeClass* >(lua_touserdata(luaState, lua_upvalueindex(1)));
 	T_ASSERT(runtimeClass);
 
@@ -1348,21 +1876,21 @@ int ScriptManagerLua::classSubtract(lua_State* luaState)
 		return 0;
 	}
 
-	const Any arg = ms_instance->toAny(2);
+	const Any arg = manager->toAny(2);
 
 #if T_VERIFY_USING_EXCEPTIONS
 	try
 #endif
 	{
 		const Any returnValue = runtimeDispatch->invoke(object, 1, &arg);
-		ms_instance->pushAny(returnValue);
+		manager->pushAny(returnValue);
 		return 1;
 	}
 #if T_VERIFY_USING_EXCEPTIONS
 	catch(const RuntimeException& x)
 	{
 		log::error << L"Unhandled RuntimeException occurred when calling subtract operator, class " << runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
-		ms_instance->breakDebugger(luaState);
+		manager->breakDebugger(luaState);
 	}
 #endif
 
@@ -1371,6 +1899,7 @@ int ScriptManagerLua::classSubtract(lua_State* luaState)
 
 int ScriptManagerLua::classMultiply(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const IRuntimeClass* runtimeClass = reinterpret_cast< const IRuntimeClass* >(lua_touserdata(luaState, lua_upvalueindex(1)));
 	T_ASSERT(runtimeClass);
 
@@ -1387,12 +1916,12 @@ int ScriptManagerLua::classMultiply(lua_State* luaState)
 	if (isNativeInstance(luaState, 1))
 	{
 		object = toTypedObject(luaState, 1);
-		arg = ms_instance->toAny(2);
+		arg = manager->toAny(2);
 	}
 	else if (isNativeInstance(luaState, 2))
 	{
 		object = toTypedObject(luaState, 2);
-		arg = ms_instance->toAny(1);
+		arg = manager->toAny(1);
 	}
 
 	if (!object) [[unlikely]]
@@ -1406,14 +1935,14 @@ int ScriptManagerLua::classMultiply(lua_State* luaState)
 #endif
 	{
 		const Any returnValue = runtimeDispatch->invoke(object, 1, &arg);
-		ms_instance->pushAny(returnValue);
+		manager->pushAny(returnValue);
 		return 1;
 	}
 #if T_VERIFY_USING_EXCEPTIONS
 	catch(const RuntimeException& x)
 	{
 		log::error << L"Unhandled RuntimeException occurred when calling multiply operator, class " << runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
-		ms_instance->breakDebugger(luaState);
+		manager->breakDebugger(luaState);
 	}
 #endif
 
@@ -1422,6 +1951,7 @@ int ScriptManagerLua::classMultiply(lua_State* luaState)
 
 int ScriptManagerLua::classDivide(lua_State* luaState)
 {
+	ScriptManagerLua* manager = fromState(luaState);
 	const IRuntimeClass* runtimeClass = reinterpret_cast< const IRuntimeClass* >(lua_touserdata(luaState, lua_upvalueindex(1)));
 	T_ASSERT(runtimeClass);
 
@@ -1439,21 +1969,21 @@ int ScriptManagerLua::classDivide(lua_State* luaState)
 		return 0;
 	}
 
-	const Any arg = ms_instance->toAny(2);
+	const Any arg = manager->toAny(2);
 
 #if T_VERIFY_USING_EXCEPTIONS
 	try
 #endif
 	{
 		const Any returnValue = runtimeDispatch->invoke(object, 1, &arg);
-		ms_instance->pushAny(returnValue);
+		manager->pushAny(returnValue);
 		return 1;
 	}
 #if T_VERIFY_USING_EXCEPTIONS
 	catch(const RuntimeException& x)
 	{
 		log::error << L"Unhandled RuntimeException occurred when calling divide operator, class " << runtimeClass->getExportType().getName() << L"; \"" << x.what() << L"\"." << Endl;
-		ms_instance->breakDebugger(luaState);
+		manager->breakDebugger(luaState);
 	}
 #endif
 
@@ -1518,6 +2048,333 @@ int ScriptManagerLua::classIndex(lua_State* luaState)
 	return 1;
 }
 
+int ScriptManagerLua::inlineIndex(lua_State* luaState)
+{
+	ScriptManagerLua* manager = fromState(luaState);
+	// lua_upvalueindex(1) == __getters
+	// lua_upvalueindex(2) == class
+	// lua_upvalueindex(3) == inline type
+
+	// Read components directly from inline value; anything
+	// else is resolved through class as usual.
+	size_t length = 0;
+	const char* key = (lua_type(luaState, 2) == LUA_TSTRING) ? lua_tolstring(luaState, 2, &length) : nullptr;
+	if (key)
+	{
+		const InlineType inlineType = (InlineType)lua_tointeger(luaState, lua_upvalueindex(3));
+		switch (inlineType)
+		{
+		case InlineType::Vector4:
+			{
+				const BoxedVector4* v = toInline< BoxedVector4 >(luaState, 1);
+				if (length == 1)
+				{
+					switch (key[0])
+					{
+					case 'x': lua_pushnumber(luaState, v->get_x()); return 1;
+					case 'y': lua_pushnumber(luaState, v->get_y()); return 1;
+					case 'z': lua_pushnumber(luaState, v->get_z()); return 1;
+					case 'w': lua_pushnumber(luaState, v->get_w()); return 1;
+					}
+				}
+				else if (strcmp(key, "length") == 0)
+				{
+					lua_pushnumber(luaState, v->get_length());
+					return 1;
+				}
+			}
+			break;
+
+		case InlineType::Quaternion:
+			if (length == 1)
+			{
+				const BoxedQuaternion* q = toInline< BoxedQuaternion >(luaState, 1);
+				switch (key[0])
+				{
+				case 'x': lua_pushnumber(luaState, q->get_x()); return 1;
+				case 'y': lua_pushnumber(luaState, q->get_y()); return 1;
+				case 'z': lua_pushnumber(luaState, q->get_z()); return 1;
+				case 'w': lua_pushnumber(luaState, q->get_w()); return 1;
+				}
+			}
+			break;
+
+		case InlineType::Color4f:
+			{
+				const BoxedColor4f* c = toInline< BoxedColor4f >(luaState, 1);
+				if (strcmp(key, "red") == 0)
+					{ lua_pushnumber(luaState, c->getRed()); return 1; }
+				else if (strcmp(key, "green") == 0)
+					{ lua_pushnumber(luaState, c->getGreen()); return 1; }
+				else if (strcmp(key, "blue") == 0)
+					{ lua_pushnumber(luaState, c->getBlue()); return 1; }
+				else if (strcmp(key, "alpha") == 0)
+					{ lua_pushnumber(luaState, c->getAlpha()); return 1; }
+			}
+			break;
+
+		case InlineType::Transform:
+			{
+				const BoxedTransform* t = toInline< BoxedTransform >(luaState, 1);
+				if (strcmp(key, "translation") == 0)
+				{
+					newInline< BoxedVector4 >(luaState, manager->m_inlineMetaTableRefs[(int32_t)InlineType::Vector4], t->get_translation());
+					return 1;
+				}
+				else if (strcmp(key, "rotation") == 0)
+				{
+					newInline< BoxedQuaternion >(luaState, manager->m_inlineMetaTableRefs[(int32_t)InlineType::Quaternion], t->get_rotation());
+					return 1;
+				}
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	return classIndex(luaState);
+}
+
+int ScriptManagerLua::inlineNewIndex(lua_State* luaState)
+{
+	// lua_upvalueindex(1) == __setters
+	// lua_upvalueindex(2) == class
+	// lua_upvalueindex(3) == inline type
+
+	// Write components directly into inline value.
+	size_t length = 0;
+	const char* key = (lua_type(luaState, 2) == LUA_TSTRING) ? lua_tolstring(luaState, 2, &length) : nullptr;
+	if (key && lua_type(luaState, 3) == LUA_TNUMBER)
+	{
+		const float value = (float)lua_tonumber(luaState, 3);
+		const InlineType inlineType = (InlineType)lua_tointeger(luaState, lua_upvalueindex(3));
+		switch (inlineType)
+		{
+		case InlineType::Vector4:
+			if (length == 1)
+			{
+				BoxedVector4* v = toInline< BoxedVector4 >(luaState, 1);
+				switch (key[0])
+				{
+				case 'x': v->set_x(value); return 0;
+				case 'y': v->set_y(value); return 0;
+				case 'z': v->set_z(value); return 0;
+				case 'w': v->set_w(value); return 0;
+				}
+			}
+			break;
+
+		case InlineType::Quaternion:
+			if (length == 1)
+			{
+				BoxedQuaternion* q = toInline< BoxedQuaternion >(luaState, 1);
+				switch (key[0])
+				{
+				case 'x': q->set_x(value); return 0;
+				case 'y': q->set_y(value); return 0;
+				case 'z': q->set_z(value); return 0;
+				case 'w': q->set_w(value); return 0;
+				}
+			}
+			break;
+
+		case InlineType::Color4f:
+			{
+				BoxedColor4f* c = toInline< BoxedColor4f >(luaState, 1);
+				if (strcmp(key, "red") == 0)
+					{ c->setRed(value); return 0; }
+				else if (strcmp(key, "green") == 0)
+					{ c->setGreen(value); return 0; }
+				else if (strcmp(key, "blue") == 0)
+					{ c->setBlue(value); return 0; }
+				else if (strcmp(key, "alpha") == 0)
+					{ c->setAlpha(value); return 0; }
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	return classNewIndex(luaState);
+}
+
+int ScriptManagerLua::inlineEqual(lua_State* luaState)
+{
+	ScriptManagerLua* manager = fromState(luaState);
+	// lua_upvalueindex(1) == inline type
+
+	// Inline values are compared by value since each
+	// copy is a separate userdata.
+	const InlineType inlineType = (InlineType)lua_tointeger(luaState, lua_upvalueindex(1));
+	if (
+		manager->getInlineType(luaState, 1) != inlineType ||
+		manager->getInlineType(luaState, 2) != inlineType
+	)
+	{
+		lua_pushboolean(luaState, 0);
+		return 1;
+	}
+
+	bool equal = false;
+	switch (inlineType)
+	{
+	case InlineType::Vector4:
+		equal = (toInline< BoxedVector4 >(luaState, 1)->unbox() == toInline< BoxedVector4 >(luaState, 2)->unbox());
+		break;
+	case InlineType::Quaternion:
+		equal = (toInline< BoxedQuaternion >(luaState, 1)->unbox() == toInline< BoxedQuaternion >(luaState, 2)->unbox());
+		break;
+	case InlineType::Color4f:
+		equal = (toInline< BoxedColor4f >(luaState, 1)->unbox() == toInline< BoxedColor4f >(luaState, 2)->unbox());
+		break;
+	case InlineType::Transform:
+		equal = (toInline< BoxedTransform >(luaState, 1)->unbox() == toInline< BoxedTransform >(luaState, 2)->unbox());
+		break;
+	default:
+		break;
+	}
+
+	lua_pushboolean(luaState, equal ? 1 : 0);
+	return 1;
+}
+
+int ScriptManagerLua::inlineArithmetic(lua_State* luaState)
+{
+	ScriptManagerLua* manager = fromState(luaState);
+	// lua_upvalueindex(1) == runtime class
+	// lua_upvalueindex(2) == operator dispatch
+	// lua_upvalueindex(3) == operator
+
+	const IRuntimeClass::Operator op = (IRuntimeClass::Operator)lua_tointeger(luaState, lua_upvalueindex(3));
+	const InlineType ta = manager->getInlineType(luaState, 1);
+	const InlineType tb = manager->getInlineType(luaState, 2);
+	const bool na = (lua_type(luaState, 1) == LUA_TNUMBER);
+	const bool nb = (lua_type(luaState, 2) == LUA_TNUMBER);
+	const int32_t* metaTableRefs = manager->m_inlineMetaTableRefs;
+
+	// Evaluate common operations without dispatch, result is
+	// written directly into a new inline value.
+	if (ta == InlineType::Vector4)
+	{
+		const BoxedVector4* a = toInline< BoxedVector4 >(luaState, 1);
+		const int32_t metaTableRef = metaTableRefs[(int32_t)InlineType::Vector4];
+		if (tb == InlineType::Vector4)
+		{
+			const BoxedVector4* b = toInline< BoxedVector4 >(luaState, 2);
+			switch (op)
+			{
+			case IRuntimeClass::Operator::Add: newInline< BoxedVector4 >(luaState, metaTableRef, a->add(b)); return 1;
+			case IRuntimeClass::Operator::Subtract: newInline< BoxedVector4 >(luaState, metaTableRef, a->sub(b)); return 1;
+			case IRuntimeClass::Operator::Multiply: newInline< BoxedVector4 >(luaState, metaTableRef, a->mul(b)); return 1;
+			case IRuntimeClass::Operator::Divide: newInline< BoxedVector4 >(luaState, metaTableRef, a->div(b)); return 1;
+			default: break;
+			}
+		}
+		else if (nb)
+		{
+			const float b = (float)lua_tonumber(luaState, 2);
+			switch (op)
+			{
+			case IRuntimeClass::Operator::Add: newInline< BoxedVector4 >(luaState, metaTableRef, a->add(b)); return 1;
+			case IRuntimeClass::Operator::Subtract: newInline< BoxedVector4 >(luaState, metaTableRef, a->sub(b)); return 1;
+			case IRuntimeClass::Operator::Multiply: newInline< BoxedVector4 >(luaState, metaTableRef, a->mul(b)); return 1;
+			case IRuntimeClass::Operator::Divide: newInline< BoxedVector4 >(luaState, metaTableRef, a->div(b)); return 1;
+			default: break;
+			}
+		}
+	}
+	else if (na && tb == InlineType::Vector4)
+	{
+		const float a = (float)lua_tonumber(luaState, 1);
+		const BoxedVector4* b = toInline< BoxedVector4 >(luaState, 2);
+		const int32_t metaTableRef = metaTableRefs[(int32_t)InlineType::Vector4];
+		if (op == IRuntimeClass::Operator::Add)
+			{ newInline< BoxedVector4 >(luaState, metaTableRef, b->add(a)); return 1; }
+		else if (op == IRuntimeClass::Operator::Multiply)
+			{ newInline< BoxedVector4 >(luaState, metaTableRef, b->mul(a)); return 1; }
+	}
+	else if (ta == InlineType::Color4f)
+	{
+		const BoxedColor4f* a = toInline< BoxedColor4f >(luaState, 1);
+		const int32_t metaTableRef = metaTableRefs[(int32_t)InlineType::Color4f];
+		if (tb == InlineType::Color4f)
+		{
+			const BoxedColor4f* b = toInline< BoxedColor4f >(luaState, 2);
+			switch (op)
+			{
+			case IRuntimeClass::Operator::Add: newInline< BoxedColor4f >(luaState, metaTableRef, a->add(b)); return 1;
+			case IRuntimeClass::Operator::Subtract: newInline< BoxedColor4f >(luaState, metaTableRef, a->sub(b)); return 1;
+			case IRuntimeClass::Operator::Multiply: newInline< BoxedColor4f >(luaState, metaTableRef, a->mul(b)); return 1;
+			case IRuntimeClass::Operator::Divide: newInline< BoxedColor4f >(luaState, metaTableRef, a->div(b)); return 1;
+			default: break;
+			}
+		}
+		else if (nb)
+		{
+			const float b = (float)lua_tonumber(luaState, 2);
+			if (op == IRuntimeClass::Operator::Multiply)
+				{ newInline< BoxedColor4f >(luaState, metaTableRef, a->mul(b)); return 1; }
+			else if (op == IRuntimeClass::Operator::Divide)
+				{ newInline< BoxedColor4f >(luaState, metaTableRef, a->div(b)); return 1; }
+		}
+	}
+	else if (na && tb == InlineType::Color4f && op == IRuntimeClass::Operator::Multiply)
+	{
+		const float a = (float)lua_tonumber(luaState, 1);
+		const BoxedColor4f* b = toInline< BoxedColor4f >(luaState, 2);
+		newInline< BoxedColor4f >(luaState, metaTableRefs[(int32_t)InlineType::Color4f], b->mul(a));
+		return 1;
+	}
+	else if (ta == InlineType::Quaternion && op == IRuntimeClass::Operator::Multiply)
+	{
+		const BoxedQuaternion* a = toInline< BoxedQuaternion >(luaState, 1);
+		if (tb == InlineType::Quaternion)
+			{ newInline< BoxedQuaternion >(luaState, metaTableRefs[(int32_t)InlineType::Quaternion], a->concat(toInline< BoxedQuaternion >(luaState, 2))); return 1; }
+		else if (tb == InlineType::Vector4)
+			{ newInline< BoxedVector4 >(luaState, metaTableRefs[(int32_t)InlineType::Vector4], a->transform(toInline< BoxedVector4 >(luaState, 2))); return 1; }
+	}
+	else if (ta == InlineType::Transform && op == IRuntimeClass::Operator::Multiply)
+	{
+		const BoxedTransform* a = toInline< BoxedTransform >(luaState, 1);
+		if (tb == InlineType::Transform)
+			{ newInline< BoxedTransform >(luaState, metaTableRefs[(int32_t)InlineType::Transform], a->concat(toInline< BoxedTransform >(luaState, 2))); return 1; }
+		else if (tb == InlineType::Vector4)
+			{ newInline< BoxedVector4 >(luaState, metaTableRefs[(int32_t)InlineType::Vector4], a->transform(toInline< BoxedVector4 >(luaState, 2))); return 1; }
+	}
+
+	// Not a common operation; fall back to class's operator dispatch.
+	if (!lua_touserdata(luaState, lua_upvalueindex(2)))
+		return luaL_error(luaState, "Operator not supported by value type");
+
+	switch (op)
+	{
+	case IRuntimeClass::Operator::Add:
+		return classAdd(luaState);
+	case IRuntimeClass::Operator::Subtract:
+		return classSubtract(luaState);
+	case IRuntimeClass::Operator::Multiply:
+		return classMultiply(luaState);
+	case IRuntimeClass::Operator::Divide:
+		return classDivide(luaState);
+	default:
+		return 0;
+	}
+}
+
+int ScriptManagerLua::inlineNegate(lua_State* luaState)
+{
+	ScriptManagerLua* manager = fromState(luaState);
+	// lua_upvalueindex(1) == inline type
+
+	const BoxedVector4* v = toInline< BoxedVector4 >(luaState, 1);
+	newInline< BoxedVector4 >(luaState, manager->m_inlineMetaTableRefs[(int32_t)InlineType::Vector4], -v->unbox());
+	return 1;
+}
+
 void* ScriptManagerLua::luaAlloc(void* ud, void* ptr, size_t osize, size_t nsize)
 {
 	ScriptManagerLua* this_ = reinterpret_cast< ScriptManagerLua* >(ud);
@@ -1529,6 +2386,11 @@ void* ScriptManagerLua::luaAlloc(void* ud, void* ptr, size_t osize, size_t nsize
 	{
 		totalMemoryUse += nsize;
 
+		// Track amount of memory allocated, for collector pacing.
+		const size_t previousSize = ptr ? osize : 0;
+		if (nsize > previousSize)
+			this_->m_allocatedMemory += nsize - previousSize;
+
 #if defined(T_USE_ALLOCATOR)
 		if (osize >= nsize && osize - nsize < 512)
 		{
@@ -1542,6 +2404,8 @@ void* ScriptManagerLua::luaAlloc(void* ud, void* ptr, size_t osize, size_t nsize
 			return nullptr;
 #endif
 
+		this_->m_allocationCount++;
+
 		if (ptr && osize > 0)
 		{
 #if defined(T_USE_ALLOCATOR)
@@ -1574,16 +2438,18 @@ void* ScriptManagerLua::luaAlloc(void* ud, void* ptr, size_t osize, size_t nsize
 
 int ScriptManagerLua::luaAllocatedMemory(lua_State* luaState)
 {
-	lua_pushinteger(luaState, lua_Integer(ms_instance->m_totalMemoryUse));
+	ScriptManagerLua* manager = fromState(luaState);
+	lua_pushinteger(luaState, lua_Integer(manager->m_totalMemoryUse));
 	return 1;
 }
 
 void ScriptManagerLua::hookCallback(lua_State* luaState, lua_Debug* ar)
 {
-	if (ms_instance->m_debugger)
-		ms_instance->m_debugger->hookCallback(luaState, ar);
-	if (ms_instance->m_profiler)
-		ms_instance->m_profiler->hookCallback(luaState, ar);
+	ScriptManagerLua* manager = fromState(luaState);
+	if (manager->m_debugger)
+		manager->m_debugger->hookCallback(luaState, ar);
+	if (manager->m_profiler)
+		manager->m_profiler->hookCallback(luaState, ar);
 }
 
 int ScriptManagerLua::luaPanic(lua_State* luaState)
@@ -33,6 +33,8 @@ namespace traktor
 {
 
 class Any;
+struct FastCall;
+union FastCallValue;
 
 }
 
@@ -69,6 +71,8 @@ public:
 
 	virtual void collectGarbage(bool full) override final;
 
+	virtual void setCollectBudget(int32_t budget) override final;
+
 	virtual void getStatistics(ScriptStatistics& outStatistics) const override final;
 
 	void pushObject(ITypedObject* object);
@@ -101,11 +105,23 @@ private:
 	friend class ScriptDebuggerLua;
 	friend class ScriptProfilerLua;
 
+	/*! Value types stored inline in userdata payload. */
+	enum class InlineType : int32_t
+	{
+		None,
+		Vector4,
+		Quaternion,
+		Color4f,
+		Transform,
+		Count
+	};
+
 	struct RegisteredClass
 	{
 		Ref< const IRuntimeClass > runtimeClass;
 		int32_t classTableRef;
 		bool isValueType;
+		InlineType inlineType;
 	};
 
 	lua_State* m_luaState;
@@ -115,17 +131,31 @@ private:
 #if defined(T_SCRIPT_LUA_USE_MT_LOCK)
 	mutable Semaphore m_lock;
 #endif
-	static ScriptManagerLua* ms_instance;
 	ScriptContextLua* m_lockContext;
 	AlignedVector< RegisteredClass > m_classRegistry;
+	int32_t m_inlineMetaTableRefs[(int32_t)InlineType::Count];
+	const void* m_inlineMetaTables[(int32_t)InlineType::Count];
+	RefArray< ITypedObject > m_scratchBoxes[(int32_t)InlineType::Count];
 	RefArray< ScriptContextLua > m_contexts;
 	Ref< ScriptDebuggerLua > m_debugger;
 	Ref< ScriptProfilerLua > m_profiler;
-	float m_collectStepFrequency;
-	int32_t m_collectSteps;
-	float m_collectTargetSteps;
+	int32_t m_collectBudget;
+	bool m_collectControlled;
+	bool m_collectCycleActive;
+	double m_collectDebt;
+	double m_collectStepCost;
+	double m_collectTime;
+	double m_collectTimeWorst;
+	double m_collectTimeWindowWorst;
+	double m_collectWindowStart;
+	uint32_t m_collectSteps;
+	uint32_t m_collectCycles;
 	size_t m_totalMemoryUse;
 	size_t m_lastMemoryUse;
+	size_t m_allocationCount;
+	size_t m_allocatedMemory;
+	size_t m_lastAllocatedMemory;
+	double m_allocationRate;
 
 	void destroyContext(ScriptContextLua* context);
 
@@ -133,10 +163,22 @@ private:
 
 	void collectGarbageFullNoLock();
 
-	void collectGarbagePartial();
+	void collectGarbagePartial(double deltaTime);
 
 	void breakDebugger(lua_State* luaState);
 
+	void createInlineMetaTable(const RegisteredClass& rc);
+
+	void pushInline(InlineType inlineType, const ITypedObject* object);
+
+	InlineType getInlineType(lua_State* luaState, int32_t index) const;
+
+	ITypedObject* boxInline(InlineType inlineType, ITypedObject* object);
+
+	bool toFastCallArguments(lua_State* luaState, int32_t base, const FastCall* fastCall, FastCallValue* outArgv) const;
+
+	static ScriptManagerLua* fromState(lua_State* luaState);
+
 	static int classGc(lua_State* luaState);
 
 	static int classNew(lua_State* luaState);
@@ -149,6 +191,10 @@ private:
 
 	static int classCallStaticMethod(lua_State* luaState);
 
+	static int classFastCallMethod(lua_State* luaState);
+
+	static int classFastCallStaticMethod(lua_State* luaState);
+
 	static int classSetProperty(lua_State* luaState);
 
 	static int classGetProperty(lua_State* luaState);
@@ -167,6 +213,16 @@ private:
 
 	static int classIndex(lua_State* luaState);
 
+	static int inlineIndex(lua_State* luaState);
+
+	static int inlineNewIndex(lua_State* luaState);
+
+	static int inlineEqual(lua_State* luaState);
+
+	static int inlineArithmetic(lua_State* luaState);
+
+	static int inlineNegate(lua_State* luaState);
+
 	static void* luaAlloc(void* ud, void* ptr, size_t osize, size_t nsize);
 
 	static int luaAllocatedMemory(lua_State* luaState);
@@ -0,0 +1,115 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Script/Lua/Test/CaseScriptCollect.h"
+
+#include "Core/Class/BoxedClassFactory.h"
+#include "Core/Class/OrderedClassRegistrar.h"
+#include "Core/Log/Log.h"
+#include "Core/Timer/Timer.h"
+#include "Script/IScriptBlob.h"
+#include "Script/IScriptContext.h"
+#include "Script/Lua/ScriptCompilerLua.h"
+#include "Script/Lua/ScriptManagerLua.h"
+
+#include <algorithm>
+
+namespace traktor::script::test
+{
+namespace
+{
+
+const int32_t c_churnFrames = 300;
+const int32_t c_idleFrames = 120;
+const int32_t c_allocationsPerFrame = 2000;
+
+const wchar_t* c_script =
+	L"live = {}\n"
+	L"function churn(n)\n"
+	L"	for i = 1, n do\n"
+	L"		local t = { x = i, y = traktor.Vector4(i, i, i, 0) }\n"
+	L"		live[(i % 64) + 1] = t\n"
+	L"	end\n"
+	L"end\n";
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.script.test.CaseScriptCollect", 0, CaseScriptCollect, traktor::test::Case)
+
+void CaseScriptCollect::run()
+{
+	Ref< ScriptManagerLua > scriptManager = new ScriptManagerLua();
+
+	OrderedClassRegistrar registrar;
+	BoxedClassFactory().createClasses(&registrar);
+	registrar.registerClassesInOrder(scriptManager);
+	scriptManager->completeRegistration();
+
+	Ref< IScriptBlob > scriptBlob = ScriptCompilerLua().compile(L"CaseScriptCollect", c_script, nullptr);
+	CASE_ASSERT(scriptBlob);
+	if (!scriptBlob)
+		return;
+
+	Ref< IScriptContext > scriptContext = scriptManager->createContext(false);
+	CASE_ASSERT(scriptContext);
+	if (!scriptContext)
+		return;
+
+	const bool loaded = scriptContext->load(scriptBlob);
+	CASE_ASSERT(loaded);
+	if (!loaded)
+		return;
+
+	scriptManager->collectGarbage(true);
+
+	// Allocate garbage each frame and collect incrementally, as
+	// application does; measure time spent collecting each frame.
+	ScriptStatistics statistics;
+	double collectTotal = 0.0;
+	double collectWorst = 0.0;
+	uint32_t memoryPeak = 0;
+	uint32_t stepsTotal = 0;
+
+	for (int32_t i = 0; i < c_churnFrames; ++i)
+	{
+		const Any argv[] = { Any::fromInt32(c_allocationsPerFrame) };
+		scriptContext->executeFunction("churn", sizeof_array(argv), argv);
+
+		Timer timer;
+		scriptManager->collectGarbage(false);
+		const double duration = timer.getElapsedTime();
+
+		scriptManager->getStatistics(statistics);
+		collectTotal += duration;
+		collectWorst = std::max(collectWorst, duration);
+		memoryPeak = std::max(memoryPeak, statistics.memoryUsage);
+		stepsTotal += statistics.collectSteps;
+	}
+
+	const uint32_t cyclesChurn = statistics.collectCycles;
+
+	log::info << L"Script collect, churn; " << collectTotal * 1e6 / c_churnFrames << L" us/frame average, " << collectWorst * 1e6 << L" us worst, " << double(stepsTotal) / c_churnFrames << L" step(s)/frame, " << cyclesChurn << L" cycle(s), " << memoryPeak / 1024 << L" KiB peak" << Endl;
+
+	// Collector must have kept up with allocation.
+	CASE_ASSERT(cyclesChurn > 0);
+
+	// Without new allocations debt is paid and remaining cycle finished
+	// within a few frames, after which no more work is performed.
+	for (int32_t i = 0; i < c_idleFrames; ++i)
+	{
+		scriptManager->collectGarbage(false);
+		scriptManager->getStatistics(statistics);
+	}
+	CASE_ASSERT_EQUAL(statistics.collectSteps, 0u);
+	CASE_ASSERT(statistics.memoryUsage <= memoryPeak);
+
+	scriptContext->destroy();
+	scriptManager->destroy();
+}
+
+}
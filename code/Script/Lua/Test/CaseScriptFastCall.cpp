@@ -0,0 +1,157 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Script/Lua/Test/CaseScriptFastCall.h"
+
+#include "Core/Class/AutoRuntimeClass.h"
+#include "Core/Class/OrderedClassRegistrar.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/TString.h"
+#include "Core/Timer/Timer.h"
+#include "Script/IScriptBlob.h"
+#include "Script/IScriptContext.h"
+#include "Script/Lua/ScriptCompilerLua.h"
+#include "Script/Lua/ScriptManagerLua.h"
+
+namespace traktor::script::test
+{
+
+class FastCall_Target : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	int32_t integer(int32_t a) { return a + 1; }
+
+	float number2(float a, float b) const { return a * b; }
+
+	float number3(float a, float b, float c) const { return a * b * c; }
+
+	bool object(const FastCall_Target* other) const { return other == this; }
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.script.test.FastCall_Target", FastCall_Target, Object)
+
+namespace
+{
+
+const int32_t c_iterations = 1000000;
+
+// Overloaded methods are dispatched through Any, thus "Any" suffixed
+// methods measure the regular path for same native methods.
+const wchar_t* c_script =
+	L"function mismatch(t)\n"
+	L"	return t:number2(2, 3, 4)\n"
+	L"end\n"
+	L"function fraction(t, a)\n"
+	L"	return t:integer(a) - t:integerAny(a)\n"
+	L"end\n"
+	L"function integer(t, n)\n"
+	L"	local s = 0\n"
+	L"	for i = 1, n do s = s + t:integer(i) end\n"
+	L"	return s\n"
+	L"end\n"
+	L"function integerAny(t, n)\n"
+	L"	local s = 0\n"
+	L"	for i = 1, n do s = s + t:integerAny(i) end\n"
+	L"	return s\n"
+	L"end\n"
+	L"function number2(t, n)\n"
+	L"	local s = 0\n"
+	L"	for i = 1, n do s = s + t:number2(i, 0.5) end\n"
+	L"	return s\n"
+	L"end\n"
+	L"function number2Any(t, n)\n"
+	L"	local s = 0\n"
+	L"	for i = 1, n do s = s + t:number2Any(i, 0.5) end\n"
+	L"	return s\n"
+	L"end\n"
+	L"function object(t, n)\n"
+	L"	local s = 0\n"
+	L"	for i = 1, n do if t:object(t) then s = s + 1 end end\n"
+	L"	return s\n"
+	L"end\n"
+	L"function objectAny(t, n)\n"
+	L"	local s = 0\n"
+	L"	for i = 1, n do if t:objectAny(t) then s = s + 1 end end\n"
+	L"	return s\n"
+	L"end\n";
+
+double measure(IScriptContext* scriptContext, const char* function, FastCall_Target* target)
+{
+	const Any argv[] = { Any::fromObject(target), Any::fromInt32(c_iterations) };
+	Timer timer;
+	scriptContext->executeFunction(function, sizeof_array(argv), argv);
+	return timer.getElapsedTime() * 1e9 / c_iterations;
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.script.test.CaseScriptFastCall", 0, CaseScriptFastCall, traktor::test::Case)
+
+void CaseScriptFastCall::run()
+{
+	Ref< AutoRuntimeClass< FastCall_Target > > runtimeClass = new AutoRuntimeClass< FastCall_Target >();
+	runtimeClass->addMethod("integer", &FastCall_Target::integer);
+	runtimeClass->addMethod("integerAny", &FastCall_Target::integer);
+	runtimeClass->addMethod("integerAny", &FastCall_Target::number2);
+	runtimeClass->addMethod("number2", &FastCall_Target::number2);
+	runtimeClass->addMethod("number2Any", &FastCall_Target::number2);
+	runtimeClass->addMethod("number2Any", &FastCall_Target::number3);
+	runtimeClass->addMethod("object", &FastCall_Target::object);
+	runtimeClass->addMethod("objectAny", &FastCall_Target::object);
+	runtimeClass->addMethod("objectAny", &FastCall_Target::number2);
+
+	Ref< ScriptManagerLua > scriptManager = new ScriptManagerLua();
+	scriptManager->registerClass(runtimeClass);
+	scriptManager->completeRegistration();
+
+	Ref< IScriptBlob > scriptBlob = ScriptCompilerLua().compile(L"CaseScriptFastCall", c_script, nullptr);
+	CASE_ASSERT(scriptBlob);
+	if (!scriptBlob)
+		return;
+
+	Ref< IScriptContext > scriptContext = scriptManager->createContext(false);
+	CASE_ASSERT(scriptContext);
+	if (!scriptContext)
+		return;
+
+	const bool loaded = scriptContext->load(scriptBlob);
+	CASE_ASSERT(loaded);
+	if (!loaded)
+		return;
+
+	Ref< FastCall_Target > target = new FastCall_Target();
+
+	// Extra arguments are left to regular dispatch, which ignores them.
+	{
+		const Any argv[] = { Any::fromObject(target) };
+		CASE_ASSERT_EQUAL(scriptContext->executeFunction("mismatch", sizeof_array(argv), argv).getFloat(), 6.0f);
+	}
+
+	// Non-integral numbers must be converted same as through regular dispatch.
+	for (double a : { 2.0, 2.5, -2.5 })
+	{
+		const Any argv[] = { Any::fromObject(target), Any::fromDouble(a) };
+		CASE_ASSERT_EQUAL(scriptContext->executeFunction("fraction", sizeof_array(argv), argv).getInt32(), 0);
+	}
+
+	// Measure per-call time through Lua trampolines and through Any.
+	const char* functions[] = { "integer", "number2", "object" };
+	for (auto function : functions)
+	{
+		const double fastTime = measure(scriptContext, function, target);
+		const double anyTime = measure(scriptContext, (std::string(function) + "Any").c_str(), target);
+		log::info << L"Script fast call, " << mbstows(function) << L"; " << anyTime << L" ns (any), " << fastTime << L" ns (fast)" << Endl;
+	}
+
+	scriptContext->destroy();
+	scriptManager->destroy();
+}
+
+}
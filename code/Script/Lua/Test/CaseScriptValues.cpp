@@ -0,0 +1,112 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Script/Lua/Test/CaseScriptValues.h"
+
+#include "Core/Class/BoxedClassFactory.h"
+#include "Core/Class/OrderedClassRegistrar.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/TString.h"
+#include "Core/Timer/Timer.h"
+#include "Script/IScriptBlob.h"
+#include "Script/IScriptContext.h"
+#include "Script/Lua/ScriptCompilerLua.h"
+#include "Script/Lua/ScriptManagerLua.h"
+
+namespace traktor::script::test
+{
+namespace
+{
+
+const int32_t c_iterations = 1000000;
+
+const wchar_t* c_script =
+	L"function values()\n"
+	L"	local a = traktor.Vector4(1, 2, 3, 0)\n"
+	L"	local b = a + traktor.Vector4(1, 1, 1, 0)\n"
+	L"	if b.x ~= 2 or b.y ~= 3 or b.z ~= 4 then return false end\n"
+	L"	if not (b == traktor.Vector4(2, 3, 4, 0)) then return false end\n"
+	L"	if a:dot(a) ~= 14 then return false end\n"
+	L"	traktor.Vector4.sum = function(self) return self.x + self.y + self.z end\n"
+	L"	if a:sum() ~= 6 then return false end\n"
+	L"	return true\n"
+	L"end\n"
+	L"function arithmetic(n)\n"
+	L"	local a = traktor.Vector4(1, 2, 3, 0)\n"
+	L"	local b = traktor.Vector4(0.5, 0.5, 0.5, 0)\n"
+	L"	for i = 1, n do a = a + b * 0.5 end\n"
+	L"	return a.x\n"
+	L"end\n"
+	L"function field(n)\n"
+	L"	local a = traktor.Vector4(1, 2, 3, 0)\n"
+	L"	local s = 0\n"
+	L"	for i = 1, n do a.x = s; s = s + a.y end\n"
+	L"	return s\n"
+	L"end\n"
+	L"function native(n)\n"
+	L"	local a = traktor.Vector4(1, 2, 3, 0)\n"
+	L"	local s = 0\n"
+	L"	for i = 1, n do s = s + a:dot(a) end\n"
+	L"	return s\n"
+	L"end\n";
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.script.test.CaseScriptValues", 0, CaseScriptValues, traktor::test::Case)
+
+void CaseScriptValues::run()
+{
+	Ref< ScriptManagerLua > scriptManager = new ScriptManagerLua();
+
+	OrderedClassRegistrar registrar;
+	BoxedClassFactory().createClasses(&registrar);
+	registrar.registerClassesInOrder(scriptManager);
+	scriptManager->completeRegistration();
+
+	Ref< IScriptBlob > scriptBlob = ScriptCompilerLua().compile(L"CaseScriptValues", c_script, nullptr);
+	CASE_ASSERT(scriptBlob);
+	if (!scriptBlob)
+		return;
+
+	Ref< IScriptContext > scriptContext = scriptManager->createContext(false);
+	CASE_ASSERT(scriptContext);
+	if (!scriptContext)
+		return;
+
+	const bool loaded = scriptContext->load(scriptBlob);
+	CASE_ASSERT(loaded);
+	if (!loaded)
+		return;
+
+	// Inline values must behave as boxed values; also methods added
+	// to class after registration must be reachable.
+	CASE_ASSERT(scriptContext->executeFunction("values").getBoolean());
+
+	// Measure per operation cost of math values.
+	const char* functions[] = { "arithmetic", "field", "native" };
+	for (auto function : functions)
+	{
+		ScriptStatistics before, after;
+		scriptManager->collectGarbage(true);
+		scriptManager->getStatistics(before);
+
+		const Any argv[] = { Any::fromInt32(c_iterations) };
+		Timer timer;
+		scriptContext->executeFunction(function, sizeof_array(argv), argv);
+		const double duration = timer.getElapsedTime();
+
+		scriptManager->getStatistics(after);
+
+		log::info << L"Script values, " << mbstows(function) << L"; " << duration * 1e9 / c_iterations << L" ns/op, " << double(after.allocations - before.allocations) / c_iterations << L" Lua allocation(s)/op" << Endl;
+	}
+
+	scriptContext->destroy();
+	scriptManager->destroy();
+}
+
+}
@@ -6,10 +6,12 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Math/Const.h"
 #include "Core/Thread/Job.h"
 #include "Core/Thread/JobManager.h"
 #include "Drawing/Image.h"
 #include "Drawing/PixelFormat.h"
+#include "Model/Model.h"
 #include "Shape/Editor/Bake/GBuffer.h"
 #include "Shape/Editor/Bake/BakeOperationData.h"
 #include "Shape/Editor/Bake/Local/RayTracerLocal.h"
@@ -19,7 +21,7 @@ namespace traktor::shape
 	namespace
 	{
 
-const Scalar p(1.0f / (2.0f * PI));
+const Scalar c_emissiveBoost(2.0f);
 const Scalar c_epsilonOffset(0.1f);
 
 // class WrappedSHFunction : public render::SHFunction
@@ -68,10 +70,12 @@ bool RayTracerLocal::create(const BakeOperationData* configuration)
 
 void RayTracerLocal::destroy()
 {
+	m_environment = nullptr;
 }
 
 void RayTracerLocal::addEnvironment(const IProbe* environment)
 {
+	m_environment = environment;
 }
 
 void RayTracerLocal::addLight(const Light& light)
@@ -98,13 +102,14 @@ void RayTracerLocal::addModel(const model::Model* model, const Transform& transf
 
 		auto& s = m_surfaces.push_back();
 		const auto& material = model->getMaterial(polygon.getMaterial());
-		s.albedo = material.getColor();
+		s.albedo = material.getColor().linear();
+		s.emissive = material.getEmissive();
 	}
 }
 
 void RayTracerLocal::commit()
 {
-	m_sah.build(m_windings);
+	m_bvh.build(m_windings);
 }
 
 Ref< render::SHCoeffs > RayTracerLocal::traceProbe(const Vector4& position, const Vector4& size) const
@@ -153,145 +158,84 @@ Ref< render::SHCoeffs > RayTracerLocal::traceProbe(const Vector4& position, cons
 
 void RayTracerLocal::traceLightmap(const model::Model* model, const GBuffer* gbuffer, drawing::Image* lightmapDiffuse, const int32_t region[4]) const
 {
-}
-
-Color4f RayTracerLocal::traceRay(const Vector4& position, const Vector4& direction) const
-{
-	return Color4f(0.0f, 0.0f, 0.0f, 1.0f);
-}
-
-/*
-Ref< drawing::Image > RayTracerLocal::traceDirect(const GBuffer* gbuffer) const
-{
-    int32_t width = gbuffer->getWidth();
-    int32_t height = gbuffer->getHeight();
+	RandomGeometry random;
 
 	AlignedVector< Light > lights;
 	cullLights(gbuffer, lights);
 
-    Ref< drawing::Image > lightmapDirect = new drawing::Image(drawing::PixelFormat::getRGBAF32(), width, height);
-    lightmapDirect->clear(Color4f(0.0f, 0.0f, 0.0f, 0.0f));
-
-    RefArray< Job > jobs;
-    for (int32_t ty = 0; ty < height; ty += 16)
-    {
-        for (int32_t tx = 0; tx < width; tx += 16)
-        {
-            auto job = JobManager::getInstance().add([&, tx, ty]() {
-                SahTree::QueryCache sahCache;
-                RandomGeometry random;
-
-                for (int32_t y = ty; y < ty + 16; ++y)
-                {
-                    for (int32_t x = tx; x < tx + 16; ++x)
-                    {
-                        const auto& elm = gbuffer->get(x, y);
-                        if (elm.polygon == model::c_InvalidIndex)
-                            continue;
-
-                        Color4f direct = sampleAnalyticalLights(
-                            random,
-                            sahCache,
-							lights,
-                            elm.position,
-                            elm.normal,
-                            m_configuration->getShadowSampleCount(),
-                            m_configuration->getPointLightShadowRadius()
-                        );
-
-                        lightmapDirect->setPixel(x, y, direct.rgb1());
-                    }
-                }
-            });
-            if (!job)
-                return nullptr;
-
-            jobs.push_back(job);
-        }
-    }
-    while (!jobs.empty())
-    {
-        jobs.back()->wait();
-        jobs.pop_back();
-    }
-
-    return lightmapDirect;
+	const Scalar ambientOcclusion(m_configuration->getAmbientOcclusionFactor());
+
+	for (int32_t y = region[1]; y < region[3]; ++y)
+	{
+		for (int32_t x = region[0]; x < region[2]; ++x)
+		{
+			const auto& e = gbuffer->get(x, y);
+			if (e.polygon == model::c_InvalidIndex)
+				continue;
+
+			const auto& originMaterial = model->getMaterial(model->getPolygon(e.polygon).getMaterial());
+			const Color4f emittance = originMaterial.getColor().linear() * c_emissiveBoost * Scalar(originMaterial.getEmissive());
+
+			// Trace direct and indirect illumination.
+			const Color4f direct = sampleAnalyticalLights(
+				random,
+				lights,
+				e.position,
+				e.normal,
+				Light::LmDirect,
+				m_configuration->getShadowSampleCount(),
+				m_configuration->getPointLightShadowRadius()
+			);
+			const Color4f incoming = direct + traceIndirect(random, e.position, e.normal);
+
+			// Trace ambient occlusion.
+			Scalar occlusion = 1.0_simd;
+			if (ambientOcclusion > Scalar(FUZZY_EPSILON))
+				occlusion = (1.0_simd - ambientOcclusion) + ambientOcclusion * traceOcclusion(random, e.position, e.normal, 1.0f);
+
+			// Trace sky occlusion.
+			const Scalar skyOcclusion = power(traceOcclusion(random, e.position, Vector4(0.0f, 1.0f, 0.0f), 1000.0f), 0.25_simd);
+
+			// Combine and write final lumel.
+			const Color4f lightmapColor = emittance + incoming * occlusion;
+			lightmapDiffuse->setPixel(x, y, lightmapColor.rgb0() + Color4f(0.0f, 0.0f, 0.0f, skyOcclusion));
+		}
+	}
 }
 
-Ref< drawing::Image > RayTracerLocal::traceIndirect(const GBuffer* gbuffer) const
+Color4f RayTracerLocal::traceRay(const Vector4& position, const Vector4& direction) const
 {
-    int32_t width = gbuffer->getWidth();
-    int32_t height = gbuffer->getHeight();
+	RandomGeometry random;
 
-	AlignedVector< Light > lights;
-	cullLights(gbuffer, lights);
+	TriangleBvh::QueryResult result;
+	if (!m_bvh.queryClosestIntersection(position, direction, 10000.0f, -1, result))
+	{
+		// Nothing hit, sample sky if available else it's all black.
+		if (m_environment)
+			return m_environment->sampleRadiance(direction);
+		else
+			return Color4f(0.0f, 0.0f, 0.0f, 1.0f);
+	}
 
-    Ref< drawing::Image > lightmapIndirect = new drawing::Image(drawing::PixelFormat::getRGBAF32(), width, height);
-    lightmapIndirect->clear(Color4f(0.0f, 0.0f, 0.0f, 0.0f));
-
-    RefArray< Job > jobs;
-    for (int32_t ty = 0; ty < height; ty += 16)
-    {
-        for (int32_t tx = 0; tx < width; tx += 16)
-        {
-            auto job = JobManager::getInstance().add([&, tx, ty]() {
-                SahTree::QueryResult result;
-                SahTree::QueryCache sahCache;
-                RandomGeometry random;
-
-                for (int32_t y = ty; y < ty + 16; ++y)
-                {
-                    for (int32_t x = tx; x < tx + 16; ++x)
-                    {
-                        const auto& elm = gbuffer->get(x, y);
-                        if (elm.polygon == model::c_InvalidIndex)
-                            continue;
-
-                        Color4f indirect(0.0f, 0.0f, 0.0f, 0.0f);
-                        for (uint32_t i = 0; i < m_configuration->getIndirectSampleCount(); ++i)
-                        {
-                            Vector4 direction = random.nextHemi(elm.normal);
-                            if (m_sah.queryClosestIntersection(elm.position + elm.normal * c_epsilonOffset, direction, m_maxDistance, -1, result, sahCache))
-                            {
-								Scalar f = attenuation(result.distance);
-								if (f <= 0.0f)
-									continue;
-
-                                Scalar ct = dot3(elm.normal, direction);
-                                Color4f brdf = m_surfaces[result.index].albedo / Scalar(PI);
-                                Color4f incoming = sampleAnalyticalLights(
-                                    random,
-                                    sahCache,
-									lights,
-                                    result.position,
-                                    result.normal,
-                                    1,
-                                    0.0f
-                                );
-                                indirect += brdf * incoming * f * ct / p;
-                            }
-                        }
-                        indirect /= Scalar(m_configuration->getIndirectSampleCount());
-
-                        lightmapIndirect->setPixel(x, y, indirect.rgb1());
-                    }
-                }
-            });
-            if (!job)
-                return nullptr;
-
-            jobs.push_back(job);
-        }
-    }
-    while (!jobs.empty())
-    {
-        jobs.back()->wait();
-        jobs.pop_back();
-    }
-
-    return lightmapIndirect;
+	// Polygons are double sided; use normal facing ray.
+	const Vector4 hitNormal = (dot3(result.normal, direction) > 0.0_simd) ? -result.normal : result.normal;
+	const Surface& hitSurface = m_surfaces[result.index];
+
+	// Calculate lighting at hit.
+	const Color4f emittance = hitSurface.albedo * c_emissiveBoost * Scalar(hitSurface.emissive);
+	const Color4f direct = sampleAnalyticalLights(
+		random,
+		m_lights,
+		result.position,
+		hitNormal,
+		Light::LmDirect | Light::LmIndirect,
+		m_configuration->getShadowSampleCount(),
+		m_configuration->getPointLightShadowRadius()
+	);
+	const Color4f incoming = direct + traceIndirect(random, result.position, hitNormal);
+	return emittance + incoming * hitSurface.albedo;
 }
-*/
+
 void RayTracerLocal::cullLights(const GBuffer* gbuffer, AlignedVector< Light >& outLights) const
 {
 	for (auto light : m_lights)
@@ -323,10 +267,10 @@ void RayTracerLocal::cullLights(const GBuffer* gbuffer, AlignedVector< Light >&
 
 Color4f RayTracerLocal::sampleAnalyticalLights(
     RandomGeometry& random,
-    SahTree::QueryCache& sahCache,
     const AlignedVector< Light >& lights,
     const Vector4& origin,
     const Vector4& normal,
+    uint8_t mask,
     uint32_t shadowSampleCount,
     float pointLightShadowRadius
  ) const
@@ -334,6 +278,9 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 	Color4f contribution(0.0f, 0.0f, 0.0f, 0.0f);
 	for (const auto& light : lights)
 	{
+		if ((light.mask & mask) == 0)
+			continue;
+
 		switch (light.type)
 		{
 		case Light::LtDirectional:
@@ -341,12 +288,11 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 				Scalar phi = dot3(normal, -light.direction);
 				if (phi > 0.0f)
 				{
-					if (!m_sah.queryAnyIntersection(
+					if (!m_bvh.queryAnyIntersection(
 						origin + normal * c_epsilonOffset,
 						-light.direction,
 						m_maxDistance,
-						-1,
-						sahCache
+						-1
 					))
 					{
 						contribution += light.color * phi;
@@ -370,34 +316,7 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 				if (f <= 0.0f)
 					break;
 
-				Scalar shadowAttenuate(1.0f);
-
-				if (shadowSampleCount > 0)
-				{
-					Vector4 u, v;
-					orthogonalFrame(lightDirection, u, v);
-
-					int32_t shadowCount = 0;
-					for (uint32_t j = 0; j < shadowSampleCount; ++j)
-					{
-						float a = 0.0f, b = 0.0f;
-						if (shadowSampleCount > 1)
-						{
-							do
-							{
-								a = random.nextFloat() * 2.0f - 1.0f;
-								b = random.nextFloat() * 2.0f - 1.0f;
-							}
-							while ((a * a) + (b * b) > 1.0f);
-						}
-
-						Vector4 shadowDirection = (light.position + u * Scalar(a * pointLightShadowRadius) + v * Scalar(b * pointLightShadowRadius) - origin).xyz0();
-
-						if (m_sah.queryAnyIntersection(origin + normal * c_epsilonOffset, shadowDirection.normalized(), lightDistance - c_epsilonOffset, -1, sahCache))
-							shadowCount++;
-					}
-					shadowAttenuate = Scalar(1.0f - float(shadowCount) / shadowSampleCount);
-				}
+				const Scalar shadowAttenuate = traceShadow(random, origin, normal, light.position, lightDirection, lightDistance, shadowSampleCount, pointLightShadowRadius);
 
 				contribution += light.color * phi * min(f, Scalar(1.0f)) * shadowAttenuate;
 			}
@@ -423,34 +342,7 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 				if (k2 <= 0.0f)
 					break;
 
-				Scalar shadowAttenuate(1.0f);
-
-				if (shadowSampleCount > 0)
-				{
-					Vector4 u, v;
-					orthogonalFrame(-lightToPoint, u, v);
-
-					int32_t shadowCount = 0;
-					for (uint32_t j = 0; j < shadowSampleCount; ++j)
-					{
-						float a = 0.0f, b = 0.0f;
-						if (shadowSampleCount > 1)
-						{
-							do
-							{
-								a = random.nextFloat() * 2.0f - 1.0f;
-								b = random.nextFloat() * 2.0f - 1.0f;
-							}
-							while ((a * a) + (b * b) > 1.0f);
-						}
-
-						Vector4 shadowDirection = (light.position + u * Scalar(a * pointLightShadowRadius) + v * Scalar(b * pointLightShadowRadius) - origin).xyz0();
-
-						if (m_sah.queryAnyIntersection(origin + normal * c_epsilonOffset, shadowDirection.normalized(), lightDistance - c_epsilonOffset, -1, sahCache))
-							shadowCount++;
-					}
-					shadowAttenuate = Scalar(1.0f - float(shadowCount) / shadowSampleCount);
-				}
+				const Scalar shadowAttenuate = traceShadow(random, origin, normal, light.position, -lightToPoint, lightDistance, shadowSampleCount, pointLightShadowRadius);
 
 				contribution += light.color * k0 * k1 * k2 * shadowAttenuate;
 			}
@@ -460,4 +352,159 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 	return contribution;
 }
 
+Color4f RayTracerLocal::traceIndirect(
+	RandomGeometry& random,
+	const Vector4& origin,
+	const Vector4& normal
+) const
+{
+	const uint32_t sampleCount = m_configuration->getSecondarySampleCount();
+	if (sampleCount == 0)
+		return Color4f(0.0f, 0.0f, 0.0f, 0.0f);
+
+	// Trace hemisphere in packets, all rays originate from same point.
+	const Vector4 traceOrigin = origin + normal * c_epsilonOffset;
+
+	Vector4 origins[TriangleBvh::PacketSize];
+	Vector4 directions[TriangleBvh::PacketSize];
+	float maxDistances[TriangleBvh::PacketSize];
+	TriangleBvh::QueryResult results[TriangleBvh::PacketSize];
+
+	Color4f color(0.0f, 0.0f, 0.0f, 0.0f);
+	for (uint32_t i = 0; i < sampleCount; i += TriangleBvh::PacketSize)
+	{
+		const uint32_t count = std::min< uint32_t >(sampleCount - i, TriangleBvh::PacketSize);
+		for (uint32_t j = 0; j < TriangleBvh::PacketSize; ++j)
+		{
+			origins[j] = traceOrigin;
+			directions[j] = random.nextHemi(normal);
+			maxDistances[j] = m_configuration->getMaxPathDistance();
+		}
+
+		const uint32_t hits = m_bvh.queryClosestIntersection(origins, directions, maxDistances, -1, results);
+		for (uint32_t j = 0; j < count; ++j)
+		{
+			if ((hits & (1 << j)) == 0)
+			{
+				// Nothing hit, sample sky if available.
+				if (m_environment)
+					color += m_environment->sampleRadiance(directions[j]);
+				continue;
+			}
+
+			const auto& result = results[j];
+			const Vector4 hitNormal = (dot3(result.normal, directions[j]) > 0.0_simd) ? -result.normal : result.normal;
+			const Surface& hitSurface = m_surfaces[result.index];
+
+			const Color4f emittance = hitSurface.albedo * c_emissiveBoost * Scalar(hitSurface.emissive);
+			const Scalar cosPhi = clamp(dot3(-directions[j], hitNormal), 0.0_simd, 1.0_simd);
+			const Color4f direct = sampleAnalyticalLights(
+				random,
+				m_lights,
+				result.position,
+				hitNormal,
+				Light::LmIndirect,
+				1,
+				0.0f
+			);
+
+			color += emittance / max(result.distance, 1.0_simd) + direct * hitSurface.albedo * cosPhi;
+		}
+	}
+
+	return color / Scalar((float)sampleCount);
+}
+
+Scalar RayTracerLocal::traceOcclusion(
+	RandomGeometry& random,
+	const Vector4& origin,
+	const Vector4& normal,
+	float maxDistance
+) const
+{
+	const uint32_t sampleCount = m_configuration->getShadowSampleCount();
+	if (sampleCount == 0)
+		return Scalar(1.0f);
+
+	const Vector4 traceOrigin = origin + normal * c_epsilonOffset;
+
+	Vector4 origins[TriangleBvh::PacketSize];
+	Vector4 directions[TriangleBvh::PacketSize];
+	float maxDistances[TriangleBvh::PacketSize];
+
+	int32_t occludedCount = 0;
+	for (uint32_t i = 0; i < sampleCount; i += TriangleBvh::PacketSize)
+	{
+		const uint32_t count = std::min< uint32_t >(sampleCount - i, TriangleBvh::PacketSize);
+		for (uint32_t j = 0; j < TriangleBvh::PacketSize; ++j)
+		{
+			origins[j] = traceOrigin;
+			directions[j] = random.nextHemi(normal);
+			maxDistances[j] = maxDistance;
+		}
+
+		const uint32_t occluded = m_bvh.queryAnyIntersection(origins, directions, maxDistances, -1) & ((1 << count) - 1);
+		for (uint32_t j = 0; j < count; ++j)
+			occludedCount += (occluded >> j) & 1;
+	}
+
+	return Scalar(1.0f - float(occludedCount) / sampleCount);
+}
+
+Scalar RayTracerLocal::traceShadow(
+	RandomGeometry& random,
+	const Vector4& origin,
+	const Vector4& normal,
+	const Vector4& lightPosition,
+	const Vector4& lightDirection,
+	const Scalar& lightDistance,
+	uint32_t shadowSampleCount,
+	float pointLightShadowRadius
+) const
+{
+	if (shadowSampleCount == 0)
+		return Scalar(1.0f);
+
+	Vector4 u, v;
+	orthogonalFrame(lightDirection, u, v);
+
+	// Trace shadow rays in packets, all rays originate from same point thus are coherent.
+	const Vector4 shadowOrigin = origin + normal * c_epsilonOffset;
+	const float shadowDistance = lightDistance - c_epsilonOffset;
+
+	Vector4 origins[TriangleBvh::PacketSize];
+	Vector4 directions[TriangleBvh::PacketSize];
+	float maxDistances[TriangleBvh::PacketSize];
+
+	int32_t shadowCount = 0;
+	for (uint32_t j = 0; j < shadowSampleCount; j += TriangleBvh::PacketSize)
+	{
+		const uint32_t count = std::min< uint32_t >(shadowSampleCount - j, TriangleBvh::PacketSize);
+		for (uint32_t k = 0; k < TriangleBvh::PacketSize; ++k)
+		{
+			float a = 0.0f, b = 0.0f;
+			if (shadowSampleCount > 1 && k < count)
+			{
+				do
+				{
+					a = random.nextFloat() * 2.0f - 1.0f;
+					b = random.nextFloat() * 2.0f - 1.0f;
+				}
+				while ((a * a) + (b * b) > 1.0f);
+			}
+
+			const Vector4 shadowDirection = (lightPosition + u * Scalar(a * pointLightShadowRadius) + v * Scalar(b * pointLightShadowRadius) - origin).xyz0();
+			origins[k] = shadowOrigin;
+			directions[k] = shadowDirection.normalized();
+			maxDistances[k] = shadowDistance;
+		}
+
+		const uint32_t occluded = m_bvh.queryAnyIntersection(origins, directions, maxDistances, -1) & ((1 << count) - 1);
+		for (uint32_t k = 0; k < count; ++k)
+			shadowCount += (occluded >> k) & 1;
+	}
+
+	return Scalar(1.0f - float(shadowCount) / shadowSampleCount);
+}
+
 }
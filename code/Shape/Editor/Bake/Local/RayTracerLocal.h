@@ -9,7 +9,8 @@
 #pragma once
 
 #include "Core/Math/RandomGeometry.h"
-#include "Core/Math/SahTree.h"
+#include "Core/Math/TriangleBvh.h"
+#include "Shape/Editor/Bake/IProbe.h"
 #include "Shape/Editor/Bake/IRayTracer.h"
 
 namespace traktor::shape
@@ -44,10 +45,12 @@ private:
 	struct Surface
 	{
 		Color4f albedo;
+		float emissive;
 	};
 
 	const BakeOperationData* m_configuration;
-	SahTree m_sah;
+	Ref< const IProbe > m_environment;
+	TriangleBvh m_bvh;
 	AlignedVector< Light > m_lights;
 	AlignedVector< Winding3 > m_windings;
 	AlignedVector< Surface > m_surfaces;
@@ -57,13 +60,37 @@ private:
 
 	Color4f sampleAnalyticalLights(
         RandomGeometry& random,
-        SahTree::QueryCache& sahCache,
         const AlignedVector< Light >& lights,
         const Vector4& origin,
         const Vector4& normal,
+        uint8_t mask,
         uint32_t shadowSampleCount,
         float pointLightShadowRadius
     ) const;
+
+	Color4f traceIndirect(
+		RandomGeometry& random,
+		const Vector4& origin,
+		const Vector4& normal
+	) const;
+
+	Scalar traceOcclusion(
+		RandomGeometry& random,
+		const Vector4& origin,
+		const Vector4& normal,
+		float maxDistance
+	) const;
+
+	Scalar traceShadow(
+		RandomGeometry& random,
+		const Vector4& origin,
+		const Vector4& normal,
+		const Vector4& lightPosition,
+		const Vector4& lightDirection,
+		const Scalar& lightDistance,
+		uint32_t shadowSampleCount,
+		float pointLightShadowRadius
+	) const;
 };
 
 }
@@ -61,6 +61,7 @@ AudioChannel::AudioChannel(uint32_t id, uint32_t hwSampleRate, uint32_t hwFrameS
 ,	m_pitch(1.0f)
 ,	m_playing(false)
 ,	m_allowRepeat(false)
+,	m_virtual(false)
 ,	m_outputSamplesIn(0)
 {
 	const uint32_t outputSamplesCount = hwFrameSamples * c_outputSamplesBlockCount;
@@ -119,6 +120,11 @@ bool AudioChannel::isPlaying() const
 	return m_playing;
 }
 
+bool AudioChannel::isVirtual() const
+{
+	return m_virtual;
+}
+
 void AudioChannel::stop()
 {
 	m_stateSoundFifo.put({});
@@ -177,28 +183,9 @@ bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
 {
 	StateSound& ss = m_stateSound;
 
-	// Read pending sound state from fifo.
-	{
-		StateSound next;
-		if (m_stateSoundFifo.get(next))
-			ss = next;
-	}
-
-	if (!ss.buffer || !ss.cursor)
+	if (!prepareCursor())
 		return false;
 
-	if (!m_allowRepeat)
-		ss.cursor->disableRepeat();
-
-	// Push pending parameters.
-	StateParameter& sp = m_stateParameters.read();
-	for (uint32_t i = 0; i < sp.set.size(); ++i)
-		ss.cursor->setParameter(sp.set[i].first, sp.set[i].second);
-	sp.set.clear();
-
-	const IAudioBuffer* soundBuffer = ss.buffer;
-	T_ASSERT(soundBuffer);
-
 	// Remove old output samples.
 	if (m_outputSamplesIn >= m_hwFrameSamples)
 	{
@@ -218,45 +205,8 @@ bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
 	{
 		// Request sound block from buffer.
 		AudioBlock block = { { 0 }, m_hwFrameSamples, 0, 0 };
-		if (!soundBuffer->getBlock(ss.cursor, mixer, block))
-		{
-			// No more blocks from sound buffer.
-			if (m_allowRepeat && ss.repeat)
-			{
-				ss.cursor->reset();
-
-				// Skip samples when repeating.
-				uint32_t skip = ss.repeatFrom;
-				while (skip > 0)
-				{
-					AudioBlock skipBlock = { { 0 }, m_hwFrameSamples, 0, 0 };
-					if (soundBuffer->getBlock(ss.cursor, mixer, skipBlock))
-						skip -= min(skip, skipBlock.samplesCount);
-					else
-					{
-						ss.buffer = nullptr;
-						ss.cursor = nullptr;
-						m_playing = false;
-						return false;
-					}
-				}
-
-				if (!soundBuffer->getBlock(ss.cursor, mixer, block))
-				{
-					ss.buffer = nullptr;
-					ss.cursor = nullptr;
-					m_playing = false;
-					return false;
-				}
-			}
-			else
-			{
-				ss.buffer = nullptr;
-				ss.cursor = nullptr;
-				m_playing = false;
-				return false;
-			}
-		}
+		if (!readBlock(mixer, block, false))
+			return false;
 
 		// We might get a null block; does not indicate end of stream.
 		if (!block.samplesCount || !block.sampleRate || !block.maxChannel)
@@ -339,4 +289,109 @@ bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
 	return true;
 }
 
+bool AudioChannel::advance(const IAudioMixer* mixer)
+{
+	if (!prepareCursor())
+		return false;
+
+	// Discard pending output samples as they are stale once channel becomes audible.
+	m_outputSamplesIn = 0;
+
+	// Skip, without decoding, filtering, resampling nor mixing, source
+	// samples corresponding to one hardware frame.
+	uint32_t advanced = 0;
+	while (advanced < m_hwFrameSamples)
+	{
+		AudioBlock block = { { 0 }, m_hwFrameSamples, 0, 0 };
+		if (!readBlock(mixer, block, true))
+			return false;
+
+		// Null block; stream isn't ready, try again next frame.
+		if (!block.samplesCount || !block.sampleRate || !block.maxChannel)
+			return true;
+
+		const uint32_t sampleRate = uint32_t(m_pitch * block.sampleRate);
+		if (sampleRate == 0)
+			return true;
+
+		advanced += max< uint32_t >((uint32_t)((uint64_t(block.samplesCount) * m_hwSampleRate) / sampleRate), 1);
+	}
+
+	return true;
+}
+
+bool AudioChannel::prepareCursor()
+{
+	StateSound& ss = m_stateSound;
+
+	if (!prepare())
+		return false;
+
+	if (!m_allowRepeat)
+		ss.cursor->disableRepeat();
+
+	// Push pending parameters.
+	StateParameter& sp = m_stateParameters.read();
+	for (uint32_t i = 0; i < sp.set.size(); ++i)
+		ss.cursor->setParameter(sp.set[i].first, sp.set[i].second);
+	sp.set.clear();
+
+	return true;
+}
+
+bool AudioChannel::readBlock(const IAudioMixer* mixer, AudioBlock& block, bool skip)
+{
+	StateSound& ss = m_stateSound;
+
+	const IAudioBuffer* soundBuffer = ss.buffer;
+	T_ASSERT(soundBuffer);
+
+	if (skip ? soundBuffer->skipBlock(ss.cursor, mixer, block) : soundBuffer->getBlock(ss.cursor, mixer, block))
+		return true;
+
+	// No more blocks from sound buffer.
+	if (m_allowRepeat && ss.repeat)
+	{
+		ss.cursor->reset();
+
+		// Skip samples when repeating.
+		uint32_t skipSamples = ss.repeatFrom;
+		while (skipSamples > 0)
+		{
+			AudioBlock skippedBlock = { { 0 }, m_hwFrameSamples, 0, 0 };
+			if (soundBuffer->skipBlock(ss.cursor, mixer, skippedBlock))
+				skipSamples -= min(skipSamples, skippedBlock.samplesCount);
+			else
+			{
+				ss.buffer = nullptr;
+				ss.cursor = nullptr;
+				m_playing = false;
+				return false;
+			}
+		}
+
+		if (skip ? soundBuffer->skipBlock(ss.cursor, mixer, block) : soundBuffer->getBlock(ss.cursor, mixer, block))
+			return true;
+	}
+
+	ss.buffer = nullptr;
+	ss.cursor = nullptr;
+	m_playing = false;
+	return false;
+}
+
+bool AudioChannel::prepare()
+{
+	StateSound& ss = m_stateSound;
+
+	// Read pending sound state from fifo.
+	{
+		StateSound next;
+		if (m_stateSoundFifo.get(next))
+			ss = next;
+	}
+
+	return ss.buffer && ss.cursor;
+}
+
 }
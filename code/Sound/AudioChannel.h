@@ -90,6 +90,14 @@ public:
 	/*! Check if there are a sound playing in this channel. */
 	bool isPlaying() const;
 
+	/*! Check if channel is virtual.
+	 *
+	 * A virtual channel is playing but isn't audible enough
+	 * to be mixed; its sound keeps advancing, without being
+	 * filtered or mixed, until channel becomes audible again.
+	 */
+	bool isVirtual() const;
+
 	/*! Stop playing sound. */
 	void stop();
 
@@ -130,6 +138,7 @@ private:
 	float m_pitch;
 	bool m_playing;
 	bool m_allowRepeat;
+	bool m_virtual;
 	
 	DoubleBuffer< StateFilter > m_stateFilter;
 	DoubleBuffer< StateParameter > m_stateParameters;
@@ -138,6 +147,28 @@ private:
 
 	float* m_outputSamples[SbcMaxChannelCount];
 	uint32_t m_outputSamplesIn;
+
+	/*! Read pending sound state, return true if a sound is attached. */
+	bool prepare();
+
+	/*! Prepare attached cursor with pending repeat state and parameters. */
+	bool prepareCursor();
+
+	/*! Read block from sound buffer, repeat or end sound when buffer is exhausted.
+	 *
+	 * When skipping the cursor is only advanced and block samples are left null.
+	 */
+	bool readBlock(const IAudioMixer* mixer, AudioBlock& block, bool skip);
+
+	/*! Advance virtual channel one hardware frame without mixing.
+	 *
+	 * Keeps sound in sync while channel is inaudible; non
+	 * repeating sounds end as if they were mixed.
+	 */
+	bool advance(const IAudioMixer* mixer);
+
+	/*! Linear volume of attached sound, excluding category volume. */
+	float getAudibility() const { return m_volume * m_stateSound.volume; }
 };
 
 }
@@ -6,10 +6,14 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Misc/ObjectStore.h"
 #include "Database/Instance.h"
 #include "Sound/AudioResourceFactory.h"
+#include "Sound/AudioSystem.h"
 #include "Sound/IAudioResource.h"
 #include "Sound/Sound.h"
+#include "Sound/StreamAudioBuffer.h"
+#include "Sound/StreamingService.h"
 
 namespace traktor::sound
 {
@@ -18,6 +22,9 @@ T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.AudioResourceFactory", 0, AudioRe
 
 bool AudioResourceFactory::initialize(const ObjectStore& objectStore)
 {
+	AudioSystem* audioSystem = objectStore.get< AudioSystem >();
+	if (audioSystem)
+		m_streamingService = audioSystem->getStreamingService();
 	return true;
 }
 
@@ -39,10 +46,22 @@ bool AudioResourceFactory::isCacheable(const TypeInfo& productType) const
 Ref< Object > AudioResourceFactory::create(resource::IResourceManager* resourceManager, const db::Database* database, const db::Instance* instance, const TypeInfo& productType, const Object* current) const
 {
 	Ref< const IAudioResource > resource = instance->getObject< IAudioResource >();
-	if (resource)
-		return resource->createSound(resourceManager, instance);
-	else
+	if (!resource)
 		return nullptr;
+
+	Ref< Sound > sound = resource->createSound(resourceManager, instance);
+	if (!sound)
+		return nullptr;
+
+	// Decode streamed sounds ahead of playback, if a streaming service is available.
+	if (m_streamingService)
+	{
+		StreamAudioBuffer* streamAudioBuffer = dynamic_type_cast< StreamAudioBuffer* >(sound->getBuffer());
+		if (streamAudioBuffer)
+			streamAudioBuffer->attach(m_streamingService);
+	}
+
+	return sound;
 }
 
 void AudioResourceFactory::destroy(Object* resource) const
@@ -21,6 +21,8 @@
 namespace traktor::sound
 {
 
+class StreamingService;
+
 /*! Audio resource factory.
  * \ingroup Sound
  */
@@ -40,6 +42,9 @@ public:
 	virtual Ref< Object > create(resource::IResourceManager* resourceManager, const db::Database* database, const db::Instance* instance, const TypeInfo& productType, const Object* current) const override final;
 
 	virtual void destroy(Object* resource) const override final;
+
+private:
+	Ref< StreamingService > m_streamingService;
 };
 
 }
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include "Core/Log/Log.h"
@@ -15,6 +16,7 @@
 #include "Core/Memory/Alloc.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobQueue.h"
 #include "Core/Thread/ThreadManager.h"
 #include "Core/Timer/Timer.h"
 #include "Sound/AudioChannel.h"
@@ -23,6 +25,7 @@
 #include "Sound/IAudioDriver.h"
 #include "Sound/IAudioMixer.h"
 #include "Sound/Sound.h"
+#include "Sound/StreamingService.h"
 
 #if defined(T_SOUND_USE_AVX_MIXER)
 #	include "Sound/Avx/AudioMixerAvx.h"
@@ -30,6 +33,14 @@
 
 namespace traktor::sound
 {
+	namespace
+	{
+
+const float c_inaudibleVolume = 0.001f;		//!< -60 dB
+const uint32_t c_minChannelsPerThread = 4;
+const uint32_t c_maxMixerThreads = 32;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.AudioSystem", AudioSystem, Object)
 
@@ -39,8 +50,11 @@ AudioSystem::AudioSystem(IAudioDriver* driver)
 ,	m_volume(1.0f)
 ,	m_threadMixer(0)
 ,	m_samplesData(0)
+,	m_accumulateData(0)
 ,	m_time(0.0)
 ,	m_mixerThreadTime(0.0)
+,	m_activeChannelCount(0)
+,	m_virtualChannelCount(0)
 {
 }
 
@@ -50,6 +64,7 @@ bool AudioSystem::create(const AudioSystemCreateDesc& desc)
 
 	m_desc = desc;
 	m_desc.driverDesc.frameSamples &= ~3U;
+	m_desc.mixerThreads = clamp< uint32_t >(m_desc.mixerThreads, 1, c_maxMixerThreads);
 
 	// Create driver.
 	if (!m_driver->create(m_desc.sysapp, m_desc.driverDesc, m_mixer))
@@ -83,6 +98,31 @@ bool AudioSystem::create(const AudioSystemCreateDesc& desc)
 	for (uint32_t i = 0; i < samplesBlockCount; ++i)
 		m_samplesBlocks.push_back(&m_samplesData[i * samplesPerBlock]);
 
+	// Create additional mixer threads, each accumulating into it's own block
+	// which are then reduced into the frame block.
+	if (m_desc.mixerThreads > 1)
+	{
+		m_accumulateData = static_cast< float* >(Alloc::acquireAlign(
+			samplesPerBlock * (m_desc.mixerThreads - 1) * sizeof(float),
+			16,
+			T_FILE_LINE
+		));
+		if (!m_accumulateData)
+			return false;
+
+		m_mixerQueue = new JobQueue();
+		if (!m_mixerQueue->create(m_desc.mixerThreads - 1, Thread::Above))
+			return false;
+	}
+
+	// Create streaming service which decode streams ahead of mixer.
+	if (m_desc.streamLatency > 0)
+	{
+		m_streamingService = new StreamingService();
+		if (!m_streamingService->create(uint32_t(uint64_t(m_desc.streamLatency) * m_desc.driverDesc.sampleRate / 1000)))
+			return false;
+	}
+
 	// Create mixer and submission threads.
 	m_threadMixer = ThreadManager::getInstance().create([=, this](){ threadMixer(); }, L"Sound mixer", 1);
 	if (!m_threadMixer)
@@ -103,7 +143,7 @@ bool AudioSystem::create(const AudioSystemCreateDesc& desc)
 	}
 
 	// Set play parameters.
-	m_requestBlocks.resize(desc.channels);
+	m_activeChannels.reserve(desc.channels);
 	m_time = 0.0;
 
 	// Start thread.
@@ -129,6 +169,8 @@ void AudioSystem::destroy()
 	}
 
 	// Free mixer and memory resources.
+	safeDestroy(m_streamingService);
+	safeDestroy(m_mixerQueue);
 	m_mixer = nullptr;
 	safeDestroy(m_driver);
 
@@ -137,6 +179,12 @@ void AudioSystem::destroy()
 		Alloc::freeAlign(m_samplesData);
 		m_samplesData = nullptr;
 	}
+
+	if (m_accumulateData)
+	{
+		Alloc::freeAlign(m_accumulateData);
+		m_accumulateData = nullptr;
+	}
 }
 
 bool AudioSystem::reset(IAudioDriver* driver)
@@ -263,82 +311,134 @@ void AudioSystem::getThreadPerformances(double& outMixerTime) const
 	outMixerTime = m_mixerThreadTime;
 }
 
+void AudioSystem::getChannelCounts(uint32_t& outActiveChannels, uint32_t& outVirtualChannels) const
+{
+	outActiveChannels = m_activeChannelCount;
+	outVirtualChannels = m_virtualChannelCount;
+}
+
 void AudioSystem::threadMixer()
 {
 	AudioBlock frameBlock;
 	Timer timerMixer;
-	uint32_t channelsCount;
+	Job::task_t tasks[c_maxMixerThreads];
+
+	const uint32_t samplesPerBlock = m_desc.driverDesc.frameSamples * m_desc.driverDesc.hwChannels;
 
 	timerMixer.reset();
 	while (!m_threadMixer->stopped())
 	{
 		const double startTime = timerMixer.getElapsedTime();
 
-		// Read blocks from channels.
-		m_channelsLock.wait();
-		{
-			channelsCount = (uint32_t)m_channels.size();
-			for (uint32_t i = 0; i < channelsCount; ++i)
-			{
-				m_requestBlocks[i].samplesCount = m_desc.driverDesc.frameSamples;
-				m_requestBlocks[i].maxChannel = 0;
-				m_requestBlocks[i].category = 0;
-				m_channels[i]->getBlock(m_mixer, m_requestBlocks[i]);
-			}
-		}
-		m_channelsLock.release();
-
 		// Allocate new frame block.
 		float* samples = m_samplesBlocks.front();
 		m_samplesBlocks.pop_front();
 
 		// Prepare new frame block.
-		m_mixer->mute(samples, m_desc.driverDesc.frameSamples * m_desc.driverDesc.hwChannels);
 		for (uint32_t i = 0; i < m_desc.driverDesc.hwChannels; ++i)
 			frameBlock.samples[i] = samples + m_desc.driverDesc.frameSamples * i;
 		frameBlock.samplesCount = m_desc.driverDesc.frameSamples;
 		frameBlock.sampleRate = m_desc.driverDesc.sampleRate;
 		frameBlock.maxChannel = m_desc.driverDesc.hwChannels;
 
-		m_mixer->synchronize();
-
-		// Final combine channels into hardware channels using "combine matrix".
-		for (uint32_t i = 0; i < channelsCount; ++i)
+		m_channelsLock.wait();
 		{
-			if (!m_requestBlocks[i].maxChannel)
-				continue;
+			// Determine which channels are audible enough to be decoded and mixed,
+			// the rest become virtual and are only advanced until they are audible again.
+			uint32_t virtualCount = 0;
 
-			T_ASSERT(m_requestBlocks[i].sampleRate == m_desc.driverDesc.sampleRate);
-			T_ASSERT(m_requestBlocks[i].samplesCount == m_desc.driverDesc.frameSamples);
-
-			const float categoryVolume = getVolume(m_requestBlocks[i].category);
-			const float finalVolume = m_volume * categoryVolume;
-
-			for (uint32_t k = 0; k < m_requestBlocks[i].maxChannel; ++k)
+			m_activeChannels.resize(0);
+			for (auto channel : m_channels)
 			{
-				if (!m_requestBlocks[i].samples[k])
+				if (!channel->prepare())
+				{
+					channel->m_virtual = false;
 					continue;
+				}
 
-				for (uint32_t j = 0; j < m_desc.driverDesc.hwChannels; ++j)
+				const float volume = m_volume * getVolume(channel->m_stateSound.category);
+				const float audibility = volume * channel->getAudibility();
+				if (audibility >= c_inaudibleVolume)
 				{
-					const float strength = m_desc.cm[j][k] * finalVolume;
-					if (abs(strength) >= FUZZY_EPSILON)
-					{
-						m_mixer->addMulConst(
-							frameBlock.samples[j],
-							m_requestBlocks[i].samples[k],
-							m_requestBlocks[i].samplesCount,
-							strength
-						);
+					channel->m_virtual = false;
+					m_activeChannels.push_back({ channel, volume, audibility });
+				}
+				else
+				{
+					channel->m_virtual = true;
+					++virtualCount;
+				}
+			}
+
+			// Only keep most audible channels if there are too many.
+			if (m_desc.activeChannels > 0 && m_activeChannels.size() > m_desc.activeChannels)
+			{
+				std::nth_element(
+					m_activeChannels.ptr(),
+					m_activeChannels.ptr() + m_desc.activeChannels,
+					m_activeChannels.ptr() + m_activeChannels.size(),
+					[](const ActiveChannel& lh, const ActiveChannel& rh) {
+						return lh.audibility > rh.audibility;
 					}
+				);
+				for (uint32_t i = m_desc.activeChannels; i < m_activeChannels.size(); ++i)
+					m_activeChannels[i].channel->m_virtual = true;
+
+				virtualCount += (uint32_t)m_activeChannels.size() - m_desc.activeChannels;
+				m_activeChannels.resize(m_desc.activeChannels);
+			}
+
+			// Decode and mix active channels; split channels evenly among mixer threads.
+			const uint32_t activeCount = (uint32_t)m_activeChannels.size();
+			const uint32_t threadCount = clamp< uint32_t >(activeCount / c_minChannelsPerThread, 1, m_desc.mixerThreads);
+
+			if (threadCount > 1)
+			{
+				// Buffers might keep shared decoding state, such as stream buffers, thus
+				// channels playing same buffer must be mixed by the same thread.
+				std::sort(m_activeChannels.begin(), m_activeChannels.end(), [](const ActiveChannel& lh, const ActiveChannel& rh) {
+					return lh.channel->m_stateSound.buffer.ptr() < rh.channel->m_stateSound.buffer.ptr();
+				});
+
+				uint32_t from = 0;
+				for (uint32_t i = 0; i < threadCount; ++i)
+				{
+					uint32_t to = (i < threadCount - 1) ? max((activeCount * (i + 1)) / threadCount, from) : activeCount;
+					while (to > 0 && to < activeCount && m_activeChannels[to].channel->m_stateSound.buffer == m_activeChannels[to - 1].channel->m_stateSound.buffer)
+						++to;
+
+					float* accumulate = (i == 0) ? samples : m_accumulateData + (i - 1) * samplesPerBlock;
+					tasks[i] = [=, this]() { mixChannels(from, to, accumulate); };
+					from = to;
 				}
+				m_mixerQueue->fork(tasks, threadCount);
 
+				// Reduce accumulated blocks into frame block.
+				for (uint32_t i = 1; i < threadCount; ++i)
+					m_mixer->addMulConst(samples, m_accumulateData + (i - 1) * samplesPerBlock, samplesPerBlock, 1.0f);
 				m_mixer->synchronize();
 			}
+			else
+				mixChannels(0, activeCount, samples);
+
+			// Advance virtual channels so they stay in sync, and end, as if they were mixed.
+			for (auto channel : m_channels)
+			{
+				if (channel->m_virtual)
+					channel->m_virtual = channel->advance(m_mixer);
+			}
+
+			m_activeChannelCount = activeCount;
+			m_virtualChannelCount = virtualCount;
 		}
+		m_channelsLock.release();
 
 		m_time += double(m_desc.driverDesc.frameSamples) / m_desc.driverDesc.sampleRate;
 
+		// Measure time spent mixing, excluding time waiting for driver.
+		const double endTime = timerMixer.getElapsedTime();
+		m_mixerThreadTime = (endTime - startTime) * 0.1 + m_mixerThreadTime * 0.9;
+
 		if (m_threadMixer->stopped())
 			break;
 
@@ -348,9 +448,51 @@ void AudioSystem::threadMixer()
 
 		// Move block back into heap.
 		m_samplesBlocks.push_back(frameBlock.samples[0]);
+	}
+}
 
-		const double endTime = timerMixer.getElapsedTime();
-		m_mixerThreadTime = (endTime - startTime) * 0.1 + m_mixerThreadTime * 0.9;
+void AudioSystem::mixChannels(uint32_t from, uint32_t to, float* samples)
+{
+	AudioBlock requestBlock;
+
+	m_mixer->mute(samples, m_desc.driverDesc.frameSamples * m_desc.driverDesc.hwChannels);
+	m_mixer->synchronize();
+
+	for (uint32_t i = from; i < to; ++i)
+	{
+		const ActiveChannel& activeChannel = m_activeChannels[i];
+
+		requestBlock.samplesCount = m_desc.driverDesc.frameSamples;
+		requestBlock.maxChannel = 0;
+		requestBlock.category = 0;
+		if (!activeChannel.channel->getBlock(m_mixer, requestBlock) || !requestBlock.maxChannel)
+			continue;
+
+		T_ASSERT(requestBlock.sampleRate == m_desc.driverDesc.sampleRate);
+		T_ASSERT(requestBlock.samplesCount == m_desc.driverDesc.frameSamples);
+
+		// Combine channels into hardware channels using "combine matrix".
+		for (uint32_t k = 0; k < requestBlock.maxChannel; ++k)
+		{
+			if (!requestBlock.samples[k])
+				continue;
+
+			for (uint32_t j = 0; j < m_desc.driverDesc.hwChannels; ++j)
+			{
+				const float strength = m_desc.cm[j][k] * activeChannel.volume;
+				if (abs(strength) >= FUZZY_EPSILON)
+				{
+					m_mixer->addMulConst(
+						samples + m_desc.driverDesc.frameSamples * j,
+						requestBlock.samples[k],
+						requestBlock.samplesCount,
+						strength
+					);
+				}
+			}
+
+			m_mixer->synchronize();
+		}
 	}
 }
 
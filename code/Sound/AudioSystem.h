@@ -26,6 +26,13 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class JobQueue;
+
+}
+
 namespace traktor::sound
 {
 
@@ -33,6 +40,7 @@ class AudioChannel;
 class IAudioDriver;
 class IAudioMixer;
 class Sound;
+class StreamingService;
 
 /*! Audio system manager.
  * \ingroup Sound
@@ -121,11 +129,31 @@ public:
 
 	/*! Query performance of each thread.
 	 *
-	 * \param outMixerTime Last mixer thread duration in seconds.
+	 * \param outMixerTime Average duration of mixing a block in seconds, excluding time waiting for driver.
 	 */
 	void getThreadPerformances(double& outMixerTime) const;
 
+	/*! Query number of playing channels.
+	 *
+	 * \param outActiveChannels Number of channels decoded and mixed last block.
+	 * \param outVirtualChannels Number of playing channels which were virtual last block.
+	 */
+	void getChannelCounts(uint32_t& outActiveChannels, uint32_t& outVirtualChannels) const;
+
+	/*! Get streaming service.
+	 *
+	 * \return Streaming service, null if streams are decoded by mixer.
+	 */
+	StreamingService* getStreamingService() const { return m_streamingService; }
+
 private:
+	struct ActiveChannel
+	{
+		AudioChannel* channel;
+		float volume;		//!< Global and category volume.
+		float audibility;	//!< Final volume of channel's sound.
+	};
+
 	Ref< IAudioDriver > m_driver;
 	Ref< IAudioMixer > m_mixer;
 	AudioSystemCreateDesc m_desc;
@@ -133,8 +161,10 @@ private:
 	float m_volume;
 	SmallMap< handle_t, float > m_categoryVolumes;
 	Thread* m_threadMixer;
+	Ref< JobQueue > m_mixerQueue;
+	Ref< StreamingService > m_streamingService;
 	RefArray< AudioChannel > m_channels;
-	AlignedVector< AudioBlock > m_requestBlocks;
+	AlignedVector< ActiveChannel > m_activeChannels;
 
 	// \name Submission queue
 	// \{
@@ -148,13 +178,19 @@ private:
 
 	float* m_samplesData;
 	CircularVector< float*, 4 > m_samplesBlocks;
+	float* m_accumulateData;		//!< Accumulation blocks of additional mixer threads.
 
 	// \}
 
 	double m_time;
 	double m_mixerThreadTime;
+	uint32_t m_activeChannelCount;
+	uint32_t m_virtualChannelCount;
 
 	void threadMixer();
+
+	/*! Decode and mix range of active channels into hardware channel samples. */
+	void mixChannels(uint32_t from, uint32_t to, float* samples);
 };
 
 }
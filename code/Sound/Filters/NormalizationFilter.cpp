@@ -7,6 +7,7 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include <cmath>
+#include "Core/Math/Vector4.h"
 #include "Core/Memory/IAllocator.h"
 #include "Core/Memory/MemoryConfig.h"
 #include "Core/Serialization/ISerializer.h"
@@ -55,23 +56,47 @@ void NormalizationFilter::apply(IAudioFilterInstance* instance, AudioBlock& outB
 {
 	NormalizationFilterInstance* nfi = static_cast< NormalizationFilterInstance* >(instance);
 
+	const uint32_t samplesCount = outBlock.samplesCount;
+	const uint32_t vectorCount = samplesCount & ~3U;
+
 	// Measure energy in sound block.
+	Vector4 energy4 = Vector4::zero();
 	float energy = 0.0f;
-	for (uint32_t i = 0; i < outBlock.samplesCount; ++i)
+	for (uint32_t j = 0; j < outBlock.maxChannel; ++j)
 	{
-		for (uint32_t j = 0; j < outBlock.maxChannel; ++j)
-			energy += std::abs(outBlock.samples[j][i]);
+		const float* samples = outBlock.samples[j];
+		uint32_t i = 0;
+		for (; i < vectorCount; i += 4)
+			energy4 += Vector4::loadAligned(&samples[i]).absolute();
+		for (; i < samplesCount; ++i)
+			energy += std::abs(samples[i]);
 	}
-	energy /= outBlock.samplesCount * outBlock.maxChannel;
+	energy += float(horizontalAdd4(energy4));
+	energy /= samplesCount * outBlock.maxChannel;
 
 	if (energy >= m_energyThreshold)
 	{
 		// Attack rate are expressed in delta per second.
-		float attackRate = m_attackRate / outBlock.sampleRate;
+		const float attackRate = m_attackRate / outBlock.sampleRate;
 
-		// Normalize energy in sound block, interpolate gain to prevent too quick changes.
-		float middleGain = m_targetEnergy / energy;
-		for (uint32_t i = 0; i < outBlock.samplesCount; ++i)
+		// Normalize energy in sound block, interpolate gain to prevent too quick changes;
+		// gain is stepped per sample and applied to four samples at a time.
+		const float middleGain = m_targetEnergy / energy;
+		uint32_t i = 0;
+		for (; i < vectorCount; i += 4)
+		{
+			float gains[4];
+			for (uint32_t k = 0; k < 4; ++k)
+			{
+				gains[k] = nfi->m_currentGain;
+				nfi->m_currentGain = middleGain * attackRate + nfi->m_currentGain * (1.0f - attackRate);
+			}
+
+			const Vector4 gain4(gains[0], gains[1], gains[2], gains[3]);
+			for (uint32_t j = 0; j < outBlock.maxChannel; ++j)
+				(Vector4::loadAligned(&outBlock.samples[j][i]) * gain4).storeAligned(&outBlock.samples[j][i]);
+		}
+		for (; i < samplesCount; ++i)
 		{
 			for (uint32_t j = 0; j < outBlock.maxChannel; ++j)
 				outBlock.samples[j][i] *= nfi->m_currentGain;
@@ -81,10 +106,15 @@ void NormalizationFilter::apply(IAudioFilterInstance* instance, AudioBlock& outB
 	else
 	{
 		// Energy below threshold, keep current gain.
-		for (uint32_t i = 0; i < outBlock.samplesCount; ++i)
+		const Scalar gain(nfi->m_currentGain);
+		for (uint32_t j = 0; j < outBlock.maxChannel; ++j)
 		{
-			for (uint32_t j = 0; j < outBlock.maxChannel; ++j)
-				outBlock.samples[j][i] *= nfi->m_currentGain;
+			float* samples = outBlock.samples[j];
+			uint32_t i = 0;
+			for (; i < vectorCount; i += 4)
+				(Vector4::loadAligned(&samples[i]) * gain).storeAligned(&samples[i]);
+			for (; i < samplesCount; ++i)
+				samples[i] *= nfi->m_currentGain;
 		}
 	}
 }
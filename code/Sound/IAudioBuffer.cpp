@@ -13,4 +13,15 @@ namespace traktor::sound
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.IAudioBuffer", IAudioBuffer, Object)
 
+bool IAudioBuffer::skipBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
+{
+	if (!getBlock(cursor, mixer, outBlock))
+		return false;
+
+	for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+		outBlock.samples[i] = nullptr;
+
+	return true;
+}
+
 }
@@ -49,6 +49,14 @@ public:
 	virtual Ref< IAudioBufferCursor > createCursor() const = 0;
 
 	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const = 0;
+
+	/*! Advance cursor without producing any samples.
+	 *
+	 * Same as getBlock except block samples are left null; default
+	 * implementation reads and discards a block so buffers which
+	 * can skip cheaply should override.
+	 */
+	virtual bool skipBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const;
 };
 
 }
@@ -10,22 +10,51 @@
 #include "Core/Log/Log.h"
 #include "Core/Math/Vector4.h"
 #include "Core/Memory/Alloc.h"
+#include "Core/Misc/Align.h"
 #include "Sound/IAudioBuffer.h"
 #include "Sound/Processor/Graph.h"
 #include "Sound/Processor/GraphEvaluator.h"
+#include "Sound/Processor/InputPin.h"
 #include "Sound/Processor/Node.h"
 #include "Sound/Processor/OutputPin.h"
 
 namespace traktor::sound
 {
+	namespace
+	{
+
+const uint32_t c_maxBlockSamples = 4096;	//!< Max number of samples per channel in a block, same as static and stream buffers.
+const uint32_t c_slotSamples = c_maxBlockSamples * SbcMaxChannelCount;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.GraphEvaluator", GraphEvaluator, Object)
 
+GraphEvaluator::GraphEvaluator()
+:	m_slots(nullptr)
+,	m_current(~0U)
+{
+}
+
+GraphEvaluator::~GraphEvaluator()
+{
+	if (m_slots)
+		Alloc::freeAlign(m_slots);
+}
+
 bool GraphEvaluator::create(const Graph* graph)
 {
+	const RefArray< Node >& nodes = graph->getNodes();
+
 	m_graph = graph;
-	for (auto node : graph->getNodes())
+
+	// Create instruction, with cursor, for each node; also
+	// enumerate all pins.
+	m_instructions.resize(nodes.size());
+	for (uint32_t i = 0; i < nodes.size(); ++i)
 	{
+		const Node* node = nodes[i];
+
 		Ref< IAudioBufferCursor > nodeCursor = node->createCursor();
 		if (!nodeCursor)
 		{
@@ -33,103 +62,122 @@ bool GraphEvaluator::create(const Graph* graph)
 			return false;
 		}
 
-		m_nodeCursors[node] = nodeCursor;
+		Instruction& instruction = m_instructions[i];
+		instruction.node = node;
+		instruction.cursor = nodeCursor;
+		instruction.inputsFrom = (uint32_t)m_inputs.size();
+		instruction.inputsCount = (uint32_t)node->getInputPinCount();
+
+		for (uint32_t j = 0; j < instruction.inputsCount; ++j)
+		{
+			const InputPin* inputPin = node->getInputPin(j);
+			m_inputLookup[inputPin] = (uint32_t)m_inputs.size();
+			m_inputs.push_back().pin = inputPin;
+		}
+
+		for (uint32_t j = 0; j < (uint32_t)node->getOutputPinCount(); ++j)
+		{
+			const OutputPin* outputPin = node->getOutputPin(j);
+			m_outputLookup[outputPin] = (uint32_t)m_outputs.size();
+
+			Output& output = m_outputs.push_back();
+			output.pin = outputPin;
+			output.producer = i;
+			output.consumerCount = graph->getDestinationCount(outputPin);
+		}
+	}
+
+	// Resolve connected output of each input.
+	for (auto& input : m_inputs)
+	{
+		const OutputPin* producerPin = graph->findSourcePin(input.pin);
+		if (!producerPin)
+			continue;
+
+		auto it = m_outputLookup.find(producerPin);
+		if (it == m_outputLookup.end())
+		{
+			log::error << L"Graph failed; input \"" << input.pin->getName() << L"\" connected to unknown node." << Endl;
+			return false;
+		}
+
+		input.output = it->second;
+	}
+
+	// Assign buffer slots to outputs with multiple consumers; first consumer
+	// get block as produced, last consumer get a pristine copy and the others
+	// get their own copy since consumers are allowed to modify blocks in-place.
+	// Nodes return their input blocks, modified in-place, as output thus a
+	// slot might be referenced until root node has been evaluated; slots
+	// cannot be shared between outputs within a block.
+	uint32_t slotCount = 0;
+	for (uint32_t i = 0; i < m_outputs.size(); ++i)
+	{
+		Output& output = m_outputs[i];
+		if (output.consumerCount >= 2)
+		{
+			output.slot = slotCount;
+			slotCount += output.consumerCount - 1;
+			m_sharedOutputs.push_back(i);
+		}
 	}
+	if (slotCount > 0)
+	{
+		m_slots = (float*)Alloc::acquireAlign(slotCount * c_slotSamples * sizeof(float), 16, T_FILE_LINE);
+		if (!m_slots)
+			return false;
+	}
+
 	m_timer.reset();
 	return true;
 }
 
 void GraphEvaluator::setParameter(handle_t id, float parameter)
 {
-	for (auto it : m_nodeCursors)
-		it.second->setParameter(id, parameter);
+	for (auto& instruction : m_instructions)
+		instruction.cursor->setParameter(id, parameter);
 }
 
 bool GraphEvaluator::evaluateScalar(const OutputPin* producerPin, float& outScalar) const
 {
-	const Node* producerNode = producerPin->getNode();
-	T_ASSERT(producerNode != nullptr);
-
-	IAudioBufferCursor* producerCursor = m_nodeCursors[producerNode];
-	if (!producerCursor)
-		return false;
-
-	if (!producerNode->getScalar(producerCursor, this, outScalar))
+	auto it = m_outputLookup.find(producerPin);
+	if (it != m_outputLookup.end())
+		return evaluateScalar(it->second, outScalar);
+	else
 		return false;
-
-	return true;
 }
 
 bool GraphEvaluator::evaluateScalar(const InputPin* consumerPin, float& outScalar) const
 {
-	const OutputPin* producerPin = m_graph->findSourcePin(consumerPin);
-	if (producerPin)
-		return evaluateScalar(producerPin, outScalar);
+	const Input* input = findInput(consumerPin);
+	if (input && input->output != ~0U)
+		return evaluateScalar(input->output, outScalar);
 	else
 		return false;
 }
 
 bool GraphEvaluator::evaluateBlock(const OutputPin* producerPin, const IAudioMixer* mixer, AudioBlock& outBlock) const
 {
-	const Node* producerNode = producerPin->getNode();
-	T_ASSERT(producerNode != nullptr);
-
-	IAudioBufferCursor* producerCursor = m_nodeCursors[producerNode];
-	if (!producerCursor)
+	auto it = m_outputLookup.find(producerPin);
+	if (it != m_outputLookup.end())
+		return evaluateBlock(it->second, mixer, outBlock);
+	else
 		return false;
-
-	const uint32_t consumerCount = m_graph->getDestinationCount(producerPin);
-	if (consumerCount == 1)
-	{
-		if (!producerNode->getBlock(producerCursor, this, mixer, outBlock))
-			return false;
-	}
-	else if (consumerCount >= 2)
-	{
-		// Need to buffer output of node since we have multiple consumers.
-		auto it = m_cachedBlocks.find(producerPin);
-		if (it != m_cachedBlocks.end())
-		{
-			if (consumerCount == 2)
-				outBlock = it->second;
-			else
-			{
-				auto copiedBlock = copyBlock(it->second);
-				if (!copiedBlock)
-					return false;
-
-				outBlock = *copiedBlock;		
-			}
-		}
-		else
-		{
-			if (!producerNode->getBlock(producerCursor, this, mixer, outBlock))
-				return false;
-
-			auto copiedBlock = copyBlock(outBlock);
-			if (!copiedBlock)
-				return false;
-
-			m_cachedBlocks[producerPin] = *copiedBlock;
-		}
-	}
-
-	return true;
 }
 
 bool GraphEvaluator::evaluateBlock(const InputPin* consumerPin, const IAudioMixer* mixer, AudioBlock& outBlock) const
 {
-	const OutputPin* producerPin = m_graph->findSourcePin(consumerPin);
-	if (producerPin)
-		return evaluateBlock(producerPin, mixer, outBlock);
+	const Input* input = findInput(consumerPin);
+	if (input && input->output != ~0U)
+		return evaluateBlock(input->output, mixer, outBlock);
 	else
 		return false;
 }
 
 NodePinType GraphEvaluator::evaluatePinType(const InputPin* consumerPin) const
 {
-	const OutputPin* producerPin = m_graph->findSourcePin(consumerPin);
-	return producerPin ? producerPin->getPinType() : NodePinType::Void;
+	const Input* input = findInput(consumerPin);
+	return (input && input->output != ~0U) ? m_outputs[input->output].pin->getPinType() : NodePinType::Void;
 }
 
 float GraphEvaluator::getTime() const
@@ -139,63 +187,124 @@ float GraphEvaluator::getTime() const
 
 void GraphEvaluator::flushCachedBlocks()
 {
-	for (auto& block : m_blocks)
+	for (auto i : m_sharedOutputs)
 	{
-		for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+		m_outputs[i].consumed = 0;
+		m_outputs[i].failed = false;
+	}
+}
+
+const GraphEvaluator::Input* GraphEvaluator::findInput(const InputPin* consumerPin) const
+{
+	// Inputs are almost always evaluated by the node currently
+	// being evaluated, thus first check it's few inputs.
+	if (m_current != ~0U)
+	{
+		const Instruction& instruction = m_instructions[m_current];
+		for (uint32_t i = 0; i < instruction.inputsCount; ++i)
 		{
-			if (block.samples[i])
-				Alloc::freeAlign(block.samples[i]);
+			const Input& input = m_inputs[instruction.inputsFrom + i];
+			if (input.pin == consumerPin)
+				return &input;
 		}
 	}
-	m_blocks.clear();
-	m_cachedBlocks.reset();
+
+	auto it = m_inputLookup.find(consumerPin);
+	return it != m_inputLookup.end() ? &m_inputs[it->second] : nullptr;
 }
 
-AudioBlock* GraphEvaluator::copyBlock(const AudioBlock& sourceBlock) const
+bool GraphEvaluator::evaluateScalar(uint32_t output, float& outScalar) const
 {
-	if (m_blocks.full())
-		return nullptr;
+	const Instruction& producer = m_instructions[m_outputs[output].producer];
 
-	AudioBlock& block = m_blocks.push_back();
+	const uint32_t current = m_current;
+	m_current = m_outputs[output].producer;
+	const bool result = producer.node->getScalar(producer.cursor, this, outScalar);
+	m_current = current;
 
+	return result;
+}
+
+bool GraphEvaluator::evaluateBlock(uint32_t output, const IAudioMixer* mixer, AudioBlock& outBlock) const
+{
+	const Output& o = m_outputs[output];
+
+	// Shared output already evaluated this block; last consumer get the
+	// pristine copy and the others a copy of it.
+	if (o.slot != ~0U && o.consumed > 0)
+	{
+		if (o.failed || o.consumed >= o.consumerCount)
+			return false;
+
+		if (++o.consumed < o.consumerCount)
+			return copyBlock(o.block, o.slot + o.consumed - 1, outBlock);
+
+		outBlock = o.block;
+		return true;
+	}
+
+	const Instruction& producer = m_instructions[o.producer];
+
+	const uint32_t current = m_current;
+	m_current = o.producer;
+	const bool result = producer.node->getBlock(producer.cursor, this, mixer, outBlock);
+	m_current = current;
+
+	if (o.slot != ~0U)
+	{
+		o.consumed = 1;
+		o.failed = !result || !copyBlock(outBlock, o.slot, o.block);
+	}
+
+	return result;
+}
+
+bool GraphEvaluator::copyBlock(const AudioBlock& sourceBlock, uint32_t slot, AudioBlock& outBlock) const
+{
+	const int32_t samplesCount = (int32_t)alignUp(sourceBlock.samplesCount, 4);
+	T_ASSERT(samplesCount <= (int32_t)c_maxBlockSamples);
+	if (samplesCount > (int32_t)c_maxBlockSamples)
+		return false;
+
+	float* slotSamples = m_slots + slot * c_slotSamples;
 	for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
 	{
 		if (sourceBlock.samples[i])
 		{
-			block.samples[i] = (float*)Alloc::acquireAlign(alignUp(sourceBlock.samplesCount, 4) * sizeof(float), 16, T_FILE_LINE);
+			outBlock.samples[i] = slotSamples;
+			slotSamples += samplesCount;
 
 			const float* sp = sourceBlock.samples[i];
-			float* dp = block.samples[i];
+			float* dp = outBlock.samples[i];
 
 			int32_t j = 0;
-			for (; j < (int32_t)sourceBlock.samplesCount - 16; j += 4 * 4)
+			for (; j < samplesCount - 16; j += 4 * 4)
 			{
 				const Vector4 s0 = Vector4::loadAligned(sp); sp += 4;
 				const Vector4 s1 = Vector4::loadAligned(sp); sp += 4;
 				const Vector4 s2 = Vector4::loadAligned(sp); sp += 4;
 				const Vector4 s3 = Vector4::loadAligned(sp); sp += 4;
-				
+
 				s0.storeAligned(dp); dp += 4;
 				s1.storeAligned(dp); dp += 4;
 				s2.storeAligned(dp); dp += 4;
 				s3.storeAligned(dp); dp += 4;
 			}
-			for (; j < (int32_t)sourceBlock.samplesCount; j += 4)
+			for (; j < samplesCount; j += 4)
 			{
 				const Vector4 s0 = Vector4::loadAligned(sp); sp += 4;
 				s0.storeAligned(dp); dp += 4;
 			}
 		}
 		else
-			block.samples[i] = nullptr;
+			outBlock.samples[i] = nullptr;
 	}
 
-	block.samplesCount = sourceBlock.samplesCount;
-	block.sampleRate = sourceBlock.sampleRate;
-	block.maxChannel = sourceBlock.maxChannel;
-	block.category = sourceBlock.category;
-
-	return &block;
+	outBlock.samplesCount = sourceBlock.samplesCount;
+	outBlock.sampleRate = sourceBlock.sampleRate;
+	outBlock.maxChannel = sourceBlock.maxChannel;
+	outBlock.category = sourceBlock.category;
+	return true;
 }
 
 }
@@ -10,8 +10,8 @@
 
 #include "Core/Object.h"
 #include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Containers/SmallMap.h"
-#include "Core/Containers/StaticVector.h"
 #include "Core/Timer/Timer.h"
 #include "Sound/Types.h"
 #include "Sound/Processor/ProcessorTypes.h"
@@ -35,11 +35,31 @@ class Node;
 class OutputPin;
 struct AudioBlock;
 
+/*! Sound graph evaluator.
+ * \ingroup Sound
+ *
+ * Graph is compiled into flat tables of nodes, inputs and outputs
+ * when evaluator is created, thus evaluation doesn't need to search
+ * graph for edges or cursors. Output of nodes with multiple consumers
+ * is evaluated once per block and distributed to consumers through
+ * buffer slots.
+ *
+ * Nodes pull their inputs on demand, and might return an input block
+ * modified in-place, so nodes are evaluated in demand order rather than
+ * in a precomputed topological order and a slot is kept alive for the
+ * entire block. Slots are allocated when evaluator is created, sized
+ * for the largest block produced by audio buffers, thus nothing is
+ * allocated by the mixer thread.
+ */
 class T_DLLCLASS GraphEvaluator : public Object
 {
 	T_RTTI_CLASS;
 
 public:
+	GraphEvaluator();
+
+	virtual ~GraphEvaluator();
+
 	bool create(const Graph* graph);
 
 	void setParameter(handle_t id, float parameter);
@@ -56,17 +76,53 @@ public:
 
 	float getTime() const;
 
+	/*! Begin evaluation of next block. */
 	void flushCachedBlocks();
 
 private:
+	struct Instruction
+	{
+		const Node* node = nullptr;
+		Ref< IAudioBufferCursor > cursor;
+		uint32_t inputsFrom = 0;
+		uint32_t inputsCount = 0;
+	};
+
+	struct Input
+	{
+		const InputPin* pin = nullptr;
+		uint32_t output = ~0U;			//!< Index of connected output, ~0 if not connected.
+	};
+
+	struct Output
+	{
+		const OutputPin* pin = nullptr;
+		uint32_t producer = 0;			//!< Index of producing node.
+		uint32_t consumerCount = 0;
+		uint32_t slot = ~0U;			//!< First buffer slot, only outputs with multiple consumers have slots.
+		mutable uint32_t consumed = 0;	//!< Number of consumers served this block.
+		mutable bool failed = false;	//!< Producer failed to produce a block this block.
+		mutable AudioBlock block;		//!< Pristine copy of produced block.
+	};
+
 	Ref< const Graph > m_graph;
-	SmallMap< const Node*, Ref< IAudioBufferCursor > > m_nodeCursors;
+	AlignedVector< Instruction > m_instructions;
+	AlignedVector< Input > m_inputs;
+	AlignedVector< Output > m_outputs;
+	AlignedVector< uint32_t > m_sharedOutputs;
+	SmallMap< const InputPin*, uint32_t > m_inputLookup;
+	SmallMap< const OutputPin*, uint32_t > m_outputLookup;
+	float* m_slots;
+	mutable uint32_t m_current;
 	Timer m_timer;
 
-	mutable StaticVector< AudioBlock, 128 > m_blocks;
-	mutable SmallMap< const OutputPin*, AudioBlock > m_cachedBlocks;
+	const Input* findInput(const InputPin* consumerPin) const;
+
+	bool evaluateScalar(uint32_t output, float& outScalar) const;
+
+	bool evaluateBlock(uint32_t output, const IAudioMixer* mixer, AudioBlock& outBlock) const;
 
-	AudioBlock* copyBlock(const AudioBlock& sourceBlock) const;
+	bool copyBlock(const AudioBlock& sourceBlock, uint32_t slot, AudioBlock& outBlock) const;
 };
 
 }
@@ -7,7 +7,9 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Core/Math/Float.h"
+#include "Core/Math/Vector4.h"
 #include "Core/Memory/Alloc.h"
+#include "Core/Misc/Align.h"
 #include "Sound/IAudioMixer.h"
 #include "Sound/IAudioBuffer.h"
 #include "Sound/Processor/GraphEvaluator.h"
@@ -34,6 +36,18 @@ const ImmutableNode::OutputPinDesc c_Blend_o[] =
 	{ 0 }
 };
 
+/*! Blend two signals in a single pass; out = lh + (rh - lh) * weight. */
+void blendSamples(float* out, const float* lh, const float* rh, uint32_t count, float weight)
+{
+	const Scalar w(weight);
+	for (uint32_t i = 0; i < count; i += 4)
+	{
+		const Vector4 l = Vector4::loadAligned(&lh[i]);
+		const Vector4 r = Vector4::loadAligned(&rh[i]);
+		(l + (r - l) * w).storeAligned(&out[i]);
+	}
+}
+
 class BlendCursor : public RefCountImpl< IAudioBufferCursor >
 {
 public:
@@ -127,7 +141,18 @@ bool Blend::getBlock(IAudioBufferCursor* cursor, const GraphEvaluator* evaluator
 	T_ASSERT(mixer);
 	for (uint32_t i = 0; i < outBlock.maxChannel; ++i)
 	{
-		if (soundBlock1.samples[i] && soundBlock2.samples[i])
+		if (soundBlock1.samples[i] && soundBlock2.samples[i] && soundBlock1.samplesCount == soundBlock2.samplesCount)
+		{
+			outBlock.samples[i] = blendCursor->m_outputSamples[i];
+			blendSamples(
+				outBlock.samples[i],
+				soundBlock1.samples[i],
+				soundBlock2.samples[i],
+				alignUp(soundBlock1.samplesCount, 4),
+				weight
+			);
+		}
+		else if (soundBlock1.samples[i] && soundBlock2.samples[i])
 		{
 			outBlock.samples[i] = blendCursor->m_outputSamples[i];
 			mixer->mulConst(
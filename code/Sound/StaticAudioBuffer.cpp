@@ -225,4 +225,31 @@ bool StaticAudioBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer*
 	return true;
 }
 
+bool StaticAudioBuffer::skipBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
+{
+	StaticAudioBufferCursor* ssbc = static_cast< StaticAudioBufferCursor* >(cursor);
+
+	const int32_t position = ssbc->m_position;
+	if (position >= m_samplesCount)
+		return false;
+
+	int32_t samplesCount = m_samplesCount - position;
+	samplesCount = std::min< int32_t >(samplesCount, outBlock.samplesCount);
+	samplesCount = alignDown(samplesCount, 4);
+	samplesCount = std::min< int32_t >(samplesCount, 4096);
+
+	if (samplesCount <= 0)
+		return false;
+
+	for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+		outBlock.samples[i] = nullptr;
+
+	outBlock.samplesCount = samplesCount;
+	outBlock.sampleRate = m_sampleRate;
+	outBlock.maxChannel = m_channelsCount;
+
+	ssbc->m_position += samplesCount;
+	return true;
+}
+
 }
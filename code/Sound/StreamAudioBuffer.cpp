@@ -6,20 +6,39 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include "Core/Log/Log.h"
+#include "Core/Memory/Alloc.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Sound/IStreamDecoder.h"
 #include "Sound/StreamAudioBuffer.h"
+#include "Sound/StreamingService.h"
+#include "Sound/StreamRing.h"
 
 namespace traktor::sound
 {
 	namespace
 	{
 
+const uint32_t c_maxBlockSize = 4096;	//!< Max number of samples read from ring each block.
+const int32_t c_rewindTimeout = 4;		//!< Max time, in milliseconds, mixer waits for stream to rewind.
+
 struct StreamAudioBufferCursor : public RefCountImpl< IAudioBufferCursor >
 {
+	Ref< StreamingService > m_streamingService;
+	Ref< StreamRing > m_streamRing;
+	float* m_samples[SbcMaxChannelCount] = { nullptr };
 	uint64_t m_position = 0;
 
+	virtual ~StreamAudioBufferCursor()
+	{
+		if (m_streamRing)
+			m_streamingService->detach(m_streamRing);
+
+		if (m_samples[0])
+			Alloc::freeAlign(m_samples[0]);
+	}
+
 	virtual void setParameter(handle_t id, float parameter)
 	{
 	}
@@ -34,6 +53,41 @@ struct StreamAudioBufferCursor : public RefCountImpl< IAudioBufferCursor >
 	}
 };
 
+bool readRing(StreamAudioBufferCursor* cursor, AudioBlock& outBlock, bool skip)
+{
+	const uint64_t position = cursor->m_position;
+
+	float* const* samples = skip ? nullptr : cursor->m_samples;
+	uint32_t samplesCount = std::min(outBlock.samplesCount, c_maxBlockSize);
+
+	StreamRing::ReadResult result = cursor->m_streamRing->read(position, samples, samplesCount, outBlock.sampleRate, outBlock.maxChannel);
+	if (result == StreamRing::ReadResult::Rewinding)
+	{
+		cursor->m_streamingService->wakeUp();
+		if (cursor->m_streamRing->waitRewound(c_rewindTimeout))
+			result = cursor->m_streamRing->read(position, samples, samplesCount, outBlock.sampleRate, outBlock.maxChannel);
+	}
+
+	switch (result)
+	{
+	case StreamRing::ReadResult::Available:
+		for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+			outBlock.samples[i] = samples ? samples[i] : nullptr;
+		outBlock.samplesCount = samplesCount;
+		cursor->m_position = position + samplesCount;
+		return true;
+
+	case StreamRing::ReadResult::End:
+		return false;
+
+	default:
+		// Return null block; not end of stream, channel will
+		// continue when service has decoded more samples.
+		outBlock.samplesCount = 0;
+		return true;
+	}
+}
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.StreamAudioBuffer", StreamAudioBuffer, IAudioBuffer)
@@ -51,21 +105,67 @@ bool StreamAudioBuffer::create(IStreamDecoder* streamDecoder)
 		return false;
 }
 
+bool StreamAudioBuffer::create(const decoder_factory_t& decoderFactory)
+{
+	m_decoderFactory = decoderFactory;
+	m_streamDecoder = m_decoderFactory();
+	return bool(m_streamDecoder != nullptr);
+}
+
 void StreamAudioBuffer::destroy()
 {
+	// Cursors own their rings, thus they are detached when cursors are released.
+	m_streamingService = nullptr;
+	m_decoderFactory = nullptr;
 	safeDestroy(m_streamDecoder);
 }
 
+bool StreamAudioBuffer::attach(StreamingService* streamingService)
+{
+	if (!m_decoderFactory || m_streamingService)
+		return false;
+
+	// Shared decoder is no longer used once cursors decode through service.
+	m_streamingService = streamingService;
+	safeDestroy(m_streamDecoder);
+	return true;
+}
+
 Ref< IAudioBufferCursor > StreamAudioBuffer::createCursor() const
 {
-	return new StreamAudioBufferCursor();
+	Ref< StreamAudioBufferCursor > cursor = new StreamAudioBufferCursor();
+	if (m_streamingService)
+	{
+		Ref< IStreamDecoder > streamDecoder = m_decoderFactory();
+		if (!streamDecoder)
+			return nullptr;
+
+		float* samples = (float*)Alloc::acquireAlign(SbcMaxChannelCount * c_maxBlockSize * sizeof(float), 16, T_FILE_LINE);
+		if (!samples)
+		{
+			streamDecoder->destroy();
+			return nullptr;
+		}
+
+		for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+			cursor->m_samples[i] = samples + i * c_maxBlockSize;
+
+		cursor->m_streamingService = m_streamingService;
+		cursor->m_streamRing = m_streamingService->attach(streamDecoder);
+	}
+	return cursor;
 }
 
 bool StreamAudioBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
 {
 	StreamAudioBufferCursor* ssbc = static_cast< StreamAudioBufferCursor* >(cursor);
-	const uint64_t position = ssbc->m_position;
+	if (ssbc->m_streamRing)
+		return readRing(ssbc, outBlock, false);
 
+	if (!m_streamDecoder)
+		return false;
+
+	const uint64_t position = ssbc->m_position;
 	if (m_position > position)
 	{
 		T_DEBUG(L"Rewind stream sound decoder");
@@ -87,4 +187,14 @@ bool StreamAudioBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer*
 	return true;
 }
 
+bool StreamAudioBuffer::skipBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
+{
+	// Without a ring the decoder cannot seek so skipped samples must be decoded here.
+	StreamAudioBufferCursor* ssbc = static_cast< StreamAudioBufferCursor* >(cursor);
+	if (ssbc->m_streamRing)
+		return readRing(ssbc, outBlock, true);
+	else
+		return IAudioBuffer::skipBlock(cursor, mixer, outBlock);
+}
+
 }
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <functional>
 #include "Sound/IAudioBuffer.h"
 
 // import/export mechanism.
@@ -22,6 +23,7 @@ namespace traktor::sound
 {
 
 class IStreamDecoder;
+class StreamingService;
 
 /*! Stream audio buffer.
  * \ingroup Sound
@@ -31,18 +33,39 @@ class T_DLLCLASS StreamAudioBuffer : public IAudioBuffer
 	T_RTTI_CLASS;
 
 public:
+	typedef std::function< Ref< IStreamDecoder > () > decoder_factory_t;
+
 	virtual ~StreamAudioBuffer();
 
+	/*! Create buffer from single decoder, shared by all cursors. */
 	bool create(IStreamDecoder* streamDecoder);
 
+	/*! Create buffer from decoder factory, required in order to attach. */
+	bool create(const decoder_factory_t& decoderFactory);
+
 	void destroy();
 
+	/*! Decode stream ahead of playback through streaming service.
+	 *
+	 * Once attached each new cursor get it's own decoder, owned
+	 * by the service, and samples are read from the cursor's ring
+	 * without blocking the mixer.
+	 *
+	 * \param streamingService Streaming service.
+	 * \return True if successfully attached.
+	 */
+	bool attach(StreamingService* streamingService);
+
 	virtual Ref< IAudioBufferCursor > createCursor() const override final;
 
 	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final;
 
+	virtual bool skipBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final;
+
 private:
+	decoder_factory_t m_decoderFactory;
 	Ref< IStreamDecoder > m_streamDecoder;
+	Ref< StreamingService > m_streamingService;
 	mutable uint64_t m_position = 0;
 };
 
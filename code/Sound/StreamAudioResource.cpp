@@ -6,7 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
-#include "Core/Io/MemoryStream.h"
+#include "Core/Io/ChunkMemory.h"
+#include "Core/Io/ChunkMemoryStream.h"
 #include "Core/Io/Reader.h"
 #include "Core/Io/StreamCopy.h"
 #include "Core/Log/Log.h"
@@ -35,31 +36,42 @@ Ref< Sound > StreamAudioResource::createSound(resource::IResourceManager* resour
 		return nullptr;
 	}
 
+	// Preloaded data is shared by all decoders of sound.
+	Ref< ChunkMemory > memory;
 	if (m_preload)
 	{
-		const int64_t size = stream->available();
+		memory = new ChunkMemory();
+		if (!StreamCopy(new ChunkMemoryStream(memory, false, true), stream).execute())
+			return nullptr;
+	}
+	stream->close();
+	stream = nullptr;
+
+	// Each cursor of streamed sound might need it's own decoder,
+	// thus decoders are created from a factory.
+	const TypeInfo* decoderType = m_decoderType;
+	Ref< const db::Instance > instance = resourceInstance;
+	auto decoderFactory = [=]() -> Ref< IStreamDecoder > {
+		Ref< IStream > stream;
+		if (memory)
+			stream = new ChunkMemoryStream(memory, true, false);
+		else
+			stream = instance->readData(L"Data");
+		if (!stream)
+			return nullptr;
 
-		uint8_t* buffer = new uint8_t [size];
-		for (int64_t i = 0; i < size; )
+		Ref< IStreamDecoder > streamDecoder = checked_type_cast< IStreamDecoder* >(decoderType->createInstance());
+		if (!streamDecoder->create(stream))
 		{
-			const int64_t res = stream->read(&buffer[i], size - i);
-			if (res <= 0)
-				return nullptr;
-			i += res;
+			log::error << L"Unable to create sound, unable to create stream decoder." << Endl;
+			return nullptr;
 		}
 
-		stream = new MemoryStream(buffer, size, true, false, true);
-	}
-
-	Ref< IStreamDecoder > streamDecoder = checked_type_cast< IStreamDecoder* >(m_decoderType->createInstance());
-	if (!streamDecoder->create(stream))
-	{
-		log::error << L"Unable to create sound, unable to create stream decoder." << Endl;
-		return nullptr;
-	}
+		return streamDecoder;
+	};
 
 	Ref< StreamAudioBuffer > soundBuffer = new StreamAudioBuffer();
-	if (!soundBuffer->create(streamDecoder))
+	if (!soundBuffer->create(decoderFactory))
 	{
 		log::error << L"Unable to create sound, unable to create stream sound buffer." << Endl;
 		return nullptr;
@@ -0,0 +1,224 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include "Core/Math/Log2.h"
+#include "Core/Memory/Alloc.h"
+#include "Core/Misc/SafeDestroy.h"
+#include "Sound/IStreamDecoder.h"
+#include "Sound/StreamRing.h"
+
+namespace traktor::sound
+{
+	namespace
+	{
+
+void writeRing(float* ring, uint32_t capacity, uint64_t position, const float* samples, uint32_t samplesCount)
+{
+	const uint32_t offset = uint32_t(position & (capacity - 1));
+	const uint32_t first = std::min(samplesCount, capacity - offset);
+	if (samples)
+	{
+		std::memcpy(ring + offset, samples, first * sizeof(float));
+		std::memcpy(ring, samples + first, (samplesCount - first) * sizeof(float));
+	}
+	else
+	{
+		std::memset(ring + offset, 0, first * sizeof(float));
+		std::memset(ring, 0, (samplesCount - first) * sizeof(float));
+	}
+}
+
+void readRing(const float* ring, uint32_t capacity, uint64_t position, float* samples, uint32_t samplesCount)
+{
+	const uint32_t offset = uint32_t(position & (capacity - 1));
+	const uint32_t first = std::min(samplesCount, capacity - offset);
+	std::memcpy(samples, ring + offset, first * sizeof(float));
+	std::memcpy(samples + first, ring, (samplesCount - first) * sizeof(float));
+}
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.StreamRing", StreamRing, Object)
+
+StreamRing::StreamRing(IStreamDecoder* streamDecoder, uint32_t capacity)
+:	m_streamDecoder(streamDecoder)
+,	m_capacity(nearestLog2(capacity))
+{
+	for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+	{
+		m_samples[i] = nullptr;
+		m_pendingBlock.samples[i] = nullptr;
+	}
+	m_pendingBlock.samplesCount = 0;
+	m_pendingBlock.sampleRate = 0;
+	m_pendingBlock.maxChannel = 0;
+	m_pendingBlock.category = 0;
+}
+
+StreamRing::~StreamRing()
+{
+	destroy();
+}
+
+StreamRing::ReadResult StreamRing::read(uint64_t position, float* const outSamples[SbcMaxChannelCount], uint32_t& inOutSamplesCount, uint32_t& outSampleRate, uint32_t& outMaxChannel)
+{
+	const uint32_t request = m_rewindRequest.load(std::memory_order_relaxed);
+	if (request != m_rewindAcknowledge.load(std::memory_order_acquire))
+		return ReadResult::Rewinding;
+
+	// Cursor is behind ring; need to rewind stream.
+	uint64_t readPosition = m_readPosition.load(std::memory_order_relaxed);
+	if (position < readPosition)
+	{
+		m_rewindRequest.store(request + 1, std::memory_order_release);
+		return ReadResult::Rewinding;
+	}
+
+	// End of stream flag must be read before write position
+	// to ensure last decoded samples are consumed.
+	const bool endOfStream = m_endOfStream.load(std::memory_order_acquire);
+	const uint64_t writePosition = m_writePosition.load(std::memory_order_acquire);
+
+	// Skip samples if cursor is ahead of ring.
+	if (position > readPosition)
+		readPosition = std::min(position, writePosition);
+
+	if (readPosition >= writePosition)
+	{
+		m_readPosition.store(readPosition, std::memory_order_release);
+		if (endOfStream)
+			return ReadResult::End;
+
+		++m_underruns;
+		return ReadResult::Underrun;
+	}
+
+	const uint32_t samplesCount = std::min< uint32_t >(uint32_t(writePosition - readPosition), inOutSamplesCount);
+	const uint32_t maxChannel = m_maxChannel.load(std::memory_order_relaxed);
+
+	if (outSamples)
+	{
+		for (uint32_t i = 0; i < maxChannel; ++i)
+			readRing(m_samples[i], m_capacity, readPosition, outSamples[i], samplesCount);
+	}
+
+	m_readPosition.store(readPosition + samplesCount, std::memory_order_release);
+
+	inOutSamplesCount = samplesCount;
+	outSampleRate = m_sampleRate.load(std::memory_order_relaxed);
+	outMaxChannel = maxChannel;
+	return ReadResult::Available;
+}
+
+bool StreamRing::waitRewound(int32_t timeout)
+{
+	if (m_rewindRequest.load(std::memory_order_relaxed) == m_rewindAcknowledge.load(std::memory_order_acquire))
+		return true;
+
+	m_eventRewound.wait(timeout);
+	return m_rewindRequest.load(std::memory_order_relaxed) == m_rewindAcknowledge.load(std::memory_order_acquire);
+}
+
+bool StreamRing::decode(uint32_t blockSize)
+{
+	if (!m_streamDecoder)
+		return false;
+
+	bool worked = false;
+
+	// Rewind stream if requested by consumer; consumer doesn't touch
+	// positions until rewind has been acknowledged.
+	const uint32_t request = m_rewindRequest.load(std::memory_order_acquire);
+	const bool rewind = bool(request != m_rewindAcknowledge.load(std::memory_order_relaxed));
+	if (rewind)
+	{
+		m_streamDecoder->rewind();
+		m_pendingBlock.samplesCount = 0;
+		m_pendingOffset = 0;
+		m_readPosition.store(0, std::memory_order_relaxed);
+		m_writePosition.store(0, std::memory_order_relaxed);
+		m_endOfStream.store(false, std::memory_order_relaxed);
+		worked = true;
+	}
+
+	if (!m_endOfStream.load(std::memory_order_relaxed))
+	{
+		const uint64_t writePosition = m_writePosition.load(std::memory_order_relaxed);
+		const uint64_t readPosition = m_readPosition.load(std::memory_order_acquire);
+		const uint32_t free = m_capacity - uint32_t(writePosition - readPosition);
+
+		// Decode new block when previous has been completely written.
+		if (m_pendingOffset >= m_pendingBlock.samplesCount && free >= blockSize)
+		{
+			m_pendingBlock.samplesCount = blockSize;
+			m_pendingOffset = 0;
+
+			if (m_streamDecoder->getBlock(m_pendingBlock))
+			{
+				const uint32_t maxChannel = std::min< uint32_t >(m_pendingBlock.maxChannel, SbcMaxChannelCount);
+				for (uint32_t i = 0; i < maxChannel; ++i)
+				{
+					if (!m_samples[i])
+						m_samples[i] = (float*)Alloc::acquireAlign(m_capacity * sizeof(float), 16, T_FILE_LINE);
+				}
+				m_sampleRate.store(m_pendingBlock.sampleRate, std::memory_order_relaxed);
+				m_maxChannel.store(std::max(maxChannel, m_maxChannel.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+			}
+			else
+			{
+				m_pendingBlock.samplesCount = 0;
+				m_endOfStream.store(true, std::memory_order_release);
+			}
+
+			worked = true;
+		}
+
+		// Write as much as possible of pending block into ring.
+		const uint32_t samplesCount = std::min(m_pendingBlock.samplesCount - m_pendingOffset, free);
+		if (samplesCount > 0)
+		{
+			const uint32_t maxChannel = m_maxChannel.load(std::memory_order_relaxed);
+			for (uint32_t i = 0; i < maxChannel; ++i)
+			{
+				const float* samples = (i < m_pendingBlock.maxChannel && m_pendingBlock.samples[i]) ? m_pendingBlock.samples[i] + m_pendingOffset : nullptr;
+				writeRing(m_samples[i], m_capacity, writePosition, samples, samplesCount);
+			}
+
+			m_pendingOffset += samplesCount;
+			m_writePosition.store(writePosition + samplesCount, std::memory_order_release);
+			worked = true;
+		}
+	}
+
+	// Acknowledge rewind after first block has been decoded
+	// so consumer can continue without starving.
+	if (rewind)
+	{
+		m_rewindAcknowledge.store(request, std::memory_order_release);
+		m_eventRewound.pulse();
+	}
+
+	return worked;
+}
+
+void StreamRing::destroy()
+{
+	safeDestroy(m_streamDecoder);
+	for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+	{
+		if (m_samples[i])
+		{
+			Alloc::freeAlign(m_samples[i]);
+			m_samples[i] = nullptr;
+		}
+	}
+}
+
+}
@@ -0,0 +1,123 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Thread/Event.h"
+#include "Sound/Types.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_SOUND_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::sound
+{
+
+class IStreamDecoder;
+
+/*! Read-ahead ring of decoded stream samples.
+ * \ingroup Sound
+ *
+ * Single producer, single consumer ring; the streaming service
+ * decode blocks into the ring from it's background thread
+ * while the mixer thread consume samples without locking.
+ *
+ * Positions are absolute, in samples since last rewind,
+ * a rewind is requested by the consumer and performed
+ * by the producer.
+ */
+class T_DLLCLASS StreamRing : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	enum class ReadResult
+	{
+		Available,	//!< Samples read into block.
+		Rewinding,	//!< Waiting for producer to rewind stream.
+		Underrun,	//!< Producer hasn't decoded enough samples yet.
+		End			//!< End of stream reached.
+	};
+
+	explicit StreamRing(IStreamDecoder* streamDecoder, uint32_t capacity);
+
+	virtual ~StreamRing();
+
+	/*! \name Consumer
+	 * \{ */
+
+	/*! Read samples from ring.
+	 *
+	 * \param position Stream position of first sample to read.
+	 * \param outSamples Destination sample buffers, one per channel; null to skip samples without copying.
+	 * \param inOutSamplesCount Max number of samples to read; number of samples read.
+	 * \param outSampleRate Sample rate of stream.
+	 * \param outMaxChannel Number of channels in stream.
+	 * \return Read result.
+	 */
+	ReadResult read(uint64_t position, float* const outSamples[SbcMaxChannelCount], uint32_t& inOutSamplesCount, uint32_t& outSampleRate, uint32_t& outMaxChannel);
+
+	/*! Wait until producer has performed a pending rewind.
+	 *
+	 * \param timeout Timeout in milliseconds.
+	 * \return True if rewind has been performed.
+	 */
+	bool waitRewound(int32_t timeout);
+
+	/*! \} */
+
+	/*! \name Producer
+	 * \{ */
+
+	/*! Decode next block from stream into ring, if there is room.
+	 *
+	 * \param blockSize Number of samples to request from decoder.
+	 * \return True if any work was performed.
+	 */
+	bool decode(uint32_t blockSize);
+
+	/*! \} */
+
+	/*! Destroy stream decoder; must not be called while producer is decoding. */
+	void destroy();
+
+	/*! Number of times consumer has been starved. */
+	uint32_t getUnderrunCount() const { return m_underruns; }
+
+	/*! Number of samples per channel in ring. */
+	uint32_t getCapacity() const { return m_capacity; }
+
+private:
+	Ref< IStreamDecoder > m_streamDecoder;
+	uint32_t m_capacity;
+	float* m_samples[SbcMaxChannelCount];
+
+	// Producer owned.
+	AudioBlock m_pendingBlock;
+	uint32_t m_pendingOffset = 0;
+
+	// Shared state.
+	std::atomic< uint64_t > m_readPosition = 0;
+	std::atomic< uint64_t > m_writePosition = 0;
+	std::atomic< uint32_t > m_rewindRequest = 0;
+	std::atomic< uint32_t > m_rewindAcknowledge = 0;
+	std::atomic< bool > m_endOfStream = false;
+	std::atomic< uint32_t > m_sampleRate = 0;
+	std::atomic< uint32_t > m_maxChannel = 0;
+	std::atomic< uint32_t > m_underruns = 0;
+	Event m_eventRewound;
+};
+
+}
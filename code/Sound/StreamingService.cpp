@@ -0,0 +1,141 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Core/Log/Log.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Sound/StreamingService.h"
+#include "Sound/StreamRing.h"
+
+namespace traktor::sound
+{
+	namespace
+	{
+
+const uint32_t c_decodeBlockSize = 1024;	//!< Number of samples requested from decoders each time.
+const int32_t c_idleTimeout = 4;			//!< Time, in milliseconds, before polling rings again when all are full.
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.StreamingService", StreamingService, Object)
+
+bool StreamingService::create(uint32_t latency)
+{
+	m_latency = std::max(latency, 4 * c_decodeBlockSize);
+
+	m_thread = ThreadManager::getInstance().create([=, this](){ threadDecode(); }, L"Sound streaming");
+	if (!m_thread)
+		return false;
+
+	m_thread->start(Thread::Above);
+	return true;
+}
+
+void StreamingService::destroy()
+{
+	if (m_thread)
+	{
+		m_thread->stop();
+		ThreadManager::getInstance().destroy(m_thread);
+		m_thread = nullptr;
+	}
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	for (auto ring : m_rings)
+		ring->destroy();
+	for (auto ring : m_retired)
+		ring->destroy();
+	m_rings.clear();
+	m_retired.clear();
+}
+
+Ref< StreamRing > StreamingService::attach(IStreamDecoder* streamDecoder)
+{
+	Ref< StreamRing > ring = new StreamRing(streamDecoder, m_latency);
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		m_rings.push_back(ring);
+	}
+	m_eventWork.pulse();
+	return ring;
+}
+
+void StreamingService::detach(StreamRing* ring)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	if (m_rings.remove(ring))
+	{
+		m_underruns += ring->getUnderrunCount();
+		m_retired.push_back(ring);
+	}
+}
+
+void StreamingService::wakeUp()
+{
+	m_eventWork.pulse();
+}
+
+uint32_t StreamingService::getUnderrunCount() const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	uint32_t underruns = m_underruns;
+	for (auto ring : m_rings)
+		underruns += ring->getUnderrunCount();
+	return underruns;
+}
+
+uint32_t StreamingService::getStreamCount() const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	return (uint32_t)m_rings.size();
+}
+
+void StreamingService::threadDecode()
+{
+	RefArray< StreamRing > rings;
+	RefArray< StreamRing > retired;
+
+	while (!m_thread->stopped())
+	{
+		// Decode one block into each ring per pass; lock is only held
+		// while copying rings so attach and detach never wait for a
+		// decoder. Rings detached during pass are kept alive until
+		// pass is complete.
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+			rings = m_rings;
+		}
+
+		bool worked = false;
+		for (auto ring : rings)
+		{
+			if (m_thread->stopped())
+				break;
+			worked |= ring->decode(c_decodeBlockSize);
+		}
+		rings.clear();
+
+		// Destroy detached rings, and their decoders, outside of lock.
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+			retired.swap(m_retired);
+		}
+		for (auto ring : retired)
+			ring->destroy();
+		retired.clear();
+
+		// All rings full or at end of stream; wait until
+		// consumers have read some samples.
+		if (!worked)
+			m_eventWork.wait(c_idleTimeout);
+	}
+}
+
+}
@@ -0,0 +1,100 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/RefArray.h"
+#include "Core/Thread/Event.h"
+#include "Core/Thread/Semaphore.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_SOUND_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class Thread;
+
+}
+
+namespace traktor::sound
+{
+
+class IStreamDecoder;
+class StreamRing;
+
+/*! Background stream decoding service.
+ * \ingroup Sound
+ *
+ * Decode streamed sounds ahead of playback on a background
+ * thread so disk stalls and decoding spikes doesn't
+ * stall the mixer thread.
+ */
+class T_DLLCLASS StreamingService : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	/*! Create streaming service.
+	 *
+	 * \param latency Number of samples decoded ahead for each stream.
+	 * \return True if service created successfully.
+	 */
+	bool create(uint32_t latency);
+
+	/*! Destroy streaming service.
+	 */
+	void destroy();
+
+	/*! Attach stream decoder to service.
+	 *
+	 * Ownership of decoder is transferred to returned ring,
+	 * decoder must not be used by caller afterwards.
+	 *
+	 * \param streamDecoder Stream decoder.
+	 * \return Ring from which decoded samples are read.
+	 */
+	Ref< StreamRing > attach(IStreamDecoder* streamDecoder);
+
+	/*! Detach ring from service.
+	 *
+	 * Doesn't wait for service; ring, and it's decoder, is
+	 * destroyed by service thread once it's no longer decoded.
+	 *
+	 * \param ring Ring returned from attach.
+	 */
+	void detach(StreamRing* ring);
+
+	/*! Wake up service thread. */
+	void wakeUp();
+
+	/*! Number of times any stream has been starved. */
+	uint32_t getUnderrunCount() const;
+
+	/*! Number of streams currently attached. */
+	uint32_t getStreamCount() const;
+
+private:
+	Thread* m_thread = nullptr;
+	mutable Semaphore m_lock;
+	Event m_eventWork;
+	RefArray< StreamRing > m_rings;
+	RefArray< StreamRing > m_retired;
+	uint32_t m_latency = 0;
+	uint32_t m_underruns = 0;
+
+	void threadDecode();
+};
+
+}
@@ -0,0 +1,310 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Sound/Test/CaseAudioMixing.h"
+
+#include <atomic>
+#include <cmath>
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Thread/Signal.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Sound/AudioChannel.h"
+#include "Sound/AudioDriverNull.h"
+#include "Sound/AudioSystem.h"
+#include "Sound/IAudioBuffer.h"
+#include "Sound/IAudioDriver.h"
+#include "Sound/IAudioMixer.h"
+
+namespace traktor::sound::test
+{
+namespace
+{
+
+const uint32_t c_sampleRate = 44100;
+const uint32_t c_frameSamples = 512;
+
+/*! Capture first sample of a number of submitted blocks. */
+class CaptureAudioDriver : public RefCountImpl< IAudioDriver >
+{
+public:
+	Signal m_signal;
+	int32_t m_skip = 8;
+	float m_sample = 0.0f;
+
+	virtual bool create(const SystemApplication& sysapp, const AudioDriverCreateDesc& desc, Ref< IAudioMixer >& outMixer) override final
+	{
+		return true;
+	}
+
+	virtual void destroy() override final
+	{
+	}
+
+	virtual void wait() override final
+	{
+		if (m_skip <= 0)
+			ThreadManager::getInstance().getCurrentThread()->sleep(1);
+	}
+
+	virtual void submit(const AudioBlock& block) override final
+	{
+		if (m_skip > 0 && --m_skip == 0)
+		{
+			m_sample = block.samples[0][0];
+			m_signal.set();
+		}
+	}
+};
+
+/*! Constant signal, easy to verify mixed result. */
+class ConstantAudioBuffer : public IAudioBuffer
+{
+public:
+	struct Cursor : public RefCountImpl< IAudioBufferCursor >
+	{
+		float m_samples[c_frameSamples];
+
+		virtual void setParameter(handle_t id, float parameter) override final {}
+
+		virtual void disableRepeat() override final {}
+
+		virtual void reset() override final {}
+	};
+
+	virtual Ref< IAudioBufferCursor > createCursor() const override final
+	{
+		Ref< Cursor > cursor = new Cursor();
+		for (uint32_t i = 0; i < c_frameSamples; ++i)
+			cursor->m_samples[i] = 0.01f;
+		return cursor;
+	}
+
+	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final
+	{
+		Cursor* c = static_cast< Cursor* >(cursor);
+		outBlock.samples[0] = c->m_samples;
+		outBlock.samplesCount = c_frameSamples;
+		outBlock.sampleRate = c_sampleRate;
+		outBlock.maxChannel = 1;
+		return true;
+	}
+};
+
+/*! Silent one-shot sound, ends after a fixed number of blocks. */
+class FiniteAudioBuffer : public IAudioBuffer
+{
+public:
+	struct Cursor : public RefCountImpl< IAudioBufferCursor >
+	{
+		float m_samples[c_frameSamples];
+		uint32_t m_blocksLeft = 16;
+
+		virtual void setParameter(handle_t id, float parameter) override final {}
+
+		virtual void disableRepeat() override final {}
+
+		virtual void reset() override final { m_blocksLeft = 16; }
+	};
+
+	virtual Ref< IAudioBufferCursor > createCursor() const override final
+	{
+		Ref< Cursor > cursor = new Cursor();
+		for (uint32_t i = 0; i < c_frameSamples; ++i)
+			cursor->m_samples[i] = 0.0f;
+		return cursor;
+	}
+
+	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final
+	{
+		Cursor* c = static_cast< Cursor* >(cursor);
+		if (c->m_blocksLeft == 0)
+			return false;
+		--c->m_blocksLeft;
+		++m_decoded;
+		outBlock.samples[0] = c->m_samples;
+		outBlock.samplesCount = c_frameSamples;
+		outBlock.sampleRate = c_sampleRate;
+		outBlock.maxChannel = 1;
+		return true;
+	}
+
+	virtual bool skipBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final
+	{
+		Cursor* c = static_cast< Cursor* >(cursor);
+		if (c->m_blocksLeft == 0)
+			return false;
+		--c->m_blocksLeft;
+		outBlock.samplesCount = c_frameSamples;
+		outBlock.sampleRate = c_sampleRate;
+		outBlock.maxChannel = 1;
+		return true;
+	}
+
+	uint32_t getDecodedCount() const { return m_decoded; }
+
+private:
+	mutable std::atomic< uint32_t > m_decoded = 0;
+};
+
+/*! Synthesized tone, costs about as much as decoding a compressed stream. */
+class ToneAudioBuffer : public IAudioBuffer
+{
+public:
+	struct Cursor : public RefCountImpl< IAudioBufferCursor >
+	{
+		alignas(16) float m_samples[2][c_frameSamples];
+		float m_frequency = 0.0f;
+		uint32_t m_position = 0;
+
+		virtual void setParameter(handle_t id, float parameter) override final {}
+
+		virtual void disableRepeat() override final {}
+
+		virtual void reset() override final { m_position = 0; }
+	};
+
+	virtual Ref< IAudioBufferCursor > createCursor() const override final
+	{
+		Ref< Cursor > cursor = new Cursor();
+		cursor->m_frequency = 220.0f + 10.0f * float(m_count++ % 64);
+		return cursor;
+	}
+
+	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final
+	{
+		Cursor* c = static_cast< Cursor* >(cursor);
+		const float k = TWO_PI * c->m_frequency / c_sampleRate;
+		for (uint32_t i = 0; i < c_frameSamples; ++i)
+		{
+			const float s = std::sin(k * float(c->m_position + i));
+			c->m_samples[0][i] = s * 0.01f;
+			c->m_samples[1][i] = s * 0.02f;
+		}
+		c->m_position += c_frameSamples;
+
+		outBlock.samples[0] = c->m_samples[0];
+		outBlock.samples[1] = c->m_samples[1];
+		outBlock.samplesCount = c_frameSamples;
+		outBlock.sampleRate = c_sampleRate;
+		outBlock.maxChannel = 2;
+		return true;
+	}
+
+private:
+	mutable uint32_t m_count = 0;
+};
+
+AudioSystemCreateDesc createDesc(uint32_t channels, uint32_t activeChannels, uint32_t mixerThreads, uint32_t hwChannels)
+{
+	AudioSystemCreateDesc desc;
+	desc.channels = channels;
+	desc.activeChannels = activeChannels;
+	desc.mixerThreads = mixerThreads;
+	desc.driverDesc.sampleRate = c_sampleRate;
+	desc.driverDesc.bitsPerSample = 16;
+	desc.driverDesc.hwChannels = hwChannels;
+	desc.driverDesc.frameSamples = c_frameSamples;
+	return desc;
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.test.CaseAudioMixing", 0, CaseAudioMixing, traktor::test::Case)
+
+void CaseAudioMixing::run()
+{
+	// Inaudible channels and channels beyond active limit must be virtual,
+	// result must be same independent of number of mixer threads, no threads
+	// is same as only using mixer thread.
+	for (uint32_t mixerThreads : { 0, 1, 4 })
+	{
+		Ref< CaptureAudioDriver > audioDriver = new CaptureAudioDriver();
+		Ref< AudioSystem > audioSystem = new AudioSystem(audioDriver);
+
+		const bool result = audioSystem->create(createDesc(64, 32, mixerThreads, 1));
+		CASE_ASSERT(result);
+		if (!result)
+			return;
+
+		Ref< ConstantAudioBuffer > audioBuffer = new ConstantAudioBuffer();
+		for (uint32_t i = 0; i < 64; ++i)
+		{
+			AudioChannel* channel = audioSystem->getChannel(i);
+			channel->setVolume(i < 16 ? 0.0f : 1.0f);
+			channel->play(audioBuffer, 0, 0.0f, false, 0);
+		}
+
+		audioDriver->m_signal.wait();
+
+		uint32_t activeChannels = 0, virtualChannels = 0;
+		audioSystem->getChannelCounts(activeChannels, virtualChannels);
+
+		CASE_ASSERT_EQUAL(activeChannels, 32);
+		CASE_ASSERT_EQUAL(virtualChannels, 32);
+		CASE_ASSERT(audioSystem->getChannel(0)->isVirtual());
+		CASE_ASSERT(std::abs(audioDriver->m_sample - 32 * 0.01f) < 0.0001f);
+
+		audioSystem->destroy();
+	}
+
+	// Virtual channels must keep advancing; non repeating sounds end even if never audible.
+	{
+		Ref< AudioSystem > audioSystem = new AudioSystem(new AudioDriverNull());
+
+		const bool result = audioSystem->create(createDesc(2, 0, 1, 1));
+		CASE_ASSERT(result);
+		if (!result)
+			return;
+
+		Ref< FiniteAudioBuffer > audioBuffer = new FiniteAudioBuffer();
+		AudioChannel* channel = audioSystem->getChannel(0);
+		channel->setVolume(0.0f);
+		channel->play(audioBuffer, 0, 0.0f, false, 0);
+
+		// 16 blocks is less than 0.2 seconds of audio.
+		for (int32_t i = 0; i < 100 && channel->isPlaying(); ++i)
+			ThreadManager::getInstance().getCurrentThread()->sleep(10);
+
+		CASE_ASSERT(!channel->isPlaying());
+		CASE_ASSERT_EQUAL(audioBuffer->getDecodedCount(), 0);
+
+		audioSystem->destroy();
+	}
+
+	// Measure how many voices can be mixed within a block deadline.
+	const double deadline = double(c_frameSamples) / c_sampleRate;
+	for (uint32_t mixerThreads = 1; mixerThreads <= 4; mixerThreads *= 2)
+	{
+		Ref< AudioSystem > audioSystem = new AudioSystem(new AudioDriverNull());
+
+		const bool result = audioSystem->create(createDesc(512, 0, mixerThreads, 2));
+		CASE_ASSERT(result);
+		if (!result)
+			return;
+
+		Ref< ToneAudioBuffer > audioBuffer = new ToneAudioBuffer();
+		for (uint32_t i = 0; i < 512; ++i)
+			audioSystem->getChannel(i)->play(audioBuffer, 0, 0.0f, true, 0);
+
+		ThreadManager::getInstance().getCurrentThread()->sleep(500);
+
+		double mixerTime = 0.0;
+		audioSystem->getThreadPerformances(mixerTime);
+
+		uint32_t activeChannels = 0, virtualChannels = 0;
+		audioSystem->getChannelCounts(activeChannels, virtualChannels);
+
+		log::info << L"Audio mixing, " << mixerThreads << L" thread(s); " << activeChannels << L" voices in " << mixerTime * 1000.0 << L" ms, " << int32_t(activeChannels * deadline / std::max(mixerTime, 1e-6)) << L" voices per block deadline (" << deadline * 1000.0 << L" ms)" << Endl;
+
+		audioSystem->destroy();
+	}
+}
+
+}
@@ -0,0 +1,272 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Sound/Test/CaseAudioStreaming.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include "Core/Log/Log.h"
+#include "Core/RefArray.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
+#include "Sound/IStreamDecoder.h"
+#include "Sound/StreamAudioBuffer.h"
+#include "Sound/StreamingService.h"
+
+namespace traktor::sound::test
+{
+namespace
+{
+
+const uint32_t c_sampleRate = 44100;
+const uint32_t c_frameSamples = 512;
+
+/*! Synthetic decoder; sample value is position in stream, with
+ * simulated decoding cost and periodic disk stalls.
+ */
+class SyntheticStreamDecoder : public IStreamDecoder
+{
+public:
+	explicit SyntheticStreamDecoder(uint32_t length, double decodeCost, int32_t stallEvery, int32_t stallDuration)
+	:	m_length(length)
+	,	m_decodeCost(decodeCost)
+	,	m_stallEvery(stallEvery)
+	,	m_stallDuration(stallDuration)
+	{
+	}
+
+	virtual bool create(IStream* stream) override final
+	{
+		return true;
+	}
+
+	virtual void destroy() override final
+	{
+		m_destroyed = true;
+	}
+
+	virtual double getDuration() const override final
+	{
+		return double(m_length) / c_sampleRate;
+	}
+
+	virtual bool getBlock(AudioBlock& outBlock) override final
+	{
+		if (m_position >= m_length)
+			return false;
+
+		const uint32_t samplesCount = std::min< uint32_t >(std::min< uint32_t >(outBlock.samplesCount, 1024), m_length - m_position);
+		for (uint32_t i = 0; i < samplesCount; ++i)
+		{
+			m_samples[0][i] = float(m_position + i);
+			m_samples[1][i] = -float(m_position + i);
+		}
+		m_position += samplesCount;
+
+		// Simulate decoding cost.
+		if (m_decodeCost > 0.0)
+		{
+			Timer timer;
+			while (timer.getElapsedTime() < m_decodeCost)
+				;
+		}
+
+		// Simulate disk stall.
+		if (m_stallEvery > 0 && (++m_blocks % m_stallEvery) == 0)
+			ThreadManager::getInstance().getCurrentThread()->sleep(m_stallDuration);
+
+		outBlock.samples[0] = m_samples[0];
+		outBlock.samples[1] = m_samples[1];
+		outBlock.samplesCount = samplesCount;
+		outBlock.sampleRate = c_sampleRate;
+		outBlock.maxChannel = 2;
+		return true;
+	}
+
+	virtual void rewind() override final
+	{
+		m_position = 0;
+	}
+
+	bool isDestroyed() const { return m_destroyed; }
+
+private:
+	uint32_t m_length;
+	double m_decodeCost;
+	int32_t m_stallEvery;
+	int32_t m_stallDuration;
+	uint32_t m_position = 0;
+	int32_t m_blocks = 0;
+	std::atomic< bool > m_destroyed = false;
+	float m_samples[2][1024];
+};
+
+/*! Read entire stream through cursor, verify all samples are in sequence. */
+bool readStream(const StreamAudioBuffer* buffer, IAudioBufferCursor* cursor, uint32_t length)
+{
+	uint32_t position = 0;
+	for (int32_t stalls = 0; stalls < 1000; )
+	{
+		AudioBlock block = { { 0 }, c_frameSamples, 0, 0 };
+		if (!buffer->getBlock(cursor, nullptr, block))
+			break;
+
+		if (block.samplesCount == 0)
+		{
+			ThreadManager::getInstance().getCurrentThread()->sleep(1);
+			++stalls;
+			continue;
+		}
+
+		if (block.maxChannel != 2 || block.sampleRate != c_sampleRate)
+			return false;
+
+		for (uint32_t i = 0; i < block.samplesCount; ++i)
+		{
+			if (block.samples[0][i] != float(position + i) || block.samples[1][i] != -float(position + i))
+				return false;
+		}
+		position += block.samplesCount;
+	}
+	return position == length;
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.test.CaseAudioStreaming", 0, CaseAudioStreaming, traktor::test::Case)
+
+void CaseAudioStreaming::run()
+{
+	// Samples read through ring must be identical to decoded samples, also after
+	// rewind; each cursor has it's own ring thus cursors doesn't interfere.
+	{
+		Ref< StreamingService > streamingService = new StreamingService();
+		CASE_ASSERT(streamingService->create(4096));
+
+		Ref< StreamAudioBuffer > buffer = new StreamAudioBuffer();
+		CASE_ASSERT(buffer->create([]() { return new SyntheticStreamDecoder(20000, 0.0, 0, 0); }));
+		CASE_ASSERT(buffer->attach(streamingService));
+
+		Ref< IAudioBufferCursor > cursor = buffer->createCursor();
+		CASE_ASSERT(readStream(buffer, cursor, 20000));
+
+		cursor->reset();
+		CASE_ASSERT(readStream(buffer, cursor, 20000));
+
+		Ref< IAudioBufferCursor > cursor2 = buffer->createCursor();
+		CASE_ASSERT_EQUAL(streamingService->getStreamCount(), 2);
+
+		cursor->reset();
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			AudioBlock block = { { 0 }, c_frameSamples, 0, 0 };
+			buffer->getBlock(cursor2, nullptr, block);
+		}
+		CASE_ASSERT(readStream(buffer, cursor, 20000));
+
+		buffer->destroy();
+		cursor = nullptr;
+		cursor2 = nullptr;
+		CASE_ASSERT_EQUAL(streamingService->getStreamCount(), 0);
+
+		streamingService->destroy();
+	}
+
+	// Releasing a cursor must not wait for decoder; streams still attached
+	// are destroyed along with service.
+	{
+		Ref< StreamingService > streamingService = new StreamingService();
+		CASE_ASSERT(streamingService->create(4096));
+
+		Ref< SyntheticStreamDecoder > stallingDecoder = new SyntheticStreamDecoder(~0U, 0.0, 1, 200);
+		Ref< SyntheticStreamDecoder > attachedDecoder = new SyntheticStreamDecoder(~0U, 0.0, 0, 0);
+
+		Ref< StreamAudioBuffer > stallingBuffer = new StreamAudioBuffer();
+		CASE_ASSERT(stallingBuffer->create([=]() { return stallingDecoder; }));
+		CASE_ASSERT(stallingBuffer->attach(streamingService));
+
+		Ref< StreamAudioBuffer > attachedBuffer = new StreamAudioBuffer();
+		CASE_ASSERT(attachedBuffer->create([=]() { return attachedDecoder; }));
+		CASE_ASSERT(attachedBuffer->attach(streamingService));
+
+		Ref< IAudioBufferCursor > stallingCursor = stallingBuffer->createCursor();
+		Ref< IAudioBufferCursor > attachedCursor = attachedBuffer->createCursor();
+
+		// Let service begin decoding stalling stream.
+		ThreadManager::getInstance().getCurrentThread()->sleep(50);
+
+		Timer timer;
+		stallingCursor = nullptr;
+		CASE_ASSERT_COMPARE(timer.getElapsedTime(), 0.1, std::less< double >());
+		CASE_ASSERT_EQUAL(streamingService->getStreamCount(), 1);
+
+		streamingService->destroy();
+		CASE_ASSERT(stallingDecoder->isDestroyed());
+		CASE_ASSERT(attachedDecoder->isDestroyed());
+
+		attachedCursor = nullptr;
+		stallingBuffer->destroy();
+		attachedBuffer->destroy();
+	}
+
+	// Measure number of simultaneous streams sustainable without underruns; each
+	// decoded block cost 0.1 ms and every 128th block stall 20 ms on disk.
+	const double deadline = double(c_frameSamples) / c_sampleRate;
+	for (uint32_t streamCount = 8; streamCount <= 256; streamCount *= 2)
+	{
+		Ref< StreamingService > streamingService = new StreamingService();
+		CASE_ASSERT(streamingService->create(c_sampleRate / 4));
+
+		RefArray< StreamAudioBuffer > buffers;
+		RefArray< IAudioBufferCursor > cursors;
+		for (uint32_t i = 0; i < streamCount; ++i)
+		{
+			Ref< StreamAudioBuffer > buffer = new StreamAudioBuffer();
+			buffer->create([]() { return new SyntheticStreamDecoder(~0U, 0.0001, 128, 20); });
+			buffer->attach(streamingService);
+			buffers.push_back(buffer);
+			cursors.push_back(buffer->createCursor());
+		}
+
+		// Let service fill rings before playback begin.
+		ThreadManager::getInstance().getCurrentThread()->sleep(300);
+		const uint32_t underrunsBefore = streamingService->getUnderrunCount();
+
+		// Consume streams in real time as mixer would.
+		Timer timer;
+		double mixerTime = 0.0;
+		const int32_t frames = int32_t(2.0 / deadline);
+		for (int32_t frame = 0; frame < frames; ++frame)
+		{
+			const double start = timer.getElapsedTime();
+			for (uint32_t i = 0; i < streamCount; ++i)
+			{
+				AudioBlock block = { { 0 }, c_frameSamples, 0, 0 };
+				buffers[i]->getBlock(cursors[i], nullptr, block);
+			}
+			mixerTime += timer.getElapsedTime() - start;
+
+			const double wait = (frame + 1) * deadline - timer.getElapsedTime();
+			if (wait > 0.0)
+				ThreadManager::getInstance().getCurrentThread()->sleep(int32_t(wait * 1000.0));
+		}
+
+		const uint32_t underruns = streamingService->getUnderrunCount() - underrunsBefore;
+		log::info << L"Audio streaming, " << streamCount << L" streams; " << underruns << L" underrun(s), " << mixerTime * 1000.0 / frames << L" ms mixer time per block" << Endl;
+
+		cursors.clear();
+		for (auto buffer : buffers)
+			buffer->destroy();
+
+		streamingService->destroy();
+	}
+}
+
+}
@@ -0,0 +1,238 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Sound/Test/CaseGraphEvaluator.h"
+
+#include <cmath>
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Timer/Timer.h"
+#include "Sound/AudioMixer.h"
+#include "Sound/IAudioBuffer.h"
+#include "Sound/Processor/Edge.h"
+#include "Sound/Processor/Graph.h"
+#include "Sound/Processor/GraphBuffer.h"
+#include "Sound/Processor/ImmutableNode.h"
+#include "Sound/Processor/Nodes/Add.h"
+#include "Sound/Processor/Nodes/Blend.h"
+#include "Sound/Processor/Nodes/Multiply.h"
+#include "Sound/Processor/Nodes/Output.h"
+#include "Sound/Processor/Nodes/Sine.h"
+
+namespace traktor::sound::test
+{
+namespace
+{
+
+const int32_t c_benchmarkBlocks = 2000;
+
+const ImmutableNode::OutputPinDesc c_Constant_o[] =
+{
+	{ L"Output", NodePinType::Scalar },
+	{ 0 }
+};
+
+class ConstantCursor : public RefCountImpl< IAudioBufferCursor >
+{
+public:
+	virtual void setParameter(handle_t id, float parameter) override final {}
+
+	virtual void disableRepeat() override final {}
+
+	virtual void reset() override final {}
+};
+
+/*! Scalar constant node, only used by tests. */
+class Constant : public ImmutableNode
+{
+	T_RTTI_CLASS;
+
+public:
+	explicit Constant(float value = 0.0f)
+	:	ImmutableNode(nullptr, c_Constant_o)
+	,	m_value(value)
+	{
+	}
+
+	virtual bool bind(resource::IResourceManager* resourceManager) override final { return true; }
+
+	virtual Ref< IAudioBufferCursor > createCursor() const override final { return new ConstantCursor(); }
+
+	virtual bool getScalar(IAudioBufferCursor* cursor, const GraphEvaluator* evaluator, float& outScalar) const override final
+	{
+		outScalar = m_value;
+		return true;
+	}
+
+	virtual bool getBlock(IAudioBufferCursor* cursor, const GraphEvaluator* evaluator, const IAudioMixer* mixer, AudioBlock& outBlock) const override final { return false; }
+
+private:
+	float m_value;
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.test.Constant", Constant, ImmutableNode)
+
+class GraphBuilder
+{
+public:
+	template < typename NodeType, typename ... ArgumentTypes >
+	NodeType* node(ArgumentTypes ... arguments)
+	{
+		NodeType* n = new NodeType(arguments ...);
+		m_nodes.push_back(n);
+		return n;
+	}
+
+	void edge(const Node* from, const Node* to, int32_t toPin)
+	{
+		m_edges.push_back(new Edge(from->getOutputPin(0), to->getInputPin(toPin)));
+	}
+
+	Ref< Graph > create()
+	{
+		return new Graph(m_nodes, m_edges);
+	}
+
+private:
+	RefArray< Node > m_nodes;
+	RefArray< Edge > m_edges;
+};
+
+Node* sine(GraphBuilder& gb, float frequency, float amplitude)
+{
+	Node* n = gb.node< Sine >();
+	gb.edge(gb.node< Constant >(frequency), n, 0);
+	gb.edge(gb.node< Constant >(amplitude), n, 1);
+	return n;
+}
+
+/*! Single sine shared by three consumers. */
+Ref< Graph > createSharedGraph()
+{
+	GraphBuilder gb;
+
+	Node* s = sine(gb, 440.0f, 0.5f);
+
+	Node* add = gb.node< Add >();
+	gb.edge(s, add, 0);
+	gb.edge(s, add, 1);
+
+	Node* blend = gb.node< Blend >();
+	gb.edge(add, blend, 0);
+	gb.edge(s, blend, 1);
+	gb.edge(gb.node< Constant >(0.5f), blend, 2);
+
+	Node* output = gb.node< Output >();
+	gb.edge(blend, output, 0);
+
+	return gb.create();
+}
+
+/*! Eight sines, modulated and mixed, then blended with a shared sine. */
+Ref< Graph > createMixGraph()
+{
+	GraphBuilder gb;
+
+	Node* shared = sine(gb, 110.0f, 0.5f);
+
+	Node* mix = nullptr;
+	for (int32_t i = 0; i < 8; ++i)
+	{
+		Node* mul = gb.node< Multiply >();
+		gb.edge(sine(gb, 220.0f + i * 55.0f, 0.1f), mul, 0);
+		gb.edge(shared, mul, 1);
+
+		if (mix)
+		{
+			Node* add = gb.node< Add >();
+			gb.edge(mix, add, 0);
+			gb.edge(mul, add, 1);
+			mix = add;
+		}
+		else
+			mix = mul;
+	}
+
+	Node* blend = gb.node< Blend >();
+	gb.edge(mix, blend, 0);
+	gb.edge(shared, blend, 1);
+	gb.edge(gb.node< Constant >(0.25f), blend, 2);
+
+	Node* output = gb.node< Output >();
+	gb.edge(blend, output, 0);
+
+	return gb.create();
+}
+
+double benchmark(const Graph* graph, const IAudioMixer* mixer)
+{
+	Ref< GraphBuffer > buffer = new GraphBuffer(graph);
+	Ref< IAudioBufferCursor > cursor = buffer->createCursor();
+	if (!cursor)
+		return 0.0;
+
+	Timer timer;
+	for (int32_t i = 0; i < c_benchmarkBlocks; ++i)
+	{
+		AudioBlock block = { { 0 }, 1024, 0, 0 };
+		buffer->getBlock(cursor, mixer, block);
+	}
+	return timer.getElapsedTime() / c_benchmarkBlocks;
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.test.CaseGraphEvaluator", 0, CaseGraphEvaluator, traktor::test::Case)
+
+void CaseGraphEvaluator::run()
+{
+	Ref< IAudioMixer > mixer = new AudioMixer();
+
+	// Output shared by multiple consumers must be evaluated once and each
+	// consumer must get an unmodified block; (s + s) * 0.5 + s * 0.5 = 1.5 s
+	{
+		Ref< Graph > graph = createSharedGraph();
+		Ref< GraphBuffer > buffer = new GraphBuffer(graph);
+		Ref< IAudioBufferCursor > cursor = buffer->createCursor();
+		CASE_ASSERT(cursor != nullptr);
+		if (!cursor)
+			return;
+
+		const float k = TWO_PI * 440.0f;
+		float t = 0.0f;
+
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			AudioBlock block = { { 0 }, 1024, 0, 0 };
+			CASE_ASSERT(buffer->getBlock(cursor, mixer, block));
+			CASE_ASSERT_EQUAL(block.samplesCount, 1024);
+			CASE_ASSERT(block.samples[0] != nullptr);
+			if (!block.samples[0])
+				return;
+
+			float maxError = 0.0f;
+			for (uint32_t j = 0; j < block.samplesCount; ++j)
+			{
+				const float expected = 1.5f * 0.5f * std::sin(t * k);
+				maxError = std::max(maxError, std::abs(block.samples[0][j] - expected));
+				t += 1.0f / 44100.0f;
+			}
+			CASE_ASSERT(maxError < 0.001f);
+		}
+	}
+
+	// Measure block evaluation time of typical graphs.
+	{
+		const double sharedTime = benchmark(createSharedGraph(), mixer);
+		const double mixTime = benchmark(createMixGraph(), mixer);
+		log::info << L"Graph evaluation, shared sine; " << sharedTime * 1000000.0 << L" us/block" << Endl;
+		log::info << L"Graph evaluation, 9 sine mix; " << mixTime * 1000000.0 << L" us/block" << Endl;
+	}
+}
+
+}
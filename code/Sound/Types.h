@@ -82,11 +82,17 @@ struct AudioSystemCreateDesc
 {
 	SystemApplication sysapp;
 	uint32_t channels;									//!< Number of virtual channels.
+	uint32_t activeChannels;							//!< Max number of channels decoded and mixed each block, less audible channels are virtual; 0 if no limit.
+	uint32_t mixerThreads;								//!< Number of threads decoding and mixing channels, including mixer thread.
+	uint32_t streamLatency;								//!< Read-ahead, in milliseconds, of streams decoded on background thread; 0 if streams are decoded by mixer.
 	AudioDriverCreateDesc driverDesc;					//!< Driver create description.
 	float cm[SbcMaxChannelCount][SbcMaxChannelCount];	//!< Final combine matrix.
 
 	AudioSystemCreateDesc()
 	:	channels(0)
+	,	activeChannels(0)
+	,	mixerThreads(1)
+	,	streamLatency(0)
 	{
 		for (int32_t i = 0; i < SbcMaxChannelCount; ++i)
 			for (int32_t j = 0; j < SbcMaxChannelCount; ++j)
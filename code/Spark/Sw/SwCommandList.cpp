@@ -0,0 +1,302 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Math/MathUtils.h"
+#include "Drawing/Image.h"
+#include "Spark/Sw/SwCommandList.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace traktor::spark
+{
+
+SwCommandList::SwCommandList()
+{
+	reset();
+}
+
+void SwCommandList::reset()
+{
+	m_image = nullptr;
+	m_mask = nullptr;
+	m_styles.resize(0);
+	m_colors.resize(0);
+	m_commands.resize(0);
+	m_batches.resize(0);
+	m_firstStyle = 0;
+	m_firstCommand = 0;
+	m_mn[0] = m_mn[1] = std::numeric_limits< float >::max();
+	m_mx[0] = m_mx[1] = -std::numeric_limits< float >::max();
+	m_strokeWidth = 0.0f;
+}
+
+void SwCommandList::setTarget(drawing::Image* image, drawing::Image* mask)
+{
+	m_image = image;
+	m_mask = mask;
+}
+
+void SwCommandList::clearStyles()
+{
+	m_firstStyle = (uint32_t)m_styles.size();
+}
+
+int32_t SwCommandList::defineSolidStyle(const Color4f& color)
+{
+	auto& style = m_styles.push_back();
+	style.type = StyleType::Solid;
+	style.repeat = false;
+	style.color = color;
+	style.firstColor = 0;
+	style.colorCount = 0;
+	return (int32_t)(m_styles.size() - m_firstStyle - 1);
+}
+
+int32_t SwCommandList::defineLinearGradientStyle(const Matrix33& gradientMatrix, const AlignedVector< std::pair< Color4f, float > >& colors)
+{
+	auto& style = m_styles.push_back();
+	style.type = StyleType::LinearGradient;
+	style.repeat = false;
+	style.matrix = gradientMatrix;
+	style.firstColor = (uint32_t)m_colors.size();
+	style.colorCount = (uint32_t)colors.size();
+	m_colors.insert(m_colors.end(), colors.begin(), colors.end());
+	return (int32_t)(m_styles.size() - m_firstStyle - 1);
+}
+
+int32_t SwCommandList::defineRadialGradientStyle(const Matrix33& gradientMatrix, const AlignedVector< std::pair< Color4f, float > >& colors)
+{
+	auto& style = m_styles.push_back();
+	style.type = StyleType::RadialGradient;
+	style.repeat = false;
+	style.matrix = gradientMatrix;
+	style.firstColor = (uint32_t)m_colors.size();
+	style.colorCount = (uint32_t)colors.size();
+	m_colors.insert(m_colors.end(), colors.begin(), colors.end());
+	return (int32_t)(m_styles.size() - m_firstStyle - 1);
+}
+
+int32_t SwCommandList::defineImageStyle(const Matrix33& imageMatrix, const drawing::Image* image, bool repeat)
+{
+	auto& style = m_styles.push_back();
+	style.type = StyleType::Image;
+	style.repeat = repeat;
+	style.matrix = imageMatrix;
+	style.firstColor = 0;
+	style.colorCount = 0;
+	style.image = image;
+	return (int32_t)(m_styles.size() - m_firstStyle - 1);
+}
+
+void SwCommandList::clear()
+{
+	auto& command = m_commands.push_back();
+	command.op = Op::Clear;
+}
+
+void SwCommandList::moveTo(const Vector2& p)
+{
+	auto& command = m_commands.push_back();
+	command.op = Op::MoveTo;
+	command.v[0] = p.x;
+	command.v[1] = p.y;
+	include(p);
+}
+
+void SwCommandList::lineTo(const Vector2& p)
+{
+	auto& command = m_commands.push_back();
+	command.op = Op::LineTo;
+	command.v[0] = p.x;
+	command.v[1] = p.y;
+	include(p);
+}
+
+void SwCommandList::quadricTo(const Vector2& p, const Vector2& c)
+{
+	auto& command = m_commands.push_back();
+	command.op = Op::QuadricTo;
+	command.v[0] = p.x;
+	command.v[1] = p.y;
+	command.v[2] = c.x;
+	command.v[3] = c.y;
+
+	// Curve is contained within hull of its control points.
+	include(p);
+	include(c);
+}
+
+void SwCommandList::fill(int32_t style0, int32_t style1, drawing::Raster::FillRule fillRule)
+{
+	auto& command = m_commands.push_back();
+	command.op = Op::Fill;
+	command.rule = (uint8_t)fillRule;
+	command.style0 = style0;
+	command.style1 = style1;
+}
+
+void SwCommandList::stroke(int32_t style, float width, drawing::Raster::StrokeJoin join, drawing::Raster::StrokeCap cap)
+{
+	auto& command = m_commands.push_back();
+	command.op = Op::Stroke;
+	command.rule = (uint8_t)join;
+	command.cap = (uint8_t)cap;
+	command.style0 = style;
+	command.v[0] = width;
+	m_strokeWidth = std::max(m_strokeWidth, width);
+}
+
+void SwCommandList::submit(const Rect& cull)
+{
+	Rect bounds;
+	if (m_mn[0] <= m_mx[0])
+	{
+		// Pad bounds with stroke width, covers both round joins and square caps.
+		// Clamp before converting to integers as path might extend far outside.
+		const float pad = m_strokeWidth + 1.0f;
+		bounds.x0 = (int32_t)clamp(std::floor(m_mn[0] - pad), (float)cull.x0, (float)cull.x1);
+		bounds.y0 = (int32_t)clamp(std::floor(m_mn[1] - pad), (float)cull.y0, (float)cull.y1);
+		bounds.x1 = (int32_t)clamp(std::ceil(m_mx[0] + pad) + 1.0f, (float)cull.x0, (float)cull.x1);
+		bounds.y1 = (int32_t)clamp(std::ceil(m_mx[1] + pad) + 1.0f, (float)cull.y0, (float)cull.y1);
+	}
+
+	if (!bounds.empty() && m_image != nullptr)
+	{
+		auto& batch = m_batches.push_back();
+		batch.image = m_image;
+		batch.mask = m_mask;
+		batch.firstStyle = m_firstStyle;
+		batch.styleCount = (uint32_t)m_styles.size() - m_firstStyle;
+		batch.firstCommand = m_firstCommand;
+		batch.commandCount = (uint32_t)m_commands.size() - m_firstCommand;
+		batch.bounds = bounds;
+	}
+	else
+		m_commands.resize(m_firstCommand);
+
+	m_firstCommand = (uint32_t)m_commands.size();
+	m_mn[0] = m_mn[1] = std::numeric_limits< float >::max();
+	m_mx[0] = m_mx[1] = -std::numeric_limits< float >::max();
+	m_strokeWidth = 0.0f;
+}
+
+void SwCommandList::replay(drawing::Raster& raster, const uint32_t* batches, uint32_t batchCount, const Rect& clip) const
+{
+	const drawing::Image* image = nullptr;
+	const drawing::Image* mask = nullptr;
+	uint32_t firstStyle = ~0U;
+	uint32_t styleCount = ~0U;
+
+	for (uint32_t i = 0; i < batchCount; ++i)
+	{
+		const Batch& batch = m_batches[batches[i]];
+
+		// Raster implementation is recreated when image change, thus
+		// clip and styles must be set again.
+		if (batch.image.ptr() != image)
+		{
+			if (!raster.setImage(batch.image))
+				continue;
+			raster.setClipRect(clip.x0, clip.y0, clip.x1, clip.y1);
+			image = batch.image;
+			mask = nullptr;
+			firstStyle = ~0U;
+		}
+
+		if (batch.mask.ptr() != mask)
+		{
+			raster.setMask(batch.mask);
+			mask = batch.mask;
+		}
+
+		if (batch.firstStyle != firstStyle || batch.styleCount != styleCount)
+		{
+			defineStyles(raster, batch.firstStyle, batch.styleCount);
+			firstStyle = batch.firstStyle;
+			styleCount = batch.styleCount;
+		}
+
+		for (uint32_t j = 0; j < batch.commandCount; ++j)
+		{
+			const Command& command = m_commands[batch.firstCommand + j];
+			switch (command.op)
+			{
+			case Op::Clear:
+				raster.clear();
+				break;
+
+			case Op::MoveTo:
+				raster.moveTo(command.v[0], command.v[1]);
+				break;
+
+			case Op::LineTo:
+				raster.lineTo(command.v[0], command.v[1]);
+				break;
+
+			case Op::QuadricTo:
+				raster.quadricTo(command.v[0], command.v[1], command.v[2], command.v[3]);
+				break;
+
+			case Op::Fill:
+				raster.fill(command.style0, command.style1, (drawing::Raster::FillRule)command.rule);
+				break;
+
+			case Op::Stroke:
+				raster.stroke(command.style0, command.v[0], (drawing::Raster::StrokeJoin)command.rule, (drawing::Raster::StrokeCap)command.cap);
+				break;
+			}
+		}
+
+		raster.submit();
+	}
+}
+
+void SwCommandList::include(const Vector2& p)
+{
+	m_mn[0] = std::min(m_mn[0], p.x);
+	m_mn[1] = std::min(m_mn[1], p.y);
+	m_mx[0] = std::max(m_mx[0], p.x);
+	m_mx[1] = std::max(m_mx[1], p.y);
+}
+
+void SwCommandList::defineStyles(drawing::Raster& raster, uint32_t firstStyle, uint32_t styleCount) const
+{
+	raster.clearStyles();
+	for (uint32_t i = 0; i < styleCount; ++i)
+	{
+		const Style& style = m_styles[firstStyle + i];
+		switch (style.type)
+		{
+		case StyleType::Solid:
+			raster.defineSolidStyle(style.color);
+			break;
+
+		case StyleType::LinearGradient:
+			{
+				AlignedVector< std::pair< Color4f, float > > colors(m_colors.begin() + style.firstColor, m_colors.begin() + style.firstColor + style.colorCount);
+				raster.defineLinearGradientStyle(style.matrix, colors);
+			}
+			break;
+
+		case StyleType::RadialGradient:
+			{
+				AlignedVector< std::pair< Color4f, float > > colors(m_colors.begin() + style.firstColor, m_colors.begin() + style.firstColor + style.colorCount);
+				raster.defineRadialGradientStyle(style.matrix, colors);
+			}
+			break;
+
+		case StyleType::Image:
+			raster.defineImageStyle(style.matrix, style.image, style.repeat);
+			break;
+		}
+	}
+}
+
+}
@@ -0,0 +1,164 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Color4f.h"
+#include "Core/Math/Matrix33.h"
+#include "Drawing/Raster.h"
+
+namespace traktor::drawing
+{
+
+class Image;
+
+}
+
+namespace traktor::spark
+{
+
+/*! Recorded raster commands.
+ * \ingroup Spark
+ *
+ * Mirror drawing::Raster interface but only record commands;
+ * each submit produce a batch with pixel bounds thus batches
+ * can be binned into screen tiles and later replayed, clipped
+ * to each tile, concurrently.
+ */
+class SwCommandList : public Object
+{
+public:
+	struct Rect
+	{
+		int32_t x0 = 0;
+		int32_t y0 = 0;
+		int32_t x1 = 0;
+		int32_t y1 = 0;
+
+		bool empty() const { return x0 >= x1 || y0 >= y1; }
+	};
+
+	struct Batch
+	{
+		Ref< drawing::Image > image;
+		Ref< drawing::Image > mask;
+		uint32_t firstStyle;
+		uint32_t styleCount;
+		uint32_t firstCommand;
+		uint32_t commandCount;
+		Rect bounds;
+	};
+
+	SwCommandList();
+
+	/*! Reset list, all batches and styles are discarded. */
+	void reset();
+
+	/*! Set target and mask image of following batches. */
+	void setTarget(drawing::Image* image, drawing::Image* mask);
+
+	void clearStyles();
+
+	int32_t defineSolidStyle(const Color4f& color);
+
+	int32_t defineLinearGradientStyle(const Matrix33& gradientMatrix, const AlignedVector< std::pair< Color4f, float > >& colors);
+
+	int32_t defineRadialGradientStyle(const Matrix33& gradientMatrix, const AlignedVector< std::pair< Color4f, float > >& colors);
+
+	int32_t defineImageStyle(const Matrix33& imageMatrix, const drawing::Image* image, bool repeat);
+
+	void clear();
+
+	void moveTo(const Vector2& p);
+
+	void lineTo(const Vector2& p);
+
+	void quadricTo(const Vector2& p, const Vector2& c);
+
+	void fill(int32_t style0, int32_t style1, drawing::Raster::FillRule fillRule);
+
+	void stroke(int32_t style, float width, drawing::Raster::StrokeJoin join, drawing::Raster::StrokeCap cap);
+
+	/*! Close batch, batch is discarded if it's completely outside of cull rectangle.
+	 *
+	 * \param cull Cull rectangle, in pixels.
+	 */
+	void submit(const Rect& cull);
+
+	/*! Replay batches into raster, clipped to rectangle.
+	 *
+	 * \param raster Raster used for replay, raster is bound to batch images.
+	 * \param batches Indices of batches to replay, in submit order.
+	 * \param batchCount Number of batches.
+	 * \param clip Clip rectangle, in pixels.
+	 */
+	void replay(drawing::Raster& raster, const uint32_t* batches, uint32_t batchCount, const Rect& clip) const;
+
+	const AlignedVector< Batch >& getBatches() const { return m_batches; }
+
+private:
+	enum class StyleType : uint8_t
+	{
+		Solid,
+		LinearGradient,
+		RadialGradient,
+		Image
+	};
+
+	struct Style
+	{
+		StyleType type;
+		bool repeat;
+		Color4f color;
+		Matrix33 matrix;
+		uint32_t firstColor;
+		uint32_t colorCount;
+		Ref< const drawing::Image > image;
+	};
+
+	enum class Op : uint8_t
+	{
+		Clear,
+		MoveTo,
+		LineTo,
+		QuadricTo,
+		Fill,
+		Stroke
+	};
+
+	struct Command
+	{
+		Op op;
+		uint8_t rule;		//!< Fill rule, or stroke join.
+		uint8_t cap;
+		int32_t style0;
+		int32_t style1;
+		float v[4];			//!< Coordinates, or stroke width.
+	};
+
+	Ref< drawing::Image > m_image;
+	Ref< drawing::Image > m_mask;
+	AlignedVector< Style > m_styles;
+	AlignedVector< std::pair< Color4f, float > > m_colors;
+	AlignedVector< Command > m_commands;
+	AlignedVector< Batch > m_batches;
+	uint32_t m_firstStyle = 0;
+	uint32_t m_firstCommand = 0;
+	float m_mn[2];
+	float m_mx[2];
+	float m_strokeWidth = 0.0f;
+
+	void include(const Vector2& p);
+
+	void defineStyles(drawing::Raster& raster, uint32_t firstStyle, uint32_t styleCount) const;
+};
+
+}
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Thread/JobManager.h"
 #include "Drawing/Image.h"
 #include "Drawing/Raster.h"
 #include "Spark/ColorTransform.h"
@@ -17,12 +18,32 @@
 #include "Spark/Shape.h"
 #include "Spark/Sw/SwDisplayRenderer.h"
 
+#include <cstring>
+
 namespace traktor::spark
 {
 	namespace
 	{
 
 const static Matrix33 c_textureTS = translate(0.5f, 0.5f) * scale(1.0f / 32768.0f, 1.0f / 32768.0f);
+const int32_t c_tileSize = 128;
+
+void clearRect(drawing::Image* image, const SwCommandList::Rect& rc, const Color4f& color)
+{
+	// Write first pixel then replicate its bytes over entire rectangle.
+	image->setPixelUnsafe(rc.x0, rc.y0, color);
+
+	const int32_t pixelSize = image->getPixelFormat().getByteSize();
+	const int32_t pitch = image->getWidth() * pixelSize;
+	const int32_t rowSize = (rc.x1 - rc.x0) * pixelSize;
+
+	uint8_t* data = (uint8_t*)image->getData();
+	uint8_t* first = data + rc.y0 * pitch + rc.x0 * pixelSize;
+	for (int32_t x = pixelSize; x < rowSize; x += pixelSize)
+		std::memcpy(first + x, first, pixelSize);
+	for (int32_t y = rc.y0 + 1; y < rc.y1; ++y)
+		std::memcpy(data + y * pitch + rc.x0 * pixelSize, first, rowSize);
+}
 
 	}
 
@@ -35,7 +56,7 @@ SwDisplayRenderer::SwDisplayRenderer(drawing::Image* image, bool clearBackground
 ,	m_writeMask(false)
 ,	m_writeEnable(true)
 {
-	m_raster = new drawing::Raster(m_image);
+	m_commands = new SwCommandList();
 }
 
 void SwDisplayRenderer::setTransform(const Matrix33& transform)
@@ -47,7 +68,6 @@ void SwDisplayRenderer::setImage(drawing::Image* image)
 {
 	T_ASSERT(image->getPixelFormat() == m_image->getPixelFormat());
 	m_image = image;
-	m_raster = new drawing::Raster(m_image);
 }
 
 bool SwDisplayRenderer::wantDirtyRegion() const
@@ -65,10 +85,18 @@ void SwDisplayRenderer::begin(
 	const Aabb2& dirtyRegion
 )
 {
-	if (m_clearBackground)
-		m_image->clear(backgroundColor.rgb0());
+	m_backgroundColor = backgroundColor.rgb0();
 	m_frameBounds = frameBounds;
 	m_frameTransform = frameTransform;
+
+	// Entire target is redrawn each frame, batches are only culled against target.
+	m_targetRect.x0 = 0;
+	m_targetRect.y0 = 0;
+	m_targetRect.x1 = m_image->getWidth();
+	m_targetRect.y1 = m_image->getHeight();
+
+	m_commands->reset();
+	m_commands->setTarget(m_image, !m_mask.empty() ? m_mask.back() : nullptr);
 }
 
 void SwDisplayRenderer::beginSprite(const SpriteInstance& sprite, const Matrix33& transform)
@@ -99,11 +127,7 @@ void SwDisplayRenderer::beginMask(bool increment)
 			m_image->getHeight()
 		));
 		m_mask.back()->clear(Color4f(0.0f, 0.0f, 0.0f, 0.0f));
-		m_raster->setImage(m_mask.back());
-		if (m_mask.size() >= 2)
-			m_raster->setMask(m_mask[m_mask.size() - 2]);
-		else
-			m_raster->setMask(0);
+		m_commands->setTarget(m_mask.back(), m_mask.size() >= 2 ? m_mask[m_mask.size() - 2].ptr() : nullptr);
 	}
 	else
 	{
@@ -118,11 +142,7 @@ void SwDisplayRenderer::endMask()
 	T_FATAL_ASSERT(m_writeMask);
 	m_writeMask = false;
 	m_writeEnable = true;
-	m_raster->setImage(m_image);
-	if (!m_mask.empty())
-		m_raster->setMask(m_mask.back());
-	else
-		m_raster->setMask(0);
+	m_commands->setTarget(m_image, !m_mask.empty() ? m_mask.back() : nullptr);
 }
 
 void SwDisplayRenderer::renderShape(const Dictionary& dictionary, const Matrix33& transform, const Aabb2& clipBounds, const Shape& shape, const ColorTransform& cxform, uint8_t blendMode)
@@ -151,7 +171,7 @@ void SwDisplayRenderer::renderShape(const Dictionary& dictionary, const Matrix33
 	int32_t lineStyleBase = 0;
 
 	// Convert all styles used by this shape.
-	m_raster->clearStyles();
+	m_commands->clearStyles();
 	if (!m_writeMask)
 	{
 		for (uint32_t i = 0; i < uint32_t(fillStyles.size()); ++i)
@@ -165,7 +185,7 @@ void SwDisplayRenderer::renderShape(const Dictionary& dictionary, const Matrix33
 				const drawing::Image* image = bitmap->getImage();
 				T_ASSERT(image);
 
-				m_raster->defineImageStyle(
+				m_commands->defineImageStyle(
 					style.getFillBitmapMatrix().inverse() * rasterTransform.inverse(),
 					image,
 					style.getFillBitmapRepeat()
@@ -176,7 +196,7 @@ void SwDisplayRenderer::renderShape(const Dictionary& dictionary, const Matrix33
 				if (colorRecords.size() == 1)
 				{
 					const Color4f& c = colorRecords[0].color;
-					m_raster->defineSolidStyle(c * cxm + cxa);
+					m_commands->defineSolidStyle(c * cxm + cxa);
 				}
 				else if (colorRecords.size() > 1)
 				{
@@ -190,7 +210,7 @@ void SwDisplayRenderer::renderShape(const Dictionary& dictionary, const Matrix33
 								const Color4f& c = colorRecords[j].color;
 								colors.push_back(std::make_pair(c * cxm + cxa, colorRecords[j].ratio));
 							}
-							m_raster->defineLinearGradientStyle(
+							m_commands->defineLinearGradientStyle(
 								c_textureTS * style.getGradientMatrix().inverse() * rasterTransform.inverse(),
 								colors
 							);
@@ -205,7 +225,7 @@ void SwDisplayRenderer::renderShape(const Dictionary& dictionary, const Matrix33
 								const Color4f& c = colorRecords[j].color;
 								colors.push_back(std::make_pair(c * cxm + cxa, colorRecords[j].ratio));
 							}
-							m_raster->defineRadialGradientStyle(
+							m_commands->defineRadialGradientStyle(
 								c_textureTS * style.getGradientMatrix().inverse() * rasterTransform.inverse(),
 								colors
 							);
@@ -213,13 +233,13 @@ void SwDisplayRenderer::renderShape(const Dictionary& dictionary, const Matrix33
 						break;
 
 					default:
-						m_raster->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
+						m_commands->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
 						break;
 					}
 				}
 				else
 				{
-					m_raster->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
+					m_commands->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
 				}
 			}
 		}
@@ -227,12 +247,12 @@ void SwDisplayRenderer::renderShape(const Dictionary& dictionary, const Matrix33
 		for (uint32_t i = 0; i < uint32_t(lineStyles.size()); ++i)
 		{
 			const LineStyle& style = lineStyles[i];
-			m_raster->defineSolidStyle(style.getLineColor() * cxm + cxa);
+			m_commands->defineSolidStyle(style.getLineColor() * cxm + cxa);
 		}
 	}
 	else
 	{
-		m_raster->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
+		m_commands->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
 	}
 
 	// Rasterize every path in shape.
@@ -247,35 +267,35 @@ void SwDisplayRenderer::renderShape(const Dictionary& dictionary, const Matrix33
 			const int32_t ls = subPath.lineStyle - 1;
 			T_ASSERT(fs0 >= 0 || fs1 >= 0 || ls >= 0);
 
-			m_raster->clear();
+			m_commands->clear();
 
 			for (const auto& segment : subPath.segments)
 			{
-				m_raster->moveTo(rasterTransform * points[segment.pointsOffset]);
+				m_commands->moveTo(rasterTransform * points[segment.pointsOffset]);
 				if (segment.type == SpgtLinear)
-					m_raster->lineTo(rasterTransform * points[segment.pointsOffset + 1]);
+					m_commands->lineTo(rasterTransform * points[segment.pointsOffset + 1]);
 				else
-					m_raster->quadricTo(rasterTransform * points[segment.pointsOffset + 1], rasterTransform * points[segment.pointsOffset + 2]);
+					m_commands->quadricTo(rasterTransform * points[segment.pointsOffset + 1], rasterTransform * points[segment.pointsOffset + 2]);
 			}
 
 			if (fs0 >= 0 || fs1 >= 0)
 			{
 				if (!m_writeMask)
-					m_raster->fill(fs0, fs1, drawing::Raster::FillRule::NonZero);
+					m_commands->fill(fs0, fs1, drawing::Raster::FillRule::NonZero);
 				else
-					m_raster->fill(fs0 >= 0 ? 0 : -1, fs1 >= 0 ? 0 : -1, drawing::Raster::FillRule::NonZero);
+					m_commands->fill(fs0 >= 0 ? 0 : -1, fs1 >= 0 ? 0 : -1, drawing::Raster::FillRule::NonZero);
 			}
 
 			if (ls >= 0)
 			{
 				if (!m_writeMask)
-					m_raster->stroke(lineStyleBase + ls, lineStyles[ls].getLineWidth() * strokeScale, drawing::Raster::StrokeJoin::Round, drawing::Raster::StrokeCap::Square);
+					m_commands->stroke(lineStyleBase + ls, lineStyles[ls].getLineWidth() * strokeScale, drawing::Raster::StrokeJoin::Round, drawing::Raster::StrokeCap::Square);
 				else
-					m_raster->stroke(0, lineStyles[ls].getLineWidth(), drawing::Raster::StrokeJoin::Round, drawing::Raster::StrokeCap::Square);
+					m_commands->stroke(0, lineStyles[ls].getLineWidth(), drawing::Raster::StrokeJoin::Round, drawing::Raster::StrokeCap::Square);
 			}
 		}
 
-		m_raster->submit();
+		m_commands->submit(m_targetRect);
 	}
 }
 
@@ -301,8 +321,8 @@ void SwDisplayRenderer::renderGlyph(
 	if (!glyph || !m_writeEnable)
 		return;
 
-	m_raster->clearStyles();
-	m_raster->defineSolidStyle(color * cxform.mul + cxform.add);
+	m_commands->clearStyles();
+	m_commands->defineSolidStyle(color * cxform.mul + cxform.add);
 
 	int32_t width = m_image->getWidth();
 	int32_t height = m_image->getHeight();
@@ -331,22 +351,22 @@ void SwDisplayRenderer::renderGlyph(
 			const int32_t fs1 = subPath.fillStyle1 - 1;
 			T_ASSERT(fs0 >= 0 || fs1 >= 0);
 
-			m_raster->clear();
+			m_commands->clear();
 
 			for (const auto& segment : subPath.segments)
 			{
-				m_raster->moveTo(rasterTransform * points[segment.pointsOffset]);
+				m_commands->moveTo(rasterTransform * points[segment.pointsOffset]);
 				if (segment.type == SpgtLinear)
-					m_raster->lineTo(rasterTransform * points[segment.pointsOffset + 1]);
+					m_commands->lineTo(rasterTransform * points[segment.pointsOffset + 1]);
 				else
-					m_raster->quadricTo(rasterTransform * points[segment.pointsOffset + 1], rasterTransform * points[segment.pointsOffset + 2]);
+					m_commands->quadricTo(rasterTransform * points[segment.pointsOffset + 1], rasterTransform * points[segment.pointsOffset + 2]);
 			}
 
 			if (fs0 >= 0 || fs1 >= 0)
-				m_raster->fill(fs0 >= 0 ? 0 : -1, fs1 >= 0 ? 0 : -1, drawing::Raster::FillRule::NonZero);
+				m_commands->fill(fs0 >= 0 ? 0 : -1, fs1 >= 0 ? 0 : -1, drawing::Raster::FillRule::NonZero);
 		}
 
-		m_raster->submit();
+		m_commands->submit(m_targetRect);
 	}
 }
 
@@ -381,7 +401,7 @@ void SwDisplayRenderer::renderCanvas(const Matrix33& transform, const Canvas& ca
 	int32_t lineStyleBase = 0;
 
 	// Convert all styles used by this shape.
-	m_raster->clearStyles();
+	m_commands->clearStyles();
 	if (!m_writeMask)
 	{
 		for (uint32_t i = 0; i < uint32_t(fillStyles.size()); ++i)
@@ -395,7 +415,7 @@ void SwDisplayRenderer::renderCanvas(const Matrix33& transform, const Canvas& ca
 				const drawing::Image* image = bitmap->getImage();
 				T_ASSERT(image);
 
-				m_raster->defineImageStyle(
+				m_commands->defineImageStyle(
 					style.getFillBitmapMatrix().inverse() * rasterTransform.inverse(),
 					image,
 					style.getFillBitmapRepeat()
@@ -406,7 +426,7 @@ void SwDisplayRenderer::renderCanvas(const Matrix33& transform, const Canvas& ca
 				if (colorRecords.size() == 1)
 				{
 					const Color4f& c = colorRecords[0].color;
-					m_raster->defineSolidStyle(c * cxm + cxa);
+					m_commands->defineSolidStyle(c * cxm + cxa);
 				}
 				else if (colorRecords.size() > 1)
 				{
@@ -420,7 +440,7 @@ void SwDisplayRenderer::renderCanvas(const Matrix33& transform, const Canvas& ca
 								const Color4f& c = colorRecords[j].color;
 								colors.push_back(std::make_pair(c * cxm + cxa, colorRecords[j].ratio));
 							}
-							m_raster->defineLinearGradientStyle(
+							m_commands->defineLinearGradientStyle(
 								c_textureTS * style.getGradientMatrix().inverse() * rasterTransform.inverse(),
 								colors
 							);
@@ -435,7 +455,7 @@ void SwDisplayRenderer::renderCanvas(const Matrix33& transform, const Canvas& ca
 								const Color4f& c = colorRecords[j].color;
 								colors.push_back(std::make_pair(c * cxm + cxa, colorRecords[j].ratio));
 							}
-							m_raster->defineRadialGradientStyle(
+							m_commands->defineRadialGradientStyle(
 								c_textureTS * style.getGradientMatrix().inverse() * rasterTransform.inverse(),
 								colors
 							);
@@ -443,13 +463,13 @@ void SwDisplayRenderer::renderCanvas(const Matrix33& transform, const Canvas& ca
 						break;
 
 					default:
-						m_raster->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
+						m_commands->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
 						break;
 					}
 				}
 				else
 				{
-					m_raster->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
+					m_commands->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
 				}
 			}
 		}
@@ -457,12 +477,12 @@ void SwDisplayRenderer::renderCanvas(const Matrix33& transform, const Canvas& ca
 		for (uint32_t i = 0; i < uint32_t(lineStyles.size()); ++i)
 		{
 			const LineStyle& style = lineStyles[i];
-			m_raster->defineSolidStyle(style.getLineColor() * cxm + cxa);
+			m_commands->defineSolidStyle(style.getLineColor() * cxm + cxa);
 		}
 	}
 	else
 	{
-		m_raster->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
+		m_commands->defineSolidStyle(Color4f(1.0f, 1.0f, 1.0f, 1.0f));
 	}
 
 	// Rasterize every path in shape.
@@ -479,41 +499,91 @@ void SwDisplayRenderer::renderCanvas(const Matrix33& transform, const Canvas& ca
 
 			T_ASSERT(fs0 >= 0 || fs1 >= 0 || ls >= 0);
 
-			m_raster->clear();
+			m_commands->clear();
 
 			const AlignedVector< SubPathSegment >& segments = j->segments;
 			for (AlignedVector< SubPathSegment >::const_iterator k = segments.begin(); k != segments.end(); ++k)
 			{
-				m_raster->moveTo(rasterTransform * points[k->pointsOffset]);
+				m_commands->moveTo(rasterTransform * points[k->pointsOffset]);
 				if (k->type == SpgtLinear)
-					m_raster->lineTo(rasterTransform * points[k->pointsOffset + 1]);
+					m_commands->lineTo(rasterTransform * points[k->pointsOffset + 1]);
 				else
-					m_raster->quadricTo(rasterTransform * points[k->pointsOffset + 1], rasterTransform * points[k->pointsOffset + 2]);
+					m_commands->quadricTo(rasterTransform * points[k->pointsOffset + 1], rasterTransform * points[k->pointsOffset + 2]);
 			}
 
 			if (fs0 >= 0 || fs1 >= 0)
 			{
 				if (!m_writeMask)
-					m_raster->fill(fs0, fs1, drawing::Raster::FillRule::NonZero);
+					m_commands->fill(fs0, fs1, drawing::Raster::FillRule::NonZero);
 				else
-					m_raster->fill(fs0 >= 0 ? 0 : -1, fs1 >= 0 ? 0 : -1, drawing::Raster::FillRule::NonZero);
+					m_commands->fill(fs0 >= 0 ? 0 : -1, fs1 >= 0 ? 0 : -1, drawing::Raster::FillRule::NonZero);
 			}
 
 			if (ls >= 0)
 			{
 				if (!m_writeMask)
-					m_raster->stroke(lineStyleBase + ls, lineStyles[ls].getLineWidth() * strokeScale, drawing::Raster::StrokeJoin::Round, drawing::Raster::StrokeCap::Square);
+					m_commands->stroke(lineStyleBase + ls, lineStyles[ls].getLineWidth() * strokeScale, drawing::Raster::StrokeJoin::Round, drawing::Raster::StrokeCap::Square);
 				else
-					m_raster->stroke(0, lineStyles[ls].getLineWidth(), drawing::Raster::StrokeJoin::Round, drawing::Raster::StrokeCap::Square);
+					m_commands->stroke(0, lineStyles[ls].getLineWidth(), drawing::Raster::StrokeJoin::Round, drawing::Raster::StrokeCap::Square);
 			}
 		}
 
-		m_raster->submit();
+		m_commands->submit(m_targetRect);
 	}
 }
 
 void SwDisplayRenderer::end()
 {
+	const int32_t tilesX = (m_image->getWidth() + c_tileSize - 1) / c_tileSize;
+	const int32_t tilesY = (m_image->getHeight() + c_tileSize - 1) / c_tileSize;
+
+	// Bin batches into every tile their bounds overlap, submit order is kept within each tile.
+	m_bins.resize(tilesX * tilesY);
+	for (auto& bin : m_bins)
+		bin.resize(0);
+
+	const auto& batches = m_commands->getBatches();
+	for (uint32_t i = 0; i < (uint32_t)batches.size(); ++i)
+	{
+		const SwCommandList::Rect& bounds = batches[i].bounds;
+		for (int32_t ty = bounds.y0 / c_tileSize; ty <= (bounds.y1 - 1) / c_tileSize; ++ty)
+		{
+			for (int32_t tx = bounds.x0 / c_tileSize; tx <= (bounds.x1 - 1) / c_tileSize; ++tx)
+				m_bins[tx + ty * tilesX].push_back(i);
+		}
+	}
+
+	// Clear and rasterize tiles in parallel.
+	AlignedVector< Job::task_t > jobs;
+	for (int32_t ty = 0; ty < tilesY; ++ty)
+	{
+		for (int32_t tx = 0; tx < tilesX; ++tx)
+		{
+			SwCommandList::Rect rc;
+			rc.x0 = tx * c_tileSize;
+			rc.y0 = ty * c_tileSize;
+			rc.x1 = std::min((tx + 1) * c_tileSize, m_targetRect.x1);
+			rc.y1 = std::min((ty + 1) * c_tileSize, m_targetRect.y1);
+
+			const AlignedVector< uint32_t >& bin = m_bins[tx + ty * tilesX];
+			if (bin.empty() && !m_clearBackground)
+				continue;
+
+			jobs.push_back([this, rc, &bin]() {
+				if (m_clearBackground)
+					clearRect(m_image, rc, m_backgroundColor);
+				if (!bin.empty())
+				{
+					Ref< drawing::Raster > raster = new drawing::Raster();
+					m_commands->replay(*raster, bin.c_ptr(), (uint32_t)bin.size(), rc);
+				}
+			});
+		}
+	}
+	if (!jobs.empty())
+		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+
+	m_commands->reset();
 }
 
 }
@@ -9,7 +9,9 @@
 #pragma once
 
 #include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Spark/IDisplayRenderer.h"
+#include "Spark/Sw/SwCommandList.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -23,7 +25,6 @@ namespace traktor::drawing
 {
 
 class Image;
-class Raster;
 
 }
 
@@ -32,6 +33,10 @@ namespace traktor::spark
 
 /*! Software display renderer.
  * \ingroup Spark
+ *
+ * Shapes and glyphs are recorded during frame and binned into
+ * screen tiles at end of frame; tiles are then cleared and
+ * rasterized in parallel.
  */
 class T_DLLCLASS SwDisplayRenderer : public IDisplayRenderer
 {
@@ -95,7 +100,10 @@ public:
 private:
 	Ref< drawing::Image > m_image;
 	RefArray< drawing::Image > m_mask;
-	Ref< drawing::Raster > m_raster;
+	Ref< SwCommandList > m_commands;
+	AlignedVector< AlignedVector< uint32_t > > m_bins;
+	SwCommandList::Rect m_targetRect;
+	Color4f m_backgroundColor;
 	Matrix33 m_transform;
 	Aabb2 m_frameBounds;
 	Vector4 m_frameTransform;
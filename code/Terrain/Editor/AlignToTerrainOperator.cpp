@@ -8,6 +8,7 @@
  */
 #include "Terrain/Editor/AlignToTerrainOperator.h"
 
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Io/IStream.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Quaternion.h"
@@ -15,6 +16,7 @@
 #include "Core/Math/Transform.h"
 #include "Core/Math/Vector4.h"
 #include "Core/Misc/SafeDestroy.h"
+#include "Core/RefArray.h"
 #include "Database/Database.h"
 #include "Database/Instance.h"
 #include "Heightfield/Heightfield.h"
@@ -131,9 +133,10 @@ bool AlignToTerrainOperator::transform(
 	// #fixme
 
 	const AlignedVector< std::wstring >& layerFilters = data->getLayers();
-	Random rndm;
 
-	uint32_t aligned = 0;
+	// Gather all entities to align.
+	RefArray< world::EntityData > entityDatas;
+	AlignedVector< Vector4 > positions;
 	for (auto layer : inoutSceneAsset->getLayers())
 	{
 		if (!layer)
@@ -154,41 +157,52 @@ bool AlignToTerrainOperator::transform(
 			if (entityData->getComponent< TerrainComponentData >() != nullptr)
 				continue;
 
-			const Transform current = entityData->getTransform();
-			const Vector4 position = current.translation();
-			const float worldX = position.x();
-			const float worldZ = position.z();
-			const float worldY = heightfield->getWorldHeight(worldX, worldZ) + data->getOffset();
+			entityDatas.push_back(entityData);
+			positions.push_back(entityData->getTransform().translation());
+		}
+	}
 
-			Quaternion rotation = current.rotation();
+	// Get terrain height of all entities at once.
+	AlignedVector< float > heights(positions.size());
+	heightfield->getWorldHeights(positions.c_ptr(), heights.ptr(), (uint32_t)positions.size());
 
-			if (data->getAlignOrientation())
-			{
-				float gridX, gridZ;
-				heightfield->worldToGrid(worldX, worldZ, gridX, gridZ);
-				const Vector4 normal = heightfield->normalAt(gridX, gridZ);
-				rotation = slerp(
-					Quaternion(Vector4(0.0f, 1.0f, 0.0f, 0.0f), normal),
-					Quaternion::identity(),
-					data->getUpness()
-				);
-			}
+	Random rndm;
+	for (uint32_t i = 0; i < entityDatas.size(); ++i)
+	{
+		world::EntityData* entityData = entityDatas[i];
 
-			if (data->getRandomHeadingAngle())
-			{
-				const float rnd = rndm.nextFloat() * TWO_PI;
-				rotation = rotation * Quaternion::fromEulerAngles(rnd, 0.0f, 0.0f);
-			}
+		const Transform current = entityData->getTransform();
+		const float worldX = positions[i].x();
+		const float worldZ = positions[i].z();
+		const float worldY = heights[i] + data->getOffset();
+
+		Quaternion rotation = current.rotation();
 
-			entityData->setTransform(Transform(
-				Vector4(worldX, worldY, worldZ, 1.0f),
-				rotation
-			));
-			++aligned;
+		if (data->getAlignOrientation())
+		{
+			float gridX, gridZ;
+			heightfield->worldToGrid(worldX, worldZ, gridX, gridZ);
+			const Vector4 normal = heightfield->normalAt(gridX, gridZ);
+			rotation = slerp(
+				Quaternion(Vector4(0.0f, 1.0f, 0.0f, 0.0f), normal),
+				Quaternion::identity(),
+				data->getUpness()
+			);
 		}
+
+		if (data->getRandomHeadingAngle())
+		{
+			const float rnd = rndm.nextFloat() * TWO_PI;
+			rotation = rotation * Quaternion::fromEulerAngles(rnd, 0.0f, 0.0f);
+		}
+
+		entityData->setTransform(Transform(
+			Vector4(worldX, worldY, worldZ, 1.0f),
+			rotation
+		));
 	}
 
-	log::debug << L"AlignToTerrain; aligned " << aligned << L" entities to terrain." << Endl;
+	log::debug << L"AlignToTerrain; aligned " << (uint32_t)entityDatas.size() << L" entities to terrain." << Endl;
 	return true;
 }
 
@@ -66,6 +66,7 @@ bool ForestComponent::create(
 
 void ForestComponent::destroy()
 {
+	m_cullTree = nullptr;
 }
 
 void ForestComponent::setOwner(world::Entity* owner)
@@ -90,29 +91,19 @@ void ForestComponent::update(const world::UpdateParams& update)
 
 void ForestComponent::setup(const world::WorldRenderView& worldRenderView)
 {
-	m_lod0Indices.resize(0);
-	m_lod1Indices.resize(0);
-	m_lod2Indices.resize(0);
+	const int32_t viewIndex = worldRenderView.getIndex();
+	if (!m_cullTree || viewIndex < 0 || viewIndex >= (int32_t)sizeof_array(m_view))
+		return;
 
-	for (uint32_t i = 0; i < (uint32_t)m_trees.size(); ++i)
-	{
-		const auto& tree = m_trees[i];
-
-		float distance = 0.0f;
-		if (!worldRenderView.isBoxVisible(
-			m_boundingBox,
-			Transform(tree.position),
-			distance
-		))
-			continue;
-
-		if (distance < m_data.m_lod0distance)
-			m_lod0Indices.push_back(i);
-		else if (distance < m_data.m_lod1distance)
-			m_lod1Indices.push_back(i);
-		else if (distance < m_data.m_lod2distance)
-			m_lod2Indices.push_back(i);
-	}
+	// Assign visible trees to lods; result is kept as long as view doesn't change.
+	const float lodDistances[] = { m_data.m_lod0distance, m_data.m_lod1distance, m_data.m_lod2distance };
+	m_cullTree->cull(
+		worldRenderView.getView(),
+		worldRenderView.getCullFrustum(),
+		lodDistances,
+		sizeof_array(lodDistances),
+		m_view[viewIndex]
+	);
 }
 
 void ForestComponent::build(
@@ -132,24 +123,20 @@ void ForestComponent::build(
 	const Vector4 eye = view.inverse().translation();
 
 	// In case we are rendering shadow map then cull from light point of view.
-	if (worldRenderPass.getTechnique() == s_techniqueShadowWrite)
+	if (worldRenderPass.getTechnique() == s_techniqueShadowWrite && m_cullTree)
 	{
-		m_lodShadowIndices.resize(0);
-
-		for (uint32_t i = 0; i < (uint32_t)m_trees.size(); ++i)
-		{
-			const auto& tree = m_trees[i];
-
-			float distance = 0.0f;
-			if (!worldRenderView.isBoxVisible(
-				m_boundingBox,
-				Transform(tree.position),
-				distance
-			))
-				continue;
-
-			m_lodShadowIndices.push_back(i);
-		}
+		const int32_t shadowMapIndex = worldRenderView.getShadowMapIndex();
+		if (shadowMapIndex >= (int32_t)m_shadowViews.size())
+			m_shadowViews.resize(shadowMapIndex + 1);
+
+		const float lodDistances[] = { std::numeric_limits< float >::max() };
+		m_cullTree->cull(
+			view,
+			cullFrustum,
+			lodDistances,
+			sizeof_array(lodDistances),
+			m_shadowViews[shadowMapIndex]
+		);
 	}
 
 	render::RenderContext* renderContext = context.getRenderContext();
@@ -166,16 +153,18 @@ void ForestComponent::build(
 /*
 	if (worldRenderPass.getTechnique() != s_techniqueShadowWrite)
 	{
-		for (uint32_t i = 0; i < m_lod2Indices.size(); )
+		const auto& lodIndices = m_view[worldRenderView.getIndex()].lodIndices;
+
+		for (uint32_t i = 0; i < lodIndices[2].size(); )
 		{
-			const uint32_t batch = std::min< uint32_t >(m_lod2Indices.size() - i, mesh::InstanceMesh::MaxInstanceCount);
+			const uint32_t batch = std::min< uint32_t >(lodIndices[2].size() - i, mesh::InstanceMesh::MaxInstanceCount);
 
 			m_instanceData.resize(batch);
 			for (int32_t j = 0; j < batch; ++j, ++i)
 			{
-				m_trees[m_lod2Indices[i]].rotation.e.storeAligned(m_instanceData[j].data.rotation);
-				m_trees[m_lod2Indices[i]].position.storeAligned(m_instanceData[j].data.translation);
-				m_instanceData[j].data.scale = m_trees[m_lod2Indices[i]].scale;
+				m_trees[lodIndices[2][i]].rotation.e.storeAligned(m_instanceData[j].data.rotation);
+				m_trees[lodIndices[2][i]].position.storeAligned(m_instanceData[j].data.translation);
+				m_instanceData[j].data.scale = m_trees[lodIndices[2][i]].scale;
 				m_instanceData[j].distance = 0.0f;
 			}
 
@@ -187,16 +176,16 @@ void ForestComponent::build(
 			);
 		}
 
-		for (uint32_t i = 0; i < m_lod1Indices.size(); )
+		for (uint32_t i = 0; i < lodIndices[1].size(); )
 		{
-			const uint32_t batch = std::min< uint32_t >(m_lod1Indices.size() - i, mesh::InstanceMesh::MaxInstanceCount);
+			const uint32_t batch = std::min< uint32_t >(lodIndices[1].size() - i, mesh::InstanceMesh::MaxInstanceCount);
 
 			m_instanceData.resize(batch);
 			for (int32_t j = 0; j < batch; ++j, ++i)
 			{
-				m_trees[m_lod1Indices[i]].rotation.e.storeAligned(m_instanceData[j].data.rotation);
-				m_trees[m_lod1Indices[i]].position.storeAligned(m_instanceData[j].data.translation);
-				m_instanceData[j].data.scale = m_trees[m_lod1Indices[i]].scale;
+				m_trees[lodIndices[1][i]].rotation.e.storeAligned(m_instanceData[j].data.rotation);
+				m_trees[lodIndices[1][i]].position.storeAligned(m_instanceData[j].data.translation);
+				m_instanceData[j].data.scale = m_trees[lodIndices[1][i]].scale;
 				m_instanceData[j].distance = 0.0f;
 			}
 
@@ -208,16 +197,16 @@ void ForestComponent::build(
 			);
 		}
 
-		for (uint32_t i = 0; i < m_lod0Indices.size(); )
+		for (uint32_t i = 0; i < lodIndices[0].size(); )
 		{
-			const uint32_t batch = std::min< uint32_t >(m_lod0Indices.size() - i, mesh::InstanceMesh::MaxInstanceCount);
+			const uint32_t batch = std::min< uint32_t >(lodIndices[0].size() - i, mesh::InstanceMesh::MaxInstanceCount);
 
 			m_instanceData.resize(batch);
 			for (int32_t j = 0; j < batch; ++j, ++i)
 			{
-				m_trees[m_lod0Indices[i]].rotation.e.storeAligned(m_instanceData[j].data.rotation);
-				m_trees[m_lod0Indices[i]].position.storeAligned(m_instanceData[j].data.translation);
-				m_instanceData[j].data.scale = m_trees[m_lod0Indices[i]].scale;
+				m_trees[lodIndices[0][i]].rotation.e.storeAligned(m_instanceData[j].data.rotation);
+				m_trees[lodIndices[0][i]].position.storeAligned(m_instanceData[j].data.translation);
+				m_instanceData[j].data.scale = m_trees[lodIndices[0][i]].scale;
 				m_instanceData[j].distance = 0.0f;
 			}
 
@@ -231,16 +220,17 @@ void ForestComponent::build(
 	}
 	else
 	{
-		for (uint32_t i = 0; i < m_lodShadowIndices.size(); )
+		const auto& shadowIndices = m_shadowViews[worldRenderView.getShadowMapIndex()].lodIndices[0];
+		for (uint32_t i = 0; i < shadowIndices.size(); )
 		{
-			const uint32_t batch = std::min< uint32_t >(m_lodShadowIndices.size() - i, mesh::InstanceMesh::MaxInstanceCount);
+			const uint32_t batch = std::min< uint32_t >(shadowIndices.size() - i, mesh::InstanceMesh::MaxInstanceCount);
 
 			m_instanceData.resize(batch);
 			for (int32_t j = 0; j < batch; ++j, ++i)
 			{
-				m_trees[m_lodShadowIndices[i]].rotation.e.storeAligned(m_instanceData[j].data.rotation);
-				m_trees[m_lodShadowIndices[i]].position.storeAligned(m_instanceData[j].data.translation);
-				m_instanceData[j].data.scale = m_trees[m_lodShadowIndices[i]].scale;
+				m_trees[shadowIndices[i]].rotation.e.storeAligned(m_instanceData[j].data.rotation);
+				m_trees[shadowIndices[i]].position.storeAligned(m_instanceData[j].data.translation);
+				m_instanceData[j].data.scale = m_trees[shadowIndices[i]].scale;
 				m_instanceData[j].distance = 0.0f;
 			}
 
@@ -278,11 +268,10 @@ void ForestComponent::updatePatches()
 				continue;
 
 			// Get world position.
-			float wx, wy, wz;
+			float wx, wz;
 			heightfield->gridToWorld(x, z, wx, wz);
 			wx += extentPerGrid.x() * densityInv * (random.nextFloat() - 0.5f);
 			wz += extentPerGrid.z() * densityInv * (random.nextFloat() - 0.5f);
-			wy = heightfield->getWorldHeight(wx, wz);
 
 			// Get ground normal.
 			float gx, gz;
@@ -302,13 +291,30 @@ void ForestComponent::updatePatches()
 			const Quaternion Qr = Quaternion::fromAxisAngle(Vector4(1.0f, 0.0f, 0.0f), rx) * Quaternion::fromAxisAngle(Vector4(0.0f, 0.0f, 1.0f), rz);
 			const Quaternion Qh = Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), head);
 
-			// Add tree on position.
+			// Add tree on position, height is resolved for all trees below.
 			auto& tree = m_trees.push_back();
-			tree.position = Vector4(wx, wy, wz, 1.0f);
+			tree.position = Vector4(wx, 0.0f, wz, 1.0f);
 			tree.rotation = Qr * Qu * Qh;
 			tree.scale = random.nextFloat() * m_data.m_randomScale + (1.0f - m_data.m_randomScale);
 		}
 	}
+
+	// Get ground height of all trees at once.
+	AlignedVector< Vector4 > positions(m_trees.size());
+	AlignedVector< float > heights(m_trees.size());
+	for (uint32_t i = 0; i < m_trees.size(); ++i)
+		positions[i] = m_trees[i].position;
+	heightfield->getWorldHeights(positions.c_ptr(), heights.ptr(), (uint32_t)m_trees.size());
+	for (uint32_t i = 0; i < m_trees.size(); ++i)
+		m_trees[i].position.set(1, Scalar(heights[i]));
+
+	// Cluster trees for culling; bounding sphere same as WorldRenderView::isBoxVisible.
+	const Vector4 boundingCenter = m_boundingBox.getCenter().xyz0();
+	for (uint32_t i = 0; i < m_trees.size(); ++i)
+		positions[i] = m_trees[i].position + boundingCenter;
+
+	m_cullTree = new InstanceCullTree();
+	m_cullTree->build(positions, m_boundingBox.getExtent().length());
 }
 
 }
@@ -10,6 +10,7 @@
 
 #include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Aabb3.h"
+#include "Core/Math/InstanceCullTree.h"
 #include "Mesh/Instance/InstanceMesh.h"
 #include "Resource/Proxy.h"
 #include "Terrain/ForestComponentData.h"
@@ -77,10 +78,9 @@ private:
 	resource::Proxy< mesh::InstanceMesh > m_lod1mesh;
 	resource::Proxy< mesh::InstanceMesh > m_lod2mesh;
 	AlignedVector< Tree > m_trees;
-	AlignedVector< uint32_t > m_lod0Indices;
-	AlignedVector< uint32_t > m_lod1Indices;
-	AlignedVector< uint32_t > m_lod2Indices;
-	AlignedVector< uint32_t > m_lodShadowIndices;
+	Ref< InstanceCullTree > m_cullTree;
+	InstanceCullTree::CullResult m_view[4];			//!< Visible trees per lod, for each view.
+	AlignedVector< InstanceCullTree::CullResult > m_shadowViews;	//!< Visible trees for each shadow map.
 	//AlignedVector< mesh::InstanceMesh::RenderInstance > m_instanceData;
 	Aabb3 m_boundingBox;
 };
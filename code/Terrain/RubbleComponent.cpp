@@ -12,6 +12,7 @@
 #include "Core/Log/Log.h"
 #include "Core/Math/Half.h"
 #include "Core/Math/RandomGeometry.h"
+#include "Core/Thread/JobManager.h"
 #include "Heightfield/Heightfield.h"
 #include "Render/Context/RenderContext.h"
 #include "Render/ITexture.h"
@@ -25,6 +26,7 @@
 #include "World/WorldBuildContext.h"
 #include "World/WorldRenderView.h"
 
+#include <algorithm>
 #include <limits>
 
 namespace traktor::terrain
@@ -32,6 +34,8 @@ namespace traktor::terrain
 namespace
 {
 
+const uint32_t c_clustersPerJob = 16;	//!< Number of newly visible clusters scattered by each job.
+
 const render::Handle s_handleTerrain_Normals(L"Terrain_Normals");
 const render::Handle s_handleTerrain_Heightfield(L"Terrain_Heightfield");
 const render::Handle s_handleTerrain_Surface(L"Terrain_Surface");
@@ -68,6 +72,7 @@ bool RubbleComponent::create(
 
 void RubbleComponent::destroy()
 {
+	m_cullTree = nullptr;
 }
 
 void RubbleComponent::setOwner(world::Entity* owner)
@@ -119,50 +124,46 @@ void RubbleComponent::setup(const world::WorldRenderView& worldRenderView)
 		m_eye = eye;
 		m_fwd = fwd;
 
-		for (auto& cluster : m_clusters)
+		if (!m_cullTree)
+			return;
+
+		// Cull cluster hierarchy, only newly visible clusters need to be scattered.
+		const float lodDistances[] = { std::numeric_limits< float >::max() };
+		m_cullTree->cull(view, viewFrustum, lodDistances, 1, m_cullResult);
+
+		m_scatterClusters.resize(0);
+		for (auto index : m_cullResult.lodIndices[0])
 		{
+			Cluster& cluster = m_clusters[index];
 			cluster.distance = (cluster.center - eye).length();
-
-			const bool visible = cluster.visible;
-			cluster.visible = (bool)(viewFrustum.inside(view * cluster.center, Scalar(m_clusterSize)) != Frustum::Result::Outside);
 			if (!cluster.visible)
-				continue;
-			if (cluster.visible && visible)
-				continue;
+				m_scatterClusters.push_back(index);
+		}
 
-			const float randomScaleAmount = cluster.rubbleDef->randomScaleAmount;
-			const float randomTilt = cluster.rubbleDef->randomTilt;
-			const float upness = cluster.rubbleDef->upness;
+		for (auto index : m_visibleClusters)
+			m_clusters[index].visible = false;
+		for (auto index : m_cullResult.lodIndices[0])
+			m_clusters[index].visible = true;
+		m_visibleClusters = m_cullResult.lodIndices[0];
 
-			RandomGeometry random(cluster.seed);
-			for (int32_t j = cluster.from; j < cluster.to; ++j)
+		// Scatter newly visible clusters in parallel.
+		if (m_scatterClusters.size() <= c_clustersPerJob)
+		{
+			for (auto index : m_scatterClusters)
+				scatter(heightfield, m_clusters[index]);
+		}
+		else
+		{
+			AlignedVector< Job::task_t > jobs;
+			for (uint32_t i = 0; i < (uint32_t)m_scatterClusters.size(); i += c_clustersPerJob)
 			{
-				const float dx = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
-				const float dz = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
-
-				// Calculate world position.
-				const float px = cluster.center.x() + dx;
-				const float pz = cluster.center.z() + dz;
-				const float py = terrain->getHeightfield()->getWorldHeight(px, pz);
-
-				// Get ground normal.
-				float gx, gz;
-				heightfield->worldToGrid(px, pz, gx, gz);
-				const Vector4 normal = heightfield->normalAt(gx, gz);
-
-				// Calculate rotation.
-				const float rx = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
-				const float rz = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
-				const float head = random.nextFloat() * TWO_PI;
-				const Quaternion Qu = slerp(Quaternion(Vector4(0.0f, 1.0f, 0.0f), normal), Quaternion::identity(), upness);
-				const Quaternion Qr = Quaternion::fromAxisAngle(Vector4(1.0f, 0.0f, 0.0f), rx) * Quaternion::fromAxisAngle(Vector4(0.0f, 0.0f, 1.0f), rz);
-				const Quaternion Qh = Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), head);
-
-				// Update instance data.
-				m_instances[j].position = Vector4(px, py, pz, 0.0f);
-				m_instances[j].rotation = Qr * Qu * Qh;
-				m_instances[j].scale = random.nextFloat() * randomScaleAmount + (1.0f - randomScaleAmount);
+				const uint32_t to = std::min< uint32_t >(i + c_clustersPerJob, (uint32_t)m_scatterClusters.size());
+				jobs.push_back([=, this](){
+					for (uint32_t j = i; j < to; ++j)
+						scatter(heightfield, m_clusters[m_scatterClusters[j]]);
+				});
 			}
+			JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
 		}
 	}
 }
@@ -237,6 +238,8 @@ void RubbleComponent::updatePatches()
 {
 	m_instances.resize(0);
 	m_clusters.resize(0);
+	m_visibleClusters.resize(0);
+	m_cullTree = nullptr;
 
 	auto terrainComponent = m_owner->getComponent< TerrainComponent >();
 	if (!terrainComponent)
@@ -326,8 +329,62 @@ void RubbleComponent::updatePatches()
 		}
 	}
 
+	// Cluster hierarchy for culling.
+	AlignedVector< Vector4 > centers(m_clusters.size());
+	for (uint32_t i = 0; i < (uint32_t)m_clusters.size(); ++i)
+		centers[i] = m_clusters[i].center;
+
+	m_cullTree = new InstanceCullTree();
+	m_cullTree->build(centers, Scalar(m_clusterSize));
+
 	// Move last eye position, forces rescatter of visible clusters.
 	m_eye = Vector4::zero();
 }
 
+void RubbleComponent::scatter(const hf::Heightfield* heightfield, const Cluster& cluster)
+{
+	const float randomScaleAmount = cluster.rubbleDef->randomScaleAmount;
+	const float randomTilt = cluster.rubbleDef->randomTilt;
+	const float upness = cluster.rubbleDef->upness;
+
+	RandomGeometry random(cluster.seed);
+	for (int32_t j = cluster.from; j < cluster.to; ++j)
+	{
+		const float dx = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
+		const float dz = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
+
+		// Calculate world position.
+		const float px = cluster.center.x() + dx;
+		const float pz = cluster.center.z() + dz;
+
+		// Get ground normal.
+		float gx, gz;
+		heightfield->worldToGrid(px, pz, gx, gz);
+		const Vector4 normal = heightfield->normalAt(gx, gz);
+
+		// Calculate rotation.
+		const float rx = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
+		const float rz = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
+		const float head = random.nextFloat() * TWO_PI;
+		const Quaternion Qu = slerp(Quaternion(Vector4(0.0f, 1.0f, 0.0f), normal), Quaternion::identity(), upness);
+		const Quaternion Qr = Quaternion::fromAxisAngle(Vector4(1.0f, 0.0f, 0.0f), rx) * Quaternion::fromAxisAngle(Vector4(0.0f, 0.0f, 1.0f), rz);
+		const Quaternion Qh = Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), head);
+
+		// Update instance data, height is resolved for all instances in cluster below.
+		m_instances[j].position = Vector4(px, 0.0f, pz, 0.0f);
+		m_instances[j].rotation = Qr * Qu * Qh;
+		m_instances[j].scale = random.nextFloat() * randomScaleAmount + (1.0f - randomScaleAmount);
+	}
+
+	// Get ground height of all instances in cluster at once.
+	const int32_t count = cluster.to - cluster.from;
+	AlignedVector< Vector4 > positions(count);
+	AlignedVector< float > heights(count);
+	for (int32_t j = 0; j < count; ++j)
+		positions[j] = m_instances[cluster.from + j].position;
+	heightfield->getWorldHeights(positions.c_ptr(), heights.ptr(), count);
+	for (int32_t j = 0; j < count; ++j)
+		m_instances[cluster.from + j].position.set(1, Scalar(heights[j]));
+}
+
 }
@@ -9,12 +9,20 @@
 #pragma once
 
 #include "Core/Containers/AlignedVector.h"
+#include "Core/Math/InstanceCullTree.h"
 #include "Core/Math/Vector4.h"
 #include "Mesh/Instance/InstanceMesh.h"
 #include "Resource/Proxy.h"
 #include "Terrain/TerrainLayerComponent.h"
 #include "Terrain/RubbleComponentData.h"
 
+namespace traktor::hf
+{
+
+class Heightfield;
+
+}
+
 namespace traktor::render
 {
 
@@ -97,10 +105,16 @@ private:
 	AlignedVector< RubbleMesh > m_rubble;
 	AlignedVector< Instance > m_instances;
 	AlignedVector< Cluster > m_clusters;
+	Ref< InstanceCullTree > m_cullTree;
+	InstanceCullTree::CullResult m_cullResult;
+	AlignedVector< uint32_t > m_visibleClusters;
+	AlignedVector< uint32_t > m_scatterClusters;
 	float m_clusterSize = 0.0f;
 	Vector4 m_eye = Vector4::zero();
 	Vector4 m_fwd = Vector4::zero();
 	//AlignedVector< mesh::InstanceMesh::RenderInstance > m_instanceData;
+
+	void scatter(const hf::Heightfield* heightfield, const Cluster& cluster);
 };
 
 }
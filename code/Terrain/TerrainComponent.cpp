@@ -151,6 +151,10 @@ void TerrainComponent::setup(
 	const Vector4 eyePosition = worldRenderView.getEyePosition();
 	const Vector4 eyeDirection = worldRenderView.getEyeDirection();
 
+	// Page in heightfield tiles surrounding primary view.
+	if (viewIndex == 0 && !snapshot)
+		m_heightfield->updateResidency(eyePosition);
+
 	const Vector4 patchExtent(worldExtent.x() / float(m_patchCount), worldExtent.y(), worldExtent.z() / float(m_patchCount), 0.0f);
 	const Vector4 patchDeltaHalf = patchExtent * Vector4(0.5f, 0.5f, 0.5f, 0.0f);
 	const Vector4 patchDeltaX = patchExtent * Vector4(1.0f, 0.0f, 0.0f, 0.0f);